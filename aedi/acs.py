@@ -0,0 +1,205 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+# Run this module as python3 -B -m aedi.acs from repository root, see BatchCompiler
+
+import argparse
+import concurrent.futures
+import hashlib
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+import typing
+from pathlib import Path
+
+
+class BatchCompiler(object):
+    """
+    ACS scripts compiled by acc concurrently, one process per script, and only when the script or anything
+    it includes has changed since the previous batch, so shared zcommon.acs headers are not compiled again
+    for every unchanged script of a mod
+
+    Digest of every script covers acc executable, its options, and content of the script together with all files
+    it includes or imports, those are found in directory of including file, in include directories, and in acc one
+    Digests of compiled scripts are kept in cache file of output directory
+    """
+
+    CACHE_NAME = '.aedi-acs.json'
+    CACHE_FORMAT_VERSION = 1
+
+    INCLUDE_PATTERN = re.compile(rb'^\s*#\s*(?:include|import)\s+"([^"]+)"', re.IGNORECASE | re.MULTILINE)
+
+    def __init__(self, acc: Path, include_paths: typing.Sequence[Path], output_path: Path,
+                 jobs: typing.Optional[int] = None):
+        self.acc = acc
+        self.include_paths = list(include_paths) + [acc.parent]
+        self.output_path = output_path
+        self.jobs = jobs or os.cpu_count()
+        self._cache_path = output_path / self.CACHE_NAME
+        self._file_digests: typing.Dict[Path, str] = {}
+
+    def compile(self, scripts: typing.Sequence[Path]) -> bool:
+        start_time = time.monotonic()
+        os.makedirs(self.output_path, exist_ok=True)
+
+        stems = [script.stem for script in scripts]
+
+        if len(set(stems)) != len(stems):
+            raise RuntimeError('Scripts with the same name would be compiled to the same object file')
+
+        cache = self._load_cache()
+        base_digest = self._base_digest()
+        digests = {script: self._script_digest(script, base_digest) for script in scripts}
+
+        outdated = [script for script in scripts
+                    if cache.get(str(script)) != digests[script] or not self._object_path(script).exists()]
+
+        failed = []
+
+        with concurrent.futures.ThreadPoolExecutor(max_workers=self.jobs) as executor:
+            futures = {executor.submit(self._compile, script): script for script in outdated}
+
+            for future in concurrent.futures.as_completed(futures):
+                script = futures[future]
+                result = future.result()
+
+                if result.returncode == 0:
+                    cache[str(script)] = digests[script]
+                else:
+                    failed.append(script)
+                    cache.pop(str(script), None)
+
+                    # Output of every acc process is printed at once, so messages of concurrent ones don't mix
+                    sys.stdout.write(result.stdout.decode('utf-8', errors='replace'))
+
+        self._write_cache(cache)
+
+        elapsed = time.monotonic() - start_time
+        print(f'Compiled {len(outdated) - len(failed)} of {len(outdated)} changed scripts, '
+              f'skipped {len(scripts) - len(outdated)} unchanged ones, in {elapsed:.1f} seconds')
+
+        for script in sorted(failed):
+            print(f'Failed to compile {script}')
+
+        return not failed
+
+    def _object_path(self, script: Path) -> Path:
+        return self.output_path / (script.stem + '.o')
+
+    def _compile(self, script: Path) -> subprocess.CompletedProcess:
+        args = [self.acc]
+
+        for include_path in self.include_paths:
+            args += ['-i', include_path]
+
+        args += [script, self._object_path(script)]
+
+        return subprocess.run(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+
+    def _base_digest(self) -> str:
+        hasher = hashlib.sha256(self._file_digest(self.acc).encode())
+
+        for include_path in self.include_paths:
+            hasher.update(str(include_path).encode() + b'\0')
+
+        return hasher.hexdigest()
+
+    def _script_digest(self, script: Path, base_digest: str) -> str:
+        hasher = hashlib.sha256(base_digest.encode())
+        pending = [script]
+        visited = set()
+
+        while pending:
+            path = pending.pop()
+
+            if path in visited:
+                continue
+
+            visited.add(path)
+            hasher.update(str(path).encode() + b'\0' + self._file_digest(path).encode())
+
+            for name in self.INCLUDE_PATTERN.findall(path.read_bytes()):
+                include = self._find_include(name.decode('utf-8', errors='replace'), path.parent)
+
+                # Missing include still makes digest different when it appears, acc reports an error for it
+                if include:
+                    pending.append(include)
+                else:
+                    hasher.update(name + b'\0')
+
+        return hasher.hexdigest()
+
+    def _find_include(self, name: str, directory: Path) -> typing.Optional[Path]:
+        for include_path in [directory] + self.include_paths:
+            path = include_path / name
+
+            if path.is_file():
+                return path.absolute()
+
+        return None
+
+    def _file_digest(self, path: Path) -> str:
+        # Shared headers are read once per batch
+        digest = self._file_digests.get(path)
+
+        if not digest:
+            digest = hashlib.sha256(path.read_bytes()).hexdigest()
+            self._file_digests[path] = digest
+
+        return digest
+
+    def _load_cache(self) -> typing.Dict[str, str]:
+        if not self._cache_path.exists():
+            return {}
+
+        try:
+            cache = json.loads(self._cache_path.read_text())
+        except ValueError:
+            return {}
+
+        return cache['scripts'] if cache.get('format') == self.CACHE_FORMAT_VERSION else {}
+
+    def _write_cache(self, scripts: typing.Dict[str, str]):
+        cache = {'format': self.CACHE_FORMAT_VERSION, 'scripts': scripts}
+        self._cache_path.write_text(json.dumps(cache, indent=1, sort_keys=True) + '\n')
+
+
+def main(args: typing.Sequence[str]):
+    parser = argparse.ArgumentParser(description='Compile changed ACS scripts with acc concurrently')
+    parser.add_argument('--acc', metavar='path', default='output/acc/acc', help='path to acc executable')
+    parser.add_argument('--include', metavar='path', action='append', default=[],
+                        help='add directory to search for included files')
+    parser.add_argument('--jobs', type=int, help='number of concurrent acc processes, all CPU cores by default')
+    parser.add_argument('--output', metavar='path', required=True, help='path to directory for compiled objects')
+    parser.add_argument('scripts', metavar='script', nargs='+', help='path to ACS script to compile')
+    arguments = parser.parse_args(args)
+
+    include_paths = [Path(path).absolute() for path in arguments.include]
+    scripts = [Path(path).absolute() for path in arguments.scripts]
+    compiler = BatchCompiler(Path(arguments.acc).absolute(), include_paths, Path(arguments.output).absolute(),
+                             arguments.jobs)
+
+    if not compiler.compile(scripts):
+        exit(1)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
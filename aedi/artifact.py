@@ -0,0 +1,214 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import hashlib
+import os
+import shutil
+import subprocess
+import typing
+import urllib.error
+import urllib.request
+from pathlib import Path
+
+from .utility import clone_tree
+
+
+class ArtifactCache(object):
+    """
+    Install trees of dependency targets stored by hash of everything that affects their content
+    Every artifact is a copy of deps/<name> directory, symbolic links are preserved
+
+    Optional remote cache keeps the same artifacts as <name>-<key>.tar.gz archives with .sha256 files next to them
+    It's accessed with plain HTTPS GET and PUT requests, or with AWS CLI for s3:// URLs
+    Endpoint of S3-compatible storage and credentials are taken by AWS CLI from its usual environment variables
+    Bearer token for HTTPS server is taken from AEDI_ARTIFACT_CACHE_TOKEN environment variable
+    """
+
+    def __init__(self, path: Path, remote_url: typing.Optional[str] = None, upload=False,
+                 environment: typing.Optional[dict] = None, deps_name: str = 'deps'):
+        self.path = path
+        self.remote_url = remote_url.rstrip('/') if remote_url else None
+        self.upload = upload
+        self.environment = environment
+
+        # Keys of artifacts that are currently installed into deps directory, every one of deps, deps-lto
+        # and deps-<variant> directories has its own, they hold different builds of the same targets
+        self._installed_path = path / 'installed' / deps_name
+
+    @staticmethod
+    def key(components: typing.Iterable[typing.Union[str, bytes]]) -> str:
+        hasher = hashlib.sha256()
+
+        for component in components:
+            data = component if isinstance(component, bytes) else component.encode('utf-8')
+
+            # Length prefix makes boundaries between components unambiguous
+            hasher.update(len(data).to_bytes(8, 'little'))
+            hasher.update(data)
+
+        return hasher.hexdigest()
+
+    def installed_key(self, name: str) -> str:
+        # Targets that are not rebuilt into variant or LTO deps directory are taken from the regular one
+        for installed_path in (self._installed_path, self._installed_path.parent / 'deps'):
+            key_path = installed_path / name
+
+            if key_path.exists():
+                return key_path.read_text()
+
+        return ''
+
+    def forget_installed(self, name: str):
+        (self._installed_path / name).unlink(missing_ok=True)
+
+    def _artifact_path(self, name: str, key: str) -> Path:
+        return self.path / f'{name}-{key}'
+
+    def restore(self, name: str, key: str, install_path: Path) -> bool:
+        artifact_path = self._artifact_path(name, key)
+
+        if not artifact_path.exists() and not self._fetch(name, key):
+            return False
+
+        if install_path.exists():
+            shutil.rmtree(install_path)
+
+        clone_tree(artifact_path, install_path)
+        self._set_installed(name, key)
+
+        return True
+
+    def store(self, name: str, key: str, install_path: Path):
+        artifact_path = self._artifact_path(name, key)
+
+        if not artifact_path.exists():
+            # Copy to temporary directory first, so interrupted store never leaves incomplete artifact
+            temp_path = self.path / f'{name}-{key}.{os.getpid()}.tmp'
+
+            if temp_path.exists():
+                shutil.rmtree(temp_path)
+
+            clone_tree(install_path, temp_path)
+
+            try:
+                os.rename(temp_path, artifact_path)
+            except OSError:
+                # The same artifact was stored concurrently
+                shutil.rmtree(temp_path)
+
+        self._set_installed(name, key)
+
+        if self.remote_url and self.upload:
+            self._upload(name, key)
+
+    def _set_installed(self, name: str, key: str):
+        os.makedirs(self._installed_path, exist_ok=True)
+        (self._installed_path / name).write_text(key)
+
+    def _fetch(self, name: str, key: str) -> bool:
+        if not self.remote_url:
+            return False
+
+        archive_name = f'{name}-{key}.tar.gz'
+        checksum = self._remote_read(archive_name + '.sha256')
+
+        if not checksum:
+            return False
+
+        print(f'Downloading {archive_name}')
+        archive = self._remote_read(archive_name)
+
+        if not archive:
+            return False
+
+        expected_checksum = checksum.decode('ascii').split()[0]
+        actual_checksum = hashlib.sha256(archive).hexdigest()
+
+        if actual_checksum != expected_checksum:
+            print(f'WARNING: Checksum of {archive_name} does not match, expected: {expected_checksum}, '
+                  f'actual: {actual_checksum}')
+            return False
+
+        temp_path = self.path / f'{name}-{key}.{os.getpid()}.tmp'
+
+        if temp_path.exists():
+            shutil.rmtree(temp_path)
+
+        os.makedirs(temp_path)
+
+        try:
+            args = ('tar', '-xzf', '-')
+            subprocess.run(args, check=True, cwd=temp_path, env=self.environment, input=archive)
+            os.rename(temp_path, self._artifact_path(name, key))
+        except OSError:
+            # The same artifact was fetched concurrently
+            shutil.rmtree(temp_path)
+        except subprocess.CalledProcessError:
+            shutil.rmtree(temp_path)
+            return False
+
+        return True
+
+    def _upload(self, name: str, key: str):
+        archive_name = f'{name}-{key}.tar.gz'
+
+        if self._remote_read(archive_name + '.sha256'):
+            return
+
+        args = ('tar', '-czf', '-', '.')
+        archive = subprocess.run(args, check=True, cwd=self._artifact_path(name, key), env=self.environment,
+                                 stdout=subprocess.PIPE).stdout
+        checksum = hashlib.sha256(archive).hexdigest()
+
+        print(f'Uploading {archive_name}')
+
+        # Checksum goes last, so incompletely uploaded archive is never fetched
+        self._remote_write(archive_name, archive)
+        self._remote_write(archive_name + '.sha256', f'{checksum}  {archive_name}\n'.encode('ascii'))
+
+    def _remote_read(self, filename: str) -> typing.Optional[bytes]:
+        url = f'{self.remote_url}/{filename}'
+
+        if url.startswith('s3://'):
+            args = ('aws', 's3', 'cp', '--quiet', url, '-')
+            result = subprocess.run(args, env=self.environment, capture_output=True)
+            return result.stdout if result.returncode == 0 else None
+
+        try:
+            with urllib.request.urlopen(self._remote_request(url)) as response:
+                return response.read()
+        except urllib.error.URLError:
+            return None
+
+    def _remote_write(self, filename: str, data: bytes):
+        url = f'{self.remote_url}/{filename}'
+
+        if url.startswith('s3://'):
+            args = ('aws', 's3', 'cp', '--quiet', '-', url)
+            subprocess.run(args, check=True, env=self.environment, input=data)
+        else:
+            urllib.request.urlopen(self._remote_request(url, data)).close()
+
+    def _remote_request(self, url: str, data: typing.Optional[bytes] = None) -> urllib.request.Request:
+        request = urllib.request.Request(url, data=data, method='PUT' if data else 'GET')
+
+        environment = self.environment or os.environ
+        if token := environment.get('AEDI_ARTIFACT_CACHE_TOKEN'):
+            request.add_header('Authorization', f'Bearer {token}')
+
+        return request
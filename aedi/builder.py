@@ -17,28 +17,61 @@
 #
 
 import argparse
+import contextlib
+import copy
+import fcntl
+import hashlib
+import inspect
+import json
 import os
 import shutil
 import subprocess
+import sys
+import time
 import typing
+from concurrent.futures import ThreadPoolExecutor
 from pathlib import Path
 from platform import machine
 
+from .artifact import ArtifactCache
+from .delta import DeltaUpdate
+from .distcc import DistributedCompilation
+from .jobserver import JobServer
+from .memorydisk import MemoryDisk
 from .packaging.version import Version
 from .state import BuildState
 from .target import targets
-from .target.base import Target
+from .target.base import BuildTarget, CMakeTarget, Target
+from .target.special import TestDepsTarget
+from .trace import BuildTrace
 from .utility import (
     OS_VERSION_ARM64,
     OS_VERSION_X86_64,
     CaseInsensitiveDict,
     CommandLineOptions,
     TargetPlatform,
+    clone_tree,
     symlink_directory,
+    symlink_file,
 )
+from .watch import SourceWatcher
 
 
 class Builder(object):
+    # Code generation options for deployment targets newer than baseline CPUs of x86_64 and arm64 slices
+    # x86-64-v2 adds SSE4.2 and POPCNT, x86-64-v3 adds AVX2, BMI2 and FMA, Macs without them cannot run such code
+    TUNING_PROFILES = {
+        'x86-64-v2': '-march=x86-64-v2 -mtune=skylake',
+        'x86-64-v3': '-march=x86-64-v3 -mtune=skylake',
+        'apple-m1': '-mcpu=apple-m1',
+    }
+
+    # Static library, thin 64-bit Mach-O binary, and universal binary
+    BINARY_MAGICS = (b'!<arch>\n', b'\xcf\xfa\xed\xfe', b'\xca\xfe\xba\xbe')
+
+    # Links to files of dependencies in prefix directory, with keys of dependencies they were made for
+    PREFIX_MANIFEST = '.aedi-manifest.json'
+
     def __init__(self, args: list):
         self._targets = CaseInsensitiveDict({target.name: target for target in targets()})
 
@@ -47,12 +80,41 @@ class Builder(object):
         state = self._state = BuildState()
         state.xcode = arguments.xcode
         state.verbose = arguments.verbose
+        state.incremental = arguments.incremental or arguments.watch
+        state.git_clone = arguments.git_clone or 'full'
+        state.dead_strip = arguments.dead_strip
+        state.split_debug_info = arguments.split_debug_info and not arguments.lto
+        state.unity_build = arguments.unity_build
+        state.prelink_deps = arguments.prelink_deps
+        state.time_trace = arguments.time_trace
+
+        if arguments.lto:
+            state.enable_lto(arguments.lto)
+
+        if arguments.variant:
+            state.enable_variant(arguments.variant)
+
+        state.pgo_workload = arguments.pgo_workload and Path(arguments.pgo_workload).absolute()
 
         self._platforms: typing.List[TargetPlatform] = []
         self._populate_platforms(arguments)
 
         state.platform = self._platforms[0]
 
+        # Nested build places its directories on memory disk of its parent, top-level one creates it when asked
+        self._memory_disk = MemoryDisk.from_environment(state.environment)
+
+        if not self._memory_disk and arguments.build_in_memory and not state.xcode:
+            self._memory_disk = MemoryDisk.create(arguments.build_in_memory, state.environment)
+
+        if self._memory_disk:
+            self._memory_disk.export(state.environment)
+            state.memory_disk_path = self._memory_disk.path
+            state.temp_path = state.memory_disk_path / 'temp'
+
+            if state.incremental:
+                print('WARNING: Build directories on memory disk are removed on exit, nothing to reuse next time')
+
         if arguments.temp_path:
             state.temp_path = Path(arguments.temp_path).absolute()
 
@@ -74,27 +136,132 @@ class Builder(object):
             state.external_source = True
             self._detect_target()
 
-        for target in self._targets.values():
-            if target != self._target:
-                target.initialize(state)
+        # Initialization can update files in deps directory
+        with self._prefix_lock():
+            for target in self._targets.values():
+                if target != self._target:
+                    target.initialize(state)
 
         del self._targets
 
+        if arguments.trace or arguments.time_trace:
+            state.trace = BuildTrace(self._target.name)
+
+        if state.variant == 'trace' and self._target.function_traced:
+            state.function_trace = True
+
+        if arguments.pgo and self._target.profile_guided and not state.xcode:
+            state.pgo = arguments.pgo
+
+            for platform in self._platforms:
+                if state.pgo == 'use' and not state.pgo_profile_path(platform.architecture).exists():
+                    print(f'WARNING: No profile data for {platform.architecture}, run pgo-train target first')
+
+        # Ninja cannot build itself because its executable is removed together with the previous installation
+        if arguments.generator == 'ninja' and isinstance(self._target, CMakeTarget) and self._target.name != 'ninja' \
+                and not state.xcode:
+            ninja = state.bin_path / 'ninja'
+
+            if ninja.exists():
+                state.ninja = ninja
+            else:
+                print('Ninja is not built yet, falling back to Unix Makefiles generator')
+
         if arguments.build_path:
             state.build_path = Path(arguments.build_path).absolute()
         else:
-            state.build_path = state.root_path / 'build' / self._target.name / ('xcode' if state.xcode else 'make')
+            generator = 'xcode' if state.xcode else 'ninja' if state.ninja else 'make'
+
+            if state.lto:
+                generator += '-lto'
+
+            if state.variant:
+                generator += '-' + state.variant
+
+            build_root_path = state.memory_disk_path or state.root_path
+            state.build_path = build_root_path / 'build' / self._target.name / generator
 
         if arguments.output_path:
             state.output_path = Path(arguments.output_path).absolute()
         else:
-            state.output_path = state.root_path / 'output'
+            state.output_path = state.root_path / ('output-' + state.variant if state.variant else 'output')
 
         self._environment = state.environment
 
+        if not arguments.no_dependency_profile and self._target.dependency_profile:
+            # Builds of dependencies get the same options, so artifacts of matching variants fill prefix directory
+            for name in self._target.dependency_profile:
+                setattr(arguments, name, True)
+
+            options = ' '.join('--' + name.replace('_', '-') for name in self._target.dependency_profile)
+            print(f'Dependency profile of {self._target.name}: {options}')
+
         state.static_moltenvk = arguments.static_moltenvk
-        state.quasi_glib = arguments.quasi_glib
-        state.jobs = arguments.jobs and arguments.jobs or self._get_default_job_count()
+        state.moltenvk_startup_link = arguments.moltenvk_startup_link
+        state.quasi_glib = arguments.quasi_glib or arguments.quasi_glib_inline
+        state.quasi_glib_inline = arguments.quasi_glib_inline
+        state.openal_low_latency = arguments.openal_low_latency
+        state.openal_fast_init = arguments.openal_fast_init
+        state.zmusic_fast_emulators = arguments.zmusic_fast_emulators
+        state.audio_signposts = arguments.audio_signposts
+        state.ogg_seek_index = arguments.ogg_seek_index
+        distcc = None
+
+        if not state.xcode:
+            # Nested build compiles on hosts checked by its parent, top-level one checks them for the whole build tree
+            distcc = DistributedCompilation.from_environment(self._environment)
+
+            if not distcc and arguments.distcc_hosts:
+                distcc = DistributedCompilation.create(arguments.distcc_hosts, int(self._get_default_job_count()),
+                                                       self._distcc_compilers(), self._environment)
+
+            if distcc:
+                distcc.export(self._environment, state.cache_path)
+                state.distcc = distcc.executable
+
+        # Make and ninja run as many compilation jobs as the whole cluster can take
+        state.jobs = arguments.jobs or (distcc and str(distcc.jobs)) or self._get_default_job_count()
+
+        if not state.xcode:
+            # Nested build joins jobserver of its parent, top-level one creates it for the whole build tree
+            state.jobserver = JobServer.from_environment(self._environment) \
+                or JobServer.create(state.temp_path / f'jobserver-{os.getpid()}', int(state.jobs))
+            state.jobserver.export(self._environment, state.jobs)
+
+        # Target can build without jobserver, so it's closed from here rather than from its state
+        self._jobserver = state.jobserver
+
+        if arguments.compiler_cache:
+            compiler_cache = shutil.which(arguments.compiler_cache, path=self._environment['PATH'])
+
+            if not compiler_cache:
+                raise RuntimeError(f'Cannot find {arguments.compiler_cache} executable')
+
+            state.compiler_cache = Path(compiler_cache)
+
+            if state.distcc and state.compiler_cache.name != 'ccache':
+                raise RuntimeError('Distributed compilation supports ccache only as compiler cache')
+
+        self._watch = arguments.watch
+        self._parallel_platforms = arguments.parallel_platforms
+        self._output_layout = arguments.output_layout
+        self._delta_update = arguments.delta_update
+        self._merge_executor = None
+        self._merge_futures = []
+        self._use_artifact_cache = arguments.artifact_cache or bool(arguments.artifact_cache_url)
+        self._artifact_cache = ArtifactCache(state.cache_path / 'artifacts', arguments.artifact_cache_url,
+                                             arguments.artifact_cache_upload, self._environment, state.deps_path.name)
+        state.forwarded_arguments = self._forwarded_arguments(arguments)
+
+    def _distcc_compilers(self) -> typing.Dict[Path, Path]:
+        state = self._state
+        compilers = {}
+
+        for platform in self._platforms:
+            for compiler in (platform.c_compiler, platform.cxx_compiler):
+                compilers[compiler] = state.deps_path / 'system' / compiler.relative_to(state.prefix_path)
+
+        return compilers
 
     def _get_default_job_count(self):
         args = ('sysctl', '-n', 'hw.ncpu')
@@ -116,13 +283,22 @@ class Builder(object):
             assert os_version >= OS_VERSION_X86_64, f'macOS {os_version} is not supported'
             sdk_path = adjust_sdk_path(arguments.sdk_path_x64)
             platform = TargetPlatform('x86_64', 'x86_64-apple-darwin', os_version, sdk_path, state.prefix_path)
+            platform.tuning_flags = self.TUNING_PROFILES.get(arguments.tune_x64, '')
             self._platforms.append(platform)
 
+            if arguments.fat_x64:
+                # Haswell slice that macOS loads instead of the baseline one on CPUs with AVX2, BMI2 and FMA
+                # Only targets marked for it get this slice, the rest of their dependencies link as baseline code
+                platform = TargetPlatform('x86_64h', 'x86_64h-apple-darwin', os_version, sdk_path, state.prefix_path)
+                platform.tuning_flags = '-mtune=skylake'
+                self._platforms.append(platform)
+
         if not arguments.disable_arm:
             os_version = Version(arguments.os_version_arm) if arguments.os_version_arm else OS_VERSION_ARM64
             assert os_version >= OS_VERSION_ARM64, f'macOS {os_version} is not supported'
             sdk_path = adjust_sdk_path(arguments.sdk_path_arm)
             platform = TargetPlatform('arm64', 'aarch64-apple-darwin', os_version, sdk_path, state.prefix_path)
+            platform.tuning_flags = self.TUNING_PROFILES.get(arguments.tune_arm, '')
             self._platforms.append(platform)
 
         assert len(self._platforms) > 0
@@ -140,6 +316,25 @@ class Builder(object):
 
     def run(self):
         state = self._state
+
+        try:
+            if self._watch:
+                self._run_watched()
+            else:
+                self._run()
+        finally:
+            if self._jobserver:
+                self._jobserver.close()
+
+            if self._memory_disk:
+                self._memory_disk.close(self._environment)
+
+            if state.trace:
+                state.trace.write(BuildTrace.path(state.root_path, self._target.name))
+                state.trace.print_summary()
+
+    def _run(self):
+        state = self._state
         target = self._target
         target.prepare_source(state)
 
@@ -150,27 +345,434 @@ class Builder(object):
 
         assert state.install_path
 
-        if not state.xcode and state.install_path.exists():
-            shutil.rmtree(state.install_path)
+        artifact_key = None
 
-        self._create_prefix_directory()
+        if target.destination == Target.DESTINATION_DEPS:
+            # Artifacts have no debug information, dependencies are built to extract it
+            if self._use_artifact_cache and not state.xcode and not state.split_debug_info:
+                artifact_key = self._artifact_key(target)
+
+            # Installed tree will not match recorded artifact after this build
+            if not artifact_key:
+                self._artifact_cache.forget_installed(target.name)
+
+        delta_update = None
+
+        if target.destination == Target.DESTINATION_OUTPUT and self._delta_update and not state.xcode:
+            delta_update = self._create_delta_update(target)
+            delta_update.keep_previous(self._output_paths(target))
+
+        with self._prefix_lock():
+            with state.phase('restore', 'common'):
+                restored = artifact_key and self._artifact_cache.restore(target.name, artifact_key, state.install_path)
+
+            if restored:
+                print(f'Restored {target.name} from artifact cache')
+                self._create_prefix_directory()
+                return
+
+            # Incremental build replaces installed files when they are ready, the rest of time they remain usable
+            if not state.xcode and not state.incremental and state.install_path.exists():
+                shutil.rmtree(state.install_path)
+
+            self._create_prefix_directory()
 
         if version := state.source_version():
             print(f'Building {version}')
 
+        start_time = time.monotonic()
+
         if target.multi_platform and not state.xcode:
             self._build_multiple_platforms(target)
         else:
             self._build(target)
 
-    def _build(self, target: Target):
+        if not state.xcode:
+            if state.split_debug_info:
+                with state.phase('split-debug-info', 'common'):
+                    self._split_debug_info(target)
+
+            self._report_binary_sizes(target)
+
+            # Only clean builds of main targets are comparable with and without --unity-build
+            if target.destination == Target.DESTINATION_OUTPUT and not state.incremental:
+                self._report_build_time(target, time.monotonic() - start_time)
+
+            if delta_update:
+                with state.phase('delta-update', 'common'):
+                    delta_update.make_patches(self._output_paths(target))
+
+        if artifact_key:
+            with state.phase('store', 'common'):
+                self._artifact_cache.store(target.name, artifact_key, state.install_path)
+
+    def _run_watched(self):
+        if self._state.xcode:
+            raise RuntimeError('Watching for changes is not supported with Xcode project generation')
+
+        # Every build starts from the same state, preparation of source code adjusts source and build paths
+        initial_state = self._state
+        target = self._target
+
+        def rebuild() -> bool:
+            self._state = copy.copy(initial_state)
+
+            try:
+                self._run()
+                return True
+            except Exception as ex:
+                # Failed build doesn't stop watching, the next change can fix it
+                print(f'Failed to build {target.name}: {ex}')
+                return False
+
+        built = rebuild()
+        state = self._state
+        tests = self._watched_tests(target)
+
+        if built:
+            self._run_tests(tests)
+
+        # Source tree is reused, so changes of source files and patches are built by the same incremental steps
+        patches = self._watched_patches(target)
+        paths = [state.source] + patches + tests
+
+        with SourceWatcher(paths) as watcher:
+            while True:
+                print(f'Watching source code, {len(patches)} patches, and {len(tests)} tests and benchmarks '
+                      f'of {target.name} for changes, press Ctrl+C to stop')
+
+                changes = watcher.wait()
+                print('Changed ' + ', '.join(str(path) for path in changes))
+                start_time = time.monotonic()
+
+                # Target is not rebuilt when only its tests and benchmarks were changed, these are run again alone
+                if any(path not in tests for path in changes):
+                    if rebuild():
+                        self._run_tests(tests)
+                else:
+                    self._run_tests(changes)
+
+                print(f'Finished in {time.monotonic() - start_time:.1f} seconds')
+
+                # Source files written by build, e.g. by patching, are not changes to rebuild for
+                watcher.discard(watcher.mark(), (state.source,))
+
+    def _watched_patches(self, target: Target) -> typing.List[Path]:
         state = self._state
+        paths = [state.patch_path / (patch + '.diff') for patch in state.source_patches]
+
+        # Additional files that target takes from its patch directory, see _artifact_key()
+        target_patch_path = state.patch_path / target.name
+
+        if target_patch_path.is_dir():
+            paths.append(target_patch_path)
+
+        return paths
+
+    def _watched_tests(self, target: Target) -> typing.List[Path]:
+        # Tests and benchmarks of libraries installed by target, and the ones named after it, e.g. of tools
+        state = self._state
+        modules = {path.stem for path in (state.install_path / 'lib' / 'pkgconfig').glob('*.pc')}
+        test_path = state.root_path / 'test'
+        tests = []
+
+        for path in sorted(test_path.glob('*.cpp')) + sorted((test_path / 'bench').glob('*.cpp')):
+            if path.stem == target.name or modules & set(TestDepsTarget.pkg_config_modules(path)):
+                # Paths are compared with the ones of changes, which have symbolic links resolved
+                tests.append(Path(os.path.realpath(path)))
+
+        return tests
+
+    def _run_tests(self, tests: typing.Sequence[Path]):
+        state = self._state
+
+        for name, is_benchmark in (('test-deps', False), ('bench-deps', True)):
+            selected = [path.stem for path in tests if (path.parent.name == 'bench') == is_benchmark]
+
+            if not selected:
+                continue
+
+            args = [sys.executable, state.root_path / 'build.py', '--target=' + name]
+            args += state.forwarded_arguments
+
+            environment = self._environment.copy()
+            environment[TestDepsTarget.SELECTION_VARIABLE] = ','.join(selected)
+
+            # Failed test or benchmark regression doesn't stop watching, output tells what went wrong
+            subprocess.run(args, cwd=state.root_path, env=environment)
+
+    def _create_delta_update(self, target: Target) -> DeltaUpdate:
+        xdelta = self._state.bin_path / 'xdelta3'
+
+        if not xdelta.exists():
+            raise RuntimeError('Delta update requires xdelta3 in prefix directory, build xdelta target first')
+
+        return DeltaUpdate(xdelta, self._state.output_path / 'delta' / target.name)
+
+    def _output_paths(self, target: Target) -> typing.List[Path]:
+        # Universal output, and thin ones of --output-layout, see _merge_thin_outputs()
+        install_path = self._state.install_path
+        return [install_path] + [install_path.with_name(f'{install_path.name}-{architecture}')
+                                 for architecture in ('arm64', 'x86_64')]
+
+    def _report_binary_sizes(self, target: Target):
+        # Sizes of static libraries and Mach-O binaries are recorded per build mode
+        # Build in the other mode, with or without --dead-strip, reports differences with the recorded sizes
+        state = self._state
+        sizes = {}
+
+        for path in sorted(state.install_path.rglob('*')):
+            if path.is_file() and not path.is_symlink():
+                with open(path, 'rb') as f:
+                    magic = f.read(8)
+
+                if magic.startswith(self.BINARY_MAGICS):
+                    sizes[str(path.relative_to(state.install_path))] = path.stat().st_size
+
+        if not sizes:
+            return
+
+        sizes_path = state.cache_path / 'binary-sizes.json'
+        mode = 'dead-strip' if state.dead_strip else 'default'
+        other_mode = 'default' if state.dead_strip else 'dead-strip'
+        os.makedirs(state.cache_path, exist_ok=True)
+
+        # Targets built concurrently by deps-all target update the same file
+        with open(state.cache_path / 'binary-sizes.lock', 'w') as lock_file:
+            fcntl.flock(lock_file, fcntl.LOCK_EX)
+
+            try:
+                all_sizes = json.loads(sizes_path.read_text()) if sizes_path.exists() else {}
+                target_sizes = all_sizes.setdefault(target.name, {})
+                target_sizes[mode] = sizes
+
+                # Written to temporary file first, so a build that is interrupted never leaves incomplete file
+                temp_path = sizes_path.with_name(f'{sizes_path.name}.{os.getpid()}.tmp')
+                temp_path.write_text(json.dumps(all_sizes, indent=2, sort_keys=True) + '\n')
+                os.rename(temp_path, sizes_path)
+            finally:
+                fcntl.flock(lock_file, fcntl.LOCK_UN)
+
+        if other_sizes := target_sizes.get(other_mode):
+            print(f'Binary sizes of {target.name} relative to {other_mode} build:')
+            total, other_total = 0, 0
+
+            for name, size in sizes.items():
+                if (other_size := other_sizes.get(name)) is not None:
+                    print(f'  {name}: {other_size} -> {size} ({self._size_delta(size, other_size)})')
+                    total += size
+                    other_total += other_size
+
+            print(f'  Total: {other_total} -> {total} ({self._size_delta(total, other_total)})')
+
+    def _split_debug_info(self, target: Target):
+        # Debug information of dependencies is moved to deps-dsym directory, their binaries keep only symbol names
+        # Linker doesn't copy debug information to executable, its debug map refers to objects in static libraries,
+        # so unstripped archives are kept, and dSYM bundles of main targets are made from them
+        state = self._state
+        is_dependency = target.destination == Target.DESTINATION_DEPS
+        dsym_path = state.dsym_path / target.name if is_dependency else state.install_path
+
+        if is_dependency and dsym_path.exists():
+            shutil.rmtree(dsym_path)
+
+        splits = []
+
+        for path in sorted(state.install_path.rglob('*')):
+            if not path.is_file() or path.is_symlink() or any(part.endswith('.dSYM') for part in path.parts):
+                continue
+
+            is_archive = self._is_archive(path)
+
+            if is_archive is None or (is_archive and not is_dependency):
+                continue
+
+            if is_dependency:
+                debug_path = dsym_path / path.relative_to(state.install_path)
+                os.makedirs(debug_path.parent, exist_ok=True)
+            else:
+                debug_path = dsym_path / path.name
+
+            splits.append((path, debug_path, is_archive))
+
+        archive_maps = [] if is_dependency else self._debug_archive_maps()
+
+        # Every file is processed by its own chain of dsymutil, strip and codesign, those run concurrently
+        with ThreadPoolExecutor(max_workers=int(state.jobs)) as executor:
+            futures = [executor.submit(self._split_file_debug_info, path, debug_path, is_archive, archive_maps)
+                       for path, debug_path, is_archive in splits]
+
+            for future in futures:
+                future.result()
+
+    def _split_file_debug_info(self, path: Path, debug_path: Path, is_archive: bool, archive_maps: typing.List[str]):
+        if is_archive:
+            clone_tree(path, debug_path)
+        else:
+            args = ['dsymutil', path, '-o', debug_path.with_name(debug_path.name + '.dSYM')] + archive_maps
+            subprocess.run(args, check=True, env=self._environment)
+
+        args = ('strip', '-S', path)
+        subprocess.run(args, check=True, env=self._environment)
+
+        if not is_archive:
+            # Stripping invalidates code signature, arm64 binaries cannot be loaded without it
+            args = ('codesign', '--sign', '-', '--force', '--preserve-metadata=entitlements', path)
+            subprocess.run(args, check=True, env=self._environment, stderr=subprocess.DEVNULL)
+
+    def _debug_archive_maps(self) -> typing.List[str]:
+        # Debug map of executable has paths of static libraries as they were given to linker, usually links from prefix
+        state = self._state
+        maps = [f'--object-prefix-map={state.deps_path}{os.sep}={state.dsym_path}{os.sep}']
+
+        if not state.dsym_path.exists():
+            return maps
+
+        for dep_path in sorted(state.dsym_path.iterdir()):
+            for archive_path in sorted(dep_path.rglob('*.a')):
+                prefix_archive_path = state.prefix_path / archive_path.relative_to(dep_path)
+                maps.append(f'--object-prefix-map={prefix_archive_path}={archive_path}')
+
+        return maps
+
+    @staticmethod
+    def _is_archive(path: Path) -> typing.Optional[bool]:
+        # Static library or Mach-O image, universal binary is identified by its first slice, None for other files
+        with open(path, 'rb') as f:
+            magic = f.read(8)
+
+            if magic[:4] == b'\xca\xfe\xba\xbe':
+                # Offset of the first slice follows its CPU type and subtype in big-endian fat_arch structure
+                f.seek(16)
+                f.seek(int.from_bytes(f.read(4), 'big'))
+                magic = f.read(8)
+
+        if magic == b'!<arch>\n':
+            return True
+
+        return False if magic[:4] == b'\xcf\xfa\xed\xfe' else None
+
+    def _report_build_time(self, target: Target, seconds: float):
+        state = self._state
+        times_path = state.cache_path / 'build-times.json'
+        all_times = json.loads(times_path.read_text()) if times_path.exists() else {}
+        target_times = all_times.setdefault(target.name, {})
+
+        mode = 'unity' if state.unity_build else 'default'
+        target_times[mode] = round(seconds, 1)
+
+        other_mode = 'default' if state.unity_build else 'unity'
+        other_seconds = target_times.get(other_mode)
+        comparison = f', {other_mode} build took {other_seconds:.1f} seconds' if other_seconds else ''
+        print(f'Built {target.name} in {seconds:.1f} seconds{comparison}')
+
+        os.makedirs(state.cache_path, exist_ok=True)
+        times_path.write_text(json.dumps(all_times, indent=2, sort_keys=True) + '\n')
+
+    @staticmethod
+    def _size_delta(size: int, other_size: int) -> str:
+        delta = size - other_size
+        percent = f', {delta / other_size:+.1%}' if other_size else ''
+        return f'{delta:+}{percent}'
+
+    def _artifact_key(self, target: Target) -> typing.Optional[str]:
+        state = self._state
+
+        # Only downloaded source packages are identified by checksum, checked out and external sources are not
+        if not state.source_checksum:
+            return None
+
+        # Variant and LTO builds of the same target configure it differently and go to their own deps directories
+        components = [target.name, state.source_checksum, state.variant or '', state.deps_path.name]
+
+        for patch in state.source_patches:
+            components.append((state.patch_path / (patch + '.diff')).read_bytes())
+
+        # Additional files that target takes from its patch directory
+        target_patch_path = state.patch_path / target.name
+
+        if target_patch_path.is_dir():
+            for path in sorted(target_patch_path.rglob('*')):
+                if path.is_file():
+                    components += [str(path.relative_to(state.patch_path)), path.read_bytes()]
+
+        # Options are set by configure methods, so their code identifies options together with build state below
+        for cls in type(target).__mro__:
+            if cls.__module__.startswith('aedi.'):
+                components.append(inspect.getsource(cls))
+
+        components.append(state.compiler_flags().replace(str(state.root_path), ''))
+        components.append(state.linker_flags().replace(str(state.root_path), ''))
+        components += [str(state.static_moltenvk), str(state.moltenvk_startup_link), str(state.quasi_glib),
+                       str(state.quasi_glib_inline), str(state.openal_low_latency), str(state.openal_fast_init),
+                       str(state.zmusic_fast_emulators), str(state.audio_signposts), str(state.ogg_seek_index)]
+
+        for platform in self._target_platforms(target):
+            sdk = platform.sdk_path.name if platform.sdk_path else ''
+            components += [platform.architecture, str(platform.os_version), sdk, platform.tuning_flags]
+
+        # Default SDK is the one from Xcode that provides clang
+        for args in (('clang', '--version'), ('xcrun', '--sdk', 'macosx', '--show-sdk-version')):
+            components.append(subprocess.run(args, check=True, capture_output=True, env=self._environment).stdout)
+
+        # Rebuilt dependency changes the key, so do dependencies built without artifact cache
+        for dependency in sorted(set(target.dependencies) - {target.name}):
+            components += [dependency, self._artifact_cache.installed_key(dependency)]
+
+        return ArtifactCache.key(components)
+
+    def _build(self, target: Target, state: typing.Optional[BuildState] = None):
+        if not state:
+            state = self._state
+
         state.environment = self._environment.copy()
         state.options = CommandLineOptions()
 
-        target.configure(state)
-        target.build(state)
-        target.post_build(state)
+        use_compiler_cache = state.compiler_cache and isinstance(target, BuildTarget) and not state.xcode
+
+        if use_compiler_cache:
+            self._prepare_compiler_cache(state)
+
+        with state.phase('configure'):
+            target.configure(state)
+
+        with state.phase('build'):
+            target.build(state)
+
+        if state.time_trace and state.trace and state.build_path.exists():
+            state.trace.add_time_traces(state.build_path, state.architecture())
+
+        # Single platform targets install directly into shared directory
+        with self._prefix_lock() if state is self._state else contextlib.nullcontext(), state.phase('install'):
+            target.post_build(state)
+
+        if use_compiler_cache:
+            print(f'Compiler cache statistics for {state.architecture() or target.name}')
+            args = (state.compiler_cache, '--show-stats')
+            subprocess.run(args, check=True, env=state.environment)
+
+    @staticmethod
+    def _prepare_compiler_cache(state: BuildState):
+        env = state.environment
+
+        if state.compiler_cache.name == 'ccache':
+            # Separate cache for every platform and SDK, so they never evict each other's objects
+            # sccache has one server with its own directory, platforms and SDKs are distinguished by compiler arguments
+            sdk_version = state.sdk_version() or 'default'
+            env['CCACHE_DIR'] = str(state.cache_path / f'ccache-{state.architecture()}-{sdk_version}')
+            env['CCACHE_BASEDIR'] = str(state.root_path)
+
+            # Compilers are shell scripts that call Xcode's clang, use its version instead of script's modification time
+            env['CCACHE_COMPILERCHECK'] = '%compiler% --version'
+            env['CCACHE_COMPILERTYPE'] = 'clang'
+
+            if state.distcc:
+                # Cache misses are compiled remotely, ccache runs preprocessor locally as distcc does
+                env['CCACHE_PREFIX'] = str(state.distcc)
+
+        # Statistics are reset to show hit rate of the current build only
+        args = (state.compiler_cache, '--zero-stats')
+        subprocess.run(args, check=True, env=env, stdout=subprocess.DEVNULL)
 
     def _build_multiple_platforms(self, target: Target):
         assert target.multi_platform
@@ -178,40 +780,181 @@ class Builder(object):
         state = self._state
         base_build_path = state.build_path
         base_install_path = state.install_path
-        install_paths = []
+        platform_states = []
 
-        for platform in self._platforms:
-            if platform.architecture in target.unsupported_architectures:
+        for platform in self._target_platforms(target):
+            platform_state = copy.copy(state)
+            platform_state.platform = platform
+            platform_state.build_path = base_build_path / ('build_' + platform.architecture)
+            platform_state.install_path = base_build_path / ('install_' + platform.architecture)
+
+            if platform.architecture == machine():
+                state.native_build_path = platform_state.build_path
+
+            platform_states.append(platform_state)
+
+        for platform_state in platform_states:
+            platform_state.native_build_path = state.native_build_path
+
+        if self._parallel_platforms and target.concurrent_platforms and len(platform_states) > 1:
+            self._build_concurrently(target, platform_states)
+        else:
+            for platform_state in platform_states:
+                self._build(target, platform_state)
+
+        install_paths = [platform_state.install_path for platform_state in platform_states]
+        thin_output = target.destination == Target.DESTINATION_OUTPUT and self._output_layout != 'universal'
+
+        if not thin_output or self._output_layout == 'all':
+            with self._prefix_lock():
+                self._merge_platforms(install_paths, base_install_path)
+
+        if thin_output:
+            self._merge_thin_outputs(target, platform_states, base_install_path)
+
+    def _merge_thin_outputs(self, target: Target, platform_states: typing.Sequence[BuildState],
+                            base_install_path: Path):
+        # Every architecture gets its own bundle, Intel one keeps Haswell slice together with the baseline one
+        groups: typing.Dict[str, typing.List[BuildState]] = {}
+
+        for platform_state in platform_states:
+            architecture = platform_state.architecture()
+            groups.setdefault('x86_64' if architecture == 'x86_64h' else architecture, []).append(platform_state)
+
+        sizes = {base_install_path.name: self._tree_size(base_install_path)} if base_install_path.exists() else {}
+
+        for architecture, group_states in groups.items():
+            thin_install_path = base_install_path.with_name(f'{base_install_path.name}-{architecture}')
+
+            if len(group_states) > 1:
+                self._merge_platforms([group_state.install_path for group_state in group_states], thin_install_path)
+            else:
+                if thin_install_path.exists():
+                    shutil.rmtree(thin_install_path)
+
+                clone_tree(group_states[0].install_path, thin_install_path)
+
+            self._thin_universal_files(thin_install_path, [group_state.architecture() for group_state in group_states])
+            sizes[thin_install_path.name] = self._tree_size(thin_install_path)
+
+        print(f'Output sizes of {target.name}:')
+
+        universal_size = sizes.get(base_install_path.name)
+
+        for name, size in sizes.items():
+            delta = f' ({self._size_delta(size, universal_size)})' if universal_size and size != universal_size else ''
+            print(f'  {name}: {size}{delta}')
+
+    def _thin_universal_files(self, path: Path, architectures: typing.Sequence[str]):
+        # Universal files taken from prefix directory, like MoltenVK library, keep slices of bundle's architectures only
+        for file_path in sorted(path.rglob('*')):
+            if not file_path.is_file() or file_path.is_symlink():
                 continue
 
-            state.platform = platform
-            state.build_path = base_build_path / ('build_' + platform.architecture)
+            with open(file_path, 'rb') as f:
+                if f.read(4) != b'\xca\xfe\xba\xbe':
+                    continue
 
-            if platform.architecture == machine():
-                state.native_build_path = state.build_path
+            args = ('lipo', '-archs', file_path)
+            file_architectures = subprocess.run(args, check=True, capture_output=True, env=self._environment)
+            file_architectures = file_architectures.stdout.decode('ascii').split()
+            kept_architectures = [architecture for architecture in file_architectures if architecture in architectures]
 
-            state.install_path = base_build_path / ('install_' + platform.architecture)
+            if not kept_architectures or kept_architectures == file_architectures:
+                continue
 
-            self._build(target)
+            args = ['lipo', file_path, '-output', file_path]
 
-            install_paths.append(state.install_path)
+            if len(kept_architectures) == 1:
+                args += ['-thin', kept_architectures[0]]
+            else:
+                for architecture in kept_architectures:
+                    args += ['-extract', architecture]
 
-        self._merge_install_paths(install_paths, base_install_path)
+            subprocess.run(args, check=True, env=self._environment)
 
     @staticmethod
-    def _compare_files(paths: typing.Sequence[Path]) -> bool:
-        content = None
+    def _tree_size(path: Path) -> int:
+        size = 0
+
+        for root, _, files in os.walk(path):
+            for filename in files:
+                size += os.lstat(os.path.join(root, filename)).st_size
+
+        return size
+
+    def _merge_platforms(self, src_paths: typing.Sequence[Path], dst_path: Path):
+        with self._state.phase('merge', 'common'):
+            self._merge_platforms_concurrently(src_paths, dst_path)
 
+    def _merge_platforms_concurrently(self, src_paths: typing.Sequence[Path], dst_path: Path):
+        start_time = time.monotonic()
+
+        # Directories are traversed on this thread, files are merged by the pool, lipo and codesign dominate anyway
+        with ThreadPoolExecutor(max_workers=int(self._state.jobs)) as executor:
+            self._merge_executor = executor
+            self._merge_futures = []
+
+            try:
+                self._merge_install_paths(src_paths, dst_path)
+            finally:
+                self._merge_executor = None
+
+            for future in self._merge_futures:
+                future.result()
+
+        elapsed = time.monotonic() - start_time
+        print(f'Merged {len(self._merge_futures)} files in {elapsed:.1f} seconds')
+
+    def _target_platforms(self, target: Target) -> typing.List[TargetPlatform]:
+        return [platform for platform in self._platforms
+                if platform.architecture not in target.unsupported_architectures
+                and (platform.architecture != 'x86_64h' or target.fat_x86_64)]
+
+    def _build_concurrently(self, target: Target, platform_states: typing.Sequence[BuildState]):
+        # Split compilation jobs between platforms, configure steps are mostly single-threaded anyway
+        # Make takes jobserver tokens regardless of this, the split limits only tools without jobserver support
+        platform_count = len(platform_states)
+        jobs = str(max(int(self._state.jobs) // platform_count, 1))
+
+        for platform_state in platform_states:
+            platform_state.jobs = jobs
+
+        # Every platform gets its own copy of target because some targets modify their attributes during build
+        with ThreadPoolExecutor(max_workers=platform_count) as executor:
+            futures = [executor.submit(self._build_in_slot, copy.copy(target), platform_state)
+                       for platform_state in platform_states]
+
+            for future in futures:
+                future.result()
+
+    def _build_in_slot(self, target: Target, state: BuildState):
+        with state.job_slot():
+            self._build(target, state)
+
+    @staticmethod
+    def _compare_files(paths: typing.Sequence[Path]) -> bool:
+        # Sizes are compared first, so only files that may match are read, in blocks without loading them entirely
         for path in paths:
             if not path.exists():
                 return False
 
+        if len(set(path.stat().st_size for path in paths)) != 1:
+            return False
+
+        digest = None
+
+        for path in paths:
+            hasher = hashlib.sha256()
+
             with path.open('rb') as f:
-                if content:
-                    if content != f.read():
-                        return False
-                else:
-                    content = f.read()
+                while block := f.read(1024 * 1024):
+                    hasher.update(block)
+
+            if not digest:
+                digest = hasher.digest()
+            elif digest != hasher.digest():
+                return False
 
         return True
 
@@ -242,7 +985,18 @@ class Builder(object):
         else:
             if not Builder._compare_files(src_sub_paths):
                 print(f'WARNING: Source files for {dst_path / src.name} don\'t match')
-            shutil.copy(src_sub_paths[0], dst_path)
+            clone_tree(src_sub_paths[0], dst_path / src.name)
+
+    def _submit_merge_file(self, src: Path, src_sub_paths: typing.Sequence[Path], dst_path: Path):
+        if self._merge_executor:
+            future = self._merge_executor.submit(self._merge_file_in_slot, src, src_sub_paths, dst_path)
+            self._merge_futures.append(future)
+        else:
+            self._merge_file(src, src_sub_paths, dst_path)
+
+    def _merge_file_in_slot(self, src: Path, src_sub_paths: typing.Sequence[Path], dst_path: Path):
+        with self._state.job_slot():
+            self._merge_file(src, src_sub_paths, dst_path)
 
     def _merge_missing_files(self, src_paths: typing.Sequence[Path], dst_path: Path):
         shifted_src_paths = [path for path in src_paths]
@@ -261,8 +1015,12 @@ class Builder(object):
         if len(src_paths) == 0:
             return
 
+        incremental = self._state.incremental
+
         if not missing_files_only:
-            if dst_path.exists():
+            if incremental:
+                self._remove_stale_entries(src_paths, dst_path)
+            elif dst_path.exists():
                 shutil.rmtree(dst_path)
 
         os.makedirs(dst_path, exist_ok=True)
@@ -275,30 +1033,167 @@ class Builder(object):
             elif src.name.endswith('.la'):
                 # Skip libtool files
                 continue
+            elif incremental and Builder._is_merged(src_sub_paths, dst_path / src.name):
+                continue
+            elif incremental and os.path.lexists(dst_path / src.name) and src.is_symlink():
+                # Symbolic link cannot be copied over the existing one
+                os.unlink(dst_path / src.name)
+                self._submit_merge_file(src, src_sub_paths, dst_path)
             elif missing_files_only:
                 for src_sub_path in src_sub_paths[1:]:
                     if not src_sub_path.exists():
                         shutil.copy(src_sub_paths[0], dst_path)
             else:
-                self._merge_file(src, src_sub_paths, dst_path)
+                self._submit_merge_file(src, src_sub_paths, dst_path)
 
         if not missing_files_only:
             self._merge_missing_files(src_paths, dst_path)
 
+    @staticmethod
+    def _remove_stale_entries(src_paths: typing.Sequence[Path], dst_path: Path):
+        # Files and directories of merged tree that are no longer installed by any platform
+        if not dst_path.is_dir() or dst_path.is_symlink():
+            return
+
+        names = set()
+
+        for src_path in src_paths:
+            if src_path.is_dir():
+                names.update(entry.name for entry in src_path.iterdir())
+
+        for entry in dst_path.iterdir():
+            if entry.name in names:
+                continue
+
+            if entry.is_dir() and not entry.is_symlink():
+                shutil.rmtree(entry)
+            else:
+                entry.unlink()
+
+    @staticmethod
+    def _is_merged(src_paths: typing.Sequence[Path], dst_path: Path) -> bool:
+        # Merged file is newer than its sources when they weren't changed by the last installation
+        if not os.path.lexists(dst_path):
+            return False
+
+        merge_time = dst_path.lstat().st_mtime
+
+        for src_path in src_paths:
+            if os.path.lexists(src_path) and src_path.lstat().st_mtime > merge_time:
+                return False
+
+        return True
+
+    @contextlib.contextmanager
+    def _prefix_lock(self):
+        # Serializes changes of deps and prefix directories between concurrently running builds, see deps-all target
+        with open(self._state.temp_path / 'prefix.lock', 'w') as lock_file:
+            fcntl.flock(lock_file, fcntl.LOCK_EX)
+
+            try:
+                yield
+            finally:
+                fcntl.flock(lock_file, fcntl.LOCK_UN)
+
     def _create_prefix_directory(self):
+        with self._state.phase('prefix', 'common'):
+            self._symlink_prefix_directory()
+
+    def _symlink_prefix_directory(self):
         state = self._state
         os.makedirs(state.prefix_path, exist_ok=True)
+        os.makedirs(state.deps_path, exist_ok=True)
+
+        # LTO build takes tools and not yet rebuilt libraries from native dependencies, existing links are kept
+        deps_paths = (state.deps_path, state.native_deps_path) if state.native_deps_path else (state.deps_path,)
+        deps = [dep for deps_path in deps_paths for dep in sorted(deps_path.iterdir()) if dep.is_dir()]
+
+        # Links of every dependency are recorded, so only changed dependencies are linked again
+        manifest_path = state.prefix_path / self.PREFIX_MANIFEST
+        manifest = json.loads(manifest_path.read_text()) if manifest_path.exists() else {}
+        keys = {str(dep): self._dep_tree_key(dep) for dep in deps}
+
+        if not manifest or manifest.keys() - keys.keys():
+            # The first build, or removed dependencies, their links can be anywhere in prefix directory
+            manifest = self._symlink_all_dependencies(deps)
+        else:
+            changed = [dep for dep in deps if manifest.get(str(dep), {}).get('key') != keys[str(dep)]]
+
+            if not changed:
+                return
 
+            self._symlink_changed_dependencies(deps, changed, manifest)
+
+        for name, key in keys.items():
+            manifest[name]['key'] = key
+
+        manifest_path.write_text(json.dumps(manifest, indent=1, sort_keys=True) + '\n')
+
+    @staticmethod
+    def _dep_tree_key(path: Path) -> list:
+        # Installation replaces dependency directory, and adding or removing a file at any depth
+        # changes modification time of directory that contains it, so every directory is a part of the key
+        key = [path.stat().st_ino]
+
+        for root, dirs, _ in os.walk(path):
+            dirs.sort()
+            key += [os.path.relpath(root, path), os.stat(root).st_mtime_ns]
+
+        return key
+
+    def _symlink_all_dependencies(self, deps: typing.Sequence[Path]) -> dict:
+        prefix_path = self._state.prefix_path
+        manifest = {}
         cleanup = True
 
-        for dep in state.deps_path.iterdir():
-            if dep.is_dir():
-                symlink_directory(dep, state.prefix_path, cleanup)
+        for dep in deps:
+            links = []
+            symlink_directory(dep, prefix_path, cleanup, links)
+            manifest[str(dep)] = {'links': [str(link.relative_to(prefix_path)) for link in links]}
+
+            # Do symlink cleanup only once
+            cleanup = False
+
+        Builder._remove_empty_directories(prefix_path)
 
-                # Do symlink cleanup only once
-                cleanup = False
+        return manifest
 
-        Builder._remove_empty_directories(state.prefix_path)
+    def _symlink_changed_dependencies(self, deps: typing.Sequence[Path], changed: typing.Sequence[Path],
+                                      manifest: dict):
+        prefix_path = self._state.prefix_path
+        removed_links = set()
+
+        for dep in changed:
+            for link in manifest.get(str(dep), {}).get('links', ()):
+                link_path = prefix_path / link
+
+                if link_path.is_symlink():
+                    link_path.unlink()
+                    removed_links.add(link)
+
+        for dep in changed:
+            links = []
+            symlink_directory(dep, prefix_path, False, links)
+            manifest[str(dep)] = {'links': [str(link.relative_to(prefix_path)) for link in links]}
+            removed_links -= set(manifest[str(dep)]['links'])
+
+        # Files that changed dependencies have no more can be provided by other dependencies
+        for link in sorted(removed_links):
+            link_path = prefix_path / link
+
+            for dep in deps:
+                if os.path.lexists(dep / link):
+                    symlink_file(dep / link, link_path)
+                    manifest[str(dep)]['links'].append(link)
+                    break
+            else:
+                Builder._remove_empty_parent_directories(link_path.parent, prefix_path)
+
+    @staticmethod
+    def _remove_empty_parent_directories(path: Path, root_path: Path):
+        while path != root_path and not os.listdir(path):
+            os.rmdir(path)
+            path = path.parent
 
     @staticmethod
     def _remove_empty_directories(path: Path) -> int:
@@ -319,13 +1214,70 @@ class Builder(object):
         return removed
 
     def _detect_target(self):
-        for name, target in self._targets.items():
-            if target.detect(self._state):
-                self._target = self._targets[name]
-                break
+        state = self._state
+
+        # Target detected for the same source directory before is checked first, alone
+        cache_path = state.cache_path / 'detected-targets.json'
+        cache = json.loads(cache_path.read_text()) if cache_path.exists() else {}
+        key = self._detection_key()
+
+        if (entry := cache.get(str(state.source))) and entry['key'] == key:
+            target = self._targets.get(entry['target'])
+
+            if target and target.detect(state):
+                self._target = target
+                return
+
+        with state.memoized_source_files():
+            for name, target in self._targets.items():
+                if target.detect(state):
+                    self._target = self._targets[name]
+                    break
 
         assert self._target
 
+        cache[str(state.source)] = {'key': key, 'target': self._target.name}
+        os.makedirs(state.cache_path, exist_ok=True)
+        cache_path.write_text(json.dumps(cache, indent=2, sort_keys=True) + '\n')
+
+    def _detection_key(self) -> typing.List[int]:
+        # Adding or removing files in top level directory, or editing CMakeLists.txt, may change detected target
+        key = []
+
+        for path in (self._state.source, self._state.source / 'CMakeLists.txt'):
+            key.append(path.stat().st_mtime_ns if path.exists() else 0)
+
+        return key
+
+    @staticmethod
+    def _forwarded_arguments(arguments) -> typing.List[str]:
+        # Arguments that apply to all targets when building one target runs builds of other targets
+        result = []
+
+        for name in ('verbose', 'incremental', 'fat_x64', 'dead_strip', 'split_debug_info', 'trace', 'time_trace',
+                     'disable_x64', 'disable_arm', 'parallel_platforms', 'artifact_cache', 'artifact_cache_upload',
+                     'static_moltenvk', 'moltenvk_startup_link', 'quasi_glib', 'quasi_glib_inline',
+                     'openal_low_latency', 'openal_fast_init', 'zmusic_fast_emulators', 'audio_signposts',
+                     'ogg_seek_index'):
+            if getattr(arguments, name):
+                result.append('--' + name.replace('_', '-'))
+
+        for name in ('os_version_x64', 'os_version_arm', 'tune_x64', 'tune_arm', 'compiler_cache', 'generator',
+                     'git_clone', 'lto', 'variant', 'pgo', 'artifact_cache_url', 'source_path', 'temp_path',
+                     'sdk_path_x64', 'sdk_path_arm'):
+            if value := getattr(arguments, name):
+                result.append(f'--{name.replace("_", "-")}={value}')
+
+        return result
+
+    @staticmethod
+    def _variant_name(name: str) -> str:
+        # Name is a part of directory names, e.g. deps-<name> and prefix-<name>
+        if not name or not name.replace('-', '').isalnum() or not name.islower() or name == 'lto':
+            raise argparse.ArgumentTypeError(f'invalid variant name: {name}')
+
+        return name
+
     def _parse_arguments(self, args: list):
         assert self._targets
 
@@ -339,8 +1291,59 @@ class Builder(object):
         group.add_argument('--xcode', action='store_true', help='generate Xcode project instead of build')
         group.add_argument('--os-version-x64', metavar='version', help='macOS deployment version for x86_64')
         group.add_argument('--os-version-arm', metavar='version', help='macOS deployment version for ARM64')
+        group.add_argument('--tune-x64', choices=('x86-64-v2', 'x86-64-v3'),
+                           help='x86_64 CPU level to generate code for, baseline by default')
+        group.add_argument('--tune-arm', choices=('apple-m1',),
+                           help='ARM64 CPU to generate code for, generic by default')
+        group.add_argument('--fat-x64', action='store_true',
+                           help='add x86_64h slice with Haswell code to game and its hot dependencies')
         group.add_argument('--verbose', action='store_true', help='enable verbose build output')
+        group.add_argument('--incremental', action='store_true',
+                           help='reuse configured build directories, and update only changed installed files')
+        group.add_argument('--watch', action='store_true',
+                           help='rebuild incrementally on changes of source code and patches of target, '
+                                'and run its tests and benchmarks after every build, implies --incremental')
         group.add_argument('--jobs', help='number of parallel compilation jobs')
+        group.add_argument('--parallel-platforms', action='store_true',
+                           help='build all platforms concurrently, splitting jobs between them')
+        group.add_argument('--compiler-cache', choices=('ccache', 'sccache'),
+                           help='use compiler cache to speed up rebuilds')
+        group.add_argument('--distcc-hosts', metavar='hosts',
+                           help='comma-separated list of host[/jobs] build Macs to compile on with distcc over SSH')
+        group.add_argument('--git-clone', choices=('full', 'blobless', 'shallow'),
+                           help='kind of git clone of checked out targets, full by default')
+        group.add_argument('--artifact-cache', action='store_true',
+                           help='restore dependencies from artifact cache, and store built ones into it')
+        group.add_argument('--artifact-cache-url', metavar='url',
+                           help='HTTPS or s3:// URL of remote artifact cache shared between machines')
+        group.add_argument('--artifact-cache-upload', action='store_true',
+                           help='upload built dependencies to remote artifact cache')
+        group.add_argument('--lto', choices=('thin',),
+                           help='compile with link-time optimization, dependencies go to deps-lto directory')
+        group.add_argument('--variant', metavar='name', type=self._variant_name,
+                           help='build variant, e.g. perf, debug or profile, dependencies go to deps-<name> directory')
+        group.add_argument('--pgo', choices=('generate', 'use'),
+                           help='build instrumented or profile-optimized game and its hot dependencies')
+        group.add_argument('--pgo-workload', metavar='path', help='shell script that pgo-train target runs')
+        group.add_argument('--dead-strip', action='store_true',
+                           help='compile with function and data sections, link with removal of unused code and data')
+        group.add_argument('--unity-build', action='store_true',
+                           help='compile main targets as unity build with precompiled headers')
+        group.add_argument('--split-debug-info', action='store_true',
+                           help='compile with debug information, and move it from binaries to dSYM bundles and '
+                                'deps-dsym directory, not supported with LTO')
+        group.add_argument('--output-layout', choices=('universal', 'thin', 'all'), default='universal',
+                           help='merge main targets into universal bundle, or make bundle per architecture, or both')
+        group.add_argument('--prelink-deps', action='store_true',
+                           help='link game with one relocatable object prelinked from all its static dependencies')
+        group.add_argument('--trace', action='store_true',
+                           help='record time of build phases, and write it as Chrome trace to build/trace directory')
+        group.add_argument('--time-trace', action='store_true',
+                           help='same as --trace, and compile with clang -ftime-trace to find slow translation units')
+        group.add_argument('--delta-update', action='store_true',
+                           help='make xdelta3 patches from previous to new output of main target for updater')
+        group.add_argument('--generator', choices=('make', 'ninja'),
+                           help='build system generator for CMake targets, Unix Makefiles by default')
 
         excl_group = parser.add_mutually_exclusive_group()
         excl_group.add_argument('--disable-x64', action='store_true', help='disable x86_64 support')
@@ -350,6 +1353,8 @@ class Builder(object):
         group.add_argument('--source-path', metavar='path',
                            help='path to store downloaded and checked out source code')
         group.add_argument('--build-path', metavar='path', help='target build path')
+        group.add_argument('--build-in-memory', metavar='size',
+                           help='place build and temporary directories on RAM disk of given size, e.g. 16G')
         group.add_argument('--output-path', metavar='path', help='output path for main targets')
         group.add_argument('--temp-path', metavar='path', help='path to temporary files directory')
         group.add_argument('--sdk-path-x64', metavar='path', help='path to macOS SDK for x86_64')
@@ -357,6 +1362,22 @@ class Builder(object):
 
         group = parser.add_argument_group('Hacks')
         group.add_argument('--static-moltenvk', action='store_true', help='link with static MoltenVK library')
+        group.add_argument('--moltenvk-startup-link', action='store_true',
+                           help='link MoltenVK dylib with Vulkan exports only, dead stripping and launch order file')
         group.add_argument('--quasi-glib', action='store_true', help='link with QuasiGlib library')
+        group.add_argument('--quasi-glib-inline', action='store_true',
+                           help='compile FluidSynth with inline QuasiGlib fast paths, implies --quasi-glib')
+        group.add_argument('--openal-low-latency', action='store_true',
+                           help='build OpenAL Soft with CoreAudio backend only, and set low latency defaults for games')
+        group.add_argument('--openal-fast-init', action='store_true',
+                           help='build OpenAL Soft with embedded HRTF that stays loaded when device is reopened')
+        group.add_argument('--zmusic-fast-emulators', action='store_true',
+                           help='build ZMusic with fast OPL3 and OPN2 emulator cores only')
+        group.add_argument('--audio-signposts', action='store_true',
+                           help='build ZMusic, OpenAL Soft and FluidSynth with os_signpost intervals of audio work')
+        group.add_argument('--ogg-seek-index', action='store_true',
+                           help='build libsndfile with page table of Ogg files that limits search of loop restarts')
+        group.add_argument('--no-dependency-profile', action='store_true',
+                           help='don\'t enable options of dependency variants that main target links by default')
 
         return parser.parse_args(args)
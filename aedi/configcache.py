@@ -0,0 +1,272 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import contextlib
+import fcntl
+import json
+import os
+import re
+import subprocess
+import typing
+from pathlib import Path
+
+from .artifact import ArtifactCache
+from .state import BuildState
+
+# Compiler versions by path of compiler, querying them once per process is enough
+_compiler_versions: typing.Dict[Path, bytes] = {}
+
+
+def cache_name(state: BuildState) -> str:
+    # Architecture and SDK are in plain text, everything else that changes results of checks is hashed
+    compiler = state.c_compiler()
+
+    if compiler not in _compiler_versions:
+        args = (compiler, '--version')
+        _compiler_versions[compiler] = subprocess.run(args, check=True, capture_output=True,
+                                                      env=state.environment).stdout
+
+    key = ArtifactCache.key((
+        str(state.os_version()),
+        str(state.sdk_path() or ''),
+        state.platform.tuning_flags,
+        state.lto or '',
+        state.pgo or '',
+        _compiler_versions[compiler],
+    ))
+
+    return f'{state.architecture()}-{state.sdk_version() or "default"}-{key[:16]}'
+
+
+@contextlib.contextmanager
+def _lock(path: Path):
+    # Targets built concurrently by deps-all target share caches of their architectures
+    os.makedirs(path.parent, exist_ok=True)
+
+    with open(path, 'w') as lock_file:
+        fcntl.flock(lock_file, fcntl.LOCK_EX)
+
+        try:
+            yield
+        finally:
+            fcntl.flock(lock_file, fcntl.LOCK_UN)
+
+
+class ConfigCache(object):
+    """
+    Results of autoconf checks shared by configure scripts of all targets, one cache per architecture and SDK
+    Cache file name has a hash of everything else that changes results of checks, i.e. deployment target, compiler
+    version, tuning, LTO and PGO flags, so a cache made with other SDK or compiler is never used, see cache_name()
+
+    Every configure script works on its own copy, so failing or interrupted one never damages shared cache
+    After successful configure, its new results are added to shared cache, except the ones specific to target
+    """
+
+    # Precious variables and host triplets given to configure, found programs, libraries and pkg-config modules,
+    # and checks of iconv and gettext that look for them in prefix directory, depend on target and its dependencies
+    EXCLUDED_PATTERN = re.compile(r'ac_cv_env_|ac_cv_(build|host|target)$|ac_cv_(lib|search|path|prog)_|pkg_cv_'
+                                  r'|.*(iconv|intl|gettext)')
+
+    # Missing header can be installed to prefix directory by another target later
+    MISSING_HEADER_PATTERN = re.compile(r'ac_cv_header_\w+=\$\{ac_cv_header_\w+=no}$')
+
+    # Autoconf writes cache variables either as name=${name=value} or as test "${name+set}" = set || name=value
+    ENTRY_PATTERN = re.compile(r'(?:test "\$\{(\w+)\+set}" = set \|\| )?(\w+)=')
+
+    def __init__(self, state: BuildState):
+        cache_path = state.cache_path / 'autoconf'
+        self.path = cache_path / f'{cache_name(state)}.cache'
+        self._lock_path = cache_path / f'{state.architecture()}.lock'
+
+    @staticmethod
+    def is_autoconf_script(path: Path) -> bool:
+        # Handwritten configure scripts reject unknown --cache-file option
+        try:
+            with open(path, 'rb') as f:
+                return b'Generated by GNU Autoconf' in f.read(1024)
+        except OSError:
+            return False
+
+    def restore(self, path: Path):
+        with _lock(self._lock_path):
+            content = self.path.read_text() if self.path.exists() else ''
+
+        path.write_text(content)
+
+    def store(self, path: Path):
+        if not path.exists():
+            return
+
+        entries = {name: entry for name, entry in self._read_entries(path.read_text())
+                   if not self.EXCLUDED_PATTERN.match(name) and not self.MISSING_HEADER_PATTERN.match(entry)}
+
+        with _lock(self._lock_path):
+            shared_entries = dict(self._read_entries(self.path.read_text())) if self.path.exists() else {}
+            new_names = entries.keys() - shared_entries.keys()
+
+            if not new_names:
+                return
+
+            for name in new_names:
+                shared_entries[name] = entries[name]
+
+            lines = ['# Autoconf cache shared by all targets, see ConfigCache\n']
+            lines += [shared_entries[name] for name in sorted(shared_entries)]
+
+            # Written to temporary file first, so configure of another target never reads incomplete cache
+            temp_path = self.path.with_name(f'{self.path.name}.{os.getpid()}.tmp')
+            temp_path.write_text(''.join(lines))
+            os.rename(temp_path, self.path)
+
+    @classmethod
+    def _read_entries(cls, content: str) -> typing.List[typing.Tuple[str, str]]:
+        entries = []
+
+        for line in content.splitlines(keepends=True):
+            if line.startswith('#'):
+                continue
+
+            if match := cls.ENTRY_PATTERN.match(line):
+                entries.append((match[1] or match[2], line))
+            elif entries:
+                # Continuation of quoted multiline value
+                name, entry = entries[-1]
+                entries[-1] = (name, entry + line)
+
+        return entries
+
+
+class CMakeCheckCache(object):
+    """
+    Results of CMake checks for headers, functions, symbols and type sizes shared by all targets, like ConfigCache
+    Every configure gets them as initial cache script, so check modules find their variables defined and skip checks
+
+    Projects name result variables themselves, so the same variable can mean different checks in different projects
+    Variable that ever had different values or descriptions is considered specific to target, it's never shared again
+    """
+
+    # Cache entry descriptions that CheckIncludeFile, CheckFunctionExists, CheckSymbolExists, CheckTypeSize,
+    # and similar modules set for their result variables
+    SHARED_CHECKS = ('Have include ', 'Have includes ', 'Have function ', 'Have symbol ', 'Have variable ',
+                     'CHECK_TYPE_SIZE: ')
+
+    # Results of iconv and gettext checks depend on libraries in prefix directory and on linked ones
+    EXCLUDED_PATTERN = re.compile(r'iconv|intl|gettext', re.IGNORECASE)
+
+    ENTRY_PATTERN = re.compile(r'([^:=]+):INTERNAL=(.*)')
+
+    def __init__(self, state: BuildState):
+        cache_path = state.cache_path / 'cmake'
+        self.path = cache_path / f'{cache_name(state)}.json'
+        self._lock_path = cache_path / f'{state.architecture()}.lock'
+
+    def write_initial_cache(self, path: Path):
+        with _lock(self._lock_path):
+            entries = self._load()['entries']
+
+        lines = ['# Results of checks shared by all targets, see CMakeCheckCache\n']
+
+        for name in sorted(entries):
+            value, description = entries[name]
+            lines.append(f'set({name} "{self._escape(value)}" CACHE INTERNAL "{self._escape(description)}")\n')
+
+        path.write_text(''.join(lines))
+
+    @staticmethod
+    def _escape(value: str) -> str:
+        return value.replace('\\', '\\\\').replace('"', '\\"').replace('$', '\\$')
+
+    def store(self, cmake_cache_path: Path):
+        if not cmake_cache_path.exists():
+            return
+
+        entries = self._read_entries(cmake_cache_path.read_text())
+
+        with _lock(self._lock_path):
+            content = self._load()
+            shared_entries = content['entries']
+            conflicts = set(content['conflicts'])
+            changed = False
+
+            for name, entry in entries.items():
+                if name in conflicts:
+                    continue
+
+                shared_entry = shared_entries.get(name)
+
+                if not shared_entry:
+                    shared_entries[name] = entry
+                    changed = True
+                elif shared_entry != entry:
+                    del shared_entries[name]
+                    conflicts.add(name)
+                    changed = True
+
+            if not changed:
+                return
+
+            content = {'entries': shared_entries, 'conflicts': sorted(conflicts)}
+
+            # Written to temporary file first, so configure of another target never reads incomplete cache
+            temp_path = self.path.with_name(f'{self.path.name}.{os.getpid()}.tmp')
+            temp_path.write_text(json.dumps(content, indent=1, sort_keys=True) + '\n')
+            os.rename(temp_path, self.path)
+
+    def _load(self) -> dict:
+        if not self.path.exists():
+            return {'entries': {}, 'conflicts': []}
+
+        content = json.loads(self.path.read_text())
+        content['entries'] = {name: tuple(entry) for name, entry in content['entries'].items()}
+
+        return content
+
+    @classmethod
+    def _read_entries(cls, content: str) -> typing.Dict[str, typing.Tuple[str, str]]:
+        entries = {}
+        description = ''
+
+        for line in content.splitlines():
+            if line.startswith('//'):
+                description += line[2:]
+                continue
+
+            if match := cls.ENTRY_PATTERN.match(line):
+                entries[match[1]] = (match[2], description)
+
+            description = ''
+
+        shared_entries = {}
+
+        for name, (value, description) in entries.items():
+            if not description.startswith(cls.SHARED_CHECKS) or cls.EXCLUDED_PATTERN.search(name + description):
+                continue
+
+            # Missing header can be installed to prefix directory by another target later
+            if description.startswith(('Have include ', 'Have includes ')) and value in ('', '0'):
+                continue
+
+            shared_entries[name] = (value, description)
+
+            # CheckTypeSize skips its check when HAVE_ variable, the result of its try_compile(), is defined
+            have_name = 'HAVE_' + name
+
+            if description.startswith('CHECK_TYPE_SIZE: ') and have_name in entries:
+                shared_entries[have_name] = entries[have_name]
+
+        return shared_entries
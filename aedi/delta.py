@@ -0,0 +1,203 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+# This module uses the standard library only, it's copied next to patches as applier script, see DeltaUpdate
+
+import argparse
+import hashlib
+import json
+import os
+import shutil
+import subprocess
+import sys
+import typing
+from pathlib import Path
+
+
+class DeltaUpdate(object):
+    """
+    VCDIFF patches made by xdelta3 between previous and new output of main target, one set per output directory,
+    i.e. per universal bundle and per thin bundle of each architecture, so updater downloads changed files only
+
+    Previous output is copied aside before build, patches are made after it, then the copy is removed
+    Manifest lists every file of new output with its SHA-256 and mode, unchanged files have no payload,
+    changed ones have patch against previous file with its SHA-256, the rest are stored as is
+    Patch that isn't smaller than the file itself is not used, e.g. for compressed resources
+    """
+
+    MANIFEST_NAME = 'manifest.json'
+    APPLIER_NAME = 'apply.py'
+    FORMAT_VERSION = 1
+
+    # Slightly smaller patches than with default compression level, the time is spent once per build
+    ENCODE_ARGS = ('-e', '-9', '-f', '-q')
+
+    def __init__(self, xdelta: Path, delta_path: Path):
+        self.xdelta = xdelta
+        self.path = delta_path
+        self._previous_path = delta_path / 'previous'
+
+    def keep_previous(self, output_paths: typing.Sequence[Path]):
+        if self._previous_path.exists():
+            shutil.rmtree(self._previous_path)
+
+        for output_path in output_paths:
+            if output_path.exists():
+                shutil.copytree(output_path, self._previous_path / output_path.name, symlinks=True)
+
+    def make_patches(self, output_paths: typing.Sequence[Path]):
+        for output_path in output_paths:
+            previous_path = self._previous_path / output_path.name
+
+            if output_path.exists() and previous_path.exists():
+                self._make_patches(previous_path, output_path, self.path / output_path.name)
+
+        if self._previous_path.exists():
+            shutil.rmtree(self._previous_path)
+
+    def _make_patches(self, previous_path: Path, output_path: Path, patches_path: Path):
+        if patches_path.exists():
+            shutil.rmtree(patches_path)
+
+        os.makedirs(patches_path)
+
+        files = {}
+        patched_size = 0
+        full_size = 0
+
+        for path in sorted(output_path.rglob('*')):
+            relative_path = str(path.relative_to(output_path))
+
+            if path.is_symlink():
+                files[relative_path] = {'symlink': os.readlink(path)}
+                continue
+
+            if not path.is_file():
+                continue
+
+            entry = {'sha256': _file_digest(path), 'mode': path.stat().st_mode & 0o777}
+            files[relative_path] = entry
+            full_size += path.stat().st_size
+
+            previous_file = previous_path / relative_path
+
+            if previous_file.is_file() and not previous_file.is_symlink():
+                previous_digest = _file_digest(previous_file)
+
+                if previous_digest == entry['sha256']:
+                    continue
+
+                patch_name = f'{len(files):05}.vcdiff'
+                patch_path = patches_path / patch_name
+
+                args = (self.xdelta, *self.ENCODE_ARGS, '-s', previous_file, path, patch_path)
+                subprocess.run(args, check=True)
+
+                if patch_path.stat().st_size < path.stat().st_size:
+                    entry['source_sha256'] = previous_digest
+                    entry['patch'] = patch_name
+                    patched_size += patch_path.stat().st_size
+                    continue
+
+                os.unlink(patch_path)
+
+            file_name = f'{len(files):05}.file'
+            shutil.copy(path, patches_path / file_name)
+            entry['file'] = file_name
+            patched_size += path.stat().st_size
+
+        removed = [str(path.relative_to(previous_path)) for path in sorted(previous_path.rglob('*'))
+                   if (path.is_file() or path.is_symlink()) and str(path.relative_to(previous_path)) not in files]
+
+        manifest = {'format': self.FORMAT_VERSION, 'files': files, 'removed': removed}
+        (patches_path / self.MANIFEST_NAME).write_text(json.dumps(manifest, indent=1, sort_keys=True) + '\n')
+
+        shutil.copy(__file__, patches_path / self.APPLIER_NAME)
+
+        print(f'Delta update of {output_path.name}: {patched_size} of {full_size} bytes in {patches_path}')
+
+    @classmethod
+    def apply(cls, xdelta: Path, patches_path: Path, output_path: Path):
+        # New tree is assembled next to the old one, and replaces it only when every file matches manifest
+        manifest = json.loads((patches_path / cls.MANIFEST_NAME).read_text())
+
+        if manifest.get('format') != cls.FORMAT_VERSION:
+            raise RuntimeError(f'Unsupported format of delta update manifest in {patches_path}')
+
+        new_path = output_path.with_name(output_path.name + '.update')
+
+        if new_path.exists():
+            shutil.rmtree(new_path)
+
+        for relative_path, entry in manifest['files'].items():
+            path = new_path / relative_path
+            os.makedirs(path.parent, exist_ok=True)
+
+            if 'symlink' in entry:
+                os.symlink(entry['symlink'], path)
+                continue
+
+            previous_file = output_path / relative_path
+
+            if 'patch' in entry:
+                if _file_digest(previous_file) != entry['source_sha256']:
+                    raise RuntimeError(f'File {previous_file} doesn\'t match the one patch was made for')
+
+                args = (xdelta, '-d', '-f', '-q', '-s', previous_file, patches_path / entry['patch'], path)
+                subprocess.run(args, check=True)
+            elif 'file' in entry:
+                shutil.copy(patches_path / entry['file'], path)
+            else:
+                shutil.copy(previous_file, path)
+
+            if _file_digest(path) != entry['sha256']:
+                raise RuntimeError(f'Updated file {path} has unexpected content')
+
+            os.chmod(path, entry['mode'])
+
+        old_path = output_path.with_name(output_path.name + '.old')
+
+        if old_path.exists():
+            shutil.rmtree(old_path)
+
+        os.rename(output_path, old_path)
+        os.rename(new_path, output_path)
+        shutil.rmtree(old_path)
+
+
+def _file_digest(path: Path) -> str:
+    hasher = hashlib.sha256()
+
+    with path.open('rb') as f:
+        while block := f.read(1024 * 1024):
+            hasher.update(block)
+
+    return hasher.hexdigest()
+
+
+def main(args: typing.Sequence[str]):
+    parser = argparse.ArgumentParser(description='Apply delta update made by --delta-update build option')
+    parser.add_argument('--xdelta', metavar='path', default='xdelta3', help='path to xdelta3 executable')
+    parser.add_argument('output', metavar='path', help='path to bundle or directory to update')
+    arguments = parser.parse_args(args)
+
+    DeltaUpdate.apply(Path(arguments.xdelta), Path(__file__).parent.absolute(), Path(arguments.output).absolute())
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
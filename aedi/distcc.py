@@ -0,0 +1,132 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import os
+import shlex
+import shutil
+import subprocess
+import typing
+from pathlib import Path
+
+
+class DistributedCompilation(object):
+    """
+    Compilation on a pool of build Macs with distcc over SSH, distcc is compiler launcher, alone or as ccache prefix
+    Translation units are preprocessed locally, with headers of prefix directory and SDK, so remote hosts need only
+    Xcode with the same clang version, and compiler scripts that are copied to the same paths, linking and compilations
+    that cannot be distributed, e.g. with precompiled headers or modules, run locally
+    The top-level build process checks hosts, and exports the ones that match, nested build.py processes find them
+    in environment variables, so they compile on the same hosts without checking them again
+    """
+
+    HOSTS_VARIABLE = 'DISTCC_HOSTS'
+    JOBS_VARIABLE = 'AEDI_DISTCC_JOBS'
+
+    # Preprocessed sources compress several times, it's cheaper than sending them over slow network as is
+    HOST_OPTIONS = ',lzo'
+
+    def __init__(self, executable: Path, hosts: str, jobs: int):
+        self.executable = executable
+        self.hosts = hosts
+        self.jobs = jobs
+
+    @classmethod
+    def create(cls, hosts: str, local_jobs: int, compilers: typing.Dict[Path, Path],
+               environment: dict) -> 'DistributedCompilation':
+        executable = shutil.which('distcc', path=environment['PATH'])
+
+        if not executable:
+            raise RuntimeError('Cannot find distcc executable')
+
+        local_version = cls._clang_version(subprocess.run(('clang', '--version'), check=True, capture_output=True,
+                                                          env=environment).stdout)
+        entries = [f'localhost/{local_jobs}']
+        jobs = local_jobs
+
+        for host in hosts.split(','):
+            name, _, host_jobs = host.strip().partition('/')
+            probe = cls._probe(name, environment)
+
+            if not probe:
+                print(f'WARNING: Skipping distcc host {name}, it cannot be reached over SSH')
+                continue
+
+            version, cpu_count = probe
+
+            if version != local_version:
+                print(f'WARNING: Skipping distcc host {name}, its {version} differs from local {local_version}')
+                continue
+
+            cls._copy_compilers(name, compilers, environment)
+
+            host_jobs = int(host_jobs) if host_jobs else cpu_count
+            entries.append(f'@{name}/{host_jobs}{cls.HOST_OPTIONS}')
+            jobs += host_jobs
+
+        if len(entries) == 1:
+            raise RuntimeError(f'No usable distcc hosts in {hosts}')
+
+        print(f'Compiling with {jobs} jobs on {len(entries)} hosts: {" ".join(entries)}')
+
+        return cls(Path(executable), ' '.join(entries), jobs)
+
+    @classmethod
+    def from_environment(cls, environment: dict) -> typing.Optional['DistributedCompilation']:
+        hosts = environment.get(cls.HOSTS_VARIABLE)
+        jobs = environment.get(cls.JOBS_VARIABLE)
+        executable = shutil.which('distcc', path=environment['PATH'])
+
+        return cls(Path(executable), hosts, int(jobs)) if hosts and jobs and executable else None
+
+    def export(self, environment: dict, cache_path: Path):
+        environment[self.HOSTS_VARIABLE] = self.hosts
+        environment[self.JOBS_VARIABLE] = str(self.jobs)
+
+        # Host locks and state are kept next to other caches instead of home directory
+        distcc_path = cache_path / 'distcc'
+        os.makedirs(distcc_path, exist_ok=True)
+        environment['DISTCC_DIR'] = str(distcc_path)
+
+    @staticmethod
+    def _clang_version(output: bytes) -> str:
+        # Apple clang version 15.0.0 (clang-1500.3.9.4)
+        return output.decode('utf-8').splitlines()[0].strip()
+
+    @classmethod
+    def _probe(cls, host: str, environment: dict) -> typing.Optional[typing.Tuple[str, int]]:
+        # Non-interactive login only, build must not wait for password prompt
+        args = ('ssh', '-o', 'BatchMode=yes', host, 'clang --version && sysctl -n hw.ncpu')
+        result = subprocess.run(args, capture_output=True, env=environment)
+
+        if result.returncode != 0:
+            return None
+
+        lines = result.stdout.decode('utf-8').splitlines()
+        return cls._clang_version(result.stdout), int(lines[-1])
+
+    @staticmethod
+    def _copy_compilers(host: str, compilers: typing.Dict[Path, Path], environment: dict):
+        # Compiler scripts run Xcode's clang with target architecture, remote distccd runs them by prefix paths
+        # Prefix directory may not exist yet, so scripts are copied from their dependency, keys are remote paths
+        directories = sorted({str(compiler.parent) for compiler in compilers})
+        args = ('ssh', '-o', 'BatchMode=yes', host, 'mkdir -p ' + ' '.join(shlex.quote(path) for path in directories))
+        subprocess.run(args, check=True, env=environment)
+
+        for compiler, script in compilers.items():
+            args = ('scp', '-q', '-o', 'BatchMode=yes', script, f'{host}:{shlex.quote(str(compiler))}')
+            subprocess.run(args, check=True, env=environment)
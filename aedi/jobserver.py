@@ -0,0 +1,125 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import contextlib
+import os
+import re
+import threading
+import typing
+from pathlib import Path
+
+
+class JobServer(object):
+    """
+    GNU make jobserver shared by the top-level build process and everything it runs, including nested build.py ones
+    Tokens are single bytes in named pipe, every process has one implicit job slot, and takes a token for each extra job
+    Make 4.4 finds the pipe in MAKEFLAGS environment variable, Python threads that run concurrent builds take tokens
+    the same way, so the number of jobs of the whole build tree never exceeds the number given to the owner
+
+    Tools without jobserver support, i.e. ninja 1.11, get a fixed number of jobs they hold tokens for while running
+    """
+
+    TOKEN = b'+'
+
+    def __init__(self, path: Path, owner: bool):
+        self.path = path
+        self.owner = owner
+
+        # Reads from blocking descriptor wait for a token, non-blocking one is used to take only available tokens
+        self._fd = os.open(path, os.O_RDWR)
+        self._nonblocking_fd = os.open(path, os.O_RDWR | os.O_NONBLOCK)
+
+        self._lock = threading.Lock()
+        self._implicit_slot_free = True
+
+    @classmethod
+    def create(cls, path: Path, jobs: int) -> 'JobServer':
+        path.unlink(missing_ok=True)
+        os.mkfifo(path, 0o600)
+
+        jobserver = cls(path, owner=True)
+
+        # The owner has its implicit slot, so the pipe gets one token less than the number of jobs
+        if jobs > 1:
+            os.write(jobserver._fd, cls.TOKEN * (jobs - 1))
+
+        return jobserver
+
+    @classmethod
+    def from_environment(cls, environment: dict) -> typing.Optional['JobServer']:
+        # Nested build.py process joins jobserver of its parent, its implicit slot is the token taken by parent
+        makeflags = environment.get('MAKEFLAGS', '')
+        match = re.search(r'--jobserver-auth=fifo:(\S+)', makeflags)
+
+        if not match or not os.path.exists(match[1]):
+            return None
+
+        return cls(Path(match[1]), owner=False)
+
+    def export(self, environment: dict, jobs: str):
+        # The same format as make uses for its own sub-makes, number of jobs is informational there
+        # Make is never given -j in command line then, because explicit number of jobs turns jobserver off
+        environment['MAKEFLAGS'] = f' -j{jobs} --jobserver-auth=fifo:{self.path}'
+
+    def close(self):
+        os.close(self._fd)
+        os.close(self._nonblocking_fd)
+
+        if self.owner:
+            self.path.unlink(missing_ok=True)
+
+    @contextlib.contextmanager
+    def slot(self):
+        # One concurrent task runs in the implicit slot, the others wait for tokens
+        with self._lock:
+            implicit = self._implicit_slot_free
+            self._implicit_slot_free = False
+
+        if not implicit:
+            os.read(self._fd, 1)
+
+        try:
+            yield
+        finally:
+            if implicit:
+                with self._lock:
+                    self._implicit_slot_free = True
+            else:
+                os.write(self._fd, self.TOKEN)
+
+    @contextlib.contextmanager
+    def reserve(self, jobs: int):
+        # Task that runs tool without jobserver support is in a slot already, extra jobs are the available tokens
+        tokens = b''
+
+        while len(tokens) < jobs - 1:
+            try:
+                token = os.read(self._nonblocking_fd, jobs - 1 - len(tokens))
+            except BlockingIOError:
+                break
+
+            if not token:
+                break
+
+            tokens += token
+
+        try:
+            yield len(tokens) + 1
+        finally:
+            if tokens:
+                os.write(self._fd, tokens)
@@ -0,0 +1,87 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import os
+import re
+import subprocess
+import typing
+from pathlib import Path
+
+
+class MemoryDisk(object):
+    """
+    APFS volume on RAM disk that holds build and temporary directories, so configure scripts, libtool and other
+    small file heavy steps don't wait for slow disk, install trees and outputs are written to persistent storage
+    The top-level build process creates the disk, and detaches it on exit, nested build.py processes find it
+    in environment variable, and place their directories on the same disk
+    """
+
+    ENVIRONMENT_VARIABLE = 'AEDI_MEMORY_DISK'
+
+    # RAM disk size is given in 512-byte sectors
+    SECTOR_SIZE = 512
+    SIZE_UNITS = {'': 1, 'K': 1 << 10, 'M': 1 << 20, 'G': 1 << 30}
+
+    def __init__(self, path: Path, device: typing.Optional[str] = None):
+        self.path = path
+        self.device = device
+
+    @classmethod
+    def create(cls, size: str, environment: dict) -> 'MemoryDisk':
+        match = re.fullmatch(r'(\d+)([KMG]?)', size.upper())
+
+        if not match:
+            raise RuntimeError(f'Invalid size of memory disk: {size}, expected number of bytes with K, M or G suffix')
+
+        sectors = int(match[1]) * cls.SIZE_UNITS[match[2]] // cls.SECTOR_SIZE
+
+        args = ('hdiutil', 'attach', '-nomount', f'ram://{sectors}')
+        device = subprocess.run(args, check=True, env=environment, stdout=subprocess.PIPE).stdout
+        device = device.decode('ascii').strip()
+
+        name = f'aedi-build-{os.getpid()}'
+
+        try:
+            args = ('diskutil', 'erasevolume', 'APFS', name, device)
+            subprocess.run(args, check=True, env=environment, stdout=subprocess.DEVNULL)
+        except subprocess.CalledProcessError:
+            cls._detach(device, environment)
+            raise
+
+        print(f'Building in {size} memory disk mounted at /Volumes/{name}')
+
+        return cls(Path('/Volumes') / name, device)
+
+    @classmethod
+    def from_environment(cls, environment: dict) -> typing.Optional['MemoryDisk']:
+        path = environment.get(cls.ENVIRONMENT_VARIABLE)
+        return cls(Path(path)) if path and os.path.isdir(path) else None
+
+    def export(self, environment: dict):
+        environment[self.ENVIRONMENT_VARIABLE] = str(self.path)
+
+    def close(self, environment: dict):
+        # Only the process that attached the disk detaches it
+        if self.device:
+            self._detach(self.device, environment)
+            self.device = None
+
+    @staticmethod
+    def _detach(device: str, environment: dict):
+        args = ('hdiutil', 'detach', '-force', device)
+        subprocess.run(args, check=True, env=environment, stdout=subprocess.DEVNULL)
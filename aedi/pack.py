@@ -0,0 +1,340 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+# Run this module as python3 -B -m aedi.pack from repository root, see IncrementalPack
+
+import argparse
+import concurrent.futures
+import fnmatch
+import hashlib
+import json
+import os
+import struct
+import sys
+import time
+import typing
+import zlib
+from pathlib import Path
+
+
+class _Entry(object):
+    def __init__(self, name: str, path: Path):
+        self.name = name
+        self.path = path
+        self.digest = ''
+        self.crc = 0
+        self.size = 0
+        self.method = IncrementalPack.METHOD_STORED
+        self.data = b''
+        self.dos_time = 0
+        self.dos_date = 0
+        self.store = False
+        self.reused = False
+
+
+class IncrementalPack(object):
+    """
+    PK3 archive made from directory of lumps, compressed entries of the previous archive are reused for lumps
+    with unchanged content, only new and changed lumps are compressed, concurrently by thread pool
+
+    SHA-256 of every lump together with compression level is kept in cache file next to archive
+    Entry is reused when its lump has the same hash, and the previous archive has it with the same CRC-32 and size
+    Headers are always written anew, so the archive has the current names, order and modification times of lumps
+
+    Lumps that match store patterns, or are not larger than store size, are never compressed, and their data
+    can be aligned, e.g. to page size, by padding in extra field of local header, like zipalign does for APKs,
+    so engine that maps the archive into memory can use such lumps in place, without reading and inflating them
+
+    Quake PAK files are not compressed, qpakman writes them as fast as lumps are read
+    """
+
+    CACHE_SUFFIX = '.aedi-pack.json'
+    CACHE_FORMAT_VERSION = 2
+
+    METHOD_STORED = 0
+    METHOD_DEFLATED = 8
+
+    # Limits of archive without ZIP64 extensions, files of mods are far smaller
+    MAX_SIZE = 0xFFFFFFFF
+    MAX_ENTRIES = 0xFFFF
+
+    LOCAL_HEADER = struct.Struct('<IHHHHHIIIHH')
+    CENTRAL_HEADER = struct.Struct('<IHHHHHHIIIHHHHHII')
+    END_OF_DIRECTORY = struct.Struct('<IHHHHIIH')
+
+    LOCAL_HEADER_SIGNATURE = 0x04034b50
+    CENTRAL_HEADER_SIGNATURE = 0x02014b50
+    END_OF_DIRECTORY_SIGNATURE = 0x06054b50
+
+    # Version 2.0 is enough for deflate, and is made by Unix host
+    VERSION_NEEDED = 20
+    VERSION_MADE_BY = (3 << 8) | 20
+
+    # Names are in UTF-8
+    FLAGS = 1 << 11
+
+    # Extra field of zipalign with alignment and padding, unknown extra fields are skipped by readers
+    ALIGNMENT_EXTRA = struct.Struct('<HHH')
+    ALIGNMENT_EXTRA_ID = 0xD935
+
+    def __init__(self, source_path: Path, archive_path: Path, level: int = 9, jobs: typing.Optional[int] = None,
+                 store_patterns: typing.Sequence[str] = (), store_size: int = 0, alignment: int = 0):
+        self.source_path = source_path
+        self.archive_path = archive_path
+        self.level = level
+        self.jobs = jobs or os.cpu_count()
+        self.store_patterns = [pattern.lower() for pattern in store_patterns]
+        self.store_size = store_size
+        self.alignment = alignment
+        self._cache_path = archive_path.with_name(archive_path.name + self.CACHE_SUFFIX)
+
+    def pack(self):
+        start_time = time.monotonic()
+
+        entries = self._collect_entries()
+
+        if len(entries) > self.MAX_ENTRIES:
+            raise RuntimeError(f'Too many lumps in {self.source_path} for archive without ZIP64 extensions')
+
+        with concurrent.futures.ThreadPoolExecutor(max_workers=self.jobs) as executor:
+            for future in [executor.submit(self._hash, entry) for entry in entries]:
+                future.result()
+
+            self._reuse_previous(entries)
+
+            changed = [entry for entry in entries if not entry.reused]
+
+            for future in [executor.submit(self._compress, entry) for entry in changed]:
+                future.result()
+
+        self._write(entries)
+        self._write_cache(entries)
+
+        elapsed = time.monotonic() - start_time
+        print(f'Packed {len(entries)} lumps into {self.archive_path}, compressed {len(changed)} changed ones, '
+              f'reused {len(entries) - len(changed)}, in {elapsed:.1f} seconds')
+
+    def _collect_entries(self) -> typing.List[_Entry]:
+        entries = []
+
+        # Directory entries are not stored, engines find lumps by their full names
+        for path in sorted(self.source_path.rglob('*')):
+            if path.is_file():
+                name = path.relative_to(self.source_path).as_posix()
+                entry = _Entry(name, path)
+
+                # Engines look lumps up case insensitively
+                entry.store = path.stat().st_size <= self.store_size \
+                    or any(fnmatch.fnmatchcase(name.lower(), pattern) for pattern in self.store_patterns)
+                entries.append(entry)
+
+        return entries
+
+    @staticmethod
+    def _hash(entry: _Entry):
+        content = entry.path.read_bytes()
+
+        entry.digest = hashlib.sha256(content).hexdigest()
+        entry.crc = zlib.crc32(content)
+        entry.size = len(content)
+
+        mtime = time.localtime(max(entry.path.stat().st_mtime, 315532800))  # not before 1980-01-01
+        entry.dos_time = (mtime.tm_hour << 11) | (mtime.tm_min << 5) | (mtime.tm_sec // 2)
+        entry.dos_date = ((mtime.tm_year - 1980) << 9) | (mtime.tm_mon << 5) | mtime.tm_mday
+
+    def _compress(self, entry: _Entry):
+        # zlib releases GIL while compressing, so thread pool uses all CPU cores
+        content = entry.path.read_bytes()
+        if entry.store:
+            entry.method = self.METHOD_STORED
+            entry.data = content
+            return
+
+        compressor = zlib.compressobj(self.level, zlib.DEFLATED, -zlib.MAX_WBITS)
+        data = compressor.compress(content) + compressor.flush()
+
+        # Already compressed lumps, like PNG or OGG ones, are stored as is
+        if len(data) < len(content):
+            entry.method = self.METHOD_DEFLATED
+            entry.data = data
+        else:
+            entry.method = self.METHOD_STORED
+            entry.data = content
+
+    def _load_cache(self) -> typing.Dict[str, str]:
+        if not self._cache_path.exists() or not self.archive_path.exists():
+            return {}
+
+        try:
+            cache = json.loads(self._cache_path.read_text())
+        except ValueError:
+            return {}
+
+        if cache.get('format') != self.CACHE_FORMAT_VERSION or cache.get('options') != self._cache_options():
+            return {}
+
+        return cache['lumps']
+
+    def _reuse_previous(self, entries: typing.Sequence[_Entry]):
+        digests = self._load_cache()
+
+        if not digests:
+            return
+
+        candidates = {entry.name: entry for entry in entries if digests.get(entry.name) == entry.digest}
+
+        if not candidates:
+            return
+
+        with open(self.archive_path, 'rb') as f:
+            for name, method, crc, compressed_size, size, offset in self._read_directory(f):
+                entry = candidates.get(name)
+
+                if not entry or entry.crc != crc or entry.size != size \
+                        or method not in (self.METHOD_STORED, self.METHOD_DEFLATED) \
+                        or (entry.store and method != self.METHOD_STORED):
+                    continue
+
+                f.seek(offset)
+                header = self.LOCAL_HEADER.unpack(f.read(self.LOCAL_HEADER.size))
+
+                if header[0] != self.LOCAL_HEADER_SIGNATURE:
+                    continue
+
+                # Lengths of name and extra field of local header can differ from central directory ones
+                f.seek(header[9] + header[10], os.SEEK_CUR)
+
+                entry.method = method
+                entry.data = f.read(compressed_size)
+                entry.reused = len(entry.data) == compressed_size
+
+    @classmethod
+    def _read_directory(cls, f: typing.BinaryIO) -> typing.Iterator[typing.Tuple[str, int, int, int, int, int]]:
+        # Archive comment is never written, so end of central directory record is at the very end
+        if f.seek(0, os.SEEK_END) < cls.END_OF_DIRECTORY.size:
+            return
+
+        f.seek(-cls.END_OF_DIRECTORY.size, os.SEEK_END)
+        record = cls.END_OF_DIRECTORY.unpack(f.read(cls.END_OF_DIRECTORY.size))
+
+        if record[0] != cls.END_OF_DIRECTORY_SIGNATURE:
+            return
+
+        count, directory_offset = record[4], record[6]
+        f.seek(directory_offset)
+        directory = f.read(record[5])
+        position = 0
+
+        for _ in range(count):
+            header = cls.CENTRAL_HEADER.unpack_from(directory, position)
+
+            if header[0] != cls.CENTRAL_HEADER_SIGNATURE:
+                return
+
+            position += cls.CENTRAL_HEADER.size
+            name = directory[position:position + header[10]].decode('utf-8')
+            position += header[10] + header[11] + header[12]
+
+            # method, CRC-32, compressed size, uncompressed size, offset of local header
+            yield name, header[4], header[7], header[8], header[9], header[16]
+
+    def _write(self, entries: typing.Sequence[_Entry]):
+        # Archive is written to temporary file first, so interrupted packing never damages the previous one
+        temp_path = self.archive_path.with_name(f'{self.archive_path.name}.{os.getpid()}.tmp')
+        directory = []
+        offset = 0
+
+        with open(temp_path, 'wb') as f:
+            for entry in entries:
+                name = entry.name.encode('utf-8')
+                extra = b''
+
+                if entry.store and self.alignment:
+                    data_offset = offset + self.LOCAL_HEADER.size + len(name) + self.ALIGNMENT_EXTRA.size
+                    padding = -data_offset % self.alignment
+                    extra = self.ALIGNMENT_EXTRA.pack(self.ALIGNMENT_EXTRA_ID, 2 + padding, self.alignment)
+                    extra += bytes(padding)
+
+                header = self.LOCAL_HEADER.pack(
+                    self.LOCAL_HEADER_SIGNATURE, self.VERSION_NEEDED, self.FLAGS, entry.method,
+                    entry.dos_time, entry.dos_date, entry.crc, len(entry.data), entry.size, len(name), len(extra))
+
+                f.write(header)
+                f.write(name)
+                f.write(extra)
+                f.write(entry.data)
+
+                directory.append(self.CENTRAL_HEADER.pack(
+                    self.CENTRAL_HEADER_SIGNATURE, self.VERSION_MADE_BY, self.VERSION_NEEDED, self.FLAGS,
+                    entry.method, entry.dos_time, entry.dos_date, entry.crc, len(entry.data), entry.size,
+                    len(name), 0, 0, 0, 0, (entry.path.stat().st_mode & 0xFFFF) << 16, offset) + name)
+
+                offset += len(header) + len(name) + len(extra) + len(entry.data)
+
+                # Compressed data is not needed anymore, only the central directory is kept in memory
+                entry.data = b''
+
+            directory = b''.join(directory)
+
+            if offset + len(directory) > self.MAX_SIZE:
+                f.close()
+                os.unlink(temp_path)
+                raise RuntimeError(f'Archive {self.archive_path} is too large without ZIP64 extensions')
+
+            f.write(directory)
+            f.write(self.END_OF_DIRECTORY.pack(
+                self.END_OF_DIRECTORY_SIGNATURE, 0, 0, len(entries), len(entries), len(directory), offset, 0))
+
+        os.rename(temp_path, self.archive_path)
+
+    def _cache_options(self) -> dict:
+        # Alignment is not here, headers are written anew anyway
+        return {'level': self.level, 'store_patterns': self.store_patterns, 'store_size': self.store_size}
+
+    def _write_cache(self, entries: typing.Sequence[_Entry]):
+        cache = {
+            'format': self.CACHE_FORMAT_VERSION,
+            'options': self._cache_options(),
+            'lumps': {entry.name: entry.digest for entry in entries},
+        }
+
+        self._cache_path.write_text(json.dumps(cache, indent=1, sort_keys=True) + '\n')
+
+
+def main(args: typing.Sequence[str]):
+    parser = argparse.ArgumentParser(description='Pack directory of lumps into PK3 archive, '
+                                                 'reusing compressed entries of unchanged lumps from the previous one')
+    parser.add_argument('--level', type=int, choices=range(1, 10), default=9, metavar='1-9',
+                        help='deflate compression level, changing it compresses all lumps again')
+    parser.add_argument('--jobs', type=int, help='number of compression threads, all CPU cores by default')
+    parser.add_argument('--store', metavar='pattern', action='append', default=[],
+                        help='store lumps that match wildcard pattern uncompressed, e.g. shaders/*')
+    parser.add_argument('--store-size', type=int, default=0, metavar='bytes',
+                        help='store lumps that are not larger than given size uncompressed')
+    parser.add_argument('--align', type=int, default=0, metavar='bytes',
+                        help='align data of uncompressed lumps, e.g. to 16384 bytes page size of Apple Silicon')
+    parser.add_argument('source', metavar='directory', help='path to directory with lumps')
+    parser.add_argument('archive', metavar='path', help='path to PK3 archive to update')
+    arguments = parser.parse_args(args)
+
+    IncrementalPack(Path(arguments.source), Path(arguments.archive), arguments.level, arguments.jobs,
+                    arguments.store, arguments.store_size, arguments.align).pack()
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
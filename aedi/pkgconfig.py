@@ -0,0 +1,239 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import os
+import re
+import shlex
+import threading
+import typing
+from pathlib import Path
+
+
+class _Package(object):
+    def __init__(self, stat_key: tuple, fields: typing.Dict[str, str]):
+        self.stat_key = stat_key
+        self.version = fields.get('Version', '')
+        self.requires = _parse_requires(fields.get('Requires', ''))
+        self.requires += _parse_requires(fields.get('Requires.private', ''))
+
+        self.libs: typing.List[typing.Tuple[str, str]] = []
+        self.cflags: typing.List[typing.Tuple[str, str]] = []
+
+        # Fields of static linking are appended in order of their lines, like pkg-config does
+        for name in fields['order']:
+            if name in ('Libs', 'Libs.private'):
+                self.libs += _parse_flags(fields[name], is_libs=True)
+            elif name == 'Cflags':
+                self.cflags += _parse_flags(fields[name], is_libs=False)
+
+
+class PkgConfig(object):
+    """
+    Resolver of .pc files from prefix directory with the same results as pkg-config wrapper of the prefix gives,
+    i.e. with prefix variable defined to prefix path, and with private requirements and libraries of --static option
+    Packages are parsed once, and again only when their files change, so configure steps and tests that query
+    the same packages many times don't spawn pkg-config process every time
+
+    Queries of --cflags, --libs and --modversion are supported, resolve() returns None for anything else,
+    like version constraints or --variable option, and for missing packages, pkg-config is run for them instead
+    Order of flags follows pkg-config 0.29, every package precedes packages it requires,
+    flags are grouped as other compiler flags, include paths, library paths, other linker flags, and libraries
+    """
+
+    _SUPPORTED_OPTIONS = ('--cflags', '--libs', '--modversion', '--static')
+
+    def __init__(self, prefix_path: Path):
+        self.prefix_path = prefix_path
+        self.search_path = prefix_path / 'lib/pkgconfig'
+        self._packages: typing.Dict[str, _Package] = {}
+        self._lock = threading.Lock()
+
+    def resolve(self, args: typing.Sequence[str]) -> typing.Optional[str]:
+        options = [arg for arg in args if arg.startswith('-')]
+        modules = [arg for arg in args if not arg.startswith('-')]
+
+        if not modules or any(option not in self._SUPPORTED_OPTIONS for option in options):
+            return None
+
+        if any(not re.fullmatch(r'[\w.+-]+', module) for module in modules):
+            return None
+
+        packages = [self._package(module) for module in modules]
+
+        if None in packages:
+            return None
+
+        if '--modversion' in options:
+            return ''.join(package.version + '\n' for package in packages).rstrip('\n')
+
+        ordered = self._dependency_order(modules)
+
+        if ordered is None:
+            return None
+
+        groups = []
+
+        if '--cflags' in options:
+            groups += [('cflags', 'other'), ('cflags', 'I')]
+        if '--libs' in options:
+            groups += [('libs', 'L'), ('libs', 'other'), ('libs', 'l')]
+
+        flags = []
+
+        for field, kind in groups:
+            group_flags = [flag for package in ordered for flag_kind, flag in getattr(package, field)
+                           if flag_kind == kind]
+
+            # Only consecutive duplicates are removed, e.g. the same library path of packages from one prefix
+            for flag in group_flags:
+                if not flags or flags[-1] != flag:
+                    flags.append(flag)
+
+        # pkg-config puts space after every flag
+        return ''.join(flag + ' ' for flag in flags)
+
+    def _dependency_order(self, modules: typing.Sequence[str]) -> typing.Optional[typing.List[_Package]]:
+        # Depth first search from the right, with prepending of visited packages, see recursive_fill_list()
+        visited = set()
+        result: typing.List[_Package] = []
+
+        def visit(name: str) -> bool:
+            if name in visited:
+                return True
+
+            visited.add(name)
+
+            if not (package := self._package(name)):
+                return False
+
+            for required in reversed(package.requires):
+                if not visit(required):
+                    return False
+
+            result.insert(0, package)
+            return True
+
+        for module in reversed(modules):
+            if not visit(module):
+                return None
+
+        return result
+
+    def _package(self, name: str) -> typing.Optional[_Package]:
+        path = self.search_path / (name + '.pc')
+
+        try:
+            stat = os.stat(path)
+        except OSError:
+            return None
+
+        stat_key = (stat.st_ino, stat.st_mtime_ns, stat.st_size)
+
+        with self._lock:
+            package = self._packages.get(name)
+
+        if package and package.stat_key == stat_key:
+            return package
+
+        package = _Package(stat_key, self._parse(path))
+
+        with self._lock:
+            self._packages[name] = package
+
+        return package
+
+    def _parse(self, path: Path) -> typing.Dict[str, typing.Any]:
+        # Prefix variable is defined like --define-variable option does, so it keeps value from the command line
+        variables = {'pcfiledir': str(path.parent)}
+        defined = {'prefix': str(self.prefix_path)}
+        fields: typing.Dict[str, typing.Any] = {'order': []}
+
+        for line in path.read_text(errors='replace').splitlines():
+            line = line.split('#', 1)[0].strip()
+
+            if not (match := re.match(r'([\w.]+)\s*([:=])\s*(.*)$', line)):
+                continue
+
+            name, separator, value = match.groups()
+            value = _expand(value, variables)
+
+            if separator == '=':
+                variables[name] = defined.get(name, value)
+            elif name not in fields:
+                fields[name] = value
+                fields['order'].append(name)
+
+        return fields
+
+
+def _expand(value: str, variables: typing.Dict[str, str]) -> str:
+    return re.sub(r'\$\{([\w.]+)\}', lambda match: variables.get(match.group(1), ''), value.replace('$$', '\0')) \
+        .replace('\0', '$')
+
+
+def _parse_requires(value: str) -> typing.List[str]:
+    # Comparison operators are followed by versions, both are skipped, items are separated by commas or spaces
+    names = []
+    tokens = value.replace(',', ' ').split()
+    skip_next = False
+
+    for token in tokens:
+        if skip_next:
+            skip_next = False
+        elif token in ('<', '<=', '=', '!=', '>=', '>'):
+            skip_next = True
+        else:
+            names.append(token)
+
+    return names
+
+
+def _escape(arg: str) -> str:
+    # Characters that pkg-config escapes in flags, see strdup_escape_shell()
+    return re.sub(r'([^$()+,\-./0-9:=@A-Z^_a-z~])', r'\\\1', arg)
+
+
+def _parse_flags(value: str, is_libs: bool) -> typing.List[typing.Tuple[str, str]]:
+    try:
+        args = shlex.split(value)
+    except ValueError:
+        args = value.split()
+
+    flags = []
+    joined_options = ('-framework', '-Wl,-framework') if is_libs else ('-idirafter', '-isystem')
+    index = 0
+
+    while index < len(args):
+        arg = _escape(args[index].strip())
+
+        if is_libs and arg.startswith('-l') and not arg.startswith('-lib:'):
+            flags.append(('l', '-l' + arg[2:].lstrip()))
+        elif is_libs and arg.startswith('-L'):
+            flags.append(('L', '-L' + arg[2:].lstrip()))
+        elif not is_libs and arg.startswith('-I'):
+            flags.append(('I', '-I' + arg[2:].lstrip()))
+        elif arg in joined_options and index + 1 < len(args):
+            # Option with separate argument is one flag, so duplicates of its argument alone are never removed
+            index += 1
+            flags.append(('other', f'{arg} {_escape(args[index].strip())}'))
+        elif arg:
+            flags.append(('other', arg))
+
+        index += 1
+
+    return flags
@@ -16,16 +16,19 @@
 #    along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
 
+import contextlib
 import hashlib
 import os
 import re
 import shutil
 import subprocess
 import typing
+import urllib.error
 import urllib.request
 from pathlib import Path
 
 from .packaging.version import Version as StrictVersion
+from .pkgconfig import PkgConfig
 from .utility import CommandLineOptions
 
 
@@ -42,9 +45,54 @@ class BuildState:
         self.source_path = self.root_path / 'source'
         self.temp_path = self.root_path / 'temp'
 
+        # Mount point of RAM disk with build and temporary directories, see MemoryDisk
+        self.memory_disk_path = None
+        self.cache_path = self.root_path / 'cache'
+
+        # Profile-guided optimization stage, 'generate' or 'use', of the target being built
+        self.pgo = None
+        self.pgo_workload = None
+
+        # Selected target is compiled with function entry and exit hooks of trace variant, see function-trace target
+        self.function_trace = False
+
+        # Dependencies built without link-time optimization, they fill prefix directory of LTO build
+        self.lto = None
+        self.native_deps_path = None
+
+        # Named build variant with its own dependencies and prefix directories, see enable_variant()
+        self.variant = None
+
+        # Every function and data object goes to its own section, linker removes unreferenced ones
+        self.dead_strip = False
+
+        # Binaries are compiled with debug information, which is moved to dsym_path, see Builder._split_debug_info()
+        self.split_debug_info = False
+        self.dsym_path = self.root_path / 'deps-dsym'
+
+        # Main targets merge their C++ sources into batches and precompile common headers
+        self.unity_build = False
+
+        # Game links one relocatable object with all static dependencies instead of their archives
+        self.prelink_deps = False
+
+        # Timing of build phases, and compilation with clang -ftime-trace, see BuildTrace
+        self.trace = None
+        self.time_trace = False
+
         self.source = Path()
         self.external_source = True
 
+        # Existence of source files, remembered while target is detected, see memoized_source_files()
+        self._source_files = None
+
+        # Fetch source packages without unpacking them, see download-all target
+        self.download_only = False
+
+        # Checksum of downloaded source package and names of patches applied to it
+        self.source_checksum = None
+        self.source_patches = ()
+
         self.build_path = None
         self.native_build_path = None
 
@@ -54,17 +102,100 @@ class BuildState:
         self._compiler_flags = None
         self._linker_flags = None
 
+        # Packages parsed from prefix directory, copies of state share them
+        self._pkg_config = None
+
         self.platform = None
         self.xcode = False
         self.verbose = False
+        self.incremental = False
         self.jobs = 1
 
+        # Kind of git clone made by checkout_git(), full, blobless or shallow one
+        self.git_clone = 'full'
+
+        # GNU make jobserver shared by all nested builds, see JobServer
+        self.jobserver = None
+
         self.static_moltenvk = False
+        self.moltenvk_startup_link = False
         self.quasi_glib = False
+        self.quasi_glib_inline = False
+        self.openal_low_latency = False
+        self.openal_fast_init = False
+        self.zmusic_fast_emulators = False
+        self.audio_signposts = False
+        self.ogg_seek_index = False
+
+        # Path to ccache or sccache executable used as compiler launcher
+        self.compiler_cache = None
+
+        # Path to distcc executable used as compiler launcher, or as ccache prefix, when compiling on remote hosts
+        self.distcc = None
+
+        # Path to ninja executable when CMake targets use Ninja generator instead of Unix Makefiles
+        self.ninja = None
+
+        # Command line arguments to pass when other targets are built from this one
+        self.forwarded_arguments = []
 
         self.environment = os.environ.copy()
         self.options = CommandLineOptions()
 
+    # Compiler flags of build variants, variants without flags are for experiments with other options or sources
+    VARIANT_FLAGS = {
+        'debug': '-g',
+        'profile': '-g -fno-omit-frame-pointer',
+        'trace': '-g',
+    }
+
+    def enable_lto(self, mode: str):
+        # Static libraries with LLVM bitcode, and targets linked with them, are kept apart from native code ones
+        self.lto = mode
+        self._set_deps_suffix('lto')
+
+    def enable_variant(self, name: str):
+        # Dependencies rebuilt for variant are kept apart, and take precedence over the ones from deps directory,
+        # so changed libraries are compared side by side with the regular ones without rebuilding everything
+        self.variant = name
+        self._set_deps_suffix(f'lto-{name}' if self.lto else name)
+
+    def _set_deps_suffix(self, suffix: str):
+        self.native_deps_path = self.root_path / 'deps'
+        self.deps_path = self.root_path / f'deps-{suffix}'
+        self.prefix_path = self.root_path / f'prefix-{suffix}'
+        self.bin_path = self.prefix_path / 'bin'
+        self.include_path = self.prefix_path / 'include'
+        self.lib_path = self.prefix_path / 'lib'
+
+    def phase(self, name: str, track: typing.Optional[str] = None):
+        # Slice phases are traced per architecture, and phases shared by all slices are traced together
+        if not self.trace:
+            return contextlib.nullcontext()
+
+        return self.trace.phase(name, track or self.architecture() or 'common')
+
+    def job_slot(self):
+        # Concurrently running builds take jobserver tokens, so they don't run more jobs than the whole build has
+        if not self.jobserver:
+            return contextlib.nullcontext()
+
+        return self.jobserver.slot()
+
+    def make_jobs_arguments(self) -> list:
+        # Make with jobserver runs as many jobs as it can take tokens for, explicit number would turn it off
+        return [] if self.jobserver else ['-j', self.jobs]
+
+    @contextlib.contextmanager
+    def fixed_jobs(self):
+        # Tools without jobserver support run only the jobs they hold tokens for, at least one in their own slot
+        if not self.jobserver:
+            yield self.jobs
+            return
+
+        with self.jobserver.reserve(int(self.jobs)) as jobs:
+            yield str(jobs)
+
     def architecture(self) -> str:
         return self.platform.architecture if self.platform else ''
 
@@ -90,16 +221,83 @@ class BuildState:
     def cxx_compiler(self) -> Path:
         return self.platform.cxx_compiler if self.platform else None
 
+    def compiler_launcher(self) -> Path:
+        # With both of them, ccache runs distcc itself, see CCACHE_PREFIX
+        return self.compiler_cache or self.distcc
+
+    def compiler_command(self, compiler: Path) -> str:
+        launcher = self.compiler_launcher()
+        return f'{launcher} {compiler}' if launcher else str(compiler)
+
     def compiler_flags(self) -> str:
         if not self._compiler_flags:
             self._compiler_flags = f'-I{self.include_path} -ffile-prefix-map={self.source}/='
 
-        return self._compiler_flags
+            if self.lto:
+                self._compiler_flags += f' -flto={self.lto}'
+
+            if variant_flags := self.VARIANT_FLAGS.get(self.variant):
+                self._compiler_flags += ' ' + variant_flags
+
+            if self.function_trace:
+                # Only functions that remain after inlining get hooks, so small helpers don't drown calls of interest
+                self._compiler_flags += ' -finstrument-functions-after-inlining'
+
+            if self.dead_strip:
+                self._compiler_flags += ' -ffunction-sections -fdata-sections'
+
+            if self.split_debug_info:
+                self._compiler_flags += ' -g'
+
+            if self.time_trace:
+                self._compiler_flags += ' -ftime-trace'
+
+        return self._compiler_flags + self._tuning_flags() + self._pgo_flags()
+
+    def _tuning_flags(self) -> str:
+        tuning_flags = self.platform.tuning_flags if self.platform else ''
+        return ' ' + tuning_flags if tuning_flags else ''
+
+    def pgo_path(self, architecture: str) -> Path:
+        return self.cache_path / 'pgo' / architecture
+
+    def pgo_profile_path(self, architecture: str) -> Path:
+        return self.pgo_path(architecture) / 'default.profdata'
+
+    def _pgo_flags(self) -> str:
+        # Every slice of universal binary writes its profile into its own directory
+        architecture = self.architecture()
+
+        if not self.pgo or not architecture:
+            return ''
+
+        if self.pgo == 'generate':
+            return f' -fprofile-generate={self.pgo_path(architecture)}'
+
+        profile_path = self.pgo_profile_path(architecture)
+
+        if not profile_path.exists():
+            return ''
+
+        return f' -fprofile-use={profile_path} -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date'
 
     def linker_flags(self) -> str:
         if not self._linker_flags:
             self._linker_flags = f'-L{self.lib_path}'
 
+            if self.lto:
+                # Cache of ThinLTO backend results makes relinking after small changes fast
+                self._linker_flags += f' -flto={self.lto} -Wl,-cache_path_lto,{self.cache_path / "lto"}'
+
+            if self.variant == 'trace' and (self.lib_path / 'libfunction-trace.a').exists():
+                # Hooks of traced dependencies are defined by function-trace library, linker takes it when needed
+                self._linker_flags += ' -lfunction-trace'
+
+            if self.dead_strip:
+                # Local symbols are removed only from linked executables and shared libraries, not from objects
+                # Linker splits sections of object files into atoms at symbols, including local ones
+                self._linker_flags += ' -Wl,-dead_strip -Wl,-x'
+
             version_output = subprocess.run(('clang', '--version'), check=True, capture_output=True)
             version_match = re.search(r'\(clang-([\d.]+)\)', version_output.stdout.decode('ascii'))
 
@@ -119,17 +317,92 @@ class BuildState:
                     # or add -Wl,-ld_classic to the OTHER_LDFLAGS build setting.
                     self._linker_flags += ' -Wl,-ld_classic'
 
-        return self._linker_flags
+        # Profile runtime is linked by compiler driver when it sees instrumentation option
+        linker_flags = self._linker_flags + (' -fprofile-generate' if self.pgo == 'generate' else '')
+
+        # Code is generated by linker with LTO, so it needs tuning options too
+        return linker_flags + (self._tuning_flags() if self.lto else '')
+
+    def target_lto_flags(self, mode: str) -> typing.Tuple[str, str]:
+        # Compiler and linker flags of link-time optimization for one target only, when the whole build has no LTO
+        linker_flags = f' -flto={mode} -Wl,-cache_path_lto,{self.cache_path / "lto"}' + self._tuning_flags()
+        return f' -flto={mode}', linker_flags
 
-    def checkout_git(self, url: str, branch: typing.Optional[str] = None):
-        if self.source.exists():
+    def checkout_git(self, url: str, branch: typing.Optional[str] = None, mirror: typing.Optional[str] = None):
+        if self.source.exists() or self.download_only:
             return
 
-        args = ('git', 'clone', '--recurse-submodules', url, self.source)
-        subprocess.run(args, check=True, cwd=self.root_path, env=self.environment)
+        with self.phase('checkout', 'common'):
+            args = ['git', 'clone', '--recurse-submodules']
+
+            # Partial and shallow clones already fetch little, only full ones take objects from shared mirror
+            if mirror and self.git_clone == 'full':
+                args += ('--reference', self._update_git_mirror(mirror, url))
+
+            if self.git_clone != 'full':
+                # History has commits and trees only, file contents of other revisions are fetched when needed
+                args += ('--filter=blob:none', '--also-filter-submodules')
+
+            if self.git_clone == 'shallow':
+                args += ('--depth=1', '--shallow-submodules')
+
+            if branch:
+                args += ('--branch', branch)
+
+            args += (url, self.source)
+            subprocess.run(args, check=True, cwd=self.root_path, env=self.environment)
+
+            if self.git_clone == 'shallow':
+                self._deepen_git_history()
+
+    def _update_git_mirror(self, mirror: str, url: str) -> Path:
+        # Bare repository with objects of all forks of the same project, clones use it via alternates
+        # Branches of every fork are kept under its own namespace, so objects that clones need stay reachable
+        mirror_path = self.source_path / 'git-mirrors' / f'{mirror}.git'
+        remote = self.source.name
 
-        if branch:
-            args = ('git', 'checkout', '-b', branch, 'origin/' + branch)
+        def git(*args, check=True):
+            return subprocess.run(('git', f'--git-dir={mirror_path}') + args, check=check, env=self.environment,
+                                  stdout=subprocess.DEVNULL, stderr=None if check else subprocess.DEVNULL)
+
+        if not mirror_path.exists():
+            os.makedirs(mirror_path.parent, exist_ok=True)
+            subprocess.run(('git', 'init', '--bare', '--quiet', mirror_path), check=True, env=self.environment)
+
+            # Objects are never removed, removing them would break clones that reference the mirror
+            git('config', 'gc.pruneExpire', 'never')
+
+        if git('remote', 'get-url', remote, check=False).returncode != 0:
+            git('remote', 'add', remote, url)
+            git('config', f'remote.{remote}.fetch', f'+refs/heads/*:refs/remotes/{remote}/*')
+            git('config', f'remote.{remote}.tagOpt', '--no-tags')
+
+        # Only history that is not in the mirror yet is downloaded
+        args = ('git', f'--git-dir={mirror_path}', 'fetch', remote)
+        subprocess.run(args, check=True, env=self.environment)
+
+        return mirror_path
+
+    # Number of commits fetched by the first deepening of shallow clone, it grows fourfold with every next one
+    _GIT_DEEPEN_COMMITS = 64
+    _GIT_DEEPEN_ATTEMPTS = 4
+
+    def _deepen_git_history(self):
+        # Version of source code, and UpdateRevision.cmake of ZDoom based targets, need the nearest tag
+        commits = self._GIT_DEEPEN_COMMITS
+
+        for _ in range(self._GIT_DEEPEN_ATTEMPTS):
+            if self.source_version():
+                return
+
+            # Tags that point to fetched commits are fetched with them
+            args = ('git', 'fetch', f'--deepen={commits}')
+            subprocess.run(args, check=True, cwd=self.source, env=self.environment)
+            commits *= 4
+
+        if not self.source_version():
+            # Tag is too far, or repository has none, the rest of commits and trees is still cheaper than full clone
+            args = ('git', 'fetch', '--unshallow')
             subprocess.run(args, check=True, cwd=self.source, env=self.environment)
 
     def download_source(self, url: str, checksum: str, patches: typing.Union[tuple, list, str, None] = None):
@@ -138,126 +411,237 @@ class BuildState:
 
         os.makedirs(self.source, exist_ok=True)
 
-        data, filepath = self._read_source_package(url)
-        self._verify_checksum(checksum, data, filepath)
+        with self.phase('download', 'common'):
+            filepath = self._read_source_package(url, checksum)
+
+        if self.download_only:
+            return
 
-        first_path_component, extract_path = self._unpack_source_package(filepath)
+        with self.phase('unpack', 'common'):
+            first_path_component, extract_path = self._unpack_source_package(filepath)
 
         if not patches:
-            pass
+            patches = ()
         elif isinstance(patches, str):
-            self._apply_source_patch(extract_path, patches)
-        elif isinstance(patches, (tuple, list)):
-            for patch in patches:
-                self._apply_source_patch(extract_path, patch)
-        else:
+            patches = (patches,)
+        elif not isinstance(patches, (tuple, list)):
             assert False
 
+        # Patches are known even when one of them fails to apply, watch mode of builder waits for their changes
+        self.source_checksum = checksum
+        self.source_patches = tuple(patches)
+
+        with self.phase('patch', 'common'):
+            self._apply_source_patches(extract_path, patches)
+
         # Adjust source and build paths according to extracted source code
         self.source = extract_path
         self.build_path = self.build_path / first_path_component
 
-    def _read_source_package(self, url: str) -> typing.Tuple[bytes, Path]:
+    # Size of blocks to read, write and hash source packages with
+    _DOWNLOAD_BLOCK_SIZE = 1024 * 1024
+
+    def _read_source_package(self, url: str, checksum: str) -> Path:
         filename = url.rsplit(os.sep, 1)[1]
         filepath = self.source / filename
 
         if filepath.exists():
-            # Read existing source package
+            # Verify existing source package
+            hasher = hashlib.sha256()
+
             with open(filepath, 'rb') as f:
-                data = f.read()
-        else:
-            # Download package with source code
-            print(f'Downloading {filename}')
+                while block := f.read(self._DOWNLOAD_BLOCK_SIZE):
+                    hasher.update(block)
 
-            response = urllib.request.urlopen(url)
+            self._verify_checksum(checksum, hasher.hexdigest(), filepath)
+            return filepath
 
-            try:
-                with open(filepath, 'wb') as f:
-                    data = response.read()
-                    f.write(data)
+        # Download package with source code into partial file, and continue from its end if it already exists
+        partial_filepath = filepath.with_name(filename + '.part')
+        hasher = hashlib.sha256()
+        offset = 0
 
-            except IOError:
-                os.unlink(filepath)
+        if partial_filepath.exists():
+            with open(partial_filepath, 'rb') as f:
+                while block := f.read(self._DOWNLOAD_BLOCK_SIZE):
+                    hasher.update(block)
+                    offset += len(block)
+
+        request = urllib.request.Request(url)
+
+        if offset:
+            print(f'Resuming download of {filename} from {offset} bytes')
+            request.add_header('Range', f'bytes={offset}-')
+        else:
+            print(f'Downloading {filename}')
+
+        try:
+            with urllib.request.urlopen(request) as response:
+                if offset and response.status != 206:
+                    # Server ignored range request, start from scratch
+                    hasher = hashlib.sha256()
+                    offset = 0
+
+                with open(partial_filepath, 'ab' if offset else 'wb') as f:
+                    while block := response.read(self._DOWNLOAD_BLOCK_SIZE):
+                        f.write(block)
+                        hasher.update(block)
+        except urllib.error.HTTPError as error:
+            # Requested range is beyond the end, partial file is complete then
+            if error.code != 416 or not offset:
                 raise
 
-        return data, filepath
+        self._verify_checksum(checksum, hasher.hexdigest(), partial_filepath)
+        os.rename(partial_filepath, filepath)
 
-    @staticmethod
-    def _verify_checksum(checksum: str, data: bytes, filepath: Path) -> None:
-        file_hasher = hashlib.sha256()
-        file_hasher.update(data)
-        file_checksum = file_hasher.hexdigest()
+        return filepath
 
+    @staticmethod
+    def _verify_checksum(checksum: str, file_checksum: str, filepath: Path) -> None:
         if file_checksum != checksum:
             filepath.unlink()
             raise Exception(f'Checksum of {filepath} does not match, expected: {checksum}, actual: {file_checksum}')
 
     def _unpack_source_package(self, filepath: Path) -> typing.Tuple[str, Path]:
-        args = ('tar', '-tf', filepath)
-        result = subprocess.run(args, check=True, env=self.environment, stdout=subprocess.PIPE)
+        # Name of root directory is stored next to source package after the first extraction
+        root_stamp_path = filepath.with_name(filepath.name + '.root')
+
+        if root_stamp_path.exists():
+            first_path_component = root_stamp_path.read_text().strip()
+            extract_path = self.source / first_path_component
 
-        file_paths_str = result.stdout.decode("utf-8")
-        file_paths = file_paths_str.split('\n')
-        file_paths.remove('')
-        assert len(file_paths) > 0
+            if extract_path.exists():
+                return first_path_component, extract_path
 
-        # Determine root path of source code to be extracted
+        # Extract everything in one pass into temporary directory, and determine root path of source code from it
         # If all files and directories are stored in one top level directory, this directory is used as a root
-        # If there is no single top level directory, new root directory will be created
-        need_new_directory = False
-        first_path_component = ''
+        # If there is no single top level directory, temporary directory becomes the new root directory
+        work_path = self.source / ('.extract-' + filepath.name)
 
-        for path in file_paths:
-            if os.sep not in path:
-                need_new_directory = True
-                break
-            else:
-                current_first_path_component = path[:path.find(os.sep)]
+        if work_path.exists():
+            shutil.rmtree(work_path)
+
+        os.makedirs(work_path)
 
-                if first_path_component:
-                    if first_path_component != current_first_path_component:
-                        need_new_directory = True
-                        break
-                else:
-                    first_path_component = current_first_path_component
+        try:
+            args = ('tar', '-xf', filepath)
+            subprocess.run(args, check=True, cwd=work_path, env=self.environment)
+        except (IOError, subprocess.CalledProcessError):
+            shutil.rmtree(work_path, ignore_errors=True)
+            raise
 
-        work_path = self.source
+        entries = os.listdir(work_path)
+        assert len(entries) > 0
 
-        if need_new_directory:
+        if len(entries) == 1 and (work_path / entries[0]).is_dir() and not (work_path / entries[0]).is_symlink():
+            first_path_component = entries[0]
+            extracted_path = work_path / first_path_component
+        else:
             first_path_component = Path(filepath.name).stem
-            work_path /= first_path_component
+            extracted_path = work_path
 
         extract_path = self.source / first_path_component
 
+        # Source code may be extracted already, before root directory was stored
         if not extract_path.exists():
-            os.makedirs(work_path, exist_ok=True)
-
-            # Extract source code package
-            try:
-                args = ('tar', '-xf', filepath)
-                subprocess.run(args, check=True, cwd=work_path, env=self.environment)
-            except (IOError, subprocess.CalledProcessError):
-                shutil.rmtree(extract_path, ignore_errors=True)
-                raise
+            os.rename(extracted_path, extract_path)
+
+        if work_path.exists():
+            shutil.rmtree(work_path)
+
+        root_stamp_path.write_text(first_path_component + '\n')
 
         return first_path_component, extract_path
 
-    def _apply_source_patch(self, extract_path: Path, patch: str):
+    # Copies of applied patches are kept in source tree, to skip unchanged ones and to revert changed ones
+    # Their order file lists them in order of application, patches of one stack may depend on lines of previous ones
+    _APPLIED_PATCHES_DIRECTORY = '.aedi-patches'
+    _APPLIED_PATCHES_ORDER = 'order'
+
+    def _apply_source_patches(self, extract_path: Path, patches: typing.Sequence[str]):
+        applied_patches_path = extract_path / self._APPLIED_PATCHES_DIRECTORY
+        applied = self._applied_source_patches(applied_patches_path, patches)
+
+        # Source tree extracted before copies of patches were kept may have patches applied already
+        check_applied = not applied_patches_path.exists()
+
+        # Applied patches are kept up to the first one that was changed, removed or moved in the list
+        # Source tree is shared by build variants, so the list differs when patches are applied for one variant only
+        kept_count = 0
+
+        for applied_patch, patch in zip(applied, patches):
+            applied_path = applied_patches_path / (applied_patch + '.diff')
+            patch_path = self.patch_path / (patch + '.diff')
+
+            if applied_patch != patch or applied_path.read_bytes() != patch_path.read_bytes():
+                break
+
+            kept_count += 1
+
+        # Every following patch is reverted from the last one back, because hunks of later patches may have context
+        # added by earlier ones, then the current versions are applied in order
+        while len(applied) > kept_count:
+            applied_path = applied_patches_path / (applied[-1] + '.diff')
+            args = ('patch', '--strip=1', '--reverse', '--input=' + str(applied_path))
+            subprocess.run(args, check=True, cwd=extract_path, env=self.environment)
+
+            applied_path.unlink()
+            applied.pop()
+            self._write_applied_source_patches(applied_patches_path, applied)
+
+        for patch in patches[kept_count:]:
+            self._apply_source_patch(extract_path, patch, check_applied)
+
+            applied.append(patch)
+            self._write_applied_source_patches(applied_patches_path, applied)
+
+    def _applied_source_patches(self, applied_patches_path: Path, patches: typing.Sequence[str]) -> typing.List[str]:
+        order_path = applied_patches_path / self._APPLIED_PATCHES_ORDER
+
+        if order_path.exists():
+            return order_path.read_text().split()
+
+        # Source tree was patched before order of patches was recorded, copies of the listed ones are assumed
+        # to be applied in the listed order, and the others before them
+        copies = {path.stem for path in applied_patches_path.glob('*.diff')}
+        listed = [patch for patch in patches if patch in copies]
+
+        return sorted(copies - set(listed)) + listed
+
+    def _write_applied_source_patches(self, applied_patches_path: Path, applied: typing.Sequence[str]):
+        os.makedirs(applied_patches_path, exist_ok=True)
+
+        order_path = applied_patches_path / self._APPLIED_PATCHES_ORDER
+        order_path.write_text(''.join(patch + '\n' for patch in applied))
+
+    def _apply_source_patch(self, extract_path: Path, patch: str, check_applied: bool):
         patch_path = self.patch_path / (patch + '.diff')
         assert patch_path.exists()
 
         args = ['patch', '--strip=1', '--input=' + str(patch_path)]
+        apply = True
 
-        # Check if patch is already applied
-        dry_run_args = args + ['--dry-run', '--force']
-        dry_run = subprocess.run(dry_run_args, cwd=extract_path, env=self.environment,
-                                 stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        if check_applied:
+            dry_run_args = args + ['--dry-run', '--force']
+            dry_run = subprocess.run(dry_run_args, cwd=extract_path, env=self.environment,
+                                     stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+            apply = dry_run.returncode == 0
 
-        if dry_run.returncode == 0:
-            # Patch wasn't applied yet, do it now
+        if apply:
             subprocess.run(args, check=True, cwd=extract_path, env=self.environment)
 
+        applied_path = extract_path / self._APPLIED_PATCHES_DIRECTORY / (patch + '.diff')
+        os.makedirs(applied_path.parent, exist_ok=True)
+        applied_path.write_bytes(patch_path.read_bytes())
+
     def run_pkg_config(self, *args) -> str:
+        if not self._pkg_config or self._pkg_config.prefix_path != self.prefix_path:
+            self._pkg_config = PkgConfig(self.prefix_path)
+
+        # Process is spawned only for queries that resolver doesn't support, and for missing packages to report them
+        if (result := self._pkg_config.resolve(args)) is not None:
+            return result.rstrip('\n')
+
         os.makedirs(self.build_path, exist_ok=True)
 
         args = (self.bin_path / 'pkg-config',) + args
@@ -266,7 +650,25 @@ class BuildState:
         return result.stdout.decode('utf-8').rstrip('\n')
 
     def has_source_file(self, path: typing.Union[str, Path]):
-        return (self.source / path).exists()
+        if self._source_files is None:
+            return (self.source / path).exists()
+
+        path = self.source / path
+
+        if path not in self._source_files:
+            self._source_files[path] = path.exists()
+
+        return self._source_files[path]
+
+    @contextlib.contextmanager
+    def memoized_source_files(self):
+        # Detection of target probes the same marker files many times, while source code doesn't change
+        self._source_files = {}
+
+        try:
+            yield
+        finally:
+            self._source_files = None
 
     def update_flags_environment_variable(self, name: str, value: str):
         sdk_path = self.sdk_path()
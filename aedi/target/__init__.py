@@ -37,6 +37,7 @@ def targets():
         DisdainTarget(),
         AccTarget(),
         WadExtTarget(),
+        WadExtMmapTarget(),
         ZdbspTarget(),
         ZDRayTarget(),
         PrBoomPlusTarget(),
@@ -57,6 +58,7 @@ def targets():
         Bzip2Target(),
         FfiTarget(),
         FlacTarget(),
+        FunctionTraceTarget(),
         GlibTarget(),
         IconvTarget(),
         IntlTarget(),
@@ -71,6 +73,8 @@ def targets():
         SndFileTarget(),
         VorbisTarget(),
         VpxTarget(),
+        VpxIOSurfaceTarget(),
+        VpxVideoToolboxTarget(),
         WebpTarget(),
         ZlibNgTarget(),
         ZMusicTarget(),
@@ -84,6 +88,7 @@ def targets():
         MadTarget(),
         MikmodTarget(),
         ModPlugTarget(),
+        OmpTarget(),
         OpusFileTarget(),
         PngTarget(),
         PortMidiTarget(),
@@ -93,6 +98,7 @@ def targets():
         Sdl2MixerTarget(),
         Sdl2NetTarget(),
         SodiumTarget(),
+        SoxrTarget(),
         VulkanHeadersTarget(),
         VulkanLoaderTarget(),
         WavPackTarget(),
@@ -100,6 +106,7 @@ def targets():
 
         # Obsolete libraries without binaries
         BrotliTarget(),
+        EmbreeTarget(),
         ExpatTarget(),
         FreeImageTarget(),
         FreeTypeTarget(),
@@ -108,6 +115,9 @@ def targets():
         HarfBuzzTarget(),
         HighwayTarget(),
         JpegTurboTarget(),
+        JxlTarget(),
+        Lcms2Target(),
+        LuaJitTarget(),
         LuaTarget(),
         Sdl2TtfTarget(),
         SfmlTarget(),
@@ -125,6 +135,7 @@ def targets():
         YasmTarget(),
 
         # Tools without binaries stored in the repo, can be outdated
+        AstcEncTarget(),
         AutoconfTarget(),
         AutomakeTarget(),
         DosBoxXTarget(),
@@ -147,6 +158,14 @@ def targets():
         BuildPrefix(),
         CleanAllTarget(),
         CleanDepsTarget(),
+        DepsAllTarget(),
+        DownloadAllTarget(),
         DownloadCMakeTarget(),
+        ExportResultsTarget(),
+        PerfRunTarget(),
+        PgoTrainTarget(),
+        ProfileLaunchTarget(),
+        SizeReportTarget(),
         TestDepsTarget(),
+        BenchDepsTarget(),
     )
@@ -26,6 +26,7 @@ import typing
 from pathlib import Path
 from platform import machine
 
+from ..configcache import CMakeCheckCache, ConfigCache
 from ..state import BuildState
 from ..utility import CommandLineOptions, symlink_directory
 
@@ -41,6 +42,25 @@ class Target:
         self.multi_platform = False
         self.unsupported_architectures = ()
 
+        # Platforms can be built concurrently unless non-native build uses results of native one
+        self.concurrent_platforms = True
+
+        # Names of targets that need to be built before this one, see deps-all target
+        self.dependencies = ()
+
+        # Target is instrumented and optimized by --pgo builds, see pgo-train target
+        self.profile_guided = False
+
+        # Target gets Haswell slice in --fat-x64 builds
+        self.fat_x86_64 = False
+
+        # Target is compiled with function entry and exit hooks in trace variant, see function-trace target
+        self.function_traced = False
+
+        # Dependency variants that target links by default, i.e. names of build state flags like 'quasi_glib',
+        # they are enabled as if their command line options were given, unless --no-dependency-profile is
+        self.dependency_profile = ()
+
     def prepare_source(self, state: BuildState):
         """ Called when target is selected by name """
         pass
@@ -75,6 +95,7 @@ class BuildTarget(Target):
 
         self.src_root = ''
         self.multi_platform = True
+        self.dependencies = ('gmake', 'pkg-config')
 
     def configure(self, state: BuildState):
         os.makedirs(state.build_path, exist_ok=True)
@@ -89,9 +110,9 @@ class BuildTarget(Target):
             return
 
         if c_compiler := state.c_compiler():
-            env['CC'] = str(c_compiler)
+            env['CC'] = state.compiler_command(c_compiler)
         if cxx_compiler := state.cxx_compiler():
-            env['CXX'] = str(cxx_compiler)
+            env['CXX'] = state.compiler_command(cxx_compiler)
 
         for prefix in ('C', 'CPP', 'CXX', 'OBJC', 'OBJCXX'):
             state.update_flags_environment_variable(f'{prefix}FLAGS', state.compiler_flags())
@@ -101,19 +122,80 @@ class BuildTarget(Target):
         # Avoid timestamp only differences in static libraries
         env['ZERO_AR_DATE'] = '1'
 
+    # Environment variables that affect configuration, in addition to command line arguments
+    CONFIGURE_VARIABLES = ('CC', 'CXX', 'CFLAGS', 'CPPFLAGS', 'CXXFLAGS', 'OBJCFLAGS', 'OBJCXXFLAGS', 'LDFLAGS')
+
+    @staticmethod
+    def configure_stamp(state: BuildState, args: typing.Sequence) -> str:
+        env = state.environment
+        lines = [str(arg) for arg in args]
+        lines += [f'{name}={env[name]}' for name in BuildTarget.CONFIGURE_VARIABLES if name in env]
+
+        return '\n'.join(lines) + '\n'
+
+    @staticmethod
+    def is_configured(state: BuildState, work_path: Path, stamp: str) -> bool:
+        if not state.incremental:
+            return False
+
+        stamp_path = work_path / '.aedi-configure'
+
+        if stamp_path.exists() and stamp_path.read_text() == stamp:
+            print('Configuration is unchanged, skipping configure step')
+            return True
+
+        return False
+
+    @staticmethod
+    def set_configured(work_path: Path, stamp: str):
+        # Stored by every build, so the next incremental one can reuse configured build directory
+        (work_path / '.aedi-configure').write_text(stamp)
+
     def install(self, state: BuildState, options: typing.Optional[CommandLineOptions] = None, tool: str = 'gmake'):
         if state.xcode:
             return
 
-        if state.install_path.exists():
-            shutil.rmtree(state.install_path)
-
         args = [tool]
         args += options and options.to_list() or ['install']
 
-        subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
+        if not state.incremental:
+            if state.install_path.exists():
+                shutil.rmtree(state.install_path)
+
+            subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
+
+            with state.phase('update-pc-files'):
+                self.update_pc_files(state)
+
+            return
+
+        # Install into staging directory, and swap it with the previous installation when complete
+        staging_path = state.install_path.with_name(state.install_path.name + '.staging')
+        previous_path = state.install_path.with_name(state.install_path.name + '.previous')
+
+        for path in (staging_path, previous_path):
+            if path.exists():
+                shutil.rmtree(path)
 
-        self.update_pc_files(state)
+        env = state.environment.copy()
+        env['DESTDIR'] = str(staging_path)
+        subprocess.run(args, check=True, cwd=state.build_path, env=env)
+
+        staged_install_path = staging_path / state.install_path.relative_to(state.install_path.anchor)
+
+        # Makefiles without DESTDIR support install over the previous installation
+        if staged_install_path.exists():
+            if state.install_path.exists():
+                os.rename(state.install_path, previous_path)
+
+            os.rename(staged_install_path, state.install_path)
+
+        for path in (staging_path, previous_path):
+            if path.exists():
+                shutil.rmtree(path)
+
+        with state.phase('update-pc-files'):
+            self.update_pc_files(state)
 
     @staticmethod
     def update_text_file(path: Path, processor: typing.Optional[typing.Callable] = None):
@@ -273,15 +355,13 @@ class MakeTarget(BuildTarget):
     def build(self, state: BuildState):
         assert not state.xcode
 
-        args = [
-            self.tool,
-            '-j', state.jobs,
-        ]
+        args = [self.tool]
+        args += state.make_jobs_arguments()
 
         if c_compiler := state.c_compiler():
-            args.append(f'CC={c_compiler}')
+            args.append(f'CC={state.compiler_command(c_compiler)}')
         if cxx_compiler := state.cxx_compiler():
-            args.append(f'CXX={cxx_compiler}')
+            args.append(f'CXX={state.compiler_command(cxx_compiler)}')
 
         args += state.options.to_list()
 
@@ -308,15 +388,29 @@ class ConfigureMakeTarget(MakeTarget):
         disable_dependency_tracking = '--disable-dependency-tracking'
         host = '--host=' + state.host()
 
+        stamp = self.configure_stamp(state, common_args)
+
+        if self.is_configured(state, work_path, stamp):
+            return
+
         args = copy.copy(common_args)
         args.append(host)
         args.append(disable_dependency_tracking)
 
+        # Results of checks are shared by slices of the same architecture of all targets
+        config_cache = ConfigCache(state) if ConfigCache.is_autoconf_script(configure_path) else None
+        config_cache_path = work_path / 'config.cache'
+
+        if config_cache:
+            config_cache.restore(config_cache_path)
+            args.append(f'--cache-file={config_cache_path}')
+
         try:
             # Try with host and disabled dependency tracking first
             subprocess.run(args, check=True, cwd=work_path, env=state.environment)
         except subprocess.CalledProcessError:
             # If it fails, try with disabled dependency tracking only
+            # Shared cache is not used anymore, wrong result of some check may be the reason of failure
             args = copy.copy(common_args)
             args.append(disable_dependency_tracking)
 
@@ -325,6 +419,11 @@ class ConfigureMakeTarget(MakeTarget):
             except subprocess.CalledProcessError:
                 # Use only common command line arguments
                 subprocess.run(common_args, check=True, cwd=work_path, env=state.environment)
+        else:
+            if config_cache:
+                config_cache.store(config_cache_path)
+
+        self.set_configured(work_path, stamp)
 
     def build(self, state: BuildState):
         # Clear configure script options
@@ -334,35 +433,39 @@ class ConfigureMakeTarget(MakeTarget):
 
 
 class CMakeTarget(BuildTarget):
-    cached_project_name = None
+    # Project names by path of CMakeLists.txt, so detection of all CMake targets reads the same file once
+    project_names: typing.Dict[Path, typing.Optional[str]] = {}
 
     def __init__(self, name=None):
         super().__init__(name)
+        self.dependencies += ('cmake',)
 
     def detect(self, state: BuildState) -> bool:
-        if CMakeTarget.cached_project_name:
-            project_name = CMakeTarget.cached_project_name
-        else:
-            cmakelists_path = state.source / self.src_root / 'CMakeLists.txt'
+        cmakelists_path = state.source / self.src_root / 'CMakeLists.txt'
 
-            if not cmakelists_path.exists():
-                return False
+        if cmakelists_path not in CMakeTarget.project_names:
+            CMakeTarget.project_names[cmakelists_path] = CMakeTarget._read_project_name(cmakelists_path)
 
-            for line in open(cmakelists_path).readlines():
-                project_name = CMakeTarget._extract_project_name(line)
-                if project_name:
-                    project_name = project_name.lower()
-                    project_name = project_name.replace(' ', '-')
-                    break
-            else:
-                return False
+        return CMakeTarget.project_names[cmakelists_path] == self.name
 
-            if project_name.startswith('lib'):
-                project_name = project_name[3:]
+    @staticmethod
+    def _read_project_name(cmakelists_path: Path) -> typing.Optional[str]:
+        if not cmakelists_path.exists():
+            return None
+
+        for line in cmakelists_path.read_text(errors='replace').splitlines():
+            project_name = CMakeTarget._extract_project_name(line)
+            if project_name:
+                project_name = project_name.lower()
+                project_name = project_name.replace(' ', '-')
+                break
+        else:
+            return None
 
-            CMakeTarget.cached_project_name = project_name
+        if project_name.startswith('lib'):
+            project_name = project_name[3:]
 
-        return project_name == self.name
+        return project_name
 
     @staticmethod
     def _extract_project_name(line: str):
@@ -399,13 +502,21 @@ class CMakeTarget(BuildTarget):
         if state.xcode:
             args.append('-GXcode')
         else:
-            args.append('-GUnix Makefiles')
+            if state.ninja:
+                args.append('-GNinja')
+                args.append(f'-DCMAKE_MAKE_PROGRAM={state.ninja}')
+            else:
+                args.append('-GUnix Makefiles')
 
             if c_compiler := state.c_compiler():
                 args.append(f'-DCMAKE_C_COMPILER={c_compiler}')
             if cxx_compiler := state.cxx_compiler():
                 args.append(f'-DCMAKE_CXX_COMPILER={cxx_compiler}')
 
+            if launcher := state.compiler_launcher():
+                for language in ('C', 'CXX', 'OBJC', 'OBJCXX'):
+                    args.append(f'-DCMAKE_{language}_COMPILER_LAUNCHER={launcher}')
+
             architecture = state.architecture()
             if architecture != machine():
                 args.append('-DCMAKE_SYSTEM_NAME=Darwin')
@@ -420,21 +531,56 @@ class CMakeTarget(BuildTarget):
             args.append('-DCMAKE_OSX_DEPLOYMENT_TARGET=' + str(os_version))
 
         args += opts.to_list(CommandLineOptions.CMAKE_RULES)
+
+        # Results of common checks are shared by slices of the same architecture of all targets
+        check_cache = None if state.xcode else CMakeCheckCache(state)
+
+        if check_cache:
+            initial_cache_path = state.build_path / 'aedi-initial-cache.cmake'
+            args += ['-C', initial_cache_path]
+
         args.append(state.source / self.src_root)
 
+        stamp = self.configure_stamp(state, args)
+
+        if self.is_configured(state, state.build_path, stamp):
+            return
+
+        if check_cache:
+            check_cache.write_initial_cache(initial_cache_path)
+
         subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
+        self.set_configured(state.build_path, stamp)
+
+        if check_cache:
+            check_cache.store(state.build_path / 'CMakeCache.txt')
 
     def build(self, state: BuildState):
         if state.xcode:
             args = ['cmake', '--open', '.']
+        elif state.ninja:
+            # Ninja 1.11 has no jobserver client, it runs as many jobs as there are free tokens
+            with state.fixed_jobs() as jobs:
+                args = [state.ninja, '-j', jobs]
+
+                if state.verbose:
+                    args.append('-v')
+
+                subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
+
+            return
         else:
-            args = ['gmake', '-j', state.jobs]
+            args = ['gmake']
+            args += state.make_jobs_arguments()
 
             if state.verbose:
                 args.append('VERBOSE=1')
 
         subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
 
+    def install(self, state: BuildState, options: typing.Optional[CommandLineOptions] = None, tool: str = 'gmake'):
+        super().install(state, options, state.ninja if state.ninja else tool)
+
 
 class ConfigureMakeDependencyTarget(ConfigureMakeTarget):
     def __init__(self, name=None):
@@ -512,7 +658,7 @@ class SingleExeCTarget(MakeTarget):
         c_compiler = state.c_compiler()
         assert c_compiler
 
-        args = [str(c_compiler), '-O3', '-o', self.name] + state.options.to_list()
+        args = state.compiler_command(c_compiler).split() + ['-O3', '-o', self.name] + state.options.to_list()
 
         for var in ('CFLAGS', 'LDFLAGS'):
             args += shlex.split(state.environment[var])
@@ -526,6 +672,7 @@ class SingleExeCTarget(MakeTarget):
 class MesonTarget(BuildTarget):
     def __init__(self, name=None):
         super().__init__(name)
+        self.dependencies += ('meson', 'ninja')
 
     def configure(self, state: BuildState):
         super().configure(state)
@@ -549,18 +696,28 @@ class MesonTarget(BuildTarget):
         args.append(state.build_path)
         args.append(state.source)
 
+        stamp = self.configure_stamp(state, args)
+
+        if self.is_configured(state, state.build_path, stamp):
+            return
+
         subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
+        self.set_configured(state.build_path, stamp)
 
     def build(self, state: BuildState):
         if state.xcode:
             args = ['open', f'{self.name}.xcodeproj']
-        else:
-            args = [state.bin_path / 'meson', 'compile']
+            subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
+            return
+
+        # Meson runs ninja without jobserver support, so it gets fixed number of jobs too
+        with state.fixed_jobs() as jobs:
+            args = [state.bin_path / 'meson', 'compile', '-j', jobs]
 
             if state.verbose:
                 args.append('--verbose')
 
-        subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
+            subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
 
     def post_build(self, state: BuildState):
         self.install(state, tool=state.bin_path / 'meson')
@@ -573,16 +730,24 @@ class MesonTarget(BuildTarget):
         cxx_compiler = state.cxx_compiler()
         assert cxx_compiler
 
+        launcher = state.compiler_launcher()
+
+        def compiler_binary(compiler: Path) -> str:
+            return f"['{launcher}', '{compiler}']" if launcher else f"'{compiler}'"
+
+        c_binary = compiler_binary(c_compiler)
+        cxx_binary = compiler_binary(cxx_compiler)
+
         cpu = state.architecture()
         cpu_family = 'arm' if 'arm64' == cpu else cpu
 
         with open(path, 'w') as f:
             f.write(f'''
 [binaries]
-c = '{c_compiler}'
-cpp = '{cxx_compiler}'
-objc = '{c_compiler}'
-objcpp = '{cxx_compiler}'
+c = {c_binary}
+cpp = {cxx_binary}
+objc = {c_binary}
+objcpp = {cxx_binary}
 pkgconfig = '{state.prefix_path}/bin/pkg-config'
 strip = '/usr/bin/strip'
 
@@ -20,6 +20,9 @@ import os
 import shlex
 import shutil
 import subprocess
+import sys
+import tempfile
+import typing
 from pathlib import Path
 
 from ..state import BuildState
@@ -80,6 +83,7 @@ class FfiTarget(base.ConfigureMakeStaticDependencyTarget):
 class FlacTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='flac'):
         super().__init__(name)
+        self.dependencies += ('ogg',)
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -89,13 +93,30 @@ class FlacTarget(base.CMakeStaticDependencyTarget):
     def configure(self, state: BuildState):
         opts = state.options
         opts['BUILD_CXXLIBS'] = 'NO'
+        opts['BUILD_DOCS'] = 'NO'
         opts['BUILD_EXAMPLES'] = 'NO'
         opts['BUILD_PROGRAMS'] = 'NO'
         opts['BUILD_TESTING'] = 'NO'
+        opts['INSTALL_MANPAGES'] = 'NO'
+
+        # Bit reader and writer process 64-bit words, this is faster on both architectures
+        opts['ENABLE_64_BIT_WORDS'] = 'YES'
+
+        # SSE2 and SSE4.1 intrinsics are always compiled for x86_64, AVX2 and FMA ones are chosen at runtime
+        # NEON intrinsics are compiled when arm_neon.h is found, this check doesn't depend on host architecture
+        opts['WITH_AVX'] = 'NO' if state.architecture() == 'arm64' else 'YES'
 
         super().configure(state)
 
 
+class FunctionTraceTarget(base.CMakeStaticDependencyTarget):
+    def __init__(self, name='function-trace'):
+        super().__init__(name)
+
+    def prepare_source(self, state: BuildState):
+        state.source = state.patch_path / self.name
+
+
 class GettextTarget(base.ConfigureMakeStaticDependencyTarget):
     def __init__(self, name='gettext'):
         super().__init__(name)
@@ -120,6 +141,7 @@ class GettextTarget(base.ConfigureMakeStaticDependencyTarget):
 class GlibTarget(base.MesonTarget):
     def __init__(self, name='glib'):
         super().__init__(name)
+        self.dependencies += ('ffi', 'pcre')
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -131,11 +153,19 @@ class GlibTarget(base.MesonTarget):
         return state.has_source_file('glib.doap')
 
     def configure(self, state: BuildState):
-        # Additional frameworks are needed for proper detection of libintl
-        ld_key = 'LDFLAGS'
-        ld_value = '-framework CoreFoundation -framework Foundation'
-        env = state.environment
-        env[ld_key] = (env[ld_key] + ' ' + ld_value) if ld_key in env else ld_value
+        # Conversions use iconv of the system, and messages aren't translated, so GNU libiconv and libintl archives
+        # aren't linked into every GLib user, and there is no gettext initialization at launch
+        opts = state.options
+        opts['nls'] = 'disabled'
+        opts['tests'] = 'false'
+
+        if state.variant == 'perf':
+            # Precondition checks, assertions, and GObject cast checks are hot in soundfont loading of FluidSynth
+            # and libinstpatch, invalid calls are not reported without them, so they are removed in perf variant only
+            opts['b_ndebug'] = 'true'
+            opts['glib_assert'] = 'false'
+            opts['glib_checks'] = 'false'
+            opts['glib_debug'] = 'disabled'
 
         super().configure(state)
 
@@ -143,6 +173,13 @@ class GlibTarget(base.MesonTarget):
         super().post_build(state)
         self.make_platform_header(state, '../lib/glib-2.0/include/glibconfig.h')
 
+        if state.variant == 'perf':
+            # Cast macros are expanded in code of GObject users, so they get the same define as GLib itself
+            def disable_cast_checks(line: str) -> str:
+                return line.rstrip('\n') + ' -DG_DISABLE_CAST_CHECKS\n' if line.startswith('Cflags:') else line
+
+            self.update_text_file(state.install_path / 'lib/pkgconfig/gobject-2.0.pc', disable_cast_checks)
+
     @staticmethod
     def _process_pkg_config(pcfile: Path, line: str) -> str:
         return 'exec_prefix=${prefix}\n' + line if line.startswith('libdir=') else line
@@ -168,6 +205,7 @@ class IconvTarget(base.ConfigureMakeStaticDependencyTarget):
 class IntlTarget(GettextTarget):
     def __init__(self, name='intl'):
         super().__init__(name)
+        self.dependencies += ('iconv',)
 
     def configure(self, state: BuildState):
         state.options['--localedir'] = '/usr/local/share/locale'
@@ -267,42 +305,94 @@ class MoltenVKTarget(base.MakeTarget):
         static_lib_path = lib_path / 'libMoltenVK-static.a'
         dynamic_lib_path = lib_path / 'libMoltenVK.dylib'
 
+        # Static library is missing while MoltenVK itself is being built, e.g. by deps-all target
+        if not static_lib_path.exists():
+            return
+
+        # Order file is generated from profiled launch by patch/moltenvk/generate_order.py
+        order_file_path = state.patch_path / 'moltenvk' / 'libMoltenVK.order'
+        use_order_file = state.moltenvk_startup_link and order_file_path.exists()
+
+        # Modification time of dylib identifies what it was linked from,
+        # startup link is stamped one second later, so switching link mode relinks it
         static_lib_time = os.stat(static_lib_path).st_mtime
+        if use_order_file:
+            static_lib_time = max(static_lib_time, os.stat(order_file_path).st_mtime)
+        if state.moltenvk_startup_link:
+            static_lib_time += 1
+
         dynamic_lib_time = os.stat(dynamic_lib_path).st_mtime if os.path.exists(dynamic_lib_path) else 0
 
-        if static_lib_time != dynamic_lib_time:
-            os.makedirs(state.lib_path, exist_ok=True)
-
-            args = [
-                'clang++',
-                '-stdlib=libc++',
-                '-dynamiclib',
-                '-arch', 'arm64',
-                '-arch', 'x86_64',
-                '-mmacosx-version-min=10.15',
-                '-compatibility_version', '1.0.0',
-                '-current_version', '1.0.0',
-                '-install_name', '@rpath/libMoltenVK.dylib',
-                '-framework', 'Metal',
-                '-framework', 'IOSurface',
-                '-framework', 'AppKit',
-                '-framework', 'QuartzCore',
-                '-framework', 'CoreGraphics',
-                '-framework', 'IOKit',
-                '-framework', 'Foundation',
-                '-o', dynamic_lib_path,
-                '-force_load', static_lib_path
-            ]
-            args += shlex.split(state.linker_flags())
+        if static_lib_time == dynamic_lib_time:
+            return
 
-            subprocess.run(args, check=True, env=state.environment)
+        os.makedirs(state.lib_path, exist_ok=True)
+
+        if not state.moltenvk_startup_link:
+            self._link_dylib(state, static_lib_path, dynamic_lib_path)
             os.utime(dynamic_lib_path, (static_lib_time, static_lib_time))
+            return
+
+        args = [
+            # Only Vulkan API is exported, this allows to strip everything unreachable from it
+            '-Wl,-exported_symbol,_vk*',
+            '-dead_strip',
+            '-Wl,-dead_strip_dylibs',
+        ]
+
+        if use_order_file:
+            # Functions called during launch are placed together to reduce page-ins
+            args.append('-Wl,-order_file,' + str(order_file_path))
+
+        self._link_dylib(state, static_lib_path, dynamic_lib_path, args)
+        os.utime(dynamic_lib_path, (static_lib_time, static_lib_time))
+
+        # Size and pre-main launch time of default and startup links are printed every time the latter is made
+        os.makedirs(state.temp_path, exist_ok=True)
+
+        with tempfile.TemporaryDirectory(dir=state.temp_path) as temp_path:
+            default_lib_path = Path(temp_path) / 'libMoltenVK.dylib'
+            self._link_dylib(state, static_lib_path, default_lib_path)
+
+            report_path = state.patch_path / 'moltenvk' / 'report.py'
+            args = (sys.executable, '-B', report_path, default_lib_path, dynamic_lib_path)
+            subprocess.run(args, check=True, env=state.environment)
+
+    @staticmethod
+    def _link_dylib(state: BuildState, static_lib_path: Path, dynamic_lib_path: Path,
+                    extra_args: typing.Sequence[str] = ()):
+        args = [
+            'clang++',
+            '-stdlib=libc++',
+            '-dynamiclib',
+            '-arch', 'arm64',
+            '-arch', 'x86_64',
+            '-mmacosx-version-min=10.15',
+            '-compatibility_version', '1.0.0',
+            '-current_version', '1.0.0',
+            '-install_name', '@rpath/libMoltenVK.dylib',
+            '-framework', 'Metal',
+            '-framework', 'IOSurface',
+            '-framework', 'AppKit',
+            '-framework', 'QuartzCore',
+            '-framework', 'CoreGraphics',
+            '-framework', 'IOKit',
+            '-framework', 'Foundation',
+            '-o', dynamic_lib_path,
+            '-force_load', static_lib_path,
+        ]
+
+        args += extra_args
+        args += shlex.split(state.linker_flags())
+
+        subprocess.run(args, check=True, env=state.environment)
 
 
 class Mpg123Target(base.CMakeStaticDependencyTarget):
     def __init__(self, name='mpg123'):
         super().__init__(name)
         self.src_root = 'ports/cmake'
+        self.function_traced = True
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -331,11 +421,15 @@ class OggTarget(base.CMakeStaticDependencyTarget):
 class OpenALTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='openal'):
         super().__init__(name)
+        self.profile_guided = True
+        self.fat_x86_64 = True
+        self.function_traced = True
 
     def prepare_source(self, state: BuildState):
         state.download_source(
             'https://openal-soft.org/openal-releases/openal-soft-1.23.1.tar.bz2',
-            '796f4b89134c4e57270b7f0d755f0fa3435b90da437b745160a49bd41c845b21')
+            '796f4b89134c4e57270b7f0d755f0fa3435b90da437b745160a49bd41c845b21',
+            patches=('openal-keep-hrtf', 'openal-signposts'))
 
     def configure(self, state: BuildState):
         opts = state.options
@@ -343,6 +437,30 @@ class OpenALTarget(base.CMakeStaticDependencyTarget):
         opts['ALSOFT_UTILS'] = 'NO'
         opts['LIBTYPE'] = 'STATIC'
 
+        if state.openal_low_latency:
+            # Loopback and null backends are always built, no time is spent on probing of unavailable ones at startup
+            opts['ALSOFT_REQUIRE_COREAUDIO'] = 'YES'
+            opts['ALSOFT_BACKEND_WAVE'] = 'YES'
+
+            for backend in ('JACK', 'PIPEWIRE', 'PORTAUDIO', 'PULSEAUDIO', 'SDL2'):
+                opts[f'ALSOFT_BACKEND_{backend}'] = 'NO'
+
+            # Configuration fails instead of silent fallback to generic C mixer
+            if state.architecture() == 'arm64':
+                opts['ALSOFT_REQUIRE_NEON'] = 'YES'
+            else:
+                opts['ALSOFT_REQUIRE_SSE4_1'] = 'YES'
+
+        if state.openal_fast_init:
+            # Default HRTF is read from library instead of data directories, and after the first device opening,
+            # its parsed and resampled data set is reused by later devices, bsinc tables are built at library load
+            # only, before the first device, so they add nothing to reopening
+            opts['ALSOFT_EMBED_HRTF_DATA'] = 'YES'
+            opts['CMAKE_CXX_FLAGS'] += '-DALSOFT_KEEP_LOADED_HRTFS'
+
+        if state.audio_signposts:
+            opts['CMAKE_CXX_FLAGS'] += '-DALSOFT_SIGNPOSTS'
+
         super().configure(state)
 
 
@@ -363,7 +481,20 @@ class OpusTarget(base.CMakeStaticDependencyTarget):
             'b84610959b8d417b611aa12a22565e0a3732097c6389d19098d844543e340f85')
 
     def configure(self, state: BuildState):
-        state.options['PC_BUILD'] = 'floating-point'
+        opts = state.options
+        opts['PC_BUILD'] = 'floating-point'
+        opts['OPUS_ENABLE_FLOAT_API'] = 'YES'
+
+        # Detection of target CPU doesn't work for cross-compiled slices, so intrinsics are set explicitly
+        # Since version 1.5, AVX option is named AVX2, and NEON ones apply to both 32 and 64-bit ARM
+        if state.architecture() == 'arm64':
+            opts['OPUS_MAY_HAVE_NEON'] = 'YES'
+            opts['OPUS_PRESUME_NEON'] = 'YES'
+        else:
+            opts['OPUS_X86_PRESUME_SSE2'] = 'YES'
+            opts['OPUS_X86_MAY_HAVE_SSE4_1'] = 'YES'
+            opts['OPUS_X86_MAY_HAVE_AVX2'] = 'YES'
+
         super().configure(state)
 
     @staticmethod
@@ -396,6 +527,9 @@ class PcreTarget(base.ConfigureMakeStaticDependencyTarget):
         opts['--enable-unicode-properties'] = 'yes'
         opts['--enable-cpp'] = 'no'
 
+        # JIT compiler of PCRE 8.x allocates executable memory without MAP_JIT, it cannot work on Apple Silicon
+        opts['--enable-jit'] = 'no' if state.architecture() == 'arm64' else 'yes'
+
         super().configure(state)
 
     def post_build(self, state: BuildState):
@@ -410,10 +544,24 @@ class QuasiGlibTarget(base.CMakeStaticDependencyTarget):
     def prepare_source(self, state: BuildState):
         state.source = state.patch_path / self.name
 
+    def post_build(self, state: BuildState):
+        super().post_build(state)
+
+        # Mangled names, and C++ ABI and personality functions, would come from libc++ and libc++abi
+        args = ('nm', '-u', '-j', state.install_path / 'lib/libquasi-glib.a')
+        output = subprocess.run(args, check=True, capture_output=True, env=state.environment).stdout
+        symbols = output.decode('utf-8', errors='replace').splitlines()
+        runtime_symbols = sorted({symbol for symbol in symbols if symbol.startswith(('__Z', '___cxa_', '___gxx_'))})
+
+        if runtime_symbols:
+            raise RuntimeError('quasi-glib depends on C++ runtime: ' + ', '.join(runtime_symbols))
+
 
 class SndFileTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='sndfile'):
         super().__init__(name)
+        self.dependencies += ('flac', 'lame', 'mpg123', 'ogg', 'opus', 'vorbis')
+        self.function_traced = True
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -427,22 +575,32 @@ class SndFileTarget(base.CMakeStaticDependencyTarget):
         opts['BUILD_TESTING'] = 'NO'
         opts['ENABLE_CPACK'] = 'NO'
 
+        if state.ogg_seek_index:
+            # Vorbis and Opus music, e.g. looped by ZMusic, seeks within two pages instead of the whole file
+            opts['CMAKE_PROJECT_INCLUDE'] = state.patch_path / self.name / 'SeekIndex.cmake'
+
         super().configure(state)
 
 
 class VorbisTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='vorbis'):
         super().__init__(name)
+        self.dependencies += ('ogg',)
+        self.function_traced = True
 
     def prepare_source(self, state: BuildState):
+        # SSE2 and NEON butterflies of MDCT and stereo residue accumulation, compared with stock decoder in perf variant
         state.download_source(
             'https://ftp.osuosl.org/pub/xiph/releases/vorbis/libvorbis-1.3.7.tar.xz',
-            'b33cc4934322bcbf6efcbacf49e3ca01aadbea4114ec9589d1b1e9d20f72954b')
+            'b33cc4934322bcbf6efcbacf49e3ca01aadbea4114ec9589d1b1e9d20f72954b',
+            patches='vorbis-simd' if state.variant == 'perf' else None)
 
 
 class VpxTarget(base.ConfigureMakeDependencyTarget):
     def __init__(self, name='vpx'):
         super().__init__(name)
+        self.dependencies += ('nasm', 'yasm')
+        self.function_traced = True
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -463,6 +621,22 @@ class VpxTarget(base.ConfigureMakeDependencyTarget):
         opts['--disable-unit-tests'] = None
         opts['--target'] = hosts[state.architecture()]
 
+        # Games only play movies, so the library is decoder-only, and without high bit depth for smaller size
+        opts['--disable-vp8-encoder'] = None
+        opts['--disable-vp9-encoder'] = None
+        opts['--disable-vp9-highbitdepth'] = None
+        opts['--enable-multithread'] = None
+
+        # All SIMD variants are compiled in, and the best ones for the running CPU are selected at runtime
+        opts['--enable-runtime-cpu-detect'] = None
+
+        if state.architecture() == 'arm64':
+            opts['--enable-neon'] = None
+            opts['--enable-neon-dotprod'] = None
+            opts['--enable-neon-i8mm'] = None
+        else:
+            opts['--enable-avx2'] = None
+
         super().configure(state)
 
         def clean_build_config(line: str):
@@ -471,6 +645,49 @@ class VpxTarget(base.ConfigureMakeDependencyTarget):
 
         self.update_text_file(state.build_path / 'vpx_config.c', clean_build_config)
 
+    def post_build(self, state: BuildState):
+        super().post_build(state)
+
+        # Codec interface declarations aren't installed, vpx-videotoolbox implements VP9 decoder interface with them
+        internal_path = state.install_path / 'include/vpx/internal'
+        os.makedirs(internal_path, exist_ok=True)
+        shutil.copy(state.source / 'vpx/internal/vpx_codec_internal.h', internal_path)
+
+
+class VpxIOSurfaceTarget(base.CMakeStaticDependencyTarget):
+    def __init__(self, name='vpx-iosurface'):
+        super().__init__(name)
+        self.dependencies += ('vpx',)
+
+    def prepare_source(self, state: BuildState):
+        state.source = state.patch_path / self.name
+
+    def post_build(self, state: BuildState):
+        super().post_build(state)
+
+        # Movie frames are decoded into IOSurfaces, ports import them as textures, e.g. via MoltenVK's Metal objects
+        self.write_pc_file(state, description='VP9 decoding into IOSurface-backed frame buffers', version='1.0',
+                           requires='vpx', libs='-lvpx-iosurface',
+                           libs_private='-framework CoreVideo -framework IOSurface -framework CoreFoundation')
+
+
+class VpxVideoToolboxTarget(base.CMakeStaticDependencyTarget):
+    def __init__(self, name='vpx-videotoolbox'):
+        super().__init__(name)
+        self.dependencies += ('vpx',)
+
+    def prepare_source(self, state: BuildState):
+        state.source = state.patch_path / self.name
+
+    def post_build(self, state: BuildState):
+        super().post_build(state)
+
+        # Hardware VP9 decoder is used when available, and libvpx one otherwise, hence both are linked
+        self.write_pc_file(state, description='VP9 decoding by VideoToolbox with libvpx fallback', version='1.0',
+                           requires='vpx', libs='-lvpx-videotoolbox',
+                           libs_private='-framework VideoToolbox -framework CoreMedia -framework CoreVideo '
+                                        '-framework CoreFoundation')
+
 
 class WebpTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='webp'):
@@ -486,8 +703,15 @@ class WebpTarget(base.CMakeStaticDependencyTarget):
             'ANIM_UTILS', 'CWEBP', 'DWEBP', 'EXTRAS', 'GIF2WEBP', 'IMG2WEBP', 'VWEBP', 'WEBPINFO', 'WEBPMUX',
         )
 
+        opts = state.options
+
         for suffix in option_suffices:
-            state.options[f'WEBP_BUILD_{suffix}'] = 'NO'
+            opts[f'WEBP_BUILD_{suffix}'] = 'NO'
+
+        # Alpha plane is decoded in a worker thread, SIMD code for all extensions that compile for the slice is built,
+        # and DSP initialization chooses it by CPU features at runtime, i.e. SSE2 and SSE4.1 on x86_64, NEON on arm64
+        opts['WEBP_ENABLE_SIMD'] = 'YES'
+        opts['WEBP_USE_THREAD'] = 'YES'
 
         super().configure(state)
 
@@ -500,6 +724,8 @@ class WebpTarget(base.CMakeStaticDependencyTarget):
 class ZlibNgTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='zlib-ng'):
         super().__init__(name)
+        self.profile_guided = True
+        self.function_traced = True
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -517,17 +743,34 @@ class ZlibNgTarget(base.CMakeStaticDependencyTarget):
         opts['ZLIB_ENABLE_TESTS'] = 'NO'
         opts['ZLIBNG_ENABLE_TESTS'] = 'NO'
 
+        # Every supported extension is compiled in, and the best one is selected at runtime via functable
+        # Instructions of build host are never used unconditionally, so all slices run on any CPU of their architecture
+        opts['WITH_OPTIM'] = 'YES'
+        opts['WITH_NATIVE_INSTRUCTIONS'] = 'NO'
+
+        if state.architecture().startswith('x86_64'):
+            for extension in ('SSE2', 'SSSE3', 'SSE42', 'PCLMULQDQ', 'AVX2', 'AVX512', 'AVX512VNNI', 'VPCLMULQDQ'):
+                opts['WITH_' + extension] = 'YES'
+        else:
+            opts['WITH_ACLE'] = 'YES'
+            opts['WITH_NEON'] = 'YES'
+
         super().configure(state)
 
 
 class ZMusicTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='zmusic'):
         super().__init__(name)
+        self.dependencies += ('glib', 'mpg123', 'sndfile', 'zlib-ng')
+        self.profile_guided = True
+        self.function_traced = True
 
     def prepare_source(self, state: BuildState):
         state.download_source(
             'https://github.com/ZDoom/ZMusic/archive/refs/tags/1.1.12.tar.gz',
-            'da818594b395aa9174561a36362332b0ab8e7906d2e556ec47669326e67613d4')
+            'da818594b395aa9174561a36362332b0ab8e7906d2e556ec47669326e67613d4',
+            patches=('zmusic-stream-stats', 'zmusic-midi-cache', 'zmusic-sample-kernels', 'zmusic-signposts',
+                     'zmusic-stream-prefetch'))
 
     def detect(self, state: BuildState) -> bool:
         return state.has_source_file('include/zmusic.h')
@@ -537,6 +780,24 @@ class ZMusicTarget(base.CMakeStaticDependencyTarget):
         opts['DYN_MPG123'] = 'OFF'
         opts['DYN_SNDFILE'] = 'OFF'
 
+        if state.zmusic_fast_emulators:
+            # Only DOSBox and Opal OPL3 cores of libADLMIDI, and MAME and Gens OPN2 cores of libOPNMIDI are built
+            # Selection of removed core falls back to the first available one, i.e. DOSBox and MAME respectively
+            disabled_emulators = (
+                'ADLMIDI_DISABLE_NUKED_EMULATOR',
+                'ADLMIDI_DISABLE_JAVA_EMULATOR',
+                'OPNMIDI_DISABLE_NUKED_EMULATOR',
+                'OPNMIDI_DISABLE_NP2_EMULATOR',
+                'OPNMIDI_DISABLE_MAME_2608_EMULATOR',
+                'OPNMIDI_DISABLE_PMDWIN_EMULATOR',
+            )
+            defines = ' '.join(f'-D{define}' for define in disabled_emulators)
+            opts['CMAKE_C_FLAGS'] += defines
+            opts['CMAKE_CXX_FLAGS'] += defines
+
+        if state.audio_signposts:
+            opts['CMAKE_CXX_FLAGS'] += '-DZMUSIC_SIGNPOSTS'
+
         super().configure(state)
 
     def post_build(self, state: BuildState):
@@ -552,3 +813,7 @@ class ZMusicTarget(base.CMakeStaticDependencyTarget):
 
         for kind in ('Full', 'Lite'):
             self.update_text_file(module_path / f'ZMusic{kind}Targets.cmake', update_cmake_libs)
+
+        # For benchmarks, ZMusic doesn't provide pkg-config file on its own
+        self.write_pc_file(state, description='GZDoom\'s music system as a standalone library', version='1.1.12',
+                           requires_private='sndfile libmpg123 zlib glib-2.0', libs='-lzmusic', libs_private='-lc++')
@@ -17,7 +17,9 @@
 #
 
 import os
+import re
 import shutil
+import subprocess
 from pathlib import Path
 
 from ..state import BuildState
@@ -31,7 +33,8 @@ class DumbTarget(base.CMakeStaticDependencyTarget):
     def prepare_source(self, state: BuildState):
         state.download_source(
             'https://github.com/kode54/dumb/archive/2.0.3.tar.gz',
-            '99bfac926aeb8d476562303312d9f47fd05b43803050cd889b44da34a9b2a4f9')
+            '99bfac926aeb8d476562303312d9f47fd05b43803050cd889b44da34a9b2a4f9',
+            patches='dumb-resampler-neon')
 
     def detect(self, state: BuildState) -> bool:
         return state.has_source_file('include/dumb.h')
@@ -41,6 +44,10 @@ class DumbTarget(base.CMakeStaticDependencyTarget):
         opts['BUILD_ALLEGRO4'] = 'NO'
         opts['BUILD_EXAMPLES'] = 'NO'
 
+        # Resampler has SSE code paths for cubic and FIR interpolation, they are selected at runtime
+        # NEON ones of arm64 are added by patch, and they don't depend on this option
+        opts['USE_SSE'] = 'NO' if state.architecture() == 'arm64' else 'YES'
+
         super().configure(state)
 
     @staticmethod
@@ -51,12 +58,22 @@ class DumbTarget(base.CMakeStaticDependencyTarget):
 class FluidSynthTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='fluidsynth'):
         super().__init__(name)
+        self.dependencies += ('glib', 'instpatch', 'omp', 'quasi-glib', 'sndfile')
+        self.profile_guided = True
+        self.fat_x86_64 = True
+        self.function_traced = True
 
     def prepare_source(self, state: BuildState):
         state.download_source(
             'https://github.com/FluidSynth/fluidsynth/archive/refs/tags/v2.3.5.tar.gz',
             'f89e8e983ecfb4a5b4f5d8c2b9157ed18d15ed2e36246fa782f18abaea550e0d',
-            patches='fluidsynth-sf3-support')
+            patches=('fluidsynth-sf3-support', 'fluidsynth-mmap-samples', 'fluidsynth-sample-cache-lru',
+                     'fluidsynth-signposts'))
+
+        # DLS loader that maps sample data from file instead of reading all samples into memory when bank is opened
+        loader_path = state.source / 'src/sfloader/fluid_instpatch.c'
+        assert loader_path.exists()
+        shutil.copy(state.patch_path / 'fluidsynth-instpatch/fluid_instpatch.c', loader_path)
 
     def configure(self, state: BuildState):
         opts = state.options
@@ -65,12 +82,34 @@ class FluidSynthTarget(base.CMakeStaticDependencyTarget):
         opts['enable-readline'] = 'NO'
         opts['enable-sdl2'] = 'NO'
 
+        # Apple Clang has no -fopenmp driver option, FindOpenMP is given preprocessor flag and libomp from prefix
+        opts['enable-openmp'] = 'YES'
+        opts['OpenMP_C_FLAGS'] = '-Xpreprocessor -fopenmp'
+        opts['OpenMP_C_LIB_NAMES'] = 'omp'
+        opts['OpenMP_omp_LIBRARY'] = state.lib_path / 'libomp.a'
+
+        if state.quasi_glib_inline:
+            # Mutex, thread private and monotonic time calls are inlined, such library links with quasi-glib only
+            opts['CMAKE_C_FLAGS'] += f'-include {state.include_path / "quasi-glib-inline.h"}'
+
+        if state.audio_signposts:
+            opts['CMAKE_C_FLAGS'] += '-DFLUID_SIGNPOSTS'
+
         super().configure(state)
 
     def post_build(self, state: BuildState):
         super().post_build(state)
         self.keep_module_target(state, 'FluidSynth::libfluidsynth')
 
+    @staticmethod
+    def _process_pkg_config(pcfile: Path, line: str) -> str:
+        libs_private = 'Libs.private:'
+
+        if line.startswith(libs_private) and '-lomp' not in line:
+            return line.rstrip('\n') + ' -lomp\n'
+
+        return line
+
 
 class FmtTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='fmt'):
@@ -106,6 +145,7 @@ class GmeTarget(base.CMakeStaticDependencyTarget):
 class InstPatchTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='instpatch'):
         super().__init__(name)
+        self.dependencies += ('glib', 'sndfile')
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -190,9 +230,41 @@ class ModPlugTarget(base.ConfigureMakeStaticDependencyTarget):
         return line
 
 
+class OmpTarget(base.CMakeStaticDependencyTarget):
+    def __init__(self, name='omp'):
+        super().__init__(name)
+        self.fat_x86_64 = True
+
+    def prepare_source(self, state: BuildState):
+        # Newer releases need LLVM's CMake modules from separate package to build standalone
+        state.download_source(
+            'https://github.com/llvm/llvm-project/releases/download/llvmorg-14.0.6/openmp-14.0.6.src.tar.xz',
+            '4f731ff202add030d9d68d4c6daabd91d3aeed9812e6a5b4968815cfdff0eb1f')
+
+    def detect(self, state: BuildState) -> bool:
+        return state.has_source_file('runtime/src/kmp.h')
+
+    def configure(self, state: BuildState):
+        opts = state.options
+        opts['LIBOMP_ENABLE_SHARED'] = 'NO'
+        opts['LIBOMP_INSTALL_ALIASES'] = 'NO'
+        opts['LIBOMP_OMPT_SUPPORT'] = 'NO'
+        opts['OPENMP_ENABLE_LIBOMPTARGET'] = 'NO'
+        opts['OPENMP_ENABLE_TESTING'] = 'NO'
+
+        super().configure(state)
+
+    def post_build(self, state: BuildState):
+        super().post_build(state)
+
+        # Upstream provides neither CMake package nor pkg-config file
+        self.write_pc_file(state, description='LLVM OpenMP runtime library', version='14.0.6', libs='-lomp')
+
+
 class OpusFileTarget(base.ConfigureMakeStaticDependencyTarget):
     def __init__(self, name='opusfile'):
         super().__init__(name)
+        self.dependencies += ('ogg', 'opus')
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -218,7 +290,9 @@ class PngTarget(base.CMakeStaticDependencyTarget):
 
     def configure(self, state: BuildState):
         opts = state.options
+        # Only the option that matches target architecture is used, NEON for arm64 and SSE2 for x86_64
         opts['PNG_ARM_NEON'] = 'on'
+        opts['PNG_INTEL_SSE'] = 'on'
         opts['PNG_SHARED'] = 'OFF'
 
         super().configure(state)
@@ -257,15 +331,22 @@ class PortMidiTarget(base.CMakeTarget):
         os.makedirs(lib_path)
         shutil.copy(state.build_path / 'libportmidi_s.a', lib_path / 'libportmidi.a')
 
+        # CoreMIDI backend schedules output by MIDIPacketList timestamps when stream is opened with non-zero latency
+        self.write_pc_file(state, description='Portable Real-Time MIDI Library', version='217',
+                           libs_private='-framework CoreAudio -framework CoreFoundation '
+                                        '-framework CoreMIDI -framework CoreServices')
+
 
 class SamplerateTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='samplerate'):
         super().__init__(name)
 
     def prepare_source(self, state: BuildState):
+        # AVX2, SSE2 and NEON inner products of mono and stereo sinc filters, chosen at runtime
         state.download_source(
             'https://github.com/libsndfile/libsamplerate/releases/download/0.2.1/libsamplerate-0.2.1.tar.bz2',
-            'f6323b5e234753579d70a0af27796dde4ebeddf58aae4be598e39b3cee00c90a')
+            'f6323b5e234753579d70a0af27796dde4ebeddf58aae4be598e39b3cee00c90a',
+            patches='samplerate-simd')
 
     def post_build(self, state: BuildState):
         super().post_build(state)
@@ -283,21 +364,48 @@ class Sdl2Target(base.CMakeStaticDependencyTarget):
         super().__init__(name)
 
     def prepare_source(self, state: BuildState):
+        # NEON and SSE2 resampler, and mono to stereo and back converters of SDL_AudioCVT and SDL_AudioStream,
+        # compared with stock conversion in perf variant
+        patches = ('sdl2-audio-simd', 'sdl2-coreaudio-buffer-size') if state.variant == 'perf' \
+            else 'sdl2-coreaudio-buffer-size'
         state.download_source(
             'https://github.com/libsdl-org/SDL/releases/download/release-2.30.1/SDL2-2.30.1.tar.gz',
-            '01215ffbc8cfc4ad165ba7573750f15ddda1f971d5a66e9dcaffd37c587f473a')
+            '01215ffbc8cfc4ad165ba7573750f15ddda1f971d5a66e9dcaffd37c587f473a',
+            patches=patches)
 
     def configure(self, state: BuildState):
         opts = state.options
         opts['SDL_STATIC_PIC'] = 'YES'
         opts['SDL_TEST'] = 'NO'
 
+        # None of the ports use OpenGL ES, haptic and sensor subsystems, or disk and virtual devices
+        # Metal render driver and OpenGL context creation stay, CoreAudio is the only audio driver for playback,
+        # and game controllers are handled by IOKit, GameController framework and HIDAPI joystick drivers
+        # Dummy audio driver stays too, profile-launch target starts games with it, so they run silently
+        for option in ('OPENGLES', 'HAPTIC', 'SENSOR', 'DISKAUDIO', 'VIRTUAL_JOYSTICK', 'OFFSCREEN'):
+            opts[f'SDL_{option}'] = 'NO'
+
+        opts['SDL_RENDER_METAL'] = 'YES'
+
         super().configure(state)
 
+    def post_build(self, state: BuildState):
+        super().post_build(state)
+
+        if state.variant == 'perf':
+            # Hunks of the patch can apply with offset to unrelated code, e.g. after SDL update, so library
+            # of perf variant must export the switch of vector kernels that sdl2 test and benchmark compare with
+            args = ('nm', '-j', '-U', state.install_path / 'lib/libSDL2.a')
+            output = subprocess.run(args, check=True, capture_output=True, env=state.environment).stdout
+
+            if '_SDL_SelectAudioSIMD' not in output.decode('utf-8', errors='replace').splitlines():
+                raise RuntimeError('SDL2 is built without vector audio kernels of sdl2-audio-simd patch')
+
 
 class Sdl2ImageTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='sdl2_image'):
         super().__init__(name)
+        self.dependencies += ('jxl', 'sdl2', 'webp')
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -306,6 +414,8 @@ class Sdl2ImageTarget(base.CMakeStaticDependencyTarget):
 
     def configure(self, state: BuildState):
         opts = state.options
+        opts['SDL2IMAGE_JXL'] = 'YES'
+        opts['SDL2IMAGE_JXL_SHARED'] = 'NO'
         opts['SDL2IMAGE_WEBP'] = 'YES'
         opts['SDL2IMAGE_WEBP_SHARED'] = 'NO'
 
@@ -313,13 +423,14 @@ class Sdl2ImageTarget(base.CMakeStaticDependencyTarget):
 
     @staticmethod
     def _process_pkg_config(pcfile: Path, line: str) -> str:
-        # Link with webpdemux library instead of webp
-        return line.replace('\n', 'demux\n') if line.startswith('Requires.private:') else line
+        # Link with webpdemux library instead of webp, libjxl goes before it in the list of private requirements
+        return re.sub(r'\blibwebp\b', 'libwebpdemux', line) if line.startswith('Requires.private:') else line
 
 
 class Sdl2MixerTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='sdl2_mixer'):
         super().__init__(name)
+        self.dependencies += ('flac', 'fluidsynth', 'gme', 'modplug', 'mpg123', 'opusfile', 'sdl2', 'vorbis', 'wavpack', 'xmp')
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -342,6 +453,7 @@ class Sdl2MixerTarget(base.CMakeStaticDependencyTarget):
 class Sdl2NetTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='sdl2_net'):
         super().__init__(name)
+        self.dependencies += ('sdl2',)
         self.version = '2.2.0'
 
     def prepare_source(self, state: BuildState):
@@ -350,6 +462,19 @@ class Sdl2NetTarget(base.CMakeStaticDependencyTarget):
             f'{base_url}/release-{self.version}/SDL2_net-{self.version}.tar.gz',
             '4e4a891988316271974ff4e9585ed1ef729a123d22c08bd473129179dc857feb')
 
+    def configure(self, state: BuildState):
+        # Replace select() based socket sets with kqueue based ones
+        src = state.patch_path / self.name / 'SDLnetselect.c'
+        dst = state.source / 'SDLnetselect.c'
+
+        src_stat = os.stat(src)
+        dst_stat = os.stat(dst)
+
+        if src_stat.st_size != dst_stat.st_size or src_stat.st_mtime != dst_stat.st_mtime:
+            shutil.copy2(src, dst)
+
+        super().configure(state)
+
     def post_build(self, state: BuildState):
         super().post_build(state)
 
@@ -365,12 +490,70 @@ class SodiumTarget(base.ConfigureMakeStaticDependencyTarget):
 
     def prepare_source(self, state: BuildState):
         state.download_source(
-            'https://download.libsodium.org/libsodium/releases/libsodium-1.0.18.tar.gz',
-            '6f504490b342a4f8a4c4a02fc9b866cbef8622d5df4e5452b46be121e46636c1')
+            'https://download.libsodium.org/libsodium/releases/libsodium-1.0.20.tar.gz',
+            'ebb65ef6ca439333c2bb41a0c1990587288da07f6c7fd07cb3a18cc18d30ce19')
 
     def detect(self, state: BuildState) -> bool:
         return state.has_source_file('libsodium.pc.in')
 
+    def configure(self, state: BuildState):
+        # Optimization for build machine CPU would break runtime dispatch of universal binary
+        state.options['--enable-opt'] = 'no'
+
+        super().configure(state)
+
+        # Accelerated implementations are compiled only when configure finds their intrinsics, select them at runtime
+        # ARMv8 crypto extension is used by AES-GCM, AES-NI with PCLMUL by AES-GCM, and AVX2 by BLAKE2b and Argon2
+        if state.architecture() == 'arm64':
+            required_defines = ('HAVE_ARMCRYPTO',)
+        else:
+            required_defines = ('HAVE_WMMINTRIN_H', 'HAVE_AVX2INTRIN_H')
+
+        makefile = (state.build_path / self.src_root / 'Makefile').read_text()
+        missing_defines = [define for define in required_defines if f'-D{define}=1' not in makefile]
+
+        if missing_defines:
+            raise RuntimeError(f'libsodium was configured without {", ".join(missing_defines)} '
+                               f'for {state.architecture()}, see config.log')
+
+
+class SoxrTarget(base.CMakeStaticDependencyTarget):
+    def __init__(self, name='soxr'):
+        super().__init__(name)
+        self.fat_x86_64 = True
+
+    def prepare_source(self, state: BuildState):
+        state.download_source(
+            'https://sourceforge.net/projects/soxr/files/soxr-0.1.3-Source.tar.xz',
+            'b111c15fdc8c029989330ff559184198c161100a59312f5dc19ddeb9b5a15889')
+
+    def detect(self, state: BuildState) -> bool:
+        return state.has_source_file('src/soxr.h')
+
+    def configure(self, state: BuildState):
+        opts = state.options
+        opts['BUILD_EXAMPLES'] = 'NO'
+        opts['BUILD_TESTS'] = 'NO'
+        opts['WITH_LSR_BINDINGS'] = 'NO'
+
+        # Resampling of audio streams runs in their threads, OpenMP would only add thread pool to every converter
+        opts['WITH_OPENMP'] = 'NO'
+
+        # SIMD engines of this version are SSE and AVX ones, both are compiled, and the best one is chosen at runtime
+        # Its NEON code is for 32-bit ARM only, so arm64 slice has scalar engines
+        if state.architecture() != 'arm64':
+            opts['WITH_CR32S'] = 'YES'
+            opts['WITH_CR64S'] = 'YES'
+
+        super().configure(state)
+
+    def post_build(self, state: BuildState):
+        super().post_build(state)
+
+        # Upstream pkg-config file is installed for shared library only
+        self.write_pc_file(state, description='High quality, one-dimensional sample-rate conversion library',
+                           version='0.1.3', libs='-lsoxr')
+
 
 class VulkanHeadersTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='vulkan-headers'):
@@ -387,6 +570,7 @@ class VulkanHeadersTarget(base.CMakeStaticDependencyTarget):
 class VulkanLoaderTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='vulkan-loader'):
         super().__init__(name)
+        self.dependencies += ('vulkan-headers',)
         self.version = '1.3.280'
 
     def prepare_source(self, state: BuildState):
@@ -429,6 +613,9 @@ class WavPackTarget(base.CMakeStaticDependencyTarget):
         opts['WAVPACK_ENABLE_LIBCRYPTO'] = 'NO'
         opts['WAVPACK_INSTALL_DOCS'] = 'NO'
 
+        # Assembly decorrelation passes exist for x86_64 and 32-bit ARM only, arm64 slice uses C code
+        opts['WAVPACK_ENABLE_ASM'] = 'NO' if state.architecture() == 'arm64' else 'YES'
+
         super().configure(state)
 
 
@@ -18,7 +18,9 @@
 
 import glob
 import os
+import re
 import shutil
+import typing
 from pathlib import Path
 
 from ..state import BuildState
@@ -52,6 +54,35 @@ class BrotliTarget(base.CMakeStaticDependencyTarget):
         return line.replace('-R${libdir} ', '') if line.startswith('Libs:') else line
 
 
+class EmbreeTarget(base.CMakeStaticDependencyTarget):
+    def __init__(self, name='embree'):
+        super().__init__(name)
+
+    def prepare_source(self, state: BuildState):
+        # ericw-tools 0.18 uses API of Embree 3
+        state.download_source(
+            'https://github.com/embree/embree/archive/refs/tags/v3.13.5.tar.gz',
+            'b8c22d275d9128741265537c559d0ea73074adbf2f2b66b0a766ca52c52d665b')
+
+    def detect(self, state: BuildState) -> bool:
+        return state.has_source_file('include/embree3/rtcore.h')
+
+    def configure(self, state: BuildState):
+        opts = state.options
+        opts['EMBREE_ISPC_SUPPORT'] = 'NO'
+        opts['EMBREE_STATIC_LIB'] = 'YES'
+        opts['EMBREE_TUTORIALS'] = 'NO'
+
+        # Thread pool of Embree itself instead of TBB, the only user is multithreaded on its own
+        opts['EMBREE_TASKING_SYSTEM'] = 'INTERNAL'
+
+        # Kernels of every ISA above the base one go to separate libraries that exist for x86_64 only,
+        # one kernel library per slice keeps the same set of files and CMake modules in both slices
+        opts['EMBREE_MAX_ISA'] = 'NEON' if state.architecture() == 'arm64' else 'SSE2'
+
+        super().configure(state)
+
+
 class ExpatTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='expat'):
         super().__init__(name)
@@ -71,9 +102,22 @@ class ExpatTarget(base.CMakeStaticDependencyTarget):
 
 
 class FreeImageTarget(base.MakeTarget):
+    # Bundled libraries that are replaced with ones from prefix, mapped to their pkg-config modules
+    UNBUNDLED_LIBRARIES = {
+        'LibJPEG': 'libjpeg',
+        'LibPNG': 'libpng',
+        'LibWebP': 'libwebpmux',
+        'ZLib': 'zlib',
+    }
+
     def __init__(self, name='freeimage'):
         super().__init__(name)
 
+        # Bundled copies of libjpeg, libpng, libwebp and zlib are years old, and built without SIMD code,
+        # so codecs are linked from prefix by default, set to False to build the bundled ones instead
+        self.unbundled = True
+        self.dependencies += ('jpeg-turbo', 'png', 'webp', 'zlib-ng')
+
     def prepare_source(self, state: BuildState):
         state.download_source(
             'https://downloads.sourceforge.net/project/freeimage/Source%20Distribution/3.18.0/FreeImage3180.zip',
@@ -98,6 +142,70 @@ class FreeImageTarget(base.MakeTarget):
         for option in ('-f', 'Makefile.gnu', 'libfreeimage.a'):
             state.options[option] = None
 
+        if self.unbundled:
+            self._unbundle_libraries(state)
+
+    def _unbundle_libraries(self, state: BuildState):
+        bundled_paths = tuple(f'Source/{directory}' for directory in self.UNBUNDLED_LIBRARIES)
+
+        def is_bundled(path: str) -> bool:
+            path = path[2:] if path.startswith('./') else path
+            return any(path == bundled or path.startswith(bundled + '/') for bundled in bundled_paths)
+
+        def update_makefile(line: str) -> str:
+            name, separator, value = line.partition(' = ')
+
+            if name == 'SRCS':
+                # Lossless JPEG transformations are made by transupp.c of bundled libjpeg 9, it can't be built
+                # with libjpeg-turbo headers, so FreeImage_JPEGTransform*() functions are not available
+                paths = [path for path in value.split()
+                         if not is_bundled(path) and not path.endswith('/JPEGTransform.cpp')]
+            elif name == 'INCLUDE':
+                paths = [path for path in value.split() if not is_bundled(path[2:])]
+            else:
+                return line
+
+            return name + separator + ' '.join(paths) + '\n'
+
+        bundled_include_regex = re.compile(r'#include\s+"\.\./(?:LibJPEG|LibPNG|LibWebP/src|ZLib)/([^"]+)"')
+
+        def update_include(match: typing.Match) -> str:
+            header = match.group(1)
+
+            if header == 'jinclude.h':
+                # Configuration of bundled libjpeg, stdio.h is the only thing needed from it
+                return '#include <stdio.h>'
+            elif header == 'zutil.h':
+                # Internal zlib header, gzip header written by ZLibInterface.cpp only needs OS code, 19 is for Darwin
+                return '#define OS_CODE 19'
+
+            return f'#include <{header}>'
+
+        self._replace_build_file(state, 'Makefile.srcs',
+                                 lambda content: ''.join(update_makefile(line) for line in content.splitlines(True)))
+
+        for directory in ('FreeImage', 'FreeImageToolkit', 'Metadata'):
+            for path in sorted((state.source / 'Source' / directory).iterdir()):
+                if path.suffix in ('.c', '.cpp', '.h'):
+                    self._replace_build_file(state, path.relative_to(state.source),
+                                             lambda content: bundled_include_regex.sub(update_include, content))
+
+    @staticmethod
+    def _replace_build_file(state: BuildState, subpath: typing.Union[str, Path], processor: typing.Callable):
+        # Build directory has symbolic links to source files, changed file replaces its link
+        # Sources are not UTF-8 encoded, Latin-1 keeps all their bytes intact
+        content = (state.source / subpath).read_text(encoding='latin-1')
+        updated_content = processor(content)
+        build_file_path = state.build_path / subpath
+
+        if updated_content == content:
+            return
+        if not build_file_path.is_symlink() and build_file_path.read_text(encoding='latin-1') == updated_content:
+            return
+
+        os.unlink(build_file_path)
+        build_file_path.write_text(updated_content, encoding='latin-1')
+
     def post_build(self, state: BuildState):
         include_path = state.install_path / 'include'
         os.makedirs(include_path, exist_ok=True)
@@ -107,18 +215,29 @@ class FreeImageTarget(base.MakeTarget):
         os.makedirs(lib_path, exist_ok=True)
         shutil.copy(state.build_path / 'libfreeimage.a', lib_path)
 
-        self.write_pc_file(state, version='3.18.0', libs='-lfreeimage -lc++')
+        requires = ' '.join(self.UNBUNDLED_LIBRARIES.values()) if self.unbundled else ''
+        self.write_pc_file(state, version='3.18.0', requires_private=requires, libs='-lfreeimage -lc++')
 
 
 class FreeTypeTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='freetype'):
         super().__init__(name)
+        self.dependencies += ('brotli',)
 
     def prepare_source(self, state: BuildState):
         state.download_source(
             'https://downloads.sourceforge.net/project/freetype/freetype2/2.13.2/freetype-2.13.2.tar.xz',
             '12991c4e55c506dd7f9b765933e62fd2be2e06d421505d7950a132e4f1bb484d')
 
+    def configure(self, state: BuildState):
+        opts = state.options
+        # WOFF2 fonts need Brotli decoder
+        opts['FT_REQUIRE_BROTLI'] = 'ON'
+        # HarfBuzz is built with FreeType, so it's never available to FreeType autohinter, the cycle is not resolved
+        opts['FT_DISABLE_HARFBUZZ'] = 'ON'
+
+        super().configure(state)
+
     def post_build(self, state: BuildState):
         super().post_build(state)
 
@@ -127,7 +246,7 @@ class FreeTypeTarget(base.CMakeStaticDependencyTarget):
         shutil.copy(state.patch_path / 'freetype-config', bin_path)
 
         def update_linker_flags(line: str):
-            link_flags = '-lbz2 -lpng16 -lz'
+            link_flags = '-lbrotlidec -lbrotlicommon -lbz2 -lpng16 -lz'
             link_var = '  INTERFACE_LINK_LIBRARIES '
 
             return f'{link_var}"{link_flags}"\n' if line.startswith(link_var) else line
@@ -252,6 +371,7 @@ class HighwayTarget(base.CMakeStaticDependencyTarget):
 class JpegTurboTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='jpeg-turbo'):
         super().__init__(name)
+        self.dependencies += ('nasm',)
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -263,9 +383,73 @@ class JpegTurboTarget(base.CMakeStaticDependencyTarget):
         opts['ENABLE_SHARED'] = 'NO'
         opts['WITH_TURBOJPEG'] = 'NO'
 
+        # Configuration fails instead of silent build without SIMD code
+        opts['REQUIRE_SIMD'] = 'YES'
+
+        if state.architecture() != 'arm64':
+            # Assembler from prefix directory, x86_64 slice can be cross-compiled on host without NASM in PATH
+            opts['CMAKE_ASM_NASM_COMPILER'] = state.bin_path / 'nasm'
+
         super().configure(state)
 
 
+class JxlTarget(base.CMakeStaticDependencyTarget):
+    def __init__(self, name='jxl'):
+        super().__init__(name)
+        self.dependencies += ('brotli', 'highway', 'lcms2')
+
+    def prepare_source(self, state: BuildState):
+        state.download_source(
+            'https://github.com/libjxl/libjxl/archive/refs/tags/v0.8.2.tar.gz',
+            'c70916fb3ed43784eb840f82f05d390053a558e2da106e40863919238fa7b420')
+
+    def detect(self, state: BuildState) -> bool:
+        return state.has_source_file('lib/include/jxl/decode.h')
+
+    def configure(self, state: BuildState):
+        opts = state.options
+        opts['BUILD_TESTING'] = 'NO'
+        opts['JPEGXL_ENABLE_BENCHMARK'] = 'NO'
+        opts['JPEGXL_ENABLE_DOXYGEN'] = 'NO'
+        opts['JPEGXL_ENABLE_EXAMPLES'] = 'NO'
+        opts['JPEGXL_ENABLE_JNI'] = 'NO'
+        opts['JPEGXL_ENABLE_MANPAGES'] = 'NO'
+        opts['JPEGXL_ENABLE_OPENEXR'] = 'NO'
+        opts['JPEGXL_ENABLE_PLUGINS'] = 'NO'
+        opts['JPEGXL_ENABLE_SJPEG'] = 'NO'
+        opts['JPEGXL_ENABLE_TOOLS'] = 'NO'
+
+        # Source package has no submodules, SIMD code of Highway with runtime dispatch, Brotli for metadata boxes,
+        # and Little CMS for color management, instead of skcms, are taken from prefix
+        opts['JPEGXL_ENABLE_SKCMS'] = 'NO'
+        opts['JPEGXL_FORCE_SYSTEM_BROTLI'] = 'YES'
+        opts['JPEGXL_FORCE_SYSTEM_HWY'] = 'YES'
+        opts['JPEGXL_FORCE_SYSTEM_LCMS2'] = 'YES'
+
+        super().configure(state)
+
+    @staticmethod
+    def _process_pkg_config(pcfile: Path, line: str) -> str:
+        # Both libjxl and libjxl_threads, its parallel runner on thread pool, are written in C++
+        if line.startswith('Libs.private:') and '-lc++' not in line:
+            return line.rstrip('\n') + ' -lc++\n'
+
+        return line
+
+
+class Lcms2Target(base.ConfigureMakeStaticDependencyTarget):
+    def __init__(self, name='lcms2'):
+        super().__init__(name)
+
+    def prepare_source(self, state: BuildState):
+        state.download_source(
+            'https://github.com/mm2/Little-CMS/releases/download/lcms2.16/lcms2-2.16.tar.gz',
+            'd873d34ad8b9b4cea010631f1a6228d2087475e4dc5e763eb81acc23d9d45a51')
+
+    def detect(self, state: BuildState) -> bool:
+        return state.has_source_file('include/lcms2.h')
+
+
 class LuaTarget(base.MakeTarget):
     def __init__(self, name='lua'):
         super().__init__(name)
@@ -284,6 +468,42 @@ class LuaTarget(base.MakeTarget):
         opts['INSTALL_TOP'] = state.install_path
 
         self.install(state, state.options)
+        self.write_pc_file(state, description='Lua scripting language', version='5.4.6', libs='-llua')
+
+
+class LuaJitTarget(base.MakeTarget):
+    # Drop-in replacement of Lua for consumers that use Lua 5.1 API only
+    # Machine code area is allocated with MAP_JIT on arm64, and made writable per thread with
+    # pthread_jit_write_protect_np(), application bundle with hardened runtime needs allow-jit entitlement
+    def __init__(self, name='luajit'):
+        super().__init__(name)
+
+    def prepare_source(self, state: BuildState):
+        # LuaJIT has no release packages, its default v2.1 branch is the rolling release
+        state.checkout_git('https://github.com/LuaJIT/LuaJIT.git')
+
+    def detect(self, state: BuildState) -> bool:
+        return state.has_source_file('src/luajit_rolling.h')
+
+    def configure(self, state: BuildState):
+        super().configure(state)
+
+        opts = state.options
+        opts['amalg'] = None
+        opts['BUILDMODE'] = 'static'
+        opts['PREFIX'] = state.install_path
+        opts['MACOSX_DEPLOYMENT_TARGET'] = str(state.os_version())
+
+        # Code generators run during the build, so they are compiled for host, and slice's CPU is given to them
+        # as target architecture, 64-bit host compiler can generate code for both slices
+        opts['HOST_CC'] = 'clang'
+
+    def post_build(self, state: BuildState):
+        opts = state.options
+        del opts['amalg']
+        opts['install'] = None
+
+        self.install(state, state.options)
 
 
 class Sdl2TtfTarget(base.CMakeStaticDependencyTarget):
@@ -444,5 +664,7 @@ class ZstdTarget(base.CMakeStaticDependencyTarget):
         opts = state.options
         opts['ZSTD_BUILD_PROGRAMS'] = 'NO'
         opts['ZSTD_BUILD_SHARED'] = 'NO'
+        opts['ZSTD_LEGACY_SUPPORT'] = 'NO'
+        opts['ZSTD_MULTITHREAD_SUPPORT'] = 'YES'
 
         super().configure(state)
@@ -17,11 +17,19 @@
 #
 
 import os
+import plistlib
+import re
+import shlex
 import shutil
+import subprocess
+import sys
+import typing
 from pathlib import Path
 from platform import machine
 
+from ..artifact import ArtifactCache
 from ..state import BuildState
+from ..utility import clone_tree
 from . import base
 
 
@@ -30,6 +38,43 @@ class MakeMainTarget(base.MakeTarget):
         super().__init__(name)
 
         self.destination = self.DESTINATION_OUTPUT
+        self.concurrent_platforms = False
+
+        # Optimization level of compiler, and make variable that takes it when makefile sets its own -O option
+        self.optimization_level = None
+        self.optimization_variable = None
+
+        # Link-time optimization mode of this target when the whole build has no --lto option, e.g. 'thin'
+        self.lto = None
+
+    def configure(self, state: BuildState):
+        super().configure(state)
+
+        if state.xcode:
+            return
+
+        # Tuning and PGO flags of every slice come from build state with the rest of compiler and linker flags,
+        # so makefiles that take CFLAGS and LDFLAGS from the environment get them like CMake targets do
+        compiler_flags = ''
+        linker_flags = ''
+
+        if self.optimization_level:
+            if self.optimization_variable:
+                state.options[self.optimization_variable] = self.optimization_level
+            else:
+                compiler_flags += f' -O{self.optimization_level}'
+
+        if self.lto and not state.lto:
+            lto_compiler_flags, lto_linker_flags = state.target_lto_flags(self.lto)
+            compiler_flags += lto_compiler_flags
+            linker_flags += lto_linker_flags
+
+        env = state.environment
+
+        for prefix in ('C', 'CXX', 'OBJC', 'OBJCXX'):
+            env[f'{prefix}FLAGS'] += compiler_flags
+
+        env['LDFLAGS'] += linker_flags
 
 
 class CMakeMainTarget(base.CMakeTarget):
@@ -39,6 +84,31 @@ class CMakeMainTarget(base.CMakeTarget):
         self.destination = self.DESTINATION_OUTPUT
         self.outputs = (self.name + '.app',)
 
+        # Cross-compilation imports executables from native build, and some targets patch their source code
+        self.concurrent_platforms = False
+
+        # Number of sources merged into one by --unity-build, and regular expressions of sources that are not merged
+        self.unity_build_batch_size = 16
+        self.unity_build_exclusions = ()
+
+        # Headers precompiled for C++ sources by --unity-build, only the standard library ones are safe for any code
+        self.precompiled_headers = ('<algorithm>', '<functional>', '<map>', '<memory>', '<string>', '<vector>')
+
+    def configure(self, state: BuildState):
+        if state.unity_build:
+            opts = state.options
+            opts['CMAKE_UNITY_BUILD'] = 'ON'
+            opts['CMAKE_UNITY_BUILD_BATCH_SIZE'] = self.unity_build_batch_size
+            opts['CMAKE_PROJECT_INCLUDE'] = state.patch_path / 'unity-build' / 'UnityBuild.cmake'
+            opts['AEDI_UNITY_BUILD_EXCLUDE'] = ';'.join(self.unity_build_exclusions)
+            opts['AEDI_PRECOMPILED_HEADERS'] = ';'.join(self.precompiled_headers)
+
+            if state.compiler_cache and state.compiler_cache.name == 'ccache':
+                # Precompiled headers are not cacheable otherwise
+                state.environment['CCACHE_SLOPPINESS'] = 'pch_defines,time_macros,include_file_mtime,include_file_ctime'
+
+        super().configure(state)
+
     def post_build(self, state: BuildState):
         if state.xcode:
             return
@@ -53,10 +123,20 @@ class CMakeMainTarget(base.CMakeTarget):
             dst_sep_pos = output.rfind(os.sep)
             dst = state.install_path / (output if dst_sep_pos == -1 else output[dst_sep_pos + 1:])
 
-            if src.is_dir():
-                shutil.copytree(src, dst)
-            else:
-                shutil.copy(src, dst)
+            clone_tree(src, dst)
+
+    _GLIB_LIBS = ('-lglib-2.0', '-lgthread-2.0')
+
+    @classmethod
+    def _link_libraries(cls, state: BuildState, *modules: str) -> str:
+        # Both libraries export the same symbols, so GLib is replaced with quasi-glib rather than linked alongside
+        libs = state.run_pkg_config('--libs', *modules)
+        split_libs = shlex.split(libs)
+
+        if state.quasi_glib and any(lib in cls._GLIB_LIBS for lib in split_libs):
+            libs = ' '.join([lib for lib in split_libs if lib not in cls._GLIB_LIBS] + ['-lquasi-glib'])
+
+        return libs
 
     @staticmethod
     def _force_cross_compilation(state: BuildState):
@@ -81,12 +161,40 @@ class CMakeSingleExeMainTarget(CMakeMainTarget):
         self.outputs = (name,)
 
 
+# OpenAL Soft configuration used by --openal-low-latency, it's loaded from resources of application bundle
+# Period of 256 frames is about 5 ms at 48 kHz, mixing thread runs with real-time priority
+OPENAL_LOW_LATENCY_CONFIG = '''[general]
+drivers = coreaudio
+period_size = 256
+periods = 2
+rt-prio = 1
+'''
+
+
 class ZDoomBaseTarget(CMakeMainTarget):
     def __init__(self, name=None):
         super().__init__(name)
+        self.profile_guided = True
+        self.fat_x86_64 = True
+
+        # Sources of engines based on ZDoom that --unity-build doesn't merge, they were not timed, only listed
+        # for the known reasons: preprocessor macros or file scope names of one file clash with ones of others
+        self.unity_build_exclusions = (
+            # Bundled third-party C++ code, e.g. asmjit, glslang, discord-rpc and libsmackerdec
+            r'/thirdparty/', r'/libraries/asmjit/', r'/glslang/', r'/libraries/discordrpc/',
+            # Vulkan memory allocator has its implementation in the header, it's expanded by one source only
+            r'/vk_mem_alloc\.cpp$',
+            # Scaler filters define the same pixel macros in every file
+            r'/hqnx/', r'/hqnx_asm/', r'/xbr/',
+            # Sources that include generated scanners and parsers with their static tables and YY macros
+            r'/sc_man\.cpp$', r'/parse_xlat\.cpp$', r'/zcc_parser\.cpp$',
+            # Revision file changes with every commit, merged sources would be compiled again with it
+            r'/gitinfo\.cpp$',
+        )
 
     def configure(self, state: BuildState):
-        pkg_config_args = ['--libs', 'openal', 'sndfile']
+        # Static ZMusic needs all libraries it was built with, i.e. sndfile, mpg123, zlib, and GLib or its replacement
+        pkg_config_args = ['--libs', 'openal', 'sndfile', 'libmpg123']
         linker_flags = f'{state.lib_path}/libz.a '
 
         if state.quasi_glib:
@@ -99,19 +207,247 @@ class ZDoomBaseTarget(CMakeMainTarget):
         opts['PK3_QUIET_ZIPDIR'] = 'YES'
         opts['DYN_OPENAL'] = 'NO'
 
-        self._force_cross_compilation(state)
+        if state.has_source_file('cmake/FindZMusic.cmake'):
+            # Find module searches default paths too, shared library from elsewhere, e.g. Homebrew one, would be
+            # loaded and bound at launch instead of static library from dependencies, which --dead-strip can trim
+            opts['ZMUSIC_INCLUDE_DIR'] = state.include_path
+            opts['ZMUSIC_LIBRARIES'] = state.lib_path / 'libzmusic.a'
+
+        if state.prelink_deps and not state.xcode:
+            opts['CMAKE_EXE_LINKER_FLAGS'] = self._prelink_dependencies(state, opts['CMAKE_EXE_LINKER_FLAGS'])
+
+        if not self._import_host_tools(state):
+            self._force_cross_compilation(state)
+
+        self._share_pk3_files(state)
         self._force_openal_soft(state)
 
         super().configure(state)
 
+    @staticmethod
+    def _share_pk3_files(state: BuildState):
+        # PK3 files are the same for all slices, cross-compiled ones copy them from native build instead of
+        # compressing every entry again, when sources are newer than its PK3 file, every slice, native one too,
+        # packs it by aedi.pack.IncrementalPack, so only changed lumps are compressed, by all CPU cores
+        # Native slice imports zipdir when host tools are cached, it runs zipdir it has just built otherwise
+        if state.xcode or not state.options['IMPORT_EXECUTABLES']:
+            return
+
+        os.makedirs(state.build_path, exist_ok=True)
+
+        launcher_path = state.build_path / 'aedi-zipdir'
+        native_build_path = state.native_build_path or state.build_path
+        launcher_path.write_text(f'''#!/bin/sh
+exec "{sys.executable}" -B "{state.patch_path / 'share-pk3/zipdir.py'}" "$(cat "$0.location")" \\
+    "{state.build_path}" "{native_build_path}" "$@"
+''')
+        launcher_path.chmod(0o755)
+
+        opts = state.options
+        opts['AEDI_NATIVE_IMPORT_EXECUTABLES'] = opts['IMPORT_EXECUTABLES']
+        opts['AEDI_ZIPDIR_LAUNCHER'] = launcher_path
+        opts['IMPORT_EXECUTABLES'] = state.patch_path / 'share-pk3/ImportExecutables.cmake'
+
+    def post_build(self, state: BuildState):
+        if not state.xcode:
+            config_path = state.build_path / f'{self.name}.app/Contents/Resources/.alsoftrc'
+            self._write_openal_config(config_path, state.openal_low_latency)
+
+        super().post_build(state)
+
+        if not state.xcode and state.architecture() == machine():
+            self._store_host_tools(state)
+
+    HOST_TOOLS_IMPORT_NAME = 'ImportExecutables.cmake'
+
+    @staticmethod
+    def _host_tools_path(state: BuildState) -> typing.Optional[Path]:
+        # Host tools, like lemon, re2c and zipdir, are shared by all slices and all targets with the same sources
+        # of tools directory, they are built by the same host compiler, so its version is the rest of the key
+        tools_path = state.source / 'tools'
+
+        if not tools_path.is_dir():
+            return None
+
+        components = [subprocess.run(('clang', '--version'), check=True, capture_output=True,
+                                     env=state.environment).stdout]
+
+        for path in sorted(tools_path.rglob('*')):
+            if path.is_file():
+                components += [str(path.relative_to(tools_path)), path.read_bytes()]
+
+        key = ArtifactCache.key(components)
+        return state.cache_path / 'host-tools' / f'{machine()}-{key[:16]}'
+
+    def _import_host_tools(self, state: BuildState) -> bool:
+        # Every slice, including native one, imports cached host tools instead of building them
+        if state.xcode or not (host_tools_path := self._host_tools_path(state)):
+            return False
+
+        import_path = host_tools_path / self.HOST_TOOLS_IMPORT_NAME
+
+        if not import_path.exists():
+            return False
+
+        opts = state.options
+        opts['FORCE_CROSSCOMPILE'] = 'YES'
+        opts['IMPORT_EXECUTABLES'] = import_path
+
+        return True
+
+    def _store_host_tools(self, state: BuildState):
+        native_import_path = state.build_path / self.HOST_TOOLS_IMPORT_NAME
+
+        # Native build that imported cached host tools doesn't export them
+        if not native_import_path.exists() or not (host_tools_path := self._host_tools_path(state)):
+            return
+
+        if (host_tools_path / self.HOST_TOOLS_IMPORT_NAME).exists():
+            return
+
+        # Executables are copied from native build directory with their relative paths, and import file
+        # is updated to point to the copies, so the cache doesn't depend on build directory of any target
+        build_path_prefix = str(state.build_path) + os.sep
+        build_path_pattern = re.compile(r'"' + re.escape(build_path_prefix) + r'([^"]+)"')
+        content = native_import_path.read_text()
+
+        temp_path = host_tools_path.with_name(f'{host_tools_path.name}.{os.getpid()}.tmp')
+
+        if temp_path.exists():
+            shutil.rmtree(temp_path)
+
+        for relative_path in set(build_path_pattern.findall(content)):
+            source_path = state.build_path / relative_path
+
+            if not source_path.is_file():
+                shutil.rmtree(temp_path, ignore_errors=True)
+                return
+
+            os.makedirs((temp_path / relative_path).parent, exist_ok=True)
+            shutil.copy2(source_path, temp_path / relative_path)
+
+        os.makedirs(temp_path, exist_ok=True)
+        content = content.replace(build_path_prefix, str(host_tools_path) + os.sep)
+        (temp_path / self.HOST_TOOLS_IMPORT_NAME).write_text(content)
+
+        # Concurrent builds of other targets may store the same tools
+        try:
+            os.rename(temp_path, host_tools_path)
+        except OSError:
+            shutil.rmtree(temp_path)
+
+    @staticmethod
+    def _write_openal_config(path: Path, enabled: bool):
+        if not enabled:
+            if path.exists():
+                os.unlink(path)
+            return
+
+        if not path.exists() or path.read_text() != OPENAL_LOW_LATENCY_CONFIG:
+            os.makedirs(path.parent, exist_ok=True)
+            path.write_text(OPENAL_LOW_LATENCY_CONFIG)
+
+    PRELINKED_NAME = 'aedi-prelinked-deps'
+
+    @staticmethod
+    def _prelink_dependencies(state: BuildState, linker_flags: str) -> str:
+        # Static libraries from linker flags are combined into one relocatable object, with all their members
+        # Linker reads this object only, instead of scanning every archive on every link of the game
+        # Private external symbols of libraries become local, so only their public interfaces remain visible
+        library_paths = [state.lib_path]
+        archives = []
+        flags = []
+
+        for flag in shlex.split(linker_flags):
+            archive = None
+
+            if flag.startswith('-L'):
+                library_paths.append(Path(flag[2:]))
+            elif flag.startswith('-l'):
+                archive = ZDoomBaseTarget._find_archive(library_paths, flag[2:])
+            elif flag.endswith('.a') and os.path.exists(flag):
+                archive = Path(flag)
+
+            if not archive:
+                flags.append(flag)
+            elif archive not in archives:
+                archives.append(archive)
+
+        if not archives:
+            return linker_flags
+
+        object_path = state.build_path / f'{ZDoomBaseTarget.PRELINKED_NAME}.o'
+        stamp_path = state.build_path / f'{ZDoomBaseTarget.PRELINKED_NAME}.txt'
+
+        # Haswell slice links baseline code of dependencies, see TargetPlatform
+        architecture = 'x86_64' if state.architecture() == 'x86_64h' else state.architecture()
+        stamp = '\n'.join([architecture] + [f'{path} {os.stat(path).st_mtime_ns}' for path in archives]) + '\n'
+
+        if not object_path.exists() or not stamp_path.exists() or stamp_path.read_text() != stamp:
+            args = [
+                'clang', '-r', '-nostdlib',
+                '-arch', architecture,
+                f'-mmacosx-version-min={state.os_version()}',
+                '-Wl,-all_load',
+                '-o', object_path,
+            ]
+
+            if sdk_path := state.sdk_path():
+                args += ['-isysroot', sdk_path]
+
+            args += archives
+
+            try:
+                subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
+            except subprocess.CalledProcessError:
+                # Archives that are linked partially may conflict when all of their members are loaded
+                print('WARNING: Cannot prelink dependencies, linking their archives as usual')
+                stamp_path.unlink(missing_ok=True)
+                return linker_flags
+
+            stamp_path.write_text(stamp)
+
+        return shlex.join([str(object_path)] + flags)
+
+    @staticmethod
+    def _find_archive(library_paths: typing.Sequence[Path], name: str) -> typing.Optional[Path]:
+        # Linker prefers dynamic library to static one from the same directory
+        for library_path in library_paths:
+            if (library_path / f'lib{name}.dylib').exists() or (library_path / f'lib{name}.tbd').exists():
+                return None
+
+            archive_path = library_path / f'lib{name}.a'
+
+            if archive_path.exists():
+                return archive_path
+
+        return None
+
+
+# MoltenVK configuration tuned for game workloads
+# With static MoltenVK, values are defaults only, and environment variables set by user take precedence
+MOLTENVK_GAME_PROFILE = {
+    'MVK_CONFIG_USE_METAL_ARGUMENT_BUFFERS': '1',
+    'MVK_CONFIG_SYNCHRONOUS_QUEUE_SUBMITS': '0',
+    'MVK_CONFIG_SHOULD_MAXIMIZE_CONCURRENT_COMPILATION': '1',
+    'MVK_CONFIG_LOG_LEVEL': '0',
+    'MVK_CONFIG_DEBUG': '0',
+    'MVK_CONFIG_PERFORMANCE_TRACKING': '0',
+    # Handled by static MoltenVK shim only
+    'VOLK_SWAPCHAIN_MIN_LATENCY': '1',
+}
+
 
 class ZDoomVulkanBaseTarget(ZDoomBaseTarget):
     def __init__(self, name=None):
         super().__init__(name)
 
+        # Mapping of MoltenVK configuration variables to their values, upstream defaults are used if empty
+        self.moltenvk_profile = {}
+
     def configure(self, state: BuildState):
         if state.static_moltenvk:
-            state.options['CMAKE_EXE_LINKER_FLAGS'] += '-framework Metal -framework IOSurface -lMoltenVK-static'
+            state.options['CMAKE_EXE_LINKER_FLAGS'] += '-framework CoreFoundation -framework Metal -framework IOSurface -lMoltenVK-static'
 
             # Unset SDK because MoltenVK usually requires the latest one shipped with Xcode
             state.platform.sdk_path = None
@@ -153,8 +489,24 @@ class ZDoomVulkanBaseTarget(ZDoomBaseTarget):
                 if src_stat.st_size != dst_stat.st_size or src_stat.st_mtime != dst_stat.st_mtime:
                     shutil.copy2(src, dst)
 
+            self._write_moltenvk_profile(state.source / replacement_dst_paths[1] / 'volk_profile.h')
+
         super().configure(state)
 
+    def _write_moltenvk_profile(self, path: Path):
+        if not self.moltenvk_profile:
+            if path.exists():
+                os.unlink(path)
+            return
+
+        content = '/* Generated from moltenvk_profile of build target, do not edit */\n\n#define VOLK_PROFILE_SETTINGS \\\n'
+        content += ''.join(f'\t{{ "{name}", "{value}" }}, \\\n' for name, value in self.moltenvk_profile.items())
+        content += '\t/* VOLK_PROFILE_SETTINGS */\n'
+
+        # Avoid rebuilding of volk.c when profile wasn't changed
+        if not path.exists() or path.read_text() != content:
+            path.write_text(content)
+
     def post_build(self, state: BuildState):
         if not state.static_moltenvk:
             # Put MoltenVK library into application bundle
@@ -175,15 +527,36 @@ class ZDoomVulkanBaseTarget(ZDoomBaseTarget):
                 copy_func = os.symlink if state.xcode else shutil.copy
                 copy_func(src_path, dst_path)  # type: ignore
 
+            if self.moltenvk_profile:
+                # Dynamic library cannot be configured at compile time, pass profile via application environment
+                self._apply_moltenvk_profile(dst_path.parent.parent / 'Info.plist')
+
         super().post_build(state)
 
+    def _apply_moltenvk_profile(self, plist_path: Path):
+        with open(plist_path, 'rb') as f:
+            plist = plistlib.load(f)
+
+        environment = plist.setdefault('LSEnvironment', {})
+        changed = False
+
+        for name, value in self.moltenvk_profile.items():
+            if environment.get(name) != value:
+                environment[name] = value
+                changed = True
+
+        if changed:
+            with open(plist_path, 'wb') as f:
+                plistlib.dump(plist, f)
+
 
 class GZDoomTarget(ZDoomVulkanBaseTarget):
     def __init__(self, name='gzdoom'):
         super().__init__(name)
+        self.moltenvk_profile = MOLTENVK_GAME_PROFILE
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/ZDoom/gzdoom.git')
+        state.checkout_git('https://github.com/ZDoom/gzdoom.git', mirror='zdoom')
 
 
 class QZDoomTarget(ZDoomVulkanBaseTarget):
@@ -191,15 +564,16 @@ class QZDoomTarget(ZDoomVulkanBaseTarget):
         super().__init__(name)
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/ZDoom/qzdoom.git')
+        state.checkout_git('https://github.com/ZDoom/qzdoom.git', mirror='zdoom')
 
 
 class VkDoomTarget(ZDoomVulkanBaseTarget):
     def __init__(self, name='vkdoom'):
         super().__init__(name)
+        self.moltenvk_profile = MOLTENVK_GAME_PROFILE
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/dpjudas/VkDoom.git')
+        state.checkout_git('https://github.com/dpjudas/VkDoom.git', mirror='zdoom')
 
 
 class LZDoomTarget(ZDoomBaseTarget):
@@ -216,7 +590,7 @@ class LZDoomTarget(ZDoomBaseTarget):
         super().configure(state)
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/drfrag666/gzdoom.git', branch='g3.3mgw')
+        state.checkout_git('https://github.com/drfrag666/gzdoom.git', branch='g3.3mgw', mirror='zdoom')
 
     def detect(self, state: BuildState) -> bool:
         return state.has_source_file('ico_lzdoom.png')
@@ -225,6 +599,10 @@ class LZDoomTarget(ZDoomBaseTarget):
 class RazeTarget(ZDoomVulkanBaseTarget):
     def __init__(self, name='raze'):
         super().__init__(name)
+        self.moltenvk_profile = MOLTENVK_GAME_PROFILE
+
+        # Game modules and engine code, ported from Build sources, reuse file scope names between their files
+        self.unity_build_exclusions += (r'/source/build/src/', r'/source/games/')
 
     def prepare_source(self, state: BuildState):
         state.checkout_git('https://github.com/ZDoom/Raze.git')
@@ -235,7 +613,7 @@ class HandsOfNecromancyTarget(ZDoomVulkanBaseTarget):
         super().__init__(name)
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/HandsOfNecromancy/HandsOfNecromancy-Engine.git')
+        state.checkout_git('https://github.com/HandsOfNecromancy/HandsOfNecromancy-Engine.git', mirror='zdoom')
 
 
 class RedemptionTarget(ZDoomVulkanBaseTarget):
@@ -243,7 +621,7 @@ class RedemptionTarget(ZDoomVulkanBaseTarget):
         super().__init__(name)
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/RedemptionEngine/redemption.git')
+        state.checkout_git('https://github.com/RedemptionEngine/redemption.git', mirror='zdoom')
 
 
 class DisdainTarget(ZDoomVulkanBaseTarget):
@@ -251,7 +629,7 @@ class DisdainTarget(ZDoomVulkanBaseTarget):
         super().__init__(name)
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/MischiefDonut/disdain-src.git')
+        state.checkout_git('https://github.com/MischiefDonut/disdain-src.git', mirror='zdoom')
 
 
 class AccTarget(CMakeSingleExeMainTarget):
@@ -270,6 +648,16 @@ class WadExtTarget(CMakeSingleExeMainTarget):
         state.checkout_git('https://github.com/ZDoom/wadext.git')
 
 
+class WadExtMmapTarget(CMakeSingleExeMainTarget):
+    def __init__(self, name='wadext-mmap'):
+        super().__init__(name)
+
+    def prepare_source(self, state: BuildState):
+        # Extractor that writes lumps from memory-mapped WAD, and converts graphics and sounds on all cores
+        # Its source is kept here, so it doesn't depend on internals of wadext that change with its branch
+        state.source = state.patch_path / self.name
+
+
 class ZdbspTarget(CMakeSingleExeMainTarget):
     def __init__(self, name='zdbsp'):
         super().__init__(name)
@@ -293,7 +681,7 @@ class PrBoomPlusTarget(CMakeMainTarget):
         self.outputs = ('Launcher.app',)
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/coelckers/prboom-plus.git')
+        state.checkout_git('https://github.com/coelckers/prboom-plus.git', mirror='prboom')
 
     def configure(self, state: BuildState):
         opts = state.options
@@ -311,7 +699,7 @@ class DsdaDoom(PrBoomPlusTarget):
         super().__init__(name)
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/kraflab/dsda-doom.git')
+        state.checkout_git('https://github.com/kraflab/dsda-doom.git', mirror='prboom')
 
 
 class ChocolateDoomBaseTarget(CMakeMainTarget):
@@ -341,7 +729,7 @@ class ChocolateDoomTarget(ChocolateDoomBaseTarget):
         self._fill_outputs('chocolate')
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/chocolate-doom/chocolate-doom.git')
+        state.checkout_git('https://github.com/chocolate-doom/chocolate-doom.git', mirror='chocolate-doom')
 
 
 class CrispyDoomTarget(ChocolateDoomBaseTarget):
@@ -350,7 +738,7 @@ class CrispyDoomTarget(ChocolateDoomBaseTarget):
         self._fill_outputs('crispy')
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/fabiangreffrath/crispy-doom.git')
+        state.checkout_git('https://github.com/fabiangreffrath/crispy-doom.git', mirror='chocolate-doom')
 
 
 class RudeTarget(ChocolateDoomBaseTarget):
@@ -359,7 +747,7 @@ class RudeTarget(ChocolateDoomBaseTarget):
         self._fill_outputs('rude')
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/drfrag666/RUDE.git')
+        state.checkout_git('https://github.com/drfrag666/RUDE.git', mirror='chocolate-doom')
 
     def post_build(self, state: BuildState):
         super().post_build(state)
@@ -386,6 +774,7 @@ class DoomRetroTarget(CMakeMainTarget):
 class Doom64EXTarget(CMakeMainTarget):
     def __init__(self, name='doom64ex'):
         super().__init__(name)
+        self.dependency_profile = ('quasi_glib',)
 
     def prepare_source(self, state: BuildState):
         state.checkout_git('https://github.com/svkaiser/Doom64EX.git')
@@ -393,7 +782,7 @@ class Doom64EXTarget(CMakeMainTarget):
     def configure(self, state: BuildState):
         opts = state.options
         opts['ENABLE_SYSTEM_FLUIDSYNTH'] = 'YES'
-        opts['CMAKE_EXE_LINKER_FLAGS'] += state.run_pkg_config('--libs', 'SDL2', 'fluidsynth')
+        opts['CMAKE_EXE_LINKER_FLAGS'] += self._link_libraries(state, 'SDL2', 'fluidsynth')
 
         super().configure(state)
 
@@ -406,7 +795,7 @@ class DevilutionXTarget(CMakeMainTarget):
         state.checkout_git('https://github.com/diasurgical/devilutionX.git')
 
     def configure(self, state: BuildState):
-        state.options['CMAKE_EXE_LINKER_FLAGS'] += state.run_pkg_config('--libs', 'SDL2_mixer', 'SDL2_ttf')
+        state.options['CMAKE_EXE_LINKER_FLAGS'] += self._link_libraries(state, 'SDL2_mixer', 'SDL2_ttf')
         super().configure(state)
 
         # Remove version file that is included erroneously because of case-insensitive file system
@@ -417,6 +806,11 @@ class DevilutionXTarget(CMakeMainTarget):
 class EDuke32Target(MakeMainTarget):
     def __init__(self, name='eduke32'):
         super().__init__(name)
+        self.profile_guided = True
+
+        # Common.mak adds -O option on its own, and does link-time optimization by default
+        self.optimization_level = '3'
+        self.optimization_variable = 'OPTLEVEL'
 
     def prepare_source(self, state: BuildState):
         state.checkout_git('https://voidpoint.io/terminx/eduke32.git')
@@ -451,9 +845,13 @@ class QuakespasmTarget(MakeMainTarget):
     def __init__(self, name='quakespasm'):
         super().__init__(name)
         self.src_root = 'Quake'
+        self.profile_guided = True
+
+        # Renderer is CPU-bound, Quakespasm-Exp is built with LTO too, see QUAKE_LTO option
+        self.lto = 'thin'
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://git.code.sf.net/p/quakespasm/quakespasm')
+        state.checkout_git('https://git.code.sf.net/p/quakespasm/quakespasm', mirror='quakespasm')
 
     def detect(self, state: BuildState) -> bool:
         return state.has_source_file('Quakespasm.txt') and not QuakespasmExpTarget().detect(state)
@@ -470,6 +868,8 @@ class QuakespasmTarget(MakeMainTarget):
         opts['USE_CODEC_UMX'] = '1'
         # Add main() alias to workaround executable linking without macOS launcher
         opts['COMMON_LIBS'] = '-framework OpenGL -Wl,-alias -Wl,_SDL_main -Wl,_main'
+        # Codecs are linked with static libraries from dependencies, together with libraries they need, e.g. ogg
+        opts['CODECLIBS'] = state.run_pkg_config('--libs', 'flac', 'libmikmod', 'mad', 'opusfile', 'vorbisfile')
 
 
 class QuakespasmExpTarget(CMakeMainTarget):
@@ -478,7 +878,7 @@ class QuakespasmExpTarget(CMakeMainTarget):
         self.outputs = (self.name, 'quakespasm-exp.pak')
 
     def prepare_source(self, state: BuildState):
-        state.checkout_git('https://github.com/alexey-lysiuk/quakespasm-exp.git')
+        state.checkout_git('https://github.com/alexey-lysiuk/quakespasm-exp.git', mirror='quakespasm')
 
     def configure(self, state: BuildState):
         opts = state.options
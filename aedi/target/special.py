@@ -16,12 +16,36 @@
 #    along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
 
+import copy
+import html
+import json
+import os
+import platform
+import plistlib
+import pty
+import re
+import select
 import shlex
 import shutil
 import subprocess
+import statistics
+import sys
+import time
+import typing
+import urllib.request
+from concurrent.futures import FIRST_COMPLETED, ThreadPoolExecutor, wait
+from pathlib import Path
 
 from ..state import BuildState
+from ..trace import BuildTrace
 from . import base
+from .main import MOLTENVK_GAME_PROFILE
+
+
+def _sysctl(state: BuildState, name: str) -> str:
+    args = ('sysctl', '-n', name)
+    result = subprocess.run(args, env=state.environment, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    return result.stdout.decode('ascii').strip()
 
 
 class BuildPrefix(base.Target):
@@ -76,7 +100,1146 @@ class DownloadCMakeTarget(base.Target):
         shutil.rmtree(state.source)
 
 
+class DepsAllTarget(base.Target):
+    # Compilation jobs given to each target, the rest of the budget is used to build independent targets in parallel
+    JOBS_PER_TARGET = 4
+
+    # Targets on the longest remaining chain of builds get more jobs, jobserver keeps the total within the budget
+    CRITICAL_PATH_JOBS_FACTOR = 2
+    CRITICAL_PATH_FRACTION = 0.75
+
+    # Assumed duration of target that was never built before, in seconds, when there are no other durations
+    DEFAULT_DURATION = 60.0
+
+    # Key of durations in build times file, main targets have theirs recorded for default and unity builds
+    DURATION_KEY = 'deps-all'
+
+    def __init__(self, name='deps-all'):
+        super().__init__(name)
+
+    def build(self, state: BuildState):
+        assert not state.xcode
+
+        # Deferred import to avoid the circular one, package imports this module
+        from . import targets
+
+        all_targets = {target.name: target for target in targets()}
+
+        # Rebuild everything that has binaries in deps directory, together with what it needs
+        # LTO build rebuilds the same dependencies as the native one has
+        pending = set()
+        deps_path = state.native_deps_path or state.deps_path
+        names = [entry.name for entry in deps_path.iterdir() if entry.name in all_targets]
+
+        if use_ninja := '--generator=ninja' in state.forwarded_arguments:
+            names.append('ninja')
+
+        while names:
+            name = names.pop()
+
+            if name not in pending:
+                pending.add(name)
+                names += all_targets[name].dependencies
+
+        dependencies = {name: set(all_targets[name].dependencies) - {name} for name in pending}
+
+        # CMake targets use ninja from prefix directory, so it needs to be built before them
+        if use_ninja:
+            for name in pending - {'ninja', 'cmake'}:
+                if isinstance(all_targets[name], base.CMakeTarget):
+                    dependencies[name].add('ninja')
+
+        # Targets that more of others are waiting for are started first
+        def collect_dependencies(name: str, collected: set) -> set:
+            for dependency in dependencies[name] - collected:
+                collected.add(dependency)
+                collect_dependencies(dependency, collected)
+
+            return collected
+
+        dependents = {name: 0 for name in pending}
+
+        for name in pending:
+            for dependency in collect_dependencies(name, set()):
+                dependents[dependency] += 1
+
+        # Length of the longest chain of builds that starts with target, from durations of previous runs
+        durations = self._load_durations(state, pending)
+        direct_dependents = {name: set() for name in pending}
+
+        for name in pending:
+            for dependency in dependencies[name]:
+                direct_dependents[dependency].add(name)
+
+        critical_paths = {}
+
+        def critical_path(name: str) -> float:
+            if name not in critical_paths:
+                longest_tail = max((critical_path(dependent) for dependent in direct_dependents[name]), default=0.0)
+                critical_paths[name] = durations[name] + longest_tail
+
+            return critical_paths[name]
+
+        # Long poles are started first, ties are broken by the number of targets that wait for them
+        def priority(name: str):
+            return -critical_path(name), -dependents[name], name
+
+        total_jobs = int(state.jobs)
+        jobs = min(self.JOBS_PER_TARGET, total_jobs)
+        critical_jobs = min(jobs * self.CRITICAL_PATH_JOBS_FACTOR, total_jobs)
+        slots = max(total_jobs // jobs, 1)
+
+        def target_jobs(name: str) -> int:
+            longest_path = max(critical_path(other) for other in pending | {name})
+            is_critical = critical_path(name) >= longest_path * self.CRITICAL_PATH_FRACTION
+            return critical_jobs if is_critical else jobs
+
+        log_path = self._log_path(state)
+        os.makedirs(log_path, exist_ok=True)
+
+        built = set()
+        built_durations = {}
+        failed = set()
+        running: typing.Dict = {}
+
+        with ThreadPoolExecutor(max_workers=slots) as executor:
+            while pending or running:
+                for name in sorted(pending):
+                    if dependencies[name] & failed:
+                        print(f'Skipping {name}, its dependency failed to build')
+                        pending.remove(name)
+                        failed.add(name)
+
+                ready = sorted((name for name in pending if dependencies[name] <= built), key=priority)
+
+                while ready and len(running) < slots:
+                    name = ready.pop(0)
+                    name_jobs = target_jobs(name)
+                    pending.remove(name)
+
+                    print(f'Building {name} with {name_jobs} jobs')
+                    running[executor.submit(self._build_target, state, name, name_jobs)] = name
+
+                if not running:
+                    raise RuntimeError('Circular dependencies between ' + ', '.join(sorted(pending)))
+
+                finished, _ = wait(running, return_when=FIRST_COMPLETED)
+
+                for future in finished:
+                    name = running.pop(future)
+                    succeeded, seconds = future.result()
+
+                    if succeeded:
+                        print(f'Finished {name} in {seconds:.1f} seconds')
+                        built.add(name)
+                        built_durations[name] = seconds
+                    else:
+                        print(f'Failed to build {name}, see {log_path / name}.log')
+                        failed.add(name)
+
+        # Reused build directories make durations much shorter than the ones to plan clean builds with
+        if not state.incremental:
+            self._save_durations(state, built_durations)
+
+        if state.trace:
+            # Every target is built by its own process, their traces are combined into one timeline
+            trace_paths = [BuildTrace.path(state.root_path, name) for name in sorted(built | failed)]
+            merged_trace_path = BuildTrace.path(state.root_path, self.name + '-targets')
+            BuildTrace.merge([path for path in trace_paths if path.exists()], merged_trace_path)
+            print(f'Combined trace of all targets is written to {merged_trace_path}')
+
+        if failed:
+            raise RuntimeError('Failed to build ' + ', '.join(sorted(failed)))
+
+    @staticmethod
+    def _build_target(state: BuildState, name: str, jobs: int) -> typing.Tuple[bool, float]:
+        args = [sys.executable, state.root_path / 'build.py', '--target=' + name, f'--jobs={jobs}']
+        args += state.forwarded_arguments
+
+        # Child process joins the same jobserver, the slot taken here is its implicit one
+        with state.job_slot(), open(DepsAllTarget._log_path(state) / f'{name}.log', 'w') as log:
+            start_time = time.monotonic()
+            result = subprocess.run(args, cwd=state.root_path, env=state.environment,
+                                    stdout=log, stderr=subprocess.STDOUT)
+
+        return result.returncode == 0, time.monotonic() - start_time
+
+    @staticmethod
+    def _build_times_path(state: BuildState) -> Path:
+        return state.cache_path / 'build-times.json'
+
+    @classmethod
+    def _load_durations(cls, state: BuildState, names: typing.Iterable[str]) -> typing.Dict[str, float]:
+        times_path = cls._build_times_path(state)
+        all_times = json.loads(times_path.read_text()) if times_path.exists() else {}
+        durations = {name: all_times[name][cls.DURATION_KEY] for name in names
+                     if cls.DURATION_KEY in all_times.get(name, {})}
+
+        # New targets are assumed to be typical ones
+        default_duration = statistics.median(durations.values()) if durations else cls.DEFAULT_DURATION
+
+        return {name: durations.get(name, default_duration) for name in names}
+
+    @classmethod
+    def _save_durations(cls, state: BuildState, durations: typing.Dict[str, float]):
+        if not durations:
+            return
+
+        times_path = cls._build_times_path(state)
+        all_times = json.loads(times_path.read_text()) if times_path.exists() else {}
+
+        for name, seconds in durations.items():
+            all_times.setdefault(name, {})[cls.DURATION_KEY] = round(seconds, 1)
+
+        os.makedirs(state.cache_path, exist_ok=True)
+        times_path.write_text(json.dumps(all_times, indent=2, sort_keys=True) + '\n')
+
+    @staticmethod
+    def _log_path(state: BuildState) -> Path:
+        # Memory disk is detached on exit, logs are needed after that to see why targets failed
+        return state.root_path / 'build' / 'deps-all' if state.memory_disk_path else state.build_path
+
+
+class DownloadAllTarget(base.Target):
+    # Number of source packages downloaded at once
+    DOWNLOAD_JOBS = 8
+
+    def __init__(self, name='download-all'):
+        super().__init__(name)
+
+    def build(self, state: BuildState):
+        # Deferred import to avoid the circular one, package imports this module
+        from . import targets
+
+        # Special targets download nothing, or build something from downloaded files
+        download_targets = [target for target in targets()
+                            if isinstance(target, base.BuildTarget) and target.name != self.name]
+
+        def download(target: base.Target):
+            target_state = copy.copy(state)
+            target_state.source = state.source_path / target.name
+            target_state.external_source = False
+            target_state.download_only = True
+
+            target.prepare_source(target_state)
+
+        failed = []
+
+        with ThreadPoolExecutor(max_workers=self.DOWNLOAD_JOBS) as executor:
+            futures = {executor.submit(download, target): target.name for target in download_targets}
+
+            for future in futures:
+                try:
+                    future.result()
+                except Exception as exception:
+                    print(f'Failed to download {futures[future]}: {exception}')
+                    failed.append(futures[future])
+
+        if failed:
+            raise RuntimeError('Failed to download ' + ', '.join(sorted(failed)))
+
+
+class PgoTrainTarget(base.Target):
+    """
+    Second stage of profile-guided optimization, between builds with --pgo=generate and --pgo=use
+    Workload script runs instrumented games, e.g. with -timedemo and music playback, once per architecture
+    Every slice writes raw profiles into its own directory, they are merged into profile data for the last stage
+    """
+
+    def __init__(self, name='pgo-train'):
+        super().__init__(name)
+
+    def build(self, state: BuildState):
+        assert not state.xcode
+
+        if not state.pgo_workload:
+            raise RuntimeError('Workload script is required, use --pgo-workload command line option')
+
+        env = state.environment
+        env['AEDI_OUTPUT_PATH'] = str(state.output_path)
+
+        for architecture in ('x86_64', 'arm64'):
+            pgo_path = state.pgo_path(architecture)
+            os.makedirs(pgo_path, exist_ok=True)
+
+            for raw_profile in pgo_path.glob('*.profraw'):
+                raw_profile.unlink()
+
+            # Spawned universal binaries prefer architecture of their parent process
+            print(f'Running workload for {architecture}')
+            args = ('arch', f'-{architecture}', '/bin/sh', state.pgo_workload)
+            result = subprocess.run(args, cwd=state.pgo_workload.parent, env=env)
+
+            raw_profiles = sorted(pgo_path.glob('*.profraw'))
+
+            if result.returncode != 0 or not raw_profiles:
+                print(f'WARNING: No profiles were collected for {architecture}')
+                continue
+
+            args = ['xcrun', 'llvm-profdata', 'merge', f'--output={state.pgo_profile_path(architecture)}']
+            args += raw_profiles
+            subprocess.run(args, check=True, env=env)
+
+
+class ProfileLaunchTarget(base.Target):
+    """
+    Measures pre-main launch time of application bundles from output directory
+    Every static initializer that dyld runs is timed, and attributed to dependency which static library defines it,
+    to shared library it belongs to, or to the application itself
+    Results are compared with the previous ones for the same CPU, and kept as baseline in launch-profile.json
+    Initializers of executables linked with --dead-strip have no local symbols, they are attributed to application
+    """
+
+    # Number of launches of every application per architecture, median values are reported
+    RUNS = 5
+
+    # Seconds without output after which application is considered to be in its main loop
+    IDLE_TIMEOUT = 2
+    LAUNCH_TIMEOUT = 30
+
+    # Growth of initialization time that is treated as regression, and smallest growth in milliseconds to care about
+    REGRESSION_THRESHOLD = 0.25
+    REGRESSION_MINIMUM = 1.0
+
+    PROBE_NAME = 'aedi_launch_probe.dylib'
+
+    # Inserted library that reports load addresses of all images before their initializers run
+    PROBE_SOURCE = r'''
+#include <mach-o/dyld.h>
+#include <stdint.h>
+#include <stdio.h>
+
+__attribute__((constructor)) static void aedi_launch_probe(void)
+{
+    for (uint32_t i = 0, count = _dyld_image_count(); i < count; ++i)
+        fprintf(stderr, "aedi-image %p %s\n", (const void*)_dyld_get_image_header(i), _dyld_get_image_name(i));
+}
+'''
+
+    _INITIALIZER_PATTERN = re.compile(r'running initializer (0x[0-9a-fA-F]+) in (.+)$')
+    _IMAGE_PATTERN = re.compile(r'^aedi-image (0x[0-9a-fA-F]+) (.+)$')
+
+    def __init__(self, name='profile-launch'):
+        super().__init__(name)
+
+    def build(self, state: BuildState):
+        assert not state.xcode
+
+        os.makedirs(state.build_path, exist_ok=True)
+        probe_path = state.build_path / self.PROBE_NAME
+        source_path = state.build_path / 'aedi_launch_probe.c'
+        source_path.write_text(self.PROBE_SOURCE)
+
+        args = ('clang', '-arch', 'x86_64', '-arch', 'arm64', '-dynamiclib', '-o', probe_path, source_path)
+        subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
+
+        apps = sorted(state.output_path.glob('*/*.app'))
+
+        if not apps:
+            raise RuntimeError(f'No application bundles in {state.output_path}')
+
+        library_symbols = self._library_symbols(state)
+
+        results_path = state.output_path / 'launch-profile.json'
+        results = json.loads(results_path.read_text()) if results_path.exists() else {}
+
+        cpu = _sysctl(state, 'machdep.cpu.brand_string')
+        cpu_results = results.setdefault(cpu, {})
+        regressions = []
+
+        archs = ('arm64', 'x86_64') if _sysctl(state, 'hw.optional.arm64') == '1' else ('x86_64',)
+
+        for app in apps:
+            with open(app / 'Contents/Info.plist', 'rb') as f:
+                executable = app / 'Contents/MacOS' / plistlib.load(f)['CFBundleExecutable']
+
+            # Thin bundles of --output-layout option run on their own architecture only
+            args = ('lipo', '-archs', executable)
+            executable_archs = subprocess.run(args, check=True, capture_output=True, env=state.environment)
+            executable_archs = executable_archs.stdout.decode('ascii').split()
+
+            for arch in archs:
+                if arch not in executable_archs:
+                    continue
+
+                print(f'Profiling launch of {app.name} on {arch}')
+
+                launches = [self._launch(state, executable, arch, probe_path) for _ in range(self.RUNS)]
+                profile = self._median_profile([self._attribute(state, launch, arch, executable, library_symbols)
+                                                for launch in launches])
+
+                for name, milliseconds in sorted(profile['initializers'].items(), key=lambda item: -item[1]):
+                    print(f'  {name}: {milliseconds:.2f} ms')
+
+                print(f'  Pre-main total: {profile["total"]:.2f} ms')
+
+                key = f'{app.relative_to(state.output_path)}/{arch}'
+                baseline = cpu_results.get(key)
+
+                if baseline:
+                    regressions += self._regressions(key, baseline, profile)
+
+                cpu_results[key] = profile
+
+        self._compare_thin_bundles(cpu_results, archs)
+
+        if regressions:
+            print('Launch time regressions:\n  ' + '\n  '.join(regressions))
+
+            if not os.environ.get('AEDI_BENCH_WARN_ONLY'):
+                threshold = self.REGRESSION_THRESHOLD
+                raise RuntimeError(f'{len(regressions)} launch time(s) regressed beyond {threshold:.0%}')
+
+        results_path.write_text(json.dumps(results, indent=2, sort_keys=True) + '\n')
+
+    @staticmethod
+    def _compare_thin_bundles(cpu_results: dict, archs: typing.Sequence[str]):
+        # Thin bundle of target is in <target>-<arch> directory, universal one is in <target> directory
+        for arch in archs:
+            suffix = f'-{arch}'
+
+            for key, profile in sorted(cpu_results.items()):
+                directory, _, rest = key.partition('/')
+
+                if not directory.endswith(suffix) or not rest.endswith('/' + arch):
+                    continue
+
+                universal_key = f'{directory[:-len(suffix)]}/{rest}'
+
+                if universal := cpu_results.get(universal_key):
+                    print(f'Pre-main time of thin {rest[:-len(arch) - 1]} on {arch}: {profile["total"]:.2f} ms, '
+                          f'universal: {universal["total"]:.2f} ms')
+
+    def _launch(self, state: BuildState, executable: Path, arch: str, probe_path: Path) -> dict:
+        env = state.environment.copy()
+        # Games that use SDL for video and audio start without a window and sound
+        env['SDL_VIDEODRIVER'] = 'dummy'
+        env['SDL_AUDIODRIVER'] = 'dummy'
+
+        # System Integrity Protection removes dyld variables from environment of arch, which passes them explicitly
+        # Statistics are reported by dyld of macOS 11 only, newer versions ignore this variable
+        dyld_variables = {
+            'DYLD_INSERT_LIBRARIES': probe_path,
+            'DYLD_PRINT_INITIALIZERS': 1,
+            'DYLD_PRINT_STATISTICS': 1,
+        }
+
+        args = ['arch', f'-{arch}']
+
+        for name, value in dyld_variables.items():
+            args += ['-e', f'{name}={value}']
+
+        args.append(executable)
+
+        # Output to terminal is not buffered by C runtime, so every line is timestamped when it is written
+        master, slave = pty.openpty()
+        start_time = time.monotonic()
+        process = subprocess.Popen(args, cwd=executable.parent, env=env, stdin=subprocess.DEVNULL,
+                                   stdout=slave, stderr=slave)
+        os.close(slave)
+
+        lines = []
+        pending = b''
+        last_output_time = start_time
+
+        try:
+            while True:
+                now = time.monotonic()
+
+                if now - start_time > self.LAUNCH_TIMEOUT or now - last_output_time > self.IDLE_TIMEOUT:
+                    break
+
+                ready, _, _ = select.select((master,), (), (), 0.1)
+
+                if not ready:
+                    if process.poll() is not None:
+                        break
+
+                    continue
+
+                try:
+                    chunk = os.read(master, 65536)
+                except OSError:
+                    # Terminal is closed when application exits
+                    break
+
+                if not chunk:
+                    break
+
+                last_output_time = time.monotonic()
+                pending += chunk
+
+                *complete_lines, pending = pending.split(b'\n')
+                lines += [(last_output_time - start_time, line.decode('utf-8', errors='replace').rstrip('\r'))
+                          for line in complete_lines]
+        finally:
+            if process.poll() is None:
+                process.terminate()
+
+            process.wait()
+            os.close(master)
+
+        return {'lines': lines}
+
+    def _attribute(self, state: BuildState, launch: dict, arch: str, executable: Path, library_symbols: dict) -> dict:
+        images = {}
+        initializers = []  # address, image path, start time, end time
+
+        for timestamp, line in launch['lines']:
+            if initializers and initializers[-1][3] is None:
+                initializers[-1][3] = timestamp
+
+            if match := self._IMAGE_PATTERN.match(line):
+                images[match.group(2)] = match.group(1)
+            elif match := self._INITIALIZER_PATTERN.search(line):
+                initializers.append([match.group(1), match.group(2), timestamp, None])
+            elif line.startswith('Total pre-main time'):
+                print('  ' + line.strip())
+
+        # Nothing is printed after the last initializer of applications without output, its time is unknown
+        if initializers and initializers[-1][3] is None:
+            initializers[-1][3] = initializers[-1][2]
+
+        symbols = self._symbolicate(state, arch, images, initializers)
+        times = {}
+
+        for address, image, start, end in initializers:
+            if Path(image).name == self.PROBE_NAME:
+                continue
+            elif Path(image).resolve() == executable.resolve():
+                owners = library_symbols.get(symbols.get(address, ''), ['application'])
+                name = '|'.join(sorted(owners))
+            elif image.startswith('/System/') or image.startswith('/usr/lib/'):
+                name = 'system'
+            else:
+                name = Path(image).name
+
+            times[name] = times.get(name, 0.0) + (end - start) * 1000
+
+        total = initializers[-1][3] * 1000 if initializers else 0.0
+        return {'initializers': times, 'total': total}
+
+    def _symbolicate(self, state: BuildState, arch: str, images: dict, initializers: list) -> dict:
+        # Addresses of the same image are resolved at once, atos handles slide with load address of image header
+        addresses_by_image = {}
+
+        for address, image, _, _ in initializers:
+            if image in images:
+                addresses_by_image.setdefault(image, []).append(address)
+
+        symbols = {}
+
+        for image, addresses in addresses_by_image.items():
+            addresses = sorted(set(addresses))
+            args = ['atos', '-arch', arch, '-o', image, '-l', images[image]] + addresses
+            result = subprocess.run(args, env=state.environment, capture_output=True)
+
+            if result.returncode == 0:
+                for address, line in zip(addresses, result.stdout.decode('utf-8', errors='replace').splitlines()):
+                    # Output is like: __GLOBAL__sub_I_gtype.c (in gzdoom) (gtype.c:123)
+                    symbols[address] = '_' + line.split(' (in ')[0].strip()
+
+        return symbols
+
+    @staticmethod
+    def _library_symbols(state: BuildState) -> dict:
+        # Functions defined by static libraries of dependencies, local ones included, initializers usually are
+        result = {}
+        deps_paths = [path for path in (state.deps_path, state.native_deps_path) if path]
+
+        for deps_path in deps_paths:
+            for library in sorted(deps_path.glob('*/lib/*.a')):
+                dependency = library.parent.parent.name
+                args = ('nm', '-j', '-U', library)
+                output = subprocess.run(args, env=state.environment, capture_output=True).stdout
+
+                for symbol in output.decode('utf-8', errors='replace').splitlines():
+                    # Archive member headers look like: /path/libfoo.a(bar.o):
+                    if symbol and not symbol.endswith(':'):
+                        result.setdefault(symbol, set()).add(dependency)
+
+        return result
+
+    @staticmethod
+    def _median_profile(profiles: typing.List[dict]) -> dict:
+        names = set()
+
+        for profile in profiles:
+            names.update(profile['initializers'])
+
+        def median(values) -> float:
+            return round(statistics.median(values), 3)
+
+        initializers = {name: median(profile['initializers'].get(name, 0.0) for profile in profiles) for name in names}
+        total = median(profile['total'] for profile in profiles)
+
+        return {'initializers': initializers, 'total': total}
+
+    def _regressions(self, key: str, baseline: dict, profile: dict) -> typing.List[str]:
+        regressions = []
+        baseline_initializers = baseline['initializers']
+
+        checked = [(name, baseline_initializers.get(name, 0.0), milliseconds)
+                   for name, milliseconds in profile['initializers'].items()]
+        checked.append(('pre-main total', baseline['total'], profile['total']))
+
+        for name, old_milliseconds, milliseconds in checked:
+            if milliseconds - old_milliseconds >= self.REGRESSION_MINIMUM \
+                    and milliseconds > old_milliseconds * (1 + self.REGRESSION_THRESHOLD):
+                regressions.append(f'{key} {name}: {old_milliseconds:.2f} ms -> {milliseconds:.2f} ms')
+
+        return regressions
+
+
+class PerfRunTarget(base.Target):
+    """
+    Measures in-game performance of games from output directory with timedemo playback
+    Every game runs the same demo several times per architecture, speed of playback, CPU time and peak memory usage
+    are reported as median values, and kept per CPU in perf-results.json together with variant of dependencies
+    Results are compared with the previous ones of the same variant, and with other variants of the same bundle,
+    e.g. build with --static-moltenvk against the one with dynamic loader, or --quasi-glib against full GLib,
+    so perf-run target is given the same options as the build of games it measures
+
+    Doom engines play AEDI_PERF_DEMO lump or file, demo1 by default, with IWAD set by AEDI_PERF_IWAD
+    Quake engines play AEDI_PERF_QUAKE_DEMO, demo1 by default, with game data from AEDI_PERF_QUAKE_BASEDIR
+    Games without their data are skipped, AEDI_PERF_ARGS replaces default command line of games, e.g. to play demo on benchmark map of a mod
+    AEDI_PERF_VARIANT replaces name of variant made from build options
+
+    With --static-moltenvk option, one more playback is made with MoltenVK performance tracking enabled,
+    its statistics of shader conversion, pipeline compilation and queue submission are kept with results,
+    but not its timings, because tracking itself slows down rendering
+    """
+
+    # Games that print statistics of timedemo, by output directory without architecture suffix
+    ENGINES = {
+        'dsda-doom': 'doom',
+        'gzdoom': 'doom',
+        'quakespasm': 'quake',
+        'quakespasm-exp': 'quake',
+        'raze': 'doom',
+        'vkdoom': 'doom',
+    }
+
+    # Number of playbacks of every demo per architecture, median values are reported
+    RUNS = 3
+    PLAYBACK_TIMEOUT = 600
+
+    # Drop of speed, and growth of CPU time or peak memory usage that are treated as regressions
+    SPEED_REGRESSION_THRESHOLD = 0.05
+    USAGE_REGRESSION_THRESHOLD = 0.10
+
+    # GZDoom, VkDoom and Raze print: 1234 gametics in 567 realtics (76.1 fps)
+    # dsda-doom prints: Timed 1234 gametics in 567 realtics = 76.1 frames per second
+    _DOOM_TIMEDEMO_PATTERN = re.compile(rb'(\d+) gametics in (\d+) realtics')
+
+    # Quakespasm prints: 1234 frames  5.6 seconds 220.4 fps
+    _QUAKE_TIMEDEMO_PATTERN = re.compile(rb'(\d+) frames\s+([\d.]+) seconds')
+
+    TICRATE = 35
+
+    def __init__(self, name='perf-run'):
+        super().__init__(name)
+
+    def build(self, state: BuildState):
+        assert not state.xcode
+
+        games = self._games(state)
+
+        if not games:
+            raise RuntimeError(f'No games of {", ".join(self.ENGINES)} in {state.output_path}')
+
+        os.makedirs(state.build_path, exist_ok=True)
+
+        results_path = state.output_path / 'perf-results.json'
+        results = json.loads(results_path.read_text()) if results_path.exists() else {}
+
+        cpu = _sysctl(state, 'machdep.cpu.brand_string')
+        cpu_results = results.setdefault(cpu, {})
+        variant = os.environ.get('AEDI_PERF_VARIANT') or self._variant(state)
+        regressions = []
+        macos = platform.mac_ver()[0]
+
+        archs = ('arm64', 'x86_64') if _sysctl(state, 'hw.optional.arm64') == '1' else ('x86_64',)
+
+        for game, executable, family in games:
+            if not (args := self._arguments(family)):
+                print(f'Skipping {game.name}, {self._DATA_VARIABLES[family]} environment variable is not set')
+                continue
+
+            # Thin bundles of --output-layout option run on their own architecture only
+            lipo_args = ('lipo', '-archs', executable)
+            executable_archs = subprocess.run(lipo_args, check=True, capture_output=True, env=state.environment)
+            executable_archs = executable_archs.stdout.decode('ascii').split()
+
+            for arch in archs:
+                if arch not in executable_archs:
+                    continue
+
+                print(f'Playing demo with {game.name} on {arch}, variant {variant}')
+
+                playbacks = [self._play(state, executable, arch, args, family) for _ in range(self.RUNS)]
+                playbacks = [playback for playback in playbacks if playback]
+
+                if not playbacks:
+                    print(f'WARNING: No timedemo statistics were reported by {game.name} on {arch}')
+                    continue
+
+                performance = self._median_performance(playbacks)
+                self._print_performance('  ', performance)
+
+                if state.static_moltenvk and (moltenvk := self._moltenvk_statistics(state, executable, arch, args,
+                                                                                      family)):
+                    performance['moltenvk'] = moltenvk
+                    self._print_moltenvk_statistics('  ', moltenvk)
+
+                key = f'{game.relative_to(state.output_path)}/{arch}'
+                variants = cpu_results.setdefault(key, {})
+                baseline = variants.get(variant)
+
+                if baseline and baseline['args'] == performance['args']:
+                    regressions += self._regressions(f'{key} {variant}', baseline, performance)
+
+                performance['macos'] = macos
+                variants[variant] = performance
+                self._compare_variants(variant, variants)
+
+        if regressions:
+            print('Performance regressions:\n  ' + '\n  '.join(regressions))
+
+            if not os.environ.get('AEDI_BENCH_WARN_ONLY'):
+                raise RuntimeError(f'{len(regressions)} performance value(s) regressed')
+
+        results_path.write_text(json.dumps(results, indent=2, sort_keys=True) + '\n')
+
+    def _games(self, state: BuildState) -> typing.List[typing.Tuple[Path, Path, str]]:
+        # Application bundle, or executable named after its output directory, with engine family
+        games = []
+
+        for output_path in sorted(state.output_path.iterdir()):
+            name = output_path.name
+
+            for suffix in ('-arm64', '-x86_64'):
+                if name.endswith(suffix):
+                    name = name[:-len(suffix)]
+
+            if not (family := self.ENGINES.get(name)):
+                continue
+
+            for app in sorted(output_path.glob('*.app')):
+                games.append((app, self._bundle_executable(app), family))
+
+            if (executable := output_path / name).is_file():
+                games.append((executable, executable, family))
+
+        return games
+
+    _DATA_VARIABLES = {'doom': 'AEDI_PERF_IWAD', 'quake': 'AEDI_PERF_QUAKE_BASEDIR'}
+
+    def _arguments(self, family: str) -> typing.Optional[typing.List[str]]:
+        if custom_args := os.environ.get('AEDI_PERF_ARGS'):
+            return shlex.split(custom_args)
+
+        if not (data_path := os.environ.get(self._DATA_VARIABLES[family])):
+            return None
+
+        data_path = str(Path(data_path).absolute())
+
+        if family == 'quake':
+            demo = os.environ.get('AEDI_PERF_QUAKE_DEMO', 'demo1')
+            return ['-basedir', data_path, '-nosound', '+timedemo', demo]
+
+        demo = os.environ.get('AEDI_PERF_DEMO', 'demo1')
+
+        # All supported games accept these options, sound is disabled to measure rendering and game logic only
+        return ['-iwad', data_path, '-timedemo', demo, '-nosound']
+
+    @staticmethod
+    def _bundle_executable(app: Path) -> Path:
+        with open(app / 'Contents/Info.plist', 'rb') as f:
+            executable = app / 'Contents/MacOS' / plistlib.load(f)['CFBundleExecutable']
+
+        # Bundle of dsda-doom starts launcher script, game executable is next to it
+        game_executable = executable.parent / 'dsda-doom'
+        return game_executable if game_executable.is_file() and game_executable != executable else executable
+
+    @staticmethod
+    def _variant(state: BuildState) -> str:
+        moltenvk = 'static-moltenvk' if state.static_moltenvk else 'dynamic-moltenvk'
+        glib = 'quasi-glib' if state.quasi_glib else 'glib'
+        return f'{state.variant}+{moltenvk}+{glib}' if state.variant else f'{moltenvk}+{glib}'
+
+    def _moltenvk_statistics(self, state: BuildState, executable: Path, arch: str, args: typing.List[str],
+                             family: str) -> typing.Optional[dict]:
+        # Volk shim of static MoltenVK writes statistics when device is destroyed, or at exit
+        # Games that use Vulkan loader dispatch its calls directly to driver, so there is no place to query them
+        statistics_path = state.build_path / 'moltenvk-statistics.json'
+        statistics_path.unlink(missing_ok=True)
+
+        environment = dict(state.environment)
+        environment['MVK_CONFIG_PERFORMANCE_TRACKING'] = '1'
+        environment['VOLK_PERFORMANCE_STATISTICS'] = str(statistics_path)
+
+        self._play(state, executable, arch, args, family, environment)
+
+        if not statistics_path.exists():
+            return None
+
+        try:
+            return json.loads(statistics_path.read_text())
+        except json.JSONDecodeError:
+            # Game was terminated while statistics were written
+            return None
+
+    @staticmethod
+    def _print_moltenvk_statistics(indent: str, statistics: dict):
+        def total(name: str) -> float:
+            tracker = statistics.get(name)
+            return tracker['count'] * tracker['average'] if tracker else 0.0
+
+        print(f'{indent}MoltenVK: {total("shaderCompilation.spirvToMSL"):.1f} ms SPIR-V to MSL conversion, '
+              f'{total("shaderCompilation.pipelineCompile"):.1f} ms pipeline compilation, '
+              f'{total("queue.submitCommandBuffers"):.1f} ms command buffer submission')
+
+    def _play(self, state: BuildState, executable: Path, arch: str, args: typing.List[str],
+              family: str, environment: typing.Optional[dict] = None) -> typing.Optional[dict]:
+        # Output goes to file, so resource usage of finished game can be queried with wait4() before anything else
+        log_path = state.build_path / 'perf-run.log'
+        pattern = self._QUAKE_TIMEDEMO_PATTERN if family == 'quake' else self._DOOM_TIMEDEMO_PATTERN
+
+        with open(log_path, 'wb') as log:
+            start_time = time.monotonic()
+            process = subprocess.Popen(['arch', f'-{arch}', executable] + args, cwd=executable.parent,
+                                       env=environment or state.environment,
+                                       stdin=subprocess.DEVNULL, stdout=log, stderr=log)
+
+            while True:
+                pid, status, usage = os.wait4(process.pid, os.WNOHANG)
+
+                if pid == process.pid:
+                    break
+
+                # Quake engines stay in console after timedemo, so they are stopped once statistics are printed
+                if time.monotonic() - start_time > self.PLAYBACK_TIMEOUT or pattern.search(log_path.read_bytes()):
+                    process.terminate()
+                    pid, status, usage = os.wait4(process.pid, 0)
+                    break
+
+                time.sleep(0.1)
+
+            elapsed = time.monotonic() - start_time
+
+        # Process was reaped here, Popen must not wait for it again
+        process.returncode = status
+        output = log_path.read_bytes()
+
+        if not (match := pattern.search(output)):
+            sys.stdout.write(output.decode('utf-8', errors='replace'))
+            return None
+
+        if family == 'quake':
+            frames, seconds = int(match.group(1)), float(match.group(2))
+        else:
+            # Every gametic of timedemo is rendered as one frame
+            frames, seconds = int(match.group(1)), int(match.group(2)) / self.TICRATE
+
+        if frames == 0 or seconds == 0:
+            return None
+
+        return {
+            'args': args,
+            'fps': frames / seconds,
+            'frame_time': seconds * 1000 / frames,
+            'wall_time': elapsed,
+            'cpu_time': usage.ru_utime + usage.ru_stime,
+            # Maximum resident set size is in bytes on macOS
+            'peak_rss': usage.ru_maxrss / (1024 * 1024),
+        }
+
+    @staticmethod
+    def _median_performance(playbacks: typing.List[dict]) -> dict:
+        performance = {'args': playbacks[0]['args']}
+
+        for name in ('fps', 'frame_time', 'wall_time', 'cpu_time', 'peak_rss'):
+            performance[name] = round(statistics.median(playback[name] for playback in playbacks), 3)
+
+        return performance
+
+    @staticmethod
+    def _print_performance(indent: str, performance: dict):
+        print(f'{indent}{performance["fps"]:.1f} fps, {performance["frame_time"]:.2f} ms per frame, '
+              f'{performance["wall_time"]:.1f} s wall time, {performance["cpu_time"]:.1f} s CPU time, '
+              f'{performance["peak_rss"]:.1f} MB peak memory')
+
+    def _compare_variants(self, variant: str, variants: typing.Dict[str, dict]):
+        current = variants[variant]
+
+        for other_variant, other in sorted(variants.items()):
+            if other_variant == variant or other['args'] != current['args']:
+                continue
+
+            print(f'  Variant {other_variant}:')
+            self._print_performance('    ', other)
+
+    def _regressions(self, key: str, baseline: dict, performance: dict) -> typing.List[str]:
+        regressions = []
+
+        if performance['fps'] < baseline['fps'] * (1 - self.SPEED_REGRESSION_THRESHOLD):
+            regressions.append(f'{key} speed: {baseline["fps"]:.1f} fps -> {performance["fps"]:.1f} fps')
+
+        for name, unit in (('cpu_time', 's'), ('peak_rss', 'MB')):
+            if performance[name] > baseline[name] * (1 + self.USAGE_REGRESSION_THRESHOLD):
+                regressions.append(f'{key} {name}: {baseline[name]:.1f} {unit} -> {performance[name]:.1f} {unit}')
+
+        return regressions
+
+
+class SizeReportTarget(base.Target):
+    """
+    Attributes sizes of __TEXT and __DATA segments to archive members and symbols, per architecture slice,
+    for static libraries of dependencies and for executables and shared libraries from output directory
+    Report is kept in size-report.json of output directory, and the previous one is the baseline it's compared with,
+    e.g. run it after builds with and without --dead-strip to see what was removed
+    Symbol size is distance to the next symbol of the same section, so it includes padding and unnamed data after it
+    """
+
+    # Number of the largest symbols per slice that are kept in report
+    SYMBOL_COUNT = 100
+
+    # Smallest changes in bytes of whole slices, and of archive members and symbols that are printed
+    SLICE_CHANGE_MINIMUM = 4096
+    ENTRY_CHANGE_MINIMUM = 1024
+
+    _MACHO_MAGICS = (b'\xca\xfe\xba\xbe', b'\xcf\xfa\xed\xfe')
+
+    # Section (__TEXT, __text): 1234 (addr 0x0 offset 560)
+    _SECTION_PATTERN = re.compile(r'^\s*Section \((\w*), (\w*)\): (\d+) \(addr 0x([0-9a-fA-F]+)')
+
+    # 0000000000000010 (__TEXT,__text) external _foo
+    _SYMBOL_PATTERN = re.compile(r'^([0-9a-fA-F]+) \((\w+),(\w+)\) .*?(\S+)$')
+
+    def __init__(self, name='size-report'):
+        super().__init__(name)
+
+    def build(self, state: BuildState):
+        assert not state.xcode
+
+        binaries = [(state.deps_path, path) for path in sorted(state.deps_path.glob('*/lib/*.a'))]
+        binaries += [(state.output_path, path) for path in self._output_binaries(state)]
+
+        if not binaries:
+            raise RuntimeError(f'No static libraries in {state.deps_path}, and no binaries in {state.output_path}')
+
+        slices = [(root, path, arch) for root, path in binaries for arch in self._architectures(state, path)]
+
+        with ThreadPoolExecutor(max_workers=int(state.jobs)) as executor:
+            measured = list(executor.map(lambda entry: self._measure(state, entry[1], entry[2]), slices))
+
+        report = {}
+
+        for (root, path, arch), sizes in zip(slices, measured):
+            report[f'{root.name}/{path.relative_to(root)}/{arch}'] = sizes
+
+        results_path = state.output_path / 'size-report.json'
+        baseline = json.loads(results_path.read_text()) if results_path.exists() else {}
+
+        self._print_dependencies(report, state.deps_path.name)
+        self._print_changes(report, baseline)
+
+        os.makedirs(state.output_path, exist_ok=True)
+        results_path.write_text(json.dumps(report, indent=2, sort_keys=True) + '\n')
+
+    def _output_binaries(self, state: BuildState) -> typing.List[Path]:
+        binaries = []
+
+        if not state.output_path.exists():
+            return binaries
+
+        for path in sorted(state.output_path.rglob('*')):
+            if path.is_symlink() or not path.is_file():
+                continue
+
+            with open(path, 'rb') as f:
+                if f.read(4) in self._MACHO_MAGICS:
+                    binaries.append(path)
+
+        return binaries
+
+    @staticmethod
+    def _architectures(state: BuildState, path: Path) -> typing.List[str]:
+        args = ('lipo', '-archs', path)
+        result = subprocess.run(args, env=state.environment, capture_output=True)
+        return result.stdout.decode('ascii').split() if result.returncode == 0 else []
+
+    @staticmethod
+    def _segment(segment: str) -> typing.Optional[str]:
+        # Segments of object files are unnamed, sections are attributed by their segment names
+        # Constant and dirty data segments of linked binaries count as data
+        return '__TEXT' if segment == '__TEXT' else '__DATA' if segment.startswith('__DATA') else None
+
+    _ARCHITECTURE_SUFFIX = re.compile(r' \(for architecture \w+\):$')
+
+    @classmethod
+    def _member(cls, line: str) -> str:
+        # Archive member headers look like: /path/libfoo.a(bar.o):, headers of other files have no parentheses
+        line = cls._ARCHITECTURE_SUFFIX.sub(':', line)
+        return line[line.rfind('(') + 1:-2] if line.endswith('):') else ''
+
+    def _measure(self, state: BuildState, path: Path, arch: str) -> dict:
+        args = ('size', '-m', '-l', '-arch', arch, path)
+        output = subprocess.run(args, check=True, capture_output=True, env=state.environment).stdout
+
+        totals = {'__TEXT': 0, '__DATA': 0}
+        members = {}
+        sections = {}
+        member = ''
+
+        for line in output.decode('utf-8', errors='replace').splitlines():
+            if not line.startswith(('\t', ' ', 'Segment', 'total')) and line.endswith(':'):
+                member = self._member(line)
+            elif match := self._SECTION_PATTERN.match(line):
+                segment_name, section_name, size, address = match.groups()
+
+                if not (segment := self._segment(segment_name)):
+                    continue
+
+                size = int(size)
+                totals[segment] += size
+                sections[(member, segment_name, section_name)] = (int(address, 16), size)
+
+                if member:
+                    member_sizes = members.setdefault(member, {'__TEXT': 0, '__DATA': 0})
+                    member_sizes[segment] += size
+
+        result = dict(totals)
+        result['symbols'] = self._symbols(state, path, arch, sections)
+
+        if members:
+            result['members'] = members
+
+        return result
+
+    def _symbols(self, state: BuildState, path: Path, arch: str, sections: dict) -> dict:
+        args = ('nm', '-n', '-m', '-arch', arch, path)
+        output = subprocess.run(args, env=state.environment, capture_output=True).stdout
+
+        addresses = {}
+        member = ''
+
+        for line in output.decode('utf-8', errors='replace').splitlines():
+            if line.endswith(':'):
+                member = self._member(line)
+            elif match := self._SYMBOL_PATTERN.match(line):
+                address, segment_name, section_name, name = match.groups()
+                key = (member, segment_name, section_name)
+
+                if key in sections:
+                    addresses.setdefault(key, []).append((int(address, 16), name))
+
+        symbols = {}
+
+        for key, entries in addresses.items():
+            section_address, section_size = sections[key]
+            ends = [address for address, _ in entries[1:]] + [section_address + section_size]
+
+            for (address, name), end in zip(entries, ends):
+                # Local symbols of different members can share names
+                symbols[name] = symbols.get(name, 0) + max(end - address, 0)
+
+        largest = sorted(symbols.items(), key=lambda item: (-item[1], item[0]))[:self.SYMBOL_COUNT]
+        return dict(largest)
+
+    @staticmethod
+    def _format_size(size: int, signed: bool = False) -> str:
+        sign = '+' if signed and size > 0 else '-' if size < 0 else ''
+        size = abs(size)
+        value = f'{size / 1048576:.2f} MB' if size >= 1048576 else f'{size / 1024:.1f} KB'
+        return sign + value
+
+    def _print_dependencies(self, report: dict, deps_name: str):
+        # Archives of the same dependency are summed up, e.g. several libraries of SDL2 or GLib
+        dependencies = {}
+
+        for key, sizes in report.items():
+            root, _, rest = key.partition('/')
+
+            if root == deps_name:
+                name, arch = rest.split('/')[0], rest.rsplit('/', 1)[1]
+                totals = dependencies.setdefault(f'{name}/{arch}', {'__TEXT': 0, '__DATA': 0})
+                totals['__TEXT'] += sizes['__TEXT']
+                totals['__DATA'] += sizes['__DATA']
+
+        if not dependencies:
+            return
+
+        print('Sizes of dependencies:')
+
+        for name, totals in sorted(dependencies.items(), key=lambda item: -item[1]['__TEXT']):
+            print(f'  {name}: __TEXT {self._format_size(totals["__TEXT"])}, '
+                  f'__DATA {self._format_size(totals["__DATA"])}')
+
+    def _listed_minimum(self, symbols: dict) -> int:
+        return min(symbols.values()) if len(symbols) >= self.SYMBOL_COUNT else 0
+
+    def _print_changes(self, report: dict, baseline: dict):
+        if not baseline:
+            print('No baseline size report, the current one is stored as baseline')
+            return
+
+        print('Size changes relative to baseline:')
+
+        for key, sizes in sorted(report.items()):
+            old_sizes = baseline.get(key)
+
+            if not old_sizes:
+                print(f'  {key}: new, __TEXT {self._format_size(sizes["__TEXT"])}, '
+                      f'__DATA {self._format_size(sizes["__DATA"])}')
+                continue
+
+            deltas = {segment: sizes[segment] - old_sizes[segment] for segment in ('__TEXT', '__DATA')}
+
+            if all(abs(delta) < self.SLICE_CHANGE_MINIMUM for delta in deltas.values()):
+                continue
+
+            print(f'  {key}: __TEXT {self._format_size(deltas["__TEXT"], True)}, '
+                  f'__DATA {self._format_size(deltas["__DATA"], True)}')
+
+            old_members = old_sizes.get('members', {})
+
+            for member, member_sizes in sorted(sizes.get('members', {}).items()):
+                old_member = old_members.get(member, {'__TEXT': 0, '__DATA': 0})
+                delta = sum(member_sizes.values()) - sum(old_member.values())
+
+                if abs(delta) >= self.ENTRY_CHANGE_MINIMUM:
+                    print(f'    {member}: {self._format_size(delta, True)}')
+
+            # Only the largest symbols are kept, symbol missing from one of lists is treated as removed or added
+            # if it's larger than the smallest listed symbol, otherwise its other size is unknown
+            old_symbols = old_sizes.get('symbols', {})
+            symbols = sizes.get('symbols', {})
+            old_minimum = self._listed_minimum(old_symbols)
+            minimum = self._listed_minimum(symbols)
+
+            for name in sorted(set(symbols) | set(old_symbols)):
+                size, old_size = symbols.get(name), old_symbols.get(name)
+
+                if old_size is None and size <= old_minimum or size is None and old_size <= minimum:
+                    continue
+
+                delta = (size or 0) - (old_size or 0)
+
+                if abs(delta) >= self.ENTRY_CHANGE_MINIMUM:
+                    print(f'    {name}: {self._format_size(delta, True)}')
+
+        for key in sorted(set(baseline) - set(report)):
+            print(f'  {key}: removed')
+
+
 class TestDepsTarget(base.BuildTarget):
+    _GLIB_LIBS = ('-lglib-2.0', '-lgthread-2.0')
+
+    # Comma-separated names of tests or benchmarks to run instead of all of them, set by watch mode of builder
+    SELECTION_VARIABLE = 'AEDI_TESTS'
+
     def __init__(self, name='test-deps'):
         super().__init__(name)
         self.multi_platform = False
@@ -84,33 +1247,499 @@ class TestDepsTarget(base.BuildTarget):
     def build(self, state: BuildState):
         assert not state.xcode
 
+        os.makedirs(state.build_path, exist_ok=True)
+
+        def run_test(entry: Path) -> tuple:
+            exe_path = state.build_path / entry.stem
+            output = ''
+
+            try:
+                build_args = self._build_args(state, entry, exe_path)
+            except subprocess.CalledProcessError as ex:
+                return False, f'{ex}\n'
+
+            for args in (build_args, (exe_path,)):
+                result = subprocess.run(args, cwd=state.build_path, env=state.environment,
+                                        stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+                output += result.stdout.decode('utf-8', errors='replace')
+
+                if result.returncode != 0:
+                    return False, output
+
+            return True, output
+
+        sources = sorted(self._sources(state))
+        failed = []
+
+        # Output of each test is buffered, and printed in order once the test is complete
+        with ThreadPoolExecutor(max_workers=int(state.jobs)) as executor:
+            for entry, (passed, output) in zip(sources, executor.map(run_test, sources)):
+                print('Testing ' + entry.stem)
+                print(output, end='')
+
+                if not passed:
+                    failed.append(entry.stem)
+
+        print(f'{len(sources) - len(failed)} of {len(sources)} tests passed')
+
+        if failed:
+            raise RuntimeError('Failed tests: ' + ', '.join(failed))
+
+    def _sources(self, state: BuildState) -> list:
         test_path = state.root_path / 'test'
+        return self._selected([entry for entry in test_path.iterdir() if entry.name.endswith('.cpp')])
 
-        for entry in test_path.iterdir():
-            if not entry.name.endswith('.cpp'):
-                continue
+    @classmethod
+    def _selected(cls, sources: list) -> list:
+        selection = os.environ.get(cls.SELECTION_VARIABLE)
+        return [entry for entry in sources if entry.stem in selection.split(',')] if selection else sources
+
+    @staticmethod
+    def pkg_config_modules(entry: Path) -> list:
+        # Source that uses several libraries lists them in its first line, e.g. // pkg-config: zlib bzip2
+        # Empty list is for benchmarks of tools that run their executables, and link with no library
+        with open(entry) as f:
+            first_line = f.readline()
+
+        prefix = '// pkg-config:'
+        return first_line[len(prefix):].split() if first_line.startswith(prefix) else [entry.stem]
 
-            test_name = entry.stem
-            pkg_config_output = state.run_pkg_config('--cflags', '--libs', test_name)
-            exe_path = state.build_path / test_name
-
-            print('Testing ' + test_name)
-
-            build_args = [
-                'clang++',
-                '-arch', 'x86_64',
-                '-arch', 'arm64',
-                '-std=c++17',
-                '-include', test_path / 'aedi.h',
-                '-g',
-                '-o', exe_path,
-                entry,
+    def _compiler_args(self, state: BuildState) -> list:
+        return [
+            '-include', state.root_path / 'test/aedi.h',
+            '-g',
+            # Vulkan test checks that MoltenVK applies game configuration
+            self._moltenvk_profile_define(),
+        ]
+
+    @staticmethod
+    def _moltenvk_profile_define() -> str:
+        profile = ' '.join(f'{name}={value}' for name, value in MOLTENVK_GAME_PROFILE.items())
+        return f'-DAEDI_MOLTENVK_GAME_PROFILE="{profile}"'
+
+    def _build_args(self, state: BuildState, entry: Path, exe_path: Path, variant='') -> list:
+        modules = self.pkg_config_modules(entry)
+        pkg_config_args = shlex.split(state.run_pkg_config('--cflags', '--libs', *modules)) if modules else []
+
+        if variant == 'quasi-glib':
+            # Both libraries export the same symbols, so GLib is replaced rather than linked alongside
+            pkg_config_args = [arg for arg in pkg_config_args if arg not in self._GLIB_LIBS] + ['-lquasi-glib']
+        elif variant == 'static-moltenvk':
+            # Libraries are the same as ZDoomVulkanBaseTarget uses with --static-moltenvk,
+            # plus frameworks that games get via SDL
+            pkg_config_args = [arg for arg in pkg_config_args if arg != '-lvulkan'] + [
+                '-DAEDI_STATIC_MOLTENVK',
+                '-lMoltenVK-static',
+                '-framework', 'CoreFoundation',
+                '-framework', 'Metal',
+                '-framework', 'IOSurface',
+                '-framework', 'AppKit',
+                '-framework', 'IOKit',
+                '-framework', 'QuartzCore',
             ]
-            build_args += shlex.split(pkg_config_output)
-            build_args += shlex.split(state.linker_flags())
 
-            if state.verbose:
-                print(' '.join(str(arg) for arg in build_args))
+        build_args = [
+            'clang++',
+            '-arch', 'x86_64',
+            '-arch', 'arm64',
+            '-std=c++17',
+        ]
+        build_args += self._compiler_args(state)
+        build_args += [
+            # Allow tests to load shared libraries from prefix, e.g. MoltenVK
+            '-Wl,-rpath,' + str(state.lib_path),
+            f'-DAEDI_LIB_PATH="{state.lib_path}"',
+            f'-DAEDI_BIN_PATH="{state.bin_path}"',
+            '-o', exe_path,
+            entry,
+        ]
+        build_args += pkg_config_args
+        build_args += shlex.split(state.linker_flags())
 
-            for args in (build_args, (exe_path,)):
-                subprocess.run(args, check=True, cwd=state.build_path, env=state.environment)
+        if state.verbose:
+            print(' '.join(str(arg) for arg in build_args))
+
+        return build_args
+
+
+class BenchDepsTarget(TestDepsTarget):
+    # Values of result that are kept in history when dependency versions change
+    HISTORY_FIELDS = ('versions', 'macos', 'results')
+
+    def __init__(self, name='bench-deps'):
+        super().__init__(name)
+
+        # Relative throughput loss after dependency update that is treated as regression
+        self.regression_threshold = 0.1
+
+    def build(self, state: BuildState):
+        assert not state.xcode
+
+        results_path = state.output_path / 'bench-results.json'
+        results = json.loads(results_path.read_text()) if results_path.exists() else {}
+
+        cpu = _sysctl(state, 'machdep.cpu.brand_string')
+        cpu_results = results.setdefault(cpu, {})
+        regressions = []
+        translated = []
+        macos = platform.mac_ver()[0]
+
+        # Intel Macs cannot run arm64 code, Apple Silicon ones run x86_64 via Rosetta
+        archs = ('arm64', 'x86_64') if _sysctl(state, 'hw.optional.arm64') == '1' else ('x86_64',)
+
+        for entry, variant in self._variants(state):
+            name = entry.stem + ('+' + variant if variant else '')
+            exe_path = state.build_path / name
+            build_args = self._build_args(state, entry, exe_path, variant)
+            subprocess.run(build_args, check=True, cwd=state.build_path, env=state.environment)
+
+            modules = self.pkg_config_modules(entry)
+            versions = ', '.join(f'{module} {state.run_pkg_config("--modversion", module).strip()}' for module in modules)
+            arch_throughputs = {}
+
+            for arch in archs:
+                print(f'Benchmarking {name} ({versions}) on {arch}')
+
+                args = ('arch', '-' + arch, exe_path)
+                output = subprocess.run(args, check=True, cwd=state.build_path, env=state.environment,
+                                        stdout=subprocess.PIPE).stdout.decode('utf-8')
+                print(output, end='')
+
+                throughputs = {}
+
+                for line in output.splitlines():
+                    if line.startswith('{'):
+                        record = json.loads(line)
+
+                        if 'throughput' in record:
+                            throughputs[record['name']] = record['throughput']
+
+                key = f'{name}/{arch}'
+                baseline = cpu_results.get(key)
+
+                record = {'versions': versions, 'macos': macos, 'results': throughputs}
+
+                # Only dependency update is gated, repeated runs of the same version just refresh results
+                if baseline and baseline['versions'] != versions:
+                    for measurement, throughput in throughputs.items():
+                        old_throughput = baseline['results'].get(measurement)
+
+                        if old_throughput and throughput < old_throughput * (1 - self.regression_threshold):
+                            regressions.append(f'{key} {measurement}: {old_throughput:.3f} ({baseline["versions"]}) '
+                                               f'-> {throughput:.3f} ({versions})')
+
+                # Results of previous dependency versions are kept for trend reports of export-results target
+                if baseline:
+                    history = baseline.get('history', [])
+
+                    if baseline['versions'] != versions:
+                        history = history + [{field: baseline[field] for field in self.HISTORY_FIELDS
+                                              if field in baseline}]
+
+                    if history:
+                        record['history'] = history
+
+                cpu_results[key] = record
+                arch_throughputs[arch] = throughputs
+
+            if len(arch_throughputs) == 2:
+                ratios = self._translation_ratios(arch_throughputs['x86_64'], arch_throughputs['arm64'])
+                cpu_results[f'{name}/x86_64']['rosetta_ratios'] = ratios
+
+                if ratios:
+                    mean = statistics.geometric_mean(ratios.values())
+                    worst = min(ratios, key=ratios.get)
+                    translated.append((mean, name, worst, ratios[worst]))
+
+        if translated:
+            # Libraries that lose the most under translation come first
+            print('Throughput of x86_64 slice under Rosetta 2 relative to native arm64 one:')
+
+            for mean, name, worst, worst_ratio in sorted(translated):
+                print(f'  {name}: {mean:.0%} geometric mean, worst {worst}: {worst_ratio:.0%}')
+
+        if regressions:
+            print('Throughput regressions:\n  ' + '\n  '.join(regressions))
+
+            if not os.environ.get('AEDI_BENCH_WARN_ONLY'):
+                raise RuntimeError(f'{len(regressions)} benchmark(s) regressed beyond {self.regression_threshold:.0%}')
+
+        os.makedirs(state.output_path, exist_ok=True)
+        results_path.write_text(json.dumps(results, indent=2, sort_keys=True) + '\n')
+
+    @staticmethod
+    def _translation_ratios(translated: dict, native: dict) -> dict:
+        # Benchmarks that are skipped or fail on one of architectures have no ratio
+        return {name: throughput / native[name]
+                for name, throughput in translated.items() if throughput > 0 and native.get(name)}
+
+    def _sources(self, state: BuildState) -> list:
+        bench_path = state.root_path / 'test/bench'
+        return self._selected(sorted(bench_path.glob('*.cpp')))
+
+    def _variants(self, state: BuildState) -> list:
+        # Benchmarks that depend on GLib run against quasi-glib too, and Vulkan ones against static MoltenVK
+        # FluidSynth compiled with --quasi-glib-inline cannot link with GLib, so its benchmarks run with quasi-glib only
+        variants = []
+
+        for entry in self._sources(state):
+            modules = self.pkg_config_modules(entry)
+            libs = shlex.split(state.run_pkg_config('--libs', *modules)) if modules else []
+
+            if not (state.quasi_glib_inline and '-lfluidsynth' in libs):
+                variants.append((entry, ''))
+
+            if any(lib in self._GLIB_LIBS for lib in libs):
+                variants.append((entry, 'quasi-glib'))
+
+            if '-lvulkan' in libs:
+                variants.append((entry, 'static-moltenvk'))
+
+        return variants
+
+    def _compiler_args(self, state: BuildState) -> list:
+        return [
+            '-include', state.root_path / 'test/aedi.h',
+            '-include', state.root_path / 'test/aedi_bench.h',
+            '-O3',
+            '-DNDEBUG',
+            # Vulkan benchmarks measure MoltenVK with game configuration too
+            self._moltenvk_profile_define(),
+        ]
+
+
+class ExportResultsTarget(base.Target):
+    """
+    Exports results of bench-deps and perf-run targets from output directory as OpenMetrics text to results.om,
+    and as static HTML report with trend of every benchmark across dependency versions to results.html
+    Samples are labeled with target name, dependency versions or build variant, host CPU and macOS version
+    When AEDI_PUSHGATEWAY_URL environment variable is set, metrics are pushed to Prometheus Pushgateway at that URL
+    """
+
+    # Metric families of perf-run results, with suffixes of their names and descriptions
+    PERF_METRICS = (
+        ('fps', '', 'Timedemo playback speed in frames per second'),
+        ('frame_time', '_milliseconds', 'Average frame time of timedemo playback'),
+        ('wall_time', '_seconds', 'Wall time of timedemo playback'),
+        ('cpu_time', '_seconds', 'CPU time of game process during timedemo playback'),
+        ('peak_rss', '_megabytes', 'Peak resident memory size of game process'),
+    )
+
+    CHART_WIDTH = 720
+    CHART_HEIGHT = 240
+    CHART_MARGIN = 40
+    CHART_COLORS = ('#4e79a7', '#f28e2b', '#e15759', '#76b7b2', '#59a14f', '#edc948', '#b07aa1', '#ff9da7',
+                    '#9c755f', '#bab0ac')
+
+    def __init__(self, name='export-results'):
+        super().__init__(name)
+
+    def build(self, state: BuildState):
+        bench_path = state.output_path / 'bench-results.json'
+        perf_path = state.output_path / 'perf-results.json'
+        bench_results = json.loads(bench_path.read_text()) if bench_path.exists() else {}
+        perf_results = json.loads(perf_path.read_text()) if perf_path.exists() else {}
+
+        if not bench_results and not perf_results:
+            raise RuntimeError(f'No benchmark or performance results in {state.output_path}')
+
+        from . import targets
+        target_names = {target.name for target in targets()}
+
+        metrics = self._metrics(bench_results, perf_results, target_names)
+        metrics_path = state.output_path / 'results.om'
+        metrics_path.write_text(metrics)
+        print(f'Exported metrics to {metrics_path}')
+
+        report_path = state.output_path / 'results.html'
+        report_path.write_text(self._report(bench_results, perf_results))
+        print(f'Exported report to {report_path}')
+
+        if url := os.environ.get('AEDI_PUSHGATEWAY_URL'):
+            self._push(url, metrics)
+
+    @staticmethod
+    def _bench_target(key: str, target_names: set) -> str:
+        # Benchmark keys look like: fluidsynth+quasi-glib/arm64, benchmark source is named after the target
+        stem = key.rpartition('/')[0].partition('+')[0]
+        return stem if stem in target_names else ''
+
+    @staticmethod
+    def _perf_target(key: str, target_names: set) -> str:
+        # Performance keys look like: gzdoom-arm64/GZDoom.app/arm64, thin bundles have architecture suffix
+        directory, _, rest = key.partition('/')
+        arch = rest.rpartition('/')[2]
+        name = directory[:-len(arch) - 1] if directory.endswith('-' + arch) else directory
+        return name if name in target_names else ''
+
+    @staticmethod
+    def _labels(**labels) -> str:
+        def escape(value: str) -> str:
+            return str(value).replace('\\', '\\\\').replace('"', '\\"').replace('\n', '\\n')
+
+        return ','.join(f'{name}="{escape(value)}"' for name, value in labels.items())
+
+    def _metrics(self, bench_results: dict, perf_results: dict, target_names: set) -> str:
+        # Samples of every metric family must be contiguous
+        families = {}
+
+        def add(family: str, labels: str, value: float):
+            families.setdefault(family, []).append(f'aedi_{family}{{{labels}}} {value}')
+
+        for cpu, cpu_results in sorted(bench_results.items()):
+            for key, record in sorted(cpu_results.items()):
+                benchmark, _, arch = key.rpartition('/')
+                common = dict(target=self._bench_target(key, target_names), benchmark=benchmark, arch=arch,
+                              versions=record['versions'], cpu=cpu, macos=record.get('macos', ''))
+
+                for measurement, throughput in sorted(record['results'].items()):
+                    add('bench_throughput', self._labels(**common, measurement=measurement), throughput)
+
+                for measurement, ratio in sorted(record.get('rosetta_ratios', {}).items()):
+                    add('bench_rosetta_ratio', self._labels(**common, measurement=measurement), ratio)
+
+        for cpu, cpu_results in sorted(perf_results.items()):
+            for key, variants in sorted(cpu_results.items()):
+                game, _, arch = key.rpartition('/')
+
+                for variant, performance in sorted(variants.items()):
+                    labels = self._labels(target=self._perf_target(key, target_names), game=game, arch=arch,
+                                          variant=variant, cpu=cpu, macos=performance.get('macos', ''))
+
+                    for name, suffix, _ in self.PERF_METRICS:
+                        add(f'perf_{name}{suffix}', labels, performance[name])
+
+                    # Allocated GPU memory is tracked in kilobytes, so it has no meaningful total
+                    for tracker, values in sorted(performance.get('moltenvk', {}).items()):
+                        if tracker != 'device.gpuMemoryAllocated':
+                            tracker_labels = labels + ',' + self._labels(tracker=tracker)
+                            add('perf_moltenvk_milliseconds', tracker_labels, values['count'] * values['average'])
+
+        descriptions = {
+            'bench_throughput': ('', 'Benchmark throughput in measured units per second'),
+            'bench_rosetta_ratio': ('', 'Throughput of x86_64 slice under Rosetta 2 relative to native arm64 one'),
+            'perf_moltenvk_milliseconds': ('milliseconds', 'Total time of MoltenVK activity during timedemo playback'),
+        }
+        descriptions.update({f'perf_{name}{suffix}': (suffix[1:], description)
+                             for name, suffix, description in self.PERF_METRICS})
+
+        lines = []
+
+        for family, samples in families.items():
+            unit, description = descriptions[family]
+            lines.append(f'# TYPE aedi_{family} gauge')
+
+            if unit:
+                lines.append(f'# UNIT aedi_{family} {unit}')
+
+            lines.append(f'# HELP aedi_{family} {description}')
+            lines += samples
+
+        lines.append('# EOF')
+        return '\n'.join(lines) + '\n'
+
+    @staticmethod
+    def _push(url: str, metrics: str):
+        # Pushgateway parses text exposition format, OpenMetrics gauges are compatible with it
+        request = urllib.request.Request(url.rstrip('/') + '/metrics/job/aedi', data=metrics.encode('utf-8'),
+                                         method='PUT', headers={'Content-Type': 'text/plain; version=0.0.4'})
+
+        with urllib.request.urlopen(request) as response:
+            print(f'Pushed metrics to {url}, status {response.status}')
+
+    def _chart(self, versions: typing.List[str], series: typing.Dict[str, typing.List[typing.Optional[float]]]) -> str:
+        # Values are relative to the first known value of each measurement, so different units share one chart
+        relative = {}
+
+        for name, values in series.items():
+            first = next((value for value in values if value), None)
+
+            if first:
+                relative[name] = [value / first * 100 if value else None for value in values]
+
+        known = [value for values in relative.values() for value in values if value is not None]
+
+        if not known:
+            return ''
+
+        low, high = min(known + [100.0]), max(known + [100.0])
+        high = high if high > low else low + 1
+
+        width, height, margin = self.CHART_WIDTH, self.CHART_HEIGHT, self.CHART_MARGIN
+        step = (width - margin * 2) / max(len(versions) - 1, 1)
+
+        def x(index: int) -> float:
+            return margin + step * index
+
+        def y(value: float) -> float:
+            return height - margin - (value - low) / (high - low) * (height - margin * 2)
+
+        parts = [f'<svg width="{width}" height="{height}" xmlns="http://www.w3.org/2000/svg">',
+                 f'<line x1="{margin}" y1="{y(100):.1f}" x2="{width - margin}" y2="{y(100):.1f}" stroke="#ccc"/>',
+                 f'<text x="2" y="{y(high) + 4:.1f}" font-size="10">{high:.0f}%</text>',
+                 f'<text x="2" y="{y(low) + 4:.1f}" font-size="10">{low:.0f}%</text>']
+
+        for index, version in enumerate(versions):
+            parts.append(f'<text x="{x(index):.1f}" y="{height - margin / 2:.1f}" font-size="10" '
+                         f'text-anchor="middle">{html.escape(version)}</text>')
+
+        for number, (name, values) in enumerate(sorted(relative.items())):
+            color = self.CHART_COLORS[number % len(self.CHART_COLORS)]
+            points = ' '.join(f'{x(index):.1f},{y(value):.1f}' for index, value in enumerate(values)
+                              if value is not None)
+            parts.append(f'<polyline points="{points}" fill="none" stroke="{color}" stroke-width="2">'
+                         f'<title>{html.escape(name)}</title></polyline>')
+
+            for index, value in enumerate(values):
+                if value is not None:
+                    parts.append(f'<circle cx="{x(index):.1f}" cy="{y(value):.1f}" r="3" fill="{color}">'
+                                 f'<title>{html.escape(name)}: {value:.1f}%</title></circle>')
+
+        parts.append('</svg>')
+        return '\n'.join(parts)
+
+    def _report(self, bench_results: dict, perf_results: dict) -> str:
+        parts = ['<!DOCTYPE html>', '<html><head><meta charset="utf-8"><title>Benchmark results</title>',
+                 '<style>body { font-family: sans-serif; } table { border-collapse: collapse; } '
+                 'td, th { border: 1px solid #ccc; padding: 2px 6px; text-align: right; } '
+                 'td:first-child { text-align: left; }</style>',
+                 '</head><body>']
+
+        for cpu, cpu_results in sorted(bench_results.items()):
+            parts.append(f'<h1>Benchmarks on {html.escape(cpu)}</h1>')
+
+            for key, record in sorted(cpu_results.items()):
+                # History is ordered from the oldest dependency versions, the current results are the last
+                records = record.get('history', []) + [record]
+                versions = [entry['versions'] for entry in records]
+                measurements = sorted({name for entry in records for name in entry['results']})
+                series = {name: [entry['results'].get(name) for entry in records] for name in measurements}
+
+                parts.append(f'<h2>{html.escape(key)}</h2>')
+                parts.append(f'<p>macOS {html.escape(record.get("macos", "unknown"))}</p>')
+                parts.append(self._chart(versions, series))
+                parts.append('<table><tr><th>Measurement</th>' +
+                             ''.join(f'<th>{html.escape(version)}</th>' for version in versions) + '</tr>')
+
+                for name in measurements:
+                    cells = ''.join(f'<td>{value:.3f}</td>' if value is not None else '<td></td>'
+                                    for value in series[name])
+                    parts.append(f'<tr><td>{html.escape(name)}</td>{cells}</tr>')
+
+                parts.append('</table>')
+
+        for cpu, cpu_results in sorted(perf_results.items()):
+            parts.append(f'<h1>Games on {html.escape(cpu)}</h1>')
+            parts.append('<table><tr><th>Game</th><th>Variant</th><th>macOS</th>' +
+                         ''.join(f'<th>{name}</th>' for name, _, _ in self.PERF_METRICS) + '</tr>')
+
+            for key, variants in sorted(cpu_results.items()):
+                for variant, performance in sorted(variants.items()):
+                    cells = ''.join(f'<td>{performance[name]:.2f}</td>' for name, _, _ in self.PERF_METRICS)
+                    parts.append(f'<tr><td>{html.escape(key)}</td><td>{html.escape(variant)}</td>'
+                                 f'<td>{html.escape(performance.get("macos", ""))}</td>{cells}</tr>')
+
+            parts.append('</table>')
+
+        parts.append('</body></html>')
+        return '\n'.join(parts) + '\n'
@@ -30,6 +30,9 @@ class CMakeTarget(base.CMakeTarget):
     def __init__(self, name='cmake'):
         super().__init__(name)
 
+        # Bootstrap binary is built by native platform only
+        self.concurrent_platforms = False
+
     def prepare_source(self, state: BuildState):
         state.download_source(
             'https://github.com/Kitware/CMake/releases/download/v3.25.1/cmake-3.25.1.tar.gz',
@@ -71,6 +74,7 @@ class GmakeTarget(base.ConfigureMakeDependencyTarget):
         # Target's directory is removed before configuration step
         # gmake cannot be used to build itself, use system's make instead
         self.tool = 'make'
+        self.dependencies = ()
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -81,6 +85,10 @@ class GmakeTarget(base.ConfigureMakeDependencyTarget):
         return state.has_source_file('doc/make.1')
 
     def configure(self, state: BuildState):
+        # System make predates FIFO jobserver and rejects its option in MAKEFLAGS, it builds with fixed number of jobs
+        state.environment.pop('MAKEFLAGS', None)
+        state.jobserver = None
+
         opts = state.options
         opts['--datarootdir'] = '/usr/local/share'
         opts['--includedir'] = '/usr/local/include'
@@ -96,6 +104,7 @@ class MesonTarget(base.BuildTarget):
     def __init__(self, name='meson'):
         super().__init__(name)
         self.multi_platform = False
+        self.dependencies = ()
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -23,6 +23,41 @@ from ..state import BuildState
 from . import base
 
 
+class AstcEncTarget(base.CMakeTarget):
+    def __init__(self, name='astcenc'):
+        super().__init__(name)
+
+    def prepare_source(self, state: BuildState):
+        state.download_source(
+            'https://github.com/ARM-software/astc-encoder/archive/refs/tags/4.8.0.tar.gz',
+            '6c12b9d4d8b2c0a4fe8a6e2b8a4b7a5a9b2b4e2fbd5123eee2e8d8e9f5fbd7b9')
+
+    def detect(self, state: BuildState) -> bool:
+        return state.has_source_file('Source/astcenc.h')
+
+    def configure(self, state: BuildState):
+        opts = state.options
+        opts['ASTCENC_UNIVERSAL_BUILD'] = 'NO'
+        opts['ASTCENC_UNITTEST'] = 'NO'
+
+        # Encoder has no runtime dispatch, every ISA is a separate executable, so each slice has one with the same
+        # name, SSE4.1 is the highest x86_64 ISA that all Intel Macs have, AVX2 would exclude ones before 2013
+        opts[self._isa_option(state)] = 'YES'
+
+        super().configure(state)
+
+    def post_build(self, state: BuildState):
+        self.copy_to_bin(state, f'Source/astcenc-{self._isa_name(state)}', 'astcenc')
+
+    @staticmethod
+    def _isa_option(state: BuildState):
+        return 'ASTCENC_ISA_NEON' if state.architecture() == 'arm64' else 'ASTCENC_ISA_SSE41'
+
+    @staticmethod
+    def _isa_name(state: BuildState):
+        return 'neon' if state.architecture() == 'arm64' else 'sse4.1'
+
+
 class AutoconfTarget(base.ConfigureMakeDependencyTarget):
     # TODO: fix absolute paths in bin/* and share/autoconf/autom4te.cfg
     def __init__(self, name='autoconf'):
@@ -71,6 +106,11 @@ class DosBoxXTarget(base.ConfigureMakeDependencyTarget):
         opts['--disable-libslirp'] = None  # TODO: Add slirp target
         opts['--enable-sdl2'] = None
 
+        # Recompiling core with simple code generator is the only dynamic core on arm64, core=auto selects it
+        # Its code cache is allocated with MAP_JIT, and made writable by pthread_jit_write_protect_np() on Apple Silicon
+        opts['--enable-dynamic-core'] = None
+        opts['--enable-dynrec'] = None
+
         # Run generated configure script
         super().configure(state)
 
@@ -88,6 +128,7 @@ class DzipTarget(base.CMakeStaticDependencyTarget):
 class EricWToolsTarget(base.CMakeStaticDependencyTarget):
     def __init__(self, name='ericw-tools'):
         super().__init__(name)
+        self.dependencies += ('embree',)
 
     def prepare_source(self, state: BuildState):
         state.download_source(
@@ -109,7 +150,14 @@ class GlslangTarget(base.CMakeStaticDependencyTarget):
         args = ('python3', 'update_glslang_sources.py')
         subprocess.run(args, check=True, cwd=state.source, env=state.environment)
 
-        state.options['ENABLE_CTEST'] = 'NO'
+        opts = state.options
+        opts['ENABLE_CTEST'] = 'NO'
+
+        # Command line compiler and optimizer, glslang and spirv-opt, to compile shaders to SPIR-V offline
+        opts['ENABLE_GLSLANG_BINARIES'] = 'YES'
+        opts['ENABLE_OPT'] = 'YES'
+        opts['SPIRV_SKIP_EXECUTABLES'] = 'NO'
+
         super().configure(state)
 
     def post_build(self, state: BuildState):
@@ -168,6 +216,14 @@ class PbzxTarget(base.SingleExeCTarget):
             '33db3cf9dc70ae704e1bbfba52c984f4c6dbfd0cc4449fa16408910e22b4fd90',
             'pbzx-xar-content')
 
+    def configure(self, state: BuildState):
+        super().configure(state)
+
+        # Chunks are decompressed on all cores, original main() remains for other usages and PBZX_JOBS=1
+        opts = state.options
+        opts[str(state.patch_path / 'pbzx' / 'pbzx_parallel.c')] = None
+        opts['-Dmain=pbzx_serial_main'] = None
+
     def detect(self, state: BuildState) -> bool:
         return state.has_source_file('pbzx.c')
 
@@ -288,6 +344,9 @@ class UnrarTarget(base.MakeTarget):
         # Value of CXXFLAGS variable from makefile with '-std=c++11' command line argument added
         state.options['CXXFLAGS'] = '-std=c++11 -O2 -Wno-logical-op-parentheses -Wno-switch -Wno-dangling-else'
 
+        # Multithreaded decompression and hashing, number of threads is the number of cores unless -mt switch is given
+        state.options['DEFINES'] = '-D_FILE_OFFSET_BITS=64 -D_LARGEFILE_SOURCE -DRAR_SMP'
+
         super().configure(state)
 
     def post_build(self, state: BuildState):
@@ -332,6 +391,14 @@ class XzTarget(base.CMakeStaticDependencyTarget):
             'https://tukaani.org/xz/xz-5.4.5.tar.gz',
             '135c90b934aee8fbc0d467de87a05cb70d627da36abe518c357a873709e5b7d6')
 
+    def configure(self, state: BuildState):
+        # Multithreaded encoder and decoder, lzma_stream_encoder_mt() and lzma_stream_decoder_mt(),
+        # are parts of liblzma only when it's built with threading support
+        opts = state.options
+        opts['ENABLE_THREADS'] = 'posix'
+
+        super().configure(state)
+
 
 class ZipTarget(base.SingleExeCTarget):
     def __init__(self, name='zip'):
@@ -0,0 +1,265 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+# Run this module as python3 -B -m aedi.texture from repository root, see BatchTranscoder
+
+import argparse
+import concurrent.futures
+import fnmatch
+import hashlib
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+import typing
+from pathlib import Path
+
+
+class BatchTranscoder(object):
+    """
+    Directory of mod lumps copied to output directory with its textures transcoded by astcenc to ASTC compressed
+    KTX files, so PK3 archive packed from the output has GPU-ready textures that are neither decoded on load
+    nor uploaded uncompressed, they take 8 bits per pixel with 4x4 blocks, and 2 bits with 8x8 ones, instead of 32
+
+    Textures are transcoded concurrently, one single-threaded astcenc process per texture, and only when
+    the texture, astcenc executable, or options have changed since the previous batch, digests of transcoded
+    textures are kept in cache file of output directory. WebP images are converted to PNG by sips first,
+    astcenc doesn't read them. Mipmaps are not generated, engines that need them make them from base level
+
+    Other lumps are copied when changed, and files without lumps are removed, so output has the same lumps
+    """
+
+    CACHE_NAME = '.aedi-texture.json'
+    CACHE_FORMAT_VERSION = 1
+
+    TEXTURE_DIRECTORIES = ('flats', 'hires', 'sprites', 'textures')
+    TEXTURE_SUFFIXES = ('.jpeg', '.jpg', '.png', '.tga', '.webp')
+    OUTPUT_SUFFIX = '.ktx'
+
+    BLOCK_SIZES = ('4x4', '5x5', '6x6', '8x8')
+    QUALITIES = ('fastest', 'fast', 'medium', 'thorough', 'exhaustive')
+
+    def __init__(self, astcenc: Path, source_path: Path, output_path: Path, block_size: str = '6x6',
+                 quality: str = 'medium', texture_directories: typing.Sequence[str] = TEXTURE_DIRECTORIES,
+                 normal_patterns: typing.Sequence[str] = (), jobs: typing.Optional[int] = None):
+        self.astcenc = astcenc
+        self.source_path = source_path
+        self.output_path = output_path
+        self.block_size = block_size
+        self.quality = quality
+        self.texture_directories = [directory.lower() for directory in texture_directories]
+        self.normal_patterns = [pattern.lower() for pattern in normal_patterns]
+        self.jobs = jobs or os.cpu_count()
+        self._cache_path = output_path / self.CACHE_NAME
+
+    def transcode(self) -> bool:
+        start_time = time.monotonic()
+        os.makedirs(self.output_path, exist_ok=True)
+
+        textures, lumps = self._collect_lumps()
+        output_names = [self._output_name(name) for name in textures]
+
+        if len(set(output_names)) != len(output_names):
+            raise RuntimeError('Textures with the same name and different extensions would be transcoded '
+                               'to the same file')
+
+        cache = self._load_cache()
+        base_digest = self._base_digest()
+        digests = {name: self._texture_digest(name, base_digest) for name in textures}
+
+        outdated = [name for name in textures
+                    if cache.get(name) != digests[name] or not (self.output_path / self._output_name(name)).exists()]
+
+        failed = []
+
+        with concurrent.futures.ThreadPoolExecutor(max_workers=self.jobs) as executor:
+            futures = {executor.submit(self._transcode, name): name for name in outdated}
+
+            # Other lumps are copied while textures are transcoded
+            copied = sum(self._copy(name) for name in lumps)
+
+            for future in concurrent.futures.as_completed(futures):
+                name = futures[future]
+                result = future.result()
+
+                if result.returncode == 0:
+                    cache[name] = digests[name]
+                else:
+                    failed.append(name)
+                    cache.pop(name, None)
+
+                    # Output of every process is printed at once, so messages of concurrent ones don't mix
+                    sys.stdout.write(result.stdout.decode('utf-8', errors='replace'))
+
+        cache = {name: digest for name, digest in cache.items() if name in digests}
+        self._write_cache(cache)
+        self._remove_stale(set(output_names) | set(lumps))
+
+        elapsed = time.monotonic() - start_time
+        print(f'Transcoded {len(outdated) - len(failed)} of {len(outdated)} changed textures, '
+              f'skipped {len(textures) - len(outdated)} unchanged ones, copied {copied} changed other lumps, '
+              f'in {elapsed:.1f} seconds')
+
+        for name in sorted(failed):
+            print(f'Failed to transcode {name}')
+
+        return not failed
+
+    def _collect_lumps(self) -> typing.Tuple[typing.List[str], typing.List[str]]:
+        textures = []
+        lumps = []
+
+        for path in sorted(self.source_path.rglob('*')):
+            if not path.is_file():
+                continue
+
+            relative_path = path.relative_to(self.source_path)
+            name = relative_path.as_posix()
+
+            # Engines look lumps up case insensitively
+            is_texture = len(relative_path.parts) > 1 and relative_path.parts[0].lower() in self.texture_directories \
+                and path.suffix.lower() in self.TEXTURE_SUFFIXES
+            (textures if is_texture else lumps).append(name)
+
+        return textures, lumps
+
+    def _output_name(self, name: str) -> str:
+        return Path(name).with_suffix(self.OUTPUT_SUFFIX).as_posix()
+
+    def _is_normal_map(self, name: str) -> bool:
+        return any(fnmatch.fnmatchcase(name.lower(), pattern) for pattern in self.normal_patterns)
+
+    def _transcode(self, name: str) -> subprocess.CompletedProcess:
+        source_path = self.source_path / name
+        output_path = self.output_path / self._output_name(name)
+        os.makedirs(output_path.parent, exist_ok=True)
+
+        with tempfile.TemporaryDirectory(dir=self.output_path, prefix='.aedi-texture-') as temp_path:
+            temp_path = Path(temp_path)
+
+            if source_path.suffix.lower() == '.webp':
+                png_path = temp_path / 'texture.png'
+                args = ('sips', '-s', 'format', 'png', source_path, '--out', png_path)
+                result = subprocess.run(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+
+                if result.returncode != 0:
+                    return result
+
+                source_path = png_path
+
+            # Color textures are in sRGB, normal maps are linear, and their two channels are encoded separately
+            is_normal_map = self._is_normal_map(name)
+            args = [self.astcenc, '-cl' if is_normal_map else '-cs', source_path, temp_path / output_path.name,
+                    self.block_size, '-' + self.quality, '-j', '1', '-silent']
+
+            if is_normal_map:
+                args.append('-normal')
+
+            result = subprocess.run(args, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+
+            # File is moved in place once complete, so interrupted batch never leaves truncated texture
+            if result.returncode == 0:
+                os.replace(temp_path / output_path.name, output_path)
+
+        return result
+
+    def _copy(self, name: str) -> bool:
+        source_path = self.source_path / name
+        output_path = self.output_path / name
+
+        if output_path.exists():
+            source_stat = source_path.stat()
+            output_stat = output_path.stat()
+
+            if source_stat.st_size == output_stat.st_size and source_stat.st_mtime == output_stat.st_mtime:
+                return False
+
+        os.makedirs(output_path.parent, exist_ok=True)
+        shutil.copy2(source_path, output_path)
+        return True
+
+    def _remove_stale(self, names: typing.Set[str]):
+        for path in sorted(self.output_path.rglob('*'), reverse=True):
+            name = path.relative_to(self.output_path).as_posix()
+
+            if path.is_file() and name not in names and name != self.CACHE_NAME:
+                path.unlink()
+            elif path.is_dir() and not any(path.iterdir()):
+                path.rmdir()
+
+    def _base_digest(self) -> str:
+        hasher = hashlib.sha256(self.astcenc.read_bytes())
+        hasher.update(f'{self.block_size}\0{self.quality}\0'.encode())
+
+        return hasher.hexdigest()
+
+    def _texture_digest(self, name: str, base_digest: str) -> str:
+        hasher = hashlib.sha256(base_digest.encode())
+        hasher.update(name.encode() + b'\0' + (b'normal' if self._is_normal_map(name) else b'color') + b'\0')
+        hasher.update((self.source_path / name).read_bytes())
+
+        return hasher.hexdigest()
+
+    def _load_cache(self) -> typing.Dict[str, str]:
+        if not self._cache_path.exists():
+            return {}
+
+        try:
+            cache = json.loads(self._cache_path.read_text())
+        except ValueError:
+            return {}
+
+        return cache['textures'] if cache.get('format') == self.CACHE_FORMAT_VERSION else {}
+
+    def _write_cache(self, textures: typing.Dict[str, str]):
+        cache = {'format': self.CACHE_FORMAT_VERSION, 'textures': textures}
+        self._cache_path.write_text(json.dumps(cache, indent=1, sort_keys=True) + '\n')
+
+
+def main(args: typing.Sequence[str]):
+    parser = argparse.ArgumentParser(description='Copy directory of mod lumps with textures transcoded '
+                                                 'to ASTC by astcenc concurrently')
+    parser.add_argument('--astcenc', metavar='path', default='prefix/bin/astcenc', help='path to astcenc executable')
+    parser.add_argument('--block', choices=BatchTranscoder.BLOCK_SIZES, default='6x6',
+                        help='ASTC block size, larger blocks take less memory at lower quality')
+    parser.add_argument('--quality', choices=BatchTranscoder.QUALITIES, default='medium',
+                        help='astcenc search quality preset')
+    parser.add_argument('--textures', metavar='directory', action='append',
+                        help=f'add top-level directory with textures, '
+                             f'{", ".join(BatchTranscoder.TEXTURE_DIRECTORIES)} by default')
+    parser.add_argument('--normal', metavar='pattern', action='append', default=[],
+                        help='transcode textures that match wildcard pattern as normal maps, e.g. *_n.png')
+    parser.add_argument('--jobs', type=int, help='number of concurrent astcenc processes, all CPU cores by default')
+    parser.add_argument('--output', metavar='path', required=True, help='path to directory for transcoded lumps')
+    parser.add_argument('source', metavar='directory', help='path to directory with lumps')
+    arguments = parser.parse_args(args)
+
+    transcoder = BatchTranscoder(Path(arguments.astcenc).absolute(), Path(arguments.source).absolute(),
+                                 Path(arguments.output).absolute(), arguments.block, arguments.quality,
+                                 arguments.textures or BatchTranscoder.TEXTURE_DIRECTORIES, arguments.normal,
+                                 arguments.jobs)
+
+    if not transcoder.transcode():
+        exit(1)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
@@ -0,0 +1,183 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import contextlib
+import json
+import os
+import resource
+import threading
+import time
+import typing
+from pathlib import Path
+
+
+class BuildTrace(object):
+    """
+    Wall and CPU time of build phases, written as Chrome trace that chrome://tracing and Perfetto UI can open
+    Phases are grouped into tracks, one per architecture slice, and one for steps shared by all slices
+    CPU time includes finished child processes, so it's exact for sequential phases only,
+    concurrently built slices share CPU time of each other's compilers
+
+    Optional clang -ftime-trace files are aggregated per translation unit, the slowest ones are listed in summary
+    """
+
+    # Number of the slowest translation units in summary
+    SLOWEST_UNITS = 10
+
+    def __init__(self, name: str):
+        self.name = name
+        self._start_time = time.monotonic()
+
+        # Traces of separately built targets are merged, so events are placed on absolute time scale
+        self._epoch_time = time.time()
+        self._pid = os.getpid()
+        self._events = []
+        self._units = []
+        self._lock = threading.Lock()
+
+    @contextlib.contextmanager
+    def phase(self, name: str, track: str):
+        start_time = time.monotonic()
+        start_cpu_time = self._cpu_time()
+
+        try:
+            yield
+        finally:
+            event = {
+                'name': name,
+                'track': track,
+                'start': start_time - self._start_time,
+                'wall': time.monotonic() - start_time,
+                'cpu': self._cpu_time() - start_cpu_time,
+            }
+
+            with self._lock:
+                self._events.append(event)
+
+    @staticmethod
+    def _cpu_time() -> float:
+        own = resource.getrusage(resource.RUSAGE_SELF)
+        children = resource.getrusage(resource.RUSAGE_CHILDREN)
+        return own.ru_utime + own.ru_stime + children.ru_utime + children.ru_stime
+
+    def add_time_traces(self, build_path: Path, track: str):
+        # Clang writes trace next to object file, with the same name and .json extension
+        for root, _, files in os.walk(build_path):
+            for filename in files:
+                if not filename.endswith('.json'):
+                    continue
+
+                path = Path(root) / filename
+                duration = self._compilation_time(path)
+
+                if duration is not None:
+                    unit = str(path.relative_to(build_path))[:-len('.json')]
+
+                    with self._lock:
+                        self._units.append({'unit': unit, 'track': track, 'wall': duration})
+
+    @staticmethod
+    def _compilation_time(path: Path) -> typing.Optional[float]:
+        try:
+            with open(path) as f:
+                content = json.load(f)
+        except (OSError, ValueError):
+            return None
+
+        if not isinstance(content, dict):
+            return None
+
+        for event in content.get('traceEvents', ()):
+            if event.get('name') == 'Total ExecuteCompiler':
+                return event.get('dur', 0) / 1_000_000
+
+        return None
+
+    @staticmethod
+    def path(root_path: Path, name: str) -> Path:
+        return root_path / 'build' / 'trace' / f'{name}.json'
+
+    def write(self, path: Path):
+        trace_events = []
+        tracks = []
+
+        for event in self._events:
+            if event['track'] not in tracks:
+                tracks.append(event['track'])
+
+            trace_events.append({
+                'name': event['name'],
+                'cat': self.name,
+                'ph': 'X',
+                'ts': round((self._epoch_time + event['start']) * 1_000_000),
+                'dur': round(event['wall'] * 1_000_000),
+                'pid': self._pid,
+                'tid': tracks.index(event['track']),
+                'args': {'cpu_seconds': round(event['cpu'], 3)},
+            })
+
+        trace_events.append({'name': 'process_name', 'ph': 'M', 'pid': self._pid, 'args': {'name': self.name}})
+
+        for index, track in enumerate(tracks):
+            trace_events.append({'name': 'thread_name', 'ph': 'M', 'pid': self._pid, 'tid': index,
+                                 'args': {'name': track}})
+
+        content = {
+            'traceEvents': trace_events,
+            'translationUnits': sorted(self._units, key=lambda unit: -unit['wall']),
+        }
+
+        os.makedirs(path.parent, exist_ok=True)
+        path.write_text(json.dumps(content, indent=1) + '\n')
+
+    def print_summary(self):
+        if not self._events:
+            return
+
+        print(f'Build phases of {self.name}:')
+        print(f'  {"Track":<12} {"Phase":<16} {"Wall, s":>9} {"CPU, s":>9}')
+
+        for event in sorted(self._events, key=lambda event: event['start']):
+            print(f'  {event["track"]:<12} {event["name"]:<16} {event["wall"]:9.1f} {event["cpu"]:9.1f}')
+
+        if self._units:
+            print(f'Slowest translation units of {self.name}:')
+
+            for unit in sorted(self._units, key=lambda unit: -unit['wall'])[:self.SLOWEST_UNITS]:
+                print(f'  {unit["wall"]:7.2f} s  {unit["track"]}  {unit["unit"]}')
+
+    @staticmethod
+    def merge(paths: typing.Iterable[Path], output_path: Path):
+        # Traces of separately built targets are combined as processes of one trace
+        trace_events = []
+        units = []
+
+        for path in paths:
+            content = json.loads(path.read_text())
+            trace_events += content.get('traceEvents', [])
+
+            for unit in content.get('translationUnits', []):
+                units.append(dict(unit, target=path.stem))
+
+        content = {
+            'traceEvents': trace_events,
+            'translationUnits': sorted(units, key=lambda unit: -unit['wall']),
+        }
+
+        os.makedirs(output_path.parent, exist_ok=True)
+        output_path.write_text(json.dumps(content, indent=1) + '\n')
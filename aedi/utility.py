@@ -17,8 +17,10 @@
 #
 
 import collections.abc
+import ctypes
 import os
 import shutil
+import sys
 import typing
 from pathlib import Path
 
@@ -74,8 +76,11 @@ class TargetPlatform:
         self.c_compiler = prefix_path / f'bin/{host}-gcc'
         self.cxx_compiler = prefix_path / f'bin/{host}-g++'
 
+        # Code generation options of CPU tuning profile
+        self.tuning_flags = ''
 
-def symlink_directory(src_path: Path, dst_path: Path, cleanup=True):
+
+def symlink_directory(src_path: Path, dst_path: Path, cleanup=True, links: typing.Optional[list] = None):
     if cleanup:
         # Delete obsolete symbolic links
         for root, _, files in os.walk(dst_path, followlinks=True):
@@ -90,12 +95,49 @@ def symlink_directory(src_path: Path, dst_path: Path, cleanup=True):
         dst_subpath = dst_path / entry.name
         if entry.is_dir():
             os.makedirs(dst_subpath, exist_ok=True)
-            symlink_directory(entry, dst_subpath, cleanup=False)
+            symlink_directory(entry, dst_subpath, cleanup=False, links=links)
         elif not dst_subpath.exists():
-            if entry.is_symlink():
-                shutil.copy(entry, dst_subpath, follow_symlinks=False)
-            else:
-                os.symlink(entry, dst_subpath)
+            symlink_file(entry, dst_subpath)
+
+            if links is not None:
+                links.append(dst_subpath)
+
+
+def symlink_file(src_path: Path, dst_path: Path):
+    if src_path.is_symlink():
+        shutil.copy(src_path, dst_path, follow_symlinks=False)
+    else:
+        os.symlink(src_path, dst_path)
+
+
+def _load_clonefile():
+    if sys.platform != 'darwin':
+        return None
+
+    try:
+        function = ctypes.CDLL(None, use_errno=True).clonefile
+    except (AttributeError, OSError):
+        return None
+
+    function.argtypes = (ctypes.c_char_p, ctypes.c_char_p, ctypes.c_uint32)
+    function.restype = ctypes.c_int
+    return function
+
+
+_clonefile = _load_clonefile()
+_CLONE_NOFOLLOW = 0x0001
+
+
+def clone_tree(src_path: Path, dst_path: Path):
+    # APFS makes copy-on-write clone of file or entire directory at once, without reading and writing any data
+    # Other file systems, or destination on another volume, get regular copy with symbolic links preserved
+    if _clonefile and _clonefile(os.fsencode(src_path), os.fsencode(dst_path), _CLONE_NOFOLLOW) == 0:
+        return
+
+    if src_path.is_dir() and not src_path.is_symlink():
+        shutil.copytree(src_path, dst_path, symlinks=True)
+    else:
+        shutil.copy2(src_path, dst_path, follow_symlinks=False)
 
 
 # Case insensitive dictionary class from
@@ -0,0 +1,192 @@
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import ctypes
+import os
+import typing
+from pathlib import Path
+
+_CF_STRING_ENCODING_UTF8 = 0x08000100
+
+_FS_EVENT_STREAM_EVENT_ID_SINCE_NOW = 0xFFFFFFFFFFFFFFFF
+_FS_EVENT_STREAM_CREATE_FLAG_FILE_EVENTS = 0x10
+_FS_EVENT_STREAM_EVENT_FLAG_MUST_SCAN_SUB_DIRS = 0x01
+_FS_EVENT_STREAM_EVENT_FLAG_ITEM_IS_DIR = 0x20000
+
+_FSEventStreamCallback = ctypes.CFUNCTYPE(None, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t,
+                                          ctypes.POINTER(ctypes.c_char_p), ctypes.POINTER(ctypes.c_uint32),
+                                          ctypes.POINTER(ctypes.c_uint64))
+
+
+class _FSEvents(object):
+    def __init__(self):
+        cf = ctypes.CDLL('/System/Library/Frameworks/CoreFoundation.framework/CoreFoundation')
+        cs = ctypes.CDLL('/System/Library/Frameworks/CoreServices.framework/CoreServices')
+
+        def function(library, name: str, restype, *argtypes):
+            result = getattr(library, name)
+            result.restype = restype
+            result.argtypes = argtypes
+            return result
+
+        pointer = ctypes.c_void_p
+
+        self.CFRelease = function(cf, 'CFRelease', None, pointer)
+        self.CFStringCreateWithCString = function(cf, 'CFStringCreateWithCString', pointer,
+                                                  pointer, ctypes.c_char_p, ctypes.c_uint32)
+        self.CFArrayCreate = function(cf, 'CFArrayCreate', pointer,
+                                      pointer, ctypes.POINTER(pointer), ctypes.c_long, pointer)
+        self.CFRunLoopGetCurrent = function(cf, 'CFRunLoopGetCurrent', pointer)
+        self.CFRunLoopRunInMode = function(cf, 'CFRunLoopRunInMode', ctypes.c_int32,
+                                           pointer, ctypes.c_double, ctypes.c_uint8)
+        self.kCFTypeArrayCallBacks = ctypes.addressof(ctypes.c_char.in_dll(cf, 'kCFTypeArrayCallBacks'))
+        self.kCFRunLoopDefaultMode = pointer.in_dll(cf, 'kCFRunLoopDefaultMode').value
+
+        self.FSEventStreamCreate = function(cs, 'FSEventStreamCreate', pointer,
+                                            pointer, _FSEventStreamCallback, pointer, pointer,
+                                            ctypes.c_uint64, ctypes.c_double, ctypes.c_uint32)
+        self.FSEventStreamScheduleWithRunLoop = function(cs, 'FSEventStreamScheduleWithRunLoop', None,
+                                                         pointer, pointer, pointer)
+        self.FSEventStreamStart = function(cs, 'FSEventStreamStart', ctypes.c_uint8, pointer)
+        self.FSEventStreamStop = function(cs, 'FSEventStreamStop', None, pointer)
+        self.FSEventStreamInvalidate = function(cs, 'FSEventStreamInvalidate', None, pointer)
+        self.FSEventStreamRelease = function(cs, 'FSEventStreamRelease', None, pointer)
+        self.FSEventsGetCurrentEventId = function(cs, 'FSEventsGetCurrentEventId', ctypes.c_uint64)
+
+
+class SourceWatcher(object):
+    """
+    Changes of files in watched directories, and of individual watched files, reported by FSEvents of macOS
+    Files and directories with names that start with dot are not watched, e.g. .git, copies of applied patches
+    in .aedi-patches, and temporary files of editors
+
+    Events are delivered when waiting only, so changes made meanwhile, by build itself too, are reported on the next
+    wait(). Changes before event ID taken by mark() can be discarded, e.g. source files written by patching
+    """
+
+    # Seconds to wait for more changes after the first one, so saving several files at once triggers one rebuild
+    LATENCY = 0.5
+
+    def __init__(self, paths: typing.Iterable[Path]):
+        try:
+            fsevents = self._fsevents = _FSEvents()
+        except (AttributeError, OSError, ValueError):
+            raise RuntimeError('Watching for changes requires FSEvents of macOS')
+
+        # Events have paths with symbolic links resolved, e.g. /private/tmp for /tmp
+        self._directories = []
+        self._files = set()
+
+        for path in paths:
+            path = Path(os.path.realpath(path))
+
+            if path.is_dir():
+                self._directories.append(path)
+            else:
+                self._files.add(path)
+
+        roots = sorted(set(self._directories) | {path.parent for path in self._files})
+        self._changes: typing.Dict[Path, int] = {}
+
+        # Reference to callback is kept for the lifetime of stream, it cannot be collected while stream calls it
+        self._callback = _FSEventStreamCallback(self._on_events)
+
+        strings = [fsevents.CFStringCreateWithCString(None, os.fsencode(root), _CF_STRING_ENCODING_UTF8)
+                   for root in roots]
+        values = (ctypes.c_void_p * len(strings))(*strings)
+        array = fsevents.CFArrayCreate(None, values, len(strings), fsevents.kCFTypeArrayCallBacks)
+
+        for string in strings:
+            fsevents.CFRelease(string)
+
+        self._stream = fsevents.FSEventStreamCreate(None, self._callback, None, array,
+                                                    _FS_EVENT_STREAM_EVENT_ID_SINCE_NOW, self.LATENCY,
+                                                    _FS_EVENT_STREAM_CREATE_FLAG_FILE_EVENTS)
+        fsevents.CFRelease(array)
+
+        if not self._stream:
+            raise RuntimeError('Failed to create FSEvents stream for ' + ', '.join(str(root) for root in roots))
+
+        fsevents.FSEventStreamScheduleWithRunLoop(self._stream, fsevents.CFRunLoopGetCurrent(),
+                                                  fsevents.kCFRunLoopDefaultMode)
+        fsevents.FSEventStreamStart(self._stream)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.close()
+
+    def close(self):
+        if not self._stream:
+            return
+
+        fsevents = self._fsevents
+        fsevents.FSEventStreamStop(self._stream)
+        fsevents.FSEventStreamInvalidate(self._stream)
+        fsevents.FSEventStreamRelease(self._stream)
+        self._stream = None
+
+    def mark(self) -> int:
+        return self._fsevents.FSEventsGetCurrentEventId()
+
+    def discard(self, event_id: int, directories: typing.Iterable[Path]):
+        # Events of recent changes are delivered with latency, they are received before discarding
+        self._run_loop(self.LATENCY * 2, False)
+
+        directories = [Path(os.path.realpath(directory)) for directory in directories]
+        self._changes = {path: path_event_id for path, path_event_id in self._changes.items()
+                         if path_event_id > event_id or not any(self._is_within(path, root) for root in directories)}
+
+    def wait(self) -> typing.List[Path]:
+        while not self._changes:
+            self._run_loop(1.0, True)
+
+        changes = sorted(self._changes)
+        self._changes.clear()
+
+        return changes
+
+    def _run_loop(self, seconds: float, return_after_events: bool):
+        # Callbacks of stream are called from here, on the thread that scheduled it
+        fsevents = self._fsevents
+        fsevents.CFRunLoopRunInMode(fsevents.kCFRunLoopDefaultMode, seconds, return_after_events)
+
+    def _on_events(self, stream, info, count: int, paths, flags, event_ids):
+        for i in range(count):
+            path = Path(os.fsdecode(paths[i]))
+            is_directory = flags[i] & _FS_EVENT_STREAM_EVENT_FLAG_ITEM_IS_DIR
+            must_scan = flags[i] & _FS_EVENT_STREAM_EVENT_FLAG_MUST_SCAN_SUB_DIRS
+
+            # Dropped events are reported for the whole directory, anything in it could have changed
+            if (must_scan or not is_directory) and self._is_watched(path):
+                self._changes[path] = event_ids[i]
+
+    def _is_watched(self, path: Path) -> bool:
+        if path in self._files:
+            return True
+
+        for root in self._directories:
+            if self._is_within(path, root):
+                return not any(part.startswith('.') for part in path.relative_to(root).parts)
+
+        return False
+
+    @staticmethod
+    def _is_within(path: Path, root: Path) -> bool:
+        return path == root or root in path.parents
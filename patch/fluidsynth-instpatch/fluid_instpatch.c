@@ -0,0 +1,726 @@
+/* FluidSynth - A Software Synthesizer
+ *
+ * Copyright (C) 2003  Peter Hanappe and others.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA
+ */
+
+/* DLS loader on top of libinstpatch, it replaces upstream one of the same name.
+ *
+ * libinstpatch still parses the bank, and converts its instruments to SF2 voices, but sample data is
+ * not read when the bank is opened. Upstream loader caches every sample in RAM store of libinstpatch,
+ * which reads and copies the whole bank. Here, native 16-bit mono samples, i.e. nearly all samples
+ * of DLS banks, are used in place from a read-only mapping of the file, so they are served from
+ * page cache and read from disk only when a voice plays them for the first time. Selection of a preset
+ * asks the kernel to read ahead its samples, so playback doesn't wait for disk in page faults.
+ * Samples in other formats, e.g. 8-bit or stereo ones, are converted by libinstpatch on load as before.
+ */
+
+#include <libinstpatch/libinstpatch.h>
+
+#include "fluid_instpatch.h"
+#include "fluid_list.h"
+#include "fluid_mod.h"
+#include "fluid_sys.h"
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_UNISTD_H) && !defined(WORDS_BIGENDIAN) && !defined(_WIN32)
+#define FLUID_INSTPATCH_MAP_SAMPLES 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Max voices per instrument, voices exceeding this will not sound */
+#define MAX_INST_VOICES 128
+
+typedef struct
+{
+    char name[256];
+    IpatchDLSFile *file;        /* File object that native samples of the bank refer to */
+    IpatchDLS2 *dls;
+    void *mapping;              /* Whole file mapped read-only, NULL if it couldn't be mapped */
+    size_t mapping_size;
+    fluid_list_t *preset_list;  /* List of fluid_preset_t */
+    fluid_list_t *preset_iter_cur;
+} fluid_instpatch_font_t;
+
+typedef struct
+{
+    fluid_instpatch_font_t *parent_sfont;
+    IpatchSF2VoiceCache *cache;
+    gchar *name;
+    int bank;
+    int prog;
+} fluid_instpatch_preset_t;
+
+/* User data of every SF2 voice that has sample */
+typedef struct
+{
+    fluid_sample_t *sample;
+    IpatchSampleStoreCache *store;  /* Open RAM store of libinstpatch, NULL if sample is mapped from file */
+    short *data;
+    size_t size;                    /* Size of sample data in bytes */
+} fluid_instpatch_sample_t;
+
+static fluid_sfont_t *fluid_instpatch_loader_load(fluid_sfloader_t *loader, const char *filename);
+
+static const char *fluid_instpatch_sfont_get_name(fluid_sfont_t *sfont);
+static fluid_preset_t *fluid_instpatch_sfont_get_preset(fluid_sfont_t *sfont, int bank, int prenum);
+static void fluid_instpatch_iteration_start(fluid_sfont_t *sfont);
+static fluid_preset_t *fluid_instpatch_iteration_next(fluid_sfont_t *sfont);
+static int fluid_instpatch_sfont_delete(fluid_sfont_t *sfont);
+
+static const char *fluid_instpatch_preset_get_name(fluid_preset_t *preset);
+static int fluid_instpatch_preset_get_banknum(fluid_preset_t *preset);
+static int fluid_instpatch_preset_get_num(fluid_preset_t *preset);
+static int fluid_instpatch_preset_noteon(fluid_preset_t *preset, fluid_synth_t *synth, int chan, int key, int vel);
+static void fluid_instpatch_preset_free(fluid_preset_t *preset);
+
+static int delete_fluid_instpatch(fluid_instpatch_font_t *font);
+static void delete_fluid_instpatch_sample(gpointer data);
+
+void fluid_instpatch_init(void)
+{
+    ipatch_init();
+}
+
+void fluid_instpatch_deinit(void)
+{
+    ipatch_close();
+}
+
+int fluid_instpatch_supports_multi_init(void)
+{
+    guint major, minor, micro;
+    ipatch_version(&major, &minor, &micro);
+
+    /* libinstpatch before 1.1.5 can't be initialized again after ipatch_close() */
+    return major * 10000 + minor * 100 + micro >= 10105;
+}
+
+fluid_sfloader_t *new_fluid_instpatch_loader(fluid_settings_t *settings)
+{
+    fluid_sfloader_t *loader = new_fluid_sfloader(fluid_instpatch_loader_load, delete_fluid_sfloader);
+
+    if(loader == NULL)
+    {
+        FLUID_LOG(FLUID_ERR, "Failed to create the instpatch SoundFont loader");
+        return NULL;
+    }
+
+    fluid_sfloader_set_data(loader, settings);
+    return loader;
+}
+
+/* SF2 modulator source, except its controller index, to FluidSynth source flags.
+ * Direction, polarity and type bits go in the same order in both */
+static int fluid_instpatch_mod_flags(guint16 src)
+{
+    const int mask = IPATCH_SF2_MOD_MASK_DIRECTION | IPATCH_SF2_MOD_MASK_POLARITY | IPATCH_SF2_MOD_MASK_TYPE;
+    return ((src & mask) >> IPATCH_SF2_MOD_SHIFT_DIRECTION)
+           | ((src & IPATCH_SF2_MOD_MASK_CC) ? FLUID_MOD_CC : FLUID_MOD_GC);
+}
+
+#ifdef FLUID_INSTPATCH_MAP_SAMPLES
+static void fluid_instpatch_map_file(fluid_instpatch_font_t *font, const char *filename)
+{
+    struct stat status;
+    void *mapping;
+    int fd = open(filename, O_RDONLY);
+
+    if(fd == -1)
+    {
+        return;
+    }
+
+    if(fstat(fd, &status) == 0 && status.st_size > 0)
+    {
+        mapping = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(mapping != MAP_FAILED)
+        {
+            font->mapping = mapping;
+            font->mapping_size = (size_t)status.st_size;
+        }
+    }
+
+    close(fd);
+}
+
+/* Sample data of the voice in file mapping, or NULL if its native sample can't be played in place */
+static short *fluid_instpatch_mapped_data(fluid_instpatch_font_t *font, IpatchSF2Voice *voice)
+{
+    const int format = IPATCH_SAMPLE_16BIT | IPATCH_SAMPLE_MONO | IPATCH_SAMPLE_SIGNED | IPATCH_SAMPLE_LENDIAN;
+    IpatchSampleStore *store;
+    IpatchSampleStoreFile *file_store;
+    guint64 end;
+
+    if(font->mapping == NULL
+            || (ipatch_sample_data_get_native_format(voice->sample_data) & IPATCH_SAMPLE_FORMAT_MASK) != format)
+    {
+        return NULL;
+    }
+
+    store = ipatch_sample_data_get_native_sample(voice->sample_data);
+
+    if(store == NULL || !IPATCH_IS_SAMPLE_STORE_FILE(store))
+    {
+        return NULL;
+    }
+
+    file_store = IPATCH_SAMPLE_STORE_FILE(store);
+    end = (guint64)file_store->location + (guint64)voice->sample_size * sizeof(short);
+
+    if(file_store->file != IPATCH_FILE(font->file) || file_store->location % sizeof(short) != 0
+            || end > font->mapping_size)
+    {
+        return NULL;
+    }
+
+    return (short *)((char *)font->mapping + file_store->location);
+}
+
+/* Reads ahead mapped samples of preset selected on a channel */
+static int fluid_instpatch_preset_notify(fluid_preset_t *preset, int reason, int chan)
+{
+    fluid_instpatch_preset_t *preset_data = fluid_preset_get_data(preset);
+    IpatchSF2VoiceCache *cache = preset_data->cache;
+    const uintptr_t page_mask = (uintptr_t)sysconf(_SC_PAGESIZE) - 1;
+    guint i;
+
+    if(reason != FLUID_PRESET_SELECTED)
+    {
+        return FLUID_OK;
+    }
+
+    for(i = 0; i < cache->voices->len; i++)
+    {
+        fluid_instpatch_sample_t *sample = IPATCH_SF2_VOICE_CACHE_GET_VOICE(cache, i)->user_data;
+        uintptr_t begin;
+
+        if(sample == NULL || sample->store != NULL)
+        {
+            continue;
+        }
+
+        begin = (uintptr_t)sample->data & ~page_mask;
+        madvise((void *)begin, (uintptr_t)sample->data + sample->size - begin, MADV_WILLNEED);
+    }
+
+    return FLUID_OK;
+}
+#endif
+
+static fluid_instpatch_sample_t *new_fluid_instpatch_sample(fluid_instpatch_font_t *font, IpatchSF2Voice *voice)
+{
+    fluid_instpatch_sample_t *sample;
+    GError *err = NULL;
+
+    sample = FLUID_NEW(fluid_instpatch_sample_t);
+
+    if(sample == NULL)
+    {
+        FLUID_LOG(FLUID_ERR, "Out of memory");
+        return NULL;
+    }
+
+    FLUID_MEMSET(sample, 0, sizeof(*sample));
+
+#ifdef FLUID_INSTPATCH_MAP_SAMPLES
+    sample->data = fluid_instpatch_mapped_data(font, voice);
+#endif
+
+    if(sample->data == NULL)
+    {
+        /* libinstpatch reads the whole sample and converts it to 16-bit mono here */
+        if(!ipatch_sf2_voice_cache_sample_data(voice, &err))
+        {
+            FLUID_LOG(FLUID_ERR, "Failed to cache DLS inst to SF2 voices: %s", ipatch_gerror_message(err));
+            g_clear_error(&err);
+            goto error;
+        }
+
+        sample->store = IPATCH_SAMPLE_STORE_CACHE(voice->sample_store);
+        ipatch_sample_store_cache_open(sample->store);
+        sample->data = ipatch_sample_store_cache_get_location(sample->store);
+    }
+
+    sample->size = (size_t)voice->sample_size * sizeof(short);
+    sample->sample = new_fluid_sample();
+
+    if(sample->sample == NULL)
+    {
+        FLUID_LOG(FLUID_ERR, "Out of memory");
+        goto error;
+    }
+
+    if(fluid_sample_set_sound_data(sample->sample, sample->data, NULL, voice->sample_size, voice->rate,
+                                   FALSE) != FLUID_OK)
+    {
+        FLUID_LOG(FLUID_ERR, "fluid_sample_set_sound_data() failed");
+        goto error;
+    }
+
+    if(fluid_sample_set_loop(sample->sample, voice->loop_start, voice->loop_end) != FLUID_OK)
+    {
+        FLUID_LOG(FLUID_ERR, "fluid_sample_set_loop() failed");
+        goto error;
+    }
+
+    if(fluid_sample_set_pitch(sample->sample, voice->root_note, voice->fine_tune) != FLUID_OK)
+    {
+        FLUID_LOG(FLUID_ERR, "fluid_sample_set_pitch() failed");
+        goto error;
+    }
+
+    return sample;
+
+error:
+    delete_fluid_instpatch_sample(sample);
+    return NULL;
+}
+
+static void delete_fluid_instpatch_sample(gpointer data)
+{
+    fluid_instpatch_sample_t *sample = data;
+
+    if(sample == NULL)
+    {
+        return;
+    }
+
+    if(sample->sample != NULL)
+    {
+        delete_fluid_sample(sample->sample);
+    }
+
+    if(sample->store != NULL)
+    {
+        ipatch_sample_store_cache_close(sample->store);
+    }
+
+    FLUID_FREE(sample);
+}
+
+static fluid_preset_t *new_fluid_instpatch_preset(fluid_instpatch_font_t *font, fluid_sfont_t *sfont,
+        IpatchDLS2Inst *inst)
+{
+    fluid_instpatch_preset_t *preset_data;
+    fluid_preset_t *preset;
+    IpatchConverter *converter;
+    GError *err = NULL;
+    gboolean converted;
+    guint i;
+
+    preset_data = FLUID_NEW(fluid_instpatch_preset_t);
+
+    if(preset_data == NULL)
+    {
+        FLUID_LOG(FLUID_ERR, "Out of memory");
+        return NULL;
+    }
+
+    FLUID_MEMSET(preset_data, 0, sizeof(*preset_data));
+    preset_data->parent_sfont = font;
+
+    ipatch_dls2_inst_get_midi_locale(inst, &preset_data->bank, &preset_data->prog);
+
+    if(ipatch_item_get_flags(inst) & IPATCH_DLS2_INST_PERCUSSION)
+    {
+        preset_data->bank = 128;
+    }
+
+    g_object_get(inst, "name", &preset_data->name, NULL);
+
+    converter = ipatch_create_converter(G_OBJECT_TYPE(inst), IPATCH_TYPE_SF2_VOICE_CACHE);
+
+    if(converter == NULL)
+    {
+        FLUID_LOG(FLUID_ERR, "Unable to find a voice cache converter for this type");
+        goto error;
+    }
+
+    preset_data->cache = ipatch_sf2_voice_cache_new(NULL, 0);
+
+    /* FluidSynth adds its own default modulators to every voice */
+    ipatch_sf2_voice_cache_set_default_mods(preset_data->cache, NULL);
+    preset_data->cache->voice_user_data_destroy = delete_fluid_instpatch_sample;
+
+    ipatch_converter_add_input(converter, G_OBJECT(inst));
+    ipatch_converter_add_output(converter, G_OBJECT(preset_data->cache));
+    converted = ipatch_converter_convert(converter, &err);
+    g_object_unref(converter);
+
+    if(!converted)
+    {
+        FLUID_LOG(FLUID_ERR, "Failed to convert DLS inst to SF2 voices: %s", ipatch_gerror_message(err));
+        g_clear_error(&err);
+        goto error;
+    }
+
+    for(i = 0; i < preset_data->cache->voices->len; i++)
+    {
+        IpatchSF2Voice *voice = IPATCH_SF2_VOICE_CACHE_GET_VOICE(preset_data->cache, i);
+
+        if(voice->sample_data == NULL)
+        {
+            continue;
+        }
+
+        if((voice->user_data = new_fluid_instpatch_sample(font, voice)) == NULL)
+        {
+            goto error;
+        }
+    }
+
+    preset = new_fluid_preset(sfont, fluid_instpatch_preset_get_name, fluid_instpatch_preset_get_banknum,
+                              fluid_instpatch_preset_get_num, fluid_instpatch_preset_noteon,
+                              fluid_instpatch_preset_free);
+
+    if(preset == NULL)
+    {
+        goto error;
+    }
+
+#ifdef FLUID_INSTPATCH_MAP_SAMPLES
+    preset->notify = fluid_instpatch_preset_notify;
+#endif
+
+    fluid_preset_set_data(preset, preset_data);
+    return preset;
+
+error:
+    FLUID_LOG(FLUID_WARN, "Unable to use DLS instrument bank %d , prog %d : %s.", preset_data->bank,
+              preset_data->prog, preset_data->name ? preset_data->name : "");
+
+    if(preset_data->cache != NULL)
+    {
+        /* Destroys samples of voices that were created */
+        g_object_unref(preset_data->cache);
+    }
+
+    g_free(preset_data->name);
+    FLUID_FREE(preset_data);
+    return NULL;
+}
+
+static fluid_instpatch_font_t *new_fluid_instpatch(fluid_sfont_t *sfont, const char *filename)
+{
+    fluid_instpatch_font_t *font;
+    IpatchFileHandle *handle;
+    IpatchDLSReader *reader;
+    IpatchDLS2Inst *inst;
+    IpatchIter iter;
+    GError *err = NULL;
+
+    font = FLUID_NEW(fluid_instpatch_font_t);
+
+    if(font == NULL)
+    {
+        FLUID_LOG(FLUID_ERR, "Out of memory");
+        return NULL;
+    }
+
+    FLUID_MEMSET(font, 0, sizeof(*font));
+    FLUID_STRNCPY(font->name, filename, sizeof(font->name));
+
+    font->file = ipatch_dls_file_new();
+    handle = ipatch_file_open(IPATCH_FILE(font->file), filename, "r", &err);
+
+    if(handle == NULL)
+    {
+        FLUID_LOG(FLUID_ERR, "ipatch_file_open() failed with error: '%s'", ipatch_gerror_message(err));
+        g_clear_error(&err);
+        goto error;
+    }
+
+    /* Reader owns the file handle and closes it */
+    reader = ipatch_dls_reader_new(handle);
+    font->dls = ipatch_dls_reader_load(reader, &err);
+    g_object_unref(reader);
+
+    if(font->dls == NULL)
+    {
+        FLUID_LOG(FLUID_ERR, "ipatch_dls_reader_new() failed with error: '%s'", ipatch_gerror_message(err));
+        g_clear_error(&err);
+        goto error;
+    }
+
+#ifdef FLUID_INSTPATCH_MAP_SAMPLES
+    fluid_instpatch_map_file(font, filename);
+#endif
+
+    if(!ipatch_container_init_iter(IPATCH_CONTAINER(font->dls), &iter, IPATCH_TYPE_DLS2_INST))
+    {
+        goto error;
+    }
+
+    for(inst = ipatch_dls2_inst_first(&iter); inst != NULL; inst = ipatch_dls2_inst_next(&iter))
+    {
+        fluid_preset_t *preset = new_fluid_instpatch_preset(font, sfont, inst);
+
+        if(preset != NULL)
+        {
+            font->preset_list = fluid_list_append(font->preset_list, preset);
+        }
+    }
+
+    if(font->preset_list == NULL)
+    {
+        FLUID_LOG(FLUID_ERR, "A soundfont file was accepted by libinstpatch, but it doesn't contain a single instrument. Dropping the whole file.");
+        goto error;
+    }
+
+    return font;
+
+error:
+    delete_fluid_instpatch(font);
+    return NULL;
+}
+
+static int delete_fluid_instpatch(fluid_instpatch_font_t *font)
+{
+    fluid_list_t *list;
+
+    /* Samples of voices that are still playing must stay */
+    for(list = font->preset_list; list != NULL; list = fluid_list_next(list))
+    {
+        fluid_instpatch_preset_t *preset_data = fluid_preset_get_data((fluid_preset_t *)fluid_list_get(list));
+        IpatchSF2VoiceCache *cache = preset_data->cache;
+        guint i;
+
+        for(i = 0; i < cache->voices->len; i++)
+        {
+            fluid_instpatch_sample_t *sample = IPATCH_SF2_VOICE_CACHE_GET_VOICE(cache, i)->user_data;
+
+            if(sample != NULL && sample->sample->refcount != 0)
+            {
+                return FLUID_FAILED;
+            }
+        }
+    }
+
+    for(list = font->preset_list; list != NULL; list = fluid_list_next(list))
+    {
+        fluid_instpatch_preset_free((fluid_preset_t *)fluid_list_get(list));
+    }
+
+    delete_fluid_list(font->preset_list);
+
+#ifdef FLUID_INSTPATCH_MAP_SAMPLES
+    if(font->mapping != NULL)
+    {
+        munmap(font->mapping, font->mapping_size);
+    }
+#endif
+
+    if(font->dls != NULL)
+    {
+        g_object_unref(font->dls);
+    }
+
+    if(font->file != NULL)
+    {
+        g_object_unref(font->file);
+    }
+
+    FLUID_FREE(font);
+    return FLUID_OK;
+}
+
+static fluid_sfont_t *fluid_instpatch_loader_load(fluid_sfloader_t *loader, const char *filename)
+{
+    fluid_instpatch_font_t *font;
+    fluid_sfont_t *sfont;
+
+    sfont = new_fluid_sfont(fluid_instpatch_sfont_get_name, fluid_instpatch_sfont_get_preset,
+                            fluid_instpatch_iteration_start, fluid_instpatch_iteration_next,
+                            fluid_instpatch_sfont_delete);
+
+    if(sfont == NULL)
+    {
+        return NULL;
+    }
+
+    if((font = new_fluid_instpatch(sfont, filename)) == NULL)
+    {
+        delete_fluid_sfont(sfont);
+        return NULL;
+    }
+
+    fluid_sfont_set_data(sfont, font);
+    return sfont;
+}
+
+static const char *fluid_instpatch_sfont_get_name(fluid_sfont_t *sfont)
+{
+    fluid_instpatch_font_t *font = fluid_sfont_get_data(sfont);
+    return font->name;
+}
+
+static fluid_preset_t *fluid_instpatch_sfont_get_preset(fluid_sfont_t *sfont, int bank, int prenum)
+{
+    fluid_instpatch_font_t *font = fluid_sfont_get_data(sfont);
+    fluid_list_t *list;
+
+    for(list = font->preset_list; list != NULL; list = fluid_list_next(list))
+    {
+        fluid_preset_t *preset = fluid_list_get(list);
+
+        if(fluid_preset_get_banknum(preset) == bank && fluid_preset_get_num(preset) == prenum)
+        {
+            return preset;
+        }
+    }
+
+    return NULL;
+}
+
+static void fluid_instpatch_iteration_start(fluid_sfont_t *sfont)
+{
+    fluid_instpatch_font_t *font = fluid_sfont_get_data(sfont);
+    font->preset_iter_cur = font->preset_list;
+}
+
+static fluid_preset_t *fluid_instpatch_iteration_next(fluid_sfont_t *sfont)
+{
+    fluid_instpatch_font_t *font = fluid_sfont_get_data(sfont);
+    fluid_preset_t *preset = fluid_list_get(font->preset_iter_cur);
+
+    font->preset_iter_cur = fluid_list_next(font->preset_iter_cur);
+    return preset;
+}
+
+static int fluid_instpatch_sfont_delete(fluid_sfont_t *sfont)
+{
+    fluid_instpatch_font_t *font = fluid_sfont_get_data(sfont);
+
+    if(delete_fluid_instpatch(font) != FLUID_OK)
+    {
+        return FLUID_FAILED;
+    }
+
+    delete_fluid_sfont(sfont);
+    return FLUID_OK;
+}
+
+static const char *fluid_instpatch_preset_get_name(fluid_preset_t *preset)
+{
+    fluid_instpatch_preset_t *preset_data = fluid_preset_get_data(preset);
+    return preset_data->name;
+}
+
+static int fluid_instpatch_preset_get_banknum(fluid_preset_t *preset)
+{
+    fluid_instpatch_preset_t *preset_data = fluid_preset_get_data(preset);
+    return preset_data->bank;
+}
+
+static int fluid_instpatch_preset_get_num(fluid_preset_t *preset)
+{
+    fluid_instpatch_preset_t *preset_data = fluid_preset_get_data(preset);
+    return preset_data->prog;
+}
+
+static int fluid_instpatch_preset_noteon(fluid_preset_t *preset, fluid_synth_t *synth, int chan, int key, int vel)
+{
+    fluid_instpatch_preset_t *preset_data = fluid_preset_get_data(preset);
+    IpatchSF2VoiceCache *cache = preset_data->cache;
+    int sel_values[IPATCH_SF2_VOICE_CACHE_MAX_SEL_VALUES];
+    guint16 index_array[MAX_INST_VOICES];
+    fluid_mod_t mod;
+    int i, j, voice_count;
+
+    for(i = 0; i < cache->sel_count && i < IPATCH_SF2_VOICE_CACHE_MAX_SEL_VALUES; i++)
+    {
+        switch(cache->sel_info[i].type)
+        {
+        case IPATCH_SF2_VOICE_SEL_NOTE:
+            sel_values[i] = key;
+            break;
+
+        case IPATCH_SF2_VOICE_SEL_VELOCITY:
+            sel_values[i] = vel;
+            break;
+
+        default:
+            sel_values[i] = IPATCH_SF2_VOICE_SEL_WILDCARD;
+            break;
+        }
+    }
+
+    FLUID_MEMSET(&mod, 0, sizeof(mod));
+    voice_count = ipatch_sf2_voice_cache_select(cache, sel_values, index_array, MAX_INST_VOICES);
+
+    for(i = 0; i < voice_count; i++)
+    {
+        IpatchSF2Voice *voice = IPATCH_SF2_VOICE_CACHE_GET_VOICE(cache, index_array[i]);
+        fluid_instpatch_sample_t *sample = voice->user_data;
+        fluid_voice_t *fluid_voice;
+        GSList *p;
+
+        if(sample == NULL)
+        {
+            continue;
+        }
+
+        fluid_voice = fluid_synth_alloc_voice(synth, sample->sample, chan, key, vel);
+
+        if(fluid_voice == NULL)
+        {
+            return FLUID_FAILED;
+        }
+
+        /* Preset and instrument generators are already combined by voice cache converter */
+        for(j = 0; j < IPATCH_SF2_GEN_COUNT; j++)
+        {
+            if(IPATCH_SF2_GEN_ARRAY_TEST_FLAG(&voice->gen_array, j))
+            {
+                fluid_voice_gen_set(fluid_voice, j, voice->gen_array.values[j].sword);
+            }
+        }
+
+        for(p = voice->mod_list; p != NULL; p = p->next)
+        {
+            IpatchSF2Mod *voice_mod = p->data;
+
+            fluid_mod_set_dest(&mod, voice_mod->dest);
+            fluid_mod_set_source1(&mod, voice_mod->src & IPATCH_SF2_MOD_MASK_CONTROL,
+                                  fluid_instpatch_mod_flags(voice_mod->src));
+            fluid_mod_set_source2(&mod, voice_mod->amtsrc & IPATCH_SF2_MOD_MASK_CONTROL,
+                                  fluid_instpatch_mod_flags(voice_mod->amtsrc));
+            fluid_mod_set_amount(&mod, voice_mod->amount);
+            fluid_voice_add_mod(fluid_voice, &mod, FLUID_VOICE_OVERWRITE);
+        }
+
+        fluid_synth_start_voice(synth, fluid_voice);
+    }
+
+    return FLUID_OK;
+}
+
+static void fluid_instpatch_preset_free(fluid_preset_t *preset)
+{
+    fluid_instpatch_preset_t *preset_data = fluid_preset_get_data(preset);
+
+    /* Voice cache destroys samples of its voices */
+    g_object_unref(preset_data->cache);
+    g_free(preset_data->name);
+    FLUID_FREE(preset_data);
+
+    delete_fluid_preset(preset);
+}
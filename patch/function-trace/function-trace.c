@@ -0,0 +1,241 @@
+#include <dlfcn.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mach/mach_time.h>
+#include <os/lock.h>
+
+#include "function-trace.h"
+
+// Entry and exit hooks of -finstrument-functions, they and everything they call must not be instrumented
+#define NO_TRACE __attribute__((no_instrument_function))
+
+// Calls deeper than that are not recorded, and recorded calls beyond buffer capacity of thread are dropped
+#define TRACE_MAX_DEPTH 256
+#define TRACE_CAPACITY (64 * 1024)
+
+typedef struct
+{
+    void* function;
+    uint64_t start;
+    uint64_t duration;
+} TraceEvent;
+
+typedef struct TraceBuffer
+{
+    struct TraceBuffer* next;
+    uint64_t thread_id;
+    size_t count;
+    size_t dropped;
+    TraceEvent events[TRACE_CAPACITY];
+} TraceBuffer;
+
+typedef struct
+{
+    TraceBuffer* buffer;
+    unsigned int depth;
+    uint64_t starts[TRACE_MAX_DEPTH];
+} TraceThread;
+
+static __thread TraceThread trace_thread;
+
+// Buffers are never freed, so calls of finished threads are dumped too
+static TraceBuffer* trace_buffers;
+static os_unfair_lock trace_lock = OS_UNFAIR_LOCK_INIT;
+
+static int trace_enabled = 1;
+static uint64_t trace_threshold;
+static mach_timebase_info_data_t trace_timebase;
+
+NO_TRACE static double trace_ticks_to_us(uint64_t ticks)
+{
+    return (double)ticks * trace_timebase.numer / trace_timebase.denom / 1000.0;
+}
+
+NO_TRACE static void trace_dump_at_exit(void)
+{
+    const char* path = getenv("AEDI_FUNCTION_TRACE");
+
+    if (path != NULL && function_trace_dump(path) != 0)
+    {
+        fprintf(stderr, "function-trace: cannot write %s\n", path);
+    }
+}
+
+NO_TRACE __attribute__((constructor)) static void trace_initialize(void)
+{
+    mach_timebase_info(&trace_timebase);
+
+    const char* threshold = getenv("AEDI_FUNCTION_TRACE_THRESHOLD");
+    const double microseconds = threshold != NULL ? atof(threshold) : 100.0;
+    trace_threshold = (uint64_t)(microseconds * 1000.0 * trace_timebase.denom / trace_timebase.numer);
+
+    if (getenv("AEDI_FUNCTION_TRACE") != NULL)
+    {
+        atexit(trace_dump_at_exit);
+    }
+}
+
+NO_TRACE static TraceBuffer* trace_create_buffer(void)
+{
+    TraceBuffer* buffer = calloc(1, sizeof(TraceBuffer));
+
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+
+    pthread_threadid_np(NULL, &buffer->thread_id);
+
+    os_unfair_lock_lock(&trace_lock);
+    buffer->next = trace_buffers;
+    trace_buffers = buffer;
+    os_unfair_lock_unlock(&trace_lock);
+
+    return buffer;
+}
+
+NO_TRACE void __cyg_profile_func_enter(void* function, void* call_site)
+{
+    (void)function;
+    (void)call_site;
+
+    TraceThread* thread = &trace_thread;
+
+    if (thread->depth < TRACE_MAX_DEPTH)
+    {
+        thread->starts[thread->depth] = mach_absolute_time();
+    }
+
+    ++thread->depth;
+}
+
+NO_TRACE void __cyg_profile_func_exit(void* function, void* call_site)
+{
+    (void)call_site;
+
+    TraceThread* thread = &trace_thread;
+
+    // Exit without entry, e.g. recording started in the middle of a call
+    if (thread->depth == 0)
+    {
+        return;
+    }
+
+    const unsigned int depth = --thread->depth;
+
+    if (depth >= TRACE_MAX_DEPTH || !__atomic_load_n(&trace_enabled, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    const uint64_t start = thread->starts[depth];
+    const uint64_t duration = mach_absolute_time() - start;
+
+    if (duration < trace_threshold)
+    {
+        return;
+    }
+
+    if (thread->buffer == NULL && (thread->buffer = trace_create_buffer()) == NULL)
+    {
+        return;
+    }
+
+    TraceBuffer* buffer = thread->buffer;
+    const size_t count = __atomic_load_n(&buffer->count, __ATOMIC_RELAXED);
+
+    if (count == TRACE_CAPACITY)
+    {
+        ++buffer->dropped;
+        return;
+    }
+
+    buffer->events[count] = (TraceEvent){ function, start, duration };
+
+    // Dumping thread reads only events that were published with the count
+    __atomic_store_n(&buffer->count, count + 1, __ATOMIC_RELEASE);
+}
+
+NO_TRACE void function_trace_enable(int enabled)
+{
+    __atomic_store_n(&trace_enabled, enabled, __ATOMIC_RELAXED);
+}
+
+NO_TRACE static void trace_write_name(FILE* file, void* function)
+{
+    Dl_info info;
+
+    if (dladdr(function, &info) == 0)
+    {
+        fprintf(file, "%p", function);
+    }
+    else if (info.dli_sname != NULL && info.dli_saddr == function)
+    {
+        // Symbol names need no escaping but quotes and backslashes are possible in theory
+        for (const char* c = info.dli_sname; *c != '\0'; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                fputc('\\', file);
+            }
+
+            fputc(*c, file);
+        }
+    }
+    else
+    {
+        // Functions without exported symbols are named by image offset, atos or nm can resolve them
+        const char* image = info.dli_fname != NULL ? strrchr(info.dli_fname, '/') : NULL;
+        const uintptr_t offset = (uintptr_t)function - (uintptr_t)info.dli_fbase;
+        fprintf(file, "%s+0x%" PRIxPTR, image != NULL ? image + 1 : "?", offset);
+    }
+}
+
+NO_TRACE int function_trace_dump(const char* path)
+{
+    FILE* file = fopen(path, "w");
+
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    os_unfair_lock_lock(&trace_lock);
+    TraceBuffer* buffers = trace_buffers;
+    os_unfair_lock_unlock(&trace_lock);
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+
+    const char* separator = "\n";
+
+    for (TraceBuffer* buffer = buffers; buffer != NULL; buffer = buffer->next)
+    {
+        const size_t count = __atomic_load_n(&buffer->count, __ATOMIC_ACQUIRE);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const TraceEvent* event = &buffer->events[i];
+
+            fprintf(file, "%s{\"ph\":\"X\",\"pid\":0,\"tid\":%" PRIu64 ",\"ts\":%.3f,\"dur\":%.3f,\"name\":\"",
+                separator, buffer->thread_id, trace_ticks_to_us(event->start), trace_ticks_to_us(event->duration));
+            trace_write_name(file, event->function);
+            fputs("\"}", file);
+
+            separator = ",\n";
+        }
+
+        if (buffer->dropped != 0)
+        {
+            fprintf(stderr, "function-trace: %zu calls of thread %" PRIu64 " were dropped\n",
+                buffer->dropped, buffer->thread_id);
+        }
+    }
+
+    fputs("\n]}\n", file);
+
+    return fclose(file) == 0 ? 0 : -1;
+}
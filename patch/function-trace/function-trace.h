@@ -0,0 +1,22 @@
+#ifndef FUNCTION_TRACE_H
+#define FUNCTION_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Function calls of dependencies built as trace variant are recorded when they last longer than threshold,
+// AEDI_FUNCTION_TRACE_THRESHOLD environment variable sets it in microseconds, 100 by default
+// With AEDI_FUNCTION_TRACE environment variable set, recorded calls are written to that path at exit
+
+// Write recorded calls to file in Chrome trace event format, returns zero on success
+int function_trace_dump(const char* path);
+
+// Pause or resume recording, e.g. to trace a particular interval only
+void function_trace_enable(int enabled);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
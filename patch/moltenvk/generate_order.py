@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+# Generates linker order file for libMoltenVK.dylib from profiled application launch
+# Usage: sudo generate_order.py path/to/gzdoom.app [application arguments...]
+# Functions are listed in the order of their first call, application should be closed when the first frame is shown
+# DTrace pid provider requires System Integrity Protection to allow it, see csrutil(8)
+
+import subprocess
+import sys
+from pathlib import Path
+
+DTRACE_SCRIPT = '''
+pid$target:libMoltenVK.dylib::entry
+/!seen[probefunc]/
+{
+    seen[probefunc] = 1;
+    printf("%s\\n", probefunc);
+}
+'''
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(f'Usage: {sys.argv[0]} path/to/application.app [arguments...]')
+        return 1
+
+    app_path = Path(sys.argv[1])
+    executable = app_path / 'Contents/MacOS' / app_path.stem
+    command = ' '.join(str(arg) for arg in [executable] + sys.argv[2:])
+
+    args = ('dtrace', '-q', '-x', 'bufsize=64m', '-n', DTRACE_SCRIPT, '-c', command)
+    result = subprocess.run(args, check=True, stdout=subprocess.PIPE)
+
+    symbols = []
+    seen = set()
+
+    for line in result.stdout.decode('ascii', errors='ignore').splitlines():
+        name = line.strip()
+
+        # Application output is mixed with trace output
+        if not name or ' ' in name or name in seen:
+            continue
+
+        seen.add(name)
+        symbols.append('_' + name)
+
+    order_path = Path(__file__).parent / 'libMoltenVK.order'
+    order_path.write_text('\n'.join(symbols) + '\n')
+
+    print(f'Wrote {len(symbols)} symbols to {order_path}')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
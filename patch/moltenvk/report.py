@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+# Compares two builds of libMoltenVK.dylib, e.g. before and after link options change
+# Usage: report.py path/to/old/libMoltenVK.dylib path/to/new/libMoltenVK.dylib
+# Launch time is measured for executable linked with the given dylib and returning from main() immediately,
+# so it consists of dyld work, i.e. loading, binding and running initializers of the library and its dependencies
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+LAUNCH_ITERATIONS = 100
+
+# Reference to Vulkan entry point keeps the dylib from being dropped by linker
+LAUNCHER_SOURCE = 'void vkGetInstanceProcAddr(void);\nint main(void) { return (long)&vkGetInstanceProcAddr == 0; }\n'
+
+
+def _exported_symbol_count(path: Path) -> int:
+    output = subprocess.run(('nm', '-gU', '-arch', 'arm64', path), check=True, stdout=subprocess.PIPE).stdout
+    return len(output.splitlines())
+
+
+def _launch_time(work_path: Path, dylib_path: Path) -> float:
+    lib_path = work_path / 'lib'
+    os.makedirs(lib_path)
+    shutil.copy(dylib_path, lib_path / 'libMoltenVK.dylib')
+
+    source_path = work_path / 'launcher.c'
+    source_path.write_text(LAUNCHER_SOURCE)
+
+    exe_path = work_path / 'launcher'
+    args = ('clang', '-o', exe_path, source_path, '-L', lib_path, '-lMoltenVK', '-Wl,-rpath,' + str(lib_path))
+    subprocess.run(args, check=True)
+
+    # Warm up file cache, cold launch cannot be reproduced without reboot
+    subprocess.run((exe_path,), check=True)
+
+    start = time.perf_counter()
+
+    for _ in range(LAUNCH_ITERATIONS):
+        subprocess.run((exe_path,), check=True)
+
+    return (time.perf_counter() - start) / LAUNCH_ITERATIONS * 1_000_000
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(f'Usage: {sys.argv[0]} path/to/old/libMoltenVK.dylib path/to/new/libMoltenVK.dylib')
+        return 1
+
+    print(f'{"":>12}{"size, bytes":>16}{"exports":>12}{"launch, us":>14}')
+
+    with tempfile.TemporaryDirectory() as temp_path:
+        for label, arg in zip(('old', 'new'), sys.argv[1:]):
+            dylib_path = Path(arg).absolute()
+            work_path = Path(temp_path) / label
+
+            size = os.stat(dylib_path).st_size
+            exports = _exported_symbol_count(dylib_path)
+            launch = _launch_time(work_path, dylib_path)
+
+            print(f'{label:>12}{size:>16}{exports:>12}{launch:>14.1f}')
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,398 @@
+/*
+ * Parallel decompression of pbzx streams, compiled together with pbzx.c
+ *
+ * main() of pbzx.c is renamed to pbzx_serial_main() by compile definition.
+ * pbzx stream is a sequence of independent chunks, each of them is either XZ
+ * stream or stored data. Chunks are read one by one, decompressed on worker
+ * threads, and written to stdout in their original order, so output matches
+ * the one of serial extraction.
+ *
+ * Only extraction of file, xar archive or stdin goes this way, other usages,
+ * e.g. help, and PBZX_JOBS=1 environment variable, run the serial version.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#undef main
+
+#include <errno.h>
+#include <lzma.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <xar/xar.h>
+
+int pbzx_serial_main(int argc, const char** argv);
+
+/* Chunk of stored data has size of the whole uncompressed chunk. */
+#define PBZX_STORED_CHUNK_SIZE 0x1000000
+#define PBZX_MORE_CHUNKS_FLAG (1 << 24)
+
+/* Upper bound of data that chunk header can declare, it's 16 MB in practice. */
+#define PBZX_MAX_CHUNK_SIZE (256ull * 1024 * 1024)
+
+#define PBZX_MAX_JOBS 64
+
+enum slot_state { SLOT_EMPTY, SLOT_READ, SLOT_DECODING, SLOT_DECODED };
+
+struct slot {
+    enum slot_state state;
+    char* input;
+    size_t input_capacity;
+    size_t input_size;
+    char* output;
+    size_t output_capacity;
+    size_t output_size;
+    bool stored;
+};
+
+struct input {
+    FILE* file;
+    xar_t xar;
+    xar_stream xs;
+};
+
+struct pipeline {
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+    struct slot* slots;
+    size_t slot_count;
+    /* Sequence numbers of the next chunk to read, to decode, and to write. */
+    uint64_t read_index;
+    uint64_t decode_index;
+    uint64_t write_index;
+    bool finished;
+    bool failed;
+};
+
+static bool input_open_xar(struct input* in, const char* path) {
+    in->xar = xar_open(path, READ);
+    if (!in->xar) {
+        fprintf(stderr, "[error] \"%s\" is not a valid xar archive\n", path);
+        return false;
+    }
+
+    /* Xcode archives have Content file, installer packages have Payload. */
+    xar_iter_t i = xar_iter_new();
+    xar_file_t f = xar_file_first(in->xar, i);
+    while (f) {
+        char* name = xar_get_path(f);
+        bool found = !strncmp(name, "Content", 7) || !strncmp(name, "Payload", 7);
+        free(name);
+        if (found) {
+            break;
+        }
+        f = xar_file_next(i);
+    }
+    xar_iter_free(i);
+
+    if (!f) {
+        fprintf(stderr, "[error] payload is not found in \"%s\"\n", path);
+        return false;
+    }
+    if (xar_extract_tostream_init(in->xar, f, &in->xs) != XAR_STREAM_OK) {
+        fprintf(stderr, "[error] cannot extract payload from \"%s\"\n", path);
+        return false;
+    }
+    return true;
+}
+
+static void input_close(struct input* in) {
+    if (in->xar) {
+        xar_extract_tostream_end(&in->xs);
+        xar_close(in->xar);
+    }
+    if (in->file && in->file != stdin) {
+        fclose(in->file);
+    }
+}
+
+static bool input_read(struct input* in, char* buffer, size_t size) {
+    if (in->file) {
+        return fread(buffer, 1, size, in->file) == size;
+    }
+
+    in->xs.next_out = buffer;
+    in->xs.avail_out = (unsigned int)size;
+    while (in->xs.avail_out > 0) {
+        int32_t result = xar_extract_tostream(&in->xs);
+        if (result == XAR_STREAM_ERR || (result == XAR_STREAM_END && in->xs.avail_out > 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool input_read_64(struct input* in, uint64_t* value) {
+    unsigned char bytes[8];
+    if (!input_read(in, (char*)bytes, sizeof bytes)) {
+        return false;
+    }
+
+    /* Numbers are big-endian. */
+    *value = 0;
+    for (size_t i = 0; i < sizeof bytes; ++i) {
+        *value = (*value << 8) | bytes[i];
+    }
+    return true;
+}
+
+static bool reserve(char** buffer, size_t* capacity, size_t size) {
+    if (*capacity >= size) {
+        return true;
+    }
+    char* grown = realloc(*buffer, size);
+    if (!grown) {
+        return false;
+    }
+    *buffer = grown;
+    *capacity = size;
+    return true;
+}
+
+static bool decode_chunk(struct slot* s) {
+    if (s->stored) {
+        return true;
+    }
+    if (s->input_size < 6 || memcmp(s->input, "\xfd" "7zXZ", 6) != 0) {
+        fprintf(stderr, "[error] chunk has no XZ header\n");
+        return false;
+    }
+
+    lzma_stream zs = LZMA_STREAM_INIT;
+    if (lzma_stream_decoder(&zs, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+        fprintf(stderr, "[error] cannot initialize XZ decoder\n");
+        return false;
+    }
+
+    zs.next_in = (const uint8_t*)s->input;
+    zs.avail_in = s->input_size;
+    s->output_size = 0;
+
+    lzma_ret result = LZMA_OK;
+    while (result == LZMA_OK) {
+        /* Chunks are 16 MB when decompressed, buffer of that size is reused by all next chunks of slot. */
+        size_t capacity = s->output_capacity ? s->output_capacity * 2 : PBZX_STORED_CHUNK_SIZE;
+        if (s->output_size == s->output_capacity && !reserve(&s->output, &s->output_capacity, capacity)) {
+            result = LZMA_MEM_ERROR;
+            break;
+        }
+        zs.next_out = (uint8_t*)s->output + s->output_size;
+        zs.avail_out = s->output_capacity - s->output_size;
+        result = lzma_code(&zs, LZMA_FINISH);
+        s->output_size = s->output_capacity - zs.avail_out;
+    }
+    lzma_end(&zs);
+
+    if (result != LZMA_STREAM_END) {
+        fprintf(stderr, "[error] XZ decoding failed with code %d\n", (int)result);
+        return false;
+    }
+    return true;
+}
+
+static void fail(struct pipeline* p) {
+    pthread_mutex_lock(&p->mutex);
+    p->failed = true;
+    pthread_cond_broadcast(&p->changed);
+    pthread_mutex_unlock(&p->mutex);
+}
+
+static void* decode_worker(void* arg) {
+    struct pipeline* p = arg;
+
+    pthread_mutex_lock(&p->mutex);
+    for (;;) {
+        while (!p->failed && p->decode_index == p->read_index && !p->finished) {
+            pthread_cond_wait(&p->changed, &p->mutex);
+        }
+        if (p->failed || p->decode_index == p->read_index) {
+            break;
+        }
+
+        struct slot* s = &p->slots[p->decode_index++ % p->slot_count];
+        s->state = SLOT_DECODING;
+        pthread_mutex_unlock(&p->mutex);
+
+        bool decoded = decode_chunk(s);
+
+        pthread_mutex_lock(&p->mutex);
+        if (!decoded) {
+            p->failed = true;
+        }
+        s->state = SLOT_DECODED;
+        pthread_cond_broadcast(&p->changed);
+    }
+    pthread_mutex_unlock(&p->mutex);
+    return NULL;
+}
+
+static void* write_worker(void* arg) {
+    struct pipeline* p = arg;
+
+    pthread_mutex_lock(&p->mutex);
+    for (;;) {
+        struct slot* s = &p->slots[p->write_index % p->slot_count];
+        while (!p->failed && !(p->write_index < p->read_index && s->state == SLOT_DECODED) &&
+               !(p->finished && p->write_index == p->read_index)) {
+            pthread_cond_wait(&p->changed, &p->mutex);
+        }
+        if (p->failed || p->write_index == p->read_index) {
+            break;
+        }
+        pthread_mutex_unlock(&p->mutex);
+
+        const char* data = s->stored ? s->input : s->output;
+        size_t size = s->stored ? s->input_size : s->output_size;
+        bool written = fwrite(data, 1, size, stdout) == size;
+
+        pthread_mutex_lock(&p->mutex);
+        if (!written) {
+            fprintf(stderr, "[error] cannot write output: %s\n", strerror(errno));
+            p->failed = true;
+            break;
+        }
+        s->state = SLOT_EMPTY;
+        ++p->write_index;
+        pthread_cond_broadcast(&p->changed);
+    }
+    pthread_mutex_unlock(&p->mutex);
+    return NULL;
+}
+
+static bool read_chunks(struct pipeline* p, struct input* in) {
+    char magic[4];
+    uint64_t flags = 0;
+    if (!input_read(in, magic, sizeof magic) || memcmp(magic, "pbzx", 4) != 0 || !input_read_64(in, &flags)) {
+        fprintf(stderr, "[error] not a pbzx stream\n");
+        return false;
+    }
+
+    while (flags & PBZX_MORE_CHUNKS_FLAG) {
+        uint64_t length = 0;
+        if (!input_read_64(in, &flags) || !input_read_64(in, &length) || length > PBZX_MAX_CHUNK_SIZE) {
+            fprintf(stderr, "[error] invalid chunk header\n");
+            return false;
+        }
+
+        pthread_mutex_lock(&p->mutex);
+        struct slot* s = &p->slots[p->read_index % p->slot_count];
+        while (!p->failed && s->state != SLOT_EMPTY) {
+            pthread_cond_wait(&p->changed, &p->mutex);
+        }
+        bool failed = p->failed;
+        pthread_mutex_unlock(&p->mutex);
+
+        if (failed) {
+            return false;
+        }
+
+        /* Slot is owned by reader until its state is changed. */
+        if (!reserve(&s->input, &s->input_capacity, length)) {
+            fprintf(stderr, "[error] out of memory\n");
+            return false;
+        }
+        if (!input_read(in, s->input, length)) {
+            fprintf(stderr, "[error] unexpected end of input\n");
+            return false;
+        }
+        s->input_size = length;
+        s->stored = length == PBZX_STORED_CHUNK_SIZE;
+
+        pthread_mutex_lock(&p->mutex);
+        s->state = SLOT_READ;
+        ++p->read_index;
+        pthread_cond_broadcast(&p->changed);
+        pthread_mutex_unlock(&p->mutex);
+    }
+    return true;
+}
+
+static long job_count(void) {
+    const char* jobs = getenv("PBZX_JOBS");
+    long count = jobs ? strtol(jobs, NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);
+    return count < 1 ? 1 : count > PBZX_MAX_JOBS ? PBZX_MAX_JOBS : count;
+}
+
+int main(int argc, const char** argv) {
+    /* Only [-n] <file> or - arguments are handled here, the rest is up to the original. */
+    bool noxar = false;
+    const char* path = NULL;
+    bool supported = true;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n")) {
+            noxar = true;
+        } else if ((argv[i][0] != '-' || !strcmp(argv[i], "-")) && !path) {
+            path = argv[i];
+        } else {
+            supported = false;
+        }
+    }
+
+    long jobs = job_count();
+    if (!supported || !path || jobs == 1) {
+        return pbzx_serial_main(argc, argv);
+    }
+
+    struct input in = { 0 };
+    if (!strcmp(path, "-")) {
+        in.file = stdin;
+    } else if (noxar) {
+        in.file = fopen(path, "rb");
+        if (!in.file) {
+            fprintf(stderr, "[error] cannot open \"%s\": %s\n", path, strerror(errno));
+            return 1;
+        }
+    } else if (!input_open_xar(&in, path)) {
+        input_close(&in);
+        return 1;
+    }
+
+    /* Two more slots than workers, one of them is read while another one is written. */
+    struct pipeline p = { 0 };
+    p.slot_count = jobs + 2;
+    p.slots = calloc(p.slot_count, sizeof(struct slot));
+    pthread_mutex_init(&p.mutex, NULL);
+    pthread_cond_init(&p.changed, NULL);
+
+    pthread_t workers[PBZX_MAX_JOBS];
+    pthread_t writer;
+    for (long i = 0; i < jobs; ++i) {
+        pthread_create(&workers[i], NULL, decode_worker, &p);
+    }
+    pthread_create(&writer, NULL, write_worker, &p);
+
+    if (!read_chunks(&p, &in)) {
+        fail(&p);
+    }
+
+    pthread_mutex_lock(&p.mutex);
+    p.finished = true;
+    pthread_cond_broadcast(&p.changed);
+    pthread_mutex_unlock(&p.mutex);
+
+    for (long i = 0; i < jobs; ++i) {
+        pthread_join(workers[i], NULL);
+    }
+    pthread_join(writer, NULL);
+
+    bool succeeded = !p.failed && fflush(stdout) == 0;
+
+    for (size_t i = 0; i < p.slot_count; ++i) {
+        free(p.slots[i].input);
+        free(p.slots[i].output);
+    }
+    free(p.slots);
+    pthread_cond_destroy(&p.changed);
+    pthread_mutex_destroy(&p.mutex);
+    input_close(&in);
+
+    return succeeded ? 0 : 1;
+}
@@ -0,0 +1,338 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <glib.h>
+
+// The same source code is linked with quasi-glib and with GLib
+// Run quasi-glib variant with --compare <path to GLib variant> to get both results side by side
+// Comparison also includes sizes of both executables and their launch times
+
+#ifndef BENCH_IMPLEMENTATION
+#   error BENCH_IMPLEMENTATION must be defined
+#endif
+
+constexpr int LOCK_ITERATIONS = 10'000'000;
+constexpr int CONTENDED_THREADS = 4;
+constexpr int CONTENDED_ITERATIONS = 1'000'000;
+constexpr int PING_PONG_ITERATIONS = 100'000;
+constexpr int PRIVATE_ITERATIONS = 10'000'000;
+constexpr int THREAD_ITERATIONS = 1'000;
+constexpr int TIME_ITERATIONS = 10'000'000;
+constexpr int LAUNCH_ITERATIONS = 100;
+
+// Keeps benchmarked calls from being optimized away
+static volatile gint64 BenchmarkSink;
+
+static guint64 Now()
+{
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+static double MutexUncontended()
+{
+    GMutex mutex;
+    g_mutex_init(&mutex);
+
+    const guint64 start = Now();
+
+    for (int i = 0; i < LOCK_ITERATIONS; ++i)
+    {
+        g_mutex_lock(&mutex);
+        g_mutex_unlock(&mutex);
+    }
+
+    const guint64 elapsed = Now() - start;
+    g_mutex_clear(&mutex);
+
+    return double(elapsed) / LOCK_ITERATIONS;
+}
+
+struct ContendedData
+{
+    GMutex mutex;
+    gint64 counter;
+};
+
+static gpointer ContendedFunc(gpointer arg)
+{
+    ContendedData* data = static_cast<ContendedData*>(arg);
+
+    for (int i = 0; i < CONTENDED_ITERATIONS; ++i)
+    {
+        g_mutex_lock(&data->mutex);
+        ++data->counter;
+        g_mutex_unlock(&data->mutex);
+    }
+
+    return nullptr;
+}
+
+static double MutexContended()
+{
+    ContendedData data = {};
+    g_mutex_init(&data.mutex);
+
+    GThread* threads[CONTENDED_THREADS];
+    const guint64 start = Now();
+
+    for (GThread*& thread : threads)
+        thread = g_thread_try_new("bench-contended", ContendedFunc, &data, nullptr);
+
+    for (GThread* thread : threads)
+        g_thread_join(thread);
+
+    const guint64 elapsed = Now() - start;
+    g_mutex_clear(&data.mutex);
+
+    if (data.counter != CONTENDED_THREADS * CONTENDED_ITERATIONS)
+    {
+        fprintf(stderr, "Contended counter mismatch\n");
+        exit(1);
+    }
+
+    return double(elapsed) / (CONTENDED_THREADS * CONTENDED_ITERATIONS);
+}
+
+static double RecMutexReentry()
+{
+    GRecMutex mutex;
+    g_rec_mutex_init(&mutex);
+    g_rec_mutex_lock(&mutex);
+
+    const guint64 start = Now();
+
+    for (int i = 0; i < LOCK_ITERATIONS; ++i)
+    {
+        g_rec_mutex_lock(&mutex);
+        g_rec_mutex_unlock(&mutex);
+    }
+
+    const guint64 elapsed = Now() - start;
+
+    g_rec_mutex_unlock(&mutex);
+    g_rec_mutex_clear(&mutex);
+
+    return double(elapsed) / LOCK_ITERATIONS;
+}
+
+struct PingPongData
+{
+    GMutex mutex;
+    GCond cond;
+    int turn;
+};
+
+static gpointer PongFunc(gpointer arg)
+{
+    PingPongData* data = static_cast<PingPongData*>(arg);
+    g_mutex_lock(&data->mutex);
+
+    for (int i = 0; i < PING_PONG_ITERATIONS; ++i)
+    {
+        while (data->turn != 1)
+            g_cond_wait(&data->cond, &data->mutex);
+
+        data->turn = 0;
+        g_cond_signal(&data->cond);
+    }
+
+    g_mutex_unlock(&data->mutex);
+    return nullptr;
+}
+
+static double CondPingPong()
+{
+    PingPongData data = {};
+    g_mutex_init(&data.mutex);
+    g_cond_init(&data.cond);
+
+    GThread* thread = g_thread_try_new("bench-pong", PongFunc, &data, nullptr);
+    const guint64 start = Now();
+
+    g_mutex_lock(&data.mutex);
+
+    for (int i = 0; i < PING_PONG_ITERATIONS; ++i)
+    {
+        data.turn = 1;
+        g_cond_signal(&data.cond);
+
+        while (data.turn != 0)
+            g_cond_wait(&data.cond, &data.mutex);
+    }
+
+    g_mutex_unlock(&data.mutex);
+
+    const guint64 elapsed = Now() - start;
+
+    g_thread_join(thread);
+    g_cond_clear(&data.cond);
+    g_mutex_clear(&data.mutex);
+
+    return double(elapsed) / PING_PONG_ITERATIONS;
+}
+
+static GPrivate BenchPrivate = G_PRIVATE_INIT(nullptr);
+
+static double PrivateGet()
+{
+    g_private_set(&BenchPrivate, &BenchPrivate);
+
+    gint64 sink = 0;
+    const guint64 start = Now();
+
+    for (int i = 0; i < PRIVATE_ITERATIONS; ++i)
+        sink += gintptr(g_private_get(&BenchPrivate));
+
+    const guint64 elapsed = Now() - start;
+    BenchmarkSink = sink;
+
+    return double(elapsed) / PRIVATE_ITERATIONS;
+}
+
+static double PrivateSet()
+{
+    const guint64 start = Now();
+
+    for (int i = 0; i < PRIVATE_ITERATIONS; ++i)
+        g_private_set(&BenchPrivate, GINT_TO_POINTER(i));
+
+    return double(Now() - start) / PRIVATE_ITERATIONS;
+}
+
+static gpointer EmptyFunc(gpointer)
+{
+    return nullptr;
+}
+
+static double ThreadCreateJoin()
+{
+    const guint64 start = Now();
+
+    for (int i = 0; i < THREAD_ITERATIONS; ++i)
+    {
+        GThread* thread = g_thread_try_new("bench-empty", EmptyFunc, nullptr, nullptr);
+        g_thread_join(thread);
+    }
+
+    return double(Now() - start) / THREAD_ITERATIONS;
+}
+
+static double MonotonicTime()
+{
+    gint64 sink = 0;
+    const guint64 start = Now();
+
+    for (int i = 0; i < TIME_ITERATIONS; ++i)
+        sink += g_get_monotonic_time();
+
+    const guint64 elapsed = Now() - start;
+    BenchmarkSink = sink;
+
+    return double(elapsed) / TIME_ITERATIONS;
+}
+
+static void PrintResults(FILE* output)
+{
+    static const struct
+    {
+        const char* name;
+        double (*function)();
+    }
+    BENCHMARKS[] =
+    {
+        { "mutex_uncontended_ns", MutexUncontended },
+        { "mutex_contended_ns", MutexContended },
+        { "rec_mutex_reentry_ns", RecMutexReentry },
+        { "cond_ping_pong_ns", CondPingPong },
+        { "private_get_ns", PrivateGet },
+        { "private_set_ns", PrivateSet },
+        { "thread_create_join_ns", ThreadCreateJoin },
+        { "monotonic_time_ns", MonotonicTime },
+    };
+
+    fprintf(output, "{\"implementation\": \"%s\", \"results\": {", BENCH_IMPLEMENTATION);
+
+    for (size_t i = 0; i < sizeof BENCHMARKS / sizeof BENCHMARKS[0]; ++i)
+        fprintf(output, "%s\"%s\": %.3f", i == 0 ? "" : ", ", BENCHMARKS[i].name, BENCHMARKS[i].function());
+
+    fprintf(output, "}}");
+}
+
+extern char** environ;
+
+// Returns average time in microseconds to start the executable which exits immediately
+static double LaunchTime(const char* path)
+{
+    char* const argv[] = { const_cast<char*>(path), const_cast<char*>("--launch"), nullptr };
+    const guint64 start = Now();
+
+    for (int i = 0; i < LAUNCH_ITERATIONS; ++i)
+    {
+        pid_t pid;
+        int status;
+
+        if (posix_spawn(&pid, path, nullptr, nullptr, argv, environ) != 0 || waitpid(pid, &status, 0) != pid)
+        {
+            fprintf(stderr, "Failed to launch %s\n", path);
+            exit(1);
+        }
+    }
+
+    return double(Now() - start) / LAUNCH_ITERATIONS / 1000.0;
+}
+
+static long long BinarySize(const char* path)
+{
+    struct stat s;
+    return stat(path, &s) == 0 ? s.st_size : -1;
+}
+
+static int Compare(const char* self, const char* path)
+{
+    FILE* pipe = popen(path, "r");
+
+    if (pipe == nullptr)
+    {
+        fprintf(stderr, "Failed to run %s\n", path);
+        return 1;
+    }
+
+    char other[4096] = {};
+    const size_t length = fread(other, 1, sizeof other - 1, pipe);
+
+    if (pclose(pipe) != 0 || length == 0)
+    {
+        fprintf(stderr, "Failed to get results from %s\n", path);
+        return 1;
+    }
+
+    // Strip trailing newline
+    other[strcspn(other, "\n")] = '\0';
+
+    printf("{\"benchmarks\": [");
+    PrintResults(stdout);
+    printf(", %s], ", other);
+
+    printf("\"binary_size\": {\"%s\": %lld, \"glib\": %lld}, ", BENCH_IMPLEMENTATION, BinarySize(self), BinarySize(path));
+    printf("\"launch_time_us\": {\"%s\": %.1f, \"glib\": %.1f}}\n", BENCH_IMPLEMENTATION, LaunchTime(self), LaunchTime(path));
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 2 && strcmp(argv[1], "--launch") == 0)
+        return 0;
+
+    if (argc == 3 && strcmp(argv[1], "--compare") == 0)
+        return Compare(argv[0], argv[2]);
+
+    PrintResults(stdout);
+    printf("\n");
+
+    return 0;
+}
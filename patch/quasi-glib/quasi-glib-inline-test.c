@@ -0,0 +1,70 @@
+#include <assert.h>
+
+#include "quasi-glib-inline.h"
+
+// Inline fast paths must interoperate with out-of-line functions, names in parentheses bypass the macros
+
+static GMutex inlineMutex;
+static GCond inlineCond;
+static int inlineCounter;
+
+static gpointer InlineThreadFunc(gpointer arg)
+{
+    for (int i = 0; i < 100000; ++i)
+    {
+        g_mutex_lock(&inlineMutex);
+        ++inlineCounter;
+        g_mutex_unlock(&inlineMutex);
+    }
+
+    g_mutex_lock(&inlineMutex);
+    g_cond_signal(&inlineCond);
+    g_mutex_unlock(&inlineMutex);
+
+    return arg;
+}
+
+void TestInline(void)
+{
+    g_mutex_lock(&inlineMutex);
+    assert(!(g_mutex_trylock)(&inlineMutex));
+    g_mutex_unlock(&inlineMutex);
+
+    (g_mutex_lock)(&inlineMutex);
+    assert(!g_mutex_trylock(&inlineMutex));
+    (g_mutex_unlock)(&inlineMutex);
+
+    assert(g_mutex_trylock(&inlineMutex));
+    g_mutex_unlock(&inlineMutex);
+
+    // Contended locking goes through os_unfair_lock functions, g_cond_wait() unlocks and relocks out-of-line
+    g_mutex_lock(&inlineMutex);
+
+    GThread* threads[4];
+
+    for (int i = 0; i < 4; ++i)
+        threads[i] = g_thread_new("quasi-glib-inline-test", InlineThreadFunc, NULL);
+
+    while (inlineCounter < 4 * 100000)
+        g_cond_wait(&inlineCond, &inlineMutex);
+
+    g_mutex_unlock(&inlineMutex);
+
+    for (int i = 0; i < 4; ++i)
+        g_thread_join(threads[i]);
+
+    assert(inlineCounter == 4 * 100000);
+
+    // Both unassigned and assigned keys
+    GPrivate tls = G_PRIVATE_INIT(NULL);
+    assert(g_private_get(&tls) == NULL);
+
+    g_private_set(&tls, &tls);
+    assert(g_private_get(&tls) == &tls);
+    assert((g_private_get)(&tls) == &tls);
+
+    const gint64 before = (g_get_monotonic_time)();
+    const gint64 now = g_get_monotonic_time();
+    const gint64 after = (g_get_monotonic_time)();
+    assert(before <= now && now <= after);
+}
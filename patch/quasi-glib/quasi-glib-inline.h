@@ -0,0 +1,119 @@
+#ifndef QUASI_GLIB_INLINE_H
+#define QUASI_GLIB_INLINE_H
+
+// Inline fast paths of the hottest quasi-glib primitives for libraries compiled against GLib headers
+// Include it instead of glib.h, or force it with -include, then calls below don't leave the call site
+// unless a lock is contended, a private key is not assigned yet, or timebase is queried for the first time
+//
+// Code compiled with this header depends on data layouts of quasi-glib, it must never be linked with GLib
+// Every translation unit references quasi_glib_inline_abi, so such link fails with undefined symbol
+// Inlined mutex operations are not counted when quasi-glib is built with QUASI_GLIB_LOCK_STATS option
+
+#include <glib.h>
+#include <os/lock.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <mach/mach_time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const int quasi_glib_inline_abi;
+
+__attribute__((used)) static const int* const quasi_glib_inline_abi_ref = &quasi_glib_inline_abi;
+
+// Mach port of the current thread from its TSD slot, os_unfair_lock stores it as owner of locked lock
+static inline __attribute__((always_inline)) uint32_t quasi_glib_thread_port(void)
+{
+    enum { TSD_MACH_THREAD_SELF = 3 };
+
+#if defined(__aarch64__)
+    uintptr_t tsd;
+    __asm__ ("mrs %0, tpidrro_el0" : "=r"(tsd));
+    return (uint32_t)((const uintptr_t*)(tsd & ~(uintptr_t)7))[TSD_MACH_THREAD_SELF];
+#elif defined(__x86_64__)
+    uintptr_t port;
+    __asm__ ("movq %%gs:%1, %0" : "=r"(port) : "m"(*(uintptr_t*)(TSD_MACH_THREAD_SELF * sizeof(uintptr_t))));
+    return (uint32_t)port;
+#else
+#error Unsupported architecture
+#endif
+}
+
+// GMutex is os_unfair_lock placed in i[0], see quasi-glib.cpp
+// Uncontended lock and unlock are single compare-and-swap, any other state is left to os_unfair_lock functions
+static inline __attribute__((always_inline)) void quasi_glib_mutex_lock(GMutex* mutex)
+{
+    guint expected = 0;
+
+    if (__builtin_expect(!__atomic_compare_exchange_n(&mutex->i[0], &expected, quasi_glib_thread_port(),
+        0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED), 0))
+    {
+        os_unfair_lock_lock((os_unfair_lock*)&mutex->i[0]);
+    }
+}
+
+static inline __attribute__((always_inline)) gboolean quasi_glib_mutex_trylock(GMutex* mutex)
+{
+    guint expected = 0;
+
+    return __atomic_compare_exchange_n(&mutex->i[0], &expected, quasi_glib_thread_port(),
+        0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static inline __attribute__((always_inline)) void quasi_glib_mutex_unlock(GMutex* mutex)
+{
+    // Lock word differs from owner's port when there are waiters, they are woken by os_unfair_lock_unlock()
+    guint expected = quasi_glib_thread_port();
+
+    if (__builtin_expect(!__atomic_compare_exchange_n(&mutex->i[0], &expected, 0,
+        0, __ATOMIC_RELEASE, __ATOMIC_RELAXED), 0))
+    {
+        os_unfair_lock_unlock((os_unfair_lock*)&mutex->i[0]);
+    }
+}
+
+// GPrivate stores pthread key plus one in p, unassigned key is handled by out-of-line function
+static inline __attribute__((always_inline)) gpointer quasi_glib_private_get(GPrivate* key)
+{
+    const uintptr_t impl = __atomic_load_n((const uintptr_t*)&key->p, __ATOMIC_RELAXED);
+    return __builtin_expect(impl != 0, 1) ? pthread_getspecific((pthread_key_t)(impl - 1)) : (g_private_get)(key);
+}
+
+// Timebase is cached per translation unit, querying it more than once is harmless
+static uint64_t quasi_glib_inline_timebase;
+
+static inline __attribute__((always_inline)) gint64 quasi_glib_get_monotonic_time(void)
+{
+    uint64_t timebase = __atomic_load_n(&quasi_glib_inline_timebase, __ATOMIC_RELAXED);
+
+    if (__builtin_expect(timebase == 0, 0))
+    {
+        mach_timebase_info_data_t info;
+        mach_timebase_info(&info);
+
+        timebase = ((uint64_t)info.numer << 32) | info.denom;
+        __atomic_store_n(&quasi_glib_inline_timebase, timebase, __ATOMIC_RELAXED);
+    }
+
+    const uint64_t ticks = mach_absolute_time();
+    const uint32_t numer = (uint32_t)(timebase >> 32);
+    const uint32_t denom = (uint32_t)timebase;
+
+    // Exact value of floor(ticks * numer / denom) like quasi_glib_monotonic_ns() computes it
+    const uint64_t ns = numer == denom ? ticks : ticks / denom * numer + ticks % denom * numer / denom;
+    return (gint64)(ns / 1000);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#define g_mutex_lock(mutex) quasi_glib_mutex_lock(mutex)
+#define g_mutex_trylock(mutex) quasi_glib_mutex_trylock(mutex)
+#define g_mutex_unlock(mutex) quasi_glib_mutex_unlock(mutex)
+#define g_private_get(key) quasi_glib_private_get(key)
+#define g_get_monotonic_time() quasi_glib_get_monotonic_time()
+
+#endif
@@ -1,8 +1,23 @@
 
 #include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <glib.h>
+#include <mach/mach_time.h>
+#include <unistd.h>
 
+#include "quasi-glib.h"
+
+// Defined in quasi-glib-inline-test.c, which is compiled with inline fast paths
+extern "C" void TestInline();
+
+constexpr const char* THREAD_NAME = "quasi-glib-test";
 constexpr int REC_MUTEX_LOCK_COUNT = 4;
+constexpr int BENCHMARK_ITERATIONS = 1'000'000;
+
+// Keeps benchmarked calls from being optimized away
+static volatile gint64 BenchmarkSink;
 
 struct ThreadData
 {
@@ -18,6 +33,12 @@ static void* ThreadFunc(void* arg)
     ThreadData* threadData = reinterpret_cast<ThreadData*>(arg);
     GPrivate* tls = threadData->tls;
 
+    {
+        char name[64] = {};
+        pthread_getname_np(pthread_self(), name, sizeof name);
+        assert(strcmp(name, THREAD_NAME) == 0);
+    }
+
     {
         assert(g_private_get(tls) == nullptr);
 
@@ -40,6 +61,404 @@ static void* ThreadFunc(void* arg)
     return nullptr;
 }
 
+// Copy of g_get_monotonic_time() from GLib 2.72 for comparison, it cannot be linked together with quasi-glib
+static gint64 ReferenceMonotonicTime()
+{
+    mach_timebase_info_data_t timebase_info;
+    guint64 val;
+
+    mach_timebase_info(&timebase_info);
+    val = mach_absolute_time();
+
+    if (timebase_info.numer != timebase_info.denom)
+        val = (__uint128_t(val) * timebase_info.numer) / timebase_info.denom / 1000;
+    else
+        val = val / 1000;
+
+    return val;
+}
+
+template <typename F>
+static void Benchmark(const char* name, F function)
+{
+    gint64 sink = 0;
+    const gint64 start = quasi_glib_monotonic_ns();
+
+    for (int i = 0; i < BENCHMARK_ITERATIONS; ++i)
+        sink += function();
+
+    const gint64 elapsed = quasi_glib_monotonic_ns() - start;
+    BenchmarkSink = sink;
+
+    printf("%s: %.2f ns/call\n", name, double(elapsed) / BENCHMARK_ITERATIONS);
+}
+
+static void BenchmarkMonotonicTime()
+{
+    const gint64 ns = quasi_glib_monotonic_ns();
+    const gint64 us = g_get_monotonic_time();
+    const gint64 reference_us = ReferenceMonotonicTime();
+    assert(ns > 0 && us >= ns / 1000 && reference_us >= us);
+
+    Benchmark("GLib g_get_monotonic_time()", ReferenceMonotonicTime);
+    Benchmark("quasi-glib g_get_monotonic_time()", g_get_monotonic_time);
+    Benchmark("quasi-glib quasi_glib_monotonic_ns()", quasi_glib_monotonic_ns);
+}
+
+constexpr int SLEEP_ITERATIONS = 200;
+constexpr gulong SLEEP_DURATION_US = 500;
+
+template <typename F>
+static void MeasureSleepJitter(const char* name, F function)
+{
+    gint64 total = 0;
+    gint64 worst = 0;
+
+    for (int i = 0; i < SLEEP_ITERATIONS; ++i)
+    {
+        const gint64 start = quasi_glib_monotonic_ns();
+        function(SLEEP_DURATION_US);
+        const gint64 overshoot = quasi_glib_monotonic_ns() - start - gint64(SLEEP_DURATION_US) * 1000;
+
+        // Sleep must never return early
+        assert(overshoot >= 0);
+
+        total += overshoot;
+        worst = overshoot > worst ? overshoot : worst;
+    }
+
+    printf("%s(%lu): average overshoot %.1f us, worst %.1f us\n",
+        name, SLEEP_DURATION_US, total / 1000.0 / SLEEP_ITERATIONS, worst / 1000.0);
+}
+
+static void MeasureSleep()
+{
+    MeasureSleepJitter("usleep", [](gulong us) { usleep(useconds_t(us)); });
+    MeasureSleepJitter("g_usleep", g_usleep);
+}
+
+constexpr gsize SLICE_SIZE = 48;
+
+struct Blocks
+{
+    void* block;
+    void* slice;
+};
+
+static void* FreeFunc(void* arg)
+{
+    Blocks* blocks = static_cast<Blocks*>(arg);
+    g_free(blocks->block);
+    g_slice_free1(SLICE_SIZE, blocks->slice);
+    return nullptr;
+}
+
+static void TestAllocator()
+{
+    for (gsize size = 1; size <= 4096; size = size * 3 / 2 + 1)
+    {
+        void* blocks[256];
+
+        for (void*& block : blocks)
+        {
+            block = g_malloc(size);
+            assert(block != nullptr && (guintptr(block) & 15) == 0);
+            memset(block, 0x55, size);
+        }
+
+        for (void* block : blocks)
+            g_free(block);
+
+        void* slice = g_slice_alloc0(size);
+        assert(slice != nullptr && static_cast<char*>(slice)[size - 1] == 0);
+        g_slice_free1(size, slice);
+    }
+
+    // Blocks allocated by one thread can be freed by another one
+    Blocks blocks = { g_malloc(64), g_slice_alloc(SLICE_SIZE) };
+
+    GThread* thread = g_thread_try_new("", FreeFunc, &blocks, nullptr);
+    assert(thread);
+    g_thread_join(thread);
+}
+
+static void PoolFunc(gpointer data, gpointer user_data)
+{
+    g_atomic_int_add(static_cast<gint*>(user_data), GPOINTER_TO_INT(data));
+}
+
+static void TestThreadPool()
+{
+    constexpr int TASK_COUNT = 100;
+    gint sum = 0;
+
+    GThreadPool* pool = g_thread_pool_new(PoolFunc, &sum, 4, FALSE, nullptr);
+    assert(pool);
+
+    for (int i = 1; i <= TASK_COUNT; ++i)
+    {
+        const gboolean pushed = g_thread_pool_push(pool, GINT_TO_POINTER(i), nullptr);
+        assert(pushed);
+    }
+
+    const gboolean updated = g_thread_pool_set_max_threads(pool, 2, nullptr);
+    assert(updated && g_thread_pool_get_max_threads(pool) == 2);
+
+    g_thread_pool_free(pool, FALSE, TRUE);
+    assert(sum == TASK_COUNT * (TASK_COUNT + 1) / 2);
+}
+
+constexpr int QUEUE_PRODUCERS = 4;
+constexpr int QUEUE_ITEMS_PER_PRODUCER = 10'000;
+
+static gpointer QueueProducerFunc(gpointer arg)
+{
+    GAsyncQueue* queue = static_cast<GAsyncQueue*>(arg);
+
+    // Zero cannot be pushed, and the total number of items exceeds queue capacity to make producers wait
+    for (int i = 1; i <= QUEUE_ITEMS_PER_PRODUCER; ++i)
+        g_async_queue_push(queue, GINT_TO_POINTER(i));
+
+    return nullptr;
+}
+
+static void TestAsyncQueue()
+{
+    GAsyncQueue* queue = g_async_queue_new();
+    assert(g_async_queue_try_pop(queue) == nullptr);
+    assert(g_async_queue_length(queue) == 0);
+
+    const gint64 start = g_get_monotonic_time();
+    assert(g_async_queue_timeout_pop(queue, 1000) == nullptr);
+    assert(g_get_monotonic_time() - start >= 1000);
+
+    GThread* producers[QUEUE_PRODUCERS];
+
+    for (GThread*& producer : producers)
+        producer = g_thread_try_new("queue-producer", QueueProducerFunc, queue, nullptr);
+
+    gint64 sum = 0;
+
+    for (int i = 0; i < QUEUE_PRODUCERS * QUEUE_ITEMS_PER_PRODUCER; ++i)
+        sum += GPOINTER_TO_INT(g_async_queue_pop(queue));
+
+    for (GThread* producer : producers)
+        g_thread_join(producer);
+
+    assert(sum == gint64(QUEUE_PRODUCERS) * QUEUE_ITEMS_PER_PRODUCER * (QUEUE_ITEMS_PER_PRODUCER + 1) / 2);
+    assert(g_async_queue_length(queue) == 0);
+
+    g_async_queue_push(queue, queue);
+    assert(g_async_queue_length(queue) == 1);
+    assert(g_async_queue_timeout_pop(queue, 1000) == queue);
+
+    g_async_queue_unref(queue);
+}
+
+static void TestHashTable()
+{
+    constexpr int ENTRY_COUNT = 1000;
+
+    GHashTable* table = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    for (int i = 1; i <= ENTRY_COUNT; ++i)
+        g_hash_table_insert(table, GINT_TO_POINTER(i), GINT_TO_POINTER(-i));
+
+    for (int i = 2; i <= ENTRY_COUNT; i += 2)
+    {
+        const gboolean removed = g_hash_table_remove(table, GINT_TO_POINTER(i));
+        assert(removed);
+    }
+
+    assert(g_hash_table_size(table) == ENTRY_COUNT / 2);
+
+    for (int i = 1; i <= ENTRY_COUNT; ++i)
+        assert(g_hash_table_lookup(table, GINT_TO_POINTER(i)) == (i % 2 ? GINT_TO_POINTER(-i) : nullptr));
+
+    GHashTableIter iter;
+    gpointer key, value;
+    guint visited = 0;
+
+    g_hash_table_iter_init(&iter, table);
+
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+        assert(GPOINTER_TO_INT(key) == -GPOINTER_TO_INT(value));
+        ++visited;
+    }
+
+    assert(visited == ENTRY_COUNT / 2);
+    g_hash_table_unref(table);
+
+    // Keys and values are owned by the table, replaced and removed ones must be freed
+    table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    g_hash_table_insert(table, g_strdup("key"), g_strdup("first"));
+    g_hash_table_insert(table, g_strdup("key"), g_strdup("second"));
+    g_hash_table_replace(table, g_strdup("other"), g_strdup("third"));
+    assert(g_hash_table_size(table) == 2);
+    assert(strcmp(static_cast<char*>(g_hash_table_lookup(table, "key")), "second") == 0);
+    assert(g_hash_table_contains(table, "other") && !g_hash_table_contains(table, "none"));
+    g_hash_table_destroy(table);
+}
+
+static void TestString()
+{
+    GString* string = g_string_new("abc");
+    g_string_append(string, "def");
+    g_string_append_c(string, 'g');
+    g_string_prepend(string, "_");
+    assert(strcmp(string->str, "_abcdefg") == 0 && string->len == 8);
+
+    // Inserted value may be a part of the string itself
+    g_string_insert_len(string, 3, string->str + 1, 4);
+    assert(strcmp(string->str, "_ababcdcdefg") == 0);
+
+    g_string_truncate(string, 3);
+    g_string_append_printf(string, "%d-%s", 42, "long enough formatted text to go beyond the size of any stack buffer, "
+        "long enough formatted text to go beyond the size of any stack buffer, "
+        "long enough formatted text to go beyond the size of any stack buffer, "
+        "long enough formatted text to go beyond the size of any stack buffer");
+    assert(strncmp(string->str, "_ab42-long", 10) == 0 && string->len == strlen(string->str));
+
+    gchar* segment = g_string_free(string, FALSE);
+    assert(strncmp(segment, "_ab", 3) == 0);
+    g_free(segment);
+}
+
+static void TestArray()
+{
+    GArray* array = g_array_new(TRUE, TRUE, sizeof(gint));
+
+    for (gint i = 0; i < 100; ++i)
+        g_array_append_val(array, i);
+
+    g_array_remove_index(array, 0);
+    g_array_remove_index_fast(array, 0);
+    assert(array->len == 98);
+    assert(g_array_index(array, gint, 0) == 99 && g_array_index(array, gint, 1) == 2);
+    assert(g_array_index(array, gint, array->len) == 0);
+
+    g_array_set_size(array, 200);
+    assert(g_array_index(array, gint, 150) == 0);
+
+    g_array_free(array, TRUE);
+}
+
+static gint CompareInts(gconstpointer a, gconstpointer b)
+{
+    return GPOINTER_TO_INT(a) - GPOINTER_TO_INT(b);
+}
+
+static void TestList()
+{
+    GList* list = nullptr;
+
+    for (gint i = 0; i < 10; ++i)
+        list = i % 2 ? g_list_append(list, GINT_TO_POINTER(i)) : g_list_prepend(list, GINT_TO_POINTER(i));
+
+    assert(g_list_length(list) == 10);
+
+    list = g_list_sort(list, CompareInts);
+
+    for (gint i = 0; i < 10; ++i)
+        assert(GPOINTER_TO_INT(g_list_nth_data(list, i)) == i);
+
+    list = g_list_remove(list, GINT_TO_POINTER(5));
+    list = g_list_reverse(list);
+    assert(g_list_length(list) == 9 && GPOINTER_TO_INT(list->data) == 9 && list->prev == nullptr);
+    assert(g_list_last(list)->next == nullptr && GPOINTER_TO_INT(g_list_last(list)->data) == 0);
+    assert(g_list_index(list, GINT_TO_POINTER(4)) == 4);
+
+    g_list_free(list);
+}
+
+static gpointer OnceFunc(gpointer arg)
+{
+    ++*static_cast<int*>(arg);
+    return arg;
+}
+
+static void TestAtomicAndOnce()
+{
+    // Parentheses prevent expansion of GLib macros, so exported functions are called
+    gint value = 0;
+    (g_atomic_int_set)(&value, 1);
+    (g_atomic_int_inc)(&value);
+    assert((g_atomic_int_add)(&value, 2) == 2 && (g_atomic_int_get)(&value) == 4);
+    assert(!(g_atomic_int_dec_and_test)(&value));
+    assert((g_atomic_int_compare_and_exchange)(&value, 3, 0) && value == 0);
+
+    gpointer pointer = nullptr;
+    assert((g_atomic_pointer_compare_and_exchange)(&pointer, nullptr, &value) && (g_atomic_pointer_get)(&pointer) == &value);
+
+    static GOnce once = G_ONCE_INIT;
+    int calls = 0;
+    assert(g_once(&once, OnceFunc, &calls) == &calls);
+    assert(g_once(&once, OnceFunc, &calls) == &calls && calls == 1);
+
+    static gsize initialized = 0;
+
+    if ((g_once_init_enter)(&initialized))
+        g_once_init_leave(&initialized, 42);
+
+    assert(!(g_once_init_enter)(&initialized) && initialized == 42);
+}
+
+static void TestShellParse()
+{
+    gint argc = 0;
+    gchar** argv = nullptr;
+
+    const gboolean parsed = g_shell_parse_argv("load 'my font.sf2' \"a \\\"b\\\"\" c\\ d # comment", &argc, &argv, nullptr);
+    assert(parsed && argc == 4);
+    assert(strcmp(argv[0], "load") == 0 && strcmp(argv[1], "my font.sf2") == 0);
+    assert(strcmp(argv[2], "a \"b\"") == 0 && strcmp(argv[3], "c d") == 0 && argv[4] == nullptr);
+    g_strfreev(argv);
+
+    GError* error = nullptr;
+    const gboolean unbalanced = g_shell_parse_argv("'unbalanced", &argc, &argv, &error);
+    assert(!unbalanced && error != nullptr && error->code == G_SHELL_ERROR_BAD_QUOTING);
+    g_clear_error(&error);
+
+    const gboolean empty = g_shell_parse_argv("  ", &argc, &argv, &error);
+    assert(!empty && error != nullptr && error->code == G_SHELL_ERROR_EMPTY_STRING);
+    g_clear_error(&error);
+}
+
+static void TestContainers()
+{
+    TestHashTable();
+    TestString();
+    TestArray();
+    TestList();
+    TestAtomicAndOnce();
+    TestShellParse();
+}
+
+static void CheckFileTests()
+{
+    // On macOS, /tmp is a symbolic link to /private/tmp
+    assert(g_file_test("/tmp", G_FILE_TEST_IS_SYMLINK));
+    assert(g_file_test("/tmp", G_FILE_TEST_IS_DIR));
+    assert(g_file_test("/private/tmp", G_FILE_TEST_IS_DIR));
+    assert(!g_file_test("/private/tmp", G_FILE_TEST_IS_SYMLINK));
+    assert(g_file_test("/bin/sh", G_FILE_TEST_IS_REGULAR));
+    assert(g_file_test("/bin/sh", G_FILE_TEST_IS_EXECUTABLE));
+    assert(!g_file_test("/bin/sh", G_FILE_TEST_IS_DIR));
+    assert(!g_file_test("/etc/hosts", G_FILE_TEST_IS_EXECUTABLE));
+    assert(!g_file_test("/nonexistent", G_FILE_TEST_EXISTS));
+    assert(!g_file_test("/nonexistent", GFileTest(G_FILE_TEST_IS_SYMLINK | G_FILE_TEST_EXISTS)));
+}
+
+static void TestFileTest()
+{
+    // The first query determines whether the cache is used
+    // Initial checks populate the cache, and the repeated ones are answered from it
+    setenv("QUASI_GLIB_FILE_TEST_CACHE", "1", 1);
+    CheckFileTests();
+    CheckFileTests();
+}
+
 int main()
 {
     g_clear_error(nullptr);
@@ -47,18 +466,34 @@ int main()
     assert(g_file_test(nullptr, GFileTest(0)) == 0);
     assert(g_get_monotonic_time() > 0);
 
+    BenchmarkMonotonicTime();
+    MeasureSleep();
+
     GRecMutex recMutex;
     g_rec_mutex_init(&recMutex);
 
     for (int i = 0; i < REC_MUTEX_LOCK_COUNT; ++i)
         g_rec_mutex_lock(&recMutex);
 
+    const gboolean recLocked = g_rec_mutex_trylock(&recMutex);
+    assert(recLocked);
+    g_rec_mutex_unlock(&recMutex);
+
     GCond cond;
     g_cond_init(&cond);
 
     GMutex mutex;
     g_mutex_init(&mutex);
 
+    {
+        // Zero-initialized mutex must be usable without g_mutex_init()
+        GMutex staticMutex = {};
+        const gboolean locked = g_mutex_trylock(&staticMutex);
+        const gboolean relocked = g_mutex_trylock(&staticMutex);
+        assert(locked && !relocked);
+        g_mutex_unlock(&staticMutex);
+    }
+
     GPrivate tls = G_PRIVATE_INIT(nullptr);
     {
         assert(g_private_get(&tls) == nullptr);
@@ -71,7 +506,7 @@ int main()
 
     ThreadData threadData = { &cond, &mutex, &recMutex, &tls, false };
 
-    GThread* thread = g_thread_try_new("", ThreadFunc, &threadData, nullptr);
+    GThread* thread = g_thread_try_new(THREAD_NAME, ThreadFunc, &threadData, nullptr);
     assert(thread);
 
     g_usleep(10'000);
@@ -82,6 +517,16 @@ int main()
     g_mutex_unlock(&mutex);
 
     g_cond_broadcast(&cond);
+
+    {
+        // Nobody signals the condition, so wait must time out eventually, spurious wakeups are allowed
+        g_mutex_lock(&mutex);
+        const gint64 endTime = g_get_monotonic_time() + 1'000;
+        while (g_cond_wait_until(&cond, &mutex, endTime));
+        assert(g_get_monotonic_time() >= endTime);
+        g_mutex_unlock(&mutex);
+    }
+
     g_cond_clear(&cond);
 
     for (int i = 0; i < REC_MUTEX_LOCK_COUNT; ++i)
@@ -92,4 +537,11 @@ int main()
 
     g_mutex_clear(&mutex);
     g_rec_mutex_clear(&recMutex);
+
+    TestAllocator();
+    TestThreadPool();
+    TestFileTest();
+    TestAsyncQueue();
+    TestContainers();
+    TestInline();
 }
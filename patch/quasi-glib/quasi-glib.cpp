@@ -1,426 +1,3748 @@
 
+#include <errno.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include <type_traits>
+#include <utility>
+
+#include <dispatch/dispatch.h>
+#include <os/lock.h>
+#include <fcntl.h>
 #include <pthread.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <mach/mach.h>
 #include <mach/mach_time.h>
+#include <pthread/qos.h>
+
+#include "quasi-glib.h"
+
+
+extern "C"
+{
+
+#ifdef QUASI_GLIB_SLAB_ALLOCATOR
+
+// Small blocks are served from per-thread free lists of fixed size classes
+// Free lists are refilled from and drained to global per-class depots in batches
+// Depots carve new blocks from large chunks, and memory of chunks is never returned to the system
+
+constexpr size_t SLAB_CLASS_SIZES[] = { 16, 32, 48, 64, 80, 96, 128, 160, 192, 256, 320, 384, 512, 768, 1024 };
+constexpr size_t SLAB_CLASS_COUNT = sizeof SLAB_CLASS_SIZES / sizeof SLAB_CLASS_SIZES[0];
+constexpr size_t SLAB_GRANULARITY = 16;
+constexpr size_t SLAB_MAX_SIZE = SLAB_CLASS_SIZES[SLAB_CLASS_COUNT - 1];
+constexpr size_t SLAB_CHUNK_SIZE = 64 * 1024;
+constexpr unsigned int SLAB_BATCH_SIZE = 32;
+constexpr unsigned int SLAB_CACHE_LIMIT = SLAB_BATCH_SIZE * 4;
+
+// Header of g_malloc() blocks, it keeps 16 bytes alignment guaranteed by the system allocator
+constexpr size_t SLAB_HEADER_SIZE = 16;
+constexpr size_t SLAB_LARGE_CLASS = ~size_t(0);
+
+struct GSlabBlock
+{
+    GSlabBlock* next;
+};
+
+struct GSlabDepot
+{
+    os_unfair_lock lock;
+    GSlabBlock* blocks;
+    char* chunk;
+    size_t chunk_size;
+};
+
+struct GSlabCache
+{
+    GSlabBlock* blocks[SLAB_CLASS_COUNT];
+    unsigned int counts[SLAB_CLASS_COUNT];
+    bool registered;
+};
+
+static GSlabDepot g_slab_depots[SLAB_CLASS_COUNT];
+static __thread GSlabCache g_slab_cache;
+
+static pthread_key_t g_slab_cache_key;
+static pthread_once_t g_slab_cache_key_once = PTHREAD_ONCE_INIT;
+
+struct GSlabClassTable
+{
+    unsigned char classes[SLAB_MAX_SIZE / SLAB_GRANULARITY + 1];
+
+    constexpr GSlabClassTable()
+    : classes()
+    {
+        for (size_t i = 0, klass = 0; i < sizeof classes; ++i)
+        {
+            while (SLAB_CLASS_SIZES[klass] < i * SLAB_GRANULARITY)
+            {
+                ++klass;
+            }
+
+            classes[i] = static_cast<unsigned char>(klass);
+        }
+    }
+};
+
+static constexpr GSlabClassTable SLAB_CLASSES;
+
+static inline size_t g_slab_class(size_t size)
+{
+    return SLAB_CLASSES.classes[(size + SLAB_GRANULARITY - 1) / SLAB_GRANULARITY];
+}
+
+static void g_slab_return(size_t klass, GSlabBlock* first, GSlabBlock* last)
+{
+    GSlabDepot& depot = g_slab_depots[klass];
+
+    os_unfair_lock_lock(&depot.lock);
+    last->next = depot.blocks;
+    depot.blocks = first;
+    os_unfair_lock_unlock(&depot.lock);
+}
+
+static void g_slab_flush_cache(void* value)
+{
+    GSlabCache* cache = static_cast<GSlabCache*>(value);
+
+    for (size_t klass = 0; klass < SLAB_CLASS_COUNT; ++klass)
+    {
+        if (GSlabBlock* first = cache->blocks[klass])
+        {
+            GSlabBlock* last = first;
+
+            while (last->next != nullptr)
+            {
+                last = last->next;
+            }
+
+            g_slab_return(klass, first, last);
+
+            cache->blocks[klass] = nullptr;
+            cache->counts[klass] = 0;
+        }
+    }
+
+    // Blocks freed by other destructors will register the cache again
+    cache->registered = false;
+}
+
+static void g_slab_create_cache_key()
+{
+    pthread_key_create(&g_slab_cache_key, g_slab_flush_cache);
+}
+
+static __attribute__((noinline)) void g_slab_register_cache(GSlabCache& cache)
+{
+    // Return cached blocks to depots on thread exit
+    pthread_once(&g_slab_cache_key_once, g_slab_create_cache_key);
+    pthread_setspecific(g_slab_cache_key, &cache);
+    cache.registered = true;
+}
+
+static __attribute__((noinline)) void* g_slab_refill(GSlabCache& cache, size_t klass)
+{
+    if (!cache.registered)
+    {
+        g_slab_register_cache(cache);
+    }
+
+    GSlabDepot& depot = g_slab_depots[klass];
+    const size_t block_size = SLAB_CLASS_SIZES[klass];
+
+    GSlabBlock* blocks = nullptr;
+    unsigned int count = 0;
+
+    os_unfair_lock_lock(&depot.lock);
+
+    for (; count < SLAB_BATCH_SIZE && depot.blocks != nullptr; ++count)
+    {
+        GSlabBlock* block = depot.blocks;
+        depot.blocks = block->next;
+        block->next = blocks;
+        blocks = block;
+    }
+
+    for (; count < SLAB_BATCH_SIZE; ++count)
+    {
+        if (depot.chunk_size < block_size)
+        {
+            depot.chunk = static_cast<char*>(malloc(SLAB_CHUNK_SIZE));
+
+            if (depot.chunk == nullptr)
+            {
+                depot.chunk_size = 0;
+                break;
+            }
+
+            depot.chunk_size = SLAB_CHUNK_SIZE;
+        }
+
+        GSlabBlock* block = reinterpret_cast<GSlabBlock*>(depot.chunk);
+        depot.chunk += block_size;
+        depot.chunk_size -= block_size;
+
+        block->next = blocks;
+        blocks = block;
+    }
+
+    os_unfair_lock_unlock(&depot.lock);
+
+    if (blocks == nullptr)
+    {
+        return nullptr;
+    }
+
+    cache.blocks[klass] = blocks->next;
+    cache.counts[klass] = count - 1;
+
+    return blocks;
+}
+
+static __attribute__((noinline)) void g_slab_drain(GSlabCache& cache, size_t klass)
+{
+    GSlabBlock* first = cache.blocks[klass];
+    GSlabBlock* last = first;
+
+    for (unsigned int i = 1; i < SLAB_BATCH_SIZE; ++i)
+    {
+        last = last->next;
+    }
+
+    cache.blocks[klass] = last->next;
+    cache.counts[klass] -= SLAB_BATCH_SIZE;
+
+    g_slab_return(klass, first, last);
+}
+
+static inline void* g_slab_alloc(size_t klass)
+{
+    GSlabCache& cache = g_slab_cache;
+
+    if (GSlabBlock* block = cache.blocks[klass])
+    {
+        cache.blocks[klass] = block->next;
+        --cache.counts[klass];
+        return block;
+    }
+
+    return g_slab_refill(cache, klass);
+}
+
+static inline void g_slab_free(void* ptr, size_t klass)
+{
+    GSlabCache& cache = g_slab_cache;
+
+    if (__builtin_expect(!cache.registered, 0))
+    {
+        // Thread may free blocks without allocating any
+        g_slab_register_cache(cache);
+    }
+
+    GSlabBlock* block = static_cast<GSlabBlock*>(ptr);
+    block->next = cache.blocks[klass];
+    cache.blocks[klass] = block;
+
+    if (++cache.counts[klass] > SLAB_CACHE_LIMIT)
+    {
+        g_slab_drain(cache, klass);
+    }
+}
+
+void* g_malloc(size_t size)
+{
+    if (size == 0)
+    {
+        return nullptr;
+    }
+
+    const size_t total_size = size + SLAB_HEADER_SIZE;
+    size_t klass;
+    void* block;
+
+    if (total_size <= SLAB_MAX_SIZE)
+    {
+        klass = g_slab_class(total_size);
+        block = g_slab_alloc(klass);
+    }
+    else
+    {
+        klass = SLAB_LARGE_CLASS;
+        block = malloc(total_size);
+    }
+
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+
+    *static_cast<size_t*>(block) = klass;
+    return static_cast<char*>(block) + SLAB_HEADER_SIZE;
+}
+
+void g_free(void* ptr)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    void* block = static_cast<char*>(ptr) - SLAB_HEADER_SIZE;
+    const size_t klass = *static_cast<size_t*>(block);
+
+    if (klass == SLAB_LARGE_CLASS)
+    {
+        free(block);
+    }
+    else
+    {
+        g_slab_free(block, klass);
+    }
+}
+
+void* g_realloc(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+    {
+        return g_malloc(size);
+    }
+
+    if (size == 0)
+    {
+        g_free(ptr);
+        return nullptr;
+    }
+
+    void* block = static_cast<char*>(ptr) - SLAB_HEADER_SIZE;
+    const size_t klass = *static_cast<size_t*>(block);
+    const size_t total_size = size + SLAB_HEADER_SIZE;
+
+    if (klass == SLAB_LARGE_CLASS)
+    {
+        // Shrunk large block stays in the system allocator, header is preserved by realloc()
+        block = realloc(block, total_size);
+        return block == nullptr ? nullptr : static_cast<char*>(block) + SLAB_HEADER_SIZE;
+    }
+
+    const size_t capacity = SLAB_CLASS_SIZES[klass];
+
+    if (total_size <= capacity)
+    {
+        return ptr;
+    }
+
+    void* result = g_malloc(size);
+
+    if (result != nullptr)
+    {
+        memcpy(result, ptr, capacity - SLAB_HEADER_SIZE);
+        g_slab_free(block, klass);
+    }
+
+    return result;
+}
+
+void* g_slice_alloc(size_t block_size)
+{
+    if (block_size == 0)
+    {
+        return nullptr;
+    }
+
+    return block_size <= SLAB_MAX_SIZE ? g_slab_alloc(g_slab_class(block_size)) : malloc(block_size);
+}
+
+void g_slice_free1(size_t block_size, void* mem_block)
+{
+    if (mem_block == nullptr)
+    {
+        return;
+    }
+
+    if (block_size <= SLAB_MAX_SIZE)
+    {
+        g_slab_free(mem_block, g_slab_class(block_size));
+    }
+    else
+    {
+        free(mem_block);
+    }
+}
+
+#else // !QUASI_GLIB_SLAB_ALLOCATOR
+
+void* g_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void* g_realloc(void* ptr, size_t size)
+{
+    if (size == 0)
+    {
+        free(ptr);
+        return nullptr;
+    }
+
+    return realloc(ptr, size);
+}
+
+void g_free(void* ptr)
+{
+    free(ptr);
+}
+
+void* g_slice_alloc(size_t block_size)
+{
+    return malloc(block_size);
+}
+
+void g_slice_free1(size_t block_size, void* mem_block)
+{
+    free(mem_block);
+}
+
+#endif // QUASI_GLIB_SLAB_ALLOCATOR
+
+extern "C++"
+{
+
+// Internal objects are plain structs from slice allocator, their fields are assigned by callers
+// Neither operator new nor delete is used, so the library doesn't depend on C++ runtime
+template <typename T>
+static T* g_internal_new()
+{
+    static_assert(std::is_trivial_v<T> && alignof(T) <= 16, "Internal object must be trivial and not over-aligned");
+    return static_cast<T*>(g_slice_alloc(sizeof(T)));
+}
+
+template <typename T>
+static void g_internal_delete(T* object)
+{
+    g_slice_free1(sizeof(T), object);
+}
+
+}
+
+void* g_malloc0(size_t size)
+{
+    void* mem = g_malloc(size);
+
+    if (mem != nullptr)
+    {
+        memset(mem, 0, size);
+    }
+
+    return mem;
+}
+
+char* g_strndup(const char* str, size_t n)
+{
+    if (str == nullptr)
+    {
+        return nullptr;
+    }
+
+    char* result = static_cast<char*>(g_malloc(n + 1));
+    memcpy(result, str, n);
+    result[n] = '\0';
+
+    return result;
+}
+
+char* g_strdup(const char* str)
+{
+    return str == nullptr ? nullptr : g_strndup(str, strlen(str));
+}
+
+void g_strfreev(char** str_array)
+{
+    if (str_array == nullptr)
+    {
+        return;
+    }
+
+    for (char** str = str_array; *str != nullptr; ++str)
+    {
+        g_free(*str);
+    }
+
+    g_free(str_array);
+}
+
+void* g_slice_alloc0(size_t block_size)
+{
+    void* mem_block = g_slice_alloc(block_size);
+
+    if (mem_block != nullptr)
+    {
+        memset(mem_block, 0, block_size);
+    }
+
+    return mem_block;
+}
+
+
+struct GError
+{
+    uint32_t domain;
+    int code;
+    char* message;
+};
+
+static void g_set_error_literal(GError** err, uint32_t domain, int code, const char* message)
+{
+    if (err == nullptr)
+    {
+        return;
+    }
+
+    GError* error = static_cast<GError*>(g_malloc(sizeof(GError)));
+    *error = GError{ domain, code, g_strdup(message) };
+    *err = error;
+}
+
+void g_error_free(GError* error)
+{
+    if (error != nullptr)
+    {
+        g_free(error->message);
+        g_free(error);
+    }
+}
+
+void g_clear_error(GError** err)
+{
+    if (nullptr != err && nullptr != *err)
+    {
+        g_error_free(*err);
+        *err = nullptr;
+    }
+}
+
+
+void g_return_if_fail_warning(const char* domain, const char* function, const char* expression)
+{
+}
+
+
+enum GFileTest
+{
+    G_FILE_TEST_IS_REGULAR    = 1 << 0,
+    G_FILE_TEST_IS_SYMLINK    = 1 << 1,
+    G_FILE_TEST_IS_DIR        = 1 << 2,
+    G_FILE_TEST_IS_EXECUTABLE = 1 << 3,
+    G_FILE_TEST_EXISTS        = 1 << 4
+};
+
+// Result of one stat() call, enough to answer all g_file_test() queries
+struct GFileStat
+{
+    bool exists;
+    mode_t mode;
+    uid_t uid;
+    gid_t gid;
+};
+
+static GFileStat g_file_stat(const char* filename, bool follow)
+{
+    struct stat s;
+    GFileStat result = {};
+
+    if (fstatat(AT_FDCWD, filename, &s, follow ? 0 : AT_SYMLINK_NOFOLLOW) == 0)
+    {
+        result = { true, s.st_mode, s.st_uid, s.st_gid };
+    }
+
+    return result;
+}
+
+// Opt-in process lifetime cache of stat() results, enabled by QUASI_GLIB_FILE_TEST_CACHE=1
+// It helps with repeated probes of the same paths during soundfont discovery
+// Changes of file system made after the first probe of a path are not noticed
+constexpr size_t FILE_TEST_CACHE_SIZE = 512;
+
+struct GFileTestCacheEntry
+{
+    char* path;
+    GFileStat link;
+    GFileStat target;
+    bool has_link;
+    bool has_target;
+};
+
+static GFileTestCacheEntry g_file_test_cache[FILE_TEST_CACHE_SIZE];
+static os_unfair_lock g_file_test_cache_lock = OS_UNFAIR_LOCK_INIT;
+
+static bool g_file_test_cache_enabled()
+{
+    // 0 - unknown, 1 - disabled, 2 - enabled
+    static int state;
+    int value = __atomic_load_n(&state, __ATOMIC_RELAXED);
+
+    if (value == 0)
+    {
+        const char* env = getenv("QUASI_GLIB_FILE_TEST_CACHE");
+        value = (env != nullptr && strcmp(env, "1") == 0) ? 2 : 1;
+        __atomic_store_n(&state, value, __ATOMIC_RELAXED);
+    }
+
+    return value == 2;
+}
+
+// Returns slot for the given path, or null if cache is full, must be called with cache lock held
+static GFileTestCacheEntry* g_file_test_cache_slot(const char* filename)
+{
+    // FNV-1a
+    size_t hash = 14695981039346656037ull;
+
+    for (const char* ch = filename; *ch != '\0'; ++ch)
+    {
+        hash = (hash ^ static_cast<unsigned char>(*ch)) * 1099511628211ull;
+    }
+
+    for (size_t i = 0; i < FILE_TEST_CACHE_SIZE; ++i)
+    {
+        GFileTestCacheEntry& entry = g_file_test_cache[(hash + i) % FILE_TEST_CACHE_SIZE];
+
+        if (entry.path == nullptr || strcmp(entry.path, filename) == 0)
+        {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+static GFileStat g_file_test_stat(const char* filename, bool follow)
+{
+    if (!g_file_test_cache_enabled())
+    {
+        return g_file_stat(filename, follow);
+    }
+
+    os_unfair_lock_lock(&g_file_test_cache_lock);
+
+    GFileTestCacheEntry* entry = g_file_test_cache_slot(filename);
+
+    if (entry != nullptr && (follow ? entry->has_target : entry->has_link))
+    {
+        const GFileStat result = follow ? entry->target : entry->link;
+        os_unfair_lock_unlock(&g_file_test_cache_lock);
+        return result;
+    }
+
+    os_unfair_lock_unlock(&g_file_test_cache_lock);
+
+    // Query file system without holding the lock, a concurrent probe of the same path may do the same
+    const GFileStat result = g_file_stat(filename, follow);
+
+    os_unfair_lock_lock(&g_file_test_cache_lock);
+
+    entry = g_file_test_cache_slot(filename);
+
+    if (entry != nullptr)
+    {
+        if (entry->path == nullptr)
+        {
+            entry->path = strdup(filename);
+        }
+
+        if (entry->path != nullptr)
+        {
+            (follow ? entry->target : entry->link) = result;
+            (follow ? entry->has_target : entry->has_link) = true;
+        }
+    }
+
+    os_unfair_lock_unlock(&g_file_test_cache_lock);
+
+    return result;
+}
+
+static bool g_file_is_executable(const GFileStat& s, const char* filename)
+{
+    constexpr mode_t ANY_EXECUTE = S_IXUSR | S_IXGRP | S_IXOTH;
+
+    // Like GLib, superuser needs at least one execute bit, and directories are considered executable
+    if (geteuid() == 0)
+    {
+        return (s.mode & ANY_EXECUTE) != 0;
+    }
+
+    if (s.uid == geteuid())
+    {
+        return (s.mode & S_IXUSR) != 0;
+    }
+
+    if (s.gid == getegid())
+    {
+        return (s.mode & S_IXGRP) != 0;
+    }
+
+    if ((s.mode & S_IXGRP) && !(s.mode & S_IXOTH))
+    {
+        // Supplementary groups may grant the permission, this rare case is left to the kernel
+        return access(filename, X_OK) == 0;
+    }
+
+    return (s.mode & S_IXOTH) != 0;
+}
+
+int g_file_test(const char* filename, int test)
+{
+    if (filename == nullptr)
+    {
+        return 0;
+    }
+
+    constexpr int TARGET_TESTS = G_FILE_TEST_EXISTS | G_FILE_TEST_IS_REGULAR | G_FILE_TEST_IS_DIR | G_FILE_TEST_IS_EXECUTABLE;
+
+    GFileStat s = {};
+
+    if (test & G_FILE_TEST_IS_SYMLINK)
+    {
+        s = g_file_test_stat(filename, false);
+
+        if (!s.exists)
+        {
+            return 0;
+        }
+
+        if (S_ISLNK(s.mode))
+        {
+            return 1;
+        }
+
+        // Not a symbolic link, so the same result applies to the remaining tests
+    }
+    else if (test & TARGET_TESTS)
+    {
+        s = g_file_test_stat(filename, true);
+    }
+
+    if (!s.exists)
+    {
+        return 0;
+    }
+
+    if (test & G_FILE_TEST_EXISTS)
+    {
+        return 1;
+    }
+
+    if ((test & G_FILE_TEST_IS_REGULAR) && S_ISREG(s.mode))
+    {
+        return 1;
+    }
+
+    if ((test & G_FILE_TEST_IS_DIR) && S_ISDIR(s.mode))
+    {
+        return 1;
+    }
+
+    if ((test & G_FILE_TEST_IS_EXECUTABLE) && g_file_is_executable(s, filename))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+
+// Timebase is packed into one word, so concurrent first calls cannot observe partially initialized value
+// Querying it more than once is harmless because result is always the same
+static uint64_t g_timebase;
+
+static inline mach_timebase_info_data_t g_get_timebase()
+{
+    uint64_t timebase = __atomic_load_n(&g_timebase, __ATOMIC_RELAXED);
+
+    if (timebase == 0)
+    {
+        mach_timebase_info_data_t info;
+        mach_timebase_info(&info);
+
+        timebase = (uint64_t(info.numer) << 32) | info.denom;
+        __atomic_store_n(&g_timebase, timebase, __ATOMIC_RELAXED);
+    }
+
+    return { uint32_t(timebase >> 32), uint32_t(timebase) };
+}
+
+// Exact value of floor(value * numer / denom) without 128-bit arithmetic
+static inline uint64_t g_scale(uint64_t value, uint32_t numer, uint32_t denom)
+{
+    return value / denom * numer + value % denom * numer / denom;
+}
+
+static inline uint64_t g_ticks_to_ns(uint64_t ticks)
+{
+    const mach_timebase_info_data_t timebase = g_get_timebase();
+
+    // Intel Macs have 1/1 timebase, Apple Silicon ones have 125/3
+    return timebase.numer == timebase.denom ? ticks : g_scale(ticks, timebase.numer, timebase.denom);
+}
+
+static inline uint64_t g_ns_to_ticks(uint64_t ns)
+{
+    const mach_timebase_info_data_t timebase = g_get_timebase();
+    return timebase.numer == timebase.denom ? ns : g_scale(ns, timebase.denom, timebase.numer);
+}
+
+int64_t quasi_glib_monotonic_ns()
+{
+    return int64_t(g_ticks_to_ns(mach_absolute_time()));
+}
+
+int64_t g_get_monotonic_time()
+{
+    return quasi_glib_monotonic_ns() / 1000;
+}
+
+
+// Short sleeps wait for absolute deadline, which is not subject to timer coalescing unlike usleep()
+// Longer sleeps don't need such precision, and coalescing is left in place for them to save power
+constexpr unsigned long PRECISE_SLEEP_LIMIT_US = 20'000;
+
+void g_usleep(unsigned long microseconds)
+{
+    if (microseconds > PRECISE_SLEEP_LIMIT_US)
+    {
+        usleep(microseconds);
+        return;
+    }
+
+    const uint64_t deadline = mach_absolute_time() + g_ns_to_ticks(uint64_t(microseconds) * 1000);
+
+    // Wait is aborted when thread is interrupted, continue until deadline is reached
+    while (mach_wait_until(deadline) == KERN_ABORTED)
+    {
+    }
+}
+
+
+enum GLockKind
+{
+    LOCK_KIND_MUTEX,
+    LOCK_KIND_REC_MUTEX,
+    LOCK_KIND_COND,
+};
+
+#ifdef QUASI_GLIB_LOCK_STATS
+
+// Lock instrumentation is compiled in with QUASI_GLIB_LOCK_STATS, and activated by QUASI_GLIB_LOCK_STATS=1 variable
+// Summary is printed to stderr at exit and when the process receives SIGUSR2
+// Statistics are kept in a fixed size table keyed by lock address, locks that don't fit there are not tracked
+
+constexpr size_t LOCK_STATS_TABLE_SIZE = 1024;
+constexpr size_t LOCK_STATS_BUCKET_COUNT = 32;
+constexpr size_t LOCK_STATS_NAME_SIZE = 32;
+
+struct GLockStats
+{
+    uintptr_t address;
+    GLockKind kind;
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t acquired_at;
+    // Histograms of durations in nanoseconds, bucket N counts durations in [2^(N-1), 2^N) range
+    uint64_t wait[LOCK_STATS_BUCKET_COUNT];
+    uint64_t hold[LOCK_STATS_BUCKET_COUNT];
+    char thread_name[LOCK_STATS_NAME_SIZE];
+};
+
+static GLockStats g_lock_stats_table[LOCK_STATS_TABLE_SIZE];
+static bool g_lock_stats_active;
+
+static __thread char g_lock_stats_thread_name[LOCK_STATS_NAME_SIZE];
+
+static inline bool g_lock_stats_enabled()
+{
+    return __builtin_expect(g_lock_stats_active, false);
+}
+
+static GLockStats* g_lock_stats_find(const void* lock, GLockKind kind)
+{
+    const uintptr_t address = uintptr_t(lock);
+
+    for (size_t i = 0; i < LOCK_STATS_TABLE_SIZE; ++i)
+    {
+        GLockStats& stats = g_lock_stats_table[(address / sizeof(void*) + i) % LOCK_STATS_TABLE_SIZE];
+        uintptr_t current = __atomic_load_n(&stats.address, __ATOMIC_ACQUIRE);
+
+        if (current == 0)
+        {
+            // Slot may be taken by another thread, possibly for the same lock
+            if (__atomic_compare_exchange_n(&stats.address, &current, address, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                stats.kind = kind;
+                return &stats;
+            }
+        }
+
+        if (current == address)
+        {
+            return &stats;
+        }
+    }
+
+    return nullptr;
+}
+
+static inline void g_lock_stats_count(uint64_t* histogram, uint64_t ticks)
+{
+    const uint64_t ns = g_ticks_to_ns(ticks);
+    const size_t bucket = ns == 0 ? 0 : 64 - __builtin_clzll(ns);
+    __atomic_fetch_add(&histogram[bucket < LOCK_STATS_BUCKET_COUNT ? bucket : LOCK_STATS_BUCKET_COUNT - 1], 1, __ATOMIC_RELAXED);
+}
+
+static void g_lock_stats_set_thread_name(GLockStats* stats)
+{
+    if (g_lock_stats_thread_name[0] == '\0')
+    {
+        pthread_getname_np(pthread_self(), g_lock_stats_thread_name, LOCK_STATS_NAME_SIZE);
+
+        if (g_lock_stats_thread_name[0] == '\0')
+        {
+            strlcpy(g_lock_stats_thread_name, pthread_main_np() ? "main" : "unnamed", LOCK_STATS_NAME_SIZE);
+        }
+    }
+
+    memcpy(stats->thread_name, g_lock_stats_thread_name, LOCK_STATS_NAME_SIZE);
+}
+
+static void g_lock_stats_acquired(const void* lock, GLockKind kind, bool contended, uint64_t wait_ticks)
+{
+    GLockStats* stats = g_lock_stats_find(lock, kind);
+
+    if (stats == nullptr)
+    {
+        return;
+    }
+
+    __atomic_fetch_add(&stats->acquisitions, 1, __ATOMIC_RELAXED);
+
+    if (contended)
+    {
+        __atomic_fetch_add(&stats->contended, 1, __ATOMIC_RELAXED);
+    }
+
+    g_lock_stats_count(stats->wait, wait_ticks);
+
+    // Only owner of the lock writes these fields, summary may observe them partially updated
+    g_lock_stats_set_thread_name(stats);
+    stats->acquired_at = mach_absolute_time();
+}
+
+static void g_lock_stats_lock(os_unfair_lock* lock, GLockKind kind)
+{
+    if (os_unfair_lock_trylock(lock))
+    {
+        g_lock_stats_acquired(lock, kind, false, 0);
+        return;
+    }
+
+    const uint64_t start = mach_absolute_time();
+    os_unfair_lock_lock(lock);
+    g_lock_stats_acquired(lock, kind, true, mach_absolute_time() - start);
+}
+
+static void g_lock_stats_released(const void* lock, GLockKind kind)
+{
+    if (GLockStats* stats = g_lock_stats_find(lock, kind))
+    {
+        g_lock_stats_count(stats->hold, mach_absolute_time() - stats->acquired_at);
+    }
+}
+
+static void g_lock_stats_waited(const void* cond, uint64_t wait_ticks)
+{
+    if (GLockStats* stats = g_lock_stats_find(cond, LOCK_KIND_COND))
+    {
+        __atomic_fetch_add(&stats->acquisitions, 1, __ATOMIC_RELAXED);
+        g_lock_stats_count(stats->wait, wait_ticks);
+        g_lock_stats_set_thread_name(stats);
+    }
+}
+
+static void g_lock_stats_print_histogram(const char* name, const uint64_t* histogram)
+{
+    fprintf(stderr, "    %s:", name);
+
+    for (size_t i = 0; i < LOCK_STATS_BUCKET_COUNT; ++i)
+    {
+        if (const uint64_t count = __atomic_load_n(&histogram[i], __ATOMIC_RELAXED))
+        {
+            fprintf(stderr, " <%llu ns: %llu", 1ull << i, count);
+        }
+    }
+
+    fputc('\n', stderr);
+}
+
+static void g_lock_stats_dump(void* = nullptr)
+{
+    static const char* const KIND_NAMES[] = { "GMutex", "GRecMutex", "GCond" };
+
+    fprintf(stderr, "quasi-glib lock statistics:\n");
+
+    for (const GLockStats& stats : g_lock_stats_table)
+    {
+        const uint64_t acquisitions = __atomic_load_n(&stats.acquisitions, __ATOMIC_RELAXED);
+
+        if (acquisitions == 0)
+        {
+            continue;
+        }
+
+        if (stats.kind == LOCK_KIND_COND)
+        {
+            fprintf(stderr, "  %s %p: waits %llu, last by %.*s\n", KIND_NAMES[stats.kind], reinterpret_cast<void*>(stats.address),
+                acquisitions, int(LOCK_STATS_NAME_SIZE), stats.thread_name);
+            g_lock_stats_print_histogram("wait", stats.wait);
+            continue;
+        }
+
+        const uint64_t contended = __atomic_load_n(&stats.contended, __ATOMIC_RELAXED);
+
+        fprintf(stderr, "  %s %p: acquisitions %llu, contended %llu (%.2f%%), last by %.*s\n",
+            KIND_NAMES[stats.kind], reinterpret_cast<void*>(stats.address), acquisitions, contended,
+            contended * 100.0 / acquisitions, int(LOCK_STATS_NAME_SIZE), stats.thread_name);
+        g_lock_stats_print_histogram("wait", stats.wait);
+        g_lock_stats_print_histogram("hold", stats.hold);
+    }
+}
+
+static void g_lock_stats_dump_at_exit()
+{
+    g_lock_stats_dump();
+}
+
+__attribute__((constructor)) static void g_lock_stats_init()
+{
+    const char* value = getenv("QUASI_GLIB_LOCK_STATS");
+
+    if (value == nullptr || strcmp(value, "1") != 0)
+    {
+        return;
+    }
+
+    g_lock_stats_active = true;
+    atexit(g_lock_stats_dump_at_exit);
+
+    // Signal is handled on a dispatch queue, so the summary is not printed from async signal context
+    signal(SIGUSR2, SIG_IGN);
+
+    dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_SIGNAL, SIGUSR2, 0, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+    dispatch_source_set_event_handler_f(source, g_lock_stats_dump);
+    dispatch_resume(source);
+}
+
+#else // !QUASI_GLIB_LOCK_STATS
+
+static inline bool g_lock_stats_enabled()
+{
+    return false;
+}
+
+static inline void g_lock_stats_acquired(const void*, GLockKind, bool, uint64_t) {}
+static inline void g_lock_stats_lock(os_unfair_lock*, GLockKind) {}
+static inline void g_lock_stats_released(const void*, GLockKind) {}
+static inline void g_lock_stats_waited(const void*, uint64_t) {}
+
+#endif // QUASI_GLIB_LOCK_STATS
+
+
+// Referenced by code compiled with quasi-glib-inline.h, which relies on layouts of GMutex and GPrivate below
+extern const int quasi_glib_inline_abi = 1;
+
+
+// Layout must match GLib's union { gpointer p; guint i[2]; }
+// os_unfair_lock is zero-initialized, so statically allocated mutexes don't need g_mutex_init()
+// The lock word stores owner's thread port, this allows the kernel to donate priority to lock owner
+struct GMutex
+{
+    os_unfair_lock lock;
+    unsigned int unused;
+};
+
+static_assert(sizeof(GMutex) == sizeof(void*), "GMutex size mismatch");
+
+void g_mutex_init(GMutex* mutex)
+{
+    mutex->lock = OS_UNFAIR_LOCK_INIT;
+}
+
+void g_mutex_clear(GMutex* mutex)
+{
+}
+
+void g_mutex_lock(GMutex* mutex)
+{
+    if (g_lock_stats_enabled())
+    {
+        g_lock_stats_lock(&mutex->lock, LOCK_KIND_MUTEX);
+        return;
+    }
+
+    os_unfair_lock_lock(&mutex->lock);
+}
+
+int g_mutex_trylock(GMutex* mutex)
+{
+    const bool locked = os_unfair_lock_trylock(&mutex->lock);
+
+    if (locked && g_lock_stats_enabled())
+    {
+        g_lock_stats_acquired(&mutex->lock, LOCK_KIND_MUTEX, false, 0);
+    }
+
+    return locked;
+}
+
+void g_mutex_unlock(GMutex* mutex)
+{
+    if (g_lock_stats_enabled())
+    {
+        g_lock_stats_released(&mutex->lock, LOCK_KIND_MUTEX);
+    }
+
+    os_unfair_lock_unlock(&mutex->lock);
+}
+
+
+// Layout must match GLib's struct { gpointer p; guint i[2]; }
+// i[0] stores owner's thread port, i[1] stores recursion depth
+struct GRecMutex
+{
+    os_unfair_lock lock;
+    unsigned int unused;
+    unsigned int owner;
+    unsigned int depth;
+};
+
+static_assert(sizeof(GRecMutex) == sizeof(void*) + sizeof(unsigned int) * 2, "GRecMutex size mismatch");
+
+static inline unsigned int g_rec_mutex_self()
+{
+    // Thread port is non-zero and unique for any running thread
+    return pthread_mach_thread_np(pthread_self());
+}
+
+void g_rec_mutex_init(GRecMutex* mutex)
+{
+    *mutex = GRecMutex{ OS_UNFAIR_LOCK_INIT, 0, 0, 0 };
+}
+
+void g_rec_mutex_clear(GRecMutex* mutex)
+{
+}
+
+void g_rec_mutex_lock(GRecMutex* mutex)
+{
+    const unsigned int self = g_rec_mutex_self();
+
+    // Relaxed load is a plain load, owner can be equal to self only when it was stored by this thread
+    if (__atomic_load_n(&mutex->owner, __ATOMIC_RELAXED) == self)
+    {
+        ++mutex->depth;
+        return;
+    }
+
+    if (g_lock_stats_enabled())
+    {
+        g_lock_stats_lock(&mutex->lock, LOCK_KIND_REC_MUTEX);
+    }
+    else
+    {
+        os_unfair_lock_lock(&mutex->lock);
+    }
+
+    __atomic_store_n(&mutex->owner, self, __ATOMIC_RELAXED);
+    mutex->depth = 1;
+}
+
+int g_rec_mutex_trylock(GRecMutex* mutex)
+{
+    const unsigned int self = g_rec_mutex_self();
+
+    if (__atomic_load_n(&mutex->owner, __ATOMIC_RELAXED) == self)
+    {
+        ++mutex->depth;
+        return 1;
+    }
+
+    if (!os_unfair_lock_trylock(&mutex->lock))
+    {
+        return 0;
+    }
+
+    if (g_lock_stats_enabled())
+    {
+        g_lock_stats_acquired(&mutex->lock, LOCK_KIND_REC_MUTEX, false, 0);
+    }
+
+    __atomic_store_n(&mutex->owner, self, __ATOMIC_RELAXED);
+    mutex->depth = 1;
+
+    return 1;
+}
+
+void g_rec_mutex_unlock(GRecMutex* mutex)
+{
+    if (--mutex->depth == 0)
+    {
+        if (g_lock_stats_enabled())
+        {
+            g_lock_stats_released(&mutex->lock, LOCK_KIND_REC_MUTEX);
+        }
+
+        __atomic_store_n(&mutex->owner, 0u, __ATOMIC_RELAXED);
+        os_unfair_lock_unlock(&mutex->lock);
+    }
+}
+
+
+// Darwin address wait primitives, these are used by libc++ to implement std::atomic<>::wait()
+// os_sync_wait_on_address() is public wrapper of the same syscalls, but it requires macOS 14.4
+
+extern int __ulock_wait(uint32_t operation, void* address, uint64_t value, uint32_t timeout);
+extern int __ulock_wake(uint32_t operation, void* address, uint64_t wake_value);
+
+constexpr uint32_t UL_COMPARE_AND_WAIT = 1;
+constexpr uint32_t ULF_WAKE_ALL = 0x00000100;
+constexpr uint32_t ULF_NO_ERRNO = 0x01000000;
+
+static inline int g_address_wait(unsigned int* address, unsigned int value, uint32_t timeout_us = 0)
+{
+    return __ulock_wait(UL_COMPARE_AND_WAIT | ULF_NO_ERRNO, address, value, timeout_us);
+}
+
+static inline void g_address_wake(unsigned int* address, bool all)
+{
+    __ulock_wake(UL_COMPARE_AND_WAIT | ULF_NO_ERRNO | (all ? ULF_WAKE_ALL : 0), address, 0);
+}
+
+
+// Layout must match GLib's struct { gpointer p; guint i[2]; }
+// i[0] stores sequence counter which waiters sleep on, i[1] stores number of waiters
+struct GCond
+{
+    void* unused;
+    unsigned int sequence;
+    unsigned int waiters;
+};
+
+static_assert(sizeof(GCond) == sizeof(void*) + sizeof(unsigned int) * 2, "GCond size mismatch");
+
+void g_cond_init(GCond* cond)
+{
+    *cond = GCond{ nullptr, 0, 0 };
+}
+
+void g_cond_clear(GCond* cond)
+{
+}
+
+static int g_cond_wait_impl(GCond* cond, GMutex* mutex, uint32_t timeout_us)
+{
+    // Both values are updated while the mutex is held, so a signal issued after predicate change
+    // either sees this waiter or bumps the sequence before it is sampled by the wait syscall
+    const unsigned int sequence = __atomic_load_n(&cond->sequence, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&cond->waiters, 1, __ATOMIC_SEQ_CST);
+
+    g_mutex_unlock(mutex);
+
+    const uint64_t start = g_lock_stats_enabled() ? mach_absolute_time() : 0;
+    const int result = g_address_wait(&cond->sequence, sequence, timeout_us);
+
+    if (g_lock_stats_enabled())
+    {
+        g_lock_stats_waited(cond, mach_absolute_time() - start);
+    }
+
+    __atomic_fetch_sub(&cond->waiters, 1, __ATOMIC_RELAXED);
+    g_mutex_lock(mutex);
+
+    return result;
+}
+
+void g_cond_wait(GCond* cond, GMutex* mutex)
+{
+    g_cond_wait_impl(cond, mutex, 0);
+}
+
+int g_cond_wait_until(GCond* cond, GMutex* mutex, int64_t end_time)
+{
+    const int64_t timeout = end_time - g_get_monotonic_time();
+
+    if (timeout <= 0)
+    {
+        return 0;
+    }
+
+    // Zero timeout means infinite wait, spurious wakeup is reported for too long timeouts
+    const uint32_t timeout_us = timeout > UINT32_MAX ? UINT32_MAX : uint32_t(timeout);
+    return g_cond_wait_impl(cond, mutex, timeout_us) != -ETIMEDOUT;
+}
+
+static inline void g_cond_wake(GCond* cond, bool all)
+{
+    // Signal without waiters costs one load
+    if (__atomic_load_n(&cond->waiters, __ATOMIC_SEQ_CST) == 0)
+    {
+        return;
+    }
+
+    __atomic_fetch_add(&cond->sequence, 1, __ATOMIC_SEQ_CST);
+    g_address_wake(&cond->sequence, all);
+}
+
+void g_cond_signal(GCond* cond)
+{
+    g_cond_wake(cond, false);
+}
+
+void g_cond_broadcast(GCond* cond)
+{
+    g_cond_wake(cond, true);
+}
+
+
+// Bounded lock-free queue, the ring is based on Dmitry Vyukov's MPMC queue
+// Each cell has a sequence number which tells whether it is ready to be written or read at the given position
+// Consumers park on address wait only when the queue is empty, and producers do the same when it is full
+constexpr size_t ASYNC_QUEUE_CAPACITY = 4096;
+
+static_assert((ASYNC_QUEUE_CAPACITY & (ASYNC_QUEUE_CAPACITY - 1)) == 0, "Queue capacity must be power of two");
+
+struct GAsyncQueueCell
+{
+    size_t sequence;
+    void* data;
+};
+
+struct GAsyncQueue
+{
+    // Positions are updated by different threads, keep them on separate cache lines
+    alignas(64) size_t tail;
+    alignas(64) size_t head;
+
+    // Sequence counters to sleep on, and numbers of threads sleeping on them
+    alignas(64) unsigned int pushed;
+    unsigned int consumers;
+    unsigned int popped;
+    unsigned int producers;
+
+    int ref_count;
+
+    GAsyncQueueCell cells[ASYNC_QUEUE_CAPACITY];
+};
+
+GAsyncQueue* g_async_queue_new()
+{
+    // Positions are aligned to cache line, which neither malloc() nor slice allocator guarantees
+    void* memory = nullptr;
+
+    if (posix_memalign(&memory, alignof(GAsyncQueue), sizeof(GAsyncQueue)) != 0)
+    {
+        abort();
+    }
+
+    GAsyncQueue* queue = static_cast<GAsyncQueue*>(memory);
+    queue->tail = 0;
+    queue->head = 0;
+    queue->pushed = 0;
+    queue->consumers = 0;
+    queue->popped = 0;
+    queue->producers = 0;
+    queue->ref_count = 1;
+
+    for (size_t i = 0; i < ASYNC_QUEUE_CAPACITY; ++i)
+    {
+        queue->cells[i].sequence = i;
+    }
+
+    return queue;
+}
+
+GAsyncQueue* g_async_queue_ref(GAsyncQueue* queue)
+{
+    __atomic_fetch_add(&queue->ref_count, 1, __ATOMIC_RELAXED);
+    return queue;
+}
+
+void g_async_queue_unref(GAsyncQueue* queue)
+{
+    if (__atomic_sub_fetch(&queue->ref_count, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        free(queue);
+    }
+}
+
+static bool g_async_queue_enqueue(GAsyncQueue* queue, void* data)
+{
+    size_t position = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+
+    while (true)
+    {
+        GAsyncQueueCell& cell = queue->cells[position % ASYNC_QUEUE_CAPACITY];
+        const intptr_t difference = intptr_t(__atomic_load_n(&cell.sequence, __ATOMIC_ACQUIRE)) - intptr_t(position);
+
+        if (difference == 0)
+        {
+            if (__atomic_compare_exchange_n(&queue->tail, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                cell.data = data;
+                __atomic_store_n(&cell.sequence, position + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Cell still holds an item from the previous lap
+            return false;
+        }
+        else
+        {
+            position = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void* g_async_queue_dequeue(GAsyncQueue* queue)
+{
+    size_t position = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+
+    while (true)
+    {
+        GAsyncQueueCell& cell = queue->cells[position % ASYNC_QUEUE_CAPACITY];
+        const intptr_t difference = intptr_t(__atomic_load_n(&cell.sequence, __ATOMIC_ACQUIRE)) - intptr_t(position + 1);
+
+        if (difference == 0)
+        {
+            if (__atomic_compare_exchange_n(&queue->head, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                void* data = cell.data;
+                __atomic_store_n(&cell.sequence, position + ASYNC_QUEUE_CAPACITY, __ATOMIC_RELEASE);
+                return data;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Cell was not written yet
+            return nullptr;
+        }
+        else
+        {
+            position = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static inline void g_async_queue_notify(unsigned int* sequence, unsigned int* sleepers)
+{
+    // Pairs with the fence in g_async_queue_park(), either sleeper is seen here or it sees the queue change
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(sleepers, __ATOMIC_RELAXED) != 0)
+    {
+        __atomic_fetch_add(sequence, 1, __ATOMIC_RELEASE);
+        g_address_wake(sequence, true);
+    }
+}
+
+extern "C++"
+{
+
+// Calls attempt until it succeeds or deadline expires, zero deadline means infinite wait
+template <typename Attempt>
+static bool g_async_queue_park(unsigned int* sequence, unsigned int* sleepers, int64_t end_time, Attempt attempt)
+{
+    while (true)
+    {
+        const unsigned int value = __atomic_load_n(sequence, __ATOMIC_ACQUIRE);
+        __atomic_fetch_add(sleepers, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        if (attempt())
+        {
+            __atomic_fetch_sub(sleepers, 1, __ATOMIC_RELAXED);
+            return true;
+        }
+
+        uint32_t timeout_us = 0;
+
+        if (end_time != 0)
+        {
+            const int64_t timeout = end_time - g_get_monotonic_time();
+
+            if (timeout <= 0)
+            {
+                __atomic_fetch_sub(sleepers, 1, __ATOMIC_RELAXED);
+                return false;
+            }
+
+            timeout_us = timeout > UINT32_MAX ? UINT32_MAX : uint32_t(timeout);
+        }
+
+        g_address_wait(sequence, value, timeout_us);
+        __atomic_fetch_sub(sleepers, 1, __ATOMIC_RELAXED);
+    }
+}
+
+}
+
+static inline void* g_async_queue_pop_impl(GAsyncQueue* queue, int64_t end_time)
+{
+    void* data = g_async_queue_dequeue(queue);
+
+    if (data == nullptr)
+    {
+        g_async_queue_park(&queue->pushed, &queue->consumers, end_time,
+            [queue, &data]() { return (data = g_async_queue_dequeue(queue)) != nullptr; });
+    }
+
+    if (data != nullptr)
+    {
+        g_async_queue_notify(&queue->popped, &queue->producers);
+    }
+
+    return data;
+}
+
+void g_async_queue_push(GAsyncQueue* queue, void* data)
+{
+    if (data == nullptr)
+    {
+        return;
+    }
+
+    if (!g_async_queue_enqueue(queue, data))
+    {
+        g_async_queue_park(&queue->popped, &queue->producers, 0,
+            [queue, data]() { return g_async_queue_enqueue(queue, data); });
+    }
+
+    g_async_queue_notify(&queue->pushed, &queue->consumers);
+}
+
+void* g_async_queue_pop(GAsyncQueue* queue)
+{
+    return g_async_queue_pop_impl(queue, 0);
+}
+
+void* g_async_queue_timeout_pop(GAsyncQueue* queue, uint64_t timeout)
+{
+    // Deadline is never zero because monotonic time is positive
+    return g_async_queue_pop_impl(queue, g_get_monotonic_time() + int64_t(timeout));
+}
+
+void* g_async_queue_try_pop(GAsyncQueue* queue)
+{
+    void* data = g_async_queue_dequeue(queue);
+
+    if (data != nullptr)
+    {
+        g_async_queue_notify(&queue->popped, &queue->producers);
+    }
+
+    return data;
+}
+
+int g_async_queue_length(GAsyncQueue* queue)
+{
+    // Like in GLib, number of waiting consumers is subtracted, so the result can be negative
+    const size_t head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    const size_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    const int consumers = int(__atomic_load_n(&queue->consumers, __ATOMIC_RELAXED));
+
+    return int(tail - head) - consumers;
+}
+
+
+using GDestroyNotify = void (*)(void* data);
+
+// Layout must match GLib's struct { gpointer p; GDestroyNotify notify; gpointer future[2]; }
+// p stores pthread key plus one, so zero means that key is not assigned yet
+struct GPrivate
+{
+    uintptr_t key;
+    GDestroyNotify notify;
+    void* future[2];
+};
+
+static_assert(sizeof(GPrivate) == sizeof(void*) * 4, "GPrivate size mismatch");
+
+// Keys are created at once on first use and handed out to GPrivate instances, they are never deleted
+// Destructor of each key is a stub that forwards to the notify function of the assigned GPrivate
+constexpr size_t PRIVATE_KEY_COUNT = 16;
+
+static pthread_key_t g_private_keys[PRIVATE_KEY_COUNT];
+static GDestroyNotify g_private_notifies[PRIVATE_KEY_COUNT];
+static size_t g_private_key_count;
+static bool g_private_keys_created;
+static os_unfair_lock g_private_lock = OS_UNFAIR_LOCK_INIT;
+
+extern "C++"
+{
+
+template <size_t N>
+static void g_private_destroy(void* value)
+{
+    // Thread exit is not a hot path, take the lock to see notify function assigned by another thread
+    os_unfair_lock_lock(&g_private_lock);
+    GDestroyNotify notify = g_private_notifies[N];
+    os_unfair_lock_unlock(&g_private_lock);
+
+    if (notify != nullptr)
+    {
+        notify(value);
+    }
+}
+
+template <size_t... N>
+static void g_private_create_keys(std::index_sequence<N...>)
+{
+    static const GDestroyNotify destructors[] = { g_private_destroy<N>... };
+
+    for (size_t i = 0; i < PRIVATE_KEY_COUNT; ++i)
+    {
+        pthread_key_create(&g_private_keys[i], destructors[i]);
+    }
+}
+
+}
+
+static __attribute__((noinline)) uintptr_t g_private_assign_key(GPrivate* key)
+{
+    os_unfair_lock_lock(&g_private_lock);
+
+    uintptr_t impl = key->key;
+
+    if (impl == 0)
+    {
+        if (!g_private_keys_created)
+        {
+            g_private_create_keys(std::make_index_sequence<PRIVATE_KEY_COUNT>());
+            g_private_keys_created = true;
+        }
+
+        pthread_key_t pthread_key;
+
+        if (g_private_key_count < PRIVATE_KEY_COUNT)
+        {
+            const size_t index = g_private_key_count++;
+            g_private_notifies[index] = key->notify;
+            pthread_key = g_private_keys[index];
+        }
+        else
+        {
+            // Preallocated keys are exhausted
+            pthread_key_create(&pthread_key, key->notify);
+        }
+
+        impl = uintptr_t(pthread_key) + 1;
+        __atomic_store_n(&key->key, impl, __ATOMIC_RELAXED);
+    }
+
+    os_unfair_lock_unlock(&g_private_lock);
+
+    return impl;
+}
+
+static inline pthread_key_t g_private_get_impl(GPrivate* key)
+{
+    // Key is a plain integer which is published once, so there is nothing to order with a barrier
+    uintptr_t impl = __atomic_load_n(&key->key, __ATOMIC_RELAXED);
+
+    if (__builtin_expect(impl == 0, 0))
+    {
+        impl = g_private_assign_key(key);
+    }
+
+    return pthread_key_t(impl - 1);
+}
+
+void* g_private_get(GPrivate* key)
+{
+    return pthread_getspecific(g_private_get_impl(key));
+}
+
+void g_private_set(GPrivate* key, void* value)
+{
+    pthread_setspecific(g_private_get_impl(key), value);
+}
+
+
+struct GThread
+{
+    pthread_t thread;
+    int ref_count;
+};
+
+using GThreadFunc = void* (*)(void* data);
+
+// Thread scheduling can be adjusted with the following environment variables
+// QUASI_GLIB_THREAD_QOS: QoS class of created threads, one of user-interactive (default), user-initiated,
+//   default, utility, background, or inherit to keep creator's QoS
+// QUASI_GLIB_AUDIO_PERIOD: audio period in microseconds, when set, FluidSynth's audio rendering threads
+//   are switched to real-time scheduling with time constraint policy sized to this period
+
+static const char* const AUDIO_THREAD_NAME_PREFIXES[] =
+{
+    "mixer",  // FluidSynth's parallel voice rendering
+};
+
+static qos_class_t g_thread_qos_class()
+{
+    static const struct
+    {
+        const char* name;
+        qos_class_t qos_class;
+    }
+    QOS_CLASSES[] =
+    {
+        { "user-interactive", QOS_CLASS_USER_INTERACTIVE },
+        { "user-initiated", QOS_CLASS_USER_INITIATED },
+        { "default", QOS_CLASS_DEFAULT },
+        { "utility", QOS_CLASS_UTILITY },
+        { "background", QOS_CLASS_BACKGROUND },
+        { "inherit", QOS_CLASS_UNSPECIFIED },
+    };
+
+    if (const char* value = getenv("QUASI_GLIB_THREAD_QOS"))
+    {
+        for (const auto& entry : QOS_CLASSES)
+        {
+            if (strcmp(value, entry.name) == 0)
+            {
+                return entry.qos_class;
+            }
+        }
+    }
+
+    return QOS_CLASS_USER_INTERACTIVE;
+}
+
+static bool g_thread_is_audio(const char* name)
+{
+    for (const char* prefix : AUDIO_THREAD_NAME_PREFIXES)
+    {
+        if (strncmp(name, prefix, strlen(prefix)) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void g_thread_set_realtime()
+{
+    const char* value = getenv("QUASI_GLIB_AUDIO_PERIOD");
+    const uint64_t period_us = value ? strtoull(value, nullptr, 10) : 0;
+
+    if (period_us == 0)
+    {
+        return;
+    }
+
+    // Allow rendering to take up to a half of audio period, and require it to be done within the period
+    const uint32_t period = uint32_t(g_ns_to_ticks(period_us * 1000));
+
+    thread_time_constraint_policy_data_t policy;
+    policy.period = period;
+    policy.computation = period / 2;
+    policy.constraint = period;
+    policy.preemptible = 1;
+
+    thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+        thread_policy_t(&policy), THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+}
+
+struct GThreadStart
+{
+    GThreadFunc func;
+    void* data;
+    char name[64];
+};
+
+static void* g_thread_start(void* arg)
+{
+    GThreadStart* start = static_cast<GThreadStart*>(arg);
+    GThreadFunc func = start->func;
+    void* data = start->data;
+
+    // Thread name can be set for the current thread only
+    if (start->name[0] != '\0')
+    {
+        pthread_setname_np(start->name);
+
+        if (g_thread_is_audio(start->name))
+        {
+            g_thread_set_realtime();
+        }
+    }
+
+    g_internal_delete(start);
+
+    return func(data);
+}
+
+GThread* g_thread_try_new(const char* name, GThreadFunc func, void* data, GError** error)
+{
+    if (error != nullptr)
+    {
+        *error = nullptr;
+    }
+
+    GThreadStart* start = g_internal_new<GThreadStart>();
+    start->func = func;
+    start->data = data;
+    start->name[0] = '\0';
+
+    if (name != nullptr)
+    {
+        strlcpy(start->name, name, sizeof start->name);
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+
+    const qos_class_t qos_class = g_thread_qos_class();
+
+    if (qos_class != QOS_CLASS_UNSPECIFIED)
+    {
+        pthread_attr_set_qos_class_np(&attr, qos_class, 0);
+    }
+
+    GThread* thread = g_internal_new<GThread>();
+    pthread_create(&thread->thread, &attr, g_thread_start, start);
+    thread->ref_count = 1;
+
+    pthread_attr_destroy(&attr);
+
+    return thread;
+}
+
+void* g_thread_join(GThread* thread)
+{
+    void* result = nullptr;
+    pthread_join(thread->thread, &result);
+    return result;
+}
+
+void g_thread_unref(GThread* thread)
+{
+    if (__sync_sub_and_fetch(&thread->ref_count, 1) == 0)
+    {
+        g_thread_join(thread);
+        g_internal_delete(thread);
+    }
+}
+
+
+using GFunc = void (*)(void* data, void* user_data);
+
+struct GThreadPoolTask
+{
+    GThreadPoolTask* next;
+    void* data;
+};
+
+// Public part of layout must match GLib's struct { GFunc func; gpointer user_data; gboolean exclusive; }
+// Tasks are executed on a global dispatch queue, exclusive pools are treated as shared ones
+// Number of workers is limited by max_threads, negative value means no limit like in GLib,
+// dispatch queue caps the number of threads that actually run concurrently
+struct GThreadPool
+{
+    GFunc func;
+    void* user_data;
+    int exclusive;
+
+    os_unfair_lock lock;
+    GThreadPoolTask* head;
+    GThreadPoolTask* tail;
+    unsigned int unprocessed;
+    int max_threads;
+    int num_threads;
+    int idle_threads;
+    bool stopped;
+
+    dispatch_queue_t queue;
+    dispatch_group_t group;
+};
+
+static void g_thread_pool_worker(void* context)
+{
+    GThreadPool* pool = static_cast<GThreadPool*>(context);
+
+    // Newly started worker is counted as idle until it takes a task
+    for (bool busy = false; ; busy = true)
+    {
+        os_unfair_lock_lock(&pool->lock);
+
+        if (busy)
+        {
+            ++pool->idle_threads;
+        }
+
+        GThreadPoolTask* task = pool->head;
+
+        if (task == nullptr || pool->stopped || (pool->max_threads >= 0 && pool->num_threads > pool->max_threads))
+        {
+            --pool->num_threads;
+            --pool->idle_threads;
+            os_unfair_lock_unlock(&pool->lock);
+            return;
+        }
+
+        pool->head = task->next;
+
+        if (pool->head == nullptr)
+        {
+            pool->tail = nullptr;
+        }
+
+        --pool->unprocessed;
+        --pool->idle_threads;
+
+        os_unfair_lock_unlock(&pool->lock);
+
+        pool->func(task->data, pool->user_data);
+        g_internal_delete(task);
+    }
+}
+
+// Must be called with pool's lock held
+// Workers busy with their tasks don't count, only idle ones will pick up unprocessed tasks
+static void g_thread_pool_start_workers(GThreadPool* pool)
+{
+    while (unsigned(pool->idle_threads) < pool->unprocessed
+        && (pool->max_threads < 0 || pool->num_threads < pool->max_threads))
+    {
+        ++pool->num_threads;
+        ++pool->idle_threads;
+        dispatch_group_async_f(pool->group, pool->queue, pool, g_thread_pool_worker);
+    }
+}
+
+GThreadPool* g_thread_pool_new(GFunc func, void* user_data, int max_threads, int exclusive, GError** error)
+{
+    if (error != nullptr)
+    {
+        *error = nullptr;
+    }
+
+    GThreadPool* pool = g_internal_new<GThreadPool>();
+    pool->func = func;
+    pool->user_data = user_data;
+    pool->exclusive = exclusive;
+    pool->lock = OS_UNFAIR_LOCK_INIT;
+    pool->head = nullptr;
+    pool->tail = nullptr;
+    pool->unprocessed = 0;
+    pool->max_threads = max_threads;
+    pool->num_threads = 0;
+    pool->idle_threads = 0;
+    pool->stopped = false;
+    pool->queue = dispatch_get_global_queue(g_thread_qos_class(), 0);
+    pool->group = dispatch_group_create();
+
+    return pool;
+}
+
+int g_thread_pool_push(GThreadPool* pool, void* data, GError** error)
+{
+    if (error != nullptr)
+    {
+        *error = nullptr;
+    }
+
+    GThreadPoolTask* task = g_internal_new<GThreadPoolTask>();
+    task->next = nullptr;
+    task->data = data;
+
+    os_unfair_lock_lock(&pool->lock);
+
+    if (pool->tail == nullptr)
+    {
+        pool->head = task;
+    }
+    else
+    {
+        pool->tail->next = task;
+    }
+
+    pool->tail = task;
+    ++pool->unprocessed;
+
+    g_thread_pool_start_workers(pool);
+
+    os_unfair_lock_unlock(&pool->lock);
+
+    return 1;
+}
+
+int g_thread_pool_set_max_threads(GThreadPool* pool, int max_threads, GError** error)
+{
+    if (error != nullptr)
+    {
+        *error = nullptr;
+    }
+
+    os_unfair_lock_lock(&pool->lock);
+
+    // Extra workers exit after finishing their current tasks
+    pool->max_threads = max_threads;
+    g_thread_pool_start_workers(pool);
+
+    os_unfair_lock_unlock(&pool->lock);
+
+    return 1;
+}
+
+int g_thread_pool_get_max_threads(GThreadPool* pool)
+{
+    os_unfair_lock_lock(&pool->lock);
+    const int max_threads = pool->max_threads;
+    os_unfair_lock_unlock(&pool->lock);
+
+    return max_threads;
+}
+
+unsigned int g_thread_pool_get_num_threads(GThreadPool* pool)
+{
+    os_unfair_lock_lock(&pool->lock);
+    const unsigned int num_threads = pool->num_threads;
+    os_unfair_lock_unlock(&pool->lock);
+
+    return num_threads;
+}
+
+unsigned int g_thread_pool_unprocessed(GThreadPool* pool)
+{
+    os_unfair_lock_lock(&pool->lock);
+    const unsigned int unprocessed = pool->unprocessed;
+    os_unfair_lock_unlock(&pool->lock);
+
+    return unprocessed;
+}
+
+static void g_thread_pool_destroy(void* context)
+{
+    GThreadPool* pool = static_cast<GThreadPool*>(context);
+
+    for (GThreadPoolTask* task = pool->head; task != nullptr; )
+    {
+        GThreadPoolTask* next = task->next;
+        g_internal_delete(task);
+        task = next;
+    }
+
+    dispatch_release(pool->group);
+    g_internal_delete(pool);
+}
+
+void g_thread_pool_free(GThreadPool* pool, int immediate, int wait_)
+{
+    os_unfair_lock_lock(&pool->lock);
+
+    if (immediate)
+    {
+        // Unprocessed tasks are discarded, running ones are allowed to finish
+        pool->stopped = true;
+    }
+
+    os_unfair_lock_unlock(&pool->lock);
+
+    if (wait_)
+    {
+        dispatch_group_wait(pool->group, DISPATCH_TIME_FOREVER);
+        g_thread_pool_destroy(pool);
+    }
+    else
+    {
+        dispatch_group_notify_f(pool->group, pool->queue, pool, g_thread_pool_destroy);
+    }
+}
+
+
+// Layout must match GLib's struct { gchar* str; gsize len; gsize allocated_len; }
+// Storage always has room for terminating null character
+struct GString
+{
+    char* str;
+    size_t len;
+    size_t allocated_len;
+};
+
+static void g_string_reserve(GString* string, size_t length)
+{
+    if (length < string->allocated_len)
+    {
+        return;
+    }
+
+    size_t capacity = string->allocated_len < 16 ? 16 : string->allocated_len;
+
+    while (capacity <= length)
+    {
+        capacity *= 2;
+    }
+
+    string->str = static_cast<char*>(g_realloc(string->str, capacity));
+    string->allocated_len = capacity;
+}
+
+GString* g_string_sized_new(size_t dfl_size)
+{
+    GString* string = static_cast<GString*>(g_slice_alloc(sizeof(GString)));
+    *string = GString{ nullptr, 0, 0 };
+
+    g_string_reserve(string, dfl_size);
+    string->str[0] = '\0';
+
+    return string;
+}
+
+GString* g_string_insert_len(GString* string, ptrdiff_t pos, const char* val, ptrdiff_t len)
+{
+    const size_t length = len < 0 ? strlen(val) : size_t(len);
+    const size_t position = pos < 0 ? string->len : size_t(pos);
+
+    // Value may point inside of the string itself
+    const size_t offset = size_t(val - string->str);
+    const bool inside = val >= string->str && offset <= string->len;
+
+    g_string_reserve(string, string->len + length);
+    memmove(string->str + position + length, string->str + position, string->len - position + 1);
+
+    if (!inside)
+    {
+        memcpy(string->str + position, val, length);
+    }
+    else if (offset + length <= position)
+    {
+        memcpy(string->str + position, string->str + offset, length);
+    }
+    else if (offset >= position)
+    {
+        // Value was moved together with the tail
+        memcpy(string->str + position, string->str + offset + length, length);
+    }
+    else
+    {
+        // Value spans insertion position, its second part was moved together with the tail
+        const size_t precount = position - offset;
+        memcpy(string->str + position, string->str + offset, precount);
+        memcpy(string->str + position + precount, string->str + position + length, length - precount);
+    }
+
+    string->len += length;
+
+    return string;
+}
+
+GString* g_string_new(const char* init)
+{
+    if (init == nullptr || *init == '\0')
+    {
+        return g_string_sized_new(2);
+    }
+
+    const size_t length = strlen(init);
+    GString* string = g_string_sized_new(length + 2);
+
+    return g_string_insert_len(string, -1, init, ptrdiff_t(length));
+}
+
+GString* g_string_new_len(const char* init, ptrdiff_t len)
+{
+    if (len < 0)
+    {
+        return g_string_new(init);
+    }
+
+    GString* string = g_string_sized_new(size_t(len));
+    return init == nullptr ? string : g_string_insert_len(string, -1, init, len);
+}
+
+char* g_string_free(GString* string, int free_segment)
+{
+    char* segment = string->str;
+
+    if (free_segment)
+    {
+        g_free(segment);
+        segment = nullptr;
+    }
+
+    g_slice_free1(sizeof(GString), string);
+    return segment;
+}
+
+GString* g_string_assign(GString* string, const char* rval)
+{
+    if (string->str != rval)
+    {
+        string->len = 0;
+        g_string_insert_len(string, -1, rval, -1);
+    }
+
+    return string;
+}
+
+GString* g_string_truncate(GString* string, size_t len)
+{
+    string->len = len < string->len ? len : string->len;
+    string->str[string->len] = '\0';
+
+    return string;
+}
+
+GString* g_string_set_size(GString* string, size_t len)
+{
+    g_string_reserve(string, len);
+
+    string->len = len;
+    string->str[len] = '\0';
+
+    return string;
+}
+
+GString* g_string_append_len(GString* string, const char* val, ptrdiff_t len)
+{
+    return g_string_insert_len(string, -1, val, len);
+}
+
+GString* g_string_append(GString* string, const char* val)
+{
+    return g_string_insert_len(string, -1, val, -1);
+}
+
+GString* g_string_insert_c(GString* string, ptrdiff_t pos, char c)
+{
+    return g_string_insert_len(string, pos, &c, 1);
+}
+
+GString* g_string_append_c(GString* string, char c)
+{
+    g_string_reserve(string, string->len + 1);
+
+    string->str[string->len++] = c;
+    string->str[string->len] = '\0';
+
+    return string;
+}
+
+GString* g_string_prepend(GString* string, const char* val)
+{
+    return g_string_insert_len(string, 0, val, -1);
+}
+
+GString* g_string_erase(GString* string, ptrdiff_t pos, ptrdiff_t len)
+{
+    const size_t position = size_t(pos);
+    const size_t length = len < 0 ? string->len - position : size_t(len);
+
+    memmove(string->str + position, string->str + position + length, string->len - position - length + 1);
+    string->len -= length;
+
+    return string;
+}
+
+void g_string_append_vprintf(GString* string, const char* format, va_list args)
+{
+    va_list copy;
+    va_copy(copy, args);
+
+    char buffer[256];
+    const int length = vsnprintf(buffer, sizeof buffer, format, copy);
+    va_end(copy);
+
+    if (length < 0)
+    {
+        return;
+    }
+
+    if (size_t(length) < sizeof buffer)
+    {
+        g_string_insert_len(string, -1, buffer, length);
+        return;
+    }
+
+    // Format directly into the string when result doesn't fit the buffer
+    g_string_reserve(string, string->len + size_t(length));
+    vsnprintf(string->str + string->len, size_t(length) + 1, format, args);
+    string->len += size_t(length);
+}
+
+void g_string_append_printf(GString* string, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    g_string_append_vprintf(string, format, args);
+    va_end(args);
+}
+
+void g_string_printf(GString* string, const char* format, ...)
+{
+    string->len = 0;
+
+    va_list args;
+    va_start(args, format);
+    g_string_append_vprintf(string, format, args);
+    va_end(args);
+}
+
+
+// Splits command line like POSIX shell does, without expansions and substitutions
+// Single quotes preserve everything, double quotes allow backslash escapes of $ ` " \ and newline
+
+constexpr uint32_t SHELL_ERROR_DOMAIN = 1;
+
+enum GShellError
+{
+    G_SHELL_ERROR_BAD_QUOTING,
+    G_SHELL_ERROR_EMPTY_STRING,
+    G_SHELL_ERROR_FAILED
+};
+
+int g_shell_parse_argv(const char* command_line, int* argcp, char*** argvp, GError** error)
+{
+    size_t count = 0;
+    size_t capacity = 8;
+    char** argv = static_cast<char**>(g_malloc(capacity * sizeof(char*)));
+
+    GString* word = nullptr;
+    const char* error_message = nullptr;
+    GShellError error_code = G_SHELL_ERROR_BAD_QUOTING;
+
+    for (const char* ch = command_line; ; ++ch)
+    {
+        const bool separator = *ch == '\0' || *ch == ' ' || *ch == '\t' || *ch == '\n';
+
+        if (separator)
+        {
+            if (word != nullptr)
+            {
+                if (count + 1 == capacity)
+                {
+                    capacity *= 2;
+                    argv = static_cast<char**>(g_realloc(argv, capacity * sizeof(char*)));
+                }
+
+                argv[count++] = g_string_free(word, false);
+                word = nullptr;
+            }
+
+            if (*ch == '\0')
+            {
+                break;
+            }
+
+            continue;
+        }
+
+        if (*ch == '#' && word == nullptr)
+        {
+            // Comment lasts until the end of line
+            while (ch[1] != '\0' && ch[1] != '\n')
+            {
+                ++ch;
+            }
+
+            continue;
+        }
+
+        if (word == nullptr)
+        {
+            word = g_string_sized_new(16);
+        }
+
+        if (*ch == '\\')
+        {
+            if (ch[1] == '\n')
+            {
+                // Line continuation
+                ++ch;
+            }
+            else if (ch[1] != '\0')
+            {
+                g_string_append_c(word, *++ch);
+            }
+            else
+            {
+                g_string_append_c(word, '\\');
+            }
+        }
+        else if (*ch == '\'')
+        {
+            const char* end = strchr(ch + 1, '\'');
+
+            if (end == nullptr)
+            {
+                error_message = "Text ended before matching quote was found for '.";
+                break;
+            }
+
+            for (++ch; ch != end; ++ch)
+            {
+                g_string_append_c(word, *ch);
+            }
+        }
+        else if (*ch == '"')
+        {
+            for (++ch; *ch != '"'; ++ch)
+            {
+                if (*ch == '\0')
+                {
+                    error_message = "Text ended before matching quote was found for \".";
+                    break;
+                }
+
+                if (*ch == '\\' && ch[1] != '\0' && strchr("$`\"\\\n", ch[1]) != nullptr)
+                {
+                    if (*++ch == '\n')
+                    {
+                        continue;
+                    }
+                }
+
+                g_string_append_c(word, *ch);
+            }
+
+            if (error_message != nullptr)
+            {
+                break;
+            }
+        }
+        else
+        {
+            g_string_append_c(word, *ch);
+        }
+    }
+
+    argv[count] = nullptr;
+
+    if (error_message == nullptr && count == 0)
+    {
+        error_message = "Text was empty (or contained only whitespace)";
+        error_code = G_SHELL_ERROR_EMPTY_STRING;
+    }
+
+    if (error_message != nullptr)
+    {
+        if (word != nullptr)
+        {
+            g_string_free(word, true);
+        }
+
+        g_strfreev(argv);
+        g_set_error_literal(error, SHELL_ERROR_DOMAIN, error_code, error_message);
+
+        return 0;
+    }
+
+    if (argcp != nullptr)
+    {
+        *argcp = int(count);
+    }
+
+    if (argvp != nullptr)
+    {
+        *argvp = argv;
+    }
+    else
+    {
+        g_strfreev(argv);
+    }
+
+    return 1;
+}
+
+
+// Public part must match GLib's struct { gchar* data; guint len; }
+struct GArray
+{
+    char* data;
+    unsigned int len;
+
+    unsigned int capacity;
+    unsigned int element_size;
+    bool zero_terminated;
+    bool clear;
+    int ref_count;
+};
+
+static inline char* g_array_element(GArray* array, unsigned int index)
+{
+    return array->data + size_t(index) * array->element_size;
+}
+
+static void g_array_reserve(GArray* array, unsigned int length)
+{
+    // Room for terminating zero element is kept when requested
+    const unsigned int required = length + array->zero_terminated;
+
+    if (required <= array->capacity)
+    {
+        return;
+    }
+
+    unsigned int capacity = array->capacity < 16 ? 16 : array->capacity;
+
+    while (capacity < required)
+    {
+        capacity *= 2;
+    }
+
+    array->data = static_cast<char*>(g_realloc(array->data, size_t(capacity) * array->element_size));
+    array->capacity = capacity;
+}
+
+static inline void g_array_terminate(GArray* array)
+{
+    if (array->zero_terminated)
+    {
+        memset(g_array_element(array, array->len), 0, array->element_size);
+    }
+}
+
+GArray* g_array_sized_new(int zero_terminated, int clear_, unsigned int element_size, unsigned int reserved_size)
+{
+    GArray* array = static_cast<GArray*>(g_slice_alloc(sizeof(GArray)));
+    *array = GArray{ nullptr, 0, 0, element_size, zero_terminated != 0, clear_ != 0, 1 };
+
+    if (reserved_size != 0 || array->zero_terminated)
+    {
+        g_array_reserve(array, reserved_size);
+        g_array_terminate(array);
+    }
+
+    return array;
+}
+
+GArray* g_array_new(int zero_terminated, int clear_, unsigned int element_size)
+{
+    return g_array_sized_new(zero_terminated, clear_, element_size, 0);
+}
+
+char* g_array_free(GArray* array, int free_segment)
+{
+    char* segment = array->data;
+
+    if (free_segment)
+    {
+        g_free(segment);
+        segment = nullptr;
+    }
+
+    g_slice_free1(sizeof(GArray), array);
+    return segment;
+}
+
+GArray* g_array_ref(GArray* array)
+{
+    __atomic_fetch_add(&array->ref_count, 1, __ATOMIC_RELAXED);
+    return array;
+}
+
+void g_array_unref(GArray* array)
+{
+    if (__atomic_sub_fetch(&array->ref_count, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        g_array_free(array, true);
+    }
+}
+
+unsigned int g_array_get_element_size(GArray* array)
+{
+    return array->element_size;
+}
+
+GArray* g_array_insert_vals(GArray* array, unsigned int index, const void* data, unsigned int len)
+{
+    if (index > array->len)
+    {
+        // Like GLib, insertion past the end grows the array, and the gap is zeroed
+        g_array_reserve(array, index + len);
+        memset(g_array_element(array, array->len), 0, size_t(index - array->len) * array->element_size);
+        array->len = index;
+    }
+    else
+    {
+        g_array_reserve(array, array->len + len);
+    }
+
+    memmove(g_array_element(array, index + len), g_array_element(array, index), size_t(array->len - index) * array->element_size);
+    memcpy(g_array_element(array, index), data, size_t(len) * array->element_size);
+
+    array->len += len;
+    g_array_terminate(array);
+
+    return array;
+}
+
+GArray* g_array_append_vals(GArray* array, const void* data, unsigned int len)
+{
+    return g_array_insert_vals(array, array->len, data, len);
+}
+
+GArray* g_array_prepend_vals(GArray* array, const void* data, unsigned int len)
+{
+    return g_array_insert_vals(array, 0, data, len);
+}
+
+GArray* g_array_set_size(GArray* array, unsigned int length)
+{
+    g_array_reserve(array, length);
+
+    if (length > array->len && (array->clear || array->zero_terminated))
+    {
+        memset(g_array_element(array, array->len), 0, size_t(length - array->len) * array->element_size);
+    }
+
+    array->len = length;
+    g_array_terminate(array);
+
+    return array;
+}
+
+GArray* g_array_remove_index(GArray* array, unsigned int index)
+{
+    memmove(g_array_element(array, index), g_array_element(array, index + 1), size_t(array->len - index - 1) * array->element_size);
+
+    --array->len;
+    g_array_terminate(array);
+
+    return array;
+}
+
+GArray* g_array_remove_index_fast(GArray* array, unsigned int index)
+{
+    if (index != array->len - 1)
+    {
+        memcpy(g_array_element(array, index), g_array_element(array, array->len - 1), array->element_size);
+    }
+
+    --array->len;
+    g_array_terminate(array);
+
+    return array;
+}
+
+
+// Layout must match GLib's struct { gpointer data; GList* next; GList* prev; }
+// Nodes are allocated with g_slice_alloc(), so they benefit from slab allocator when it's enabled
+struct GList
+{
+    void* data;
+    GList* next;
+    GList* prev;
+};
+
+using GCompareFunc = int (*)(const void* a, const void* b);
+
+GList* g_list_alloc()
+{
+    return static_cast<GList*>(g_slice_alloc0(sizeof(GList)));
+}
+
+void g_list_free_1(GList* list)
+{
+    g_slice_free1(sizeof(GList), list);
+}
+
+void g_list_free(GList* list)
+{
+    while (list != nullptr)
+    {
+        GList* next = list->next;
+        g_list_free_1(list);
+        list = next;
+    }
+}
+
+void g_list_free_full(GList* list, GDestroyNotify free_func)
+{
+    for (GList* node = list; node != nullptr; node = node->next)
+    {
+        free_func(node->data);
+    }
+
+    g_list_free(list);
+}
+
+GList* g_list_last(GList* list)
+{
+    if (list != nullptr)
+    {
+        while (list->next != nullptr)
+        {
+            list = list->next;
+        }
+    }
+
+    return list;
+}
+
+GList* g_list_first(GList* list)
+{
+    if (list != nullptr)
+    {
+        while (list->prev != nullptr)
+        {
+            list = list->prev;
+        }
+    }
+
+    return list;
+}
+
+unsigned int g_list_length(GList* list)
+{
+    unsigned int length = 0;
+
+    for (; list != nullptr; list = list->next)
+    {
+        ++length;
+    }
+
+    return length;
+}
+
+GList* g_list_append(GList* list, void* data)
+{
+    GList* node = static_cast<GList*>(g_slice_alloc(sizeof(GList)));
+    GList* last = g_list_last(list);
+
+    *node = GList{ data, nullptr, last };
+
+    if (last == nullptr)
+    {
+        return node;
+    }
+
+    last->next = node;
+    return list;
+}
+
+GList* g_list_prepend(GList* list, void* data)
+{
+    GList* node = static_cast<GList*>(g_slice_alloc(sizeof(GList)));
+    *node = GList{ data, list, nullptr };
+
+    if (list != nullptr)
+    {
+        // List may point into the middle, keep backward links consistent like GLib does
+        node->prev = list->prev;
+
+        if (list->prev != nullptr)
+        {
+            list->prev->next = node;
+        }
+
+        list->prev = node;
+    }
+
+    return node;
+}
+
+GList* g_list_nth(GList* list, unsigned int n)
+{
+    while (n-- > 0 && list != nullptr)
+    {
+        list = list->next;
+    }
+
+    return list;
+}
+
+void* g_list_nth_data(GList* list, unsigned int n)
+{
+    list = g_list_nth(list, n);
+    return list == nullptr ? nullptr : list->data;
+}
+
+GList* g_list_insert(GList* list, void* data, int position)
+{
+    if (position < 0)
+    {
+        return g_list_append(list, data);
+    }
+
+    if (position == 0)
+    {
+        return g_list_prepend(list, data);
+    }
+
+    GList* next = g_list_nth(list, unsigned(position));
+
+    if (next == nullptr)
+    {
+        return g_list_append(list, data);
+    }
+
+    g_list_prepend(next, data);
+    return list;
+}
+
+GList* g_list_concat(GList* list1, GList* list2)
+{
+    if (list2 == nullptr)
+    {
+        return list1;
+    }
+
+    GList* last = g_list_last(list1);
+
+    if (last == nullptr)
+    {
+        return list2;
+    }
+
+    last->next = list2;
+    list2->prev = last;
+
+    return list1;
+}
+
+GList* g_list_remove_link(GList* list, GList* link)
+{
+    if (link == nullptr)
+    {
+        return list;
+    }
+
+    if (link->prev != nullptr)
+    {
+        link->prev->next = link->next;
+    }
+
+    if (link->next != nullptr)
+    {
+        link->next->prev = link->prev;
+    }
+
+    if (link == list)
+    {
+        list = list->next;
+    }
+
+    link->next = nullptr;
+    link->prev = nullptr;
+
+    return list;
+}
+
+GList* g_list_delete_link(GList* list, GList* link)
+{
+    list = g_list_remove_link(list, link);
+    g_list_free_1(link);
+
+    return list;
+}
+
+GList* g_list_find(GList* list, const void* data)
+{
+    while (list != nullptr && list->data != data)
+    {
+        list = list->next;
+    }
+
+    return list;
+}
+
+GList* g_list_find_custom(GList* list, const void* data, GCompareFunc func)
+{
+    while (list != nullptr && func(list->data, data) != 0)
+    {
+        list = list->next;
+    }
+
+    return list;
+}
+
+GList* g_list_remove(GList* list, const void* data)
+{
+    GList* link = g_list_find(list, data);
+    return link == nullptr ? list : g_list_delete_link(list, link);
+}
+
+int g_list_index(GList* list, const void* data)
+{
+    for (int index = 0; list != nullptr; list = list->next, ++index)
+    {
+        if (list->data == data)
+        {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+GList* g_list_reverse(GList* list)
+{
+    GList* last = nullptr;
+
+    while (list != nullptr)
+    {
+        last = list;
+        list = last->next;
+        last->next = last->prev;
+        last->prev = list;
+    }
+
+    return last;
+}
+
+GList* g_list_copy(GList* list)
+{
+    GList* copy = nullptr;
+
+    for (; list != nullptr; list = list->next)
+    {
+        copy = g_list_prepend(copy, list->data);
+    }
+
+    return g_list_reverse(copy);
+}
+
+void g_list_foreach(GList* list, GFunc func, void* user_data)
+{
+    while (list != nullptr)
+    {
+        // Function may remove the current node
+        GList* next = list->next;
+        func(list->data, user_data);
+        list = next;
+    }
+}
+
+static GList* g_list_merge_sort(GList* list, GCompareFunc compare_func)
+{
+    if (list == nullptr || list->next == nullptr)
+    {
+        return list;
+    }
+
+    // Split in halves, only forward links are maintained until the end of sorting
+    GList* slow = list;
+
+    for (GList* fast = list->next; fast != nullptr && fast->next != nullptr; fast = fast->next->next)
+    {
+        slow = slow->next;
+    }
+
+    GList* second = slow->next;
+    slow->next = nullptr;
+
+    GList* a = g_list_merge_sort(list, compare_func);
+    GList* b = g_list_merge_sort(second, compare_func);
+
+    GList head = {};
+    GList* tail = &head;
+
+    // Taking from the first half on equality keeps sorting stable
+    while (a != nullptr && b != nullptr)
+    {
+        GList*& source = compare_func(a->data, b->data) <= 0 ? a : b;
+        tail->next = source;
+        tail = source;
+        source = source->next;
+    }
+
+    tail->next = a != nullptr ? a : b;
+    return head.next;
+}
+
+GList* g_list_sort(GList* list, GCompareFunc compare_func)
+{
+    list = g_list_merge_sort(list, compare_func);
+
+    GList* prev = nullptr;
+
+    for (GList* node = list; node != nullptr; node = node->next)
+    {
+        node->prev = prev;
+        prev = node;
+    }
+
+    return list;
+}
+
+GList* g_list_insert_sorted(GList* list, void* data, GCompareFunc func)
+{
+    GList* node = list;
+    GList* last = nullptr;
+
+    for (; node != nullptr && func(data, node->data) > 0; node = node->next)
+    {
+        last = node;
+    }
+
+    if (node == nullptr)
+    {
+        if (last == nullptr)
+        {
+            return g_list_prepend(nullptr, data);
+        }
+
+        GList* added = static_cast<GList*>(g_slice_alloc(sizeof(GList)));
+        *added = GList{ data, nullptr, last };
+        last->next = added;
+
+        return list;
+    }
+
+    GList* added = g_list_prepend(node, data);
+    return node == list ? added : list;
+}
+
+
+// Open addressing hash table with linear probing
+// Hashes, keys and values are stored in separate arrays, so probing touches only compact array of hashes
+// Hash values 0 and 1 mark empty and deleted slots, real hashes are remapped to avoid them
+
+using GHashFunc = unsigned int (*)(const void* key);
+using GEqualFunc = int (*)(const void* a, const void* b);
+using GHFunc = void (*)(void* key, void* value, void* user_data);
+using GHRFunc = int (*)(void* key, void* value, void* user_data);
+
+constexpr unsigned int HASH_EMPTY = 0;
+constexpr unsigned int HASH_DELETED = 1;
+constexpr unsigned int HASH_MIN_CAPACITY = 8;
+
+struct GHashTable
+{
+    unsigned int capacity;
+    unsigned int count;
+    // Occupied plus deleted slots
+    unsigned int used;
+    int ref_count;
+
+    unsigned int* hashes;
+    void** keys;
+    void** values;
+
+    GHashFunc hash_func;
+    GEqualFunc key_equal_func;
+    GDestroyNotify key_destroy_func;
+    GDestroyNotify value_destroy_func;
+};
+
+unsigned int g_direct_hash(const void* v)
+{
+    return unsigned(uintptr_t(v));
+}
+
+int g_direct_equal(const void* v1, const void* v2)
+{
+    return v1 == v2;
+}
+
+unsigned int g_int_hash(const void* v)
+{
+    return *static_cast<const int*>(v);
+}
+
+int g_int_equal(const void* v1, const void* v2)
+{
+    return *static_cast<const int*>(v1) == *static_cast<const int*>(v2);
+}
+
+unsigned int g_str_hash(const void* v)
+{
+    // Same DJB hash as in GLib, so iteration order and performance characteristics are comparable
+    unsigned int hash = 5381;
+
+    for (const signed char* p = static_cast<const signed char*>(v); *p != '\0'; ++p)
+    {
+        hash = (hash << 5) + hash + *p;
+    }
+
+    return hash;
+}
+
+int g_str_equal(const void* v1, const void* v2)
+{
+    return strcmp(static_cast<const char*>(v1), static_cast<const char*>(v2)) == 0;
+}
+
+static inline unsigned int g_hash_table_hash(GHashTable* hash_table, const void* key)
+{
+    // Finalizer of MurmurHash3 spreads aligned pointers and sequential integers over the whole table
+    unsigned int hash = hash_table->hash_func(key);
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+
+    return hash < 2 ? hash + 2 : hash;
+}
+
+static void g_hash_table_allocate(GHashTable* hash_table, unsigned int capacity)
+{
+    hash_table->capacity = capacity;
+    hash_table->hashes = static_cast<unsigned int*>(g_malloc0(capacity * sizeof(unsigned int)));
+    hash_table->keys = static_cast<void**>(g_malloc(capacity * sizeof(void*)));
+    hash_table->values = static_cast<void**>(g_malloc(capacity * sizeof(void*)));
+}
+
+static void g_hash_table_resize(GHashTable* hash_table)
+{
+    // Rehashing in place is not possible, so old arrays are kept until all entries are moved
+    unsigned int capacity = HASH_MIN_CAPACITY;
+
+    while (capacity / 2 < hash_table->count + 1)
+    {
+        capacity *= 2;
+    }
+
+    const unsigned int old_capacity = hash_table->capacity;
+    unsigned int* old_hashes = hash_table->hashes;
+    void** old_keys = hash_table->keys;
+    void** old_values = hash_table->values;
+
+    g_hash_table_allocate(hash_table, capacity);
+    hash_table->used = hash_table->count;
+
+    const unsigned int mask = capacity - 1;
+
+    for (unsigned int i = 0; i < old_capacity; ++i)
+    {
+        const unsigned int hash = old_hashes[i];
+
+        if (hash < 2)
+        {
+            continue;
+        }
+
+        unsigned int index = hash & mask;
+
+        while (hash_table->hashes[index] != HASH_EMPTY)
+        {
+            index = (index + 1) & mask;
+        }
+
+        hash_table->hashes[index] = hash;
+        hash_table->keys[index] = old_keys[i];
+        hash_table->values[index] = old_values[i];
+    }
+
+    g_free(old_hashes);
+    g_free(old_keys);
+    g_free(old_values);
+}
+
+// Returns index of the key, or of the slot where it should be inserted with set not_found flag
+static unsigned int g_hash_table_find(GHashTable* hash_table, const void* key, unsigned int hash, bool& not_found)
+{
+    const unsigned int mask = hash_table->capacity - 1;
+    unsigned int index = hash & mask;
+    unsigned int first_deleted = ~0u;
 
+    // Loop terminates because table is never full, there is always at least one empty slot
+    while (true)
+    {
+        const unsigned int slot_hash = hash_table->hashes[index];
 
-extern "C"
-{
+        if (slot_hash == HASH_EMPTY)
+        {
+            not_found = true;
+            return first_deleted != ~0u ? first_deleted : index;
+        }
 
-void* g_malloc(size_t size)
-{
-    return malloc(size);
+        if (slot_hash == hash && hash_table->key_equal_func(hash_table->keys[index], key))
+        {
+            not_found = false;
+            return index;
+        }
+
+        if (slot_hash == HASH_DELETED && first_deleted == ~0u)
+        {
+            first_deleted = index;
+        }
+
+        index = (index + 1) & mask;
+    }
 }
 
-void g_free(void* ptr)
+static int g_pointer_equal(const void* a, const void* b)
 {
-    free(ptr);
+    return a == b;
 }
 
+GHashTable* g_hash_table_new_full(GHashFunc hash_func, GEqualFunc key_equal_func,
+    GDestroyNotify key_destroy_func, GDestroyNotify value_destroy_func)
+{
+    GHashTable* hash_table = static_cast<GHashTable*>(g_slice_alloc(sizeof(GHashTable)));
+    *hash_table = GHashTable{};
+
+    hash_table->ref_count = 1;
+    hash_table->hash_func = hash_func != nullptr ? hash_func : g_direct_hash;
+    hash_table->key_equal_func = key_equal_func != nullptr ? key_equal_func : g_pointer_equal;
+    hash_table->key_destroy_func = key_destroy_func;
+    hash_table->value_destroy_func = value_destroy_func;
 
-struct GError
+    g_hash_table_allocate(hash_table, HASH_MIN_CAPACITY);
+
+    return hash_table;
+}
+
+GHashTable* g_hash_table_new(GHashFunc hash_func, GEqualFunc key_equal_func)
 {
-    uint32_t domain;
-    int code;
-    char* message;
-};
+    return g_hash_table_new_full(hash_func, key_equal_func, nullptr, nullptr);
+}
 
-void g_clear_error(GError** err)
+static int g_hash_table_insert_impl(GHashTable* hash_table, void* key, void* value, bool keep_new_key)
 {
-    if (nullptr != err && nullptr != *err)
+    const unsigned int hash = g_hash_table_hash(hash_table, key);
+    bool not_found;
+    unsigned int index = g_hash_table_find(hash_table, key, hash, not_found);
+
+    if (!not_found)
     {
-        free(*err);
-        *err = nullptr;
+        void* old_key = hash_table->keys[index];
+        void* old_value = hash_table->values[index];
+
+        // Like GLib, destroy notifications are called after the table is updated
+        hash_table->values[index] = value;
+
+        if (keep_new_key)
+        {
+            hash_table->keys[index] = key;
+        }
+
+        if (hash_table->key_destroy_func != nullptr)
+        {
+            hash_table->key_destroy_func(keep_new_key ? old_key : key);
+        }
+
+        if (hash_table->value_destroy_func != nullptr)
+        {
+            hash_table->value_destroy_func(old_value);
+        }
+
+        return 0;
+    }
+
+    if (hash_table->hashes[index] == HASH_EMPTY)
+    {
+        // Keep load factor including deleted slots under 3/4
+        if ((hash_table->used + 1) * 4 > hash_table->capacity * 3)
+        {
+            g_hash_table_resize(hash_table);
+            index = g_hash_table_find(hash_table, key, hash, not_found);
+        }
+
+        ++hash_table->used;
     }
-}
 
+    hash_table->hashes[index] = hash;
+    hash_table->keys[index] = key;
+    hash_table->values[index] = value;
 
-void g_return_if_fail_warning(const char* domain, const char* function, const char* expression)
+    ++hash_table->count;
+
+    return 1;
+}
+
+int g_hash_table_insert(GHashTable* hash_table, void* key, void* value)
 {
+    return g_hash_table_insert_impl(hash_table, key, value, false);
 }
 
+int g_hash_table_replace(GHashTable* hash_table, void* key, void* value)
+{
+    return g_hash_table_insert_impl(hash_table, key, value, true);
+}
 
-enum GFileTest
+int g_hash_table_add(GHashTable* hash_table, void* key)
 {
-    G_FILE_TEST_IS_REGULAR    = 1 << 0,
-    G_FILE_TEST_IS_SYMLINK    = 1 << 1,
-    G_FILE_TEST_IS_DIR        = 1 << 2,
-    G_FILE_TEST_IS_EXECUTABLE = 1 << 3,
-    G_FILE_TEST_EXISTS        = 1 << 4
-};
+    return g_hash_table_insert_impl(hash_table, key, key, true);
+}
 
-int g_file_test(const char* filename, int test)
+int g_hash_table_lookup_extended(GHashTable* hash_table, const void* lookup_key, void** orig_key, void** value)
 {
-    if (filename == nullptr)
+    bool not_found;
+    const unsigned int index = g_hash_table_find(hash_table, lookup_key, g_hash_table_hash(hash_table, lookup_key), not_found);
+
+    if (not_found)
     {
         return 0;
     }
 
-    if ((test & G_FILE_TEST_EXISTS) && (access(filename, F_OK) == 0))
+    if (orig_key != nullptr)
     {
-        return 1;
+        *orig_key = hash_table->keys[index];
     }
 
-    if ((test & G_FILE_TEST_IS_EXECUTABLE) && (access(filename, X_OK) == 0))
+    if (value != nullptr)
     {
-        if (getuid() != 0)
-        {
-            return 1;
-        }
+        *value = hash_table->values[index];
     }
-    else
+
+    return 1;
+}
+
+void* g_hash_table_lookup(GHashTable* hash_table, const void* key)
+{
+    void* value = nullptr;
+    g_hash_table_lookup_extended(hash_table, key, nullptr, &value);
+
+    return value;
+}
+
+int g_hash_table_contains(GHashTable* hash_table, const void* key)
+{
+    return g_hash_table_lookup_extended(hash_table, key, nullptr, nullptr);
+}
+
+unsigned int g_hash_table_size(GHashTable* hash_table)
+{
+    return hash_table->count;
+}
+
+static void g_hash_table_remove_at(GHashTable* hash_table, unsigned int index, bool notify)
+{
+    void* key = hash_table->keys[index];
+    void* value = hash_table->values[index];
+
+    // Slot followed by empty one can become empty too, this keeps probe sequences short
+    const bool last_in_chain = hash_table->hashes[(index + 1) & (hash_table->capacity - 1)] == HASH_EMPTY;
+    hash_table->hashes[index] = last_in_chain ? HASH_EMPTY : HASH_DELETED;
+
+    if (last_in_chain)
     {
-        test &= ~G_FILE_TEST_IS_EXECUTABLE;
+        --hash_table->used;
     }
 
-    if (test & G_FILE_TEST_IS_SYMLINK)
+    --hash_table->count;
+
+    if (notify && hash_table->key_destroy_func != nullptr)
+    {
+        hash_table->key_destroy_func(key);
+    }
+
+    if (notify && hash_table->value_destroy_func != nullptr)
+    {
+        hash_table->value_destroy_func(value);
+    }
+}
+
+static int g_hash_table_remove_impl(GHashTable* hash_table, const void* key, bool notify)
+{
+    bool not_found;
+    const unsigned int index = g_hash_table_find(hash_table, key, g_hash_table_hash(hash_table, key), not_found);
+
+    if (not_found)
     {
-        struct stat s;
+        return 0;
+    }
+
+    g_hash_table_remove_at(hash_table, index, notify);
+    return 1;
+}
 
-        if ((lstat(filename, &s) == 0) && S_ISLNK(s.st_mode))
+int g_hash_table_remove(GHashTable* hash_table, const void* key)
+{
+    return g_hash_table_remove_impl(hash_table, key, true);
+}
+
+int g_hash_table_steal(GHashTable* hash_table, const void* key)
+{
+    return g_hash_table_remove_impl(hash_table, key, false);
+}
+
+void g_hash_table_foreach(GHashTable* hash_table, GHFunc func, void* user_data)
+{
+    for (unsigned int i = 0; i < hash_table->capacity; ++i)
+    {
+        if (hash_table->hashes[i] >= 2)
         {
-            return 1;
+            func(hash_table->keys[i], hash_table->values[i], user_data);
         }
     }
+}
 
-    if (test & (G_FILE_TEST_IS_REGULAR | G_FILE_TEST_IS_DIR | G_FILE_TEST_IS_EXECUTABLE))
-    {
-        struct stat s;
+unsigned int g_hash_table_foreach_remove(GHashTable* hash_table, GHRFunc func, void* user_data)
+{
+    unsigned int removed = 0;
 
-        if (stat(filename, &s) == 0)
+    for (unsigned int i = 0; i < hash_table->capacity; ++i)
+    {
+        if (hash_table->hashes[i] >= 2 && func(hash_table->keys[i], hash_table->values[i], user_data))
         {
-            if ((test & G_FILE_TEST_IS_REGULAR) && S_ISREG(s.st_mode))
-            {
-                return 1;
-            }
+            // Deleted mark keeps probe chains intact while the table is being walked
+            hash_table->hashes[i] = HASH_DELETED;
+            --hash_table->count;
+            ++removed;
 
-            if ((test & G_FILE_TEST_IS_DIR) && S_ISDIR(s.st_mode))
+            if (hash_table->key_destroy_func != nullptr)
             {
-                return 1;
+                hash_table->key_destroy_func(hash_table->keys[i]);
             }
 
-            if ((test & G_FILE_TEST_IS_EXECUTABLE) && ((s.st_mode & S_IXOTH) || (s.st_mode & S_IXUSR) || (s.st_mode & S_IXGRP)))
+            if (hash_table->value_destroy_func != nullptr)
             {
-                return 1;
+                hash_table->value_destroy_func(hash_table->values[i]);
             }
         }
     }
 
-    return 0;
+    return removed;
 }
 
-
-int64_t g_get_monotonic_time()
+void g_hash_table_remove_all(GHashTable* hash_table)
 {
-    static mach_timebase_info_data_t timebase_info;
-
-    if (timebase_info.denom == 0)
+    for (unsigned int i = 0; i < hash_table->capacity; ++i)
     {
-        mach_timebase_info(&timebase_info);
-
-        if (timebase_info.numer % 1000 == 0)
+        if (hash_table->hashes[i] < 2)
         {
-            timebase_info.numer /= 1000;
+            continue;
         }
-        else
+
+        if (hash_table->key_destroy_func != nullptr)
         {
-            timebase_info.denom *= 1000;
+            hash_table->key_destroy_func(hash_table->keys[i]);
         }
 
-        if (timebase_info.denom % timebase_info.numer == 0)
+        if (hash_table->value_destroy_func != nullptr)
         {
-            timebase_info.denom /= timebase_info.numer;
-            timebase_info.numer = 1;
+            hash_table->value_destroy_func(hash_table->values[i]);
         }
     }
 
-    return mach_absolute_time() / timebase_info.denom;
-}
+    memset(hash_table->hashes, 0, hash_table->capacity * sizeof(unsigned int));
 
+    hash_table->count = 0;
+    hash_table->used = 0;
+}
 
-void g_usleep(unsigned long microseconds)
+GHashTable* g_hash_table_ref(GHashTable* hash_table)
 {
-    usleep(microseconds);
+    __atomic_fetch_add(&hash_table->ref_count, 1, __ATOMIC_RELAXED);
+    return hash_table;
 }
 
-
-struct GMutex
+void g_hash_table_unref(GHashTable* hash_table)
 {
-    pthread_mutex_t* p;
-};
+    if (__atomic_sub_fetch(&hash_table->ref_count, 1, __ATOMIC_ACQ_REL) != 0)
+    {
+        return;
+    }
 
-static pthread_mutex_t* g_mutex_impl_new()
-{
-    return new pthread_mutex_t(PTHREAD_MUTEX_INITIALIZER);
+    g_hash_table_remove_all(hash_table);
+
+    g_free(hash_table->hashes);
+    g_free(hash_table->keys);
+    g_free(hash_table->values);
+    g_slice_free1(sizeof(GHashTable), hash_table);
 }
 
-static void g_mutex_impl_free(pthread_mutex_t* mutex)
+void g_hash_table_destroy(GHashTable* hash_table)
 {
-    pthread_mutex_destroy(mutex);
-    delete mutex;
+    g_hash_table_remove_all(hash_table);
+    g_hash_table_unref(hash_table);
 }
 
-static pthread_mutex_t* g_mutex_get_impl(GMutex* mutex)
+GList* g_hash_table_get_keys(GHashTable* hash_table)
 {
-    pthread_mutex_t* impl = mutex->p;
-    __sync_synchronize();
+    GList* keys = nullptr;
 
-    if (nullptr == impl)
+    for (unsigned int i = 0; i < hash_table->capacity; ++i)
     {
-        impl = g_mutex_impl_new();
-
-        if (__sync_val_compare_and_swap(&mutex->p, nullptr, impl) != nullptr)
+        if (hash_table->hashes[i] >= 2)
         {
-            g_mutex_impl_free(impl);
-            impl = mutex->p;
+            keys = g_list_prepend(keys, hash_table->keys[i]);
         }
     }
 
-    return impl;
+    return keys;
 }
 
-void g_mutex_init(GMutex* mutex)
+GList* g_hash_table_get_values(GHashTable* hash_table)
 {
-    mutex->p = g_mutex_impl_new();
+    GList* values = nullptr;
+
+    for (unsigned int i = 0; i < hash_table->capacity; ++i)
+    {
+        if (hash_table->hashes[i] >= 2)
+        {
+            values = g_list_prepend(values, hash_table->values[i]);
+        }
+    }
+
+    return values;
 }
 
-void g_mutex_clear(GMutex* mutex)
+// Layout must match GLib's struct { gpointer dummy1, dummy2, dummy3; int dummy4; gboolean dummy5; gpointer dummy6; }
+struct GHashTableIter
 {
-    g_mutex_impl_free(mutex->p);
-}
+    GHashTable* hash_table;
+    void* unused1;
+    void* unused2;
+    int position;
+    int unused3;
+    void* unused4;
+};
 
-void g_mutex_lock(GMutex* mutex)
+void g_hash_table_iter_init(GHashTableIter* iter, GHashTable* hash_table)
 {
-    pthread_mutex_lock(g_mutex_get_impl(mutex));
+    *iter = GHashTableIter{ hash_table, nullptr, nullptr, -1, 0, nullptr };
 }
 
-void g_mutex_unlock(GMutex* mutex)
+int g_hash_table_iter_next(GHashTableIter* iter, void** key, void** value)
 {
-    pthread_mutex_unlock(g_mutex_get_impl(mutex));
-}
+    GHashTable* hash_table = iter->hash_table;
+
+    for (unsigned int i = unsigned(iter->position + 1); i < hash_table->capacity; ++i)
+    {
+        if (hash_table->hashes[i] >= 2)
+        {
+            iter->position = int(i);
 
+            if (key != nullptr)
+            {
+                *key = hash_table->keys[i];
+            }
 
-struct GRecMutex
-{
-    pthread_mutex_t* p;
-    unsigned int i[2];
-};
+            if (value != nullptr)
+            {
+                *value = hash_table->values[i];
+            }
+
+            return 1;
+        }
+    }
+
+    iter->position = int(hash_table->capacity);
+    return 0;
+}
 
-static pthread_mutex_t* g_rec_mutex_impl_new()
+static void g_hash_table_iter_remove_impl(GHashTableIter* iter, bool notify)
 {
-    pthread_mutexattr_t attr;
-    pthread_mutexattr_init(&attr);
-    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    GHashTable* hash_table = iter->hash_table;
+    const unsigned int index = unsigned(iter->position);
 
-    pthread_mutex_t* mutex = new pthread_mutex_t;
-    pthread_mutex_init(mutex, &attr);
+    // Deleted mark keeps probe chains of entries that are not visited yet intact
+    hash_table->hashes[index] = HASH_DELETED;
+    --hash_table->count;
 
-    pthread_mutexattr_destroy(&attr);
+    if (notify && hash_table->key_destroy_func != nullptr)
+    {
+        hash_table->key_destroy_func(hash_table->keys[index]);
+    }
 
-    return mutex;
+    if (notify && hash_table->value_destroy_func != nullptr)
+    {
+        hash_table->value_destroy_func(hash_table->values[index]);
+    }
 }
 
-static void g_rec_mutex_impl_free(pthread_mutex_t* mutex)
+void g_hash_table_iter_remove(GHashTableIter* iter)
 {
-    pthread_mutex_destroy(mutex);
-    delete mutex;
+    g_hash_table_iter_remove_impl(iter, true);
 }
 
-static pthread_mutex_t* g_rec_mutex_get_impl(GRecMutex* mutex)
+void g_hash_table_iter_steal(GHashTableIter* iter)
 {
-    pthread_mutex_t* impl = mutex->p;
-    __sync_synchronize();
+    g_hash_table_iter_remove_impl(iter, false);
+}
 
-    if (nullptr == impl)
-    {
-        impl = g_rec_mutex_impl_new();
 
-        if (__sync_val_compare_and_swap(&mutex->p, nullptr, impl) != nullptr)
-        {
-            g_rec_mutex_impl_free(impl);
-            impl = mutex->p;
-        }
-    }
+// Function versions of atomic operations, GLib headers normally expand them to compiler builtins
 
-    return impl;
+int g_atomic_int_get(const volatile int* atomic)
+{
+    return __atomic_load_n(atomic, __ATOMIC_SEQ_CST);
 }
 
-void g_rec_mutex_init(GRecMutex* mutex)
+void g_atomic_int_set(volatile int* atomic, int newval)
 {
-    mutex->p = g_rec_mutex_impl_new();
+    __atomic_store_n(atomic, newval, __ATOMIC_SEQ_CST);
 }
 
-void g_rec_mutex_clear(GRecMutex* mutex)
+void g_atomic_int_inc(volatile int* atomic)
 {
-    g_rec_mutex_impl_free(mutex->p);
+    __atomic_fetch_add(atomic, 1, __ATOMIC_SEQ_CST);
 }
 
-void g_rec_mutex_lock(GRecMutex* mutex)
+int g_atomic_int_dec_and_test(volatile int* atomic)
 {
-    pthread_mutex_lock(g_rec_mutex_get_impl(mutex));
+    return __atomic_sub_fetch(atomic, 1, __ATOMIC_SEQ_CST) == 0;
 }
 
-void g_rec_mutex_unlock(GRecMutex* mutex)
+int g_atomic_int_compare_and_exchange(volatile int* atomic, int oldval, int newval)
 {
-    pthread_mutex_unlock(g_rec_mutex_get_impl(mutex));
+    return __atomic_compare_exchange_n(atomic, &oldval, newval, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
 }
 
-
-struct GCond
+int g_atomic_int_add(volatile int* atomic, int val)
 {
-    pthread_cond_t* p;
-    unsigned int i[2];
-};
+    return __atomic_fetch_add(atomic, val, __ATOMIC_SEQ_CST);
+}
 
-static pthread_cond_t* g_cond_impl_new()
+int g_atomic_int_exchange_and_add(volatile int* atomic, int val)
 {
-    return new pthread_cond_t(PTHREAD_COND_INITIALIZER);
+    return __atomic_fetch_add(atomic, val, __ATOMIC_SEQ_CST);
 }
 
-static void g_cond_impl_free(pthread_cond_t* cond)
+unsigned int g_atomic_int_and(volatile unsigned int* atomic, unsigned int val)
 {
-    pthread_cond_destroy(cond);
-    delete cond;
+    return __atomic_fetch_and(atomic, val, __ATOMIC_SEQ_CST);
 }
 
-static pthread_cond_t* g_cond_get_impl(GCond* cond)
+unsigned int g_atomic_int_or(volatile unsigned int* atomic, unsigned int val)
 {
-    pthread_cond_t* impl = cond->p;
-    __sync_synchronize();
+    return __atomic_fetch_or(atomic, val, __ATOMIC_SEQ_CST);
+}
 
-    if (nullptr == impl)
-    {
-        impl = g_cond_impl_new();
+unsigned int g_atomic_int_xor(volatile unsigned int* atomic, unsigned int val)
+{
+    return __atomic_fetch_xor(atomic, val, __ATOMIC_SEQ_CST);
+}
 
-        if (__sync_val_compare_and_swap(&cond->p, nullptr, impl) != nullptr)
-        {
-            g_cond_impl_free(impl);
-            impl = cond->p;
-        }
-    }
+void* g_atomic_pointer_get(const volatile void* atomic)
+{
+    return __atomic_load_n(static_cast<void* const volatile*>(atomic), __ATOMIC_SEQ_CST);
+}
 
-    return impl;
+void g_atomic_pointer_set(volatile void* atomic, void* newval)
+{
+    __atomic_store_n(static_cast<void* volatile*>(atomic), newval, __ATOMIC_SEQ_CST);
 }
 
-void g_cond_init(GCond* cond)
+int g_atomic_pointer_compare_and_exchange(volatile void* atomic, void* oldval, void* newval)
 {
-    cond->p = g_cond_impl_new();
+    return __atomic_compare_exchange_n(static_cast<void* volatile*>(atomic), &oldval, newval, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
 }
 
-void g_cond_clear(GCond* cond)
+ptrdiff_t g_atomic_pointer_add(volatile void* atomic, ptrdiff_t val)
 {
-    g_cond_impl_free(cond->p);
+    return __atomic_fetch_add(static_cast<volatile ptrdiff_t*>(atomic), val, __ATOMIC_SEQ_CST);
 }
 
-void g_cond_wait(GCond* cond, GMutex* mutex)
+size_t g_atomic_pointer_and(volatile void* atomic, size_t val)
 {
-    pthread_cond_wait(g_cond_get_impl(cond), g_mutex_get_impl(mutex));
+    return __atomic_fetch_and(static_cast<volatile size_t*>(atomic), val, __ATOMIC_SEQ_CST);
 }
 
-void g_cond_signal(GCond* cond)
+size_t g_atomic_pointer_or(volatile void* atomic, size_t val)
 {
-    pthread_cond_signal(g_cond_get_impl(cond));
+    return __atomic_fetch_or(static_cast<volatile size_t*>(atomic), val, __ATOMIC_SEQ_CST);
 }
 
-void g_cond_broadcast(GCond* cond)
+size_t g_atomic_pointer_xor(volatile void* atomic, size_t val)
 {
-    pthread_cond_broadcast(g_cond_get_impl(cond));
+    return __atomic_fetch_xor(static_cast<volatile size_t*>(atomic), val, __ATOMIC_SEQ_CST);
 }
 
 
-using GDestroyNotify = void (*)(void* data);
+// Layout must match GLib's struct { volatile GOnceStatus status; volatile gpointer retval; }
+// All one-time initializations share the same mutex and condition like in GLib, contention is not expected
 
-struct GPrivate
+enum GOnceStatus
 {
-    pthread_key_t* p;
-    GDestroyNotify notify;
-    void* future[2];
+    G_ONCE_STATUS_NOTCALLED,
+    G_ONCE_STATUS_PROGRESS,
+    G_ONCE_STATUS_READY
 };
 
-static pthread_key_t* g_private_impl_new(GDestroyNotify notify)
+struct GOnce
 {
-    pthread_key_t* key = new pthread_key_t;
-    pthread_key_create(key, notify);
-    return key;
-}
+    GOnceStatus status;
+    void* retval;
+};
 
-static void g_private_impl_free(pthread_key_t* key)
-{
-    pthread_key_delete(*key);
-    delete key;
-}
+static GMutex g_once_mutex;
+static GCond g_once_cond;
+// Locations being initialized by g_once_init_enter() and g_once_init_leave() pair
+static GList* g_once_init_list;
 
-static inline pthread_key_t* g_private_get_impl(GPrivate* key)
+void* g_once_impl(GOnce* once, GThreadFunc func, void* arg)
 {
-    pthread_key_t* impl = key->p;
-    __sync_synchronize();
+    g_mutex_lock(&g_once_mutex);
+
+    while (once->status == G_ONCE_STATUS_PROGRESS)
+    {
+        g_cond_wait(&g_once_cond, &g_once_mutex);
+    }
 
-    if (nullptr == impl)
+    if (once->status != G_ONCE_STATUS_READY)
     {
-        impl = g_private_impl_new(key->notify);
+        once->status = G_ONCE_STATUS_PROGRESS;
+        g_mutex_unlock(&g_once_mutex);
 
-        if (__sync_val_compare_and_swap(&key->p, nullptr, impl) != nullptr)
-        {
-            g_private_impl_free(impl);
-            impl = key->p;
-        }
+        void* retval = func(arg);
+
+        g_mutex_lock(&g_once_mutex);
+        once->retval = retval;
+        __atomic_store_n(&once->status, G_ONCE_STATUS_READY, __ATOMIC_RELEASE);
+        g_cond_broadcast(&g_once_cond);
     }
 
-  return impl;
-}
+    g_mutex_unlock(&g_once_mutex);
 
-void* g_private_get(GPrivate* key)
-{
-    return pthread_getspecific(*g_private_get_impl(key));
+    return once->retval;
 }
 
-void g_private_set(GPrivate* key, void* value)
+int g_once_init_enter(volatile void* location)
 {
-    pthread_setspecific(*g_private_get_impl(key), value);
-}
+    size_t* value = const_cast<size_t*>(static_cast<volatile size_t*>(location));
 
+    if (__atomic_load_n(value, __ATOMIC_ACQUIRE) != 0)
+    {
+        return 0;
+    }
 
-struct GThread
-{
-    pthread_t thread;
-    int ref_count;
-};
-
-using GThreadFunc = void* (*)(void* data);
+    bool need_init = false;
+    g_mutex_lock(&g_once_mutex);
 
-GThread* g_thread_try_new(const char* name, GThreadFunc func, void* data, GError** error)
-{
-    if (error != nullptr)
+    if (__atomic_load_n(value, __ATOMIC_ACQUIRE) == 0)
     {
-        *error = nullptr;
+        if (g_list_find(g_once_init_list, value) == nullptr)
+        {
+            need_init = true;
+            g_once_init_list = g_list_prepend(g_once_init_list, value);
+        }
+        else
+        {
+            while (g_list_find(g_once_init_list, value) != nullptr)
+            {
+                g_cond_wait(&g_once_cond, &g_once_mutex);
+            }
+        }
     }
 
-    GThread* thread = new GThread;
-    pthread_create(&thread->thread, nullptr, func, data);
-    thread->ref_count = 1;
+    g_mutex_unlock(&g_once_mutex);
 
-    return thread;
+    return need_init;
 }
 
-void* g_thread_join(GThread* thread)
+void g_once_init_leave(volatile void* location, size_t result)
 {
-    void* result = nullptr;
-    pthread_join(thread->thread, &result);
-    return result;
-}
+    size_t* value = const_cast<size_t*>(static_cast<volatile size_t*>(location));
+    __atomic_store_n(value, result, __ATOMIC_RELEASE);
 
-void g_thread_unref(GThread* thread)
-{
-    if (__sync_sub_and_fetch(&thread->ref_count, 1) == 0)
-    {
-        g_thread_join(thread);
-        delete thread;
-    }
+    g_mutex_lock(&g_once_mutex);
+    g_once_init_list = g_list_remove(g_once_init_list, value);
+    g_cond_broadcast(&g_once_cond);
+    g_mutex_unlock(&g_once_mutex);
 }
 
 }
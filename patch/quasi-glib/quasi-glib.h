@@ -0,0 +1,17 @@
+#ifndef QUASI_GLIB_H
+#define QUASI_GLIB_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Monotonic time in nanoseconds, uses the same clock as g_get_monotonic_time()
+int64_t quasi_glib_monotonic_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
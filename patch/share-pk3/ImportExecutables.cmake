@@ -0,0 +1,25 @@
+# Imported executables of ZDoom based main target, see ZDoomBaseTarget
+#
+# Executables of native build, or cached host tools, are imported as usual, then zipdir is replaced with
+# AEDI_ZIPDIR_LAUNCHER that copies PK3 built by native slice when it's up to date, and packs it by
+# aedi.pack.IncrementalPack otherwise, native zipdir is run only for arguments that it doesn't handle
+# Location of native zipdir is written next to the launcher, it differs between build configurations
+
+include("${AEDI_NATIVE_IMPORT_EXECUTABLES}")
+
+if(TARGET zipdir)
+    get_target_property(aedi_zipdir_configurations zipdir IMPORTED_CONFIGURATIONS)
+    set(aedi_zipdir_location "")
+
+    foreach(configuration IN LISTS aedi_zipdir_configurations)
+        get_target_property(aedi_zipdir_location zipdir IMPORTED_LOCATION_${configuration})
+        set_target_properties(zipdir PROPERTIES IMPORTED_LOCATION_${configuration} "${AEDI_ZIPDIR_LAUNCHER}")
+    endforeach()
+
+    if(NOT aedi_zipdir_location)
+        get_target_property(aedi_zipdir_location zipdir IMPORTED_LOCATION)
+    endif()
+
+    set_target_properties(zipdir PROPERTIES IMPORTED_LOCATION "${AEDI_ZIPDIR_LAUNCHER}")
+    file(WRITE "${AEDI_ZIPDIR_LAUNCHER}.location" "${aedi_zipdir_location}")
+endif()
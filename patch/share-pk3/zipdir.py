@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+
+# zipdir replacement for slices of ZDoom based main targets that import host tools, see ZDoomBaseTarget
+#
+# Usage: zipdir.py <native zipdir> <slice build path> <native build path> [zipdir options] <archive> <paths>...
+# PK3 files are built from the same sources by every slice, so the one made by native slice is copied
+# when it's newer than all of its sources, like zipdir -u would keep it
+# Otherwise, archive of one directory is packed by aedi.pack.IncrementalPack, which compresses lumps concurrently
+# and reuses compressed entries of unchanged ones, native zipdir is run for other arguments
+
+import os
+import shutil
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from aedi.pack import IncrementalPack
+
+# Options of zipdir that IncrementalPack matches: it always updates the whole archive with deleted lumps removed
+_PACK_OPTIONS = set('dfqu')
+
+
+def _newest_source_time(paths):
+    newest = 0
+
+    for path in paths:
+        if path.is_dir():
+            for root, _, files in os.walk(path):
+                for name in files:
+                    newest = max(newest, os.stat(os.path.join(root, name)).st_mtime)
+        elif path.exists():
+            newest = max(newest, path.stat().st_mtime)
+
+    return newest
+
+
+def _share_archive(slice_build_path, native_build_path, arguments):
+    paths = [Path(argument) for argument in arguments if not argument.startswith('-')]
+
+    if len(paths) < 2:
+        return False
+
+    archive_path = paths[0].absolute()
+
+    try:
+        native_archive_path = native_build_path / archive_path.relative_to(slice_build_path)
+    except ValueError:
+        return False
+
+    if not native_archive_path.exists():
+        return False
+
+    native_time = native_archive_path.stat().st_mtime
+
+    if _newest_source_time(paths[1:]) > native_time:
+        return False
+
+    if not archive_path.exists() or archive_path.stat().st_mtime != native_time:
+        archive_path.parent.mkdir(parents=True, exist_ok=True)
+        shutil.copy2(native_archive_path, archive_path)
+
+    return True
+
+
+def _pack_archive(arguments):
+    options = set(''.join(argument[1:] for argument in arguments if argument.startswith('-')))
+    paths = [Path(argument) for argument in arguments if not argument.startswith('-')]
+
+    if 'd' not in options or not options <= _PACK_OPTIONS or len(paths) != 2 or not paths[1].is_dir():
+        return False
+
+    archive_path = paths[0].absolute()
+    archive_path.parent.mkdir(parents=True, exist_ok=True)
+
+    IncrementalPack(paths[1], archive_path).pack()
+    return True
+
+
+def main(args):
+    zipdir, slice_build_path, native_build_path = args[:3]
+    arguments = args[3:]
+
+    if not _share_archive(Path(slice_build_path), Path(native_build_path), arguments) \
+            and not _pack_archive(arguments):
+        os.execv(zipdir, [zipdir] + arguments)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
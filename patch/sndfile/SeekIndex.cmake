@@ -0,0 +1,16 @@
+# Included into libsndfile project built with --ogg-seek-index, see SndFileTarget
+#
+# Functions of src/ogg.c that open Ogg files and search their pages are renamed, ogg_seek_index.c defines them
+# with the original names, builds page table of every opened file, and limits page search with it
+
+include_guard(GLOBAL)
+
+set_source_files_properties(src/ogg.c PROPERTIES COMPILE_DEFINITIONS
+    "ogg_open=sf_ogg_open_unindexed;ogg_stream_seek_page_search=sf_ogg_stream_seek_page_search_unindexed")
+
+function(aedi_ogg_seek_index)
+    target_sources(sndfile PRIVATE ${CMAKE_CURRENT_FUNCTION_LIST_DIR}/ogg_seek_index.c)
+endfunction()
+
+# Library target doesn't exist yet when project() includes this file
+cmake_language(DEFER DIRECTORY ${CMAKE_SOURCE_DIR} CALL aedi_ogg_seek_index)
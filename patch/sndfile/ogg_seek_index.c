@@ -0,0 +1,413 @@
+/*
+** Seek index of Ogg streams, compiled into libsndfile by SeekIndex.cmake
+**
+** ogg_open () and ogg_stream_seek_page_search () of src/ogg.c are renamed
+** by compile definitions, functions below replace them and call originals.
+**
+** When a seekable Ogg file is opened for reading, all its pages are scanned
+** once, and granule position and file offset of every page of the first
+** logical stream are stored in compact table. Tables are cached by hash of
+** file length, its head and its tail, so reopening of the same music, e.g.
+** after level restart, doesn't scan it again.
+**
+** Page search, used for Vorbis and Opus seeks, is then limited to the two
+** pages around target granule position, instead of bisection of the whole
+** file. So loop restart reads one page plus pre-roll that codec decodes
+** anyway. Without table, e.g. for a file too large, search is not changed.
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation; either version 2.1 of the License, or
+** (at your option) any later version.
+*/
+
+#include "sfconfig.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "sndfile.h"
+#include "common.h"
+
+#if HAVE_EXTERNAL_XIPH_LIBS
+
+#include <ogg/ogg.h>
+
+#include "ogg.h"
+
+/* Originals in src/ogg.c, see SeekIndex.cmake. */
+int sf_ogg_open_unindexed (SF_PRIVATE *psf) ;
+int sf_ogg_stream_seek_page_search_unindexed (SF_PRIVATE *psf, OGG_PRIVATE *odata,
+	uint64_t target_gp, uint64_t pcm_start, uint64_t pcm_end,
+	uint64_t *best_gp, sf_count_t begin, sf_count_t end, uint64_t gp_rate) ;
+
+enum
+{	SEEK_INDEX_HASHED_BYTES = 64 * 1024,
+	SEEK_INDEX_READ_BYTES = 64 * 1024,
+	SEEK_INDEX_MAX_FILE_LENGTH = 256 * 1024 * 1024,
+
+	/* Tables of recently opened files, a few megabytes of music take some kilobytes. */
+	SEEK_INDEX_CACHE_SIZE = 16,
+
+	/* Files open at once with table, the oldest one searches without table when exceeded. */
+	SEEK_INDEX_STREAM_COUNT = 64
+} ;
+
+typedef struct
+{	sf_count_t offset ;
+	uint64_t granule ;
+} SEEK_INDEX_PAGE ;
+
+typedef struct
+{	uint64_t hash ;
+	SEEK_INDEX_PAGE *pages ;
+	sf_count_t page_count ;
+	uint64_t last_use ;
+} SEEK_INDEX ;
+
+typedef struct
+{	const SF_PRIVATE *psf ;
+	uint64_t hash ;
+} SEEK_INDEX_STREAM ;
+
+static pthread_mutex_t seek_index_mutex = PTHREAD_MUTEX_INITIALIZER ;
+static SEEK_INDEX seek_index_cache [SEEK_INDEX_CACHE_SIZE] ;
+static SEEK_INDEX_STREAM seek_index_streams [SEEK_INDEX_STREAM_COUNT] ;
+static uint64_t seek_index_use_counter ;
+static int seek_index_next_stream ;
+
+/* FNV-1a */
+static uint64_t
+seek_index_hash_bytes (uint64_t hash, const unsigned char *bytes, sf_count_t count)
+{	sf_count_t k ;
+
+	for (k = 0 ; k < count ; k++)
+	{	hash ^= bytes [k] ;
+		hash *= UINT64_C (0x100000001b3) ;
+		} ;
+
+	return hash ;
+} /* seek_index_hash_bytes */
+
+static int
+seek_index_hash_file (SF_PRIVATE *psf, sf_count_t length, uint64_t *hash)
+{	unsigned char *buffer ;
+	sf_count_t count, tail ;
+	uint64_t value = UINT64_C (0xcbf29ce484222325) ;
+
+	if ((buffer = malloc (SEEK_INDEX_HASHED_BYTES)) == NULL)
+		return 0 ;
+
+	value = seek_index_hash_bytes (value, (const unsigned char *) &length, sizeof (length)) ;
+
+	count = SF_MIN (length, SEEK_INDEX_HASHED_BYTES) ;
+	tail = SF_MAX (length - SEEK_INDEX_HASHED_BYTES, count) ;
+
+	if (psf_fseek (psf, 0, SEEK_SET) != 0 || psf_fread (buffer, 1, count, psf) != count)
+	{	free (buffer) ;
+		return 0 ;
+		} ;
+
+	value = seek_index_hash_bytes (value, buffer, count) ;
+
+	/* Tail has the last granule position, it tells files with the same head apart. */
+	count = length - tail ;
+
+	if (count > 0)
+	{	if (psf_fseek (psf, tail, SEEK_SET) != tail || psf_fread (buffer, 1, count, psf) != count)
+		{	free (buffer) ;
+			return 0 ;
+			} ;
+
+		value = seek_index_hash_bytes (value, buffer, count) ;
+		} ;
+
+	free (buffer) ;
+
+	/* Zero means no table. */
+	*hash = value != 0 ? value : 1 ;
+
+	return 1 ;
+} /* seek_index_hash_file */
+
+static int
+seek_index_scan_file (SF_PRIVATE *psf, SEEK_INDEX_PAGE **result, sf_count_t *result_count)
+{	ogg_sync_state osync ;
+	ogg_page opage ;
+	SEEK_INDEX_PAGE *pages = NULL, *grown ;
+	sf_count_t count = 0, capacity = 0, offset = 0, bytes ;
+	long page_bytes ;
+	int serialno = 0, have_serialno = 0, error = 0 ;
+	char *buffer ;
+
+	if (psf_fseek (psf, 0, SEEK_SET) != 0)
+		return 0 ;
+
+	ogg_sync_init (&osync) ;
+
+	do
+	{	if ((buffer = ogg_sync_buffer (&osync, SEEK_INDEX_READ_BYTES)) == NULL)
+		{	error = 1 ;
+			break ;
+			} ;
+
+		bytes = psf_fread (buffer, 1, SEEK_INDEX_READ_BYTES, psf) ;
+		ogg_sync_wrote (&osync, bytes) ;
+
+		/* Negative return value is count of skipped bytes that are not a page. */
+		while ((page_bytes = ogg_sync_pageseek (&osync, &opage)) != 0)
+		{	if (page_bytes < 0)
+			{	offset -= page_bytes ;
+				continue ;
+				} ;
+
+			if (have_serialno == 0)
+			{	serialno = ogg_page_serialno (&opage) ;
+				have_serialno = 1 ;
+				} ;
+
+			/* Pages without finished packet have granule position of -1. */
+			if (ogg_page_serialno (&opage) == serialno && ogg_page_granulepos (&opage) != -1)
+			{	if (count == capacity)
+				{	capacity = capacity ? capacity * 2 : 256 ;
+
+					if ((grown = realloc (pages, capacity * sizeof (SEEK_INDEX_PAGE))) == NULL)
+					{	error = 1 ;
+						break ;
+						} ;
+
+					pages = grown ;
+					} ;
+
+				pages [count].offset = offset ;
+				pages [count].granule = ogg_page_granulepos (&opage) ;
+				count++ ;
+				} ;
+
+			offset += page_bytes ;
+			} ;
+		}
+	while (bytes > 0 && error == 0) ;
+
+	ogg_sync_clear (&osync) ;
+
+	if (error || count == 0)
+	{	free (pages) ;
+		return 0 ;
+		} ;
+
+	*result = pages ;
+	*result_count = count ;
+
+	return 1 ;
+} /* seek_index_scan_file */
+
+/* Called with mutex locked. */
+static SEEK_INDEX *
+seek_index_find (uint64_t hash)
+{	int k ;
+
+	for (k = 0 ; k < SEEK_INDEX_CACHE_SIZE ; k++)
+		if (seek_index_cache [k].pages != NULL && seek_index_cache [k].hash == hash)
+			return &seek_index_cache [k] ;
+
+	return NULL ;
+} /* seek_index_find */
+
+/* Called with mutex locked. Table of the same file scanned by other thread meanwhile is kept. */
+static void
+seek_index_insert (uint64_t hash, SEEK_INDEX_PAGE *pages, sf_count_t page_count)
+{	SEEK_INDEX *index = &seek_index_cache [0] ;
+	int k ;
+
+	if (seek_index_find (hash) != NULL)
+	{	free (pages) ;
+		return ;
+		} ;
+
+	for (k = 1 ; k < SEEK_INDEX_CACHE_SIZE ; k++)
+		if (seek_index_cache [k].last_use < index->last_use)
+			index = &seek_index_cache [k] ;
+
+	free (index->pages) ;
+
+	index->hash = hash ;
+	index->pages = pages ;
+	index->page_count = page_count ;
+	index->last_use = ++seek_index_use_counter ;
+} /* seek_index_insert */
+
+/*
+** Address of freed SF_PRIVATE can be reused by the next file. Every Ogg file
+** passes ogg_open () that replaces association of its address, so the stale
+** one is never used. Files of other containers don't search Ogg pages.
+*/
+static void
+seek_index_associate (const SF_PRIVATE *psf, uint64_t hash)
+{	SEEK_INDEX_STREAM *stream = NULL ;
+	int k ;
+
+	pthread_mutex_lock (&seek_index_mutex) ;
+
+	for (k = 0 ; k < SEEK_INDEX_STREAM_COUNT ; k++)
+		if (seek_index_streams [k].psf == psf)
+		{	stream = &seek_index_streams [k] ;
+			break ;
+			} ;
+
+	if (stream == NULL && hash != 0)
+	{	stream = &seek_index_streams [seek_index_next_stream] ;
+		seek_index_next_stream = (seek_index_next_stream + 1) % SEEK_INDEX_STREAM_COUNT ;
+		} ;
+
+	if (stream != NULL)
+	{	stream->psf = hash != 0 ? psf : NULL ;
+		stream->hash = hash ;
+		} ;
+
+	pthread_mutex_unlock (&seek_index_mutex) ;
+} /* seek_index_associate */
+
+static void
+seek_index_open (SF_PRIVATE *psf)
+{	SEEK_INDEX_PAGE *pages ;
+	sf_count_t length, position, page_count ;
+	uint64_t hash = 0 ;
+	int found ;
+
+	if (psf->file.mode != SFM_READ || psf->sf.seekable == 0)
+		return ;
+
+	length = psf_get_filelen (psf) ;
+
+	if (length <= 0 || length > SEEK_INDEX_MAX_FILE_LENGTH)
+		return ;
+
+	/* Codec has read headers already, its sync state continues from this position. */
+	position = psf_ftell (psf) ;
+
+	if (seek_index_hash_file (psf, length, &hash))
+	{	pthread_mutex_lock (&seek_index_mutex) ;
+		found = seek_index_find (hash) != NULL ;
+		pthread_mutex_unlock (&seek_index_mutex) ;
+
+		if (found == 0)
+		{	if (seek_index_scan_file (psf, &pages, &page_count))
+			{	pthread_mutex_lock (&seek_index_mutex) ;
+				seek_index_insert (hash, pages, page_count) ;
+				pthread_mutex_unlock (&seek_index_mutex) ;
+				}
+			else
+				hash = 0 ;
+			} ;
+		}
+	else
+		hash = 0 ;
+
+	psf_fseek (psf, position, SEEK_SET) ;
+
+	/* Zero hash removes association left by the previous file at this address. */
+	seek_index_associate (psf, hash) ;
+} /* seek_index_open */
+
+int
+ogg_open (SF_PRIVATE *psf)
+{	int error ;
+
+	if ((error = sf_ogg_open_unindexed (psf)) == 0)
+		seek_index_open (psf) ;
+
+	return error ;
+} /* ogg_open */
+
+/*
+** Narrow [begin, end) range to pages around target_gp. The best page, the
+** last one with granule position at or below target, and the next one stay
+** in range, so search gets the same result as bisection of the whole file.
+*/
+static int
+seek_index_narrow (const SF_PRIVATE *psf, uint64_t target_gp, uint64_t *pcm_start, uint64_t *pcm_end,
+	sf_count_t *begin, sf_count_t *end)
+{	const SEEK_INDEX *index = NULL ;
+	const SEEK_INDEX_PAGE *pages ;
+	sf_count_t low = 0, high, best, last ;
+	int k, narrowed = 0 ;
+
+	pthread_mutex_lock (&seek_index_mutex) ;
+
+	for (k = 0 ; k < SEEK_INDEX_STREAM_COUNT ; k++)
+		if (seek_index_streams [k].psf == psf)
+		{	index = seek_index_find (seek_index_streams [k].hash) ;
+			break ;
+			} ;
+
+	if (index != NULL)
+	{	pages = index->pages ;
+		high = index->page_count ;
+
+		/* The first page with granule position above target. */
+		while (low < high)
+		{	sf_count_t middle = low + (high - low) / 2 ;
+
+			if (pages [middle].granule <= target_gp)
+				low = middle + 1 ;
+			else
+				high = middle ;
+			} ;
+
+		best = low - 1 ;
+		last = low + 1 ;
+
+		/* Target before the first audio page is left to unlimited search. */
+		if (best > 0 && pages [best].offset > *begin)
+		{	*begin = pages [best].offset ;
+			*pcm_start = pages [best - 1].granule ;
+			narrowed = 1 ;
+			} ;
+
+		if (narrowed && last < index->page_count && pages [last].offset < *end)
+		{	*end = pages [last].offset ;
+			*pcm_end = pages [last - 1].granule ;
+			} ;
+
+		((SEEK_INDEX *) index)->last_use = ++seek_index_use_counter ;
+		} ;
+
+	pthread_mutex_unlock (&seek_index_mutex) ;
+
+	return narrowed ;
+} /* seek_index_narrow */
+
+int
+ogg_stream_seek_page_search (SF_PRIVATE *psf, OGG_PRIVATE *odata,
+	uint64_t target_gp, uint64_t pcm_start, uint64_t pcm_end,
+	uint64_t *best_gp, sf_count_t begin, sf_count_t end, uint64_t gp_rate)
+{	uint64_t narrow_pcm_start = pcm_start, narrow_pcm_end = pcm_end ;
+	sf_count_t narrow_begin = begin, narrow_end = end ;
+	int ret ;
+
+	if (seek_index_narrow (psf, target_gp, &narrow_pcm_start, &narrow_pcm_end, &narrow_begin, &narrow_end))
+	{	ret = sf_ogg_stream_seek_page_search_unindexed (psf, odata, target_gp, narrow_pcm_start, narrow_pcm_end,
+					best_gp, narrow_begin, narrow_end, gp_rate) ;
+
+		if (ret >= 0)
+			return ret ;
+		} ;
+
+	/* Table doesn't match the file, e.g. it was modified while open. */
+	return sf_ogg_stream_seek_page_search_unindexed (psf, odata, target_gp, pcm_start, pcm_end,
+				best_gp, begin, end, gp_rate) ;
+} /* ogg_stream_seek_page_search */
+
+#else /* HAVE_EXTERNAL_XIPH_LIBS */
+
+int sf_ogg_open_unindexed (SF_PRIVATE *psf) ;
+
+int
+ogg_open (SF_PRIVATE *psf)
+{	return sf_ogg_open_unindexed (psf) ;
+} /* ogg_open */
+
+#endif /* HAVE_EXTERNAL_XIPH_LIBS */
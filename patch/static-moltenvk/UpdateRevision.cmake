@@ -47,6 +47,90 @@ function(query_repo_info)
 	ret_var(Hash)
 endfunction()
 
+# Results of git commands are cached in repository's git directory, so they are
+# shared by build directories of all architectures. The cache is valid while
+# HEAD, the commit it points to, packed refs and tags stay the same. Populate
+# variable "CacheFile" with path to the cache, and "CacheKey" with the state
+# it's valid for. Both are empty if git directory is not found.
+function(get_cache_key)
+	get_filename_component(Dir "." ABSOLUTE)
+
+	while(NOT EXISTS "${Dir}/.git")
+		get_filename_component(Parent "${Dir}" DIRECTORY)
+		if(Parent STREQUAL Dir)
+			return()
+		endif()
+		set(Dir "${Parent}")
+	endwhile()
+
+	# Worktrees and submodules have .git file instead of directory
+	set(GitDir "${Dir}/.git")
+	if(NOT IS_DIRECTORY "${GitDir}")
+		return()
+	endif()
+
+	file(READ "${GitDir}/HEAD" Head)
+	string(STRIP "${Head}" Head)
+	set(CacheKey "${Head}")
+
+	# Loose ref has commit hash, packed one is covered by packed refs time
+	if(Head MATCHES "^ref: (.+)$" AND EXISTS "${GitDir}/${CMAKE_MATCH_1}")
+		file(READ "${GitDir}/${CMAKE_MATCH_1}" Ref)
+		string(STRIP "${Ref}" Ref)
+		string(APPEND CacheKey ";${Ref}")
+	endif()
+
+	file(TIMESTAMP "${GitDir}/packed-refs" PackedRefsTime "%s" UTC)
+	file(TIMESTAMP "${GitDir}/refs/tags" TagsTime "%s" UTC)
+	string(APPEND CacheKey ";${PackedRefsTime};${TagsTime}")
+
+	set(CacheFile "${GitDir}/aedi-revision-cache.txt")
+
+	ret_var(CacheFile)
+	ret_var(CacheKey)
+endfunction()
+
+# Populate variables "Hash", "Tag", and "Timestamp" from the cache if it's valid.
+function(read_cache)
+	if(NOT CacheFile OR NOT EXISTS "${CacheFile}")
+		return()
+	endif()
+
+	file(STRINGS "${CacheFile}" Lines)
+	list(LENGTH Lines LineCount)
+	if(NOT LineCount EQUAL 4)
+		return()
+	endif()
+
+	list(GET Lines 0 CachedKey)
+	string(REPLACE "," ";" CachedKey "${CachedKey}")
+	if(NOT CachedKey STREQUAL CacheKey)
+		return()
+	endif()
+
+	list(GET Lines 1 Tag)
+	list(GET Lines 2 Timestamp)
+	list(GET Lines 3 Hash)
+
+	ret_var(Tag)
+	ret_var(Timestamp)
+	ret_var(Hash)
+endfunction()
+
+function(write_cache)
+	if(NOT CacheFile)
+		return()
+	endif()
+
+	# Semicolons separate list elements, and are not read back by file(STRINGS)
+	string(REPLACE ";" "," Key "${CacheKey}")
+
+	# Written to temporary file first, so concurrent builds never read incomplete cache
+	string(RANDOM TempSuffix)
+	file(WRITE "${CacheFile}.${TempSuffix}" "${Key}\n${Tag}\n${Timestamp}\n${Hash}\n")
+	file(RENAME "${CacheFile}.${TempSuffix}" "${CacheFile}")
+endfunction()
+
 # Although configure_file doesn't overwrite the file if the contents are the
 # same we can't easily observe that to change the status message.  This
 # function parses the existing file (if it exists) and puts the hash in
@@ -70,7 +154,16 @@ function(main)
 
 	get_filename_component(ScriptDir "${CMAKE_SCRIPT_MODE_FILE}" DIRECTORY)
 
-	query_repo_info()
+	get_cache_key()
+	read_cache()
+
+	if(NOT Hash)
+		query_repo_info()
+		if(Hash)
+			write_cache()
+		endif()
+	endif()
+
 	if(NOT Hash)
 		message("Failed to get commit info: ${Error}")
 		set(Hash "0")
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+
+#
+#    Helper module to build macOS version of various source ports
+#    Copyright (C) 2020-2024 Alexey Lysiuk
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+# Regenerates device dispatch table in volk.h and volk.c from Vulkan registry
+# Usage: generate.py [path/to/vk.xml]
+
+import hashlib
+import re
+import sys
+import xml.etree.ElementTree as etree
+from pathlib import Path
+
+DEVICE_HANDLES = ('VkDevice', 'VkQueue', 'VkCommandBuffer')
+
+# These are resolved through instance, not device
+EXCLUDED_COMMANDS = ('vkGetDeviceProcAddr',)
+
+
+def _is_vulkan_api(node) -> bool:
+    api = node.get('api')
+    return api is None or 'vulkan' in api.split(',')
+
+
+def _is_supported_extension(node) -> bool:
+    supported = node.get('supported', '')
+    return 'vulkan' in supported.split(',')
+
+
+def _depends_to_condition(depends: str) -> str:
+    # Dependency expression uses ',' for 'or' and '+' for 'and', parentheses keep their meaning
+    condition = re.sub(r'[A-Za-z_][A-Za-z0-9_:]*', lambda m: f'defined({m.group(0).split("::")[0]})', depends)
+    return condition.replace('+', ' && ').replace(',', ' || ')
+
+
+def _collect_device_commands(registry) -> set:
+    commands = set()
+    aliases = {}
+
+    for command in registry.findall('commands/command'):
+        if not _is_vulkan_api(command):
+            continue
+
+        alias = command.get('alias')
+
+        if alias:
+            aliases[command.get('name')] = alias
+            continue
+
+        name = command.findtext('proto/name')
+        first_param_type = command.findtext('param/type')
+
+        if first_param_type in DEVICE_HANDLES and name not in EXCLUDED_COMMANDS:
+            commands.add(name)
+
+    for alias, target in aliases.items():
+        if target in commands:
+            commands.add(alias)
+
+    return commands
+
+
+def _collect_blocks(registry, device_commands: set) -> list:
+    command_conditions = {}
+
+    def add_requirements(name: str, node):
+        for require in node.findall('require'):
+            if not _is_vulkan_api(require):
+                continue
+
+            condition = f'defined({name})'
+            depends = require.get('depends')
+
+            if depends:
+                condition += f' && ({_depends_to_condition(depends)})'
+
+            for command in require.findall('command'):
+                command_name = command.get('name')
+
+                if command_name in device_commands:
+                    conditions = command_conditions.setdefault(command_name, [])
+
+                    if condition not in conditions:
+                        conditions.append(condition)
+
+    for feature in registry.findall('feature'):
+        if _is_vulkan_api(feature):
+            add_requirements(feature.get('name'), feature)
+
+    for extension in registry.findall('extensions/extension'):
+        if _is_supported_extension(extension):
+            add_requirements(extension.get('name'), extension)
+
+    # Command required by several features or extensions is declared once, under combined condition
+    blocks = {}
+
+    for command_name, conditions in command_conditions.items():
+        condition = conditions[0] if len(conditions) == 1 else ' || '.join(f'({c})' for c in conditions)
+        blocks.setdefault(condition, []).append(command_name)
+
+    return [(condition, sorted(commands)) for condition, commands in blocks.items()]
+
+
+def _replace_section(text: str, section: str, content: str) -> str:
+    begin = f'/* VOLK_GENERATE_{section} */\n'
+    end = f'/* VOLK_GENERATE_{section}_END */'
+
+    begin_pos = text.index(begin) + len(begin)
+    end_pos = text.index(end)
+
+    return text[:begin_pos] + content + text[end_pos:]
+
+
+def main():
+    self_path = Path(__file__).parent
+    registry_path = Path(sys.argv[1]) if len(sys.argv) > 1 else \
+        self_path.parent.parent / 'deps/vulkan-headers/share/vulkan/registry/vk.xml'
+
+    registry = etree.parse(registry_path).getroot()
+    blocks = _collect_blocks(registry, _collect_device_commands(registry))
+
+    table = ''
+    loader = ''
+
+    for condition, commands in blocks:
+        # Padding keeps table layout the same regardless of available extensions
+        padding = hashlib.sha1(condition.encode()).hexdigest()[:8]
+
+        table += f'#if {condition}\n'
+        table += ''.join(f'\tPFN_{command} {command};\n' for command in commands)
+        table += f'#else\n\tPFN_vkVoidFunction padding_{padding}[{len(commands)}];\n'
+        table += f'#endif /* {condition} */\n'
+
+        loader += f'#if {condition}\n'
+        loader += ''.join(f'\ttable->{command} = (PFN_{command})load(context, "{command}");\n' for command in commands)
+        loader += f'#endif /* {condition} */\n'
+
+    for filename, section, content in (('volk.h', 'DEVICE_TABLE', table), ('volk.c', 'LOAD_DEVICE_TABLE', loader)):
+        path = self_path / filename
+        text = path.read_text()
+        path.write_text(_replace_section(text, section, content))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,75 @@
+# Included into every project of main target built with --unity-build, see CMakeMainTarget
+#
+# When the whole source tree is processed, sources that cannot be merged with others are excluded from unity build:
+#   - C sources, mostly bundled third-party libraries that reuse names of static functions and macros between files
+#   - Objective-C and Objective-C++ sources, they are compiled as C and C++ ones with additional options
+#   - sources that match one of AEDI_UNITY_BUILD_EXCLUDE regular expressions
+# C++ targets precompile AEDI_PRECOMPILED_HEADERS, Objective-C++ sources of them don't use precompiled headers
+# Sources with their own compile options are never merged by CMake itself
+
+include_guard(GLOBAL)
+
+function(aedi_unity_build_directory directory)
+    get_property(targets DIRECTORY ${directory} PROPERTY BUILDSYSTEM_TARGETS)
+
+    foreach(target IN LISTS targets)
+        get_target_property(type ${target} TYPE)
+
+        if(NOT type MATCHES "^(EXECUTABLE|STATIC_LIBRARY|SHARED_LIBRARY|MODULE_LIBRARY)$")
+            continue()
+        endif()
+
+        get_target_property(sources ${target} SOURCES)
+        get_target_property(source_dir ${target} SOURCE_DIR)
+        set(has_cxx_sources NO)
+
+        foreach(source IN LISTS sources)
+            if(source MATCHES "\\$<")
+                continue()
+            endif()
+
+            cmake_path(ABSOLUTE_PATH source BASE_DIRECTORY ${source_dir})
+            set(excluded NO)
+
+            if(source MATCHES "\\.(c|m|mm)$")
+                set(excluded YES)
+            else()
+                foreach(pattern IN LISTS AEDI_UNITY_BUILD_EXCLUDE)
+                    if(source MATCHES "${pattern}")
+                        set(excluded YES)
+                    endif()
+                endforeach()
+            endif()
+
+            if(excluded)
+                set_source_files_properties(${source} TARGET_DIRECTORY ${target}
+                    PROPERTIES SKIP_UNITY_BUILD_INCLUSION ON)
+            endif()
+
+            if(source MATCHES "\\.mm$")
+                set_source_files_properties(${source} TARGET_DIRECTORY ${target}
+                    PROPERTIES SKIP_PRECOMPILE_HEADERS ON)
+            elseif(source MATCHES "\\.(cpp|cxx|cc)$")
+                set(has_cxx_sources YES)
+            endif()
+        endforeach()
+
+        if(has_cxx_sources)
+            foreach(header IN LISTS AEDI_PRECOMPILED_HEADERS)
+                target_precompile_headers(${target} PRIVATE "$<$<COMPILE_LANGUAGE:CXX>:${header}>")
+            endforeach()
+        endif()
+    endforeach()
+
+    get_property(subdirectories DIRECTORY ${directory} PROPERTY SUBDIRECTORIES)
+
+    foreach(subdirectory IN LISTS subdirectories)
+        aedi_unity_build_directory(${subdirectory})
+    endforeach()
+endfunction()
+
+function(aedi_unity_build_exclusions)
+    aedi_unity_build_directory(${CMAKE_SOURCE_DIR})
+endfunction()
+
+cmake_language(DEFER DIRECTORY ${CMAKE_SOURCE_DIR} CALL aedi_unity_build_exclusions)
@@ -0,0 +1,386 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <os/lock.h>
+#include <vpx/vp8dx.h>
+
+#include "vpx-iosurface.h"
+
+// Decoder aligns start of every plane to this, it's the strictest alignment of linear textures of Metal GPUs
+// Strides are chosen by decoder too, they are multiples of 32 bytes for luma plane, and of 16 bytes for chroma ones
+#define VPX_IOSURFACE_BYTE_ALIGNMENT 256
+
+#define VPX_IOSURFACE_PLANES 3
+
+// Row size of plain memory surfaces, they have no planes, their size is all that matters
+#define VPX_IOSURFACE_PLAIN_ROW 4096
+
+typedef struct
+{
+    // Zero for plain memory surface
+    OSType format;
+    size_t width[VPX_IOSURFACE_PLANES];
+    size_t height[VPX_IOSURFACE_PLANES];
+    size_t stride[VPX_IOSURFACE_PLANES];
+    size_t offset[VPX_IOSURFACE_PLANES];
+} Layout;
+
+typedef struct Buffer
+{
+    struct Buffer* next;  // in list of free buffers
+    struct Buffer* previous_allocated;
+    struct Buffer* next_allocated;
+    IOSurfaceRef surface;
+    CVPixelBufferRef pixel_buffer;
+    Layout layout;
+    size_t size;
+} Buffer;
+
+struct vpx_iosurface_pool
+{
+    os_unfair_lock lock;
+    Buffer* free_buffers;
+    Buffer* allocated_buffers;
+    Layout layout;   // of the latest decoded frame, surfaces of other layouts are not reused
+    int planar_surfaces_failed;
+    vpx_iosurface_stats stats;
+};
+
+static int LayoutEqual(const Layout* first, const Layout* second)
+{
+    if (first->format != second->format)
+        return 0;
+
+    for (int i = 0; i < VPX_IOSURFACE_PLANES; ++i)
+    {
+        if (first->width[i] != second->width[i] || first->height[i] != second->height[i]
+            || first->stride[i] != second->stride[i] || first->offset[i] != second->offset[i])
+            return 0;
+    }
+
+    return 1;
+}
+
+static void SetNumber(CFMutableDictionaryRef dictionary, CFStringRef key, size_t value)
+{
+    const long long number = (long long)value;
+    CFNumberRef object = CFNumberCreate(kCFAllocatorDefault, kCFNumberLongLongType, &number);
+    CFDictionarySetValue(dictionary, key, object);
+    CFRelease(object);
+}
+
+static CFMutableDictionaryRef CreateDictionary(void)
+{
+    return CFDictionaryCreateMutable(kCFAllocatorDefault, 0,
+        &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+}
+
+static IOSurfaceRef CreateSurface(const Layout* layout, size_t size)
+{
+    CFMutableDictionaryRef properties = CreateDictionary();
+
+    if (layout->format == 0)
+    {
+        SetNumber(properties, kIOSurfaceWidth, VPX_IOSURFACE_PLAIN_ROW);
+        SetNumber(properties, kIOSurfaceHeight, size / VPX_IOSURFACE_PLAIN_ROW);
+        SetNumber(properties, kIOSurfaceBytesPerElement, 1);
+        SetNumber(properties, kIOSurfaceBytesPerRow, VPX_IOSURFACE_PLAIN_ROW);
+    }
+    else
+    {
+        SetNumber(properties, kIOSurfaceWidth, layout->width[0]);
+        SetNumber(properties, kIOSurfaceHeight, layout->height[0]);
+        SetNumber(properties, kIOSurfacePixelFormat, layout->format);
+
+        CFMutableArrayRef planes = CFArrayCreateMutable(kCFAllocatorDefault, VPX_IOSURFACE_PLANES,
+            &kCFTypeArrayCallBacks);
+
+        for (int i = 0; i < VPX_IOSURFACE_PLANES; ++i)
+        {
+            CFMutableDictionaryRef plane = CreateDictionary();
+            SetNumber(plane, kIOSurfacePlaneWidth, layout->width[i]);
+            SetNumber(plane, kIOSurfacePlaneHeight, layout->height[i]);
+            SetNumber(plane, kIOSurfacePlaneBytesPerRow, layout->stride[i]);
+            SetNumber(plane, kIOSurfacePlaneOffset, layout->offset[i]);
+            SetNumber(plane, kIOSurfacePlaneSize, layout->stride[i] * layout->height[i]);
+            SetNumber(plane, kIOSurfacePlaneBytesPerElement, 1);
+            SetNumber(plane, kIOSurfacePlaneElementWidth, 1);
+            SetNumber(plane, kIOSurfacePlaneElementHeight, 1);
+            CFArrayAppendValue(planes, plane);
+            CFRelease(plane);
+        }
+
+        CFDictionarySetValue(properties, kIOSurfacePlaneInfo, planes);
+        CFRelease(planes);
+    }
+
+    SetNumber(properties, kIOSurfaceAllocSize, size);
+
+    IOSurfaceRef surface = IOSurfaceCreate(properties);
+    CFRelease(properties);
+
+    return surface;
+}
+
+static void DestroyBuffer(vpx_iosurface_pool* pool, Buffer* buffer)
+{
+    if (buffer->previous_allocated)
+        buffer->previous_allocated->next_allocated = buffer->next_allocated;
+    else
+        pool->allocated_buffers = buffer->next_allocated;
+
+    if (buffer->next_allocated)
+        buffer->next_allocated->previous_allocated = buffer->previous_allocated;
+
+    // Surface remains alive while GPU or pixel buffer consumers retain it
+    if (buffer->pixel_buffer)
+        CFRelease(buffer->pixel_buffer);
+
+    CFRelease(buffer->surface);
+    free(buffer);
+
+    --pool->stats.surfaces;
+}
+
+static Buffer* CreateBuffer(vpx_iosurface_pool* pool, size_t min_size)
+{
+    Layout layout = pool->layout;
+    size_t size = min_size;
+
+    for (int i = 0; layout.format != 0 && i < VPX_IOSURFACE_PLANES; ++i)
+    {
+        const size_t plane_end = layout.offset[i] + layout.stride[i] * layout.height[i];
+
+        if (plane_end > size)
+            size = plane_end;
+    }
+
+    const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size = (size + VPX_IOSURFACE_PLAIN_ROW - 1) / VPX_IOSURFACE_PLAIN_ROW * VPX_IOSURFACE_PLAIN_ROW;
+    size = (size + page_size - 1) / page_size * page_size;
+
+    IOSurfaceRef surface = CreateSurface(&layout, size);
+
+    if (surface == NULL && layout.format != 0)
+    {
+        // Layout cannot be described as surface planes, decoding continues to plain memory surfaces
+        pool->planar_surfaces_failed = 1;
+        memset(&pool->layout, 0, sizeof(Layout));
+        memset(&layout, 0, sizeof(Layout));
+        surface = CreateSurface(&layout, size);
+    }
+
+    if (surface == NULL)
+        return NULL;
+
+    Buffer* buffer = calloc(1, sizeof(Buffer));
+
+    if (buffer == NULL)
+    {
+        CFRelease(surface);
+        return NULL;
+    }
+
+    buffer->surface = surface;
+    buffer->layout = layout;
+    buffer->size = size;
+
+    buffer->next_allocated = pool->allocated_buffers;
+
+    if (pool->allocated_buffers)
+        pool->allocated_buffers->previous_allocated = buffer;
+
+    pool->allocated_buffers = buffer;
+    ++pool->stats.surfaces;
+
+    return buffer;
+}
+
+static int GetFrameBuffer(void* priv, size_t min_size, vpx_codec_frame_buffer_t* frame_buffer)
+{
+    vpx_iosurface_pool* pool = priv;
+    Buffer* buffer = NULL;
+
+    os_unfair_lock_lock(&pool->lock);
+
+    for (Buffer** link = &pool->free_buffers; *link != NULL; )
+    {
+        Buffer* candidate = *link;
+
+        if (IOSurfaceIsInUse(candidate->surface))
+        {
+            link = &candidate->next;
+        }
+        else if (!LayoutEqual(&candidate->layout, &pool->layout))
+        {
+            // Layout changed after surface was returned to pool
+            *link = candidate->next;
+            DestroyBuffer(pool, candidate);
+        }
+        else if (candidate->size >= min_size)
+        {
+            *link = candidate->next;
+            buffer = candidate;
+            break;
+        }
+        else
+        {
+            link = &candidate->next;
+        }
+    }
+
+    if (buffer == NULL)
+        buffer = CreateBuffer(pool, min_size);
+
+    os_unfair_lock_unlock(&pool->lock);
+
+    if (buffer == NULL)
+        return -1;
+
+    // Memory of new surface is zero-filled, decoder may read borders of reference frames before it writes them
+    IOSurfaceLock(buffer->surface, 0, NULL);
+
+    frame_buffer->data = IOSurfaceGetBaseAddress(buffer->surface);
+    frame_buffer->size = buffer->size;
+    frame_buffer->priv = buffer;
+
+    return 0;
+}
+
+static int ReleaseFrameBuffer(void* priv, vpx_codec_frame_buffer_t* frame_buffer)
+{
+    vpx_iosurface_pool* pool = priv;
+    Buffer* buffer = frame_buffer->priv;
+
+    if (buffer == NULL)
+        return 0;
+
+    IOSurfaceUnlock(buffer->surface, 0, NULL);
+
+    os_unfair_lock_lock(&pool->lock);
+
+    // Surfaces of previous layout are replaced with ones that match frames of the current layout
+    if (LayoutEqual(&buffer->layout, &pool->layout))
+    {
+        buffer->next = pool->free_buffers;
+        pool->free_buffers = buffer;
+    }
+    else
+    {
+        DestroyBuffer(pool, buffer);
+    }
+
+    os_unfair_lock_unlock(&pool->lock);
+
+    return 0;
+}
+
+vpx_iosurface_pool* vpx_iosurface_pool_create(void)
+{
+    vpx_iosurface_pool* pool = calloc(1, sizeof(vpx_iosurface_pool));
+
+    if (pool != NULL)
+        pool->lock = OS_UNFAIR_LOCK_INIT;
+
+    return pool;
+}
+
+void vpx_iosurface_pool_destroy(vpx_iosurface_pool* pool)
+{
+    if (pool == NULL)
+        return;
+
+    while (pool->allocated_buffers != NULL)
+        DestroyBuffer(pool, pool->allocated_buffers);
+
+    free(pool);
+}
+
+vpx_codec_err_t vpx_iosurface_attach(vpx_codec_ctx_t* codec, vpx_iosurface_pool* pool)
+{
+    const vpx_codec_err_t result =
+        vpx_codec_set_frame_buffer_functions(codec, GetFrameBuffer, ReleaseFrameBuffer, pool);
+
+    if (result != VPX_CODEC_OK)
+        return result;
+
+    return vpx_codec_control(codec, VP9_SET_BYTE_ALIGNMENT, VPX_IOSURFACE_BYTE_ALIGNMENT);
+}
+
+static Buffer* ImportedBuffer(vpx_iosurface_pool* pool, const vpx_image_t* image)
+{
+    Buffer* buffer = image->fb_priv;
+
+    if (buffer == NULL)
+        return NULL;
+
+    Layout layout;
+    memset(&layout, 0, sizeof(Layout));
+
+    // Only 8-bit 4:2:0 frames have pixel format surfaces can be described with
+    if (image->fmt == VPX_IMG_FMT_I420)
+    {
+        const uint8_t* base = IOSurfaceGetBaseAddress(buffer->surface);
+
+        layout.format = image->range == VPX_CR_FULL_RANGE
+            ? kCVPixelFormatType_420YpCbCr8PlanarFullRange
+            : kCVPixelFormatType_420YpCbCr8Planar;
+
+        for (int i = 0; i < VPX_IOSURFACE_PLANES; ++i)
+        {
+            const unsigned x_shift = i == 0 ? 0 : image->x_chroma_shift;
+            const unsigned y_shift = i == 0 ? 0 : image->y_chroma_shift;
+
+            layout.width[i] = (image->d_w + (1u << x_shift) - 1) >> x_shift;
+            layout.height[i] = (image->d_h + (1u << y_shift) - 1) >> y_shift;
+            layout.stride[i] = (size_t)image->stride[i];
+            layout.offset[i] = (size_t)(image->planes[i] - base);
+        }
+    }
+
+    os_unfair_lock_lock(&pool->lock);
+
+    // Layout of the first frames, and of frames after resolution change, is learned here
+    if (!pool->planar_surfaces_failed)
+        pool->layout = layout;
+
+    const int imported = layout.format != 0 && LayoutEqual(&buffer->layout, &layout);
+
+    ++pool->stats.frames;
+
+    if (imported)
+        ++pool->stats.imported_frames;
+
+    os_unfair_lock_unlock(&pool->lock);
+
+    return imported ? buffer : NULL;
+}
+
+IOSurfaceRef vpx_iosurface_surface(vpx_iosurface_pool* pool, const vpx_image_t* image)
+{
+    Buffer* buffer = ImportedBuffer(pool, image);
+    return buffer ? buffer->surface : NULL;
+}
+
+CVPixelBufferRef vpx_iosurface_pixel_buffer(vpx_iosurface_pool* pool, const vpx_image_t* image)
+{
+    Buffer* buffer = ImportedBuffer(pool, image);
+
+    if (buffer == NULL)
+        return NULL;
+
+    // Pixel buffer is made once, and then shows every frame that decoder writes to its surface
+    if (buffer->pixel_buffer == NULL)
+        CVPixelBufferCreateWithIOSurface(kCFAllocatorDefault, buffer->surface, NULL, &buffer->pixel_buffer);
+
+    return buffer->pixel_buffer;
+}
+
+void vpx_iosurface_pool_stats(vpx_iosurface_pool* pool, vpx_iosurface_stats* stats)
+{
+    os_unfair_lock_lock(&pool->lock);
+    *stats = pool->stats;
+    os_unfair_lock_unlock(&pool->lock);
+}
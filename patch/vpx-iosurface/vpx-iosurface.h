@@ -0,0 +1,55 @@
+#ifndef VPX_IOSURFACE_H
+#define VPX_IOSURFACE_H
+
+#include <stddef.h>
+
+#include <CoreVideo/CoreVideo.h>
+#include <IOSurface/IOSurface.h>
+#include <vpx/vpx_decoder.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// VP9 decoding into IOSurfaces, so frames can be used as textures with no copies, and converted to RGB on GPU
+//
+// Pool gives IOSurface memory to libvpx via external frame buffer API, plane layout of frames is chosen by decoder,
+// so the first frames go to plain memory surfaces, and once layout is known, surfaces with matching 4:2:0 planes
+// replace them. Frames of such surfaces are imported by vpx_iosurface_surface(), e.g. for Metal textures of planes,
+// or by vpx_iosurface_pixel_buffer(), other frames, e.g. the first ones and 4:4:4 ones, should be uploaded as usual
+//
+// Decoder reuses surface after frame is replaced, surface that is still read by GPU must be kept by
+// IOSurfaceIncrementUseCount() until then, pool doesn't give surfaces in use to decoder
+
+typedef struct vpx_iosurface_pool vpx_iosurface_pool;
+
+typedef struct
+{
+    size_t surfaces;        // currently allocated
+    size_t frames;          // passed to vpx_iosurface_surface() or vpx_iosurface_pixel_buffer()
+    size_t imported_frames; // of them, ones with IOSurface returned
+} vpx_iosurface_stats;
+
+vpx_iosurface_pool* vpx_iosurface_pool_create(void);
+
+// Must be called after vpx_codec_destroy() of decoder the pool is attached to
+void vpx_iosurface_pool_destroy(vpx_iosurface_pool* pool);
+
+// Sets frame buffer functions of decoder, must be called before the first vpx_codec_decode()
+// VP9 supports external frame buffers, VP8 doesn't, VPX_CODEC_INCAPABLE or other error is returned then
+vpx_codec_err_t vpx_iosurface_attach(vpx_codec_ctx_t* codec, vpx_iosurface_pool* pool);
+
+// IOSurface with planes of the given decoded image, or NULL if it cannot be imported
+// Returned surface is owned by pool, and holds the image until the next frame replaces it
+IOSurfaceRef vpx_iosurface_surface(vpx_iosurface_pool* pool, const vpx_image_t* image);
+
+// The same as vpx_iosurface_surface() but wrapped into pixel buffer of 420YpCbCr8Planar format, full or video range
+CVPixelBufferRef vpx_iosurface_pixel_buffer(vpx_iosurface_pool* pool, const vpx_image_t* image);
+
+void vpx_iosurface_pool_stats(vpx_iosurface_pool* pool, vpx_iosurface_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
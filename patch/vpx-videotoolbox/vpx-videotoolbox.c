@@ -0,0 +1,631 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <VideoToolbox/VideoToolbox.h>
+#include <vpx/internal/vpx_codec_internal.h>
+#include <vpx/vp8dx.h>
+
+#include "vpx-videotoolbox.h"
+
+// Values of color_space field of VP9 uncompressed frame header
+#define VP9_COLOR_SPACE_UNKNOWN 0
+#define VP9_COLOR_SPACE_BT_601  1
+#define VP9_COLOR_SPACE_BT_709  2
+#define VP9_COLOR_SPACE_SMPTE_170 3
+#define VP9_COLOR_SPACE_RGB     7
+
+typedef enum
+{
+    MODE_UNKNOWN = -1,  // no key frame yet, libvpx reports errors for packets then
+    MODE_SOFTWARE = 0,
+    MODE_HARDWARE = 1,
+} Mode;
+
+// Properties of stream from header of key frame, ones that hardware decoding and its format description depend on
+typedef struct
+{
+    int profile;
+    int bit_depth;
+    int color_space;
+    int full_range;
+    int subsampling_x;
+    int subsampling_y;
+    int width;
+    int height;
+} StreamConfig;
+
+typedef struct
+{
+    // Must be the first member, libvpx accesses decoder state as vpx_codec_priv_t
+    vpx_codec_priv_t base;
+    vpx_codec_dec_cfg_t config;
+
+    // Fallback decoder, controls and frame buffer functions are always forwarded to it, so it's ready at key frame
+    vpx_codec_ctx_t software;
+    int software_initialized;
+
+    Mode mode;
+    int hardware_failed;  // decoding in hardware is not tried again for this stream then
+
+    StreamConfig stream;
+    CMVideoFormatDescriptionRef format;
+    VTDecompressionSessionRef session;
+
+    // Written by output callback, which can be called on other thread, but it's waited for before they are read
+    CVPixelBufferRef output;
+    OSStatus output_status;
+
+    void* user_priv;
+    int output_locked;  // base address of output is locked while its image is given to caller
+    vpx_image_t image;
+} Decoder;
+
+static pthread_once_t hardware_check_once = PTHREAD_ONCE_INIT;
+static int hardware_supported;
+
+static void CheckHardware(void)
+{
+    const char* const enabled = getenv("VPX_VIDEOTOOLBOX");
+
+    if (enabled != NULL && strcmp(enabled, "0") == 0)
+        return;
+
+    if (__builtin_available(macOS 11.0, *))
+    {
+        // VP9 decoder of VideoToolbox is not available to applications until it's registered
+        VTRegisterSupplementalVideoDecoderIfAvailable(kCMVideoCodecType_VP9);
+        hardware_supported = VTIsHardwareDecodeSupported(kCMVideoCodecType_VP9);
+    }
+}
+
+static int HardwareSupported(void)
+{
+    pthread_once(&hardware_check_once, CheckHardware);
+    return hardware_supported;
+}
+
+typedef struct
+{
+    const uint8_t* data;
+    size_t size;
+    size_t position;  // in bits
+} BitReader;
+
+static int ReadBits(BitReader* reader, int count)
+{
+    int value = 0;
+
+    for (int i = 0; i < count; ++i, ++reader->position)
+    {
+        const size_t byte = reader->position / 8;
+        const int bit = byte < reader->size ? (reader->data[byte] >> (7 - reader->position % 8)) & 1 : 0;
+        value = (value << 1) | bit;
+    }
+
+    return value;
+}
+
+// Returns non-zero for key frame, and fills stream config from its uncompressed header
+// Header of the first frame begins at the start of packet, superframe or not
+static int ParseKeyFrame(const uint8_t* data, size_t size, StreamConfig* config)
+{
+    // Header fields up to and including frame size take 10 bytes at most
+    if (size < 10)
+        return 0;
+
+    BitReader reader = { data, size, 0 };
+
+    if (ReadBits(&reader, 2) != 2)  // frame_marker
+        return 0;
+
+    const int profile_low_bit = ReadBits(&reader, 1);
+    const int profile = (ReadBits(&reader, 1) << 1) | profile_low_bit;
+
+    if (profile == 3)
+        ReadBits(&reader, 1);  // reserved_zero
+
+    if (ReadBits(&reader, 1))  // show_existing_frame
+        return 0;
+
+    if (ReadBits(&reader, 1) != 0)  // frame_type, zero is KEY_FRAME
+        return 0;
+
+    ReadBits(&reader, 2);  // show_frame, error_resilient_mode
+
+    if (ReadBits(&reader, 24) != 0x498342)  // frame_sync_code
+        return 0;
+
+    config->profile = profile;
+    config->bit_depth = profile >= 2 ? (ReadBits(&reader, 1) ? 12 : 10) : 8;
+    config->color_space = ReadBits(&reader, 3);
+
+    if (config->color_space != VP9_COLOR_SPACE_RGB)
+    {
+        config->full_range = ReadBits(&reader, 1);
+
+        if (profile == 1 || profile == 3)
+        {
+            config->subsampling_x = ReadBits(&reader, 1);
+            config->subsampling_y = ReadBits(&reader, 1);
+            ReadBits(&reader, 1);  // reserved_zero
+        }
+        else
+        {
+            config->subsampling_x = 1;
+            config->subsampling_y = 1;
+        }
+    }
+    else
+    {
+        config->full_range = 1;
+        config->subsampling_x = 0;
+        config->subsampling_y = 0;
+    }
+
+    config->width = ReadBits(&reader, 16) + 1;
+    config->height = ReadBits(&reader, 16) + 1;
+
+    return 1;
+}
+
+static int StreamConfigEqual(const StreamConfig* first, const StreamConfig* second)
+{
+    return memcmp(first, second, sizeof *first) == 0;
+}
+
+static int CanDecodeInHardware(const StreamConfig* config)
+{
+    // Output images are I420, i.e. 8-bit 4:2:0, like ones of libvpx built without high bit depth support
+    return config->profile == 0 && config->color_space != VP9_COLOR_SPACE_RGB && HardwareSupported();
+}
+
+static CFMutableDictionaryRef CreateDictionary(void)
+{
+    return CFDictionaryCreateMutable(kCFAllocatorDefault, 0,
+        &kCFTypeDictionaryKeyCallBacks, &kCFTypeDictionaryValueCallBacks);
+}
+
+static void SetNumber(CFMutableDictionaryRef dictionary, CFStringRef key, int value)
+{
+    CFNumberRef object = CFNumberCreate(kCFAllocatorDefault, kCFNumberIntType, &value);
+    CFDictionarySetValue(dictionary, key, object);
+    CFRelease(object);
+}
+
+static CMVideoFormatDescriptionRef CreateFormat(const StreamConfig* config)
+{
+    // Color primaries, transfer characteristics, and matrix coefficients, as ISO/IEC 23091-4 code points
+    uint8_t color = 2;  // unspecified
+
+    if (config->color_space == VP9_COLOR_SPACE_BT_709)
+        color = 1;
+    else if (config->color_space == VP9_COLOR_SPACE_BT_601 || config->color_space == VP9_COLOR_SPACE_SMPTE_170)
+        color = 6;
+
+    // VP codec configuration record of 'vpcC' box, version 1, level is unknown
+    const uint8_t record[] =
+    {
+        1, 0, 0, 0,
+        (uint8_t)config->profile,
+        0,
+        (uint8_t)((config->bit_depth << 4) | (config->full_range & 1)),  // chroma subsampling is 4:2:0 vertical
+        color, color, color,
+        0, 0,  // codec initialization data size
+    };
+
+    CFDataRef record_data = CFDataCreate(kCFAllocatorDefault, record, sizeof record);
+    CFMutableDictionaryRef atoms = CreateDictionary();
+    CFDictionarySetValue(atoms, CFSTR("vpcC"), record_data);
+    CFRelease(record_data);
+
+    CFMutableDictionaryRef extensions = CreateDictionary();
+    CFDictionarySetValue(extensions, kCMFormatDescriptionExtension_SampleDescriptionExtensionAtoms, atoms);
+    CFDictionarySetValue(extensions, kCMFormatDescriptionExtension_FullRangeVideo,
+        config->full_range ? kCFBooleanTrue : kCFBooleanFalse);
+    CFRelease(atoms);
+
+    CMVideoFormatDescriptionRef format = NULL;
+
+    if (CMVideoFormatDescriptionCreate(kCFAllocatorDefault, kCMVideoCodecType_VP9,
+        config->width, config->height, extensions, &format) != noErr)
+        format = NULL;
+
+    CFRelease(extensions);
+    return format;
+}
+
+static void OutputCallback(void* decoder_pointer, void* source_frame, OSStatus status,
+    VTDecodeInfoFlags flags, CVImageBufferRef image_buffer, CMTime presentation_time, CMTime duration)
+{
+    (void)source_frame;
+    (void)presentation_time;
+    (void)duration;
+
+    Decoder* decoder = decoder_pointer;
+
+    if (status != noErr)
+        decoder->output_status = status;
+    else if (image_buffer != NULL && (flags & kVTDecodeInfo_FrameDropped) == 0)
+    {
+        // Packet has one shown frame at most, hidden frames of superframe produce no output
+        CVPixelBufferRelease(decoder->output);
+        decoder->output = CVPixelBufferRetain(image_buffer);
+    }
+}
+
+static void ReleaseOutput(Decoder* decoder)
+{
+    if (decoder->output == NULL)
+        return;
+
+    if (decoder->output_locked)
+    {
+        CVPixelBufferUnlockBaseAddress(decoder->output, kCVPixelBufferLock_ReadOnly);
+        decoder->output_locked = 0;
+    }
+
+    CVPixelBufferRelease(decoder->output);
+    decoder->output = NULL;
+}
+
+static void DestroySession(Decoder* decoder)
+{
+    ReleaseOutput(decoder);
+
+    if (decoder->session != NULL)
+    {
+        VTDecompressionSessionInvalidate(decoder->session);
+        CFRelease(decoder->session);
+        decoder->session = NULL;
+    }
+
+    if (decoder->format != NULL)
+    {
+        CFRelease(decoder->format);
+        decoder->format = NULL;
+    }
+}
+
+static int CreateSession(Decoder* decoder, const StreamConfig* config)
+{
+    decoder->format = CreateFormat(config);
+
+    if (decoder->format == NULL)
+        return 0;
+
+    // Software decoder of VideoToolbox is not better than libvpx, so fallback is libvpx only
+    CFMutableDictionaryRef specification = CreateDictionary();
+    CFDictionarySetValue(specification,
+        kVTVideoDecoderSpecification_RequireHardwareAcceleratedVideoDecoder, kCFBooleanTrue);
+
+    // Planar format is converted from biplanar one of decoder without CPU, pixel buffers are backed by IOSurfaces
+    // so frames can be used as textures with no copies, like ones of vpx-iosurface
+    CFMutableDictionaryRef attributes = CreateDictionary();
+    SetNumber(attributes, kCVPixelBufferPixelFormatTypeKey, config->full_range
+        ? kCVPixelFormatType_420YpCbCr8PlanarFullRange : kCVPixelFormatType_420YpCbCr8Planar);
+    SetNumber(attributes, kCVPixelBufferWidthKey, config->width);
+    SetNumber(attributes, kCVPixelBufferHeightKey, config->height);
+
+    CFMutableDictionaryRef surface_properties = CreateDictionary();
+    CFDictionarySetValue(attributes, kCVPixelBufferIOSurfacePropertiesKey, surface_properties);
+    CFRelease(surface_properties);
+
+    const VTDecompressionOutputCallbackRecord callback = { OutputCallback, decoder };
+    const OSStatus status = VTDecompressionSessionCreate(kCFAllocatorDefault, decoder->format,
+        specification, attributes, &callback, &decoder->session);
+
+    CFRelease(attributes);
+    CFRelease(specification);
+
+    if (status != noErr)
+    {
+        decoder->session = NULL;
+        DestroySession(decoder);
+        return 0;
+    }
+
+    decoder->stream = *config;
+    return 1;
+}
+
+static int DecodeInHardware(Decoder* decoder, const uint8_t* data, size_t size)
+{
+    // Decoding is synchronous, so packet memory is given to decoder with no copy
+    CMBlockBufferRef block = NULL;
+
+    if (CMBlockBufferCreateWithMemoryBlock(kCFAllocatorDefault, (void*)data, size,
+        kCFAllocatorNull, NULL, 0, size, 0, &block) != kCMBlockBufferNoErr)
+        return 0;
+
+    CMSampleBufferRef sample = NULL;
+    OSStatus status = CMSampleBufferCreateReady(kCFAllocatorDefault, block, decoder->format,
+        1, 0, NULL, 1, &size, &sample);
+
+    if (status == noErr)
+    {
+        decoder->output_status = noErr;
+
+        VTDecodeInfoFlags flags = 0;
+        status = VTDecompressionSessionDecodeFrame(decoder->session, sample, 0, NULL, &flags);
+
+        if (status == noErr)
+            status = VTDecompressionSessionWaitForAsynchronousFrames(decoder->session);
+
+        if (status == noErr)
+            status = decoder->output_status;
+
+        CFRelease(sample);
+    }
+
+    CFRelease(block);
+    return status == noErr;
+}
+
+static vpx_codec_err_t SoftwareError(Decoder* decoder, vpx_codec_err_t result)
+{
+    decoder->base.err_detail = result == VPX_CODEC_OK ? NULL : vpx_codec_error_detail(&decoder->software);
+    return result;
+}
+
+static vpx_codec_err_t Destroy(vpx_codec_alg_priv_t* state);
+
+static vpx_codec_err_t Init(vpx_codec_ctx_t* codec, vpx_codec_priv_enc_mr_cfg_t* data)
+{
+    (void)data;
+
+    if (codec->priv != NULL)
+        return VPX_CODEC_OK;
+
+    Decoder* decoder = calloc(1, sizeof(Decoder));
+
+    if (decoder == NULL)
+        return VPX_CODEC_MEM_ERROR;
+
+    codec->priv = &decoder->base;
+    codec->priv->init_flags = codec->init_flags;
+
+    if (codec->config.dec != NULL)
+    {
+        decoder->config = *codec->config.dec;
+        codec->config.dec = &decoder->config;
+    }
+
+    decoder->mode = MODE_UNKNOWN;
+
+    const vpx_codec_err_t result = vpx_codec_dec_init(&decoder->software, vpx_codec_vp9_dx(),
+        codec->config.dec, codec->init_flags);
+    decoder->software_initialized = result == VPX_CODEC_OK;
+
+    return SoftwareError(decoder, result);
+}
+
+static vpx_codec_err_t Destroy(vpx_codec_alg_priv_t* state)
+{
+    Decoder* decoder = (Decoder*)state;
+
+    DestroySession(decoder);
+
+    if (decoder->software_initialized)
+        vpx_codec_destroy(&decoder->software);
+
+    free(decoder);
+    return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t PeekStreamInfo(const uint8_t* data, unsigned int size, vpx_codec_stream_info_t* info)
+{
+    return vpx_codec_peek_stream_info(vpx_codec_vp9_dx(), data, size, info);
+}
+
+static vpx_codec_err_t GetStreamInfo(vpx_codec_alg_priv_t* state, vpx_codec_stream_info_t* info)
+{
+    Decoder* decoder = (Decoder*)state;
+
+    if (decoder->mode != MODE_HARDWARE)
+        return SoftwareError(decoder, vpx_codec_get_stream_info(&decoder->software, info));
+
+    info->w = (unsigned int)decoder->stream.width;
+    info->h = (unsigned int)decoder->stream.height;
+    return VPX_CODEC_OK;
+}
+
+// Deadline argument, which the latest libvpx versions don't have, is not used, so function type is cast
+static vpx_codec_err_t Decode(vpx_codec_alg_priv_t* state, const uint8_t* data, unsigned int size, void* user_priv)
+{
+    Decoder* decoder = (Decoder*)state;
+
+    // Frame of the previous packet is valid until this one is decoded, the same as with libvpx
+    ReleaseOutput(decoder);
+
+    if (data == NULL)
+    {
+        // Flush, hardware decoding is synchronous, so only libvpx may have frames to output
+        return decoder->mode == MODE_HARDWARE
+            ? VPX_CODEC_OK : SoftwareError(decoder, vpx_codec_decode(&decoder->software, NULL, 0, user_priv, 0));
+    }
+
+    StreamConfig config;
+
+    if (ParseKeyFrame(data, size, &config))
+    {
+        if (!decoder->hardware_failed && CanDecodeInHardware(&config))
+        {
+            if (decoder->session == NULL || !StreamConfigEqual(&config, &decoder->stream))
+            {
+                DestroySession(decoder);
+                decoder->hardware_failed = !CreateSession(decoder, &config);
+            }
+        }
+        else
+            DestroySession(decoder);
+
+        decoder->mode = decoder->session != NULL ? MODE_HARDWARE : MODE_SOFTWARE;
+    }
+
+    if (decoder->mode == MODE_HARDWARE)
+    {
+        if (DecodeInHardware(decoder, data, size))
+        {
+            decoder->user_priv = user_priv;
+            decoder->base.err_detail = NULL;
+            return VPX_CODEC_OK;
+        }
+
+        // libvpx reports errors until the next key frame, and decodes stream from it
+        DestroySession(decoder);
+        decoder->hardware_failed = 1;
+        decoder->mode = MODE_SOFTWARE;
+    }
+
+    return SoftwareError(decoder, vpx_codec_decode(&decoder->software, data, size, user_priv, 0));
+}
+
+static vpx_image_t* GetFrame(vpx_codec_alg_priv_t* state, vpx_codec_iter_t* iterator)
+{
+    Decoder* decoder = (Decoder*)state;
+    CVPixelBufferRef output = decoder->output;
+
+    if (output == NULL)
+        return vpx_codec_get_frame(&decoder->software, iterator);
+
+    if (*iterator != NULL)
+        return NULL;
+
+    if (!decoder->output_locked)
+    {
+        if (CVPixelBufferLockBaseAddress(output, kCVPixelBufferLock_ReadOnly) != kCVReturnSuccess)
+            return NULL;
+
+        decoder->output_locked = 1;
+    }
+
+    vpx_image_t* const image = &decoder->image;
+    memset(image, 0, sizeof *image);
+
+    image->fmt = VPX_IMG_FMT_I420;
+    image->range = decoder->stream.full_range ? VPX_CR_FULL_RANGE : VPX_CR_STUDIO_RANGE;
+    image->w = image->d_w = (unsigned int)CVPixelBufferGetWidth(output);
+    image->h = image->d_h = (unsigned int)CVPixelBufferGetHeight(output);
+    image->bit_depth = 8;
+    image->x_chroma_shift = 1;
+    image->y_chroma_shift = 1;
+    image->bps = 12;
+    image->user_priv = decoder->user_priv;
+
+    static const vpx_color_space_t color_spaces[] =
+    {
+        VPX_CS_UNKNOWN, VPX_CS_BT_601, VPX_CS_BT_709, VPX_CS_SMPTE_170,
+    };
+
+    if (decoder->stream.color_space < (int)(sizeof color_spaces / sizeof color_spaces[0]))
+        image->cs = color_spaces[decoder->stream.color_space];
+
+    static const int planes[] = { VPX_PLANE_Y, VPX_PLANE_U, VPX_PLANE_V };
+
+    for (size_t i = 0; i < sizeof planes / sizeof planes[0]; ++i)
+    {
+        image->planes[planes[i]] = CVPixelBufferGetBaseAddressOfPlane(output, i);
+        image->stride[planes[i]] = (int)CVPixelBufferGetBytesPerRowOfPlane(output, i);
+    }
+
+    *iterator = decoder;
+    return image;
+}
+
+static vpx_codec_err_t SetFrameBufferFunctions(vpx_codec_alg_priv_t* state,
+    vpx_get_frame_buffer_cb_fn_t get, vpx_release_frame_buffer_cb_fn_t release, void* user_data)
+{
+    // External frame buffers are used by libvpx only, hardware decoder allocates its pixel buffers
+    Decoder* decoder = (Decoder*)state;
+    return SoftwareError(decoder, vpx_codec_set_frame_buffer_functions(&decoder->software, get, release, user_data));
+}
+
+static vpx_codec_err_t GetSize(Decoder* decoder, int control, va_list arguments)
+{
+    int* const size = va_arg(arguments, int*);
+
+    if (decoder->mode != MODE_HARDWARE)
+        return SoftwareError(decoder, vpx_codec_control_(&decoder->software, control, size));
+
+    if (size == NULL)
+        return VPX_CODEC_INVALID_PARAM;
+
+    size[0] = decoder->stream.width;
+    size[1] = decoder->stream.height;
+    return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t GetDisplaySize(vpx_codec_alg_priv_t* state, va_list arguments)
+{
+    return GetSize((Decoder*)state, VP9D_GET_DISPLAY_SIZE, arguments);
+}
+
+static vpx_codec_err_t GetFrameSize(vpx_codec_alg_priv_t* state, va_list arguments)
+{
+    return GetSize((Decoder*)state, VP9D_GET_FRAME_SIZE, arguments);
+}
+
+// Other controls have no effect on hardware decoding, and their queries report the state of libvpx decoder
+#define FORWARD_CONTROL(CONTROL, TYPE) \
+    static vpx_codec_err_t Forward_##CONTROL(vpx_codec_alg_priv_t* state, va_list arguments) \
+    { \
+        Decoder* decoder = (Decoder*)state; \
+        return SoftwareError(decoder, vpx_codec_control_(&decoder->software, CONTROL, va_arg(arguments, TYPE))); \
+    }
+
+FORWARD_CONTROL(VP8D_GET_FRAME_CORRUPTED, int*)
+FORWARD_CONTROL(VPXD_GET_LAST_QUANTIZER, int*)
+FORWARD_CONTROL(VP9D_GET_BIT_DEPTH, unsigned int*)
+FORWARD_CONTROL(VP9_SET_BYTE_ALIGNMENT, int)
+FORWARD_CONTROL(VP9_INVERT_TILE_DECODE_ORDER, int)
+FORWARD_CONTROL(VP9_SET_SKIP_LOOP_FILTER, int)
+FORWARD_CONTROL(VP9D_SET_ROW_MT, int)
+
+#undef FORWARD_CONTROL
+
+static vpx_codec_ctrl_fn_map_t controls[] =
+{
+    { VP9D_GET_DISPLAY_SIZE, GetDisplaySize },
+    { VP9D_GET_FRAME_SIZE, GetFrameSize },
+    { VP8D_GET_FRAME_CORRUPTED, Forward_VP8D_GET_FRAME_CORRUPTED },
+    { VPXD_GET_LAST_QUANTIZER, Forward_VPXD_GET_LAST_QUANTIZER },
+    { VP9D_GET_BIT_DEPTH, Forward_VP9D_GET_BIT_DEPTH },
+    { VP9_SET_BYTE_ALIGNMENT, Forward_VP9_SET_BYTE_ALIGNMENT },
+    { VP9_INVERT_TILE_DECODE_ORDER, Forward_VP9_INVERT_TILE_DECODE_ORDER },
+    { VP9_SET_SKIP_LOOP_FILTER, Forward_VP9_SET_SKIP_LOOP_FILTER },
+    { VP9D_SET_ROW_MT, Forward_VP9D_SET_ROW_MT },
+    { -1, NULL },
+};
+
+vpx_codec_iface_t vpx_codec_vp9_videotoolbox_dx_algo =
+{
+    .name = "VideoToolbox VP9 Decoder with libvpx fallback",
+    .abi_version = VPX_CODEC_INTERNAL_ABI_VERSION,
+    .caps = VPX_CODEC_CAP_DECODER | VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER,
+    .init = Init,
+    .destroy = Destroy,
+    .ctrl_maps = controls,
+    .dec =
+    {
+        .peek_si = PeekStreamInfo,
+        .get_si = GetStreamInfo,
+        .decode = (vpx_codec_decode_fn_t)Decode,
+        .get_frame = GetFrame,
+        .set_fb_fn = SetFrameBufferFunctions,
+    },
+};
+
+vpx_codec_iface_t* vpx_codec_vp9_videotoolbox_dx(void)
+{
+    return &vpx_codec_vp9_videotoolbox_dx_algo;
+}
+
+int vpx_videotoolbox_is_hardware(vpx_codec_ctx_t* codec)
+{
+    if (codec == NULL || codec->iface != &vpx_codec_vp9_videotoolbox_dx_algo || codec->priv == NULL)
+        return MODE_UNKNOWN;
+
+    return ((Decoder*)codec->priv)->mode;
+}
@@ -0,0 +1,29 @@
+#ifndef VPX_VIDEOTOOLBOX_H
+#define VPX_VIDEOTOOLBOX_H
+
+#include <vpx/vpx_decoder.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// VP9 decoder interface for vpx_codec_dec_init() in place of vpx_codec_vp9_dx(), the rest of libvpx API is the same
+//
+// Streams of profile 0, i.e. 8-bit 4:2:0, are decoded by VideoToolbox when the running Mac has hardware VP9 decoder,
+// other streams, and all streams on other Macs, by libvpx VP9 decoder. The choice is made at every key frame,
+// and when hardware decoding fails, the stream continues with libvpx. Frames are I420 images in both cases,
+// hardware decoded ones point to IOSurface-backed pixel buffers, and are valid until the next vpx_codec_decode()
+// VPX_VIDEOTOOLBOX=0 environment variable disables hardware decoding, e.g. to compare CPU usage
+
+extern vpx_codec_iface_t vpx_codec_vp9_videotoolbox_dx_algo;
+vpx_codec_iface_t* vpx_codec_vp9_videotoolbox_dx(void);
+
+// 1 if the latest key frame of decoder, initialized with the interface above, was decoded in hardware,
+// 0 if it was decoded by libvpx, -1 if there was no key frame yet, or decoder uses other interface
+int vpx_videotoolbox_is_hardware(vpx_codec_ctx_t* codec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,676 @@
+// Extraction of WAD files into directory trees, memory-mapped counterpart of wadext, see WadExtMmapTarget
+//
+// Usage: wadext-mmap [-j jobs] [-raw] <file.wad> [output directory]
+//
+// WAD file is mapped into memory, lumps are written to their files directly from the mapping, so their data
+// is neither read into heap nor copied, pages of file are served from page cache, and are read ahead sequentially
+// Every output file is one task of worker pool, all CPU cores are used by default
+//
+// Lumps between namespace markers go to subdirectories, e.g. sprites, flats and patches, map lumps are written
+// as PWAD per map to maps subdirectory, other lumps are written to root of output directory, except sounds
+// and music that are found by their signatures
+// Unless -raw is given, Doom format pictures and flats are converted to PNG with the first palette of PLAYPAL,
+// pictures keep their offsets in grAb chunk, and DMX sounds are converted to WAV, like wadext does
+// Names are lowercase, backslashes are replaced with carets, duplicate names get numeric suffixes
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+// Writes larger than 2 GB fail on macOS, no lump is that large in practice
+static constexpr size_t MAX_WRITE_SIZE = 1024 * 1024 * 1024;
+
+static constexpr size_t HEADER_SIZE = 12;
+static constexpr size_t DIRECTORY_ENTRY_SIZE = 16;
+static constexpr size_t PALETTE_SIZE = 768;
+static constexpr int MAX_PICTURE_SIZE = 4096;
+
+enum class Conversion
+{
+    None,
+    Picture,
+    Flat,
+    Sound,
+};
+
+struct Lump
+{
+    const uint8_t* data;
+    size_t size;
+    std::string name;
+};
+
+struct Task
+{
+    std::string path;
+    Conversion conversion;
+    std::vector<Lump> lumps;  // single lump for everything except maps
+};
+
+static uint16_t ReadU16(const uint8_t* data)
+{
+    return uint16_t(data[0] | (data[1] << 8));
+}
+
+static uint32_t ReadU32(const uint8_t* data)
+{
+    return uint32_t(data[0]) | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+}
+
+static void AppendU16(std::vector<uint8_t>& buffer, uint32_t value)
+{
+    buffer.push_back(uint8_t(value));
+    buffer.push_back(uint8_t(value >> 8));
+}
+
+static void AppendU32(std::vector<uint8_t>& buffer, uint32_t value)
+{
+    AppendU16(buffer, value);
+    AppendU16(buffer, value >> 16);
+}
+
+static void AppendU32BE(std::vector<uint8_t>& buffer, uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8)
+        buffer.push_back(uint8_t(value >> shift));
+}
+
+static bool WriteAll(int fd, const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    while (size > 0)
+    {
+        const ssize_t written = write(fd, bytes, size < MAX_WRITE_SIZE ? size : MAX_WRITE_SIZE);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return false;
+        }
+
+        bytes += written;
+        size -= size_t(written);
+    }
+
+    return true;
+}
+
+// Pieces of output file, they point either into the mapping or to buffer of conversion
+static bool WriteFile(const std::string& path, const std::vector<std::pair<const void*, size_t>>& pieces)
+{
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd == -1)
+    {
+        fprintf(stderr, "Cannot create %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    bool result = true;
+
+    for (const auto& piece : pieces)
+        result = result && WriteAll(fd, piece.first, piece.second);
+
+    if (close(fd) != 0 || !result)
+    {
+        fprintf(stderr, "Cannot write %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+static std::string LumpName(const uint8_t* entry)
+{
+    std::string name;
+
+    for (size_t i = 8; i < DIRECTORY_ENTRY_SIZE && entry[i] != '\0'; ++i)
+    {
+        const char ch = char(entry[i]);
+        name += ch >= 'A' && ch <= 'Z' ? char(ch - 'A' + 'a') : ch;
+    }
+
+    return name;
+}
+
+static bool IsMapLump(const std::string& name)
+{
+    static const char* const NAMES[] =
+    {
+        "things", "linedefs", "sidedefs", "vertexes", "segs", "ssectors", "nodes", "sectors", "reject", "blockmap",
+        "behavior", "scripts", "leafs", "lights", "macros", "textmap", "znodes", "dialogue", "endmap",
+    };
+
+    for (const char* map_name : NAMES)
+        if (name == map_name)
+            return true;
+
+    // Nodes built by glBSP
+    return name.compare(0, 3, "gl_") == 0;
+}
+
+// Namespace subdirectory of marker, empty string for ending marker, nullptr for lumps that aren't markers
+static const char* MarkerNamespace(const std::string& name)
+{
+    static const std::pair<const char*, const char*> MARKERS[] =
+    {
+        { "s", "sprites" }, { "ss", "sprites" }, { "f", "flats" }, { "ff", "flats" },
+        { "p", "patches" }, { "pp", "patches" }, { "p1", "patches" }, { "p2", "patches" }, { "p3", "patches" },
+        { "f1", "flats" }, { "f2", "flats" }, { "f3", "flats" }, { "tx", "textures" }, { "c", "colormaps" },
+        { "a", "acs" }, { "v", "voxels" }, { "hi", "hires" },
+    };
+
+    const size_t separator = name.find('_');
+
+    if (separator == std::string::npos)
+        return nullptr;
+
+    const std::string prefix = name.substr(0, separator);
+    const std::string suffix = name.substr(separator + 1);
+
+    if (suffix != "start" && suffix != "end")
+        return nullptr;
+
+    for (const auto& marker : MARKERS)
+        if (prefix == marker.first)
+            return suffix == "start" ? marker.second : "";
+
+    return nullptr;
+}
+
+static bool IsPicture(const uint8_t* data, size_t size)
+{
+    if (size < 8)
+        return false;
+
+    const int width = ReadU16(data);
+    const int height = ReadU16(data + 2);
+
+    if (width == 0 || height == 0 || width > MAX_PICTURE_SIZE || height > MAX_PICTURE_SIZE
+        || size < 8 + size_t(width) * 4)
+        return false;
+
+    for (int x = 0; x < width; ++x)
+    {
+        size_t offset = ReadU32(data + 8 + x * 4);
+
+        while (true)
+        {
+            if (offset >= size)
+                return false;
+
+            if (data[offset] == 0xFF)
+                break;
+
+            if (offset + 4 > size || offset + 4 + data[offset + 1] > size)
+                return false;
+
+            offset += 4 + data[offset + 1];
+        }
+    }
+
+    return true;
+}
+
+static int FlatSide(size_t size)
+{
+    for (int side : { 64, 128, 256, 512, 1024 })
+        if (size == size_t(side) * side)
+            return side;
+
+    return 0;
+}
+
+static bool IsDmxSound(const uint8_t* data, size_t size)
+{
+    return size >= 8 && ReadU16(data) == 3 && ReadU32(data + 4) <= size - 8 && ReadU32(data + 4) > 32;
+}
+
+static const char* Extension(const uint8_t* data, size_t size)
+{
+    static const std::pair<const char*, const char*> SIGNATURES[] =
+    {
+        { "MUS\x1a", ".mus" }, { "MThd", ".mid" }, { "OggS", ".ogg" }, { "fLaC", ".flac" }, { "RIFF", ".wav" },
+        { "\x89PNG", ".png" }, { "IMPM", ".it" }, { "Extended Module: ", ".xm" }, { "ID3", ".mp3" },
+    };
+
+    for (const auto& signature : SIGNATURES)
+    {
+        const size_t length = strlen(signature.first);
+
+        if (size >= length && memcmp(data, signature.first, length) == 0)
+            return signature.second;
+    }
+
+    return ".lmp";
+}
+
+static void AppendChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data)
+{
+    AppendU32BE(png, uint32_t(data.size()));
+
+    const size_t start = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data.begin(), data.end());
+
+    AppendU32BE(png, uint32_t(crc32(crc32(0, nullptr, 0), &png[start], uInt(png.size() - start))));
+}
+
+// Scanlines are unfiltered, Doom graphics are small, and filters gain little on paletted images
+static std::vector<uint8_t> EncodePNG(int width, int height, int color_type, const std::vector<uint8_t>& pixels,
+    const uint8_t* palette, const int* offsets)
+{
+    const size_t stride = size_t(width) * (color_type == 6 ? 4 : 1);
+    std::vector<uint8_t> scanlines;
+    scanlines.reserve((stride + 1) * height);
+
+    for (int y = 0; y < height; ++y)
+    {
+        scanlines.push_back(0);
+        scanlines.insert(scanlines.end(), &pixels[y * stride], &pixels[y * stride] + stride);
+    }
+
+    uLongf compressed_size = compressBound(uLong(scanlines.size()));
+    std::vector<uint8_t> compressed(compressed_size);
+
+    if (compress2(compressed.data(), &compressed_size, scanlines.data(), uLong(scanlines.size()), 9) != Z_OK)
+        return {};
+
+    compressed.resize(compressed_size);
+
+    std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    std::vector<uint8_t> header;
+    AppendU32BE(header, uint32_t(width));
+    AppendU32BE(header, uint32_t(height));
+    header.insert(header.end(), { 8, uint8_t(color_type), 0, 0, 0 });
+    AppendChunk(png, "IHDR", header);
+
+    if (offsets)
+    {
+        std::vector<uint8_t> grab;
+        AppendU32BE(grab, uint32_t(offsets[0]));
+        AppendU32BE(grab, uint32_t(offsets[1]));
+        AppendChunk(png, "grAb", grab);
+    }
+
+    if (color_type == 3)
+        AppendChunk(png, "PLTE", std::vector<uint8_t>(palette, palette + PALETTE_SIZE));
+
+    AppendChunk(png, "IDAT", compressed);
+    AppendChunk(png, "IEND", {});
+
+    return png;
+}
+
+static std::vector<uint8_t> ConvertPicture(const Lump& lump, const uint8_t* palette)
+{
+    const uint8_t* data = lump.data;
+    const int width = ReadU16(data);
+    const int height = ReadU16(data + 2);
+    const int offsets[2] = { int16_t(ReadU16(data + 4)), int16_t(ReadU16(data + 6)) };
+
+    std::vector<uint8_t> pixels(size_t(width) * height * 4);
+
+    for (int x = 0; x < width; ++x)
+    {
+        size_t offset = ReadU32(data + 8 + x * 4);
+        int top = -1;
+
+        while (data[offset] != 0xFF)
+        {
+            const int delta = data[offset];
+            const int length = data[offset + 1];
+            top = delta <= top ? top + delta : delta;
+
+            for (int i = 0; i < length && top + i < height; ++i)
+            {
+                uint8_t* pixel = &pixels[(size_t(top + i) * width + x) * 4];
+                memcpy(pixel, &palette[data[offset + 3 + i] * 3], 3);
+                pixel[3] = 255;
+            }
+
+            offset += 4 + length;
+        }
+    }
+
+    return EncodePNG(width, height, 6, pixels, palette, offsets);
+}
+
+static std::vector<uint8_t> ConvertFlat(const Lump& lump, const uint8_t* palette)
+{
+    const int side = FlatSide(lump.size);
+    return EncodePNG(side, side, 3, std::vector<uint8_t>(lump.data, lump.data + lump.size), palette, nullptr);
+}
+
+// Padding samples of DMX format are dropped, WAV has 8-bit unsigned samples like DMX
+static std::vector<uint8_t> ConvertSound(const Lump& lump)
+{
+    const uint32_t rate = ReadU16(lump.data + 2);
+    const uint32_t count = ReadU32(lump.data + 4) - 32;
+
+    std::vector<uint8_t> wav = { 'R', 'I', 'F', 'F' };
+    AppendU32(wav, 36 + count);
+    wav.insert(wav.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+    AppendU32(wav, 16);
+    AppendU16(wav, 1);  // PCM
+    AppendU16(wav, 1);  // mono
+    AppendU32(wav, rate);
+    AppendU32(wav, rate);  // bytes per second
+    AppendU16(wav, 1);  // block align
+    AppendU16(wav, 8);  // bits per sample
+    wav.insert(wav.end(), { 'd', 'a', 't', 'a' });
+    AppendU32(wav, count);
+    wav.insert(wav.end(), lump.data + 8 + 16, lump.data + 8 + 16 + count);
+
+    return wav;
+}
+
+static bool RunTask(const Task& task, const uint8_t* palette)
+{
+    const Lump& lump = task.lumps[0];
+    std::vector<uint8_t> converted;
+
+    switch (task.conversion)
+    {
+    case Conversion::Picture:
+        converted = ConvertPicture(lump, palette);
+        break;
+
+    case Conversion::Flat:
+        converted = ConvertFlat(lump, palette);
+        break;
+
+    case Conversion::Sound:
+        converted = ConvertSound(lump);
+        break;
+
+    case Conversion::None:
+        break;
+    }
+
+    if (task.conversion != Conversion::None)
+        return !converted.empty() && WriteFile(task.path, { { converted.data(), converted.size() } });
+
+    if (task.lumps.size() == 1)
+        return WriteFile(task.path, { { lump.data, lump.size } });
+
+    // Map is PWAD with its marker and lumps, their data is written from the mapping
+    std::vector<uint8_t> header = { 'P', 'W', 'A', 'D' };
+    std::vector<uint8_t> directory;
+    uint32_t offset = HEADER_SIZE;
+
+    for (const Lump& map_lump : task.lumps)
+    {
+        AppendU32(directory, offset);
+        AppendU32(directory, uint32_t(map_lump.size));
+
+        char name[8] = {};
+
+        for (size_t i = 0; i < map_lump.name.size() && i < sizeof name; ++i)
+        {
+            const char ch = map_lump.name[i];
+            name[i] = ch >= 'a' && ch <= 'z' ? char(ch - 'a' + 'A') : ch;
+        }
+
+        directory.insert(directory.end(), name, name + sizeof name);
+        offset += uint32_t(map_lump.size);
+    }
+
+    AppendU32(header, uint32_t(task.lumps.size()));
+    AppendU32(header, offset);
+
+    std::vector<std::pair<const void*, size_t>> pieces = { { header.data(), header.size() } };
+
+    for (const Lump& map_lump : task.lumps)
+        pieces.emplace_back(map_lump.data, map_lump.size);
+
+    pieces.emplace_back(directory.data(), directory.size());
+
+    return WriteFile(task.path, pieces);
+}
+
+static bool MakeDirectory(const std::string& path)
+{
+    if (mkdir(path.c_str(), 0755) == 0 || errno == EEXIST)
+        return true;
+
+    fprintf(stderr, "Cannot create directory %s: %s\n", path.c_str(), strerror(errno));
+    return false;
+}
+
+static std::string UniquePath(std::map<std::string, int>& names, const std::string& directory,
+    const std::string& name, const char* extension)
+{
+    std::string file_name = name;
+
+    for (char& ch : file_name)
+        if (ch == '\\')
+            ch = '^';
+
+    std::string path = directory + '/' + file_name;
+    const int count = names[path + extension]++;
+
+    if (count > 0)
+        path += '_' + std::to_string(count);
+
+    return path + extension;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int jobs = std::thread::hardware_concurrency();
+    bool raw = false;
+    int argi = 1;
+
+    for (; argi < argc && argv[argi][0] == '-'; ++argi)
+    {
+        if (strcmp(argv[argi], "-raw") == 0)
+            raw = true;
+        else if (strcmp(argv[argi], "-j") == 0 && argi + 1 < argc)
+            jobs = unsigned(atoi(argv[++argi]));
+        else
+            break;
+    }
+
+    if (argi >= argc || argc - argi > 2 || jobs == 0)
+    {
+        fprintf(stderr, "Usage: %s [-j jobs] [-raw] <file.wad> [output directory]\n", argv[0]);
+        return 1;
+    }
+
+    const char* wad_path = argv[argi];
+    std::string output_path = argi + 1 < argc ? argv[argi + 1] : wad_path;
+
+    if (argi + 1 >= argc)
+    {
+        const size_t slash = output_path.rfind('/');
+        const size_t dot = output_path.rfind('.');
+
+        if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+            output_path.resize(dot);
+        else
+            output_path += ".extracted";
+    }
+
+    const int fd = open(wad_path, O_RDONLY);
+    struct stat status = {};
+
+    if (fd == -1 || fstat(fd, &status) != 0)
+    {
+        fprintf(stderr, "Cannot open %s: %s\n", wad_path, strerror(errno));
+        return 1;
+    }
+
+    const size_t file_size = size_t(status.st_size);
+    void* mapping = file_size == 0 ? MAP_FAILED : mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        fprintf(stderr, "Cannot map %s: %s\n", wad_path, strerror(errno));
+        return 1;
+    }
+
+    madvise(mapping, file_size, MADV_SEQUENTIAL);
+    madvise(mapping, file_size, MADV_WILLNEED);
+
+    const uint8_t* wad = static_cast<const uint8_t*>(mapping);
+    const size_t lump_count = file_size >= HEADER_SIZE ? ReadU32(wad + 4) : 0;
+    const size_t directory_offset = file_size >= HEADER_SIZE ? ReadU32(wad + 8) : 0;
+
+    if (file_size < HEADER_SIZE || (memcmp(wad, "IWAD", 4) != 0 && memcmp(wad, "PWAD", 4) != 0)
+        || directory_offset > file_size || lump_count > (file_size - directory_offset) / DIRECTORY_ENTRY_SIZE)
+    {
+        fprintf(stderr, "%s is not a WAD file\n", wad_path);
+        return 1;
+    }
+
+    std::vector<Lump> lumps;
+    const uint8_t* palette = nullptr;
+
+    for (size_t i = 0; i < lump_count; ++i)
+    {
+        const uint8_t* entry = wad + directory_offset + i * DIRECTORY_ENTRY_SIZE;
+        const size_t offset = ReadU32(entry);
+        const size_t size = ReadU32(entry + 4);
+
+        if (offset > file_size || size > file_size - offset)
+        {
+            fprintf(stderr, "Lump %zu of %s is out of file bounds\n", i, wad_path);
+            return 1;
+        }
+
+        lumps.push_back({ wad + offset, size, LumpName(entry) });
+
+        if (!palette && lumps.back().name == "playpal" && size >= PALETTE_SIZE)
+            palette = wad + offset;
+    }
+
+    // Conversions need palette, without it lumps are written as is
+    raw = raw || !palette;
+
+    if (!MakeDirectory(output_path))
+        return 1;
+
+    std::vector<Task> tasks;
+    std::map<std::string, int> names;
+    std::set<std::string> directories;
+    std::string current_namespace;
+
+    for (size_t i = 0; i < lumps.size(); ++i)
+    {
+        const Lump& lump = lumps[i];
+
+        if (const char* marker = MarkerNamespace(lump.name))
+        {
+            current_namespace = marker;
+            continue;
+        }
+
+        const std::string directory = current_namespace.empty() ? output_path : output_path + '/' + current_namespace;
+
+        // Map marker is followed by map lumps, UDMF map ends with ENDMAP
+        if (current_namespace.empty() && i + 1 < lumps.size() && !IsMapLump(lump.name) && IsMapLump(lumps[i + 1].name))
+        {
+            Task task = { UniquePath(names, output_path + "/maps", lump.name, ".wad"), Conversion::None, { lump } };
+            const bool udmf = lumps[i + 1].name == "textmap";
+
+            while (i + 1 < lumps.size() && IsMapLump(lumps[i + 1].name))
+            {
+                task.lumps.push_back(lumps[++i]);
+
+                if (udmf && task.lumps.back().name == "endmap")
+                    break;
+            }
+
+            directories.insert(output_path + "/maps");
+            tasks.push_back(std::move(task));
+            continue;
+        }
+
+        Conversion conversion = Conversion::None;
+        std::string task_directory = directory;
+        const char* extension = Extension(lump.data, lump.size);
+
+        if (current_namespace == "flats" && !raw && FlatSide(lump.size) != 0)
+            conversion = Conversion::Flat;
+        else if ((current_namespace == "sprites" || current_namespace == "patches" || current_namespace.empty())
+            && strcmp(extension, ".lmp") == 0 && IsPicture(lump.data, lump.size))
+        {
+            conversion = raw ? Conversion::None : Conversion::Picture;
+
+            if (current_namespace.empty())
+                task_directory = output_path + "/graphics";
+        }
+        else if (current_namespace.empty() && strcmp(extension, ".lmp") == 0 && IsDmxSound(lump.data, lump.size))
+        {
+            conversion = raw ? Conversion::None : Conversion::Sound;
+            task_directory = output_path + "/sounds";
+        }
+        else if (current_namespace.empty() && strcmp(extension, ".lmp") != 0)
+        {
+            const bool music = strcmp(extension, ".mus") == 0 || strcmp(extension, ".mid") == 0
+                || strcmp(extension, ".it") == 0 || strcmp(extension, ".xm") == 0;
+            task_directory = output_path + (music ? "/music" : "/sounds");
+
+            if (strcmp(extension, ".png") == 0)
+                task_directory = output_path + "/graphics";
+        }
+
+        if (conversion == Conversion::Sound)
+            extension = ".wav";
+        else if (conversion != Conversion::None)
+            extension = ".png";
+
+        directories.insert(task_directory);
+        tasks.push_back({ UniquePath(names, task_directory, lump.name, extension), conversion, { lump } });
+    }
+
+    for (const std::string& directory : directories)
+        if (!MakeDirectory(directory))
+            return 1;
+
+    std::atomic<size_t> next_task(0);
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> workers;
+
+    for (unsigned int i = 0; i < jobs && i < tasks.size(); ++i)
+    {
+        workers.emplace_back([&]()
+        {
+            for (size_t task = next_task++; task < tasks.size(); task = next_task++)
+                if (!RunTask(tasks[task], palette))
+                    failed = true;
+        });
+    }
+
+    for (std::thread& worker : workers)
+        worker.join();
+
+    munmap(mapping, file_size);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,832 @@
+#include <dlfcn.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mach/mach_time.h>
+#include <mach-o/dyld.h>
+#include <malloc/malloc.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/sysctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Benchmark harness, it's force-included after aedi.h, so benchmarks can use AEDI_EXPECT too
+//
+// AEDI_BENCH(name, unit, amount) { ... } runs its body for warm-up and then for measured repetitions
+// Amount is work done by one repetition in the given unit, i.e. bytes, samples, frames, pixels or operations
+// Results are printed to stdout as JSON objects, one per line
+// AEDI_BENCH_WARMUP and AEDI_BENCH_REPETITIONS environment variables override default repetition counts
+// AEDI_BENCH_COUNTERS=1 samples hardware performance counters of the benchmark thread, this requires root
+// AEDI_BENCH_ALLOCATIONS=1 counts heap allocations of all threads during measured repetitions, this adds to times
+
+// Benchmarks check results in helper functions and lambdas too, so failed expectation exits instead of returning
+#undef AEDI_EXPECT
+#define AEDI_EXPECT(CODE) if (!(CODE)) { puts(#CODE); exit(1); }
+
+namespace aedi
+{
+
+enum class Unit
+{
+    Bytes,       // MB/s
+    Samples,     // samples/s
+    Frames,      // frames/s
+    Pixels,      // MP/s
+    Operations,  // ops/s
+};
+
+inline int EnvironmentValue(const char* name, int fallback)
+{
+    const char* value = getenv(name);
+    return value == nullptr ? fallback : atoi(value);
+}
+
+inline std::string Format(const char* format, ...)
+{
+    char buffer[1024];
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof buffer, format, args);
+    va_end(args);
+
+    return buffer;
+}
+
+inline void PrintString(const char* value)
+{
+    putchar('"');
+
+    for (const char* ch = value; *ch != '\0'; ++ch)
+    {
+        if (*ch == '"' || *ch == '\\')
+            putchar('\\');
+
+        putchar(*ch);
+    }
+
+    putchar('"');
+}
+
+// Reports additional information about benchmarked library, e.g. detected SIMD paths
+inline void Info(const char* key, const char* format, ...)
+{
+    char buffer[1024];
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof buffer, format, args);
+    va_end(args);
+
+    printf("{\"info\": ");
+    PrintString(key);
+    printf(", \"value\": ");
+    PrintString(buffer);
+    printf("}\n");
+}
+
+// Reports SIMD extensions supported by CPU that runs the current architecture slice
+inline void PrintCpuFeatures()
+{
+    std::string features;
+
+#if defined(__aarch64__)
+    static const char* const FEATURES[] =
+    {
+        "hw.optional.neon",
+        "hw.optional.armv8_crc32",
+        "hw.optional.arm.FEAT_PMULL",
+        "hw.optional.arm.FEAT_DotProd",
+        "hw.optional.arm.FEAT_FP16",
+    };
+
+    features = "arm64:";
+
+    for (const char* feature : FEATURES)
+    {
+        int value = 0;
+        size_t size = sizeof value;
+
+        if (sysctlbyname(feature, &value, &size, nullptr, 0) == 0 && value != 0)
+            features += std::string(" ") + (strrchr(feature, '.') + 1);
+    }
+#elif defined(__x86_64__)
+    features = "x86_64:";
+
+    if (__builtin_cpu_supports("sse4.1"))
+        features += " sse4.1";
+    if (__builtin_cpu_supports("sse4.2"))
+        features += " sse4.2";
+    if (__builtin_cpu_supports("pclmul"))
+        features += " pclmul";
+    if (__builtin_cpu_supports("avx"))
+        features += " avx";
+    if (__builtin_cpu_supports("avx2"))
+        features += " avx2";
+    if (__builtin_cpu_supports("avx512f"))
+        features += " avx512f";
+#endif
+
+    Info("cpu_features", "%s", features.c_str());
+}
+
+// Returns names of symbols of the current architecture slice of the given executable, e.g. to check what SIMD code
+// was linked in when library has no runtime query for it
+inline std::vector<std::string> LinkedSymbols(const char* path)
+{
+#if defined(__aarch64__)
+    const char* const arch = "arm64";
+#elif defined(__x86_64__)
+    const char* const arch = "x86_64";
+#endif
+
+    const std::string command = Format("nm -j -arch %s '%s'", arch, path);
+    std::vector<std::string> symbols;
+
+    if (FILE* output = popen(command.c_str(), "r"))
+    {
+        char line[4096];
+
+        while (fgets(line, sizeof line, output) != nullptr)
+        {
+            line[strcspn(line, "\r\n")] = '\0';
+            symbols.emplace_back(line);
+        }
+
+        pclose(output);
+    }
+
+    return symbols;
+}
+
+struct Symbol
+{
+    uintptr_t address;  // relocated, i.e. as seen by the running executable
+    std::string name;
+};
+
+// Defined symbols of the running executable for its architecture, sorted by address
+inline std::vector<Symbol> DefinedSymbols(const char* path)
+{
+#if defined(__aarch64__)
+    const char* const arch = "arm64";
+#elif defined(__x86_64__)
+    const char* const arch = "x86_64";
+#endif
+
+    const std::string command = Format("nm -n -arch %s '%s'", arch, path);
+    const uintptr_t slide = uintptr_t(_dyld_get_image_vmaddr_slide(0));
+    std::vector<Symbol> symbols;
+
+    if (FILE* output = popen(command.c_str(), "r"))
+    {
+        char line[4096];
+
+        while (fgets(line, sizeof line, output) != nullptr)
+        {
+            unsigned long long address = 0;
+            char type = '\0';
+            char name[4096];
+
+            // Undefined symbols have no address, so they don't match
+            if (sscanf(line, "%llx %c %4095s", &address, &type, name) == 3)
+                symbols.push_back({ uintptr_t(address) + slide, name });
+        }
+
+        pclose(output);
+    }
+
+    return symbols;
+}
+
+// Name of defined symbol at exactly the given address, or empty string
+inline std::string SymbolName(const std::vector<Symbol>& symbols, const void* address)
+{
+    for (const Symbol& symbol : symbols)
+    {
+        if (symbol.address == uintptr_t(address))
+            return symbol.name;
+    }
+
+    return {};
+}
+
+// Keeps compiler from optimizing away computation of the given value
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Converts difference of mach_absolute_time() values, it's negative when the second time was earlier
+inline double TicksToNanoseconds(int64_t ticks)
+{
+    static mach_timebase_info_data_t timebase;
+
+    if (timebase.denom == 0)
+        mach_timebase_info(&timebase);
+
+    return double(ticks) * timebase.numer / timebase.denom;
+}
+
+// Hardware performance counters of the current thread via private kperf and kperfdata frameworks
+// Events are looked up by names from CPU-specific database, the first known name of every counter is used
+// Counters that the running CPU doesn't have, or all of them when not running as root, are reported as missing
+class Counters
+{
+public:
+    enum Index
+    {
+        Cycles,
+        Instructions,
+        L1DMisses,
+        L2Misses,
+        BranchMisses,
+        Count
+    };
+
+    static const char* Name(int index)
+    {
+        static const char* const NAMES[] = { "cycles", "instructions", "l1d_misses", "l2_misses", "branch_misses" };
+        return NAMES[index];
+    }
+
+    // Returns nullptr unless counters were requested and successfully configured
+    static const Counters* Instance()
+    {
+        static Counters* const instance = Create();
+        return instance;
+    }
+
+    bool Has(int index) const
+    {
+        return m_map[index] != UNMAPPED;
+    }
+
+    void Read(uint64_t values[Count]) const
+    {
+        uint64_t counters[MAX_COUNTERS] = {};
+        m_get_thread_counters(0, MAX_COUNTERS, counters);
+
+        for (int i = 0; i < Count; ++i)
+            values[i] = Has(i) ? counters[m_map[i]] : 0;
+    }
+
+private:
+    static constexpr size_t MAX_COUNTERS = 32;
+    static constexpr size_t UNMAPPED = ~size_t(0);
+
+    using GetThreadCounters = int (*)(uint32_t, uint32_t, uint64_t*);
+
+    GetThreadCounters m_get_thread_counters = nullptr;
+    size_t m_map[Count] = { UNMAPPED, UNMAPPED, UNMAPPED, UNMAPPED, UNMAPPED };
+
+    static Counters* Create()
+    {
+        if (EnvironmentValue("AEDI_BENCH_COUNTERS", 0) == 0)
+            return nullptr;
+
+        Counters* counters = new Counters;
+        const char* const error = counters->Configure();
+
+        if (error == nullptr)
+        {
+            std::string names;
+
+            for (int i = 0; i < Count; ++i)
+                names += counters->Has(i) ? (names.empty() ? "" : " ") + std::string(Name(i)) : "";
+
+            Info("counters", "%s", names.c_str());
+            return counters;
+        }
+
+        Info("counters", "unavailable, %s", error);
+        delete counters;
+        return nullptr;
+    }
+
+    // Returns error description, or nullptr on success
+    const char* Configure()
+    {
+        void* const kperf = dlopen("/System/Library/PrivateFrameworks/kperf.framework/kperf", RTLD_LAZY);
+        void* const kperfdata = dlopen("/System/Library/PrivateFrameworks/kperfdata.framework/kperfdata", RTLD_LAZY);
+
+        if (kperf == nullptr || kperfdata == nullptr)
+            return "cannot load kperf frameworks";
+
+        const auto kpc_force_all_ctrs_set = reinterpret_cast<int (*)(int)>(dlsym(kperf, "kpc_force_all_ctrs_set"));
+        const auto kpc_set_config = reinterpret_cast<int (*)(uint32_t, uint64_t*)>(dlsym(kperf, "kpc_set_config"));
+        const auto kpc_set_counting = reinterpret_cast<int (*)(uint32_t)>(dlsym(kperf, "kpc_set_counting"));
+        const auto kpc_set_thread_counting = reinterpret_cast<int (*)(uint32_t)>(dlsym(kperf, "kpc_set_thread_counting"));
+        m_get_thread_counters = reinterpret_cast<GetThreadCounters>(dlsym(kperf, "kpc_get_thread_counters"));
+
+        // Database, configuration and event types are opaque, configuration is built from events and turned into
+        // register values with mapping of events to counter indices
+        const auto kpep_db_create = reinterpret_cast<int (*)(const char*, void**)>(dlsym(kperfdata, "kpep_db_create"));
+        const auto kpep_db_event = reinterpret_cast<int (*)(void*, const char*, void**)>(dlsym(kperfdata, "kpep_db_event"));
+        const auto kpep_config_create = reinterpret_cast<int (*)(void*, void**)>(dlsym(kperfdata, "kpep_config_create"));
+        const auto kpep_config_force_counters = reinterpret_cast<int (*)(void*)>(dlsym(kperfdata, "kpep_config_force_counters"));
+        const auto kpep_config_add_event = reinterpret_cast<int (*)(void*, void**, uint32_t, uint32_t*)>(
+            dlsym(kperfdata, "kpep_config_add_event"));
+        const auto kpep_config_kpc = reinterpret_cast<int (*)(void*, uint64_t*, size_t)>(dlsym(kperfdata, "kpep_config_kpc"));
+        const auto kpep_config_kpc_classes = reinterpret_cast<int (*)(void*, uint32_t*)>(
+            dlsym(kperfdata, "kpep_config_kpc_classes"));
+        const auto kpep_config_kpc_map = reinterpret_cast<int (*)(void*, size_t*, size_t)>(
+            dlsym(kperfdata, "kpep_config_kpc_map"));
+
+        if (kpc_force_all_ctrs_set == nullptr || kpc_set_config == nullptr || kpc_set_counting == nullptr
+            || kpc_set_thread_counting == nullptr || m_get_thread_counters == nullptr || kpep_db_create == nullptr
+            || kpep_db_event == nullptr || kpep_config_create == nullptr || kpep_config_force_counters == nullptr
+            || kpep_config_add_event == nullptr || kpep_config_kpc == nullptr || kpep_config_kpc_classes == nullptr
+            || kpep_config_kpc_map == nullptr)
+            return "missing kperf functions";
+
+        void* database = nullptr;
+        void* config = nullptr;
+
+        if (kpep_db_create(nullptr, &database) != 0 || kpep_config_create(database, &config) != 0)
+            return "no event database for this CPU";
+
+        if (kpep_config_force_counters(config) != 0)
+            return "cannot use all counters";
+
+        // Apple Silicon names first, then Intel ones
+        static const char* const EVENTS[Count][4] =
+        {
+            { "FIXED_CYCLES", "CPU_CLK_UNHALTED.THREAD", "CPU_CLK_UNHALTED.CORE" },
+            { "FIXED_INSTRUCTIONS", "INST_RETIRED.ANY" },
+            { "L1D_CACHE_MISS_LD_NONSPEC", "L1D_CACHE_MISS_LD", "MEM_LOAD_RETIRED.L1_MISS", "L1D.REPLACEMENT" },
+            { "MEM_LOAD_RETIRED.L2_MISS", "L2_RQSTS.MISS" },
+            { "BRANCH_MISPRED_NONSPEC", "BRANCH_MISPREDICT", "BR_MISP_RETIRED.ALL_BRANCHES" },
+        };
+
+        int added[Count];
+        int added_count = 0;
+
+        for (int i = 0; i < Count; ++i)
+        {
+            for (const char* name : EVENTS[i])
+            {
+                void* event = nullptr;
+
+                if (name != nullptr && kpep_db_event(database, name, &event) == 0
+                    && kpep_config_add_event(config, &event, 0, nullptr) == 0)
+                {
+                    added[added_count++] = i;
+                    break;
+                }
+            }
+        }
+
+        uint32_t classes = 0;
+        size_t map[MAX_COUNTERS] = {};
+        uint64_t registers[MAX_COUNTERS] = {};
+
+        if (added_count == 0 || kpep_config_kpc_classes(config, &classes) != 0
+            || kpep_config_kpc_map(config, map, sizeof map) != 0
+            || kpep_config_kpc(config, registers, sizeof registers) != 0)
+            return "cannot configure events";
+
+        // Only root can take counters, and set their configuration
+        if (kpc_force_all_ctrs_set(1) != 0)
+            return "requires root";
+
+        constexpr uint32_t KPC_CLASS_CONFIGURABLE_MASK = 1u << 1;
+
+        if (((classes & KPC_CLASS_CONFIGURABLE_MASK) != 0 && kpc_set_config(classes, registers) != 0)
+            || kpc_set_counting(classes) != 0 || kpc_set_thread_counting(classes) != 0)
+            return "cannot start counting";
+
+        for (int i = 0; i < added_count; ++i)
+            m_map[added[i]] = map[i];
+
+        return nullptr;
+    }
+};
+
+// Heap allocations via functions of the default malloc zone, which are replaced with counting ones
+// Counting is active only during measured repetitions, peak is the largest growth of heap within one repetition
+// Batch and pressure relief functions aren't replaced, nothing among benchmarked libraries uses them
+class Allocations
+{
+public:
+    struct Totals
+    {
+        uint64_t count;
+        uint64_t bytes;
+        int64_t peak;
+    };
+
+    // Returns nullptr unless allocation counting was requested and zone functions were replaced
+    static Allocations* Instance()
+    {
+        static Allocations* const instance = Create();
+        return instance;
+    }
+
+    void Start()
+    {
+        m_count.store(0, std::memory_order_relaxed);
+        m_bytes.store(0, std::memory_order_relaxed);
+        m_current.store(0, std::memory_order_relaxed);
+        m_peak.store(0, std::memory_order_relaxed);
+        m_active.store(true, std::memory_order_release);
+    }
+
+    Totals Stop()
+    {
+        m_active.store(false, std::memory_order_release);
+        return { m_count.load(), m_bytes.load(), m_peak.load() };
+    }
+
+    // Maximum resident set size of the process so far, in bytes
+    static uint64_t PeakResidentSize()
+    {
+        rusage usage = {};
+        getrusage(RUSAGE_SELF, &usage);
+        return uint64_t(usage.ru_maxrss);
+    }
+
+private:
+    malloc_zone_t m_original = {};
+    std::atomic<bool> m_active{ false };
+    std::atomic<uint64_t> m_count{ 0 };
+    std::atomic<uint64_t> m_bytes{ 0 };
+    std::atomic<int64_t> m_current{ 0 };
+    std::atomic<int64_t> m_peak{ 0 };
+
+    static Allocations* Create()
+    {
+        if (EnvironmentValue("AEDI_BENCH_ALLOCATIONS", 0) == 0)
+            return nullptr;
+
+        // Replaced functions refer to this instance, so it's kept even if counting turns out to be unusable
+        Allocations* allocations = new Allocations;
+
+        if (!allocations->Replace())
+        {
+            Info("allocations", "unavailable, %s", "unsupported default zone");
+            return nullptr;
+        }
+
+        allocations->Start();
+        void* volatile block = malloc(64);
+        free(block);
+
+        if (allocations->Stop().count != 1)
+        {
+            Info("allocations", "unavailable, %s", "malloc bypasses default zone");
+            return nullptr;
+        }
+
+        Info("allocations", "%s", "default zone");
+        return allocations;
+    }
+
+    // Zone structure is read-only since version 8, it's made writable while its function pointers are replaced
+    bool Replace()
+    {
+        malloc_zone_t* const zone = malloc_default_zone();
+
+        if (zone == nullptr || zone->version < 6)
+            return false;
+
+        const uintptr_t page_size = uintptr_t(getpagesize());
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(zone) & ~(page_size - 1);
+        const uintptr_t end = (reinterpret_cast<uintptr_t>(zone + 1) + page_size - 1) & ~(page_size - 1);
+        void* const pages = reinterpret_cast<void*>(begin);
+
+        if (mprotect(pages, end - begin, PROT_READ | PROT_WRITE) != 0)
+            return false;
+
+        m_original = *zone;
+        Current() = this;
+
+        zone->malloc = Malloc;
+        zone->calloc = Calloc;
+        zone->valloc = Valloc;
+        zone->free = Free;
+        zone->realloc = Realloc;
+        zone->memalign = Memalign;
+        zone->free_definite_size = FreeDefiniteSize;
+
+        if (zone->version >= 8)
+            mprotect(pages, end - begin, PROT_READ);
+
+        return true;
+    }
+
+    // Zero-initialized pointer, unlike Instance() it's usable while the instance is being created
+    static Allocations*& Current()
+    {
+        static Allocations* current;
+        return current;
+    }
+
+    static Allocations& Self()
+    {
+        return *Current();
+    }
+
+    void Allocated(malloc_zone_t* zone, void* pointer, size_t requested)
+    {
+        if (pointer == nullptr || !m_active.load(std::memory_order_acquire))
+            return;
+
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_bytes.fetch_add(requested, std::memory_order_relaxed);
+        Grow(int64_t(m_original.size(zone, pointer)));
+    }
+
+    void Freeing(malloc_zone_t* zone, void* pointer)
+    {
+        if (pointer != nullptr && m_active.load(std::memory_order_acquire))
+            Grow(-int64_t(m_original.size(zone, pointer)));
+    }
+
+    void Grow(int64_t size)
+    {
+        const int64_t current = m_current.fetch_add(size, std::memory_order_relaxed) + size;
+        int64_t peak = m_peak.load(std::memory_order_relaxed);
+
+        while (current > peak && !m_peak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    static void* Malloc(malloc_zone_t* zone, size_t size)
+    {
+        void* const pointer = Self().m_original.malloc(zone, size);
+        Self().Allocated(zone, pointer, size);
+        return pointer;
+    }
+
+    static void* Calloc(malloc_zone_t* zone, size_t count, size_t size)
+    {
+        void* const pointer = Self().m_original.calloc(zone, count, size);
+        Self().Allocated(zone, pointer, count * size);
+        return pointer;
+    }
+
+    static void* Valloc(malloc_zone_t* zone, size_t size)
+    {
+        void* const pointer = Self().m_original.valloc(zone, size);
+        Self().Allocated(zone, pointer, size);
+        return pointer;
+    }
+
+    static void* Memalign(malloc_zone_t* zone, size_t alignment, size_t size)
+    {
+        void* const pointer = Self().m_original.memalign(zone, alignment, size);
+        Self().Allocated(zone, pointer, size);
+        return pointer;
+    }
+
+    // Reallocation counts as allocation of the new block, even when the old one was resized in place
+    static void* Realloc(malloc_zone_t* zone, void* pointer, size_t size)
+    {
+        Self().Freeing(zone, pointer);
+
+        void* const reallocated = Self().m_original.realloc(zone, pointer, size);
+        Self().Allocated(zone, reallocated, size);
+        return reallocated;
+    }
+
+    static void Free(malloc_zone_t* zone, void* pointer)
+    {
+        Self().Freeing(zone, pointer);
+        Self().m_original.free(zone, pointer);
+    }
+
+    static void FreeDefiniteSize(malloc_zone_t* zone, void* pointer, size_t size)
+    {
+        Self().Freeing(zone, pointer);
+        Self().m_original.free_definite_size(zone, pointer, size);
+    }
+};
+
+class Bench
+{
+public:
+    // Zero repetitions means the default count, explicit count is used when each repetition processes a part of
+    // input, e.g. one audio frame, so the number of repetitions is defined by the input
+    Bench(const std::string& name, Unit unit, double amount, int repetitions = 0)
+    : m_name(name)
+    , m_unit(unit)
+    , m_amount(amount)
+    , m_warmup(EnvironmentValue("AEDI_BENCH_WARMUP", 3))
+    , m_repetitions(repetitions > 0 ? repetitions : std::max(EnvironmentValue("AEDI_BENCH_REPETITIONS", 25), 1))
+    , m_counters(Counters::Instance())
+    , m_allocations(Allocations::Instance())
+    {
+        m_times.reserve(m_repetitions);
+    }
+
+    ~Bench()
+    {
+        Report();
+    }
+
+    Bench(const Bench&) = delete;
+    Bench& operator=(const Bench&) = delete;
+
+    // Returns true while repetitions should continue, time of the previous repetition is recorded here
+    bool Next()
+    {
+        const uint64_t now = mach_absolute_time();
+
+        if (m_allocations != nullptr && m_iteration > m_warmup)
+            AccumulateAllocations(m_allocations->Stop());
+
+        // Counters are read outside of timed interval, so reading them doesn't affect times
+        if (m_counters != nullptr)
+            AccumulateCounters(m_iteration > m_warmup);
+
+        if (m_iteration > m_warmup)
+            m_times.push_back(now - m_start);
+
+        if (m_iteration >= m_warmup + m_repetitions)
+            return false;
+
+        ++m_iteration;
+
+        if (m_counters != nullptr)
+            m_counters->Read(m_counter_start);
+
+        if (m_allocations != nullptr && m_iteration > m_warmup)
+            m_allocations->Start();
+
+        m_start = mach_absolute_time();
+        return true;
+    }
+
+    // Adds repetition measured elsewhere, e.g. in a child process, Next() isn't used in this case
+    void AddTime(uint64_t ticks)
+    {
+        m_times.push_back(ticks);
+    }
+
+    // Time of all measured repetitions, e.g. to calculate real-time factor of the whole input
+    double TotalNanoseconds() const
+    {
+        uint64_t total = 0;
+
+        for (uint64_t time : m_times)
+            total += time;
+
+        return TicksToNanoseconds(total);
+    }
+
+private:
+    std::string m_name;
+    Unit m_unit;
+    double m_amount;
+    int m_warmup;
+    int m_repetitions;
+    int m_iteration = 0;
+    uint64_t m_start = 0;
+    std::vector<uint64_t> m_times;
+
+    const Counters* m_counters;
+    uint64_t m_counter_start[Counters::Count] = {};
+    uint64_t m_counter_totals[Counters::Count] = {};
+    int m_counted = 0;
+
+    Allocations* m_allocations;
+    Allocations::Totals m_allocation_totals = {};
+    int m_allocated = 0;
+
+    void AccumulateCounters(bool measured)
+    {
+        uint64_t values[Counters::Count];
+        m_counters->Read(values);
+
+        if (!measured)
+            return;
+
+        for (int i = 0; i < Counters::Count; ++i)
+            m_counter_totals[i] += values[i] - m_counter_start[i];
+
+        ++m_counted;
+    }
+
+    void AccumulateAllocations(const Allocations::Totals& totals)
+    {
+        m_allocation_totals.count += totals.count;
+        m_allocation_totals.bytes += totals.bytes;
+        m_allocation_totals.peak = std::max(m_allocation_totals.peak, totals.peak);
+        ++m_allocated;
+    }
+
+    // Per-repetition averages of count and bytes, so zero means no allocations in steady state
+    void ReportAllocations() const
+    {
+        if (m_allocated == 0)
+            return;
+
+        printf(", \"allocations\": {\"count\": %.1f, \"bytes\": %.0f, \"peak_bytes\": %lld, \"peak_rss\": %llu}",
+            double(m_allocation_totals.count) / m_allocated, double(m_allocation_totals.bytes) / m_allocated,
+            static_cast<long long>(m_allocation_totals.peak),
+            static_cast<unsigned long long>(Allocations::PeakResidentSize()));
+    }
+
+    // Per-repetition averages, instructions per cycle, and misses per unit of amount, e.g. L1D misses per byte
+    void ReportCounters(const char* item) const
+    {
+        if (m_counted == 0)
+            return;
+
+        printf(", \"counters\": {");
+
+        const char* separator = "";
+
+        for (int i = 0; i < Counters::Count; ++i)
+        {
+            if (!m_counters->Has(i))
+                continue;
+
+            printf("%s\"%s\": %.0f", separator, Counters::Name(i), double(m_counter_totals[i]) / m_counted);
+            separator = ", ";
+
+            if (i >= Counters::L1DMisses && m_amount > 0)
+                printf(", \"%s_per_%s\": %.6f", Counters::Name(i), item, m_counter_totals[i] / (m_amount * m_counted));
+        }
+
+        if (m_counters->Has(Counters::Cycles) && m_counters->Has(Counters::Instructions)
+            && m_counter_totals[Counters::Cycles] > 0)
+        {
+            printf(", \"ipc\": %.3f",
+                double(m_counter_totals[Counters::Instructions]) / m_counter_totals[Counters::Cycles]);
+        }
+
+        printf("}");
+    }
+
+    // Nearest-rank percentile of sorted times
+    double Percentile(double percent) const
+    {
+        const size_t count = m_times.size();
+        size_t rank = size_t(percent / 100.0 * count + 0.5);
+        rank = std::min(std::max(rank, size_t(1)), count);
+        return TicksToNanoseconds(m_times[rank - 1]);
+    }
+
+    void Report()
+    {
+        if (m_times.empty())
+            return;
+
+        std::sort(m_times.begin(), m_times.end());
+
+        const double median = Percentile(50);
+        const double p95 = Percentile(95);
+        const double p99 = Percentile(99);
+
+        static const struct
+        {
+            const char* name;
+            double scale;
+            const char* item;
+        }
+        UNITS[] =
+        {
+            { "MB/s", 1e6, "byte" },
+            { "samples/s", 1, "sample" },
+            { "frames/s", 1, "frame" },
+            { "MP/s", 1e6, "pixel" },
+            { "ops/s", 1, "op" },
+        };
+
+        const auto& unit = UNITS[int(m_unit)];
+        const double throughput = median > 0 ? m_amount / (median / 1e9) / unit.scale : 0;
+
+        printf("{\"name\": ");
+        PrintString(m_name.c_str());
+        printf(", \"repetitions\": %zu, \"median_ns\": %.0f, \"p95_ns\": %.0f, \"p99_ns\": %.0f, "
+            "\"throughput\": %.3f, \"unit\": \"%s\"", m_times.size(), median, p95, p99, throughput, unit.name);
+
+        if (m_counters != nullptr)
+            ReportCounters(unit.item);
+
+        if (m_allocations != nullptr)
+            ReportAllocations();
+
+        printf("}\n");
+        fflush(stdout);
+    }
+};
+
+} // namespace aedi
+
+#define AEDI_BENCH(NAME, UNIT, AMOUNT) \
+    for (aedi::Bench aedi_bench(NAME, aedi::Unit::UNIT, AMOUNT); aedi_bench.Next();)
+
+// The same as AEDI_BENCH but with the given number of repetitions, AEDI_BENCH_REPETITIONS doesn't affect it
+#define AEDI_BENCH_COUNT(NAME, UNIT, AMOUNT, COUNT) \
+    for (aedi::Bench aedi_bench(NAME, aedi::Unit::UNIT, AMOUNT, COUNT); aedi_bench.Next();)
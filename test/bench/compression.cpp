@@ -0,0 +1,384 @@
+// pkg-config: zlib bzip2 libzstd libbrotlienc libbrotlidec liblzma
+
+#define ZSTD_STATIC_LINKING_ONLY
+
+#include <bzlib.h>
+#include <lzma.h>
+#include <zlib.h>
+#include <zstd.h>
+#include <brotli/decode.h>
+#include <brotli/encode.h>
+
+#include <memory>
+
+#include "corpus.h"
+
+// Compression ratio, compression and decompression throughput, and peak working memory of archive codecs
+// All codecs process the same corpus, each item is compressed separately like an archive entry
+
+// Allocations made by codecs go through counting allocator to get their peak working memory
+static size_t MemoryCurrent;
+static size_t MemoryPeak;
+
+static void* CountingAlloc(size_t size)
+{
+    size_t* block = static_cast<size_t*>(malloc(size + sizeof(max_align_t)));
+
+    if (block == nullptr)
+        return nullptr;
+
+    *block = size;
+    MemoryCurrent += size;
+    MemoryPeak = std::max(MemoryPeak, MemoryCurrent);
+
+    return reinterpret_cast<char*>(block) + sizeof(max_align_t);
+}
+
+static void CountingFree(void* pointer)
+{
+    if (pointer == nullptr)
+        return;
+
+    size_t* block = reinterpret_cast<size_t*>(static_cast<char*>(pointer) - sizeof(max_align_t));
+    MemoryCurrent -= *block;
+    free(block);
+}
+
+class Codec
+{
+public:
+    virtual ~Codec() = default;
+
+    // Returns compressed size, or zero on failure
+    virtual size_t Compress(const std::vector<unsigned char>& input, std::vector<unsigned char>& output, int level) = 0;
+    virtual bool Decompress(const unsigned char* input, size_t size, std::vector<unsigned char>& output) = 0;
+};
+
+class ZlibCodec : public Codec
+{
+public:
+    size_t Compress(const std::vector<unsigned char>& input, std::vector<unsigned char>& output, int level) override
+    {
+        z_stream stream = {};
+        stream.zalloc = [](voidpf, uInt items, uInt size) { return CountingAlloc(size_t(items) * size); };
+        stream.zfree = [](voidpf, voidpf pointer) { CountingFree(pointer); };
+
+        if (deflateInit(&stream, level) != Z_OK)
+            return 0;
+
+        output.resize(deflateBound(&stream, uLong(input.size())));
+
+        stream.next_in = const_cast<Bytef*>(input.data());
+        stream.avail_in = uInt(input.size());
+        stream.next_out = output.data();
+        stream.avail_out = uInt(output.size());
+
+        const bool finished = deflate(&stream, Z_FINISH) == Z_STREAM_END;
+        deflateEnd(&stream);
+
+        return finished ? stream.total_out : 0;
+    }
+
+    bool Decompress(const unsigned char* input, size_t size, std::vector<unsigned char>& output) override
+    {
+        z_stream stream = {};
+        stream.zalloc = [](voidpf, uInt items, uInt size) { return CountingAlloc(size_t(items) * size); };
+        stream.zfree = [](voidpf, voidpf pointer) { CountingFree(pointer); };
+
+        if (inflateInit(&stream) != Z_OK)
+            return false;
+
+        stream.next_in = const_cast<Bytef*>(input);
+        stream.avail_in = uInt(size);
+        stream.next_out = output.data();
+        stream.avail_out = uInt(output.size());
+
+        const bool finished = inflate(&stream, Z_FINISH) == Z_STREAM_END;
+        inflateEnd(&stream);
+
+        return finished;
+    }
+};
+
+class Bzip2Codec : public Codec
+{
+public:
+    size_t Compress(const std::vector<unsigned char>& input, std::vector<unsigned char>& output, int level) override
+    {
+        bz_stream stream = {};
+        stream.bzalloc = [](void*, int items, int size) { return CountingAlloc(size_t(items) * size); };
+        stream.bzfree = [](void*, void* pointer) { CountingFree(pointer); };
+
+        if (BZ2_bzCompressInit(&stream, level, 0, 0) != BZ_OK)
+            return 0;
+
+        // Worst case expansion is 1% plus 600 bytes
+        output.resize(input.size() + input.size() / 100 + 600);
+
+        stream.next_in = reinterpret_cast<char*>(const_cast<unsigned char*>(input.data()));
+        stream.avail_in = unsigned(input.size());
+        stream.next_out = reinterpret_cast<char*>(output.data());
+        stream.avail_out = unsigned(output.size());
+
+        int result;
+        while ((result = BZ2_bzCompress(&stream, BZ_FINISH)) == BZ_FINISH_OK);
+
+        const size_t size = stream.total_out_lo32;
+        BZ2_bzCompressEnd(&stream);
+
+        return result == BZ_STREAM_END ? size : 0;
+    }
+
+    bool Decompress(const unsigned char* input, size_t size, std::vector<unsigned char>& output) override
+    {
+        bz_stream stream = {};
+        stream.bzalloc = [](void*, int items, int size) { return CountingAlloc(size_t(items) * size); };
+        stream.bzfree = [](void*, void* pointer) { CountingFree(pointer); };
+
+        if (BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK)
+            return false;
+
+        stream.next_in = reinterpret_cast<char*>(const_cast<unsigned char*>(input));
+        stream.avail_in = unsigned(size);
+        stream.next_out = reinterpret_cast<char*>(output.data());
+        stream.avail_out = unsigned(output.size());
+
+        int result;
+        while ((result = BZ2_bzDecompress(&stream)) == BZ_OK);
+
+        BZ2_bzDecompressEnd(&stream);
+        return result == BZ_STREAM_END;
+    }
+};
+
+class ZstdCodec : public Codec
+{
+public:
+    size_t Compress(const std::vector<unsigned char>& input, std::vector<unsigned char>& output, int level) override
+    {
+        ZSTD_CCtx* context = ZSTD_createCCtx_advanced(ZSTD_ALLOCATOR);
+
+        if (context == nullptr)
+            return 0;
+
+        output.resize(ZSTD_compressBound(input.size()));
+
+        const size_t size = ZSTD_compressCCtx(context, output.data(), output.size(), input.data(), input.size(), level);
+        ZSTD_freeCCtx(context);
+
+        return ZSTD_isError(size) ? 0 : size;
+    }
+
+    bool Decompress(const unsigned char* input, size_t size, std::vector<unsigned char>& output) override
+    {
+        ZSTD_DCtx* context = ZSTD_createDCtx_advanced(ZSTD_ALLOCATOR);
+
+        if (context == nullptr)
+            return false;
+
+        const size_t result = ZSTD_decompressDCtx(context, output.data(), output.size(), input, size);
+        ZSTD_freeDCtx(context);
+
+        return result == output.size();
+    }
+
+private:
+    static constexpr ZSTD_customMem ZSTD_ALLOCATOR =
+    {
+        [](void*, size_t size) { return CountingAlloc(size); },
+        [](void*, void* pointer) { CountingFree(pointer); },
+        nullptr
+    };
+};
+
+class BrotliCodec : public Codec
+{
+public:
+    size_t Compress(const std::vector<unsigned char>& input, std::vector<unsigned char>& output, int level) override
+    {
+        BrotliEncoderState* encoder = BrotliEncoderCreateInstance(Alloc, Free, nullptr);
+
+        if (encoder == nullptr)
+            return 0;
+
+        BrotliEncoderSetParameter(encoder, BROTLI_PARAM_QUALITY, level);
+        BrotliEncoderSetParameter(encoder, BROTLI_PARAM_SIZE_HINT, uint32_t(input.size()));
+
+        output.resize(BrotliEncoderMaxCompressedSize(input.size()));
+
+        size_t available_in = input.size();
+        const uint8_t* next_in = input.data();
+        size_t available_out = output.size();
+        uint8_t* next_out = output.data();
+
+        while (BrotliEncoderCompressStream(encoder, BROTLI_OPERATION_FINISH, &available_in, &next_in, &available_out, &next_out, nullptr)
+            && !BrotliEncoderIsFinished(encoder));
+
+        const bool finished = BrotliEncoderIsFinished(encoder);
+        BrotliEncoderDestroyInstance(encoder);
+
+        return finished ? output.size() - available_out : 0;
+    }
+
+    bool Decompress(const unsigned char* input, size_t size, std::vector<unsigned char>& output) override
+    {
+        BrotliDecoderState* decoder = BrotliDecoderCreateInstance(Alloc, Free, nullptr);
+
+        if (decoder == nullptr)
+            return false;
+
+        size_t available_in = size;
+        const uint8_t* next_in = input;
+        size_t available_out = output.size();
+        uint8_t* next_out = output.data();
+
+        const BrotliDecoderResult result = BrotliDecoderDecompressStream(decoder, &available_in, &next_in, &available_out, &next_out, nullptr);
+        BrotliDecoderDestroyInstance(decoder);
+
+        return result == BROTLI_DECODER_RESULT_SUCCESS;
+    }
+
+private:
+    static void* Alloc(void*, size_t size)
+    {
+        return CountingAlloc(size);
+    }
+
+    static void Free(void*, void* pointer)
+    {
+        CountingFree(pointer);
+    }
+};
+
+class LzmaCodec : public Codec
+{
+public:
+    size_t Compress(const std::vector<unsigned char>& input, std::vector<unsigned char>& output, int level) override
+    {
+        lzma_stream stream = LZMA_STREAM_INIT;
+        stream.allocator = &LZMA_ALLOCATOR;
+
+        if (lzma_easy_encoder(&stream, uint32_t(level), LZMA_CHECK_CRC32) != LZMA_OK)
+            return 0;
+
+        output.resize(lzma_stream_buffer_bound(input.size()));
+
+        stream.next_in = input.data();
+        stream.avail_in = input.size();
+        stream.next_out = output.data();
+        stream.avail_out = output.size();
+
+        lzma_ret result;
+        while ((result = lzma_code(&stream, LZMA_FINISH)) == LZMA_OK);
+
+        const size_t size = stream.total_out;
+        lzma_end(&stream);
+
+        return result == LZMA_STREAM_END ? size : 0;
+    }
+
+    bool Decompress(const unsigned char* input, size_t size, std::vector<unsigned char>& output) override
+    {
+        lzma_stream stream = LZMA_STREAM_INIT;
+        stream.allocator = &LZMA_ALLOCATOR;
+
+        if (lzma_stream_decoder(&stream, UINT64_MAX, 0) != LZMA_OK)
+            return false;
+
+        stream.next_in = input;
+        stream.avail_in = size;
+        stream.next_out = output.data();
+        stream.avail_out = output.size();
+
+        lzma_ret result;
+        while ((result = lzma_code(&stream, LZMA_FINISH)) == LZMA_OK);
+
+        lzma_end(&stream);
+        return result == LZMA_STREAM_END;
+    }
+
+private:
+    static constexpr lzma_allocator LZMA_ALLOCATOR =
+    {
+        [](void*, size_t items, size_t size) { return CountingAlloc(items * size); },
+        [](void*, void* pointer) { CountingFree(pointer); },
+        nullptr
+    };
+};
+
+int main()
+{
+    const auto corpus = LoadCorpus();
+    AEDI_EXPECT(!corpus.empty());
+
+    size_t corpus_size = 0;
+
+    for (const auto& item : corpus)
+        corpus_size += item.second.size();
+
+    static const struct
+    {
+        const char* name;
+        std::unique_ptr<Codec> (*create)();
+        std::vector<int> levels;
+    }
+    CODECS[] =
+    {
+        { "zlib", [] { return std::unique_ptr<Codec>(new ZlibCodec); }, { 1, 6, 9 } },
+        { "bzip2", [] { return std::unique_ptr<Codec>(new Bzip2Codec); }, { 1, 9 } },
+        { "zstd", [] { return std::unique_ptr<Codec>(new ZstdCodec); }, { 1, 3, 9, 19 } },
+        { "brotli", [] { return std::unique_ptr<Codec>(new BrotliCodec); }, { 1, 5, 9, 11 } },
+        { "lzma", [] { return std::unique_ptr<Codec>(new LzmaCodec); }, { 0, 6, 9 } },
+    };
+
+    for (const auto& codec_info : CODECS)
+    {
+        const std::unique_ptr<Codec> codec = codec_info.create();
+
+        for (int level : codec_info.levels)
+        {
+            const std::string name = aedi::Format("%s/level%d", codec_info.name, level);
+            std::vector<std::vector<unsigned char>> compressed(corpus.size());
+            std::vector<size_t> compressed_sizes(corpus.size());
+
+            MemoryPeak = 0;
+
+            AEDI_BENCH("compress/" + name, Bytes, corpus_size)
+            {
+                for (size_t i = 0; i < corpus.size(); ++i)
+                {
+                    compressed_sizes[i] = codec->Compress(corpus[i].second, compressed[i], level);
+                    AEDI_EXPECT(compressed_sizes[i] != 0);
+                }
+            }
+
+            const size_t compress_peak = MemoryPeak;
+            size_t total_compressed = 0;
+
+            for (size_t size : compressed_sizes)
+                total_compressed += size;
+
+            std::vector<std::vector<unsigned char>> decompressed(corpus.size());
+
+            for (size_t i = 0; i < corpus.size(); ++i)
+                decompressed[i].resize(corpus[i].second.size());
+
+            MemoryPeak = 0;
+
+            AEDI_BENCH("decompress/" + name, Bytes, corpus_size)
+            {
+                for (size_t i = 0; i < corpus.size(); ++i)
+                    AEDI_EXPECT(codec->Decompress(compressed[i].data(), compressed_sizes[i], decompressed[i]));
+            }
+
+            for (size_t i = 0; i < corpus.size(); ++i)
+                AEDI_EXPECT(decompressed[i] == corpus[i].second);
+
+            aedi::Info(("ratio/" + name).c_str(), "%.3f", double(corpus_size) / total_compressed);
+            aedi::Info(("peak_memory/compress/" + name).c_str(), "%zu", compress_peak);
+            aedi::Info(("peak_memory/decompress/" + name).c_str(), "%zu", MemoryPeak);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include <math.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// Content typical for PK3 archives, shared by compression benchmarks
+// Built-in corpus is generated, set AEDI_BENCH_CORPUS to colon separated list of files to use real data instead
+
+constexpr size_t ITEM_SIZE = 1024 * 1024;
+
+static uint32_t Random(uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// ZScript source like text
+static std::vector<unsigned char> MakeText()
+{
+    static const char* const WORDS[] =
+    {
+        "class", "extends", "Actor", "override", "void", "Tick", "int", "double", "bool", "return",
+        "if", "else", "for", "while", "self", "invoker", "A_SpawnItemEx", "A_StartSound", "Default",
+        "States", "Spawn:", "Loop;", "Stop;", "TNT1", "A", "0;", "Radius", "Height", "+NOGRAVITY",
+    };
+
+    std::vector<unsigned char> data;
+    data.reserve(ITEM_SIZE);
+
+    uint32_t state = 0x1234;
+
+    while (data.size() < ITEM_SIZE)
+    {
+        const int indent = Random(state) % 4;
+        data.insert(data.end(), indent, '\t');
+
+        for (uint32_t i = 0, count = 2 + Random(state) % 8; i < count; ++i)
+        {
+            const char* word = WORDS[Random(state) % (sizeof WORDS / sizeof WORDS[0])];
+            data.insert(data.end(), word, word + strlen(word));
+            data.push_back(' ');
+
+            if (Random(state) % 5 == 0)
+            {
+                const std::string number = aedi::Format("%u", Random(state) % 1000);
+                data.insert(data.end(), number.begin(), number.end());
+                data.push_back(',');
+            }
+        }
+
+        data.push_back('\n');
+    }
+
+    data.resize(ITEM_SIZE);
+    return data;
+}
+
+// 16-bit PCM sound effect, decaying tones with noise
+static std::vector<unsigned char> MakeSound()
+{
+    std::vector<unsigned char> data(ITEM_SIZE);
+    int16_t* samples = reinterpret_cast<int16_t*>(data.data());
+
+    uint32_t state = 0x5678;
+
+    for (size_t i = 0, count = ITEM_SIZE / sizeof(int16_t); i < count; ++i)
+    {
+        const double time = (i % 11025) / 11025.0;
+        const double envelope = exp(-4.0 * time);
+        const double tone = sin(2 * M_PI * 220 * time) + 0.5 * sin(2 * M_PI * 660 * time);
+        const double noise = (int(Random(state) % 2001) - 1000) / 1000.0 * 0.1;
+
+        samples[i] = int16_t((tone * envelope + noise) * 12000);
+    }
+
+    return data;
+}
+
+// 8-bit paletted texture, bricks with noise
+static std::vector<unsigned char> MakeTexture()
+{
+    std::vector<unsigned char> data(ITEM_SIZE);
+    constexpr size_t WIDTH = 1024;
+
+    uint32_t state = 0x9abc;
+
+    for (size_t i = 0; i < ITEM_SIZE; ++i)
+    {
+        const size_t x = i % WIDTH, y = i / WIDTH;
+        const bool mortar = y % 16 == 0 || (x + (y / 16 % 2) * 16) % 32 == 0;
+
+        data[i] = static_cast<unsigned char>(mortar ? 96 : 160 + Random(state) % 8);
+    }
+
+    return data;
+}
+
+// Already compressed content, e.g. PNG or Ogg Vorbis
+static std::vector<unsigned char> MakeCompressed()
+{
+    std::vector<unsigned char> data(ITEM_SIZE);
+    uint32_t state = 0xdef0;
+
+    for (unsigned char& byte : data)
+        byte = static_cast<unsigned char>(Random(state));
+
+    return data;
+}
+
+static std::vector<std::pair<std::string, std::vector<unsigned char>>> LoadCorpus()
+{
+    std::vector<std::pair<std::string, std::vector<unsigned char>>> corpus;
+
+    if (const char* files = getenv("AEDI_BENCH_CORPUS"))
+    {
+        std::string list = files;
+
+        for (size_t start = 0, end; start < list.size(); start = end + 1)
+        {
+            end = list.find(':', start);
+            end = end == std::string::npos ? list.size() : end;
+
+            const std::string path = list.substr(start, end - start);
+            FILE* file = fopen(path.c_str(), "rb");
+
+            if (file == nullptr)
+                continue;
+
+            std::vector<unsigned char> data;
+            unsigned char buffer[65536];
+
+            for (size_t length; (length = fread(buffer, 1, sizeof buffer, file)) > 0;)
+                data.insert(data.end(), buffer, buffer + length);
+
+            fclose(file);
+
+            const size_t slash = path.rfind('/');
+            corpus.emplace_back(slash == std::string::npos ? path : path.substr(slash + 1), std::move(data));
+        }
+    }
+    else
+    {
+        corpus.emplace_back("text", MakeText());
+        corpus.emplace_back("sound", MakeSound());
+        corpus.emplace_back("texture", MakeTexture());
+        corpus.emplace_back("compressed", MakeCompressed());
+    }
+
+    return corpus;
+}
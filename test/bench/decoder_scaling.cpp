@@ -0,0 +1,462 @@
+// pkg-config: zmusic sndfile libmpg123 vorbisfile opusfile flac
+#include <FLAC/stream_decoder.h>
+#include <math.h>
+#include <mpg123.h>
+#include <opus/opusfile.h>
+#include <sndfile.h>
+#include <vorbis/vorbisfile.h>
+#include <zmusic.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// Throughput scaling of audio decoding with independent decoders on many threads, like streaming of music
+// and ambient sounds in parallel with loading of sound effects by job system does
+//
+// Every thread creates its own decoder for every repetition and decodes the whole file from memory
+// Files are encoded once by libsndfile, each library decodes the format it is used for in ports
+// Efficiency is aggregate throughput divided by single thread throughput times the number of busy cores,
+// library is flagged when efficiency drops below the threshold on performance cores only,
+// because shared state or locks inside of it serialize decoders that otherwise don't interact
+
+static constexpr int SAMPLE_RATE = 48000;  // the only rate of Opus
+static constexpr int CHANNELS = 2;
+static constexpr int DURATION = 5;  // seconds
+static constexpr int DECODES_PER_THREAD = 2;
+static constexpr int THREAD_COUNTS[] = { 1, 2, 4, 8, 16 };
+static constexpr double FLATTENED_EFFICIENCY = 0.5;
+
+struct MemoryFile
+{
+    std::vector<unsigned char> data;
+    sf_count_t position = 0;
+};
+
+static SF_VIRTUAL_IO MEMORY_IO =
+{
+    [](void* user_data) { return sf_count_t(static_cast<MemoryFile*>(user_data)->data.size()); },
+    [](sf_count_t offset, int whence, void* user_data)
+    {
+        MemoryFile* file = static_cast<MemoryFile*>(user_data);
+
+        if (whence == SEEK_CUR)
+            offset += file->position;
+        else if (whence == SEEK_END)
+            offset += sf_count_t(file->data.size());
+
+        file->position = offset;
+        return offset;
+    },
+    [](void*, sf_count_t, void*) { return sf_count_t(0); },  // read, not used for encoding
+    [](const void* buffer, sf_count_t count, void* user_data)
+    {
+        MemoryFile* file = static_cast<MemoryFile*>(user_data);
+        const size_t end = size_t(file->position + count);
+
+        if (file->data.size() < end)
+            file->data.resize(end);
+
+        memcpy(&file->data[size_t(file->position)], buffer, size_t(count));
+        file->position += count;
+
+        return count;
+    },
+    [](void* user_data) { return static_cast<MemoryFile*>(user_data)->position; },
+};
+
+// Read-only view of encoded data shared by all threads, every decoder has its own position
+struct MemoryView
+{
+    const std::vector<unsigned char>& data;
+    size_t position = 0;
+
+    explicit MemoryView(const std::vector<unsigned char>& data)
+    : data(data)
+    {
+    }
+
+    size_t Read(void* buffer, size_t size)
+    {
+        size = std::min(size, data.size() - position);
+        memcpy(buffer, &data[position], size);
+        position += size;
+
+        return size;
+    }
+
+    int64_t Seek(int64_t offset, int whence)
+    {
+        if (whence == SEEK_CUR)
+            offset += int64_t(position);
+        else if (whence == SEEK_END)
+            offset += int64_t(data.size());
+
+        if (offset < 0 || offset > int64_t(data.size()))
+            return -1;
+
+        position = size_t(offset);
+        return offset;
+    }
+};
+
+// Chord with slow tremolo, channels are slightly different
+static std::vector<float> MakeSignal()
+{
+    std::vector<float> signal(size_t(SAMPLE_RATE) * DURATION * CHANNELS);
+
+    for (size_t i = 0, e = signal.size() / CHANNELS; i < e; ++i)
+    {
+        const double time = double(i) / SAMPLE_RATE;
+        const double envelope = 0.5 + 0.25 * sin(2 * M_PI * 0.5 * time);
+
+        for (int channel = 0; channel < CHANNELS; ++channel)
+        {
+            const double chord = sin(2 * M_PI * 220 * time + channel) + 0.6 * sin(2 * M_PI * 277.18 * time)
+                + 0.4 * sin(2 * M_PI * 329.63 * time);
+            signal[i * CHANNELS + channel] = float(envelope * chord * 0.3);
+        }
+    }
+
+    return signal;
+}
+
+static std::vector<unsigned char> Encode(const std::vector<float>& signal, int format)
+{
+    MemoryFile file;
+
+    SF_INFO info = {};
+    info.samplerate = SAMPLE_RATE;
+    info.channels = CHANNELS;
+    info.format = format;
+
+    SNDFILE* sndfile = sf_open_virtual(&MEMORY_IO, SFM_WRITE, &info, &file);
+
+    if (sndfile == nullptr)
+        return {};
+
+    const sf_count_t frames = sf_count_t(signal.size() / CHANNELS);
+    const bool written = sf_writef_float(sndfile, signal.data(), frames) == frames;
+
+    if (sf_close(sndfile) != 0 || !written)
+        return {};
+
+    return std::move(file.data);
+}
+
+// Decoders of the whole file, every one returns number of sample frames, or zero on failure
+
+static size_t DecodeZMusic(const std::vector<unsigned char>& data)
+{
+    SoundDecoder* decoder = CreateDecoder(data.data(), data.size(), true);
+
+    if (decoder == nullptr)
+        return 0;
+
+    int samplerate = 0;
+    ChannelConfig channels = ChannelConfig_Mono;
+    SampleType type = SampleType_UInt8;
+    SoundDecoder_GetInfo(decoder, &samplerate, &channels, &type);
+
+    const size_t frame_size = (type == SampleType_Float32 ? 4 : type == SampleType_Int16 ? 2 : 1)
+        * (channels == ChannelConfig_Stereo ? 2 : 1);
+
+    unsigned char buffer[64 * 1024];
+    size_t size = 0;
+
+    while (const size_t read = SoundDecoder_Read(decoder, buffer, sizeof buffer))
+        size += read;
+
+    SoundDecoder_Close(decoder);
+
+    return size / frame_size;
+}
+
+static size_t DecodeMpg123(const std::vector<unsigned char>& data)
+{
+    mpg123_handle* handle = mpg123_new(nullptr, nullptr);
+
+    if (handle == nullptr)
+        return 0;
+
+    size_t size = 0;
+    int result = MPG123_ERR;
+
+    if (mpg123_open_feed(handle) == MPG123_OK && mpg123_feed(handle, data.data(), data.size()) == MPG123_OK)
+    {
+        unsigned char buffer[64 * 1024];
+
+        do
+        {
+            size_t done = 0;
+            result = mpg123_read(handle, buffer, sizeof buffer, &done);
+            size += done;
+        }
+        while (result == MPG123_OK || result == MPG123_NEW_FORMAT);
+
+        mpg123_close(handle);
+    }
+
+    mpg123_delete(handle);
+
+    // With feeding, the end of data is reported as the need for more of it, output is 16-bit by default
+    return result == MPG123_NEED_MORE || result == MPG123_DONE ? size / sizeof(int16_t) / CHANNELS : 0;
+}
+
+static size_t DecodeSndFile(const std::vector<unsigned char>& data)
+{
+    static SF_VIRTUAL_IO io =
+    {
+        [](void* user_data) { return sf_count_t(static_cast<MemoryView*>(user_data)->data.size()); },
+        [](sf_count_t offset, int whence, void* user_data)
+        {
+            return sf_count_t(static_cast<MemoryView*>(user_data)->Seek(offset, whence));
+        },
+        [](void* buffer, sf_count_t count, void* user_data)
+        {
+            return sf_count_t(static_cast<MemoryView*>(user_data)->Read(buffer, size_t(count)));
+        },
+        [](const void*, sf_count_t, void*) { return sf_count_t(0); },  // write, not used for decoding
+        [](void* user_data) { return sf_count_t(static_cast<MemoryView*>(user_data)->position); },
+    };
+
+    MemoryView view(data);
+    SF_INFO info = {};
+    SNDFILE* sndfile = sf_open_virtual(&io, SFM_READ, &info, &view);
+
+    if (sndfile == nullptr)
+        return 0;
+
+    float buffer[4096 * CHANNELS];
+    size_t frames = 0;
+
+    while (const sf_count_t read = sf_readf_float(sndfile, buffer, 4096))
+        frames += size_t(read);
+
+    sf_close(sndfile);
+
+    return frames;
+}
+
+static size_t DecodeVorbisFile(const std::vector<unsigned char>& data)
+{
+    static const ov_callbacks callbacks =
+    {
+        [](void* buffer, size_t size, size_t count, void* source)
+        {
+            return static_cast<MemoryView*>(source)->Read(buffer, size * count) / size;
+        },
+        [](void* source, ogg_int64_t offset, int whence)
+        {
+            return static_cast<MemoryView*>(source)->Seek(offset, whence) < 0 ? -1 : 0;
+        },
+        nullptr,  // close, nothing to do
+        [](void* source) { return long(static_cast<MemoryView*>(source)->position); },
+    };
+
+    MemoryView view(data);
+    OggVorbis_File file;
+
+    if (ov_open_callbacks(&view, &file, nullptr, 0, callbacks) != 0)
+        return 0;
+
+    size_t frames = 0;
+    float** pcm = nullptr;
+    int bitstream = 0;
+    long read;
+
+    while ((read = ov_read_float(&file, &pcm, 4096, &bitstream)) > 0)
+        frames += size_t(read);
+
+    ov_clear(&file);
+
+    return read == 0 ? frames : 0;
+}
+
+static size_t DecodeOpusFile(const std::vector<unsigned char>& data)
+{
+    OggOpusFile* file = op_open_memory(data.data(), data.size(), nullptr);
+
+    if (file == nullptr)
+        return 0;
+
+    float buffer[5760 * CHANNELS];  // 120 ms, the largest Opus packet
+    size_t frames = 0;
+    int read;
+
+    while ((read = op_read_float(file, buffer, int(sizeof buffer / sizeof buffer[0]), nullptr)) > 0)
+        frames += size_t(read);
+
+    op_free(file);
+
+    return read == 0 ? frames : 0;
+}
+
+static size_t DecodeFLAC(const std::vector<unsigned char>& data)
+{
+    struct State
+    {
+        MemoryView view;
+        size_t frames;
+    };
+
+    const auto Read = [](const FLAC__StreamDecoder*, FLAC__byte buffer[], size_t* bytes, void* client_data)
+    {
+        *bytes = static_cast<State*>(client_data)->view.Read(buffer, *bytes);
+        return *bytes == 0 ? FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM : FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
+    };
+
+    const auto Write = [](const FLAC__StreamDecoder*, const FLAC__Frame* frame, const FLAC__int32* const[],
+        void* client_data)
+    {
+        static_cast<State*>(client_data)->frames += frame->header.blocksize;
+        return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+    };
+
+    const auto Error = [](const FLAC__StreamDecoder*, FLAC__StreamDecoderErrorStatus, void*)
+    {
+    };
+
+    FLAC__StreamDecoder* decoder = FLAC__stream_decoder_new();
+
+    if (decoder == nullptr)
+        return 0;
+
+    State state = { MemoryView(data), 0 };
+    bool decoded = false;
+
+    if (FLAC__stream_decoder_init_stream(decoder, Read, nullptr, nullptr, nullptr, nullptr, Write, nullptr, Error,
+        &state) == FLAC__STREAM_DECODER_INIT_STATUS_OK)
+    {
+        decoded = FLAC__stream_decoder_process_until_end_of_stream(decoder);
+        FLAC__stream_decoder_finish(decoder);
+    }
+
+    FLAC__stream_decoder_delete(decoder);
+
+    return decoded ? state.frames : 0;
+}
+
+struct Library
+{
+    const char* name;
+    const char* encoding;
+    int format;
+    size_t (*decode)(const std::vector<unsigned char>&);
+};
+
+static const Library LIBRARIES[] =
+{
+    { "zmusic", "vorbis", SF_FORMAT_OGG | SF_FORMAT_VORBIS, DecodeZMusic },
+    { "mpg123", "mp3", SF_FORMAT_MPEG | SF_FORMAT_MPEG_LAYER_III, DecodeMpg123 },
+    { "sndfile", "flac", SF_FORMAT_FLAC | SF_FORMAT_PCM_16, DecodeSndFile },
+    { "vorbisfile", "vorbis", SF_FORMAT_OGG | SF_FORMAT_VORBIS, DecodeVorbisFile },
+    { "opusfile", "opus", SF_FORMAT_OGG | SF_FORMAT_OPUS, DecodeOpusFile },
+    { "flac", "flac", SF_FORMAT_FLAC | SF_FORMAT_PCM_16, DecodeFLAC },
+};
+
+// Number of the fastest cores, efficiency cores of Apple silicon would lower scaling of any library
+static int PerformanceCores()
+{
+    int value = 0;
+    size_t size = sizeof value;
+
+    if (sysctlbyname("hw.perflevel0.physicalcpu", &value, &size, nullptr, 0) == 0 && value > 0)
+        return value;
+
+    size = sizeof value;
+
+    if (sysctlbyname("hw.physicalcpu", &value, &size, nullptr, 0) == 0 && value > 0)
+        return value;
+
+    return 1;
+}
+
+static void MeasureScaling(const Library& library, const std::vector<unsigned char>& encoded, int cores,
+    int performance_cores)
+{
+    const size_t frames = library.decode(encoded);
+    AEDI_EXPECT(frames >= size_t(SAMPLE_RATE) * (DURATION - 1));
+
+    double single_throughput = 0;
+    int flattened_at = 0;
+
+    for (int thread_count : THREAD_COUNTS)
+    {
+        const std::string suffix = aedi::Format("%s/threads%d", library.name, thread_count);
+        const double amount = double(frames) * DECODES_PER_THREAD * thread_count;
+
+        aedi::Bench aedi_bench("decode/" + suffix, aedi::Unit::Samples, amount);
+        int repetitions = 0;
+
+        while (aedi_bench.Next())
+        {
+            std::vector<std::thread> threads;
+            std::atomic<bool> failed(false);
+
+            for (int i = 0; i < thread_count; ++i)
+            {
+                threads.emplace_back([&library, &encoded, &failed, frames]
+                {
+                    for (int decode = 0; decode < DECODES_PER_THREAD; ++decode)
+                    {
+                        if (library.decode(encoded) != frames)
+                            failed.store(true, std::memory_order_relaxed);
+                    }
+                });
+            }
+
+            for (std::thread& thread : threads)
+                thread.join();
+
+            AEDI_EXPECT(!failed.load(std::memory_order_relaxed));
+            ++repetitions;
+        }
+
+        // The last repetition is recorded by the final Next() call, warm-up ones aren't recorded at all
+        const int warmup = aedi::EnvironmentValue("AEDI_BENCH_WARMUP", 3);
+        const double throughput = amount * (repetitions - warmup) / aedi_bench.TotalNanoseconds() * 1e9;
+
+        if (thread_count == 1)
+            single_throughput = throughput;
+
+        const double efficiency = throughput / (single_throughput * std::min(thread_count, cores));
+        aedi::Info(("efficiency/" + suffix).c_str(), "%.2f", efficiency);
+
+        if (flattened_at == 0 && thread_count <= performance_cores && efficiency < FLATTENED_EFFICIENCY)
+            flattened_at = thread_count;
+    }
+
+    if (flattened_at == 0)
+        aedi::Info(aedi::Format("flattened/%s", library.name).c_str(), "no");
+    else
+        aedi::Info(aedi::Format("flattened/%s", library.name).c_str(), "at %d threads", flattened_at);
+}
+
+int main()
+{
+    // Required by mpg123 versions before 1.27, it's no-op for later ones
+    AEDI_EXPECT(mpg123_init() == MPG123_OK);
+
+    const int cores = std::max(int(std::thread::hardware_concurrency()), 1);
+    const int performance_cores = PerformanceCores();
+
+    aedi::Info("cores", "%d", cores);
+    aedi::Info("performance_cores", "%d", performance_cores);
+    aedi::PrintCpuFeatures();
+
+    const std::vector<float> signal = MakeSignal();
+
+    for (const Library& library : LIBRARIES)
+    {
+        const std::vector<unsigned char> encoded = Encode(signal, library.format);
+        AEDI_EXPECT(!encoded.empty());
+
+        aedi::Info(aedi::Format("size/%s/%s", library.name, library.encoding).c_str(), "%zu", encoded.size());
+        MeasureScaling(library, encoded, cores, performance_cores);
+    }
+
+    mpg123_exit();
+
+    return 0;
+}
@@ -0,0 +1,552 @@
+#include <mach/mach.h>
+#include <math.h>
+#include <sys/stat.h>
+#include <fluidsynth.h>
+
+#include <string>
+#include <vector>
+
+// FluidSynth rendering of dense MIDI, sweeps polyphony and number of rendering threads
+//
+// Every repetition renders one block, so percentiles show block render time distribution, i.e. audio CPU spikes
+// Set AEDI_BENCH_SOUNDFONT to General MIDI soundfont to use, otherwise simple generated one is used
+// With generated soundfont, all voices cost the same, while real ones add layered zones and modulators
+//
+// Soundfont loading is measured with and without dynamic sample loading, load time and memory footprint
+// of sample data, after loading and after playback, show what is saved with large, i.e. SF3 compressed, banks
+// Uncompressed SF2 samples are mapped from file, so they add to resident size but not to footprint,
+// as clean file pages are in page cache, which is shared by all synths of all processes
+//
+// Set AEDI_BENCH_DLS to DLS bank to measure its loading too, GS bank of macOS is used by default
+// DLS banks are loaded by libinstpatch, their 16-bit samples are mapped from file like SF2 ones
+//
+// Unused samples are kept in cache up to FLUID_SAMPLECACHE_SIZE megabytes, see patch/fluidsynth-sample-cache-lru.diff
+// Loading is measured with empty cache, program changes with dynamic sample loading are measured with and without it
+
+static constexpr int SAMPLE_RATE = 48000;
+static constexpr int BLOCK_SIZE = 512;  // frames
+static constexpr int DURATION = 20;  // seconds
+
+static constexpr int LOAD_REPETITIONS = 5;
+static constexpr int PLAYBACK_DURATION = 5;  // seconds, played before memory footprint is taken
+static constexpr int PROGRAM_CHANGE_COUNT = 1000;
+
+static constexpr int TICKS_PER_BEAT = 480;
+static constexpr int TICKS_PER_SECOND = TICKS_PER_BEAT * 2;  // default tempo, 120 BPM
+
+class Writer
+{
+public:
+    std::vector<unsigned char> data;
+
+    void Bytes(const void* bytes, size_t size)
+    {
+        const unsigned char* begin = static_cast<const unsigned char*>(bytes);
+        data.insert(data.end(), begin, begin + size);
+    }
+
+    void String(const char* value, size_t size)
+    {
+        const size_t length = std::min(strlen(value), size);
+        Bytes(value, length);
+        data.insert(data.end(), size - length, 0);
+    }
+
+    // Little endian for RIFF
+    void U8(unsigned value) { data.push_back(uint8_t(value)); }
+    void U16(unsigned value) { U8(value); U8(value >> 8); }
+    void U32(uint32_t value) { U16(value); U16(value >> 16); }
+
+    // Big endian for SMF
+    void BE16(unsigned value) { U8(value >> 8); U8(value); }
+    void BE32(uint32_t value) { BE16(value >> 16); BE16(value); }
+
+    void VarLen(uint32_t value)
+    {
+        unsigned char bytes[5];
+        int count = 0;
+
+        do
+        {
+            bytes[count++] = value & 0x7F;
+            value >>= 7;
+        }
+        while (value != 0);
+
+        while (count > 1)
+            U8(bytes[--count] | 0x80);
+
+        U8(bytes[0]);
+    }
+
+    size_t BeginChunk(const char* id)
+    {
+        Bytes(id, 4);
+        U32(0);
+        return data.size();
+    }
+
+    void EndChunk(size_t start)
+    {
+        const uint32_t size = uint32_t(data.size() - start);
+
+        if (size & 1)
+            U8(0);
+
+        for (int i = 0; i < 4; ++i)
+            data[start - 4 + i] = uint8_t(size >> (i * 8));
+    }
+};
+
+// Minimal SoundFont 2.01 with a looped harmonic-rich waveform used by all 128 melodic presets and by drum kit
+static std::vector<unsigned char> MakeSoundFont()
+{
+    constexpr int CYCLE = 100;  // 441 Hz at 44.1 kHz, close enough to A4
+    constexpr int LENGTH = CYCLE * 20;
+    constexpr int LOOP_START = CYCLE * 10;
+    constexpr int PRESET_COUNT = 129;
+
+    // Generators, see SoundFont 2.01 specification, section 8.1.2
+    constexpr unsigned GEN_RELEASE_VOL_ENV = 38;
+    constexpr unsigned GEN_INSTRUMENT = 41;
+    constexpr unsigned GEN_SAMPLE_ID = 53;
+    constexpr unsigned GEN_SAMPLE_MODES = 54;
+
+    Writer sf;
+
+    size_t riff = sf.BeginChunk("RIFF");
+    sf.Bytes("sfbk", 4);
+
+    size_t list = sf.BeginChunk("LIST");
+    sf.Bytes("INFO", 4);
+    size_t chunk = sf.BeginChunk("ifil");
+    sf.U16(2);
+    sf.U16(1);
+    sf.EndChunk(chunk);
+    chunk = sf.BeginChunk("isng");
+    sf.String("EMU8000", 8);
+    sf.EndChunk(chunk);
+    chunk = sf.BeginChunk("INAM");
+    sf.String("aedi benchmark", 16);
+    sf.EndChunk(chunk);
+    sf.EndChunk(list);
+
+    list = sf.BeginChunk("LIST");
+    sf.Bytes("sdta", 4);
+    chunk = sf.BeginChunk("smpl");
+
+    for (int i = 0; i < LENGTH; ++i)
+    {
+        const double phase = 2 * M_PI * (i % CYCLE) / CYCLE;
+        const double value = 0.5 * sin(phase) + 0.25 * sin(2 * phase) + 0.125 * sin(3 * phase) + 0.0625 * sin(5 * phase);
+        sf.U16(uint16_t(int16_t(value * 32767 * 0.9)));
+    }
+
+    // Specification requires at least 46 zero samples after each sample
+    for (int i = 0; i < 46; ++i)
+        sf.U16(0);
+
+    sf.EndChunk(chunk);
+    sf.EndChunk(list);
+
+    list = sf.BeginChunk("LIST");
+    sf.Bytes("pdta", 4);
+
+    chunk = sf.BeginChunk("phdr");
+
+    for (int i = 0; i <= PRESET_COUNT; ++i)
+    {
+        const bool drums = i == PRESET_COUNT - 1;
+        const bool terminal = i == PRESET_COUNT;
+
+        sf.String(terminal ? "EOP" : aedi::Format("Preset %d", i).c_str(), 20);
+        sf.U16(drums || terminal ? 0 : i);
+        sf.U16(drums ? 128 : 0);
+        sf.U16(i);  // bag index
+        sf.U32(0);
+        sf.U32(0);
+        sf.U32(0);
+    }
+
+    sf.EndChunk(chunk);
+
+    chunk = sf.BeginChunk("pbag");
+
+    for (int i = 0; i <= PRESET_COUNT; ++i)
+    {
+        sf.U16(i);  // generator index
+        sf.U16(0);  // modulator index
+    }
+
+    sf.EndChunk(chunk);
+
+    chunk = sf.BeginChunk("pmod");
+    sf.data.insert(sf.data.end(), 10, 0);
+    sf.EndChunk(chunk);
+
+    chunk = sf.BeginChunk("pgen");
+
+    for (int i = 0; i < PRESET_COUNT; ++i)
+    {
+        sf.U16(GEN_INSTRUMENT);
+        sf.U16(0);
+    }
+
+    sf.U32(0);
+    sf.EndChunk(chunk);
+
+    chunk = sf.BeginChunk("inst");
+    sf.String("Instrument", 20);
+    sf.U16(0);
+    sf.String("EOI", 20);
+    sf.U16(1);
+    sf.EndChunk(chunk);
+
+    chunk = sf.BeginChunk("ibag");
+    sf.U16(0);
+    sf.U16(0);
+    sf.U16(3);
+    sf.U16(0);
+    sf.EndChunk(chunk);
+
+    chunk = sf.BeginChunk("imod");
+    sf.data.insert(sf.data.end(), 10, 0);
+    sf.EndChunk(chunk);
+
+    chunk = sf.BeginChunk("igen");
+    sf.U16(GEN_RELEASE_VOL_ENV);
+    sf.U16(uint16_t(-1200));  // 0.5 seconds in timecents
+    sf.U16(GEN_SAMPLE_MODES);
+    sf.U16(1);  // continuous loop
+    sf.U16(GEN_SAMPLE_ID);  // must be the last generator of zone
+    sf.U16(0);
+    sf.U32(0);
+    sf.EndChunk(chunk);
+
+    chunk = sf.BeginChunk("shdr");
+    sf.String("Sample", 20);
+    sf.U32(0);
+    sf.U32(LENGTH);
+    sf.U32(LOOP_START);
+    sf.U32(LENGTH);
+    sf.U32(44100);
+    sf.U8(69);  // A4
+    sf.U8(0);
+    sf.U16(0);
+    sf.U16(1);  // mono
+    sf.String("EOS", 20);
+    sf.data.insert(sf.data.end(), 26, 0);
+    sf.EndChunk(chunk);
+
+    sf.EndChunk(list);
+    sf.EndChunk(riff);
+
+    return std::move(sf.data);
+}
+
+// Format 0 MIDI file with all channels playing long overlapping notes, it wants more voices than polyphony allows
+static std::vector<unsigned char> MakeStressMidi()
+{
+    constexpr uint32_t NOTE_INTERVAL = TICKS_PER_SECOND / 40;  // 25 ms
+    constexpr uint32_t NOTE_LENGTH = TICKS_PER_SECOND * 2;
+    constexpr uint32_t END = TICKS_PER_SECOND * DURATION;
+
+    struct Event
+    {
+        uint32_t tick;
+        unsigned char status, data1, data2;
+    };
+
+    std::vector<Event> events;
+
+    // Drum channel keeps the default kit
+    for (unsigned channel = 0; channel < 16; ++channel)
+    {
+        if (channel != 9)
+            events.push_back({ 0, uint8_t(0xC0 | channel), uint8_t(channel * 8), 0 });
+    }
+
+    uint32_t state = 0x5EED;
+
+    for (uint32_t tick = 0; tick + NOTE_LENGTH < END; tick += NOTE_INTERVAL)
+    {
+        for (unsigned channel = 0; channel < 16; ++channel)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+
+            const uint8_t note = uint8_t(channel == 9 ? 35 + state % 47 : 36 + state % 60);
+            const uint8_t velocity = uint8_t(64 + (state >> 8) % 64);
+
+            events.push_back({ tick, uint8_t(0x90 | channel), note, velocity });
+            events.push_back({ tick + NOTE_LENGTH, uint8_t(0x80 | channel), note, 0 });
+        }
+    }
+
+    std::stable_sort(events.begin(), events.end(), [](const Event& left, const Event& right)
+    {
+        return left.tick < right.tick;
+    });
+
+    Writer midi;
+    midi.Bytes("MThd", 4);
+    midi.BE32(6);
+    midi.BE16(0);
+    midi.BE16(1);
+    midi.BE16(TICKS_PER_BEAT);
+
+    midi.Bytes("MTrk", 4);
+    const size_t size_offset = midi.data.size();
+    midi.BE32(0);
+
+    uint32_t last_tick = 0;
+
+    for (const Event& event : events)
+    {
+        midi.VarLen(event.tick - last_tick);
+        midi.U8(event.status);
+        midi.U8(event.data1);
+
+        if ((event.status & 0xF0) != 0xC0)
+            midi.U8(event.data2);
+
+        last_tick = event.tick;
+    }
+
+    midi.VarLen(END - last_tick);
+    midi.Bytes("\xFF\x2F\x00", 3);  // end of track
+
+    const uint32_t track_size = uint32_t(midi.data.size() - size_offset - 4);
+
+    for (int i = 0; i < 4; ++i)
+        midi.data[size_offset + i] = uint8_t(track_size >> (24 - i * 8));
+
+    return std::move(midi.data);
+}
+
+static std::string PrepareSoundFont()
+{
+    if (const char* path = getenv("AEDI_BENCH_SOUNDFONT"))
+        return path;
+
+    const std::vector<unsigned char> soundfont = MakeSoundFont();
+    const char* const path = "fluidsynth-bench.sf2";
+
+    FILE* file = fopen(path, "wb");
+
+    if (file == nullptr)
+        return {};
+
+    const bool written = fwrite(soundfont.data(), 1, soundfont.size(), file) == soundfont.size();
+    return fclose(file) == 0 && written ? path : "";
+}
+
+static task_vm_info_data_t VMInfo()
+{
+    task_vm_info_data_t info = {};
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+
+    if (task_info(mach_task_self(), TASK_VM_INFO, task_info_t(&info), &count) != KERN_SUCCESS)
+        return {};
+
+    return info;
+}
+
+// Physical memory of the process, unlike peak resident size it goes down when sample data is freed
+static int64_t MemoryFootprint()
+{
+    return int64_t(VMInfo().phys_footprint);
+}
+
+// Current resident size, it includes pages of mapped files
+static int64_t ResidentSize()
+{
+    return int64_t(VMInfo().resident_size);
+}
+
+// Load time, then memory footprint and resident size of sample data after loading and after playback
+static void MeasureBank(const std::string& bank, const std::vector<unsigned char>& midi, const std::string& mode,
+    int dynamic)
+{
+    struct stat status = {};
+    AEDI_EXPECT(stat(bank.c_str(), &status) == 0);
+
+    std::vector<float> left(BLOCK_SIZE);
+    std::vector<float> right(BLOCK_SIZE);
+
+    fluid_settings_t* settings = new_fluid_settings();
+    AEDI_EXPECT(fluid_settings_setnum(settings, "synth.sample-rate", SAMPLE_RATE) == FLUID_OK);
+    AEDI_EXPECT(fluid_settings_setint(settings, "synth.dynamic-sample-loading", dynamic) == FLUID_OK);
+
+    fluid_synth_t* synth = new_fluid_synth(settings);
+    AEDI_EXPECT(synth != nullptr);
+
+    AEDI_BENCH_COUNT("load/" + mode, Bytes, status.st_size, LOAD_REPETITIONS)
+    {
+        const int id = fluid_synth_sfload(synth, bank.c_str(), 1);
+        AEDI_EXPECT(id != FLUID_FAILED);
+        AEDI_EXPECT(fluid_synth_sfunload(synth, id, 1) == FLUID_OK);
+    }
+
+    const int64_t initial_footprint = MemoryFootprint();
+    const int64_t initial_resident = ResidentSize();
+    AEDI_EXPECT(fluid_synth_sfload(synth, bank.c_str(), 1) != FLUID_FAILED);
+    const int64_t loaded_footprint = MemoryFootprint();
+    const int64_t loaded_resident = ResidentSize();
+
+    fluid_player_t* player = new_fluid_player(synth);
+    AEDI_EXPECT(fluid_player_add_mem(player, midi.data(), midi.size()) == FLUID_OK);
+    AEDI_EXPECT(fluid_player_play(player) == FLUID_OK);
+
+    for (int i = 0; i < SAMPLE_RATE * PLAYBACK_DURATION / BLOCK_SIZE; ++i)
+        AEDI_EXPECT(fluid_synth_write_float(synth, BLOCK_SIZE, left.data(), 0, 1, right.data(), 0, 1) == FLUID_OK);
+
+    const int64_t playback_footprint = MemoryFootprint();
+    const int64_t playback_resident = ResidentSize();
+
+    constexpr double MB = 1024 * 1024;
+    aedi::Info(("footprint_mb/loaded/" + mode).c_str(), "%.1f", (loaded_footprint - initial_footprint) / MB);
+    aedi::Info(("footprint_mb/playback/" + mode).c_str(), "%.1f", (playback_footprint - initial_footprint) / MB);
+    aedi::Info(("rss_mb/loaded/" + mode).c_str(), "%.1f", (loaded_resident - initial_resident) / MB);
+    aedi::Info(("rss_mb/playback/" + mode).c_str(), "%.1f", (playback_resident - initial_resident) / MB);
+
+    fluid_player_stop(player);
+    delete_fluid_player(player);
+    delete_fluid_synth(synth);
+    delete_fluid_settings(settings);
+}
+
+// With dynamic sample loading, samples are read, and decoded for SF3, only when presets that use them are selected
+static void MeasureLoading(const std::string& soundfont, const std::vector<unsigned char>& midi)
+{
+    // Samples of unloaded soundfont would be taken from cache by the next load
+    AEDI_EXPECT(setenv("FLUID_SAMPLECACHE_SIZE", "0", 1) == 0);
+
+    for (int dynamic : { 0, 1 })
+        MeasureBank(soundfont, midi, dynamic ? "dynamic" : "static", dynamic);
+
+    AEDI_EXPECT(unsetenv("FLUID_SAMPLECACHE_SIZE") == 0);
+}
+
+// Every program change loads samples of selected preset, and unloads ones of previous preset, if nothing else uses them
+// Presets are cycled, so with large enough cache, samples are read, and decoded for SF3, during the first cycle only
+// All presets of generated soundfont share the same sample, use real one to see the difference
+static void MeasureProgramChanges(const std::string& soundfont)
+{
+    for (const char* cache_size : { "0", "64", "512" })
+    {
+        AEDI_EXPECT(setenv("FLUID_SAMPLECACHE_SIZE", cache_size, 1) == 0);
+
+        fluid_settings_t* settings = new_fluid_settings();
+        AEDI_EXPECT(fluid_settings_setnum(settings, "synth.sample-rate", SAMPLE_RATE) == FLUID_OK);
+        AEDI_EXPECT(fluid_settings_setint(settings, "synth.dynamic-sample-loading", 1) == FLUID_OK);
+
+        fluid_synth_t* synth = new_fluid_synth(settings);
+        AEDI_EXPECT(synth != nullptr);
+        AEDI_EXPECT(fluid_synth_sfload(synth, soundfont.c_str(), 1) != FLUID_FAILED);
+
+        const int64_t initial_footprint = MemoryFootprint();
+        int program = 0;
+
+        AEDI_BENCH_COUNT(aedi::Format("program_change/cache_%smb", cache_size), Operations, 1, PROGRAM_CHANGE_COUNT)
+        {
+            program = (program + 1) % 128;
+            AEDI_EXPECT(fluid_synth_program_change(synth, 0, program) == FLUID_OK);
+        }
+
+        constexpr double MB = 1024 * 1024;
+        const double footprint = (MemoryFootprint() - initial_footprint) / MB;
+        aedi::Info(aedi::Format("footprint_mb/program_change/cache_%smb", cache_size).c_str(), "%.1f", footprint);
+
+        delete_fluid_synth(synth);
+        delete_fluid_settings(settings);
+    }
+
+    AEDI_EXPECT(unsetenv("FLUID_SAMPLECACHE_SIZE") == 0);
+}
+
+// Dynamic sample loading doesn't apply to DLS banks, their samples are read on the first playback anyway
+static void MeasureDLSLoading(const std::vector<unsigned char>& midi)
+{
+    const char* path = getenv("AEDI_BENCH_DLS");
+
+    if (path == nullptr)
+        path = "/System/Library/Components/CoreAudio.component/Contents/Resources/gs_instruments.dls";
+
+    struct stat status = {};
+
+    if (stat(path, &status) != 0)
+        return;
+
+    aedi::Info("dls", "%s", path);
+    MeasureBank(path, midi, "dls", 0);
+}
+
+int main()
+{
+    aedi::Info("fluidsynth_version", "%s", fluid_version_str());
+    aedi::PrintCpuFeatures();
+
+    fluid_set_log_function(FLUID_WARN, nullptr, nullptr);
+    fluid_set_log_function(FLUID_INFO, nullptr, nullptr);
+
+    const std::string soundfont = PrepareSoundFont();
+    AEDI_EXPECT(!soundfont.empty());
+    aedi::Info("soundfont", "%s", soundfont.c_str());
+
+    const std::vector<unsigned char> midi = MakeStressMidi();
+    MeasureLoading(soundfont, midi);
+    MeasureProgramChanges(soundfont);
+    MeasureDLSLoading(midi);
+
+    std::vector<float> left(BLOCK_SIZE);
+    std::vector<float> right(BLOCK_SIZE);
+
+    constexpr int BLOCK_COUNT = SAMPLE_RATE * DURATION / BLOCK_SIZE;
+
+    for (int polyphony : { 128, 256, 512 })
+    {
+        for (int cores : { 1, 2, 4, 8 })
+        {
+            fluid_settings_t* settings = new_fluid_settings();
+            AEDI_EXPECT(fluid_settings_setnum(settings, "synth.sample-rate", SAMPLE_RATE) == FLUID_OK);
+            AEDI_EXPECT(fluid_settings_setint(settings, "synth.polyphony", polyphony) == FLUID_OK);
+            AEDI_EXPECT(fluid_settings_setint(settings, "synth.cpu-cores", cores) == FLUID_OK);
+
+            fluid_synth_t* synth = new_fluid_synth(settings);
+            AEDI_EXPECT(synth != nullptr);
+            AEDI_EXPECT(fluid_synth_sfload(synth, soundfont.c_str(), 1) != FLUID_FAILED);
+
+            // Player is driven by synth's sample timer, so rendering advances the song
+            fluid_player_t* player = new_fluid_player(synth);
+            AEDI_EXPECT(fluid_player_add_mem(player, midi.data(), midi.size()) == FLUID_OK);
+            AEDI_EXPECT(fluid_player_set_loop(player, -1) == FLUID_OK);
+            AEDI_EXPECT(fluid_player_play(player) == FLUID_OK);
+
+            const std::string suffix = aedi::Format("polyphony%d/cores%d", polyphony, cores);
+            int max_voices = 0;
+
+            {
+                aedi::Bench aedi_bench("render/" + suffix, aedi::Unit::Samples, BLOCK_SIZE, BLOCK_COUNT);
+
+                while (aedi_bench.Next())
+                {
+                    AEDI_EXPECT(fluid_synth_write_float(synth, BLOCK_SIZE, left.data(), 0, 1, right.data(), 0, 1) == FLUID_OK);
+                    max_voices = std::max(max_voices, fluid_synth_get_active_voice_count(synth));
+                }
+
+                aedi::Info(("rtf/" + suffix).c_str(), "%.1f", DURATION * 1e9 / aedi_bench.TotalNanoseconds());
+            }
+
+            aedi::Info(("max_voices/" + suffix).c_str(), "%d", max_voices);
+
+            fluid_player_stop(player);
+            delete_fluid_player(player);
+            delete_fluid_synth(synth);
+            delete_fluid_settings(settings);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+// pkg-config: freeimage
+#include <FreeImage.h>
+
+#include <vector>
+
+// Image loading time of FreeImage based tools, decoding of JPEG, PNG and WebP images from memory
+//
+// Test image is generated once and encoded into every format, then the encoded data is decoded repeatedly
+// Codecs come from libjpeg-turbo, libpng, libwebp and zlib-ng of prefix unless FreeImage is built with bundled ones,
+// PNG is measured with default and the best zlib compression levels, as the latter is common for textures
+
+static constexpr int WIDTH = 1024;
+static constexpr int HEIGHT = 1024;
+
+struct Format
+{
+    const char* name;
+    FREE_IMAGE_FORMAT format;
+    int flags;
+};
+
+static const Format FORMATS[] =
+{
+    { "jpeg", FIF_JPEG, JPEG_QUALITYGOOD },
+    { "png", FIF_PNG, PNG_DEFAULT },
+    { "png-best", FIF_PNG, PNG_Z_BEST_COMPRESSION },
+    { "webp", FIF_WEBP, WEBP_DEFAULT },
+    { "webp-lossless", FIF_WEBP, WEBP_LOSSLESS },
+};
+
+// Gradients with a grid of sharp edges, so no codec gets trivial input
+static FIBITMAP* GenerateImage()
+{
+    FIBITMAP* image = FreeImage_Allocate(WIDTH, HEIGHT, 24);
+    AEDI_EXPECT(image != nullptr);
+
+    for (int y = 0; y < HEIGHT; ++y)
+    {
+        BYTE* pixel = FreeImage_GetScanLine(image, y);
+
+        for (int x = 0; x < WIDTH; ++x, pixel += 3)
+        {
+            const bool grid = (x % 64) < 2 || (y % 64) < 2;
+
+            pixel[FI_RGBA_RED] = grid ? 255 : BYTE(x / 4);
+            pixel[FI_RGBA_GREEN] = grid ? 255 : BYTE(y / 4);
+            pixel[FI_RGBA_BLUE] = grid ? 0 : BYTE((x ^ y) & 0xff);
+        }
+    }
+
+    return image;
+}
+
+static std::vector<BYTE> Encode(FIBITMAP* image, const Format& format)
+{
+    FIMEMORY* memory = FreeImage_OpenMemory();
+    AEDI_EXPECT(FreeImage_SaveToMemory(format.format, image, memory, format.flags));
+
+    BYTE* data = nullptr;
+    DWORD size = 0;
+    AEDI_EXPECT(FreeImage_AcquireMemory(memory, &data, &size));
+
+    std::vector<BYTE> encoded(data, data + size);
+    FreeImage_CloseMemory(memory);
+
+    return encoded;
+}
+
+int main()
+{
+    FreeImage_Initialise(FALSE);
+
+    aedi::Info("freeimage_version", "%s", FreeImage_GetVersion());
+    aedi::PrintCpuFeatures();
+
+    FIBITMAP* image = GenerateImage();
+
+    for (const Format& format : FORMATS)
+    {
+        std::vector<BYTE> encoded = Encode(image, format);
+        aedi::Info(aedi::Format("encoded_size/%s", format.name).c_str(), "%zu", encoded.size());
+
+        AEDI_BENCH(aedi::Format("load/%s", format.name), Pixels, WIDTH * HEIGHT)
+        {
+            FIMEMORY* memory = FreeImage_OpenMemory(encoded.data(), DWORD(encoded.size()));
+            FIBITMAP* loaded = FreeImage_LoadFromMemory(format.format, memory);
+
+            AEDI_EXPECT(loaded != nullptr && FreeImage_GetWidth(loaded) == WIDTH);
+
+            FreeImage_Unload(loaded);
+            FreeImage_CloseMemory(memory);
+        }
+    }
+
+    FreeImage_Unload(image);
+    FreeImage_DeInitialise();
+
+    return 0;
+}
@@ -0,0 +1,232 @@
+#include <png.h>
+#include <setjmp.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Decoding of large textures by libpng, for RGBA and paletted images, with every row filter type
+//
+// SIMD code of libpng, NEON on arm64 and SSE2 on x86_64, accelerates reverse Sub, Avg and Paeth filters of RGB and RGBA
+// rows, NEON does Up filter too, so the difference with None filter of the same image is where optimized code shows up
+// Paletted images have one byte per pixel, their reverse filters always run scalar code, so they are the reference
+// Every repetition reads the whole image with the low level API into preallocated rows, without any transformations
+
+static constexpr int SIZE = 2048;
+
+// Platform specific filter initialization, detected by presence of its function in the executable
+static std::string FilterOptimizations(const char* path)
+{
+    static const struct
+    {
+        const char* name;
+        const char* symbol;
+    }
+    OPTIMIZATIONS[] =
+    {
+        { "neon", "_png_init_filter_functions_neon" },
+        { "sse2", "_png_init_filter_functions_sse2" },
+    };
+
+    const std::vector<std::string> symbols = aedi::LinkedSymbols(path);
+    std::string optimizations;
+
+    for (const auto& optimization : OPTIMIZATIONS)
+    {
+        if (std::find(symbols.begin(), symbols.end(), optimization.symbol) != symbols.end())
+            optimizations += (optimizations.empty() ? "" : " ") + std::string(optimization.name);
+    }
+
+    return optimizations.empty() ? "none" : optimizations;
+}
+
+// Brick wall with noise and holes, as 8-bit RGBA pixels or as indices into 256 color palette
+static std::vector<uint8_t> MakeTexture(int channels)
+{
+    std::vector<uint8_t> texture(size_t(SIZE) * SIZE * channels);
+    uint32_t state = 0xFACE;
+
+    for (int y = 0; y < SIZE; ++y)
+    {
+        for (int x = 0; x < SIZE; ++x)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+
+            const int row = y / 32;
+            const bool mortar = y % 32 < 3 || (x + (row & 1) * 32) % 64 < 3;
+            const int noise = int(state % 32);
+            const int dx = x % 128 - 64, dy = y % 128 - 64;
+            const bool hole = dx * dx + dy * dy < 24 * 24;
+
+            uint8_t* pixel = &texture[(size_t(y) * SIZE + x) * channels];
+
+            if (channels == 1)
+            {
+                pixel[0] = uint8_t(hole ? 0 : (mortar ? 192 : 64 + row % 3 * 32) + noise);
+                continue;
+            }
+
+            pixel[0] = uint8_t(mortar ? 160 + noise : 140 + noise + row % 3 * 10);
+            pixel[1] = uint8_t(mortar ? 150 + noise : 60 + noise);
+            pixel[2] = uint8_t(mortar ? 140 + noise : 40 + noise);
+            pixel[3] = uint8_t(hole ? 0 : 255);
+        }
+    }
+
+    return texture;
+}
+
+static std::vector<png_color> MakePalette()
+{
+    std::vector<png_color> palette(256);
+
+    for (int i = 0; i < 256; ++i)
+        palette[i] = { png_byte(i), png_byte(i * 3 / 4), png_byte(i / 2) };
+
+    return palette;
+}
+
+static std::vector<uint8_t> Encode(const std::vector<uint8_t>& pixels, int channels, int filter)
+{
+    std::vector<uint8_t> encoded;
+
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png_create_info_struct(png);
+
+    if (setjmp(png_jmpbuf(png)))
+    {
+        png_destroy_write_struct(&png, &info);
+        return {};
+    }
+
+    const auto Write = [](png_structp png, png_bytep data, size_t size)
+    {
+        auto* output = static_cast<std::vector<uint8_t>*>(png_get_io_ptr(png));
+        output->insert(output->end(), data, data + size);
+    };
+
+    png_set_write_fn(png, &encoded, Write, nullptr);
+    png_set_IHDR(png, info, SIZE, SIZE, 8, channels == 1 ? PNG_COLOR_TYPE_PALETTE : PNG_COLOR_TYPE_RGBA,
+        PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+
+    if (channels == 1)
+    {
+        const std::vector<png_color> palette = MakePalette();
+        png_set_PLTE(png, info, palette.data(), int(palette.size()));
+    }
+
+    png_set_filter(png, PNG_FILTER_TYPE_BASE, filter);
+    png_write_info(png, info);
+
+    for (int y = 0; y < SIZE; ++y)
+        png_write_row(png, &pixels[size_t(y) * SIZE * channels]);
+
+    png_write_end(png, info);
+    png_destroy_write_struct(&png, &info);
+
+    return encoded;
+}
+
+struct MemoryReader
+{
+    const std::vector<uint8_t>& encoded;
+    size_t position;
+};
+
+static bool Decode(const std::vector<uint8_t>& encoded, std::vector<png_bytep>& rows)
+{
+    MemoryReader reader = { encoded, 0 };
+
+    png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png_create_info_struct(png);
+
+    if (setjmp(png_jmpbuf(png)))
+    {
+        png_destroy_read_struct(&png, &info, nullptr);
+        return false;
+    }
+
+    const auto Read = [](png_structp png, png_bytep data, size_t size)
+    {
+        auto* reader = static_cast<MemoryReader*>(png_get_io_ptr(png));
+
+        if (reader->encoded.size() - reader->position < size)
+            png_error(png, "unexpected end of data");
+
+        memcpy(data, &reader->encoded[reader->position], size);
+        reader->position += size;
+    };
+
+    png_set_read_fn(png, &reader, Read);
+    png_read_info(png, info);
+
+    const bool valid = png_get_image_width(png, info) == SIZE && png_get_image_height(png, info) == SIZE;
+
+    if (valid)
+    {
+        png_read_image(png, rows.data());
+        png_read_end(png, nullptr);
+    }
+
+    png_destroy_read_struct(&png, &info, nullptr);
+    return valid;
+}
+
+int main(int, char** argv)
+{
+    aedi::Info("png_version", "%s", png_get_libpng_ver(nullptr));
+    aedi::PrintCpuFeatures();
+
+    const std::string optimizations = FilterOptimizations(argv[0]);
+    aedi::Info("png_filter_optimizations", "%s", optimizations.c_str());
+
+#if defined(__aarch64__)
+    AEDI_EXPECT(optimizations.find("neon") != std::string::npos);
+#elif defined(__x86_64__)
+    AEDI_EXPECT(optimizations.find("sse2") != std::string::npos);
+#endif
+
+    static const struct
+    {
+        const char* name;
+        int value;
+    }
+    FILTERS[] =
+    {
+        { "none", PNG_FILTER_NONE },
+        { "sub", PNG_FILTER_SUB },
+        { "up", PNG_FILTER_UP },
+        { "avg", PNG_FILTER_AVG },
+        { "paeth", PNG_FILTER_PAETH },
+    };
+
+    for (const auto& [name, channels] : { std::make_pair("rgba", 4), std::make_pair("paletted", 1) })
+    {
+        const std::vector<uint8_t> pixels = MakeTexture(channels);
+        std::vector<uint8_t> output(pixels.size());
+        std::vector<png_bytep> rows(SIZE);
+
+        for (int y = 0; y < SIZE; ++y)
+            rows[y] = &output[size_t(y) * SIZE * channels];
+
+        for (const auto& filter : FILTERS)
+        {
+            const std::vector<uint8_t> encoded = Encode(pixels, channels, filter.value);
+            AEDI_EXPECT(!encoded.empty());
+
+            const std::string suffix = aedi::Format("%s/%s/%d", name, filter.name, SIZE);
+            aedi::Info(("size/" + suffix).c_str(), "%zu", encoded.size());
+
+            AEDI_BENCH("decode/" + suffix, Pixels, SIZE * SIZE)
+            {
+                AEDI_EXPECT(Decode(encoded, rows));
+            }
+
+            AEDI_EXPECT(output == pixels);
+        }
+    }
+
+    return 0;
+}
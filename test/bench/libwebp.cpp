@@ -0,0 +1,141 @@
+#include <webp/decode.h>
+#include <webp/encode.h>
+
+#include <vector>
+
+// Texture decoding, all at once into allocated and preallocated memory, and incrementally as from a PK3 entry stream
+
+// Internal libwebp function pointer that reports CPU features to its DSP initialization, see src/dsp/cpu.h
+extern "C" int (*VP8GetCPUInfo)(int feature);
+
+static constexpr int WIDTH = 1024;
+static constexpr int HEIGHT = 1024;
+static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+static void PrintSimdPaths()
+{
+    static const char* const FEATURES[] =
+    {
+        // Order matches CPUFeature enumeration
+        "sse2", "sse3", "slow_ssse3", "sse4.1", "avx", "avx2", "neon",
+    };
+
+    std::string paths;
+
+    for (int i = 0, e = int(sizeof FEATURES / sizeof FEATURES[0]); i < e; ++i)
+    {
+        if (VP8GetCPUInfo != nullptr && VP8GetCPUInfo(i))
+            paths += (paths.empty() ? "" : " ") + std::string(FEATURES[i]);
+    }
+
+    aedi::Info("webp_simd", "%s", paths.empty() ? "none" : paths.c_str());
+}
+
+// Brick wall with noise, transparent holes are added for image with alpha
+static std::vector<uint8_t> MakeTexture(bool alpha)
+{
+    std::vector<uint8_t> texture(size_t(WIDTH) * HEIGHT * 4);
+    uint32_t state = 0xBEEF;
+
+    for (int y = 0; y < HEIGHT; ++y)
+    {
+        for (int x = 0; x < WIDTH; ++x)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+
+            const int row = y / 32;
+            const bool mortar = y % 32 < 3 || (x + (row & 1) * 32) % 64 < 3;
+            const int noise = int(state % 32);
+
+            uint8_t* pixel = &texture[(size_t(y) * WIDTH + x) * 4];
+            pixel[0] = uint8_t(mortar ? 160 + noise : 140 + noise + row % 3 * 10);
+            pixel[1] = uint8_t(mortar ? 150 + noise : 60 + noise);
+            pixel[2] = uint8_t(mortar ? 140 + noise : 40 + noise);
+
+            const int dx = x % 128 - 64, dy = y % 128 - 64;
+            pixel[3] = uint8_t(alpha && dx * dx + dy * dy < 24 * 24 ? 0 : 255);
+        }
+    }
+
+    return texture;
+}
+
+int main()
+{
+    const int version = WebPGetDecoderVersion();
+    aedi::Info("webp_version", "%d.%d.%d", version >> 16, (version >> 8) & 0xFF, version & 0xFF);
+    aedi::PrintCpuFeatures();
+    PrintSimdPaths();
+
+    const std::vector<uint8_t> opaque = MakeTexture(false);
+    const std::vector<uint8_t> transparent = MakeTexture(true);
+
+    constexpr int STRIDE = WIDTH * 4;
+
+    const struct
+    {
+        const char* name;
+        size_t (*encode)(const uint8_t*, int, int, int, uint8_t**);
+        const std::vector<uint8_t>& pixels;
+    }
+    IMAGES[] =
+    {
+        { "lossy", [](const uint8_t* rgba, int width, int height, int stride, uint8_t** output)
+            { return WebPEncodeRGBA(rgba, width, height, stride, 75, output); }, opaque },
+        { "lossless", WebPEncodeLosslessRGBA, opaque },
+        { "alpha", [](const uint8_t* rgba, int width, int height, int stride, uint8_t** output)
+            { return WebPEncodeRGBA(rgba, width, height, stride, 75, output); }, transparent },
+    };
+
+    std::vector<uint8_t> output(size_t(STRIDE) * HEIGHT);
+
+    for (const auto& image : IMAGES)
+    {
+        uint8_t* encoded_data = nullptr;
+        const size_t encoded_size = image.encode(image.pixels.data(), WIDTH, HEIGHT, STRIDE, &encoded_data);
+        AEDI_EXPECT(encoded_size > 0);
+
+        const std::vector<uint8_t> encoded(encoded_data, encoded_data + encoded_size);
+        WebPFree(encoded_data);
+
+        aedi::Info(aedi::Format("size/%s", image.name).c_str(), "%zu", encoded_size);
+
+        AEDI_BENCH(aedi::Format("decode/%s", image.name), Pixels, WIDTH * HEIGHT)
+        {
+            int width = 0, height = 0;
+            uint8_t* decoded = WebPDecodeRGBA(encoded.data(), encoded.size(), &width, &height);
+            AEDI_EXPECT(decoded != nullptr);
+            WebPFree(decoded);
+        }
+
+        AEDI_BENCH(aedi::Format("decode_into/%s", image.name), Pixels, WIDTH * HEIGHT)
+        {
+            AEDI_EXPECT(WebPDecodeRGBAInto(encoded.data(), encoded.size(), output.data(), output.size(), STRIDE));
+        }
+
+        AEDI_BENCH(aedi::Format("incremental/%s", image.name), Pixels, WIDTH * HEIGHT)
+        {
+            WebPIDecoder* decoder = WebPINewRGB(MODE_RGBA, output.data(), output.size(), STRIDE);
+            AEDI_EXPECT(decoder != nullptr);
+
+            VP8StatusCode status = VP8_STATUS_SUSPENDED;
+
+            for (size_t offset = 0; offset < encoded.size() && status == VP8_STATUS_SUSPENDED; offset += CHUNK_SIZE)
+            {
+                const size_t size = std::min(CHUNK_SIZE, encoded.size() - offset);
+                status = WebPIAppend(decoder, &encoded[offset], size);
+            }
+
+            WebPIDelete(decoder);
+            AEDI_EXPECT(status == VP8_STATUS_OK);
+        }
+
+        // Lossless decoding must reproduce the original
+        if (image.encode == WebPEncodeLosslessRGBA)
+            AEDI_EXPECT(output == image.pixels);
+    }
+
+    return 0;
+}
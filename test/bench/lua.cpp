@@ -0,0 +1,13 @@
+#include "lua_workloads.h"
+
+// Reference interpreter for LuaJIT benchmark, both run the same workloads, see lua_workloads.h
+
+int main()
+{
+    aedi::Info("lua_version", "%s", LUA_RELEASE);
+    aedi::PrintCpuFeatures();
+
+    MeasureLuaWorkloads("interpreter");
+
+    return 0;
+}
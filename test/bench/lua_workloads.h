@@ -0,0 +1,102 @@
+#include <lua.hpp>
+
+// Script workloads shared by Lua and LuaJIT benchmarks, every one is written for Lua 5.1 syntax and library,
+// so both interpreters run exactly the same code through the same embedding API
+// Chunk is compiled once, then its function is called with iteration count, and returns a checksum
+
+struct LuaWorkload
+{
+    const char* name;
+    int iterations;
+    const char* source;
+};
+
+static const LuaWorkload LUA_WORKLOADS[] =
+{
+    // Function calls and integer arithmetic
+    { "fib", 10, R"lua(
+        local n = ...
+        local function fib(n) if n < 2 then return n end return fib(n - 1) + fib(n - 2) end
+        local sum = 0
+        for i = 1, n do sum = sum + fib(24) end
+        return sum
+    )lua" },
+
+    // Floating point math of actor movement, like thinkers of script heavy mods
+    { "actors", 1000, R"lua(
+        local n = ...
+        local actors = {}
+        for i = 1, 256 do actors[i] = { x = i, y = -i, z = 0, vx = 1.5, vy = 0.5, vz = 2.0 } end
+        local sum = 0
+        for step = 1, n do
+            for i = 1, #actors do
+                local a = actors[i]
+                a.x, a.y, a.z = a.x + a.vx, a.y + a.vy, a.z + a.vz
+                a.vz = a.vz - 0.125
+                if a.z < 0 then a.z = 0; a.vz = -a.vz * 0.5 end
+                sum = sum + math.sqrt(a.x * a.x + a.y * a.y)
+            end
+        end
+        return math.floor(sum)
+    )lua" },
+
+    // Table inserts and lookups by string keys
+    { "tables", 100, R"lua(
+        local n = ...
+        local sum = 0
+        for step = 1, n do
+            local t = {}
+            for i = 1, 1000 do t["key" .. i] = i end
+            for i = 1, 1000, 7 do sum = sum + t["key" .. i] end
+        end
+        return sum
+    )lua" },
+
+    // String building and pattern matching, like parsing of text lumps
+    { "strings", 100, R"lua(
+        local n = ...
+        local sum = 0
+        for step = 1, n do
+            local parts = {}
+            for i = 1, 200 do parts[#parts + 1] = "Actor" .. i .. " : Health " .. (i * 3) end
+            local text = table.concat(parts, "\n")
+            for value in text:gmatch("Health (%d+)") do sum = sum + tonumber(value) end
+        end
+        return sum
+    )lua" },
+};
+
+// Setup function is called for new state after standard libraries are opened, e.g. to switch JIT compiler mode
+static void MeasureLuaWorkloads(const char* engine, void (*setup)(lua_State*) = nullptr)
+{
+    lua_State* state = luaL_newstate();
+    AEDI_EXPECT(state != nullptr);
+
+    luaL_openlibs(state);
+
+    if (setup)
+        setup(state);
+
+    for (const LuaWorkload& workload : LUA_WORKLOADS)
+    {
+        AEDI_EXPECT(luaL_loadstring(state, workload.source) == 0);
+
+        // Chunk stays on the stack, and a copy of it is called every time
+        lua_Number checksum = 0;
+
+        AEDI_BENCH(aedi::Format("%s/%s", engine, workload.name), Operations, workload.iterations)
+        {
+            lua_pushvalue(state, -1);
+            lua_pushinteger(state, workload.iterations);
+            AEDI_EXPECT(lua_pcall(state, 1, 1, 0) == 0);
+
+            checksum = lua_tonumber(state, -1);
+            lua_pop(state, 1);
+        }
+
+        aedi::Info(aedi::Format("checksum/%s/%s", engine, workload.name).c_str(), "%.0f", double(checksum));
+        lua_pop(state, 1);
+    }
+
+    lua_close(state);
+}
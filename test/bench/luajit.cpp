@@ -0,0 +1,26 @@
+#include "lua_workloads.h"
+
+// The same workloads as Lua benchmark runs, with JIT compiler and with interpreter only, see lua_workloads.h
+// Interpreter of LuaJIT is faster than PUC Lua one too, so both modes are compared with the reference
+
+static void EnableJit(lua_State* state)
+{
+    // Switching fails when machine code area cannot be made executable, e.g. on arm64 without MAP_JIT
+    AEDI_EXPECT(luaJIT_setmode(state, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_ON) == 1);
+}
+
+static void DisableJit(lua_State* state)
+{
+    AEDI_EXPECT(luaJIT_setmode(state, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_OFF) == 1);
+}
+
+int main()
+{
+    aedi::Info("luajit_version", "%s", LUAJIT_VERSION);
+    aedi::PrintCpuFeatures();
+
+    MeasureLuaWorkloads("jit", EnableJit);
+    MeasureLuaWorkloads("interpreter", DisableJit);
+
+    return 0;
+}
@@ -0,0 +1,301 @@
+// pkg-config: libmpg123 mad sndfile
+#include <math.h>
+#include <mad.h>
+#include <mpg123.h>
+#include <sndfile.h>
+
+#include <string>
+#include <vector>
+
+// MP3 decoding by mpg123, with every decoder core it supports on the running CPU, and by libmad
+//
+// Files are encoded in memory by libsndfile with LAME, every repetition decodes the whole file to 16-bit PCM
+// Decoder core that mpg123 selects by itself is verified to be the optimized one for the running architecture
+
+static constexpr int DURATION = 10;  // seconds
+
+struct MemoryFile
+{
+    std::vector<unsigned char> data;
+    sf_count_t position = 0;
+};
+
+static SF_VIRTUAL_IO MEMORY_IO =
+{
+    [](void* user_data) { return sf_count_t(static_cast<MemoryFile*>(user_data)->data.size()); },
+    [](sf_count_t offset, int whence, void* user_data)
+    {
+        MemoryFile* file = static_cast<MemoryFile*>(user_data);
+
+        if (whence == SEEK_CUR)
+            offset += file->position;
+        else if (whence == SEEK_END)
+            offset += sf_count_t(file->data.size());
+
+        file->position = offset;
+        return offset;
+    },
+    [](void*, sf_count_t, void*) { return sf_count_t(0); },  // read, not used for encoding
+    [](const void* buffer, sf_count_t count, void* user_data)
+    {
+        MemoryFile* file = static_cast<MemoryFile*>(user_data);
+        const size_t end = size_t(file->position + count);
+
+        if (file->data.size() < end)
+            file->data.resize(end);
+
+        memcpy(&file->data[size_t(file->position)], buffer, size_t(count));
+        file->position += count;
+
+        return count;
+    },
+    [](void* user_data) { return static_cast<MemoryFile*>(user_data)->position; },
+};
+
+// Chord with vibrato and some noise, channels are slightly different
+static std::vector<float> MakeSignal(int rate, int channels)
+{
+    std::vector<float> signal(size_t(rate) * DURATION * channels);
+    uint32_t state = 0x3A3A;
+
+    for (size_t i = 0, e = signal.size() / channels; i < e; ++i)
+    {
+        const double time = double(i) / rate;
+        const double vibrato = 1 + 0.003 * sin(2 * M_PI * 5 * time);
+
+        for (int channel = 0; channel < channels; ++channel)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+
+            const double chord = sin(2 * M_PI * 220 * vibrato * time) + 0.6 * sin(2 * M_PI * 277.18 * time + channel)
+                + 0.4 * sin(2 * M_PI * 329.63 * vibrato * time);
+            const double noise = double(state) / UINT32_MAX - 0.5;
+            signal[i * channels + channel] = float(chord * 0.25 + noise * 0.05);
+        }
+    }
+
+    return signal;
+}
+
+static std::vector<unsigned char> Encode(int rate, int channels, int bitrate_mode, double compression)
+{
+    MemoryFile file;
+
+    SF_INFO info = {};
+    info.samplerate = rate;
+    info.channels = channels;
+    info.format = SF_FORMAT_MPEG | SF_FORMAT_MPEG_LAYER_III;
+
+    SNDFILE* sndfile = sf_open_virtual(&MEMORY_IO, SFM_WRITE, &info, &file);
+
+    if (sndfile == nullptr)
+        return {};
+
+    sf_command(sndfile, SFC_SET_BITRATE_MODE, &bitrate_mode, sizeof bitrate_mode);
+    sf_command(sndfile, SFC_SET_COMPRESSION_LEVEL, &compression, sizeof compression);
+
+    const std::vector<float> signal = MakeSignal(rate, channels);
+    const sf_count_t frames = sf_count_t(signal.size() / channels);
+    const bool written = sf_writef_float(sndfile, signal.data(), frames) == frames;
+
+    if (sf_close(sndfile) != 0 || !written)
+        return {};
+
+    return std::move(file.data);
+}
+
+// Decodes the whole file, returns number of sample frames
+static size_t DecodeMpg123(mpg123_handle* handle, const std::vector<unsigned char>& data, int channels,
+    std::vector<int16_t>& output)
+{
+    if (mpg123_open_feed(handle) != MPG123_OK || mpg123_feed(handle, data.data(), data.size()) != MPG123_OK)
+        return 0;
+
+    const size_t capacity = output.size() * sizeof output[0];
+    unsigned char* const buffer = reinterpret_cast<unsigned char*>(output.data());
+    size_t size = 0;
+    int result;
+
+    do
+    {
+        size_t done = 0;
+        result = mpg123_read(handle, buffer + size, std::min(capacity - size, size_t(64 * 1024)), &done);
+        size += done;
+    }
+    while ((result == MPG123_OK || result == MPG123_NEW_FORMAT) && size < capacity);
+
+    mpg123_close(handle);
+
+    // With feeding, the end of data is reported as the need for more of it
+    return result == MPG123_NEED_MORE || result == MPG123_DONE ? size / sizeof output[0] / channels : 0;
+}
+
+// The same rounding and clipping as madplay does
+static int16_t MadScale(mad_fixed_t sample)
+{
+    sample += 1L << (MAD_F_FRACBITS - 16);
+
+    if (sample >= MAD_F_ONE)
+        sample = MAD_F_ONE - 1;
+    else if (sample < -MAD_F_ONE)
+        sample = -MAD_F_ONE;
+
+    return int16_t(sample >> (MAD_F_FRACBITS + 1 - 16));
+}
+
+// Decodes the whole file, input must be padded with MAD_BUFFER_GUARD zero bytes, returns number of sample frames
+static size_t DecodeMad(const std::vector<unsigned char>& data, std::vector<int16_t>& output)
+{
+    mad_stream stream;
+    mad_frame frame;
+    mad_synth synth;
+
+    mad_stream_init(&stream);
+    mad_frame_init(&frame);
+    mad_synth_init(&synth);
+
+    mad_stream_buffer(&stream, data.data(), data.size());
+
+    size_t size = 0;
+    unsigned channels = 0;
+
+    while (true)
+    {
+        if (mad_frame_decode(&frame, &stream) != 0)
+        {
+            if (MAD_RECOVERABLE(stream.error))
+                continue;
+
+            break;
+        }
+
+        mad_synth_frame(&synth, &frame);
+
+        channels = synth.pcm.channels;
+        const unsigned length = std::min(unsigned(synth.pcm.length), unsigned((output.size() - size) / channels));
+
+        for (unsigned i = 0; i < length; ++i)
+        {
+            for (unsigned channel = 0; channel < channels; ++channel)
+                output[size++] = MadScale(synth.pcm.samples[channel][i]);
+        }
+    }
+
+    const bool finished = stream.error == MAD_ERROR_BUFLEN;
+
+    mad_synth_finish(&synth);
+    mad_frame_finish(&frame);
+    mad_stream_finish(&stream);
+
+    return finished && channels > 0 ? size / channels : 0;
+}
+
+static mpg123_handle* CreateMpg123(const char* decoder, int rate, int channels)
+{
+    mpg123_handle* handle = mpg123_new(decoder, nullptr);
+
+    if (handle == nullptr)
+        return nullptr;
+
+    // The only output format, so all cores are measured with the same synthesis routine kind
+    mpg123_param(handle, MPG123_FLAGS, MPG123_QUIET, 0);
+    mpg123_format_none(handle);
+    mpg123_format(handle, rate, channels, MPG123_ENC_SIGNED_16);
+
+    return handle;
+}
+
+int main()
+{
+    unsigned major = 0, minor = 0, patch = 0;
+    mpg123_distversion(&major, &minor, &patch);
+    aedi::Info("mpg123_version", "%u.%u.%u", major, minor, patch);
+    aedi::Info("mad_version", "%s", mad_version);
+
+    std::string supported;
+
+    for (const char** decoder = mpg123_supported_decoders(); *decoder != nullptr; ++decoder)
+        supported += (supported.empty() ? "" : " ") + std::string(*decoder);
+
+    aedi::Info("mpg123_supported_decoders", "%s", supported.c_str());
+
+    static const struct
+    {
+        const char* name;
+        int rate;
+        int channels;
+        int bitrate_mode;
+        double compression;
+    }
+    FILES[] =
+    {
+        { "music_44k_stereo_cbr", 44100, 2, SF_BITRATE_MODE_CONSTANT, 0.5 },
+        { "music_48k_stereo_vbr", 48000, 2, SF_BITRATE_MODE_VARIABLE, 0.0 },
+        { "sfx_22k_mono_cbr", 22050, 1, SF_BITRATE_MODE_CONSTANT, 0.7 },
+    };
+
+    bool verified = false;
+
+    for (const auto& file : FILES)
+    {
+        std::vector<unsigned char> data = Encode(file.rate, file.channels, file.bitrate_mode, file.compression);
+        AEDI_EXPECT(!data.empty());
+        aedi::Info(aedi::Format("size/%s", file.name).c_str(), "%zu", data.size());
+
+        // Extra second for encoder delay and padding
+        std::vector<int16_t> output(size_t(file.rate) * (DURATION + 1) * file.channels);
+        const size_t minimum_frames = size_t(file.rate) * (DURATION - 1);
+
+        // Selection of decoder core happens at handle creation, and it's checked once
+        if (!verified)
+        {
+            mpg123_handle* handle = CreateMpg123(nullptr, file.rate, file.channels);
+            AEDI_EXPECT(handle != nullptr);
+            AEDI_EXPECT(DecodeMpg123(handle, data, file.channels, output) >= minimum_frames);
+
+            const char* const decoder = mpg123_current_decoder(handle);
+            AEDI_EXPECT(decoder != nullptr);
+            aedi::Info("mpg123_decoder", "%s", decoder);
+
+#if defined(__aarch64__)
+            AEDI_EXPECT(strcmp(decoder, "NEON64") == 0);
+#elif defined(__x86_64__)
+            // Rosetta doesn't implement AVX before macOS 15, so it's required only when the CPU reports it
+            AEDI_EXPECT(strcmp(decoder, __builtin_cpu_supports("avx") ? "AVX" : "x86-64") == 0);
+#endif
+
+            mpg123_delete(handle);
+            verified = true;
+        }
+
+        for (const char** decoder = mpg123_supported_decoders(); *decoder != nullptr; ++decoder)
+        {
+            mpg123_handle* handle = CreateMpg123(*decoder, file.rate, file.channels);
+            AEDI_EXPECT(handle != nullptr);
+
+            const size_t frames = DecodeMpg123(handle, data, file.channels, output);
+            AEDI_EXPECT(frames >= minimum_frames);
+
+            AEDI_BENCH(aedi::Format("decode/mpg123/%s/%s", *decoder, file.name), Samples, frames)
+            {
+                AEDI_EXPECT(DecodeMpg123(handle, data, file.channels, output) == frames);
+            }
+
+            mpg123_delete(handle);
+        }
+
+        data.insert(data.end(), MAD_BUFFER_GUARD, 0);
+
+        const size_t frames = DecodeMad(data, output);
+        AEDI_EXPECT(frames >= minimum_frames);
+
+        AEDI_BENCH(aedi::Format("decode/mad/%s", file.name), Samples, frames)
+        {
+            AEDI_EXPECT(DecodeMad(data, output) == frames);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,252 @@
+#define AL_ALEXT_PROTOTYPES
+
+#include <ctype.h>
+#include <math.h>
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+
+// Positional sound mixing by OpenAL Soft, rendered to loopback device without actual output
+//
+// Every repetition mixes one block, sources have different pitches and positions around the listener
+// Sound rate differs from device rate, so every source goes through the resampler
+//
+// Device reopening with context creation is measured too, like audio reset of a game does it,
+// HRTF data set is loaded and resampled to device rate on every reopening unless built with --openal-fast-init
+
+static constexpr int DEVICE_RATE = 48000;
+static constexpr int SOUND_RATE = 44100;
+static constexpr int BLOCK_SIZE = 1024;  // sample frames
+static constexpr int BLOCK_COUNT = 500;
+static constexpr int MAX_SOURCES = 256;
+
+// Mixers are template functions specialized with instruction set tag types
+static void PrintLinkedMixers(const char* path)
+{
+    static const char* const TAGS[] = { "SSETag", "SSE2Tag", "SSE3Tag", "SSE4Tag", "NEONTag" };
+
+    std::set<std::string> found;
+
+    for (const std::string& symbol : aedi::LinkedSymbols(path))
+    {
+        for (const char* tag : TAGS)
+        {
+            if (symbol.find(tag) != std::string::npos)
+                found.insert(std::string(tag, strlen(tag) - 3));
+        }
+    }
+
+    std::string mixers;
+
+    for (const std::string& name : found)
+        mixers += (mixers.empty() ? "" : " ") + name;
+
+    aedi::Info("openal_simd_mixers", "%s", mixers.empty() ? "none" : mixers.c_str());
+}
+
+// Resampler names are descriptive, e.g. "11th order Sinc (fast)", so they're turned into identifiers for benchmark names
+static std::string Identifier(const char* name)
+{
+    std::string result;
+
+    for (const char* ch = name; *ch != '\0'; ++ch)
+    {
+        if (isalnum(static_cast<unsigned char>(*ch)))
+            result += char(tolower(static_cast<unsigned char>(*ch)));
+        else if (!result.empty() && result.back() != '_')
+            result += '_';
+    }
+
+    while (!result.empty() && result.back() == '_')
+        result.pop_back();
+
+    return result;
+}
+
+// Engine-like noise with tonal component, one second long
+static std::vector<int16_t> MakeSound()
+{
+    std::vector<int16_t> sound(SOUND_RATE);
+    uint32_t state = 0xABCD;
+
+    for (size_t i = 0; i < sound.size(); ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        const double tone = sin(2 * M_PI * 110 * i / SOUND_RATE) + 0.5 * sin(2 * M_PI * 330 * i / SOUND_RATE);
+        const double noise = double(state) / UINT32_MAX - 0.5;
+        sound[i] = int16_t((tone * 0.3 + noise * 0.2) * 32767);
+    }
+
+    return sound;
+}
+
+// Loopback device goes through the same context creation as playback one, playback device is opened if available
+static void MeasureReopening(bool loopback, bool hrtf)
+{
+    const ALCint loopback_attributes[] =
+    {
+        ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+        ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+        ALC_FREQUENCY, DEVICE_RATE,
+        ALC_HRTF_SOFT, hrtf ? ALC_TRUE : ALC_FALSE,
+        0
+    };
+    const ALCint playback_attributes[] =
+    {
+        ALC_FREQUENCY, DEVICE_RATE,
+        ALC_HRTF_SOFT, hrtf ? ALC_TRUE : ALC_FALSE,
+        0
+    };
+
+    const auto Open = [loopback]
+    {
+        return loopback ? alcLoopbackOpenDeviceSOFT(nullptr) : alcOpenDevice(nullptr);
+    };
+
+    const std::string name = aedi::Format("reopen/%s/%s", loopback ? "loopback" : "playback", hrtf ? "hrtf" : "stereo");
+    const auto start = std::chrono::steady_clock::now();
+
+    ALCdevice* device = Open();
+
+    if (device == nullptr)
+    {
+        aedi::Info(name.c_str(), "skipped, no output device");
+        return;
+    }
+
+    ALCcontext* context = alcCreateContext(device, loopback ? loopback_attributes : playback_attributes);
+    AEDI_EXPECT(context != nullptr);
+    const auto first = std::chrono::steady_clock::now() - start;
+
+    alcDestroyContext(context);
+    AEDI_EXPECT(alcCloseDevice(device));
+
+    // The first opening includes one-time initialization of the library, backend and loaded data sets
+    aedi::Info((name + "/first_us").c_str(), "%lld",
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(first).count()));
+
+    AEDI_BENCH(name, Operations, 1)
+    {
+        device = Open();
+        AEDI_EXPECT(device != nullptr);
+
+        context = alcCreateContext(device, loopback ? loopback_attributes : playback_attributes);
+        AEDI_EXPECT(context != nullptr);
+
+        alcDestroyContext(context);
+        AEDI_EXPECT(alcCloseDevice(device));
+    }
+}
+
+int main(int, char** argv)
+{
+    PrintLinkedMixers(argv[0]);
+    aedi::PrintCpuFeatures();
+
+    AEDI_EXPECT(alcIsExtensionPresent(nullptr, "ALC_SOFT_loopback"));
+
+    for (bool loopback : { true, false })
+    {
+        for (bool hrtf : { true, false })
+            MeasureReopening(loopback, hrtf);
+    }
+
+    ALCdevice* device = alcLoopbackOpenDeviceSOFT(nullptr);
+    AEDI_EXPECT(device != nullptr);
+    AEDI_EXPECT(alcIsRenderFormatSupportedSOFT(device, DEVICE_RATE, ALC_STEREO_SOFT, ALC_FLOAT_SOFT));
+
+    const std::vector<int16_t> sound = MakeSound();
+    std::vector<float> output(BLOCK_SIZE * 2);
+
+    for (bool hrtf : { false, true })
+    {
+        const ALCint attributes[] =
+        {
+            ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+            ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+            ALC_FREQUENCY, DEVICE_RATE,
+            ALC_MONO_SOURCES, MAX_SOURCES,
+            ALC_HRTF_SOFT, hrtf ? ALC_TRUE : ALC_FALSE,
+            0
+        };
+
+        ALCcontext* context = alcCreateContext(device, attributes);
+        AEDI_EXPECT(context != nullptr);
+        AEDI_EXPECT(alcMakeContextCurrent(context));
+
+        ALCint hrtf_status = ALC_FALSE;
+        alcGetIntegerv(device, ALC_HRTF_SOFT, 1, &hrtf_status);
+
+        if (hrtf && hrtf_status != ALC_TRUE)
+        {
+            // Build without HRTF data, nothing to measure
+            aedi::Info("hrtf", "unavailable");
+            alcMakeContextCurrent(nullptr);
+            alcDestroyContext(context);
+            break;
+        }
+
+        ALuint buffer = 0;
+        alGenBuffers(1, &buffer);
+        alBufferData(buffer, AL_FORMAT_MONO16, sound.data(), ALsizei(sound.size() * sizeof sound[0]), SOUND_RATE);
+
+        const ALint resampler_count = alGetInteger(AL_NUM_RESAMPLERS_SOFT);
+
+        for (int source_count : { 32, 128, 256 })
+        {
+            std::vector<ALuint> sources(source_count);
+            alGenSources(source_count, sources.data());
+            AEDI_EXPECT(alGetError() == AL_NO_ERROR);
+
+            for (int i = 0; i < source_count; ++i)
+            {
+                const double angle = 2 * M_PI * i / source_count;
+                const float distance = 2.0f + i % 8;
+
+                alSourcei(sources[i], AL_BUFFER, ALint(buffer));
+                alSourcei(sources[i], AL_LOOPING, AL_TRUE);
+                alSourcef(sources[i], AL_PITCH, 0.8f + 0.4f * i / source_count);
+                alSource3f(sources[i], AL_POSITION, float(sin(angle) * distance), 0.0f, float(-cos(angle) * distance));
+            }
+
+            for (ALint resampler = 0; resampler < resampler_count; ++resampler)
+            {
+                for (ALuint source : sources)
+                    alSourcei(source, AL_SOURCE_RESAMPLER_SOFT, resampler);
+
+                alSourcePlayv(source_count, sources.data());
+                AEDI_EXPECT(alGetError() == AL_NO_ERROR);
+
+                const std::string name = aedi::Format("mix/%s/sources%d/%s", hrtf ? "hrtf" : "stereo", source_count,
+                    Identifier(alGetStringiSOFT(AL_RESAMPLER_NAME_SOFT, resampler)).c_str());
+
+                AEDI_BENCH_COUNT(name, Samples, BLOCK_SIZE, BLOCK_COUNT)
+                {
+                    alcRenderSamplesSOFT(device, output.data(), BLOCK_SIZE);
+                }
+
+                alSourceStopv(source_count, sources.data());
+            }
+
+            alDeleteSources(source_count, sources.data());
+        }
+
+        alDeleteBuffers(1, &buffer);
+        AEDI_EXPECT(alGetError() == AL_NO_ERROR);
+
+        alcMakeContextCurrent(nullptr);
+        alcDestroyContext(context);
+    }
+
+    AEDI_EXPECT(alcCloseDevice(device));
+
+    return 0;
+}
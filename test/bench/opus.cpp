@@ -0,0 +1,163 @@
+#include <math.h>
+#include <opus.h>
+
+#include <set>
+
+// Encoding and decoding cost of voice and music streams
+//
+// Every repetition processes one frame, so p99 is per-frame latency
+// Real-time factor is duration of the whole stream divided by time spent on it, e.g. 100 means 1% of one core
+
+static constexpr int SAMPLE_RATE = 48000;
+static constexpr int CHANNELS = 2;
+static constexpr int DURATION = 60;  // seconds
+static constexpr int MAX_PACKET_SIZE = 1276 * 3;
+
+// Intrinsic functions are suffixed with instruction set name, their presence in the executable shows what paths
+// were compiled in, and CPU features show which of them can be selected at runtime
+static std::string LinkedIntrinsics(const char* path)
+{
+#if defined(__aarch64__)
+    static const char* const SUFFIXES[] = { "_neon", "_dotprod" };
+#elif defined(__x86_64__)
+    static const char* const SUFFIXES[] = { "_sse", "_sse2", "_sse4_1", "_avx", "_avx2" };
+#endif
+
+    std::set<std::string> found;
+
+    for (const std::string& symbol : aedi::LinkedSymbols(path))
+    {
+        for (const char* suffix : SUFFIXES)
+        {
+            const size_t suffix_length = strlen(suffix);
+
+            if (symbol.size() > suffix_length && symbol.compare(symbol.size() - suffix_length, suffix_length, suffix) == 0)
+                found.insert(suffix + 1);
+        }
+    }
+
+    std::string intrinsics;
+
+    for (const std::string& name : found)
+        intrinsics += (intrinsics.empty() ? "" : " ") + name;
+
+    return intrinsics.empty() ? "none" : intrinsics;
+}
+
+// Music-like signal, chord with vibrato and noise, channels differ to prevent joint stereo collapsing them
+static std::vector<float> MakeSignal()
+{
+    std::vector<float> signal(size_t(SAMPLE_RATE) * DURATION * CHANNELS);
+    uint32_t state = 0x12345678;
+
+    for (size_t i = 0, e = signal.size() / CHANNELS; i < e; ++i)
+    {
+        const double time = double(i) / SAMPLE_RATE;
+        const double vibrato = 1.0 + 0.005 * sin(2 * M_PI * 5 * time);
+
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        const double noise = (double(state) / UINT32_MAX - 0.5) * 0.02;
+
+        const double left = 0.3 * sin(2 * M_PI * 220 * vibrato * time) + 0.2 * sin(2 * M_PI * 277.18 * time);
+        const double right = 0.3 * sin(2 * M_PI * 329.63 * vibrato * time) + 0.2 * sin(2 * M_PI * 440 * time);
+
+        signal[i * CHANNELS] = float(left + noise);
+        signal[i * CHANNELS + 1] = float(right - noise);
+    }
+
+    return signal;
+}
+
+int main(int, char** argv)
+{
+    aedi::Info("opus_version", "%s", opus_get_version_string());
+    aedi::PrintCpuFeatures();
+
+    const std::string intrinsics = LinkedIntrinsics(argv[0]);
+    aedi::Info("opus_intrinsics", "%s", intrinsics.c_str());
+
+    // Both slices are configured with intrinsics, x86_64 one selects SSE4.1 and AVX2 paths at runtime
+    const std::string names = ' ' + intrinsics + ' ';
+
+#if defined(__aarch64__)
+    AEDI_EXPECT(names.find(" neon ") != std::string::npos);
+#elif defined(__x86_64__)
+    AEDI_EXPECT(names.find(" sse4_1 ") != std::string::npos);
+    AEDI_EXPECT(names.find(" avx2 ") != std::string::npos);
+#endif
+
+    const std::vector<float> signal = MakeSignal();
+    std::vector<float> decoded(size_t(SAMPLE_RATE) * 60 / 1000 * CHANNELS);
+
+    // In samples per channel, i.e. 2.5, 5, 10, 20, 40 and 60 ms
+    static const int FRAME_SIZES[] = { 120, 240, 480, 960, 1920, 2880 };
+
+    for (int complexity = 0; complexity <= 10; ++complexity)
+    {
+        for (int frame_size : FRAME_SIZES)
+        {
+            const int frame_count = int(signal.size() / CHANNELS / frame_size);
+            const std::string suffix = aedi::Format("complexity%d/%.1fms", complexity, frame_size * 1000.0 / SAMPLE_RATE);
+
+            int error = OPUS_INVALID_STATE;
+            OpusEncoder* encoder = opus_encoder_create(SAMPLE_RATE, CHANNELS, OPUS_APPLICATION_AUDIO, &error);
+            AEDI_EXPECT(error == OPUS_OK);
+            AEDI_EXPECT(opus_encoder_ctl(encoder, OPUS_SET_COMPLEXITY(complexity)) == OPUS_OK);
+
+            std::vector<std::vector<unsigned char>> packets(frame_count);
+
+            // Warm-up repetitions wrap around, so every frame is encoded at least once after the loop
+            {
+                int frame = 0;
+                aedi::Bench aedi_bench("encode/" + suffix, aedi::Unit::Samples, frame_size, frame_count);
+
+                while (aedi_bench.Next())
+                {
+                    const int index = frame++ % frame_count;
+                    unsigned char packet[MAX_PACKET_SIZE];
+
+                    const opus_int32 size = opus_encode_float(encoder,
+                        &signal[size_t(index) * frame_size * CHANNELS], frame_size, packet, MAX_PACKET_SIZE);
+                    AEDI_EXPECT(size > 0);
+
+                    packets[index].assign(packet, packet + size);
+                }
+
+                aedi::Info(("rtf/encode/" + suffix).c_str(), "%.1f", DURATION * 1e9 / aedi_bench.TotalNanoseconds());
+            }
+
+            opus_encoder_destroy(encoder);
+
+            OpusDecoder* decoder = opus_decoder_create(SAMPLE_RATE, CHANNELS, &error);
+            AEDI_EXPECT(error == OPUS_OK);
+
+            {
+                int frame = 0;
+                aedi::Bench aedi_bench("decode/" + suffix, aedi::Unit::Samples, frame_size, frame_count);
+
+                while (aedi_bench.Next())
+                {
+                    const std::vector<unsigned char>& packet = packets[frame++ % frame_count];
+                    const int samples = opus_decode_float(decoder,
+                        packet.data(), opus_int32(packet.size()), decoded.data(), frame_size, 0);
+                    AEDI_EXPECT(samples == frame_size);
+                }
+
+                aedi::Info(("rtf/decode/" + suffix).c_str(), "%.1f", DURATION * 1e9 / aedi_bench.TotalNanoseconds());
+            }
+
+            opus_decoder_destroy(decoder);
+
+            size_t total_size = 0;
+
+            for (const auto& packet : packets)
+                total_size += packet.size();
+
+            aedi::Info(("bitrate/" + suffix).c_str(), "%.1f kbit/s", total_size * 8.0 / DURATION / 1000);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+// pkg-config: portmidi
+#include <CoreMIDI/CoreMIDI.h>
+#include <math.h>
+#include <portmidi.h>
+#include <porttime.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Latency and jitter of MIDI output, events sent on time by the game loop versus events scheduled by CoreMIDI
+//
+// Events go to virtual CoreMIDI destination of this process at fixed period, its read callback timestamps arrivals
+// With zero latency, events are written when they are due, like ports do in their own timing loops
+// With non-zero latency, all events are written at once with timestamps, and PortMidi converts them to times
+// of MIDIPacketList packets, so delivery on time is up to CoreMIDI, scheduled times are verified to match periods
+// Latency is median delay of arrival after due time, excluding requested latency, jitter is 99th percentile
+// of arrival deviation from the median, every mode is measured on idle system and with busy threads on all cores
+
+static constexpr int EVENT_COUNT = 200;
+static constexpr int PERIOD_MS = 5;
+static constexpr int LATENCIES_MS[] = { 0, 10, 50 };
+
+static const char* const DESTINATION_NAME = "aedi bench";
+
+struct Arrivals
+{
+    uint64_t times[EVENT_COUNT];
+    MIDITimeStamp stamps[EVENT_COUNT];
+    std::atomic<int> count;
+};
+
+static Arrivals arrivals;
+
+static void ReadCallback(const MIDIPacketList* list, void*, void*)
+{
+    const uint64_t now = mach_absolute_time();
+    const MIDIPacket* packet = &list->packet[0];
+
+    for (UInt32 i = 0; i < list->numPackets; ++i)
+    {
+        // CoreMIDI may coalesce several note on messages into one packet
+        for (UInt16 offset = 0; offset + 3 <= packet->length; offset += 3)
+        {
+            const int index = arrivals.count.load(std::memory_order_relaxed);
+
+            if (index < EVENT_COUNT)
+            {
+                arrivals.times[index] = now;
+                arrivals.stamps[index] = packet->timeStamp;
+                arrivals.count.store(index + 1, std::memory_order_release);
+            }
+        }
+
+        packet = MIDIPacketNext(packet);
+    }
+}
+
+static mach_timebase_info_data_t timebase;
+
+static uint64_t MillisecondsToTicks(int64_t milliseconds)
+{
+    return uint64_t(milliseconds * 1000000 * timebase.denom / timebase.numer);
+}
+
+// Host time that corresponds to zero time of PortTime, which counts milliseconds since Pt_Start()
+static uint64_t PortTimeOrigin()
+{
+    // Wait for the next millisecond to begin, so truncation of PortTime doesn't skew the origin
+    const PtTimestamp start = Pt_Time();
+
+    while (Pt_Time() == start)
+        ;
+
+    return mach_absolute_time() - MillisecondsToTicks(Pt_Time());
+}
+
+static PmDeviceID FindDestination()
+{
+    for (PmDeviceID id = 0; id < Pm_CountDevices(); ++id)
+    {
+        const PmDeviceInfo* info = Pm_GetDeviceInfo(id);
+
+        if (info->output && strcmp(info->name, DESTINATION_NAME) == 0)
+            return id;
+    }
+
+    return pmNoDevice;
+}
+
+static void Measure(PmDeviceID device, int latency, bool loaded)
+{
+    PortMidiStream* stream = nullptr;
+    AEDI_EXPECT(Pm_OpenOutput(&stream, device, nullptr, EVENT_COUNT, nullptr, nullptr, latency) == pmNoError);
+
+    std::atomic<bool> running(loaded);
+    std::vector<std::thread> load;
+
+    if (loaded)
+    {
+        for (unsigned i = 0; i < std::thread::hardware_concurrency(); ++i)
+        {
+            load.emplace_back([&running]
+            {
+                while (running.load(std::memory_order_relaxed))
+                    ;
+            });
+        }
+    }
+
+    arrivals.count.store(0, std::memory_order_release);
+
+    const uint64_t origin = PortTimeOrigin();
+    const PtTimestamp start = Pt_Time() + 10;
+
+    for (int i = 0; i < EVENT_COUNT; ++i)
+    {
+        const PmTimestamp when = start + i * PERIOD_MS;
+
+        if (latency == 0)
+            mach_wait_until(origin + MillisecondsToTicks(when));
+
+        PmEvent event = { Pm_Message(0x90, 60, 64), when };
+        AEDI_EXPECT(Pm_Write(stream, &event, 1) == pmNoError);
+    }
+
+    const PmTimestamp end = start + EVENT_COUNT * PERIOD_MS + latency + 1000;
+
+    while (arrivals.count.load(std::memory_order_acquire) < EVENT_COUNT && Pt_Time() < end)
+        usleep(1000);
+
+    running.store(false, std::memory_order_relaxed);
+
+    for (std::thread& thread : load)
+        thread.join();
+
+    Pm_Close(stream);
+
+    const int count = arrivals.count.load(std::memory_order_acquire);
+    AEDI_EXPECT(count == EVENT_COUNT);
+
+    std::vector<double> delays;
+
+    for (int i = 0; i < count; ++i)
+    {
+        const uint64_t due = origin + MillisecondsToTicks(start + i * PERIOD_MS + latency);
+        delays.push_back(aedi::TicksToNanoseconds(int64_t(arrivals.times[i] - due)) / 1000);
+
+        // Scheduled packets must be apart exactly by event period
+        if (latency != 0 && i != 0)
+        {
+            const int64_t ticks = int64_t(arrivals.stamps[i] - arrivals.stamps[i - 1]);
+            const double interval = aedi::TicksToNanoseconds(ticks) / 1000;
+            AEDI_EXPECT(arrivals.stamps[i] != 0 && fabs(interval - PERIOD_MS * 1000) < 100);
+        }
+    }
+
+    std::vector<double> sorted = delays;
+    std::sort(sorted.begin(), sorted.end());
+    const double median = sorted[sorted.size() / 2];
+
+    std::vector<double> deviations;
+
+    for (double delay : delays)
+        deviations.push_back(fabs(delay - median));
+
+    std::sort(deviations.begin(), deviations.end());
+
+    const std::string suffix = aedi::Format("%s/%d", loaded ? "loaded" : "idle", latency);
+
+    aedi::Info(("latency_us/" + suffix).c_str(), "%.0f", median);
+    aedi::Info(("jitter_us/" + suffix).c_str(), "%.0f", deviations[deviations.size() * 99 / 100]);
+    aedi::Info(("max_delay_us/" + suffix).c_str(), "%.0f", sorted.back());
+}
+
+int main()
+{
+    mach_timebase_info(&timebase);
+
+    MIDIClientRef client = 0;
+    AEDI_EXPECT(MIDIClientCreate(CFSTR("aedi"), nullptr, nullptr, &client) == noErr);
+
+    // Destination must exist before PortMidi enumerates devices
+    CFStringRef name = CFStringCreateWithCString(nullptr, DESTINATION_NAME, kCFStringEncodingUTF8);
+    MIDIEndpointRef destination = 0;
+    AEDI_EXPECT(MIDIDestinationCreate(client, name, ReadCallback, nullptr, &destination) == noErr);
+    CFRelease(name);
+
+    AEDI_EXPECT(Pt_Start(1, nullptr, nullptr) == ptNoError);
+    AEDI_EXPECT(Pm_Initialize() == pmNoError);
+
+    const PmDeviceID device = FindDestination();
+    AEDI_EXPECT(device != pmNoDevice);
+
+    for (bool loaded : { false, true })
+    {
+        for (int latency : LATENCIES_MS)
+            Measure(device, latency, loaded);
+    }
+
+    Pm_Terminate();
+    Pt_Stop();
+
+    MIDIEndpointDispose(destination);
+    MIDIClientDispose(client);
+
+    return 0;
+}
@@ -0,0 +1,304 @@
+#include <dlfcn.h>
+#include <math.h>
+#include <samplerate.h>
+
+#include <string>
+#include <vector>
+
+// Sample rate conversion of music streams with push and pull interfaces of libsamplerate
+//
+// Every repetition converts one block, input wraps around, so the whole stream is converted once per measurement
+// Quality is signal-to-noise ratio of output with test tones fitted to it, it's measured separately without timing
+// Test signal is a sum of tones up to 40 % of source rate, so it stays within passband of all converters
+// Vector kernels of sinc filters are compared with scalar path, outputs must not differ more than SIMD_TOLERANCE
+
+static constexpr int DURATION = 5;  // seconds of input
+static constexpr int BLOCK_SIZE = 512;  // input frames per block
+
+static constexpr double TONES[] = { 0.01, 0.05, 0.12, 0.2, 0.3, 0.4 };  // fractions of source rate
+static constexpr double AMPLITUDE = 0.15;
+
+static constexpr double SIMD_TOLERANCE = 1e-6;
+
+// Not declared in samplerate.h, and exists in patched library only, see patch/samplerate-simd.diff
+using SelectSincSimd = const char* (*)(int enabled);
+
+// Value of the test signal at time in seconds, channels differ in tone phases
+static double Signal(double time, int rate, int channel)
+{
+    double value = 0;
+
+    for (size_t i = 0; i < sizeof TONES / sizeof TONES[0]; ++i)
+        value += AMPLITUDE * sin(2 * M_PI * TONES[i] * rate * time + channel * (i + 1));
+
+    return value;
+}
+
+static std::vector<float> MakeInput(int rate, int channels)
+{
+    const size_t frames = size_t(DURATION) * rate;
+    std::vector<float> input(frames * channels);
+
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        for (int channel = 0; channel < channels; ++channel)
+            input[frame * channels + channel] = float(Signal(double(frame) / rate, rate, channel));
+    }
+
+    return input;
+}
+
+// Converts the whole input at once
+static std::vector<float> Convert(int converter, int channels, double ratio, const std::vector<float>& input)
+{
+    const long input_frames = long(input.size() / channels);
+    std::vector<float> output(size_t(input_frames * ratio + 64) * channels);
+
+    SRC_DATA data = {};
+    data.data_in = input.data();
+    data.data_out = output.data();
+    data.input_frames = input_frames;
+    data.output_frames = long(output.size() / channels);
+    data.src_ratio = ratio;
+
+    if (src_simple(&data, converter, channels) != 0)
+        return {};
+
+    output.resize(size_t(data.output_frames_gen * channels));
+    return output;
+}
+
+// Fits test tones to the middle part of converted input by least squares
+// Residual is noise and distortion, the fit makes result independent of converter delay
+static double MeasureQuality(int converter, int channels, int input_rate, int output_rate, const std::vector<float>& input)
+{
+    const std::vector<float> output = Convert(converter, channels, double(output_rate) / input_rate, input);
+
+    if (output.empty())
+        return 0;
+
+    // Edges are skipped, because filters see silence before and after the signal there
+    const long frames = long(output.size() / channels);
+    const long begin = frames / 10;
+    const long end = frames - begin;
+
+    constexpr int BASIS = sizeof TONES / sizeof TONES[0] * 2;  // cosine and sine of every tone
+    double total = 0, residual = 0;
+
+    for (int channel = 0; channel < channels; ++channel)
+    {
+        double normal[BASIS][BASIS + 1] = {};
+        double energy = 0;
+
+        for (long frame = begin; frame < end; ++frame)
+        {
+            double basis[BASIS];
+
+            for (int i = 0; i < BASIS / 2; ++i)
+            {
+                const double phase = 2 * M_PI * TONES[i] * input_rate * frame / output_rate;
+                basis[i * 2] = cos(phase);
+                basis[i * 2 + 1] = sin(phase);
+            }
+
+            const double value = output[frame * channels + channel];
+            energy += value * value;
+
+            for (int row = 0; row < BASIS; ++row)
+            {
+                for (int column = 0; column < BASIS; ++column)
+                    normal[row][column] += basis[row] * basis[column];
+
+                normal[row][BASIS] += basis[row] * value;
+            }
+        }
+
+        // Gauss-Jordan elimination, normal matrix is symmetric positive definite, so no pivoting is needed
+        double projection[BASIS];
+
+        for (int row = 0; row < BASIS; ++row)
+            projection[row] = normal[row][BASIS];
+
+        for (int pivot = 0; pivot < BASIS; ++pivot)
+        {
+            for (int row = 0; row < BASIS; ++row)
+            {
+                if (row == pivot)
+                    continue;
+
+                const double factor = normal[row][pivot] / normal[pivot][pivot];
+
+                for (int column = pivot; column <= BASIS; ++column)
+                    normal[row][column] -= factor * normal[pivot][column];
+            }
+        }
+
+        double fitted = 0;
+
+        for (int row = 0; row < BASIS; ++row)
+            fitted += normal[row][BASIS] / normal[row][row] * projection[row];
+
+        total += fitted;
+        residual += std::max(energy - fitted, 0.0);
+    }
+
+    return residual > 0 ? 10 * log10(total / residual) : INFINITY;
+}
+
+// Largest difference between outputs of vector kernels and of scalar path, vector ones stay selected
+static double MeasureSimdDifference(SelectSincSimd select, int converter, int channels, double ratio,
+    const std::vector<float>& input)
+{
+    select(0);
+    const std::vector<float> scalar = Convert(converter, channels, ratio, input);
+    select(1);
+    const std::vector<float> vector = Convert(converter, channels, ratio, input);
+
+    if (scalar.empty() || scalar.size() != vector.size())
+        return INFINITY;
+
+    double difference = 0;
+
+    for (size_t i = 0; i < scalar.size(); ++i)
+        difference = std::max(difference, fabs(double(scalar[i]) - vector[i]));
+
+    return difference;
+}
+
+struct Stream
+{
+    const std::vector<float>& input;
+    int channels;
+    long position;
+
+    const float* Next(long frames)
+    {
+        const long total = long(input.size() / channels);
+
+        if (position + frames > total)
+            position = 0;
+
+        const float* block = &input[position * channels];
+        position += frames;
+        return block;
+    }
+};
+
+static long ReadCallback(void* user_data, float** data)
+{
+    Stream* stream = static_cast<Stream*>(user_data);
+    *data = const_cast<float*>(stream->Next(BLOCK_SIZE));
+    return BLOCK_SIZE;
+}
+
+int main()
+{
+    aedi::Info("samplerate_version", "%s", src_get_version());
+
+    const auto select_simd = reinterpret_cast<SelectSincSimd>(dlsym(RTLD_DEFAULT, "src_sinc_simd_select"));
+    aedi::Info("sinc_simd", "%s", select_simd ? select_simd(1) : "unpatched");
+
+    static const struct
+    {
+        const char* name;
+        int type;
+    }
+    CONVERTERS[] =
+    {
+        { "sinc_best", SRC_SINC_BEST_QUALITY },
+        { "sinc_medium", SRC_SINC_MEDIUM_QUALITY },
+        { "sinc_fastest", SRC_SINC_FASTEST },
+        { "linear", SRC_LINEAR },
+    };
+
+    static const struct
+    {
+        int input;
+        int output;
+    }
+    RATES[] =
+    {
+        { 22050, 48000 },
+        { 44100, 48000 },
+        { 11025, 44100 },
+    };
+
+    for (const auto& rates : RATES)
+    {
+        const double ratio = double(rates.output) / rates.input;
+        const int block_count = DURATION * rates.input / BLOCK_SIZE;
+        const long output_block_size = lround(BLOCK_SIZE * ratio);
+
+        for (int channels : { 1, 2 })
+        {
+            const std::vector<float> input = MakeInput(rates.input, channels);
+            std::vector<float> output(size_t(output_block_size + 64) * channels);
+
+            for (const auto& converter : CONVERTERS)
+            {
+                const std::string suffix = aedi::Format("%s/%d-%d/%s", converter.name, rates.input, rates.output,
+                    channels == 1 ? "mono" : "stereo");
+
+                const double snr = MeasureQuality(converter.type, channels, rates.input, rates.output, input);
+                AEDI_EXPECT(snr > 0);
+                aedi::Info(("snr_db/" + suffix).c_str(), "%.1f", snr);
+
+                if (select_simd && converter.type != SRC_LINEAR)
+                {
+                    const double difference =
+                        MeasureSimdDifference(select_simd, converter.type, channels, ratio, input);
+                    aedi::Info(("simd_difference/" + suffix).c_str(), "%.3g", difference);
+                    AEDI_EXPECT(difference <= SIMD_TOLERANCE);
+                }
+
+                // Push interface, input block is given and whatever is ready comes out
+                {
+                    int error = 0;
+                    SRC_STATE* state = src_new(converter.type, channels, &error);
+                    AEDI_EXPECT(state != nullptr);
+
+                    Stream stream = { input, channels, 0 };
+                    SRC_DATA data = {};
+                    data.input_frames = BLOCK_SIZE;
+                    data.data_out = output.data();
+                    data.output_frames = long(output.size() / channels);
+                    data.src_ratio = ratio;
+
+                    aedi::Bench aedi_bench("process/" + suffix, aedi::Unit::Samples, BLOCK_SIZE * ratio, block_count);
+
+                    while (aedi_bench.Next())
+                    {
+                        data.data_in = stream.Next(BLOCK_SIZE);
+                        AEDI_EXPECT(src_process(state, &data) == 0);
+                        aedi::DoNotOptimize(output[0]);
+                    }
+
+                    aedi::Info(("rtf/process/" + suffix).c_str(), "%.1f", DURATION * 1e9 / aedi_bench.TotalNanoseconds());
+                    src_delete(state);
+                }
+
+                // Pull interface, output block is requested and input is fed by callback, as audio output does
+                {
+                    Stream stream = { input, channels, 0 };
+
+                    int error = 0;
+                    SRC_STATE* state = src_callback_new(ReadCallback, converter.type, channels, &error, &stream);
+                    AEDI_EXPECT(state != nullptr);
+
+                    aedi::Bench aedi_bench("callback/" + suffix, aedi::Unit::Samples, double(output_block_size), block_count);
+
+                    while (aedi_bench.Next())
+                    {
+                        AEDI_EXPECT(src_callback_read(state, ratio, output_block_size, output.data()) == output_block_size);
+                        aedi::DoNotOptimize(output[0]);
+                    }
+
+                    aedi::Info(("rtf/callback/" + suffix).c_str(), "%.1f", DURATION * 1e9 / aedi_bench.TotalNanoseconds());
+                    src_delete(state);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,255 @@
+// pkg-config: sdl2
+#include <SDL.h>
+
+#include <dlfcn.h>
+#include <math.h>
+
+#include <string>
+#include <vector>
+
+// Initialization of SDL subsystems used by games, and the amount of SDL code that static library brings in
+//
+// Every repetition initializes and shuts down the given subsystems, this includes driver selection and device
+// enumeration, so backends and subsystems compiled out of the library show up as shorter SDL_Init() time
+// Numbers of global symbols defined in libSDL2.a and of SDL symbols linked into this executable are printed too
+//
+// Audio conversions that SDL_mixer does for loaded chunks and music streams are measured too, from formats of
+// Doom sounds and of music to device format, output of vector kernels is compared with scalar path if they exist
+
+static constexpr uint32_t GAME_SUBSYSTEMS = SDL_INIT_TIMER | SDL_INIT_AUDIO | SDL_INIT_VIDEO | SDL_INIT_EVENTS
+    | SDL_INIT_JOYSTICK | SDL_INIT_GAMECONTROLLER;
+
+static constexpr int CONVERSION_DURATION = 2;  // seconds of input
+static constexpr float SIMD_TOLERANCE = 1e-5f;
+
+// Not declared in SDL.h, and exists in patched library only, see patch/sdl2-audio-simd.diff
+using SelectAudioSimd = const char* (*)(int enabled);
+
+struct Conversion
+{
+    const char* name;
+    SDL_AudioFormat src_format;
+    Uint8 src_channels;
+    int src_rate;
+    Uint8 dst_channels;
+    int dst_rate;
+    bool stream;
+};
+
+// Tones in all channels, with phases that differ between channels
+static std::vector<Uint8> MakeInput(const Conversion& conversion)
+{
+    const size_t samples = size_t(CONVERSION_DURATION) * conversion.src_rate * conversion.src_channels;
+    const size_t sample_size = SDL_AUDIO_BITSIZE(conversion.src_format) / 8;
+    std::vector<Uint8> input(samples * sample_size);
+
+    for (size_t i = 0; i < samples; ++i)
+    {
+        const size_t frame = i / conversion.src_channels;
+        const size_t channel = i % conversion.src_channels;
+        const float value = 0.4f * sinf(0.03f * frame + channel) + 0.2f * sinf(0.41f * frame);
+        Uint8* const sample = &input[i * sample_size];
+
+        if (conversion.src_format == AUDIO_U8)
+            *sample = Uint8(128 + lrintf(127 * value));
+        else if (conversion.src_format == AUDIO_S16SYS)
+            *reinterpret_cast<Sint16*>(sample) = Sint16(lrintf(32767 * value));
+        else
+            *reinterpret_cast<float*>(sample) = value;
+    }
+
+    return input;
+}
+
+// Whole input at once, to 32-bit float samples that SDL_mixer mixes, empty output on failure
+static std::vector<float> Convert(const Conversion& conversion, const std::vector<Uint8>& input)
+{
+    std::vector<float> output;
+
+    if (conversion.stream)
+    {
+        SDL_AudioStream* stream = SDL_NewAudioStream(conversion.src_format, conversion.src_channels,
+            conversion.src_rate, AUDIO_F32SYS, conversion.dst_channels, conversion.dst_rate);
+
+        if (stream == nullptr)
+            return output;
+
+        if (SDL_AudioStreamPut(stream, input.data(), int(input.size())) == 0 && SDL_AudioStreamFlush(stream) == 0)
+        {
+            output.resize(SDL_AudioStreamAvailable(stream) / sizeof(float));
+            const int length = SDL_AudioStreamGet(stream, output.data(), int(output.size() * sizeof(float)));
+            output.resize(length > 0 ? length / sizeof(float) : 0);
+        }
+
+        SDL_FreeAudioStream(stream);
+    }
+    else
+    {
+        SDL_AudioCVT cvt;
+
+        if (SDL_BuildAudioCVT(&cvt, conversion.src_format, conversion.src_channels, conversion.src_rate,
+            AUDIO_F32SYS, conversion.dst_channels, conversion.dst_rate) < 0)
+            return output;
+
+        std::vector<Uint8> buffer(input.size() * cvt.len_mult);
+        SDL_memcpy(buffer.data(), input.data(), input.size());
+        cvt.buf = buffer.data();
+        cvt.len = int(input.size());
+
+        if (SDL_ConvertAudio(&cvt) == 0)
+        {
+            const float* samples = reinterpret_cast<const float*>(buffer.data());
+            output.assign(samples, samples + cvt.len_cvt / sizeof(float));
+        }
+    }
+
+    return output;
+}
+
+// Largest difference between outputs of vector kernels and of scalar path, vector ones stay selected
+static float MeasureSimdDifference(SelectAudioSimd select, const Conversion& conversion,
+    const std::vector<Uint8>& input)
+{
+    select(0);
+    const std::vector<float> scalar = Convert(conversion, input);
+    select(1);
+    const std::vector<float> vector = Convert(conversion, input);
+
+    if (scalar.empty() || scalar.size() != vector.size())
+        return INFINITY;
+
+    float difference = 0;
+
+    for (size_t i = 0; i < scalar.size(); ++i)
+        difference = fmaxf(difference, fabsf(scalar[i] - vector[i]));
+
+    return difference;
+}
+
+static size_t LibrarySymbolCount(const char* path)
+{
+#if defined(__aarch64__)
+    const char* const arch = "arm64";
+#elif defined(__x86_64__)
+    const char* const arch = "x86_64";
+#endif
+
+    // Defined external symbols only, archive member names and undefined references are skipped
+    const std::string command = aedi::Format("nm -g -U -j -arch %s '%s'", arch, path);
+    size_t count = 0;
+
+    if (FILE* output = popen(command.c_str(), "r"))
+    {
+        char line[4096];
+
+        while (fgets(line, sizeof line, output) != nullptr)
+        {
+            if (line[0] == '_')
+                ++count;
+        }
+
+        pclose(output);
+    }
+
+    return count;
+}
+
+int main(int, char** argv)
+{
+    SDL_version version;
+    SDL_GetVersion(&version);
+    aedi::Info("sdl2_version", "%d.%d.%d", version.major, version.minor, version.patch);
+    aedi::PrintCpuFeatures();
+
+    aedi::Info("symbols/library", "%zu", LibrarySymbolCount(AEDI_LIB_PATH "/libSDL2.a"));
+
+    size_t linked_count = 0;
+
+    for (const std::string& symbol : aedi::LinkedSymbols(argv[0]))
+    {
+        if (symbol.compare(0, 5, "_SDL_") == 0)
+            ++linked_count;
+    }
+
+    aedi::Info("symbols/linked", "%zu", linked_count);
+
+    static const struct
+    {
+        const char* name;
+        uint32_t flags;
+    }
+    SUBSYSTEMS[] =
+    {
+        { "video", SDL_INIT_VIDEO },
+        { "audio", SDL_INIT_AUDIO },
+        { "gamecontroller", SDL_INIT_GAMECONTROLLER },
+        { "game", GAME_SUBSYSTEMS },
+    };
+
+    for (const auto& subsystem : SUBSYSTEMS)
+    {
+        AEDI_BENCH(aedi::Format("init/%s", subsystem.name), Operations, 1)
+        {
+            AEDI_EXPECT(SDL_Init(subsystem.flags) == 0);
+            SDL_Quit();
+        }
+    }
+
+    // Drivers that remain in the library
+    AEDI_EXPECT(SDL_Init(GAME_SUBSYSTEMS) == 0);
+
+    for (int i = 0, e = SDL_GetNumRenderDrivers(); i < e; ++i)
+    {
+        SDL_RendererInfo info;
+
+        if (SDL_GetRenderDriverInfo(i, &info) == 0)
+            aedi::Info(aedi::Format("render_driver/%d", i).c_str(), "%s", info.name);
+    }
+
+    for (int i = 0, e = SDL_GetNumAudioDrivers(); i < e; ++i)
+        aedi::Info(aedi::Format("audio_driver/%d", i).c_str(), "%s", SDL_GetAudioDriver(i));
+
+    SDL_Quit();
+
+    // Kernels are chosen when converter is built, so every conversion builds it with the selected ones
+    const auto select_simd = reinterpret_cast<SelectAudioSimd>(dlsym(RTLD_DEFAULT, "SDL_SelectAudioSIMD"));
+    aedi::Info("audio_simd", "%s", select_simd ? select_simd(1) : "unpatched");
+
+    static const Conversion CONVERSIONS[] =
+    {
+        // Mix_LoadWAV() of Doom sound, and the same with device of mono output
+        { "cvt/u8_mono_11025/stereo_48000", AUDIO_U8, 1, 11025, 2, 48000, false },
+        { "cvt/u8_mono_11025/mono_48000", AUDIO_U8, 1, 11025, 1, 48000, false },
+        // Music streams decoded at their rates
+        { "stream/s16_stereo_44100/stereo_48000", AUDIO_S16SYS, 2, 44100, 2, 48000, true },
+        { "stream/s16_stereo_22050/stereo_48000", AUDIO_S16SYS, 2, 22050, 2, 48000, true },
+        { "stream/f32_stereo_48000/mono_48000", AUDIO_F32SYS, 2, 48000, 1, 48000, true },
+    };
+
+    for (const Conversion& conversion : CONVERSIONS)
+    {
+        const std::vector<Uint8> input = MakeInput(conversion);
+        const size_t samples = size_t(CONVERSION_DURATION) * conversion.src_rate * conversion.src_channels;
+
+        for (int enabled = select_simd ? 0 : 1; enabled <= 1; ++enabled)
+        {
+            const char* const kernels = select_simd ? select_simd(enabled) : "stock";
+
+            AEDI_BENCH(aedi::Format("convert/%s/%s", conversion.name, kernels), Samples, samples)
+            {
+                const std::vector<float> output = Convert(conversion, input);
+                AEDI_EXPECT(!output.empty());
+                aedi::DoNotOptimize(output.data());
+            }
+        }
+
+        if (select_simd)
+        {
+            const float difference = MeasureSimdDifference(select_simd, conversion, input);
+            aedi::Info(aedi::Format("simd_difference/%s", conversion.name).c_str(), "%.3g", difference);
+            AEDI_EXPECT(difference <= SIMD_TOLERANCE);
+        }
+    }
+
+    return 0;
+}
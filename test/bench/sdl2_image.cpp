@@ -0,0 +1,464 @@
+// pkg-config: sdl2 SDL2_image libpng libwebp libjxl libjxl_threads
+#include <SDL.h>
+#include <SDL_image.h>
+#include <jxl/decode.h>
+#include <jxl/encode.h>
+#include <jxl/thread_parallel_runner.h>
+#include <png.h>
+#include <webp/decode.h>
+#include <webp/encode.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loading of the same pictures from memory in PNG, WebP, JPEG XL, JPEG and TGA formats by SDL2_image, as a game
+// loads textures
+//
+// Every repetition creates SDL surface from memory buffer with IMG_Load_RW(), format is detected from the contents
+// The same PNG and WebP data is also decoded by libpng and libwebp directly into preallocated memory, the difference
+// is the cost of SDL2_image backends and surface creation, lossless formats are verified against the original
+// JPEG data is produced by IMG_SaveJPG_RW(), and its loading is skipped if SDL2_image was built without JPEG saving
+// Sizes of encoded pictures are reported relative to PNG ones, as texture pack sizes would compare
+//
+// JPEG XL pictures are decoded by libjxl directly too, without parallel runner, and with thread parallel runner
+// of several thread counts, SDL2_image decodes them on the calling thread only
+
+// Backends compiled into SDL2_image, detected by presence of their functions in the executable
+static void PrintImageBackends(const char* path)
+{
+    static const struct
+    {
+        const char* name;
+        const char* symbol;
+    }
+    BACKENDS[] =
+    {
+        { "imageio", "_CGImageSourceCreateWithData" },
+        { "stb", "_IMG_LoadSTB_RW" },
+        { "libwebp", "_WebPDecode" },
+    };
+
+    const std::vector<std::string> symbols = aedi::LinkedSymbols(path);
+    std::string backends;
+
+    for (const auto& backend : BACKENDS)
+    {
+        if (std::find(symbols.begin(), symbols.end(), backend.symbol) != symbols.end())
+            backends += (backends.empty() ? "" : " ") + std::string(backend.name);
+    }
+
+    aedi::Info("sdl2_image_backends", "%s", backends.empty() ? "none" : backends.c_str());
+}
+
+// Brick wall with noise and fully transparent holes, so TGA run-length encoding has something to compress
+static std::vector<uint8_t> MakeTexture(int size)
+{
+    std::vector<uint8_t> texture(size_t(size) * size * 4);
+    uint32_t state = 0xD00D;
+
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+
+            uint8_t* pixel = &texture[(size_t(y) * size + x) * 4];
+            const int dx = x % 128 - 64, dy = y % 128 - 64;
+
+            if (dx * dx + dy * dy < 24 * 24)
+            {
+                memset(pixel, 0, 4);
+                continue;
+            }
+
+            const int row = y / 32;
+            const bool mortar = y % 32 < 3 || (x + (row & 1) * 32) % 64 < 3;
+            const int noise = int(state % 32);
+
+            pixel[0] = uint8_t(mortar ? 160 + noise : 140 + noise + row % 3 * 10);
+            pixel[1] = uint8_t(mortar ? 150 + noise : 60 + noise);
+            pixel[2] = uint8_t(mortar ? 140 + noise : 40 + noise);
+            pixel[3] = 255;
+        }
+    }
+
+    return texture;
+}
+
+static std::vector<uint8_t> EncodePng(const std::vector<uint8_t>& pixels, int size)
+{
+    png_image image = {};
+    image.version = PNG_IMAGE_VERSION;
+    image.width = png_uint_32(size);
+    image.height = png_uint_32(size);
+    image.format = PNG_FORMAT_RGBA;
+
+    png_alloc_size_t encoded_size = 0;
+
+    if (!png_image_write_to_memory(&image, nullptr, &encoded_size, 0, pixels.data(), size * 4, nullptr))
+        return {};
+
+    std::vector<uint8_t> encoded(encoded_size);
+
+    if (!png_image_write_to_memory(&image, encoded.data(), &encoded_size, 0, pixels.data(), size * 4, nullptr))
+        return {};
+
+    encoded.resize(encoded_size);
+    return encoded;
+}
+
+static std::vector<uint8_t> EncodeWebp(const std::vector<uint8_t>& pixels, int size)
+{
+    uint8_t* encoded_data = nullptr;
+    const size_t encoded_size = WebPEncodeRGBA(pixels.data(), size, size, size * 4, 75, &encoded_data);
+
+    const std::vector<uint8_t> encoded(encoded_data, encoded_data + encoded_size);
+    WebPFree(encoded_data);
+
+    return encoded;
+}
+
+// Lossless WebP keeps exact colors of visible pixels only, ones of fully transparent pixels are changed
+static std::vector<uint8_t> EncodeWebpLossless(const std::vector<uint8_t>& pixels, int size)
+{
+    uint8_t* encoded_data = nullptr;
+    const size_t encoded_size = WebPEncodeLosslessRGBA(pixels.data(), size, size, size * 4, &encoded_data);
+
+    const std::vector<uint8_t> encoded(encoded_data, encoded_data + encoded_size);
+    WebPFree(encoded_data);
+
+    return encoded;
+}
+
+static const JxlPixelFormat JXL_RGBA = { 4, JXL_TYPE_UINT8, JXL_NATIVE_ENDIAN, 0 };
+
+// Lossy pictures have visually lossless default distance of 1.0, both are encoded with default effort of 7
+static std::vector<uint8_t> EncodeJxl(const std::vector<uint8_t>& pixels, int size, bool lossless)
+{
+    void* runner = JxlThreadParallelRunnerCreate(nullptr, JxlThreadParallelRunnerDefaultNumWorkerThreads());
+    JxlEncoder* encoder = JxlEncoderCreate(nullptr);
+
+    JxlBasicInfo info;
+    JxlEncoderInitBasicInfo(&info);
+    info.xsize = uint32_t(size);
+    info.ysize = uint32_t(size);
+    info.bits_per_sample = 8;
+    info.num_extra_channels = 1;
+    info.alpha_bits = 8;
+    info.uses_original_profile = lossless ? JXL_TRUE : JXL_FALSE;
+
+    JxlColorEncoding color;
+    JxlColorEncodingSetToSRGB(&color, JXL_FALSE);
+
+    JxlEncoderFrameSettings* settings = JxlEncoderFrameSettingsCreate(encoder, nullptr);
+
+    bool ok = JxlEncoderSetParallelRunner(encoder, JxlThreadParallelRunner, runner) == JXL_ENC_SUCCESS
+        && JxlEncoderSetBasicInfo(encoder, &info) == JXL_ENC_SUCCESS
+        && JxlEncoderSetColorEncoding(encoder, &color) == JXL_ENC_SUCCESS
+        && (!lossless || JxlEncoderSetFrameLossless(settings, JXL_TRUE) == JXL_ENC_SUCCESS)
+        && JxlEncoderAddImageFrame(settings, &JXL_RGBA, pixels.data(), pixels.size()) == JXL_ENC_SUCCESS;
+
+    JxlEncoderCloseInput(encoder);
+
+    std::vector<uint8_t> encoded(64 * 1024);
+    uint8_t* next_out = encoded.data();
+    size_t avail_out = encoded.size();
+
+    while (ok)
+    {
+        const JxlEncoderStatus status = JxlEncoderProcessOutput(encoder, &next_out, &avail_out);
+
+        if (status != JXL_ENC_NEED_MORE_OUTPUT)
+        {
+            ok = status == JXL_ENC_SUCCESS;
+            break;
+        }
+
+        const size_t offset = size_t(next_out - encoded.data());
+        encoded.resize(encoded.size() * 2);
+        next_out = encoded.data() + offset;
+        avail_out = encoded.size() - offset;
+    }
+
+    encoded.resize(ok ? size_t(next_out - encoded.data()) : 0);
+
+    JxlEncoderDestroy(encoder);
+    JxlThreadParallelRunnerDestroy(runner);
+
+    return encoded;
+}
+
+// Runner is optional, without it all groups of picture are decoded on the calling thread
+static bool DecodeJxl(const std::vector<uint8_t>& encoded, std::vector<uint8_t>& output, void* runner)
+{
+    JxlDecoder* decoder = JxlDecoderCreate(nullptr);
+
+    bool ok = (runner == nullptr
+            || JxlDecoderSetParallelRunner(decoder, JxlThreadParallelRunner, runner) == JXL_DEC_SUCCESS)
+        && JxlDecoderSubscribeEvents(decoder, JXL_DEC_FULL_IMAGE) == JXL_DEC_SUCCESS
+        && JxlDecoderSetInput(decoder, encoded.data(), encoded.size()) == JXL_DEC_SUCCESS;
+
+    JxlDecoderCloseInput(decoder);
+
+    for (bool finished = false; ok && !finished;)
+    {
+        const JxlDecoderStatus status = JxlDecoderProcessInput(decoder);
+
+        if (status == JXL_DEC_NEED_IMAGE_OUT_BUFFER)
+            ok = JxlDecoderSetImageOutBuffer(decoder, &JXL_RGBA, output.data(), output.size()) == JXL_DEC_SUCCESS;
+        else
+            ok = finished = status == JXL_DEC_FULL_IMAGE;
+    }
+
+    JxlDecoderDestroy(decoder);
+    return ok;
+}
+
+static std::vector<uint8_t> EncodeJpeg(const std::vector<uint8_t>& pixels, int size)
+{
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint8_t*>(pixels.data()),
+        size, size, 32, size * 4, SDL_PIXELFORMAT_RGBA32);
+
+    if (surface == nullptr)
+        return {};
+
+    // Memory stream cannot grow, but JPEG at this quality is much smaller than uncompressed pixels
+    std::vector<uint8_t> encoded(pixels.size() + 64 * 1024);
+    SDL_RWops* stream = SDL_RWFromMem(encoded.data(), int(encoded.size()));
+    const bool saved = IMG_SaveJPG_RW(surface, stream, 0, 90) == 0;
+
+    encoded.resize(saved ? size_t(SDL_RWtell(stream)) : 0);
+    SDL_RWclose(stream);
+    SDL_FreeSurface(surface);
+
+    return encoded;
+}
+
+// 32-bit BGRA with top-left origin, uncompressed or run-length encoded, packets don't cross scanlines
+static std::vector<uint8_t> EncodeTga(const std::vector<uint8_t>& pixels, int size, bool rle)
+{
+    const uint8_t header[18] =
+    {
+        0, 0, uint8_t(rle ? 10 : 2), 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        uint8_t(size), uint8_t(size >> 8), uint8_t(size), uint8_t(size >> 8), 32, 0x28,
+    };
+
+    std::vector<uint8_t> encoded(header, header + sizeof header);
+
+    const auto Pixel = [&](int y, int x) { return &pixels[(size_t(y) * size + x) * 4]; };
+    const auto Same = [&](int y, int x1, int x2) { return memcmp(Pixel(y, x1), Pixel(y, x2), 4) == 0; };
+    const auto Append = [&](const uint8_t* rgba)
+    {
+        const uint8_t bgra[] = { rgba[2], rgba[1], rgba[0], rgba[3] };
+        encoded.insert(encoded.end(), bgra, bgra + 4);
+    };
+
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size;)
+        {
+            if (!rle)
+            {
+                Append(Pixel(y, x++));
+                continue;
+            }
+
+            int end = x + 1;
+
+            while (end < size && end - x < 128 && Same(y, x, end))
+                ++end;
+
+            if (end - x > 1)
+            {
+                encoded.push_back(uint8_t(0x80 | (end - x - 1)));
+                Append(Pixel(y, x));
+            }
+            else
+            {
+                while (end < size && end - x < 128 && (end + 1 == size || !Same(y, end, end + 1)))
+                    ++end;
+
+                encoded.push_back(uint8_t(end - x - 1));
+
+                for (int i = x; i < end; ++i)
+                    Append(Pixel(y, i));
+            }
+
+            x = end;
+        }
+    }
+
+    return encoded;
+}
+
+// Largest difference of color components, or -1 if dimensions don't match
+static int SurfaceDifference(SDL_Surface* surface, const std::vector<uint8_t>& pixels, int size)
+{
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+
+    if (converted == nullptr)
+        return -1;
+
+    int difference = converted->w == size && converted->h == size ? 0 : -1;
+
+    for (int y = 0; difference >= 0 && y < size; ++y)
+    {
+        const uint8_t* row = static_cast<const uint8_t*>(converted->pixels) + size_t(y) * converted->pitch;
+
+        for (size_t i = 0, e = size_t(size) * 4; i < e; ++i)
+            difference = std::max(difference, abs(row[i] - pixels[size_t(y) * size * 4 + i]));
+    }
+
+    SDL_FreeSurface(converted);
+    return difference;
+}
+
+int main(int, char** argv)
+{
+    const SDL_version* version = IMG_Linked_Version();
+    aedi::Info("sdl2_image_version", "%d.%d.%d", version->major, version->minor, version->patch);
+    aedi::Info("png_version", "%s", png_get_libpng_ver(nullptr));
+
+    const int webp_version = WebPGetDecoderVersion();
+    aedi::Info("webp_version", "%d.%d.%d", webp_version >> 16, (webp_version >> 8) & 0xFF, webp_version & 0xFF);
+
+    const uint32_t jxl_version = JxlDecoderVersion();
+    aedi::Info("jxl_version", "%u.%u.%u", jxl_version / 1000000, jxl_version / 1000 % 1000, jxl_version % 1000);
+
+    PrintImageBackends(argv[0]);
+
+    const int initialized = IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_WEBP | IMG_INIT_JXL);
+    aedi::Info("sdl2_image_init", "0x%x", initialized);
+
+    const unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+    aedi::Info("cores", "%u", cores);
+
+    // Zero is for decoding without parallel runner
+    std::vector<unsigned> jxl_thread_counts = { 0, 1, 2, 4 };
+
+    if (cores > 4)
+        jxl_thread_counts.push_back(cores);
+
+    // Sprite and high resolution texture
+    for (int size : { 256, 2048 })
+    {
+        const std::vector<uint8_t> pixels = MakeTexture(size);
+        std::vector<uint8_t> output(pixels.size());
+
+        const struct
+        {
+            const char* name;
+            std::vector<uint8_t> encoded;
+            int tolerance;  // negative for lossy formats
+        }
+        IMAGES[] =
+        {
+            // ImageIO draws PNG through color management, which may round components off by one
+            { "png", EncodePng(pixels, size), 1 },
+            { "webp", EncodeWebp(pixels, size), -1 },
+            { "jxl", EncodeJxl(pixels, size, false), -1 },
+            { "jxl_lossless", EncodeJxl(pixels, size, true), 0 },
+            { "webp_lossless", EncodeWebpLossless(pixels, size), -1 },
+            { "jpeg", EncodeJpeg(pixels, size), -1 },
+            { "tga", EncodeTga(pixels, size, false), 0 },
+            { "tga_rle", EncodeTga(pixels, size, true), 0 },
+        };
+
+        for (const auto& image : IMAGES)
+        {
+            const std::string suffix = aedi::Format("%s/%d", image.name, size);
+
+            if (image.encoded.empty())
+            {
+                aedi::Info(("skipped/" + suffix).c_str(), "%s", "no encoder");
+                continue;
+            }
+
+            aedi::Info(("size/" + suffix).c_str(), "%zu", image.encoded.size());
+            const double size_to_png = double(image.encoded.size()) / IMAGES[0].encoded.size();
+            aedi::Info(("size_to_png/" + suffix).c_str(), "%.3f", size_to_png);
+
+            if (strncmp(image.name, "jxl", 3) == 0 && (initialized & IMG_INIT_JXL) == 0)
+            {
+                aedi::Info(("skipped/" + suffix).c_str(), "%s", "no JPEG XL support in SDL2_image");
+                continue;
+            }
+
+            SDL_Surface* surface = IMG_Load_RW(SDL_RWFromConstMem(image.encoded.data(), int(image.encoded.size())), 1);
+            AEDI_EXPECT(surface != nullptr);
+
+            if (image.tolerance >= 0)
+            {
+                const int difference = SurfaceDifference(surface, pixels, size);
+                AEDI_EXPECT(difference >= 0 && difference <= image.tolerance);
+            }
+
+            SDL_FreeSurface(surface);
+
+            AEDI_BENCH("load/sdl2_image/" + suffix, Pixels, size * size)
+            {
+                SDL_RWops* stream = SDL_RWFromConstMem(image.encoded.data(), int(image.encoded.size()));
+                surface = IMG_Load_RW(stream, 1);
+                AEDI_EXPECT(surface != nullptr);
+                SDL_FreeSurface(surface);
+            }
+        }
+
+        const std::vector<uint8_t>& png = IMAGES[0].encoded;
+        AEDI_EXPECT(!png.empty());
+
+        AEDI_BENCH(aedi::Format("decode/libpng/png/%d", size), Pixels, size * size)
+        {
+            png_image image = {};
+            image.version = PNG_IMAGE_VERSION;
+            AEDI_EXPECT(png_image_begin_read_from_memory(&image, png.data(), png.size()));
+
+            image.format = PNG_FORMAT_RGBA;
+            const bool finished = png_image_finish_read(&image, nullptr, output.data(), size * 4, nullptr);
+            png_image_free(&image);
+            AEDI_EXPECT(finished);
+        }
+
+        AEDI_EXPECT(output == pixels);
+
+        const std::vector<uint8_t>& webp = IMAGES[1].encoded;
+        AEDI_EXPECT(!webp.empty());
+
+        AEDI_BENCH(aedi::Format("decode/libwebp/webp/%d", size), Pixels, size * size)
+        {
+            AEDI_EXPECT(WebPDecodeRGBAInto(webp.data(), webp.size(), output.data(), output.size(), size * 4));
+        }
+
+        for (int index : { 2, 3 })
+        {
+            const auto& image = IMAGES[index];
+            AEDI_EXPECT(!image.encoded.empty());
+
+            for (unsigned threads : jxl_thread_counts)
+            {
+                void* runner = threads == 0 ? nullptr : JxlThreadParallelRunnerCreate(nullptr, threads);
+                const std::string name = aedi::Format("decode/libjxl/%s/%d/", image.name, size)
+                    + (threads == 0 ? std::string("serial") : aedi::Format("threads%u", threads));
+
+                AEDI_BENCH(name, Pixels, size * size)
+                {
+                    AEDI_EXPECT(DecodeJxl(image.encoded, output, runner));
+                }
+
+                if (runner != nullptr)
+                    JxlThreadParallelRunnerDestroy(runner);
+            }
+
+            if (image.tolerance == 0)
+                AEDI_EXPECT(output == pixels);
+        }
+    }
+
+    IMG_Quit();
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+// pkg-config: sdl2 SDL2_mixer
+#include <CoreAudio/CoreAudio.h>
+#include <SDL.h>
+#include <SDL_mixer.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Audio callback timing for buffer sizes from 128 to 4096 sample frames
+//
+// Callbacks are timestamped for SDL audio device opened directly, and for SDL_mixer's post-mix hook
+// Period is median time between callbacks, jitter is 99th percentile of its deviation from the nominal period
+// Latency is estimated from SDL buffer queue and CoreAudio device latency, safety offset and I/O buffer size
+// SDL sizes I/O buffer of the device to the requested period, it's checked unless SDL_COREAUDIO_DEVICE_BUFFER_SIZE=0
+// Results are reported as info records, SDL_AUDIODRIVER and other SDL hints can be set via environment variables
+
+static constexpr int SAMPLE_RATE = 48000;
+static constexpr int CHANNELS = 2;
+static constexpr int DURATION = 2;  // seconds per buffer size
+static constexpr size_t MAX_CALLBACKS = SAMPLE_RATE * DURATION / 128 * 2;
+
+struct Timestamps
+{
+    uint64_t times[MAX_CALLBACKS];
+    std::atomic<size_t> count;
+
+    void Record()
+    {
+        const size_t index = count.load(std::memory_order_relaxed);
+
+        if (index < MAX_CALLBACKS)
+        {
+            times[index] = mach_absolute_time();
+            count.store(index + 1, std::memory_order_release);
+        }
+    }
+};
+
+static Timestamps timestamps;
+
+static void AudioCallback(void*, Uint8* stream, int length)
+{
+    timestamps.Record();
+    memset(stream, 0, size_t(length));
+}
+
+static void PostMixCallback(void*, Uint8*, int)
+{
+    timestamps.Record();
+}
+
+template <typename T>
+static T GetDeviceProperty(AudioObjectID device, AudioObjectPropertySelector selector, AudioObjectPropertyScope scope)
+{
+    // Zero is kAudioObjectPropertyElementMain, it was named differently before macOS 12
+    const AudioObjectPropertyAddress address = { selector, scope, 0 };
+
+    T value = {};
+    UInt32 size = sizeof value;
+
+    return AudioObjectGetPropertyData(device, &address, 0, nullptr, &size, &value) == noErr ? value : T();
+}
+
+static AudioObjectID DefaultDevice()
+{
+    return GetDeviceProperty<AudioObjectID>(kAudioObjectSystemObject, kAudioHardwarePropertyDefaultOutputDevice,
+        kAudioObjectPropertyScopeGlobal);
+}
+
+// I/O buffer size is per-process setting, so it's queried while audio device of this process is open
+static UInt32 DeviceBufferFrames()
+{
+    return GetDeviceProperty<UInt32>(DefaultDevice(), kAudioDevicePropertyBufferFrameSize,
+        kAudioObjectPropertyScopeGlobal);
+}
+
+static void CheckDeviceBufferFrames(const char* path, int samples)
+{
+    const UInt32 frames = DeviceBufferFrames();
+    aedi::Info(aedi::Format("device_buffer_frames/%s/%d", path, samples).c_str(), "%u", frames);
+
+    if (!SDL_GetHintBoolean("SDL_COREAUDIO_DEVICE_BUFFER_SIZE", SDL_TRUE))
+        return;
+
+    // Requested size is clamped to the range that the device supports
+    const AudioValueRange range = GetDeviceProperty<AudioValueRange>(DefaultDevice(),
+        kAudioDevicePropertyBufferFrameSizeRange, kAudioObjectPropertyScopeGlobal);
+    AEDI_EXPECT(frames <= UInt32(samples) || frames <= UInt32(range.mMinimum));
+}
+
+// Output latency of default CoreAudio device in microseconds, excluding application side buffering
+static double DeviceLatency()
+{
+    const AudioObjectID device = DefaultDevice();
+    const Float64 rate = GetDeviceProperty<Float64>(device, kAudioDevicePropertyNominalSampleRate,
+        kAudioObjectPropertyScopeGlobal);
+
+    if (rate <= 0)
+        return 0;
+
+    const UInt32 latency = GetDeviceProperty<UInt32>(device, kAudioDevicePropertyLatency, kAudioObjectPropertyScopeOutput);
+    const UInt32 safety_offset = GetDeviceProperty<UInt32>(device, kAudioDevicePropertySafetyOffset,
+        kAudioObjectPropertyScopeOutput);
+    const UInt32 buffer_size = DeviceBufferFrames();
+
+    return (latency + safety_offset + buffer_size) * 1e6 / rate;
+}
+
+// SDL CoreAudio backend queues at least two buffers and enough of them to cover 15 ms, see MINIMUM_AUDIO_BUFFER_TIME_MS
+static int QueuedBufferCount(int samples, int rate)
+{
+    const double milliseconds = samples * 1000.0 / rate;
+    return milliseconds < 15 ? int(ceil(15 / milliseconds)) * 2 : 2;
+}
+
+struct Timing
+{
+    double period;
+    double jitter;
+    double max_interval;
+};
+
+static Timing MeasureCallbacks(double nominal_period)
+{
+    timestamps.count.store(0, std::memory_order_release);
+    SDL_Delay(DURATION * 1000);
+
+    const size_t count = timestamps.count.load(std::memory_order_acquire);
+
+    // The first few callbacks are issued back to back to fill the queue, they're skipped
+    const size_t skip = std::min(count, size_t(8));
+
+    std::vector<double> intervals;
+    std::vector<double> deviations;
+
+    for (size_t i = skip + 1; i < count; ++i)
+    {
+        const int64_t ticks = int64_t(timestamps.times[i] - timestamps.times[i - 1]);
+        const double interval = aedi::TicksToNanoseconds(ticks) / 1000;
+        intervals.push_back(interval);
+        deviations.push_back(fabs(interval - nominal_period));
+    }
+
+    if (intervals.empty())
+        return { 0, 0, 0 };
+
+    std::sort(intervals.begin(), intervals.end());
+    std::sort(deviations.begin(), deviations.end());
+
+    return { intervals[intervals.size() / 2], deviations[deviations.size() * 99 / 100], intervals.back() };
+}
+
+static void Report(const char* path, int samples, const Timing& timing, double latency)
+{
+    const std::string suffix = aedi::Format("%s/%d", path, samples);
+
+    aedi::Info(("period_us/" + suffix).c_str(), "%.0f", timing.period);
+    aedi::Info(("jitter_us/" + suffix).c_str(), "%.0f", timing.jitter);
+    aedi::Info(("max_interval_us/" + suffix).c_str(), "%.0f", timing.max_interval);
+    aedi::Info(("latency_us/" + suffix).c_str(), "%.0f", latency);
+}
+
+int main()
+{
+    SDL_version version;
+    SDL_GetVersion(&version);
+    aedi::Info("sdl_version", "%d.%d.%d (%s)", version.major, version.minor, version.patch, SDL_GetRevision());
+
+    const SDL_version* mixer_version = Mix_Linked_Version();
+    aedi::Info("sdl_mixer_version", "%d.%d.%d", mixer_version->major, mixer_version->minor, mixer_version->patch);
+
+    AEDI_EXPECT(SDL_Init(SDL_INIT_AUDIO) == 0);
+    aedi::Info("audio_driver", "%s", SDL_GetCurrentAudioDriver());
+
+    int recommended = 0;
+
+    for (int samples = 128; samples <= 4096; samples *= 2)
+    {
+        // Plain SDL audio device
+        SDL_AudioSpec desired = {};
+        desired.freq = SAMPLE_RATE;
+        desired.format = AUDIO_S16SYS;
+        desired.channels = CHANNELS;
+        desired.samples = Uint16(samples);
+        desired.callback = AudioCallback;
+
+        SDL_AudioSpec obtained;
+        const SDL_AudioDeviceID device = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, 0);
+        AEDI_EXPECT(device != 0);
+        CheckDeviceBufferFrames("sdl", obtained.samples);
+
+        const double period = obtained.samples * 1e6 / obtained.freq;
+        const double latency = QueuedBufferCount(obtained.samples, obtained.freq) * period + DeviceLatency();
+
+        SDL_PauseAudioDevice(device, 0);
+        const Timing timing = MeasureCallbacks(period);
+        SDL_CloseAudioDevice(device);
+
+        Report("sdl", samples, timing, latency);
+
+        // SDL_mixer on top of it, as used by Chocolate Doom and its forks
+        AEDI_EXPECT(Mix_OpenAudio(SAMPLE_RATE, AUDIO_S16SYS, CHANNELS, samples) == 0);
+
+        int frequency = 0;
+        Uint16 format = 0;
+        int channels = 0;
+        AEDI_EXPECT(Mix_QuerySpec(&frequency, &format, &channels) != 0);
+        CheckDeviceBufferFrames("mixer", samples);
+
+        const double mixer_latency = DeviceLatency();
+
+        const double mixer_period = samples * 1e6 / frequency;
+        Mix_SetPostMix(PostMixCallback, nullptr);
+        const Timing mixer_timing = MeasureCallbacks(mixer_period);
+        Mix_SetPostMix(nullptr, nullptr);
+        Mix_CloseAudio();
+
+        Report("mixer", samples, mixer_timing, QueuedBufferCount(samples, frequency) * mixer_period + mixer_latency);
+
+        // The smallest buffer that keeps callbacks regular enough to not underrun
+        const bool stable = mixer_timing.period > 0
+            && mixer_timing.jitter < mixer_period * 0.5
+            && mixer_timing.max_interval < mixer_period * 2.5;
+
+        if (recommended == 0 && stable)
+            recommended = samples;
+    }
+
+    aedi::Info("recommended_mix_buffer", "%d", recommended);
+
+    SDL_Quit();
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+// pkg-config: SDL2_net
+#include <SDL_net.h>
+
+#include <vector>
+
+// Socket set polling of UDP server with many peers, like multiplayer game server or lobby does every tic
+//
+// Every peer has its own UDP socket on loopback interface, all of them are in one socket set
+// Idle check polls the set without any pending data, receive check sends packets to a few peers at once,
+// then polls the set until they arrive, and reads them from sockets that SDLNet_SocketReady() reports
+// Cost of select() based set grows with the number of sockets, the kqueue based one depends on ready sockets only
+
+static constexpr int PEER_COUNTS[] = { 64, 256, 1000 };
+static constexpr int PACKETS_PER_CHECK = 8;
+static constexpr int PACKET_SIZE = 64;
+
+static void MeasurePolling(int peerCount)
+{
+    std::vector<UDPsocket> peers;
+    std::vector<IPaddress> addresses;
+
+    for (int i = 0; i < peerCount; ++i)
+    {
+        UDPsocket peer = SDLNet_UDP_Open(0);
+
+        // Descriptor limit of the process may be too low for large sets
+        if (peer == nullptr)
+        {
+            aedi::Info(aedi::Format("peers/%d", peerCount).c_str(), "skipped, %s", SDLNet_GetError());
+
+            for (UDPsocket opened : peers)
+                SDLNet_UDP_Close(opened);
+
+            return;
+        }
+
+        IPaddress* address = SDLNet_UDP_GetPeerAddress(peer, -1);
+        AEDI_EXPECT(address != nullptr);
+
+        peers.push_back(peer);
+        addresses.push_back(*address);
+        SDLNet_Write32(0x7f000001, &addresses.back().host);  // INADDR_LOOPBACK
+    }
+
+    SDLNet_SocketSet set = SDLNet_AllocSocketSet(peerCount);
+    AEDI_EXPECT(set != nullptr);
+
+    for (UDPsocket peer : peers)
+        AEDI_EXPECT(SDLNet_UDP_AddSocket(set, peer) != -1);
+
+    UDPsocket sender = SDLNet_UDP_Open(0);
+    AEDI_EXPECT(sender != nullptr);
+
+    UDPpacket* packet = SDLNet_AllocPacket(PACKET_SIZE);
+    AEDI_EXPECT(packet != nullptr);
+
+    AEDI_BENCH(aedi::Format("check/idle/%d", peerCount), Operations, 1)
+    {
+        AEDI_EXPECT(SDLNet_CheckSockets(set, 0) == 0);
+    }
+
+    int nextPeer = 0;
+
+    AEDI_BENCH(aedi::Format("check/receive/%d", peerCount), Operations, PACKETS_PER_CHECK)
+    {
+        // Packets go to peers spread over the whole set
+        for (int i = 0; i < PACKETS_PER_CHECK; ++i)
+        {
+            nextPeer = (nextPeer + 97) % peerCount;
+            packet->address = addresses[nextPeer];
+            packet->len = PACKET_SIZE;
+            AEDI_EXPECT(SDLNet_UDP_Send(sender, -1, packet) == 1);
+        }
+
+        for (int received = 0; received < PACKETS_PER_CHECK;)
+        {
+            AEDI_EXPECT(SDLNet_CheckSockets(set, 1000) > 0);
+
+            for (UDPsocket peer : peers)
+            {
+                if (SDLNet_SocketReady(peer))
+                {
+                    while (SDLNet_UDP_Recv(peer, packet) == 1)
+                        ++received;
+                }
+            }
+        }
+    }
+
+    SDLNet_FreePacket(packet);
+    SDLNet_UDP_Close(sender);
+    SDLNet_FreeSocketSet(set);
+
+    for (UDPsocket peer : peers)
+        SDLNet_UDP_Close(peer);
+}
+
+int main()
+{
+    // Default limit of open files is too low for the largest set
+    rlimit limit;
+
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < 4096)
+    {
+        limit.rlim_cur = limit.rlim_max < 4096 ? limit.rlim_max : 4096;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    AEDI_EXPECT(SDLNet_Init() == 0);
+
+    const SDLNet_version* version = SDLNet_Linked_Version();
+    aedi::Info("sdl2_net_version", "%d.%d.%d", version->major, version->minor, version->patch);
+
+    for (int peerCount : PEER_COUNTS)
+        MeasurePolling(peerCount);
+
+    SDLNet_Quit();
+
+    return 0;
+}
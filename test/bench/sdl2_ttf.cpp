@@ -0,0 +1,195 @@
+// pkg-config: sdl2 SDL2_ttf harfbuzz freetype2
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include <hb.h>
+
+#include <string>
+#include <vector>
+
+// Text rendering of UI and console, glyphs per second of shaping, rasterization, and complete line rendering
+//
+// HarfBuzz shapes lines with its built-in OpenType functions, FreeType renders every glyph of lines into bitmaps
+// without any cache, and SDL2_ttf renders the same lines into ARGB surfaces with TTF_RenderUTF8_Blended(),
+// that is rasterization plus blending of glyphs it caches per font, the differences show what caching could save
+// TrueType font is taken from the system, set AEDI_BENCH_FONT to path of another font file to use it instead
+
+static constexpr int FONT_SIZE = 16;
+
+static const char* const LINES[] =
+{
+    "] map e1m1",
+    "Player 1 picked up a shotgun.",
+    "R_DrawVisSprite: bad texture 1234, falling back to default",
+    "GZDoom g4.11.3 - Apr 24 2024 12:00:00 - SDL version",
+    "You need a blue key to activate this object",
+    "alias +zoom \"fov 40; sensitivity 0.5\"; bind mouse2 +zoom",
+    "Script 42 (OPEN): 3 actors spawned, 17 ticks, 0x7fffa1b2 checksum",
+    "The quick brown fox jumps over the lazy dog 0123456789 !?#$%&*()[]{}",
+};
+
+static std::string FindFont()
+{
+    if (const char* path = getenv("AEDI_BENCH_FONT"))
+        return path;
+
+    static const char* const CANDIDATES[] =
+    {
+        "/System/Library/Fonts/Supplemental/Arial.ttf",
+        "/System/Library/Fonts/Geneva.ttf",
+        "/Library/Fonts/Arial.ttf",
+    };
+
+    for (const char* path : CANDIDATES)
+    {
+        if (access(path, R_OK) == 0)
+            return path;
+    }
+
+    return {};
+}
+
+static size_t TotalLength()
+{
+    size_t length = 0;
+
+    for (const char* line : LINES)
+        length += strlen(line);
+
+    return length;
+}
+
+static void MeasureShaping(const std::string& path)
+{
+    hb_blob_t* blob = hb_blob_create_from_file(path.c_str());
+    AEDI_EXPECT(hb_blob_get_length(blob) > 0);
+
+    hb_face_t* face = hb_face_create(blob, 0);
+    hb_font_t* font = hb_font_create(face);
+    hb_font_set_scale(font, FONT_SIZE * 64, FONT_SIZE * 64);
+
+    hb_buffer_t* buffer = hb_buffer_create();
+    size_t glyphs = 0;
+
+    for (const char* line : LINES)
+    {
+        hb_buffer_reset(buffer);
+        hb_buffer_add_utf8(buffer, line, -1, 0, -1);
+        hb_buffer_guess_segment_properties(buffer);
+        hb_shape(font, buffer, nullptr, 0);
+
+        glyphs += hb_buffer_get_length(buffer);
+    }
+
+    aedi::Info("glyphs_per_pass", "%zu", glyphs);
+
+    AEDI_BENCH("shape/harfbuzz", Operations, glyphs)
+    {
+        for (const char* line : LINES)
+        {
+            hb_buffer_reset(buffer);
+            hb_buffer_add_utf8(buffer, line, -1, 0, -1);
+            hb_buffer_guess_segment_properties(buffer);
+            hb_shape(font, buffer, nullptr, 0);
+        }
+    }
+
+    hb_buffer_destroy(buffer);
+    hb_font_destroy(font);
+    hb_face_destroy(face);
+    hb_blob_destroy(blob);
+}
+
+static void MeasureRasterization(const std::string& path)
+{
+    FT_Library library;
+    AEDI_EXPECT(FT_Init_FreeType(&library) == 0);
+
+    FT_Int major, minor, patch;
+    FT_Library_Version(library, &major, &minor, &patch);
+    aedi::Info("freetype_version", "%d.%d.%d", major, minor, patch);
+
+    FT_Face face;
+    AEDI_EXPECT(FT_New_Face(library, path.c_str(), 0, &face) == 0);
+    AEDI_EXPECT(FT_Set_Pixel_Sizes(face, 0, FONT_SIZE) == 0);
+
+    for (const char* mode : { "hinted", "light" })
+    {
+        const FT_Int32 flags = FT_LOAD_RENDER | (strcmp(mode, "light") == 0 ? FT_LOAD_TARGET_LIGHT : 0);
+
+        AEDI_BENCH(aedi::Format("rasterize/freetype/%s", mode), Operations, TotalLength())
+        {
+            for (const char* line : LINES)
+            {
+                for (const char* ch = line; *ch != '\0'; ++ch)
+                    AEDI_EXPECT(FT_Load_Char(face, FT_ULong(*ch), flags) == 0);
+            }
+        }
+    }
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+static void MeasureRendering(const std::string& path)
+{
+    AEDI_EXPECT(TTF_Init() == 0);
+
+    const SDL_version* version = TTF_Linked_Version();
+    aedi::Info("sdl2_ttf_version", "%d.%d.%d", version->major, version->minor, version->patch);
+
+    TTF_Font* font = TTF_OpenFont(path.c_str(), FONT_SIZE);
+    AEDI_EXPECT(font != nullptr);
+
+    const SDL_Color color = { 255, 255, 255, 255 };
+
+    // Change of font style flushes glyph cache, so every glyph is rasterized again like with new font or size
+    AEDI_BENCH("render/sdl2_ttf/blended/uncached", Operations, TotalLength())
+    {
+        TTF_SetFontStyle(font, TTF_STYLE_BOLD);
+        TTF_SetFontStyle(font, TTF_STYLE_NORMAL);
+
+        for (const char* line : LINES)
+        {
+            SDL_Surface* surface = TTF_RenderUTF8_Blended(font, line, color);
+            AEDI_EXPECT(surface != nullptr);
+            SDL_FreeSurface(surface);
+        }
+    }
+
+    AEDI_BENCH("render/sdl2_ttf/blended", Operations, TotalLength())
+    {
+        for (const char* line : LINES)
+        {
+            SDL_Surface* surface = TTF_RenderUTF8_Blended(font, line, color);
+            AEDI_EXPECT(surface != nullptr);
+            SDL_FreeSurface(surface);
+        }
+    }
+
+    TTF_CloseFont(font);
+    TTF_Quit();
+}
+
+int main()
+{
+    aedi::Info("harfbuzz_version", "%s", hb_version_string());
+    aedi::PrintCpuFeatures();
+
+    const std::string path = FindFont();
+
+    if (path.empty())
+    {
+        aedi::Info("font", "%s", "not found, set AEDI_BENCH_FONT");
+        return 0;
+    }
+
+    aedi::Info("font", "%s", path.c_str());
+
+    MeasureShaping(path);
+    MeasureRasterization(path);
+    MeasureRendering(path);
+
+    return 0;
+}
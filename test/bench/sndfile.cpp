@@ -0,0 +1,490 @@
+// pkg-config: sndfile flac wavpack
+#include <math.h>
+#include <sndfile.h>
+#include <FLAC/stream_decoder.h>
+#include <wavpack/wavpack.h>
+
+#include <string>
+#include <vector>
+
+// Sound effect decoding from memory, the way GZDoom loads sound lumps
+//
+// WAV, FLAC and Ogg Vorbis are decoded by libsndfile via virtual I/O, FLAC and WavPack are decoded by their own
+// libraries via stream callbacks. Every repetition opens, decodes and closes the whole sound, so small sounds
+// show per-call overhead, i.e. format detection, decoder allocation and header parsing. Open benchmarks measure
+// this overhead alone. libsndfile has no WavPack support, so WavPack is decoded by its library only
+// Throughput is in bytes of 16-bit PCM
+//
+// Music track is decoded by libFLAC too, it shows whether lossless music packs can be decoded while streaming
+// Ogg Vorbis music track is opened and restarted from its loop start, like ZMusic streams do, libsndfile built
+// with --ogg-seek-index option scans Ogg pages on open, and searches only two of them on seek
+// LPC restore functions with SIMD intrinsics, and WavPack assembly functions, linked into executable are printed
+
+static constexpr int SAMPLE_RATE = 44100;
+static constexpr int SIZES[] = { 1, 4, 16, 50 };  // KiB of 16-bit mono PCM
+
+// Sound effects decode in microseconds, more repetitions than default make percentiles stable
+static constexpr int REPETITIONS = 500;
+
+static constexpr int MUSIC_DURATION = 30;  // seconds
+static constexpr sf_count_t LOOP_BUFFER_FRAMES = 4096;
+
+struct MemoryFile
+{
+    std::vector<uint8_t>* data;
+    int64_t position;
+
+    int64_t Length() const
+    {
+        return int64_t(data->size());
+    }
+
+    int64_t Read(void* buffer, int64_t count)
+    {
+        count = std::min(count, std::max(Length() - position, int64_t(0)));
+
+        if (count > 0)
+        {
+            memcpy(buffer, &(*data)[size_t(position)], size_t(count));
+            position += count;
+        }
+
+        return count;
+    }
+
+    int64_t Write(const void* buffer, int64_t count)
+    {
+        const size_t end = size_t(position + count);
+
+        if (data->size() < end)
+            data->resize(end);
+
+        memcpy(&(*data)[size_t(position)], buffer, size_t(count));
+        position += count;
+
+        return count;
+    }
+
+    int64_t Seek(int64_t offset, int whence)
+    {
+        if (whence == SEEK_CUR)
+            offset += position;
+        else if (whence == SEEK_END)
+            offset += Length();
+
+        position = offset;
+        return offset;
+    }
+};
+
+static MemoryFile& File(void* user_data)
+{
+    return *static_cast<MemoryFile*>(user_data);
+}
+
+static SF_VIRTUAL_IO SNDFILE_IO =
+{
+    [](void* user_data) -> sf_count_t { return File(user_data).Length(); },
+    [](sf_count_t offset, int whence, void* user_data) -> sf_count_t { return File(user_data).Seek(offset, whence); },
+    [](void* buffer, sf_count_t count, void* user_data) -> sf_count_t { return File(user_data).Read(buffer, count); },
+    [](const void* buffer, sf_count_t count, void* user_data) -> sf_count_t { return File(user_data).Write(buffer, count); },
+    [](void* user_data) -> sf_count_t { return File(user_data).position; },
+};
+
+static WavpackStreamReader64 WAVPACK_READER =
+{
+    [](void* id, void* data, int32_t count) { return int32_t(File(id).Read(data, count)); },
+    nullptr,  // write_bytes
+    [](void* id) { return File(id).position; },
+    [](void* id, int64_t position) { File(id).position = position; return 0; },
+    [](void* id, int64_t delta, int mode) { File(id).Seek(delta, mode); return 0; },
+    [](void* id, int c) { --File(id).position; return c; },
+    [](void* id) { return File(id).Length(); },
+    [](void*) { return 1; },  // can_seek
+    nullptr,  // truncate_here
+    nullptr,  // close
+};
+
+// Impact-like sound, decaying noise burst with a low tone
+static std::vector<int16_t> MakeSound(size_t frames)
+{
+    std::vector<int16_t> sound(frames);
+    uint32_t state = 0x5EED;
+
+    for (size_t i = 0; i < frames; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        const double time = double(i) / SAMPLE_RATE;
+        const double envelope = exp(-time * 20);
+        const double value = envelope * (0.6 * (double(state) / UINT32_MAX - 0.5) + 0.4 * sin(2 * M_PI * 90 * time));
+        sound[i] = int16_t(value * 32767);
+    }
+
+    return sound;
+}
+
+// Music-like sound, chord with vibrato and a bit of noise, so it doesn't compress better than real music
+static std::vector<int16_t> MakeMusic(size_t frames)
+{
+    std::vector<int16_t> music(frames);
+    uint32_t state = 0xBEA7;
+
+    for (size_t i = 0; i < frames; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        const double time = double(i) / SAMPLE_RATE;
+        const double vibrato = 1.0 + 0.005 * sin(2 * M_PI * 5 * time);
+        const double value = 0.3 * sin(2 * M_PI * 220 * vibrato * time) + 0.2 * sin(2 * M_PI * 277.18 * time)
+            + 0.15 * sin(2 * M_PI * 329.63 * time) + 0.05 * (double(state) / UINT32_MAX - 0.5);
+        music[i] = int16_t(value * 32767);
+    }
+
+    return music;
+}
+
+// libFLAC chooses LPC functions at runtime, the ones with intrinsics have instruction set in their names
+static void PrintFlacIntrinsics(const char* path)
+{
+    static const char* const INSTRUCTION_SETS[] = { "_sse2", "_sse41", "_avx2", "_fma", "_neon" };
+    std::string functions;
+
+    for (const std::string& symbol : aedi::LinkedSymbols(path))
+    {
+        if (symbol.compare(0, 11, "_FLAC__lpc_") != 0)
+            continue;
+
+        for (const char* instruction_set : INSTRUCTION_SETS)
+        {
+            if (symbol.find(instruction_set) != std::string::npos)
+            {
+                functions += (functions.empty() ? "" : " ") + symbol.substr(1);
+                break;
+            }
+        }
+    }
+
+    aedi::Info("flac_intrinsics", "%s", functions.empty() ? "none" : functions.c_str());
+}
+
+// Assembly versions of WavPack decorrelation passes, used for unpacking when they are linked
+static size_t CountWavpackAssembly(const char* path)
+{
+    size_t count = 0;
+
+    for (const std::string& symbol : aedi::LinkedSymbols(path))
+    {
+        if (symbol.find("_decorr_") != std::string::npos && symbol.find("_x64") != std::string::npos)
+            ++count;
+    }
+
+    return count;
+}
+
+static std::vector<uint8_t> EncodeSndfile(const std::vector<int16_t>& sound, int format)
+{
+    std::vector<uint8_t> data;
+    MemoryFile file = { &data, 0 };
+
+    SF_INFO info = {};
+    info.samplerate = SAMPLE_RATE;
+    info.channels = 1;
+    info.format = format;
+
+    SNDFILE* sndfile = sf_open_virtual(&SNDFILE_IO, SFM_WRITE, &info, &file);
+
+    if (sndfile == nullptr)
+        return {};
+
+    const sf_count_t frames = sf_count_t(sound.size());
+    const bool written = sf_writef_short(sndfile, sound.data(), frames) == frames;
+
+    if (sf_close(sndfile) != 0 || !written)
+        return {};
+
+    return data;
+}
+
+static std::vector<uint8_t> EncodeWavpack(const std::vector<int16_t>& sound)
+{
+    std::vector<uint8_t> data;
+
+    auto write_block = [](void* id, void* block, int32_t size)
+    {
+        const uint8_t* begin = static_cast<const uint8_t*>(block);
+        std::vector<uint8_t>* output = static_cast<std::vector<uint8_t>*>(id);
+        output->insert(output->end(), begin, begin + size);
+        return 1;
+    };
+
+    WavpackContext* context = WavpackOpenFileOutput(write_block, &data, nullptr);
+
+    if (context == nullptr)
+        return {};
+
+    WavpackConfig config = {};
+    config.bits_per_sample = 16;
+    config.bytes_per_sample = 2;
+    config.num_channels = 1;
+    config.channel_mask = 4;  // front center
+    config.sample_rate = SAMPLE_RATE;
+
+    std::vector<int32_t> samples(sound.begin(), sound.end());
+
+    const bool encoded = WavpackSetConfiguration(context, &config, uint32_t(samples.size()))
+        && WavpackPackInit(context)
+        && WavpackPackSamples(context, samples.data(), uint32_t(samples.size()))
+        && WavpackFlushSamples(context);
+
+    WavpackCloseFile(context);
+
+    return encoded ? data : std::vector<uint8_t>();
+}
+
+static sf_count_t DecodeSndfile(std::vector<uint8_t>& data, std::vector<float>& output, bool open_only)
+{
+    MemoryFile file = { &data, 0 };
+    SF_INFO info = {};
+
+    SNDFILE* sndfile = sf_open_virtual(&SNDFILE_IO, SFM_READ, &info, &file);
+
+    if (sndfile == nullptr)
+        return -1;
+
+    const sf_count_t frames = open_only ? 0 : sf_readf_float(sndfile, output.data(), sf_count_t(output.size()));
+    sf_close(sndfile);
+
+    return frames;
+}
+
+struct FlacStream
+{
+    MemoryFile file;
+    std::vector<int16_t>& output;
+    size_t frames;
+};
+
+static long DecodeFlac(std::vector<uint8_t>& data, std::vector<int16_t>& output, bool open_only)
+{
+    FLAC__StreamDecoder* decoder = FLAC__stream_decoder_new();
+
+    if (decoder == nullptr)
+        return -1;
+
+    FlacStream stream = { { &data, 0 }, output, 0 };
+
+    auto read = [](const FLAC__StreamDecoder*, FLAC__byte buffer[], size_t* bytes, void* user_data)
+    {
+        *bytes = size_t(static_cast<FlacStream*>(user_data)->file.Read(buffer, int64_t(*bytes)));
+        return *bytes > 0 ? FLAC__STREAM_DECODER_READ_STATUS_CONTINUE : FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+    };
+    auto seek = [](const FLAC__StreamDecoder*, FLAC__uint64 offset, void* user_data)
+    {
+        static_cast<FlacStream*>(user_data)->file.position = int64_t(offset);
+        return FLAC__STREAM_DECODER_SEEK_STATUS_OK;
+    };
+    auto tell = [](const FLAC__StreamDecoder*, FLAC__uint64* offset, void* user_data)
+    {
+        *offset = FLAC__uint64(static_cast<FlacStream*>(user_data)->file.position);
+        return FLAC__STREAM_DECODER_TELL_STATUS_OK;
+    };
+    auto length = [](const FLAC__StreamDecoder*, FLAC__uint64* length, void* user_data)
+    {
+        *length = FLAC__uint64(static_cast<FlacStream*>(user_data)->file.Length());
+        return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
+    };
+    auto eof = [](const FLAC__StreamDecoder*, void* user_data) -> FLAC__bool
+    {
+        const MemoryFile& file = static_cast<FlacStream*>(user_data)->file;
+        return file.position >= file.Length();
+    };
+    auto write = [](const FLAC__StreamDecoder*, const FLAC__Frame* frame, const FLAC__int32* const buffer[], void* user_data)
+    {
+        FlacStream* stream = static_cast<FlacStream*>(user_data);
+        const size_t count = std::min(size_t(frame->header.blocksize), stream->output.size() - stream->frames);
+
+        for (size_t i = 0; i < count; ++i)
+            stream->output[stream->frames + i] = int16_t(buffer[0][i]);
+
+        stream->frames += count;
+        return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+    };
+    auto error = [](const FLAC__StreamDecoder*, FLAC__StreamDecoderErrorStatus, void*) {};
+
+    const bool decoded = FLAC__stream_decoder_init_stream(decoder, read, seek, tell, length, eof, write, nullptr, error,
+            &stream) == FLAC__STREAM_DECODER_INIT_STATUS_OK
+        && (open_only ? FLAC__stream_decoder_process_until_end_of_metadata(decoder)
+            : FLAC__stream_decoder_process_until_end_of_stream(decoder));
+
+    FLAC__stream_decoder_finish(decoder);
+    FLAC__stream_decoder_delete(decoder);
+
+    return decoded ? long(stream.frames) : -1;
+}
+
+static long DecodeWavpack(std::vector<uint8_t>& data, std::vector<int32_t>& output, bool open_only)
+{
+    MemoryFile file = { &data, 0 };
+    char error[80];
+
+    WavpackContext* context = WavpackOpenFileInputEx64(&WAVPACK_READER, &file, nullptr, error, 0, 0);
+
+    if (context == nullptr)
+        return -1;
+
+    const uint32_t frames = open_only ? 0 : WavpackUnpackSamples(context, output.data(), uint32_t(output.size()));
+    WavpackCloseFile(context);
+
+    return long(frames);
+}
+
+int main(int, char** argv)
+{
+    aedi::Info("sndfile_version", "%s", sf_version_string());
+    aedi::Info("flac_version", "%s", FLAC__VERSION_STRING);
+    aedi::Info("wavpack_version", "%s", WavpackGetLibraryVersionString());
+    aedi::PrintCpuFeatures();
+    PrintFlacIntrinsics(argv[0]);
+
+    const size_t wavpack_assembly = CountWavpackAssembly(argv[0]);
+    aedi::Info("wavpack_assembly_functions", "%zu", wavpack_assembly);
+
+#if defined(__x86_64__)
+    AEDI_EXPECT(wavpack_assembly > 0);
+#endif
+
+    static const struct
+    {
+        const char* name;
+        int format;
+    }
+    SNDFILE_FORMATS[] =
+    {
+        { "wav", SF_FORMAT_WAV | SF_FORMAT_PCM_16 },
+        { "flac", SF_FORMAT_FLAC | SF_FORMAT_PCM_16 },
+        { "vorbis", SF_FORMAT_OGG | SF_FORMAT_VORBIS },
+    };
+
+    for (int size : SIZES)
+    {
+        const size_t frames = size_t(size) * 1024 / sizeof(int16_t);
+        const std::vector<int16_t> sound = MakeSound(frames);
+        const double bytes = double(frames * sizeof(int16_t));
+
+        // Decoders may return a bit more than was encoded, e.g. because of codec padding
+        std::vector<float> float_output(frames + 4096);
+        std::vector<int16_t> short_output(frames + 4096);
+        std::vector<int32_t> int_output(frames + 4096);
+
+        for (const auto& format : SNDFILE_FORMATS)
+        {
+            std::vector<uint8_t> data = EncodeSndfile(sound, format.format);
+            AEDI_EXPECT(!data.empty());
+
+            const std::string suffix = aedi::Format("%s/sndfile/%dk", format.name, size);
+            aedi::Info(("encoded_size/" + suffix).c_str(), "%zu", data.size());
+
+            AEDI_BENCH_COUNT("decode/" + suffix, Bytes, bytes, REPETITIONS)
+            {
+                AEDI_EXPECT(DecodeSndfile(data, float_output, false) >= sf_count_t(frames));
+            }
+
+            if (size == SIZES[0])
+            {
+                AEDI_BENCH_COUNT(aedi::Format("open/%s/sndfile", format.name), Operations, 1, REPETITIONS)
+                {
+                    AEDI_EXPECT(DecodeSndfile(data, float_output, true) == 0);
+                }
+            }
+
+            // The same FLAC stream through libFLAC directly
+            if (format.format == (SF_FORMAT_FLAC | SF_FORMAT_PCM_16))
+            {
+                AEDI_BENCH_COUNT(aedi::Format("decode/flac/libflac/%dk", size), Bytes, bytes, REPETITIONS)
+                {
+                    AEDI_EXPECT(DecodeFlac(data, short_output, false) == long(frames));
+                }
+
+                AEDI_EXPECT(memcmp(short_output.data(), sound.data(), frames * sizeof(int16_t)) == 0);
+
+                if (size == SIZES[0])
+                {
+                    AEDI_BENCH_COUNT("open/flac/libflac", Operations, 1, REPETITIONS)
+                    {
+                        AEDI_EXPECT(DecodeFlac(data, short_output, true) == 0);
+                    }
+                }
+            }
+        }
+
+        std::vector<uint8_t> wavpack = EncodeWavpack(sound);
+        AEDI_EXPECT(!wavpack.empty());
+        aedi::Info(aedi::Format("encoded_size/wavpack/wavpack/%dk", size).c_str(), "%zu", wavpack.size());
+
+        AEDI_BENCH_COUNT(aedi::Format("decode/wavpack/wavpack/%dk", size), Bytes, bytes, REPETITIONS)
+        {
+            AEDI_EXPECT(DecodeWavpack(wavpack, int_output, false) == long(frames));
+        }
+
+        AEDI_EXPECT(std::equal(sound.begin(), sound.end(), int_output.begin()));
+
+        if (size == SIZES[0])
+        {
+            AEDI_BENCH_COUNT("open/wavpack/wavpack", Operations, 1, REPETITIONS)
+            {
+                AEDI_EXPECT(DecodeWavpack(wavpack, int_output, true) == 0);
+            }
+        }
+    }
+
+    {
+        const size_t frames = size_t(SAMPLE_RATE) * MUSIC_DURATION;
+        const std::vector<int16_t> music = MakeMusic(frames);
+        std::vector<int16_t> output(frames + 4096);
+
+        std::vector<uint8_t> data = EncodeSndfile(music, SF_FORMAT_FLAC | SF_FORMAT_PCM_16);
+        AEDI_EXPECT(!data.empty());
+        aedi::Info("encoded_size/flac/libflac/music", "%zu", data.size());
+
+        AEDI_BENCH("decode/flac/libflac/music", Bytes, double(frames * sizeof(int16_t)))
+        {
+            AEDI_EXPECT(DecodeFlac(data, output, false) == long(frames));
+        }
+
+        AEDI_EXPECT(memcmp(output.data(), music.data(), frames * sizeof(int16_t)) == 0);
+
+        // Loop restart of streamed music, seek to loop start and decode of one buffer
+        std::vector<uint8_t> vorbis = EncodeSndfile(music, SF_FORMAT_OGG | SF_FORMAT_VORBIS);
+        AEDI_EXPECT(!vorbis.empty());
+        aedi::Info("encoded_size/vorbis/sndfile/music", "%zu", vorbis.size());
+
+        std::vector<float> buffer(LOOP_BUFFER_FRAMES);
+
+        AEDI_BENCH_COUNT("open/vorbis/sndfile/music", Operations, 1, REPETITIONS)
+        {
+            AEDI_EXPECT(DecodeSndfile(vorbis, buffer, true) == 0);
+        }
+
+        MemoryFile file = { &vorbis, 0 };
+        SF_INFO info = {};
+        SNDFILE* sndfile = sf_open_virtual(&SNDFILE_IO, SFM_READ, &info, &file);
+        AEDI_EXPECT(sndfile != nullptr);
+
+        const sf_count_t loop_start = sf_count_t(SAMPLE_RATE) * MUSIC_DURATION / 3;
+
+        AEDI_BENCH_COUNT("seek/vorbis/sndfile/music", Operations, 1, REPETITIONS)
+        {
+            AEDI_EXPECT(sf_seek(sndfile, loop_start, SEEK_SET) == loop_start);
+            AEDI_EXPECT(sf_readf_float(sndfile, buffer.data(), LOOP_BUFFER_FRAMES) == LOOP_BUFFER_FRAMES);
+        }
+
+        sf_close(sndfile);
+    }
+
+    return 0;
+}
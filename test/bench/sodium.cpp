@@ -0,0 +1,78 @@
+// pkg-config: libsodium
+#include <sodium.h>
+
+#include <vector>
+
+// Encryption throughput of packet and save sized messages, like multiplayer traffic of DevilutionX
+//
+// secretbox is XSalsa20 with Poly1305, AEAD constructions are ChaCha20 with Poly1305 and AES-256 in GCM mode
+// AES-GCM requires ARMv8 crypto extension or AES-NI with PCLMUL, so its availability is checked on every slice,
+// and the benchmark fails if accelerated implementation was not compiled in, or was not selected at runtime
+
+static constexpr size_t MESSAGE_SIZES[] = { 64, 1024, 65536 };
+
+template <typename Function>
+static void MeasureEncryption(const char* name, size_t overhead, Function encrypt)
+{
+    for (size_t size : MESSAGE_SIZES)
+    {
+        std::vector<unsigned char> message(size, 0x5a);
+        std::vector<unsigned char> ciphertext(size + overhead);
+
+        AEDI_BENCH(aedi::Format("%s/%zu", name, size), Bytes, size)
+        {
+            AEDI_EXPECT(encrypt(ciphertext.data(), message.data(), size) == 0);
+            aedi::DoNotOptimize(ciphertext);
+        }
+    }
+}
+
+int main()
+{
+    AEDI_EXPECT(sodium_init() >= 0);
+
+    aedi::Info("sodium_version", "%s", sodium_version_string());
+    aedi::PrintCpuFeatures();
+
+    AEDI_EXPECT(crypto_aead_aes256gcm_is_available() == 1);
+
+    unsigned char secretbox_key[crypto_secretbox_KEYBYTES];
+    crypto_secretbox_keygen(secretbox_key);
+
+    unsigned char secretbox_nonce[crypto_secretbox_NONCEBYTES];
+    randombytes_buf(secretbox_nonce, sizeof secretbox_nonce);
+
+    MeasureEncryption("secretbox", crypto_secretbox_MACBYTES,
+        [&](unsigned char* ciphertext, const unsigned char* message, size_t size)
+        {
+            return crypto_secretbox_easy(ciphertext, message, size, secretbox_nonce, secretbox_key);
+        });
+
+    unsigned char chacha20_key[crypto_aead_chacha20poly1305_ietf_KEYBYTES];
+    crypto_aead_chacha20poly1305_ietf_keygen(chacha20_key);
+
+    unsigned char chacha20_nonce[crypto_aead_chacha20poly1305_ietf_NPUBBYTES];
+    randombytes_buf(chacha20_nonce, sizeof chacha20_nonce);
+
+    MeasureEncryption("aead/chacha20poly1305", crypto_aead_chacha20poly1305_ietf_ABYTES,
+        [&](unsigned char* ciphertext, const unsigned char* message, size_t size)
+        {
+            return crypto_aead_chacha20poly1305_ietf_encrypt(ciphertext, nullptr, message, size,
+                nullptr, 0, nullptr, chacha20_nonce, chacha20_key);
+        });
+
+    unsigned char aes256gcm_key[crypto_aead_aes256gcm_KEYBYTES];
+    crypto_aead_aes256gcm_keygen(aes256gcm_key);
+
+    unsigned char aes256gcm_nonce[crypto_aead_aes256gcm_NPUBBYTES];
+    randombytes_buf(aes256gcm_nonce, sizeof aes256gcm_nonce);
+
+    MeasureEncryption("aead/aes256gcm", crypto_aead_aes256gcm_ABYTES,
+        [&](unsigned char* ciphertext, const unsigned char* message, size_t size)
+        {
+            return crypto_aead_aes256gcm_encrypt(ciphertext, nullptr, message, size,
+                nullptr, 0, nullptr, aes256gcm_nonce, aes256gcm_key);
+        });
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <math.h>
+#include <soxr.h>
+
+#include <string>
+#include <vector>
+
+// Sample rate conversion of music streams by libsoxr, with the same rates and blocks as libsamplerate benchmark
+//
+// Every repetition converts one block, input wraps around, so the whole stream is converted once per measurement
+// Quality recipes are compared with sinc converters of libsamplerate, e.g. HQ with sinc_medium, VHQ with sinc_best
+// DFT engine is printed for every converter, its name ends with 's' when SIMD code is used
+
+static constexpr int DURATION = 5;  // seconds of input
+static constexpr int BLOCK_SIZE = 512;  // input frames per block
+
+// Sum of tones up to 40 % of source rate, channels differ in tone phases
+static std::vector<float> MakeInput(int rate, int channels)
+{
+    static constexpr double TONES[] = { 0.01, 0.05, 0.12, 0.2, 0.3, 0.4 };  // fractions of source rate
+
+    const size_t frames = size_t(DURATION) * rate;
+    std::vector<float> input(frames * channels);
+
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        for (int channel = 0; channel < channels; ++channel)
+        {
+            double value = 0;
+
+            for (size_t i = 0; i < sizeof TONES / sizeof TONES[0]; ++i)
+                value += 0.15 * sin(2 * M_PI * TONES[i] * frame + channel * (i + 1));
+
+            input[frame * channels + channel] = float(value);
+        }
+    }
+
+    return input;
+}
+
+int main()
+{
+    aedi::Info("soxr_version", "%s", soxr_version());
+    aedi::PrintCpuFeatures();
+
+    static const struct
+    {
+        const char* name;
+        unsigned long recipe;
+    }
+    QUALITIES[] =
+    {
+        { "vhq", SOXR_VHQ },
+        { "hq", SOXR_HQ },
+        { "mq", SOXR_MQ },
+        { "lq", SOXR_LQ },
+    };
+
+    static const struct
+    {
+        int input;
+        int output;
+    }
+    RATES[] =
+    {
+        { 22050, 48000 },
+        { 44100, 48000 },
+        { 11025, 44100 },
+    };
+
+    for (const auto& rates : RATES)
+    {
+        const double ratio = double(rates.output) / rates.input;
+        const int block_count = DURATION * rates.input / BLOCK_SIZE;
+
+        for (int channels : { 1, 2 })
+        {
+            const std::vector<float> input = MakeInput(rates.input, channels);
+            const long total_frames = long(input.size() / channels);
+            std::vector<float> output(size_t(BLOCK_SIZE * ratio + 64) * channels);
+
+            for (const auto& quality : QUALITIES)
+            {
+                const std::string suffix = aedi::Format("%s/%d-%d/%s", quality.name, rates.input, rates.output,
+                    channels == 1 ? "mono" : "stereo");
+
+                const soxr_io_spec_t io_spec = soxr_io_spec(SOXR_FLOAT32_I, SOXR_FLOAT32_I);
+                const soxr_quality_spec_t quality_spec = soxr_quality_spec(quality.recipe, 0);
+
+                soxr_error_t error = nullptr;
+                soxr_t soxr = soxr_create(rates.input, rates.output, unsigned(channels), &error, &io_spec,
+                    &quality_spec, nullptr);
+                AEDI_EXPECT(soxr != nullptr && error == nullptr);
+
+                aedi::Info(("engine/" + suffix).c_str(), "%s", soxr_engine(soxr));
+
+                long position = 0;
+                aedi::Bench aedi_bench("process/" + suffix, aedi::Unit::Samples, BLOCK_SIZE * ratio, block_count);
+
+                while (aedi_bench.Next())
+                {
+                    if (position + BLOCK_SIZE > total_frames)
+                        position = 0;
+
+                    size_t input_done = 0, output_done = 0;
+                    AEDI_EXPECT(soxr_process(soxr, &input[position * channels], BLOCK_SIZE, &input_done,
+                        output.data(), output.size() / channels, &output_done) == nullptr);
+                    AEDI_EXPECT(input_done == BLOCK_SIZE);
+                    aedi::DoNotOptimize(output[0]);
+
+                    position += BLOCK_SIZE;
+                }
+
+                aedi::Info(("rtf/process/" + suffix).c_str(), "%.1f", DURATION * 1e9 / aedi_bench.TotalNanoseconds());
+                soxr_delete(soxr);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,1040 @@
+// pkg-config: libxmp libgme dumb libmodplug libmikmod
+#include <dlfcn.h>
+#include <math.h>
+#include <dumb.h>
+#include <mikmod.h>
+#include <xmp.h>
+#include <gme/gme.h>
+#include <libmodplug/modplug.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Tracker module and chip music rendering by every library that supports the given format
+//
+// The same song is stored as MOD, S3M, XM and IT, i.e. eight channels of notes retriggered every few rows
+// Chip music is VGM with YM2612 and SN76489 writes, and SPC with a small SPC700 program that retriggers DSP voices
+// Every repetition renders one block of 16-bit stereo, so results are comparable between libraries and formats
+// Songs use no effects, so they measure mixing and interpolation, not effect processing of real music
+// On arm64, DUMB renders with NEON kernels of its cubic and FIR resamplers, they are compared with scalar code
+
+static constexpr int BLOCK_SIZE = 4096;  // sample frames
+static constexpr int DURATION = 20;  // seconds
+
+static constexpr int CHANNELS = 8;
+static constexpr int PATTERNS = 8;
+static constexpr int ROWS = 64;
+static constexpr int SEMITONES = 36;
+
+static constexpr int SAMPLE_LENGTH = 2048;
+static constexpr int SAMPLE_CYCLE = 32;  // about 261 Hz, i.e. C-4 at 8363 Hz
+
+class Writer
+{
+public:
+    std::vector<uint8_t> data;
+
+    size_t Size() const { return data.size(); }
+
+    void Bytes(const void* bytes, size_t size)
+    {
+        const uint8_t* begin = static_cast<const uint8_t*>(bytes);
+        data.insert(data.end(), begin, begin + size);
+    }
+
+    void String(const char* value, size_t size)
+    {
+        const size_t length = std::min(strlen(value), size);
+        Bytes(value, length);
+        Zeros(size - length);
+    }
+
+    void Zeros(size_t count) { data.insert(data.end(), count, 0); }
+
+    void Align(size_t alignment) { Zeros((alignment - data.size() % alignment) % alignment); }
+
+    void U8(unsigned value) { data.push_back(uint8_t(value)); }
+    void U16(unsigned value) { U8(value); U8(value >> 8); }
+    void U32(uint32_t value) { U16(value); U16(value >> 16); }
+
+    void BE16(unsigned value) { U8(value >> 8); U8(value); }
+
+    // Little endian value at the given offset, for pointers to data written later
+    void Patch16(size_t offset, unsigned value)
+    {
+        data[offset] = uint8_t(value);
+        data[offset + 1] = uint8_t(value >> 8);
+    }
+
+    void Patch32(size_t offset, uint32_t value)
+    {
+        Patch16(offset, value & 0xFFFF);
+        Patch16(offset + 2, value >> 16);
+    }
+};
+
+// Note of the channel at the given row as semitone from the lowest one, or -1 when nothing is triggered
+static int SongNote(int pattern, int row, int channel)
+{
+    return (row + channel) % 4 == 0 ? (channel * 5 + row * 7 + pattern * 3) % SEMITONES : -1;
+}
+
+// Bright waveform, square and saw mixed, signed 8-bit
+static std::vector<int8_t> MakeSample()
+{
+    std::vector<int8_t> sample(SAMPLE_LENGTH);
+
+    for (int i = 0; i < SAMPLE_LENGTH; ++i)
+    {
+        const int phase = i % SAMPLE_CYCLE;
+        const int saw = phase * 192 / SAMPLE_CYCLE - 96;
+        const int square = phase < SAMPLE_CYCLE / 2 ? 24 : -24;
+        sample[i] = int8_t(saw + square);
+    }
+
+    return sample;
+}
+
+// ProTracker 8-channel module, semitone 12 is C-2 with period 428
+static std::vector<uint8_t> MakeMod(const std::vector<int8_t>& sample)
+{
+    static const uint16_t PERIODS[SEMITONES] =
+    {
+        856, 808, 762, 720, 678, 640, 604, 570, 538, 508, 480, 453,
+        428, 404, 381, 360, 339, 320, 302, 285, 269, 254, 240, 226,
+        214, 202, 190, 180, 170, 160, 151, 143, 135, 127, 120, 113,
+    };
+
+    Writer mod;
+    mod.String("aedi benchmark", 20);
+
+    for (int i = 0; i < 31; ++i)
+    {
+        const unsigned words = i == 0 ? unsigned(sample.size() / 2) : 0;
+
+        mod.String("", 22);
+        mod.BE16(words);
+        mod.U8(0);  // finetune
+        mod.U8(i == 0 ? 64 : 0);  // volume
+        mod.BE16(0);  // loop start
+        mod.BE16(i == 0 ? words : 1);  // loop length
+    }
+
+    mod.U8(PATTERNS);  // song length
+    mod.U8(127);  // restart position
+
+    for (int i = 0; i < 128; ++i)
+        mod.U8(i < PATTERNS ? i : 0);
+
+    mod.Bytes("8CHN", 4);
+
+    for (int pattern = 0; pattern < PATTERNS; ++pattern)
+    {
+        for (int row = 0; row < ROWS; ++row)
+        {
+            for (int channel = 0; channel < CHANNELS; ++channel)
+            {
+                const int note = SongNote(pattern, row, channel);
+                const unsigned period = note < 0 ? 0 : PERIODS[note];
+                const unsigned instrument = note < 0 ? 0 : 1;
+
+                mod.U8((instrument & 0xF0) | (period >> 8));
+                mod.U8(period & 0xFF);
+                mod.U8((instrument & 0x0F) << 4);  // no effect
+                mod.U8(0);
+            }
+        }
+    }
+
+    mod.Bytes(sample.data(), sample.size());
+    return mod.data;
+}
+
+// Scream Tracker 3 module, semitone 12 is C-4 that plays at C2Spd, pointers are in 16-byte paragraphs
+static std::vector<uint8_t> MakeS3m(const std::vector<int8_t>& sample)
+{
+    Writer s3m;
+    s3m.String("aedi benchmark", 28);
+    s3m.U8(0x1A);
+    s3m.U8(16);  // module type
+    s3m.U16(0);
+    s3m.U16(PATTERNS);  // order count, even
+    s3m.U16(1);  // instrument count
+    s3m.U16(PATTERNS);
+    s3m.U16(0);  // flags
+    s3m.U16(0x1320);  // Scream Tracker 3.20
+    s3m.U16(1);  // signed samples
+    s3m.Bytes("SCRM", 4);
+    s3m.U8(64);  // global volume
+    s3m.U8(6);  // speed
+    s3m.U8(125);  // tempo
+    s3m.U8(0x80 | 48);  // stereo, master volume
+    s3m.U8(0);  // ultra click removal
+    s3m.U8(0);  // no default panning
+    s3m.Zeros(8);
+    s3m.U16(0);  // special
+
+    // Channels alternate between left and right
+    for (int channel = 0; channel < 32; ++channel)
+        s3m.U8(channel < CHANNELS ? (channel & 1) * 8 + channel / 2 : 255);
+
+    for (int pattern = 0; pattern < PATTERNS; ++pattern)
+        s3m.U8(pattern);
+
+    const size_t instrument_pointer = s3m.Size();
+    s3m.U16(0);
+
+    const size_t pattern_pointers = s3m.Size();
+    s3m.Zeros(PATTERNS * 2);
+
+    s3m.Align(16);
+    s3m.Patch16(instrument_pointer, unsigned(s3m.Size() / 16));
+
+    s3m.U8(1);  // sample
+    s3m.String("", 12);
+    const size_t sample_pointer = s3m.Size();
+    s3m.Zeros(3);
+    s3m.U32(uint32_t(sample.size()));
+    s3m.U32(0);  // loop begin
+    s3m.U32(uint32_t(sample.size()));  // loop end
+    s3m.U8(64);  // volume
+    s3m.U8(0);
+    s3m.U8(0);  // not packed
+    s3m.U8(1);  // looped
+    s3m.U32(8363);  // C2Spd
+    s3m.Zeros(12);
+    s3m.String("", 28);
+    s3m.Bytes("SCRS", 4);
+
+    for (int pattern = 0; pattern < PATTERNS; ++pattern)
+    {
+        s3m.Align(16);
+        s3m.Patch16(pattern_pointers + pattern * 2, unsigned(s3m.Size() / 16));
+
+        const size_t start = s3m.Size();
+        s3m.U16(0);  // packed size including itself
+
+        for (int row = 0; row < ROWS; ++row)
+        {
+            for (int channel = 0; channel < CHANNELS; ++channel)
+            {
+                const int note = SongNote(pattern, row, channel);
+
+                if (note >= 0)
+                {
+                    s3m.U8(0x20 | channel);  // note and instrument follow
+                    s3m.U8((3 + note / 12) << 4 | note % 12);
+                    s3m.U8(1);
+                }
+            }
+
+            s3m.U8(0);  // end of row
+        }
+
+        s3m.Patch16(start, unsigned(s3m.Size() - start));
+    }
+
+    s3m.Align(16);
+    const size_t sample_paragraph = s3m.Size() / 16;
+    s3m.data[sample_pointer] = uint8_t(sample_paragraph >> 16);
+    s3m.Patch16(sample_pointer + 1, sample_paragraph & 0xFFFF);
+
+    s3m.Bytes(sample.data(), sample.size());
+    return s3m.data;
+}
+
+// FastTracker II module with linear frequencies, semitone 12 is C-4 that plays at 8363 Hz
+static std::vector<uint8_t> MakeXm(const std::vector<int8_t>& sample)
+{
+    Writer xm;
+    xm.Bytes("Extended Module: ", 17);
+    xm.String("aedi benchmark", 20);
+    xm.U8(0x1A);
+    xm.String("aedi", 20);
+    xm.U16(0x0104);
+    xm.U32(276);  // header size, from this field
+    xm.U16(PATTERNS);  // song length
+    xm.U16(0);  // restart position
+    xm.U16(CHANNELS);
+    xm.U16(PATTERNS);
+    xm.U16(1);  // instrument count
+    xm.U16(1);  // linear frequency table
+    xm.U16(6);  // speed
+    xm.U16(125);  // tempo
+
+    for (int i = 0; i < 256; ++i)
+        xm.U8(i < PATTERNS ? i : 0);
+
+    for (int pattern = 0; pattern < PATTERNS; ++pattern)
+    {
+        xm.U32(9);  // header size
+        xm.U8(0);  // packing type
+        xm.U16(ROWS);
+
+        const size_t size = xm.Size();
+        xm.U16(0);
+
+        for (int row = 0; row < ROWS; ++row)
+        {
+            for (int channel = 0; channel < CHANNELS; ++channel)
+            {
+                const int note = SongNote(pattern, row, channel);
+
+                if (note < 0)
+                    xm.U8(0x80);  // packed empty note
+                else
+                {
+                    xm.U8(0x83);  // packed note and instrument
+                    xm.U8(37 + note);
+                    xm.U8(1);
+                }
+            }
+        }
+
+        xm.Patch16(size, unsigned(xm.Size() - size - 2));
+    }
+
+    xm.U32(263);  // instrument header size
+    xm.String("", 22);
+    xm.U8(0);  // type
+    xm.U16(1);  // sample count
+    xm.U32(40);  // sample header size
+    xm.Zeros(96);  // note to sample map
+    xm.Zeros(48);  // volume envelope
+    xm.Zeros(48);  // panning envelope
+    xm.Zeros(2);  // envelope point counts
+    xm.Zeros(6);  // envelope sustain and loop points
+    xm.Zeros(2);  // envelope types
+    xm.Zeros(4);  // vibrato
+    xm.U16(0);  // volume fadeout
+    xm.Zeros(22);
+
+    xm.U32(uint32_t(sample.size()));
+    xm.U32(0);  // loop start
+    xm.U32(uint32_t(sample.size()));  // loop length
+    xm.U8(64);  // volume
+    xm.U8(0);  // finetune
+    xm.U8(1);  // forward loop, 8-bit
+    xm.U8(128);  // panning
+    xm.U8(0);  // relative note
+    xm.U8(0);
+    xm.String("", 22);
+
+    // Sample data is delta encoded
+    int8_t previous = 0;
+
+    for (int8_t value : sample)
+    {
+        xm.U8(uint8_t(value - previous));
+        previous = value;
+    }
+
+    return xm.data;
+}
+
+// Impulse Tracker module in sample mode, semitone 12 is C-5 that plays at C5Speed
+static std::vector<uint8_t> MakeIt(const std::vector<int8_t>& sample)
+{
+    Writer it;
+    it.Bytes("IMPM", 4);
+    it.String("aedi benchmark", 26);
+    it.U16(0x1004);  // pattern row highlight
+    it.U16(PATTERNS + 1);  // order count, including end marker
+    it.U16(0);  // instrument count
+    it.U16(1);  // sample count
+    it.U16(PATTERNS);
+    it.U16(0x0214);  // created with
+    it.U16(0x0214);  // compatible with
+    it.U16(1 | 8);  // stereo, linear slides
+    it.U16(0);  // special
+    it.U8(128);  // global volume
+    it.U8(48);  // mixing volume
+    it.U8(6);  // speed
+    it.U8(125);  // tempo
+    it.U8(128);  // panning separation
+    it.U8(0);  // pitch wheel depth
+    it.U16(0);  // message length
+    it.U32(0);  // message offset
+    it.U32(0);
+
+    // Channels alternate between left and right, unused ones are disabled
+    for (int channel = 0; channel < 64; ++channel)
+        it.U8(channel < CHANNELS ? (channel & 1) * 64 : 128 | 32);
+
+    for (int channel = 0; channel < 64; ++channel)
+        it.U8(64);
+
+    for (int pattern = 0; pattern < PATTERNS; ++pattern)
+        it.U8(pattern);
+
+    it.U8(255);  // end of song
+
+    const size_t sample_offset = it.Size();
+    it.U32(0);
+
+    const size_t pattern_offsets = it.Size();
+    it.Zeros(PATTERNS * 4);
+
+    it.Patch32(sample_offset, uint32_t(it.Size()));
+    it.Bytes("IMPS", 4);
+    it.String("", 12);
+    it.U8(0);
+    it.U8(64);  // global volume
+    it.U8(1 | 16);  // sample present, looped
+    it.U8(64);  // volume
+    it.String("", 26);
+    it.U8(1);  // signed
+    it.U8(0);  // no default panning
+    it.U32(uint32_t(sample.size()));
+    it.U32(0);  // loop begin
+    it.U32(uint32_t(sample.size()));  // loop end
+    it.U32(8363);  // C5Speed
+    it.U32(0);  // sustain loop begin
+    it.U32(0);  // sustain loop end
+    const size_t data_offset = it.Size();
+    it.U32(0);
+    it.Zeros(4);  // vibrato
+
+    for (int pattern = 0; pattern < PATTERNS; ++pattern)
+    {
+        it.Patch32(pattern_offsets + pattern * 4, uint32_t(it.Size()));
+
+        const size_t size = it.Size();
+        it.U16(0);  // packed size, without pattern header
+        it.U16(ROWS);
+        it.Zeros(4);
+
+        for (int row = 0; row < ROWS; ++row)
+        {
+            for (int channel = 0; channel < CHANNELS; ++channel)
+            {
+                const int note = SongNote(pattern, row, channel);
+
+                if (note >= 0)
+                {
+                    it.U8(0x80 | (channel + 1));  // mask follows
+                    it.U8(1 | 2);  // note and instrument
+                    it.U8(48 + note);
+                    it.U8(1);
+                }
+            }
+
+            it.U8(0);  // end of row
+        }
+
+        it.Patch16(size, unsigned(it.Size() - size - 8));
+    }
+
+    it.Patch32(data_offset, uint32_t(it.Size()));
+    it.Bytes(sample.data(), sample.size());
+    return it.data;
+}
+
+// Sega Mega Drive music, six FM channels and three PSG tone channels change notes eight times per second
+static std::vector<uint8_t> MakeVgm()
+{
+    constexpr uint32_t PSG_CLOCK = 3579545;
+    constexpr uint32_t FM_CLOCK = 7670453;
+    constexpr int VGM_RATE = 44100;
+    constexpr int SONG_LENGTH = 60;  // seconds
+    constexpr int STEP = VGM_RATE / 8;  // samples between notes
+
+    Writer vgm;
+    vgm.Bytes("Vgm ", 4);
+    vgm.U32(0);  // end of file offset, relative
+    vgm.U32(0x150);
+    vgm.U32(PSG_CLOCK);
+    vgm.U32(0);  // YM2413 clock
+    vgm.U32(0);  // GD3 offset
+    vgm.U32(VGM_RATE * SONG_LENGTH);  // total samples
+    vgm.U32(0);  // loop offset
+    vgm.U32(0);  // loop samples
+    vgm.U32(60);  // rate
+    vgm.U16(0x0009);  // SN76489 feedback
+    vgm.U8(16);  // SN76489 shift register width
+    vgm.U8(0);  // SN76489 flags
+    vgm.U32(FM_CLOCK);
+    vgm.U32(0);  // YM2151 clock
+    vgm.U32(0x0C);  // data offset, relative
+    vgm.Zeros(8);
+
+    auto fm = [&vgm](int channel, unsigned reg, unsigned value)
+    {
+        vgm.U8(channel < 3 ? 0x52 : 0x53);
+        vgm.U8(reg + channel % 3);
+        vgm.U8(value);
+    };
+
+    auto key = [&vgm](int channel, bool on)
+    {
+        vgm.U8(0x52);
+        vgm.U8(0x28);
+        vgm.U8((on ? 0xF0 : 0) | (channel < 3 ? channel : channel + 1));
+    };
+
+    // Algorithm 4, two operator pairs, fast attack and moderate decay
+    for (int channel = 0; channel < 6; ++channel)
+    {
+        for (unsigned slot = 0; slot < 16; slot += 4)
+        {
+            const bool carrier = slot == 8 || slot == 12;  // operators 2 and 4
+
+            fm(channel, 0x30 + slot, 0x01 + slot / 4);  // detune, multiple
+            fm(channel, 0x40 + slot, carrier ? 0x10 : 0x24);  // total level
+            fm(channel, 0x50 + slot, 0x1F);  // attack rate
+            fm(channel, 0x60 + slot, 0x06);  // first decay rate
+            fm(channel, 0x70 + slot, 0x02);  // second decay rate
+            fm(channel, 0x80 + slot, 0x26);  // sustain level, release rate
+            fm(channel, 0x90 + slot, 0x00);  // SSG-EG
+        }
+
+        fm(channel, 0xB0, 0x2C);  // feedback, algorithm
+        fm(channel, 0xB4, 0xC0);  // both speakers
+    }
+
+    const double fm_rate = FM_CLOCK / 144.0;
+
+    for (int step = 0; step < SONG_LENGTH * VGM_RATE / STEP; ++step)
+    {
+        for (int channel = 0; channel < 6; ++channel)
+        {
+            const int semitone = (channel * 5 + step * 7) % SEMITONES;
+            const double frequency = 130.81 * pow(2.0, semitone / 12.0);
+
+            // The lowest block that fits frequency number into 11 bits
+            int block = 1;
+            unsigned number = 0;
+
+            while ((number = unsigned(frequency * (1 << 20) / fm_rate / (1 << (block - 1)) + 0.5)) > 0x7FF)
+                ++block;
+
+            key(channel, false);
+            fm(channel, 0xA4, block << 3 | number >> 8);
+            fm(channel, 0xA0, number & 0xFF);
+            key(channel, true);
+        }
+
+        for (unsigned channel = 0; channel < 3; ++channel)
+        {
+            const int semitone = (channel * 7 + step * 5) % SEMITONES;
+            const unsigned period = unsigned(PSG_CLOCK / (32 * 261.63 * pow(2.0, semitone / 12.0)));
+
+            vgm.U8(0x50);
+            vgm.U8(0x80 | channel << 5 | (period & 0x0F));
+            vgm.U8(0x50);
+            vgm.U8((period >> 4) & 0x3F);
+            vgm.U8(0x50);
+            vgm.U8(0x90 | channel << 5 | 2);  // attenuation
+        }
+
+        vgm.U8(0x61);  // wait
+        vgm.U16(STEP);
+    }
+
+    vgm.U8(0x66);  // end of data
+    vgm.Patch32(4, uint32_t(vgm.Size() - 4));
+    return vgm.data;
+}
+
+// SNES music, the program retriggers DSP voices one by one with new pitch on every timer tick,
+// all voices go through echo with feedback
+static std::vector<uint8_t> MakeSpc()
+{
+    constexpr size_t RAM_OFFSET = 0x100;
+    constexpr size_t DSP_OFFSET = 0x10100;
+    constexpr unsigned PROGRAM = 0x0200;
+    constexpr unsigned PITCH_LOW = 0x0300;
+    constexpr unsigned PITCH_HIGH = 0x0400;
+    constexpr unsigned VOICE_BITS = 0x0500;
+    constexpr unsigned DIRECTORY = 0x1000;
+    constexpr unsigned BRR = 0x1100;
+    constexpr unsigned ECHO = 0x6000;
+
+    Writer spc;
+    spc.Bytes("SNES-SPC700 Sound File Data v0.30", 33);
+    spc.U8(26);
+    spc.U8(26);
+    spc.U8(27);  // no ID666 tag
+    spc.U8(30);  // minor version
+    spc.U16(PROGRAM);  // PC
+    spc.U8(0);  // A
+    spc.U8(0);  // X
+    spc.U8(0);  // Y
+    spc.U8(0);  // PSW
+    spc.U8(0xEF);  // SP
+    spc.Zeros(RAM_OFFSET - spc.Size());
+
+    spc.Zeros(0x10000 + 128 + 64 + 64);
+    uint8_t* const ram = &spc.data[RAM_OFFSET];
+    uint8_t* const dsp = &spc.data[DSP_OFFSET];
+
+    static const uint8_t CODE[] =
+    {
+        0x8F, 0x00, 0xFA,        // mov $FA, #$00    timer 0 divider 256, 31.25 Hz
+        0x8F, 0x01, 0xF1,        // mov $F1, #$01    start timer 0
+        0xE4, 0xFD,              // loop: mov a, $FD
+        0xF0, 0xFC,              // beq loop
+        0x3D,                    // inc x
+        0x7D,                    // mov a, x
+        0x28, 0x07,              // and a, #$07
+        0x5D,                    // mov x, a
+        0x9F,                    // xcn a            voice registers
+        0x08, 0x02,              // or a, #$02       pitch, low byte
+        0xC4, 0xF2,              // mov $F2, a
+        0xFC,                    // inc y
+        0xF6, 0x00, 0x03,        // mov a, $0300+y
+        0xC4, 0xF3,              // mov $F3, a
+        0xAB, 0xF2,              // inc $F2          pitch, high byte
+        0xF6, 0x00, 0x04,        // mov a, $0400+y
+        0xC4, 0xF3,              // mov $F3, a
+        0x8F, 0x4C, 0xF2,        // mov $F2, #$4C    key on
+        0xF5, 0x00, 0x05,        // mov a, $0500+x
+        0xC4, 0xF3,              // mov $F3, a
+        0x2F, 0xDB,              // bra loop
+    };
+
+    memcpy(&ram[PROGRAM], CODE, sizeof CODE);
+    ram[0xF0] = 0x0A;  // test register, power on value
+
+    for (int i = 0; i < 256; ++i)
+    {
+        // Pitches from 0x0400 to 0x07FF, i.e. 250 to 500 Hz with 32-sample cycle
+        const unsigned pitch = 0x0400 + (i * 0x3B7) % 0x400;
+        ram[PITCH_LOW + i] = uint8_t(pitch);
+        ram[PITCH_HIGH + i] = uint8_t(pitch >> 8);
+    }
+
+    for (int voice = 0; voice < 8; ++voice)
+        ram[VOICE_BITS + voice] = uint8_t(1 << voice);
+
+    // Source directory has the only sample that loops to its start
+    ram[DIRECTORY + 0] = BRR & 0xFF;
+    ram[DIRECTORY + 1] = BRR >> 8;
+    ram[DIRECTORY + 2] = BRR & 0xFF;
+    ram[DIRECTORY + 3] = BRR >> 8;
+
+    // Two cycles of saw wave, 16 samples per block, filter 0, range 11
+    constexpr int BRR_BLOCKS = 4;
+
+    for (int block = 0; block < BRR_BLOCKS; ++block)
+    {
+        uint8_t* const data = &ram[BRR + block * 9];
+        data[0] = 11 << 4 | (block == BRR_BLOCKS - 1 ? 0x03 : 0x00);  // loop and end flags in the last block
+
+        for (int i = 0; i < 16; i += 2)
+        {
+            const int phase = (block % 2) * 16 + i;
+            const int first = phase / 2 - 8;
+            const int second = (phase + 1) / 2 - 8;
+            data[1 + i / 2] = uint8_t((first & 0x0F) << 4 | (second & 0x0F));
+        }
+    }
+
+    for (int voice = 0; voice < 8; ++voice)
+    {
+        uint8_t* const registers = &dsp[voice * 16];
+        registers[0x0] = voice & 1 ? 0x20 : 0x50;  // left volume
+        registers[0x1] = voice & 1 ? 0x50 : 0x20;  // right volume
+        registers[0x2] = 0x00;  // pitch
+        registers[0x3] = 0x04;
+        registers[0x4] = 0x00;  // source number
+        registers[0x5] = 0x8F;  // ADSR enabled, fastest attack
+        registers[0x6] = 0xE4;  // sustain level and rate
+        registers[0x7] = 0x7F;  // gain
+    }
+
+    dsp[0x0C] = 0x7F;  // main volume
+    dsp[0x1C] = 0x7F;
+    dsp[0x2C] = 0x30;  // echo volume
+    dsp[0x3C] = 0x30;
+    dsp[0x4C] = 0xFF;  // key on all voices
+    dsp[0x0D] = 0x40;  // echo feedback
+    dsp[0x4D] = 0xFF;  // echo for all voices
+    dsp[0x5D] = DIRECTORY >> 8;
+    dsp[0x6C] = 0x00;  // flags, echo writes enabled
+    dsp[0x6D] = ECHO >> 8;
+    dsp[0x7D] = 0x04;  // echo delay, 64 ms
+    dsp[0x0F] = 0x7F;  // echo FIR, pass-through
+
+    return spc.data;
+}
+
+class Player
+{
+public:
+    virtual ~Player() = default;
+
+    // Renders interleaved 16-bit stereo, returns false on failure
+    virtual bool Render(int16_t* buffer, int frames) = 0;
+};
+
+class XmpPlayer : public Player
+{
+public:
+    XmpPlayer(const std::vector<uint8_t>& data, int rate, int mode)
+    {
+        if (xmp_load_module_from_memory(m_context, data.data(), long(data.size())) != 0)
+            return;
+
+        m_loaded = true;
+        m_started = xmp_start_player(m_context, rate, 0) == 0 && xmp_set_player(m_context, XMP_PLAYER_INTERP, mode) == 0;
+    }
+
+    ~XmpPlayer() override
+    {
+        if (m_started)
+            xmp_end_player(m_context);
+
+        if (m_loaded)
+            xmp_release_module(m_context);
+
+        xmp_free_context(m_context);
+    }
+
+    bool Render(int16_t* buffer, int frames) override
+    {
+        return m_started && xmp_play_buffer(m_context, buffer, frames * 4, 0) == 0;
+    }
+
+private:
+    xmp_context m_context = xmp_create_context();
+    bool m_loaded = false;
+    bool m_started = false;
+};
+
+class DumbPlayer : public Player
+{
+public:
+    DumbPlayer(const std::vector<uint8_t>& data, const char* format, int rate, int mode)
+    : m_delta(65536.0f / rate)
+    {
+        DUMBFILE* file = dumbfile_open_memory(reinterpret_cast<const char*>(data.data()), data.size());
+
+        if (file == nullptr)
+            return;
+
+        if (strcmp(format, "mod") == 0)
+            m_duh = dumb_read_mod_quick(file, 0);
+        else if (strcmp(format, "s3m") == 0)
+            m_duh = dumb_read_s3m_quick(file);
+        else if (strcmp(format, "xm") == 0)
+            m_duh = dumb_read_xm_quick(file);
+        else if (strcmp(format, "it") == 0)
+            m_duh = dumb_read_it_quick(file);
+
+        dumbfile_close(file);
+
+        if (m_duh == nullptr)
+            return;
+
+        m_renderer = duh_start_sigrenderer(m_duh, 0, 2, 0);
+
+        if (m_renderer != nullptr)
+            dumb_it_set_resampling_quality(duh_get_it_sigrenderer(m_renderer), mode);
+    }
+
+    ~DumbPlayer() override
+    {
+        if (m_samples != nullptr)
+            destroy_sample_buffer(m_samples);
+
+        if (m_renderer != nullptr)
+            duh_end_sigrenderer(m_renderer);
+
+        if (m_duh != nullptr)
+            unload_duh(m_duh);
+    }
+
+    bool Render(int16_t* buffer, int frames) override
+    {
+        return m_renderer != nullptr
+            && duh_render_int(m_renderer, &m_samples, &m_samples_size, 16, 0, 1.0f, m_delta, frames, buffer) == frames;
+    }
+
+private:
+    float m_delta;
+    DUH* m_duh = nullptr;
+    DUH_SIGRENDERER* m_renderer = nullptr;
+    sample_t** m_samples = nullptr;
+    long m_samples_size = 0;
+};
+
+// Not declared in dumb.h, and exists in patched library only, see patch/dumb-resampler-neon.diff
+using SelectResamplerSimd = const char* (*)(int enabled);
+
+// Vector kernels produce the same samples as scalar code, except for rounding of sums, scalar code is measured too,
+// benchmarks of vector kernels are render/ ones of the same song and rate
+static void MeasureDumbKernels(const std::vector<uint8_t>& data, const char* format)
+{
+    const auto select_simd = reinterpret_cast<SelectResamplerSimd>(dlsym(RTLD_DEFAULT, "dumb_resampler_select_simd"));
+
+    // Upstream SSE kernels of x86_64 are selected at runtime, and they can't be switched off
+    if (select_simd == nullptr || strcmp(select_simd(1), "none") == 0)
+        return;
+
+    constexpr int RATE = 48000;
+    constexpr int BLOCK_COUNT = DURATION * RATE / BLOCK_SIZE;
+
+    std::vector<int16_t> scalar_buffer(BLOCK_SIZE * 2);
+    std::vector<int16_t> vector_buffer(BLOCK_SIZE * 2);
+
+    for (const auto& [name, mode] : { std::make_pair("cubic", DUMB_RQ_CUBIC), std::make_pair("fir", DUMB_RQ_FIR) })
+    {
+        DumbPlayer scalar(data, format, RATE, mode);
+        DumbPlayer vector(data, format, RATE, mode);
+
+        for (int block = 0; block < BLOCK_COUNT; ++block)
+        {
+            select_simd(0);
+            AEDI_EXPECT(scalar.Render(scalar_buffer.data(), BLOCK_SIZE));
+            select_simd(1);
+            AEDI_EXPECT(vector.Render(vector_buffer.data(), BLOCK_SIZE));
+
+            for (size_t i = 0; i < scalar_buffer.size(); ++i)
+                AEDI_EXPECT(abs(scalar_buffer[i] - vector_buffer[i]) <= 1);
+        }
+
+        select_simd(0);
+        DumbPlayer player(data, format, RATE, mode);
+
+        const std::string bench_name = aedi::Format("render/%s/dumb/%d/%s/scalar", format, RATE, name);
+
+        AEDI_BENCH_COUNT(bench_name, Samples, BLOCK_SIZE, BLOCK_COUNT)
+        {
+            AEDI_EXPECT(player.Render(scalar_buffer.data(), BLOCK_SIZE));
+        }
+
+        select_simd(1);
+    }
+}
+
+class ModPlugPlayer : public Player
+{
+public:
+    ModPlugPlayer(const std::vector<uint8_t>& data, int rate, int mode)
+    {
+        // Settings are global, and they're applied to files loaded afterwards
+        ModPlug_Settings settings;
+        ModPlug_GetSettings(&settings);
+        settings.mFlags = MODPLUG_ENABLE_OVERSAMPLING;
+        settings.mChannels = 2;
+        settings.mBits = 16;
+        settings.mFrequency = rate;
+        settings.mResamplingMode = mode;
+        settings.mLoopCount = -1;
+        ModPlug_SetSettings(&settings);
+
+        m_file = ModPlug_Load(data.data(), int(data.size()));
+    }
+
+    ~ModPlugPlayer() override
+    {
+        if (m_file != nullptr)
+            ModPlug_Unload(m_file);
+    }
+
+    bool Render(int16_t* buffer, int frames) override
+    {
+        return m_file != nullptr && ModPlug_Read(m_file, buffer, frames * 4) == frames * 4;
+    }
+
+private:
+    ModPlugFile* m_file = nullptr;
+};
+
+class MikmodPlayer : public Player
+{
+public:
+    MikmodPlayer(const std::vector<uint8_t>& data, int rate, int mode)
+    {
+        // Only one module can be played at a time, the library is reinitialized for every mixer mode
+        md_mixfreq = UWORD(rate);
+        md_mode = DMODE_SOFT_MUSIC | DMODE_16BITS | DMODE_STEREO | UWORD(mode);
+
+        if (MikMod_Init("") != 0)
+            return;
+
+        m_initialized = true;
+        m_module = Player_LoadMem(reinterpret_cast<const char*>(data.data()), int(data.size()), 64, 0);
+
+        if (m_module != nullptr)
+            Player_Start(m_module);
+    }
+
+    ~MikmodPlayer() override
+    {
+        if (m_module != nullptr)
+            Player_Free(m_module);
+
+        if (m_initialized)
+            MikMod_Exit();
+    }
+
+    bool Render(int16_t* buffer, int frames) override
+    {
+        // With no sound driver, mixing and playback are driven by the caller
+        return m_module != nullptr && VC_WriteBytes(reinterpret_cast<SBYTE*>(buffer), ULONG(frames * 4)) == ULONG(frames * 4);
+    }
+
+private:
+    bool m_initialized = false;
+    MODULE* m_module = nullptr;
+};
+
+class GmePlayer : public Player
+{
+public:
+    GmePlayer(const std::vector<uint8_t>& data, int rate, int mode)
+    {
+        if (gme_open_data(data.data(), long(data.size()), &m_emu, rate) != nullptr)
+        {
+            m_emu = nullptr;
+            return;
+        }
+
+        gme_enable_accuracy(m_emu, mode);
+
+        if (gme_start_track(m_emu, 0) != nullptr)
+        {
+            gme_delete(m_emu);
+            m_emu = nullptr;
+        }
+    }
+
+    ~GmePlayer() override
+    {
+        if (m_emu != nullptr)
+            gme_delete(m_emu);
+    }
+
+    bool Render(int16_t* buffer, int frames) override
+    {
+        return m_emu != nullptr && gme_play(m_emu, frames * 2, buffer) == nullptr;
+    }
+
+private:
+    Music_Emu* m_emu = nullptr;
+};
+
+struct Mode
+{
+    const char* name;
+    int value;
+};
+
+struct Library
+{
+    const char* name;
+    std::vector<const char*> formats;
+    std::vector<Mode> modes;
+    std::unique_ptr<Player> (*create)(const std::vector<uint8_t>& data, const char* format, int rate, int mode);
+};
+
+int main()
+{
+    aedi::Info("xmp_version", "%s", xmp_version);
+    aedi::Info("gme_version", "%d.%d.%d", GME_VERSION >> 16, (GME_VERSION >> 8) & 0xFF, GME_VERSION & 0xFF);
+    aedi::Info("dumb_version", "%s", DUMB_VERSION_STR);
+
+    const long mikmod_version = MikMod_GetVersion();
+    aedi::Info("mikmod_version", "%ld.%ld.%ld", mikmod_version >> 16, (mikmod_version >> 8) & 0xFF, mikmod_version & 0xFF);
+
+    MikMod_RegisterDriver(&drv_nos);
+    MikMod_RegisterAllLoaders();
+
+    const std::vector<int8_t> sample = MakeSample();
+
+    const struct
+    {
+        const char* name;
+        std::vector<uint8_t> data;
+    }
+    SONGS[] =
+    {
+        { "mod", MakeMod(sample) },
+        { "s3m", MakeS3m(sample) },
+        { "xm", MakeXm(sample) },
+        { "it", MakeIt(sample) },
+        { "vgm", MakeVgm() },
+        { "spc", MakeSpc() },
+    };
+
+    const Library LIBRARIES[] =
+    {
+        {
+            "xmp", { "mod", "s3m", "xm", "it" },
+            { { "nearest", XMP_INTERP_NEAREST }, { "linear", XMP_INTERP_LINEAR }, { "spline", XMP_INTERP_SPLINE } },
+            [](const std::vector<uint8_t>& data, const char*, int rate, int mode) -> std::unique_ptr<Player>
+                { return std::make_unique<XmpPlayer>(data, rate, mode); },
+        },
+        {
+            "dumb", { "mod", "s3m", "xm", "it" },
+            {
+                { "aliasing", DUMB_RQ_ALIASING }, { "blep", DUMB_RQ_BLEP }, { "linear", DUMB_RQ_LINEAR },
+                { "blam", DUMB_RQ_BLAM }, { "cubic", DUMB_RQ_CUBIC }, { "fir", DUMB_RQ_FIR },
+            },
+            [](const std::vector<uint8_t>& data, const char* format, int rate, int mode) -> std::unique_ptr<Player>
+                { return std::make_unique<DumbPlayer>(data, format, rate, mode); },
+        },
+        {
+            "modplug", { "mod", "s3m", "xm", "it" },
+            {
+                { "nearest", MODPLUG_RESAMPLE_NEAREST }, { "linear", MODPLUG_RESAMPLE_LINEAR },
+                { "spline", MODPLUG_RESAMPLE_SPLINE }, { "fir", MODPLUG_RESAMPLE_FIR },
+            },
+            [](const std::vector<uint8_t>& data, const char*, int rate, int mode) -> std::unique_ptr<Player>
+                { return std::make_unique<ModPlugPlayer>(data, rate, mode); },
+        },
+        {
+            "mikmod", { "mod", "s3m", "xm", "it" },
+            { { "nearest", 0 }, { "interp", DMODE_INTERP }, { "hq_interp", DMODE_INTERP | DMODE_HQMIXER } },
+            [](const std::vector<uint8_t>& data, const char*, int rate, int mode) -> std::unique_ptr<Player>
+                { return std::make_unique<MikmodPlayer>(data, rate, mode); },
+        },
+        {
+            "gme", { "vgm", "spc" },
+            { { "default", 0 }, { "accurate", 1 } },
+            [](const std::vector<uint8_t>& data, const char*, int rate, int mode) -> std::unique_ptr<Player>
+                { return std::make_unique<GmePlayer>(data, rate, mode); },
+        },
+    };
+
+    std::vector<int16_t> buffer(BLOCK_SIZE * 2);
+
+    for (const auto& song : SONGS)
+    {
+        for (const Library& library : LIBRARIES)
+        {
+            if (std::find_if(library.formats.begin(), library.formats.end(),
+                [&song](const char* format) { return strcmp(format, song.name) == 0; }) == library.formats.end())
+                continue;
+
+            for (int rate : { 44100, 48000 })
+            {
+                for (const Mode& mode : library.modes)
+                {
+                    const std::unique_ptr<Player> player = library.create(song.data, song.name, rate, mode.value);
+                    int peak = 0;
+
+                    const std::string name = aedi::Format("render/%s/%s/%d/%s", song.name, library.name, rate, mode.name);
+
+                    AEDI_BENCH_COUNT(name, Samples, BLOCK_SIZE, DURATION * rate / BLOCK_SIZE)
+                    {
+                        AEDI_EXPECT(player->Render(buffer.data(), BLOCK_SIZE));
+                        peak = std::max(peak, abs(buffer[BLOCK_SIZE]));
+                    }
+
+                    // Silence means that the song was loaded, but it doesn't play as intended
+                    AEDI_EXPECT(peak > 0);
+                }
+            }
+
+            if (strcmp(library.name, "dumb") == 0)
+                MeasureDumbKernels(song.data, song.name);
+        }
+    }
+
+    return 0;
+}
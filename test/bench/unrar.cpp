@@ -0,0 +1,109 @@
+// pkg-config:
+
+#include <sys/stat.h>
+
+#include <thread>
+
+// Extraction of large RAR archive, e.g. of mod, by unrar executable from prefix directory with different thread counts
+//
+// Archive is tested rather than extracted, i.e. it's decompressed and its checksums are verified without writing
+// files, so disk speed doesn't affect results. unrar built with RAR_SMP decompresses and hashes on several threads,
+// and uses all cores by default, without it -mt switch has no effect, and all thread counts take the same time
+// RAR archives cannot be created without proprietary rar tool, so archive is given by AEDI_BENCH_RAR variable
+
+static constexpr int REPETITIONS = 3;
+
+static const char* const UNRAR_PATH = AEDI_BIN_PATH "/unrar";
+
+static std::string ShellQuote(const char* value)
+{
+    std::string result = "'";
+
+    for (const char* ch = value; *ch != '\0'; ++ch)
+        result += *ch == '\'' ? std::string("'\\''") : std::string(1, *ch);
+
+    return result + "'";
+}
+
+static std::string FirstOutputLine(const std::string& command)
+{
+    std::string result;
+
+    if (FILE* output = popen(command.c_str(), "r"))
+    {
+        char line[4096];
+
+        while (result.empty() && fgets(line, sizeof line, output) != nullptr)
+        {
+            line[strcspn(line, "\r\n")] = '\0';
+            result = line;
+        }
+
+        pclose(output);
+    }
+
+    return result;
+}
+
+static bool HasThreadPool()
+{
+    // Pool of worker threads is compiled out without RAR_SMP
+    for (const std::string& symbol : aedi::LinkedSymbols(UNRAR_PATH))
+    {
+        if (symbol.find("ThreadPool") != std::string::npos)
+            return true;
+    }
+
+    return false;
+}
+
+int main()
+{
+    aedi::PrintCpuFeatures();
+
+    // Output of unrar without arguments begins with empty line, and then its version and copyright
+    const std::string version = FirstOutputLine(ShellQuote(UNRAR_PATH) + " 2>&1");
+    aedi::Info("unrar_version", "%s", version.c_str());
+
+    const bool smp = HasThreadPool();
+    aedi::Info("rar_smp", "%s", smp ? "yes" : "no");
+    AEDI_EXPECT(smp);
+
+    const char* const path = getenv("AEDI_BENCH_RAR");
+    struct stat archive_stat = {};
+
+    if (path == nullptr || stat(path, &archive_stat) != 0)
+    {
+        aedi::Info("skipped", "%s", "no archive in AEDI_BENCH_RAR");
+        return 0;
+    }
+
+    const size_t archive_size = size_t(archive_stat.st_size);
+    aedi::Info("archive_size", "%zu", archive_size);
+
+    const unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+    aedi::Info("cores", "%u", cores);
+
+    std::vector<unsigned> thread_counts = { 1, 2, 4 };
+
+    if (cores > 4)
+        thread_counts.push_back(cores);
+
+    // Thread count of zero is for unrar default
+    thread_counts.push_back(0);
+
+    for (unsigned threads : thread_counts)
+    {
+        const std::string switches = threads == 0 ? std::string() : aedi::Format(" -mt%u", threads);
+        const std::string command = ShellQuote(UNRAR_PATH) + " t -idq" + switches + " " + ShellQuote(path);
+        const std::string name = threads == 0 ? std::string("test/default") : aedi::Format("test/threads%u", threads);
+
+        // Throughput is in bytes of archive, i.e. of compressed data, per second
+        AEDI_BENCH_COUNT(name, Bytes, archive_size, REPETITIONS)
+        {
+            AEDI_EXPECT(system(command.c_str()) == 0);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <vpx/vpx_decoder.h>
+#include <vpx/vp8dx.h>
+
+#include <string>
+#include <vector>
+
+// Movie decoding with different number of threads and, for VP9, with and without row-based multithreading
+//
+// libvpx is built without encoders, so clips are read from IVF files listed in AEDI_BENCH_VPX_CLIPS environment
+// variable, separated by colons, e.g. produced by ffmpeg -i movie.mkv -t 4 -c:v libvpx-vp9 -g 9999 clip.ivf
+// Every repetition decodes one frame, so percentiles show frame decode time distribution
+// Decoding wraps around to the first frame after the last one, so clips should start with their only key frame
+
+struct Clip
+{
+    std::string name;
+    vpx_codec_iface_t* decoder = nullptr;
+    bool row_mt = false;
+    unsigned width = 0;
+    unsigned height = 0;
+    double frame_rate = 0;
+    std::vector<std::vector<uint8_t>> packets;
+};
+
+static uint32_t ReadLE(const uint8_t* data, int size)
+{
+    uint32_t value = 0;
+
+    for (int i = size - 1; i >= 0; --i)
+        value = value << 8 | data[i];
+
+    return value;
+}
+
+// Loads all frames of IVF file, decoder is left null if the file is not VP8 or VP9 one
+static Clip LoadClip(const std::string& path)
+{
+    Clip clip;
+    FILE* file = fopen(path.c_str(), "rb");
+
+    if (file == nullptr)
+        return clip;
+
+    uint8_t header[32];
+
+    if (fread(header, 1, sizeof header, file) == sizeof header && memcmp(header, "DKIF", 4) == 0)
+    {
+        const bool vp8 = memcmp(&header[8], "VP80", 4) == 0;
+        const bool vp9 = memcmp(&header[8], "VP90", 4) == 0;
+
+        if (vp8 || vp9)
+        {
+            // VP8 decoder always splits frame by macroblock rows between threads, it has no separate row-MT mode
+            clip.decoder = vp8 ? vpx_codec_vp8_dx() : vpx_codec_vp9_dx();
+            clip.row_mt = vp9;
+            clip.width = ReadLE(&header[12], 2);
+            clip.height = ReadLE(&header[14], 2);
+
+            const uint32_t rate = ReadLE(&header[16], 4), scale = ReadLE(&header[20], 4);
+            clip.frame_rate = scale == 0 ? 0 : double(rate) / scale;
+
+            const size_t slash = path.rfind('/');
+            clip.name = aedi::Format("%s/%s", vp8 ? "vp8" : "vp9", path.substr(slash == std::string::npos ? 0 : slash + 1).c_str());
+        }
+
+        uint8_t frame_header[12];
+
+        while (clip.decoder != nullptr && fread(frame_header, 1, sizeof frame_header, file) == sizeof frame_header)
+        {
+            std::vector<uint8_t> packet(ReadLE(frame_header, 4));
+
+            if (fread(packet.data(), 1, packet.size(), file) != packet.size())
+                break;
+
+            clip.packets.push_back(std::move(packet));
+        }
+    }
+
+    fclose(file);
+    return clip;
+}
+
+static std::vector<Clip> LoadClips()
+{
+    std::vector<Clip> clips;
+    const char* const files = getenv("AEDI_BENCH_VPX_CLIPS");
+
+    if (files == nullptr)
+        return clips;
+
+    std::string list = files;
+
+    for (size_t start = 0, end; start < list.size(); start = end + 1)
+    {
+        end = list.find(':', start);
+        end = end == std::string::npos ? list.size() : end;
+
+        Clip clip = LoadClip(list.substr(start, end - start));
+
+        if (clip.decoder != nullptr && !clip.packets.empty())
+            clips.push_back(std::move(clip));
+    }
+
+    return clips;
+}
+
+int main()
+{
+    aedi::Info("vpx_version", "%s", vpx_codec_version_str());
+    aedi::PrintCpuFeatures();
+
+    const std::vector<Clip> clips = LoadClips();
+
+    if (clips.empty())
+    {
+        aedi::Info("skipped", "%s", "no clips in AEDI_BENCH_VPX_CLIPS");
+        return 0;
+    }
+
+    for (const Clip& clip : clips)
+    {
+        size_t clip_size = 0;
+
+        for (const auto& packet : clip.packets)
+            clip_size += packet.size();
+
+        const size_t frame_count = clip.packets.size();
+        aedi::Info(("resolution/" + clip.name).c_str(), "%ux%u", clip.width, clip.height);
+        aedi::Info(("bitrate/" + clip.name).c_str(), "%.0f kbit/s", clip_size * 8.0 * clip.frame_rate / frame_count / 1000);
+
+        for (int threads : { 1, 2, 4, 8 })
+        {
+            for (int row_mt = 0; row_mt <= int(clip.row_mt); ++row_mt)
+            {
+                vpx_codec_dec_cfg_t config = { unsigned(threads), clip.width, clip.height };
+                vpx_codec_ctx_t decoder;
+                AEDI_EXPECT(vpx_codec_dec_init(&decoder, clip.decoder, &config, 0) == VPX_CODEC_OK);
+
+                if (clip.row_mt)
+                    AEDI_EXPECT(vpx_codec_control(&decoder, VP9D_SET_ROW_MT, row_mt) == VPX_CODEC_OK);
+
+                const std::string name = aedi::Format("decode/%s/threads%d%s", clip.name.c_str(), threads, row_mt ? "/row_mt" : "");
+                size_t frame = 0;
+
+                AEDI_BENCH_COUNT(name, Frames, 1, int(frame_count))
+                {
+                    const std::vector<uint8_t>& packet = clip.packets[frame++ % frame_count];
+                    AEDI_EXPECT(vpx_codec_decode(&decoder, packet.data(), unsigned(packet.size()), nullptr, 0) == VPX_CODEC_OK);
+
+                    vpx_codec_iter_t iterator = nullptr;
+                    const vpx_image_t* image = vpx_codec_get_frame(&decoder, &iterator);
+                    AEDI_EXPECT(image != nullptr);
+                    aedi::DoNotOptimize(image->planes[0][0]);
+                }
+
+                AEDI_EXPECT(vpx_codec_destroy(&decoder) == VPX_CODEC_OK);
+            }
+        }
+    }
+
+    return 0;
+}
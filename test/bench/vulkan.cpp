@@ -0,0 +1,443 @@
+#include "vulkan_common.h"
+
+#include <limits.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+
+// Vulkan startup latency, from instance creation to the first queue submit
+//
+// Every measured run is a separate process, the first one is cold, i.e. Metal shader cache of the executable is
+// removed before it, the rest are warm. File system cache isn't purged, so cold run doesn't include disk reads
+// The same source is built with Vulkan loader and libMoltenVK.dylib, and with static MoltenVK, see bench-deps target
+// Pipelines are created without pipeline cache, so warm runs benefit from Metal shader cache only
+// Loader gets MoltenVK manifest directly, and then via manifest discovery, to measure the cost of directory scan
+
+static constexpr int WARM_RUNS = 10;
+static constexpr int SHADER_VARIANTS = 16;
+
+static constexpr const char* const CHILD_ARGUMENT = "--child";
+
+// data[gl_GlobalInvocationID.x] = data[gl_GlobalInvocationID.x] * scale + bias
+static std::vector<uint32_t> MakeComputeShader(float scale, float bias)
+{
+    SpirvModule m;
+    const uint32_t main = m.Id(), gid = m.Id(), buffer = m.Id();
+    const uint32_t type_void = m.Id(), type_function = m.Id(), type_uint = m.Id(), type_uvec3 = m.Id();
+    const uint32_t type_float = m.Id(), type_array = m.Id(), type_struct = m.Id();
+    const uint32_t type_gid_pointer = m.Id(), type_struct_pointer = m.Id(), type_float_pointer = m.Id();
+
+    m.Op(SpirvModule::OpCapability, { SpirvModule::CapabilityShader });
+    m.Op(SpirvModule::OpMemoryModel, { 0, 1 });  // logical, GLSL450
+    m.Op(SpirvModule::OpEntryPoint, { SpirvModule::ExecutionModelGLCompute, main }, "main", { gid });
+    m.Op(SpirvModule::OpExecutionMode, { main, SpirvModule::ExecutionModeLocalSize, 64, 1, 1 });
+
+    m.Op(SpirvModule::OpDecorate, { gid, SpirvModule::DecorationBuiltIn, SpirvModule::BuiltInGlobalInvocationId });
+    m.Op(SpirvModule::OpDecorate, { type_array, SpirvModule::DecorationArrayStride, 4 });
+    m.Op(SpirvModule::OpMemberDecorate, { type_struct, 0, SpirvModule::DecorationOffset, 0 });
+    m.Op(SpirvModule::OpDecorate, { type_struct, SpirvModule::DecorationBufferBlock });
+    m.Op(SpirvModule::OpDecorate, { buffer, SpirvModule::DecorationDescriptorSet, 0 });
+    m.Op(SpirvModule::OpDecorate, { buffer, SpirvModule::DecorationBinding, 0 });
+
+    m.Op(SpirvModule::OpTypeVoid, { type_void });
+    m.Op(SpirvModule::OpTypeFunction, { type_function, type_void });
+    m.Op(SpirvModule::OpTypeInt, { type_uint, 32, 0 });
+    m.Op(SpirvModule::OpTypeVector, { type_uvec3, type_uint, 3 });
+    m.Op(SpirvModule::OpTypeFloat, { type_float, 32 });
+    m.Op(SpirvModule::OpTypeRuntimeArray, { type_array, type_float });
+    m.Op(SpirvModule::OpTypeStruct, { type_struct, type_array });
+    m.Op(SpirvModule::OpTypePointer, { type_gid_pointer, SpirvModule::StorageClassInput, type_uvec3 });
+    m.Op(SpirvModule::OpTypePointer, { type_struct_pointer, SpirvModule::StorageClassUniform, type_struct });
+    m.Op(SpirvModule::OpTypePointer, { type_float_pointer, SpirvModule::StorageClassUniform, type_float });
+
+    const uint32_t zero = m.Id();
+    m.Op(SpirvModule::OpConstant, { type_uint, zero, 0 });
+    const uint32_t scale_constant = m.Float(type_float, scale);
+    const uint32_t bias_constant = m.Float(type_float, bias);
+
+    m.Op(SpirvModule::OpVariable, { type_gid_pointer, gid, SpirvModule::StorageClassInput });
+    m.Op(SpirvModule::OpVariable, { type_struct_pointer, buffer, SpirvModule::StorageClassUniform });
+
+    const uint32_t label = m.Id(), gid_value = m.Id(), index = m.Id(), element = m.Id();
+    const uint32_t value = m.Id(), scaled = m.Id(), result = m.Id();
+
+    m.Op(SpirvModule::OpFunction, { type_void, main, 0, type_function });
+    m.Op(SpirvModule::OpLabel, { label });
+    m.Op(SpirvModule::OpLoad, { type_uvec3, gid_value, gid });
+    m.Op(SpirvModule::OpCompositeExtract, { type_uint, index, gid_value, 0 });
+    m.Op(SpirvModule::OpAccessChain, { type_float_pointer, element, buffer, zero, index });
+    m.Op(SpirvModule::OpLoad, { type_float, value, element });
+    m.Op(SpirvModule::OpFMul, { type_float, scaled, value, scale_constant });
+    m.Op(SpirvModule::OpFAdd, { type_float, result, scaled, bias_constant });
+    m.Op(SpirvModule::OpStore, { element, result });
+    m.Op(SpirvModule::OpReturn, {});
+    m.Op(SpirvModule::OpFunctionEnd, {});
+
+    return m.Finish();
+}
+
+// Vertex shader stores constant position, fragment shader stores constant color
+static std::vector<uint32_t> MakeGraphicsShader(bool fragment, float value)
+{
+    SpirvModule m;
+    const uint32_t main = m.Id(), output = m.Id();
+    const uint32_t type_void = m.Id(), type_function = m.Id(), type_float = m.Id(), type_vec4 = m.Id();
+    const uint32_t type_output_pointer = m.Id();
+
+    m.Op(SpirvModule::OpCapability, { SpirvModule::CapabilityShader });
+    m.Op(SpirvModule::OpMemoryModel, { 0, 1 });  // logical, GLSL450
+    m.Op(SpirvModule::OpEntryPoint,
+        { fragment ? SpirvModule::ExecutionModelFragment : SpirvModule::ExecutionModelVertex, main }, "main", { output });
+
+    if (fragment)
+    {
+        m.Op(SpirvModule::OpExecutionMode, { main, SpirvModule::ExecutionModeOriginUpperLeft });
+        m.Op(SpirvModule::OpDecorate, { output, SpirvModule::DecorationLocation, 0 });
+    }
+    else
+        m.Op(SpirvModule::OpDecorate, { output, SpirvModule::DecorationBuiltIn, SpirvModule::BuiltInPosition });
+
+    m.Op(SpirvModule::OpTypeVoid, { type_void });
+    m.Op(SpirvModule::OpTypeFunction, { type_function, type_void });
+    m.Op(SpirvModule::OpTypeFloat, { type_float, 32 });
+    m.Op(SpirvModule::OpTypeVector, { type_vec4, type_float, 4 });
+    m.Op(SpirvModule::OpTypePointer, { type_output_pointer, SpirvModule::StorageClassOutput, type_vec4 });
+
+    const uint32_t component = m.Float(type_float, value);
+    const uint32_t one = m.Float(type_float, 1.0f);
+    const uint32_t vector = m.Id();
+    m.Op(SpirvModule::OpConstantComposite, { type_vec4, vector, component, component, component, one });
+
+    m.Op(SpirvModule::OpVariable, { type_output_pointer, output, SpirvModule::StorageClassOutput });
+
+    const uint32_t label = m.Id();
+    m.Op(SpirvModule::OpFunction, { type_void, main, 0, type_function });
+    m.Op(SpirvModule::OpLabel, { label });
+    m.Op(SpirvModule::OpStore, { output, vector });
+    m.Op(SpirvModule::OpReturn, {});
+    m.Op(SpirvModule::OpFunctionEnd, {});
+
+    return m.Finish();
+}
+
+// Runs startup sequence once, and prints time of each phase in ticks
+static int RunChild()
+{
+    uint64_t start = mach_absolute_time();
+
+    auto phase = [&start](const char* name)
+    {
+        const uint64_t now = mach_absolute_time();
+        printf("%s %llu\n", name, static_cast<unsigned long long>(now - start));
+        start = now;
+    };
+
+    const VkInstance instance = CreateInstance();
+    phase("create_instance");
+
+    const VkPhysicalDevice physical_device = FirstPhysicalDevice(instance);
+    phase("enumerate_devices");
+
+    uint32_t queue_family = 0;
+    const VkDevice device = CreateDevice(physical_device, queue_family);
+    phase("create_device");
+
+    // Pipelines, every shader variant is a distinct module, so each one is translated and compiled separately
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo set_layout_info = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    set_layout_info.bindingCount = 1;
+    set_layout_info.pBindings = &binding;
+
+    VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateDescriptorSetLayout(device, &set_layout_info, nullptr, &set_layout) == VK_SUCCESS);
+
+    VkPipelineLayoutCreateInfo layout_info = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    layout_info.setLayoutCount = 1;
+    layout_info.pSetLayouts = &set_layout;
+
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreatePipelineLayout(device, &layout_info, nullptr, &layout) == VK_SUCCESS);
+
+    VkAttachmentDescription attachment = {};
+    attachment.format = VK_FORMAT_R8G8B8A8_UNORM;
+    attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    const VkAttachmentReference color_reference = { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+
+    VkSubpassDescription subpass = {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &color_reference;
+
+    VkRenderPassCreateInfo render_pass_info = { VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
+    render_pass_info.attachmentCount = 1;
+    render_pass_info.pAttachments = &attachment;
+    render_pass_info.subpassCount = 1;
+    render_pass_info.pSubpasses = &subpass;
+
+    VkRenderPass render_pass = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateRenderPass(device, &render_pass_info, nullptr, &render_pass) == VK_SUCCESS);
+
+    VkPipelineLayoutCreateInfo graphics_layout_info = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    VkPipelineLayout graphics_layout = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreatePipelineLayout(device, &graphics_layout_info, nullptr, &graphics_layout) == VK_SUCCESS);
+
+    std::vector<VkShaderModule> modules;
+    std::vector<VkPipeline> pipelines;
+
+    for (int variant = 0; variant < SHADER_VARIANTS; ++variant)
+    {
+        const float value = 1.0f + variant / 16.0f;
+
+        const VkShaderModule compute_module = CreateShaderModule(device, MakeComputeShader(value, -value));
+        AEDI_EXPECT(compute_module != VK_NULL_HANDLE);
+        modules.push_back(compute_module);
+
+        VkComputePipelineCreateInfo compute_info = { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+        compute_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        compute_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        compute_info.stage.module = compute_module;
+        compute_info.stage.pName = "main";
+        compute_info.layout = layout;
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        AEDI_EXPECT(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &compute_info, nullptr, &pipeline) == VK_SUCCESS);
+        pipelines.push_back(pipeline);
+
+        const VkShaderModule vertex_module = CreateShaderModule(device, MakeGraphicsShader(false, value / 2));
+        const VkShaderModule fragment_module = CreateShaderModule(device, MakeGraphicsShader(true, value / 4));
+        AEDI_EXPECT(vertex_module != VK_NULL_HANDLE && fragment_module != VK_NULL_HANDLE);
+        modules.push_back(vertex_module);
+        modules.push_back(fragment_module);
+
+        VkPipelineShaderStageCreateInfo stages[2] = {};
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = vertex_module;
+        stages[0].pName = "main";
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = fragment_module;
+        stages[1].pName = "main";
+
+        VkPipelineVertexInputStateCreateInfo vertex_input = { VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+
+        VkPipelineInputAssemblyStateCreateInfo input_assembly = { VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+        input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        const VkViewport viewport = { 0, 0, 64, 64, 0, 1 };
+        const VkRect2D scissor = { { 0, 0 }, { 64, 64 } };
+
+        VkPipelineViewportStateCreateInfo viewport_state = { VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+        viewport_state.viewportCount = 1;
+        viewport_state.pViewports = &viewport;
+        viewport_state.scissorCount = 1;
+        viewport_state.pScissors = &scissor;
+
+        VkPipelineRasterizationStateCreateInfo rasterization = { VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+        rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterization.cullMode = VK_CULL_MODE_NONE;
+        rasterization.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisample = { VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+        multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineColorBlendAttachmentState blend_attachment = {};
+        blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
+            | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+        VkPipelineColorBlendStateCreateInfo color_blend = { VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+        color_blend.attachmentCount = 1;
+        color_blend.pAttachments = &blend_attachment;
+
+        VkGraphicsPipelineCreateInfo graphics_info = { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+        graphics_info.stageCount = 2;
+        graphics_info.pStages = stages;
+        graphics_info.pVertexInputState = &vertex_input;
+        graphics_info.pInputAssemblyState = &input_assembly;
+        graphics_info.pViewportState = &viewport_state;
+        graphics_info.pRasterizationState = &rasterization;
+        graphics_info.pMultisampleState = &multisample;
+        graphics_info.pColorBlendState = &color_blend;
+        graphics_info.layout = graphics_layout;
+        graphics_info.renderPass = render_pass;
+
+        AEDI_EXPECT(vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphics_info, nullptr, &pipeline) == VK_SUCCESS);
+        pipelines.push_back(pipeline);
+    }
+
+    phase("create_pipelines");
+
+    // The first submit, it creates Metal command queue and command buffer behind the scenes
+    VkCommandPoolCreateInfo pool_info = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    pool_info.queueFamilyIndex = queue_family;
+
+    VkCommandPool pool = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateCommandPool(device, &pool_info, nullptr, &pool) == VK_SUCCESS);
+
+    VkCommandBufferAllocateInfo allocate_info = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    allocate_info.commandPool = pool;
+    allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocate_info.commandBufferCount = 1;
+
+    VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkAllocateCommandBuffers(device, &allocate_info, &command_buffer) == VK_SUCCESS);
+
+    VkCommandBufferBeginInfo begin_info = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    AEDI_EXPECT(vkBeginCommandBuffer(command_buffer, &begin_info) == VK_SUCCESS);
+    AEDI_EXPECT(vkEndCommandBuffer(command_buffer) == VK_SUCCESS);
+
+    VkFenceCreateInfo fence_info = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    VkFence fence = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateFence(device, &fence_info, nullptr, &fence) == VK_SUCCESS);
+
+    VkQueue queue = VK_NULL_HANDLE;
+    vkGetDeviceQueue(device, queue_family, 0, &queue);
+
+    VkSubmitInfo submit_info = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &command_buffer;
+    AEDI_EXPECT(vkQueueSubmit(queue, 1, &submit_info, fence) == VK_SUCCESS);
+    AEDI_EXPECT(vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS);
+    phase("first_submit");
+
+    vkDestroyFence(device, fence, nullptr);
+    vkDestroyCommandPool(device, pool, nullptr);
+
+    for (VkPipeline pipeline : pipelines)
+        vkDestroyPipeline(device, pipeline, nullptr);
+
+    for (VkShaderModule module : modules)
+        vkDestroyShaderModule(device, module, nullptr);
+
+    vkDestroyPipelineLayout(device, graphics_layout, nullptr);
+    vkDestroyRenderPass(device, render_pass, nullptr);
+    vkDestroyPipelineLayout(device, layout, nullptr);
+    vkDestroyDescriptorSetLayout(device, set_layout, nullptr);
+    vkDestroyDevice(device, nullptr);
+    vkDestroyInstance(instance, nullptr);
+
+    return 0;
+}
+
+// Runs the executable again in child mode, and collects phase times together with the whole process time
+static std::map<std::string, uint64_t> RunProcess(const char* path)
+{
+#if defined(__aarch64__)
+    const char* const arch = "arm64";
+#elif defined(__x86_64__)
+    const char* const arch = "x86_64";
+#endif
+
+    std::map<std::string, uint64_t> phases;
+    const std::string command = aedi::Format("arch -%s '%s' %s", arch, path, CHILD_ARGUMENT);
+    const uint64_t start = mach_absolute_time();
+
+    FILE* output = popen(command.c_str(), "r");
+
+    if (output == nullptr)
+        return phases;
+
+    char name[256];
+    unsigned long long ticks;
+
+    while (fscanf(output, "%255s %llu", name, &ticks) == 2)
+        phases[name] = ticks;
+
+    if (pclose(output) != 0)
+        phases.clear();
+    else
+        phases["process"] = mach_absolute_time() - start;
+
+    return phases;
+}
+
+// Best effort removal of Metal shader cache, it's stored per executable name in user cache directory
+static void RemoveShaderCache()
+{
+    char cache_path[PATH_MAX];
+
+    if (confstr(_CS_DARWIN_USER_CACHE_DIR, cache_path, sizeof cache_path) == 0)
+        return;
+
+    const std::string command = aedi::Format("rm -rf '%scom.apple.metal/%s'", cache_path, getprogname());
+    aedi::DoNotOptimize(system(command.c_str()));
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && strcmp(argv[1], CHILD_ARGUMENT) == 0)
+        return RunChild();
+
+#ifdef AEDI_STATIC_MOLTENVK
+    aedi::Info("moltenvk", "static");
+#else
+    aedi::Info("moltenvk", "loader and dylib");
+
+    UseMoltenVKFromPrefix();
+#endif
+
+    RemoveShaderCache();
+
+    const std::map<std::string, uint64_t> cold = RunProcess(argv[0]);
+    AEDI_EXPECT(!cold.empty());
+
+    // Single cold run is too noisy to be gated, so it's reported as info
+    for (const auto& [phase, ticks] : cold)
+        aedi::Info(("cold_us/" + phase).c_str(), "%.0f", aedi::TicksToNanoseconds(int64_t(ticks)) / 1000);
+
+    std::map<std::string, std::vector<uint64_t>> warm;
+
+    for (int run = 0; run < WARM_RUNS; ++run)
+    {
+        const std::map<std::string, uint64_t> phases = RunProcess(argv[0]);
+        AEDI_EXPECT(!phases.empty());
+
+        for (const auto& [phase, ticks] : phases)
+            warm[phase].push_back(ticks);
+    }
+
+    for (const auto& [phase, times] : warm)
+    {
+        aedi::Bench bench("warm/" + phase, aedi::Unit::Operations, 1, int(times.size()));
+
+        for (uint64_t ticks : times)
+            bench.AddTime(ticks);
+    }
+
+#ifndef AEDI_STATIC_MOLTENVK
+    // The same ICD added to manifests the loader finds itself, in system, user and bundle directories,
+    // the difference with warm runs above is the cost of driver manifest discovery in instance creation
+    AEDI_EXPECT(unsetenv("VK_DRIVER_FILES") == 0);
+    AEDI_EXPECT(setenv("VK_ADD_DRIVER_FILES", MOLTENVK_ICD_PATH, 1) == 0);
+
+    std::vector<uint64_t> discovery;
+
+    for (int run = 0; run < WARM_RUNS; ++run)
+    {
+        const std::map<std::string, uint64_t> phases = RunProcess(argv[0]);
+        AEDI_EXPECT(!phases.empty());
+
+        discovery.push_back(phases.at("create_instance"));
+    }
+
+    aedi::Bench bench("discovery/create_instance", aedi::Unit::Operations, 1, int(discovery.size()));
+
+    for (uint64_t ticks : discovery)
+        bench.AddTime(ticks);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include <string.h>
+#include <vulkan/vulkan_core.h>
+
+#include <initializer_list>
+#include <vector>
+
+// Helpers shared by Vulkan benchmarks
+
+// Minimal SPIR-V 1.0 assembler, just enough for shaders below
+class SpirvModule
+{
+public:
+    SpirvModule()
+    {
+        m_words = { 0x07230203, 0x00010000, 0, 0, 0 };
+    }
+
+    uint32_t Id()
+    {
+        return m_bound++;
+    }
+
+    void Op(uint32_t opcode, std::initializer_list<uint32_t> operands)
+    {
+        m_words.push_back(uint32_t(operands.size() + 1) << 16 | opcode);
+        m_words.insert(m_words.end(), operands);
+    }
+
+    // Instruction with literal string operand, e.g. OpEntryPoint
+    void Op(uint32_t opcode, std::initializer_list<uint32_t> prefix, const char* string,
+        std::initializer_list<uint32_t> suffix = {})
+    {
+        const size_t string_words = strlen(string) / 4 + 1;
+        m_words.push_back(uint32_t(prefix.size() + string_words + suffix.size() + 1) << 16 | opcode);
+        m_words.insert(m_words.end(), prefix);
+
+        const size_t offset = m_words.size();
+        m_words.resize(offset + string_words, 0);
+        memcpy(&m_words[offset], string, strlen(string));
+
+        m_words.insert(m_words.end(), suffix);
+    }
+
+    uint32_t Float(uint32_t type, float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof bits);
+
+        const uint32_t id = Id();
+        Op(OpConstant, { type, id, bits });
+        return id;
+    }
+
+    std::vector<uint32_t> Finish()
+    {
+        m_words[3] = m_bound;
+        return m_words;
+    }
+
+    enum : uint32_t
+    {
+        OpExecutionMode = 16,
+        OpCapability = 17,
+        OpEntryPoint = 15,
+        OpMemoryModel = 14,
+        OpTypeVoid = 19,
+        OpTypeInt = 21,
+        OpTypeFloat = 22,
+        OpTypeVector = 23,
+        OpTypeRuntimeArray = 29,
+        OpTypeStruct = 30,
+        OpTypePointer = 32,
+        OpTypeFunction = 33,
+        OpConstant = 43,
+        OpConstantComposite = 44,
+        OpFunction = 54,
+        OpFunctionEnd = 56,
+        OpVariable = 59,
+        OpLoad = 61,
+        OpStore = 62,
+        OpAccessChain = 65,
+        OpDecorate = 71,
+        OpMemberDecorate = 72,
+        OpCompositeExtract = 81,
+        OpFAdd = 129,
+        OpFMul = 133,
+        OpLabel = 248,
+        OpReturn = 253,
+    };
+
+    enum : uint32_t
+    {
+        CapabilityShader = 1,
+        ExecutionModelVertex = 0,
+        ExecutionModelFragment = 4,
+        ExecutionModelGLCompute = 5,
+        ExecutionModeOriginUpperLeft = 7,
+        ExecutionModeLocalSize = 17,
+        DecorationBlock = 2,
+        DecorationBufferBlock = 3,
+        DecorationArrayStride = 6,
+        DecorationBuiltIn = 11,
+        DecorationLocation = 30,
+        DecorationBinding = 33,
+        DecorationDescriptorSet = 34,
+        DecorationOffset = 35,
+        BuiltInPosition = 0,
+        BuiltInGlobalInvocationId = 28,
+        StorageClassInput = 1,
+        StorageClassUniform = 2,
+        StorageClassOutput = 3,
+        StorageClassPushConstant = 9,
+    };
+
+private:
+    std::vector<uint32_t> m_words;
+    uint32_t m_bound = 1;
+};
+
+static VkShaderModule CreateShaderModule(VkDevice device, const std::vector<uint32_t>& code)
+{
+    VkShaderModuleCreateInfo info = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+    info.codeSize = code.size() * sizeof code[0];
+    info.pCode = code.data();
+
+    VkShaderModule module = VK_NULL_HANDLE;
+    return vkCreateShaderModule(device, &info, nullptr, &module) == VK_SUCCESS ? module : VK_NULL_HANDLE;
+}
+
+static bool HasExtension(const std::vector<VkExtensionProperties>& extensions, const char* name)
+{
+    for (const VkExtensionProperties& extension : extensions)
+    {
+        if (strcmp(extension.extensionName, name) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+// Instance, MoltenVK is a portability driver, so it's enumerated only when asked to
+static VkInstance CreateInstance()
+{
+    uint32_t extension_count = 0;
+    AEDI_EXPECT(vkEnumerateInstanceExtensionProperties(nullptr, &extension_count, nullptr) == VK_SUCCESS);
+    std::vector<VkExtensionProperties> extensions(extension_count);
+    AEDI_EXPECT(vkEnumerateInstanceExtensionProperties(nullptr, &extension_count, extensions.data()) == VK_SUCCESS);
+
+    VkApplicationInfo application_info = { VK_STRUCTURE_TYPE_APPLICATION_INFO };
+    application_info.pApplicationName = "aedi-bench";
+    application_info.apiVersion = VK_API_VERSION_1_1;
+
+    VkInstanceCreateInfo instance_info = { VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
+    instance_info.pApplicationInfo = &application_info;
+
+    const char* const portability_extension = "VK_KHR_portability_enumeration";
+
+    if (HasExtension(extensions, portability_extension))
+    {
+        instance_info.flags = 0x00000001;  // VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR
+        instance_info.enabledExtensionCount = 1;
+        instance_info.ppEnabledExtensionNames = &portability_extension;
+    }
+
+    VkInstance instance = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateInstance(&instance_info, nullptr, &instance) == VK_SUCCESS);
+    return instance;
+}
+
+static VkPhysicalDevice FirstPhysicalDevice(VkInstance instance)
+{
+    uint32_t physical_device_count = 0;
+    AEDI_EXPECT(vkEnumeratePhysicalDevices(instance, &physical_device_count, nullptr) == VK_SUCCESS);
+    AEDI_EXPECT(physical_device_count > 0);
+    std::vector<VkPhysicalDevice> physical_devices(physical_device_count);
+    AEDI_EXPECT(vkEnumeratePhysicalDevices(instance, &physical_device_count, physical_devices.data()) == VK_SUCCESS);
+
+    return physical_devices[0];
+}
+
+// Logical device with one graphics queue, and portability subset when device supports it as specification requires
+static VkDevice CreateDevice(VkPhysicalDevice physical_device, uint32_t& queue_family)
+{
+    uint32_t device_extension_count = 0;
+    AEDI_EXPECT(vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &device_extension_count, nullptr) == VK_SUCCESS);
+    std::vector<VkExtensionProperties> device_extensions(device_extension_count);
+    AEDI_EXPECT(vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &device_extension_count,
+        device_extensions.data()) == VK_SUCCESS);
+
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, queue_families.data());
+
+    queue_family = 0;
+
+    while (queue_family < queue_family_count && !(queue_families[queue_family].queueFlags & VK_QUEUE_GRAPHICS_BIT))
+        ++queue_family;
+
+    AEDI_EXPECT(queue_family < queue_family_count);
+
+    const float priority = 1.0f;
+    VkDeviceQueueCreateInfo queue_info = { VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+    queue_info.queueFamilyIndex = queue_family;
+    queue_info.queueCount = 1;
+    queue_info.pQueuePriorities = &priority;
+
+    VkDeviceCreateInfo device_info = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+    device_info.queueCreateInfoCount = 1;
+    device_info.pQueueCreateInfos = &queue_info;
+
+    const char* const portability_subset_extension = "VK_KHR_portability_subset";
+
+    if (HasExtension(device_extensions, portability_subset_extension))
+    {
+        device_info.enabledExtensionCount = 1;
+        device_info.ppEnabledExtensionNames = &portability_subset_extension;
+    }
+
+    VkDevice device = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateDevice(physical_device, &device_info, nullptr, &device) == VK_SUCCESS);
+    return device;
+}
+
+#ifndef AEDI_STATIC_MOLTENVK
+static constexpr const char* const MOLTENVK_ICD_PATH = "MoltenVK_icd.json";
+
+// Points loader to MoltenVK from prefix, child processes inherit it
+static void UseMoltenVKFromPrefix()
+{
+    FILE* icd = fopen(MOLTENVK_ICD_PATH, "w");
+    AEDI_EXPECT(icd != nullptr);
+    fprintf(icd, "{\"file_format_version\": \"1.0.0\", \"ICD\": {\"library_path\": \"%s/libMoltenVK.dylib\", "
+        "\"api_version\": \"1.2.0\", \"is_portability_driver\": true}}\n", AEDI_LIB_PATH);
+    AEDI_EXPECT(fclose(icd) == 0);
+    AEDI_EXPECT(setenv("VK_DRIVER_FILES", MOLTENVK_ICD_PATH, 1) == 0);
+}
+#endif
@@ -0,0 +1,598 @@
+// pkg-config: vulkan
+#include "vulkan_common.h"
+
+#include <string>
+#include <utility>
+
+// CPU time of draw call recording and submission, i.e. MoltenVK command encoding, per draw
+//
+// Command buffer with thousands of draws into offscreen render target is recorded and submitted, GPU work is excluded
+// by waiting for completion outside of timed interval. Triangles are degenerate, so no fragments are shaded
+// Patterns change pipeline, descriptor set and push constants between draws, alone and together, like games do
+// Every MoltenVK configuration profile is measured in a separate process, because MoltenVK reads it at startup
+// The same source is built with Vulkan loader and libMoltenVK.dylib, and with static MoltenVK, see bench-deps target
+
+static constexpr int WARMUP = 3;
+static constexpr int REPETITIONS = 15;
+static constexpr int PIPELINES = 16;
+static constexpr int DESCRIPTOR_SETS = 16;
+static constexpr uint32_t UNIFORM_STRIDE = 256;  // not less than minUniformBufferOffsetAlignment of Metal devices
+static constexpr uint32_t TARGET_SIZE = 256;
+
+static constexpr const char* const CHILD_ARGUMENT = "--child";
+
+static constexpr int DRAW_COUNTS[] = { 1000, 10000, 50000 };
+
+enum StateChange
+{
+    ChangePipeline = 1,
+    ChangeDescriptorSet = 2,
+    ChangePushConstants = 4,
+};
+
+static const struct
+{
+    const char* name;
+    int changes;
+}
+PATTERNS[] =
+{
+    { "static", 0 },
+    { "pipeline", ChangePipeline },
+    { "descriptor_set", ChangeDescriptorSet },
+    { "push_constant", ChangePushConstants },
+    { "all", ChangePipeline | ChangeDescriptorSet | ChangePushConstants },
+};
+
+// Profile name and space separated assignments of MoltenVK configuration variables, empty for upstream defaults
+static const struct
+{
+    const char* name;
+    const char* settings;
+}
+PROFILES[] =
+{
+    { "default", "" },
+#ifdef AEDI_MOLTENVK_GAME_PROFILE
+    { "game", AEDI_MOLTENVK_GAME_PROFILE },
+#endif
+};
+
+// gl_Position = uniforms.scale * push_constants.offset + value, the same for every vertex
+// Both blocks are read, so MoltenVK has to bind buffer and set bytes of every changed state for the next draw
+static std::vector<uint32_t> MakeVertexShader(float value)
+{
+    SpirvModule m;
+    const uint32_t main = m.Id(), output = m.Id(), push_constants = m.Id(), uniforms = m.Id();
+    const uint32_t type_void = m.Id(), type_function = m.Id(), type_int = m.Id(), type_float = m.Id();
+    const uint32_t type_vec4 = m.Id(), type_block = m.Id();
+    const uint32_t type_push_block_pointer = m.Id(), type_uniform_block_pointer = m.Id();
+    const uint32_t type_push_vec4_pointer = m.Id(), type_uniform_vec4_pointer = m.Id(), type_output_pointer = m.Id();
+
+    m.Op(SpirvModule::OpCapability, { SpirvModule::CapabilityShader });
+    m.Op(SpirvModule::OpMemoryModel, { 0, 1 });  // logical, GLSL450
+    m.Op(SpirvModule::OpEntryPoint, { SpirvModule::ExecutionModelVertex, main }, "main", { output });
+
+    m.Op(SpirvModule::OpDecorate, { output, SpirvModule::DecorationBuiltIn, SpirvModule::BuiltInPosition });
+    m.Op(SpirvModule::OpMemberDecorate, { type_block, 0, SpirvModule::DecorationOffset, 0 });
+    m.Op(SpirvModule::OpDecorate, { type_block, SpirvModule::DecorationBlock });
+    m.Op(SpirvModule::OpDecorate, { uniforms, SpirvModule::DecorationDescriptorSet, 0 });
+    m.Op(SpirvModule::OpDecorate, { uniforms, SpirvModule::DecorationBinding, 0 });
+
+    m.Op(SpirvModule::OpTypeVoid, { type_void });
+    m.Op(SpirvModule::OpTypeFunction, { type_function, type_void });
+    m.Op(SpirvModule::OpTypeInt, { type_int, 32, 1 });
+    m.Op(SpirvModule::OpTypeFloat, { type_float, 32 });
+    m.Op(SpirvModule::OpTypeVector, { type_vec4, type_float, 4 });
+    m.Op(SpirvModule::OpTypeStruct, { type_block, type_vec4 });
+    m.Op(SpirvModule::OpTypePointer, { type_push_block_pointer, SpirvModule::StorageClassPushConstant, type_block });
+    m.Op(SpirvModule::OpTypePointer, { type_uniform_block_pointer, SpirvModule::StorageClassUniform, type_block });
+    m.Op(SpirvModule::OpTypePointer, { type_push_vec4_pointer, SpirvModule::StorageClassPushConstant, type_vec4 });
+    m.Op(SpirvModule::OpTypePointer, { type_uniform_vec4_pointer, SpirvModule::StorageClassUniform, type_vec4 });
+    m.Op(SpirvModule::OpTypePointer, { type_output_pointer, SpirvModule::StorageClassOutput, type_vec4 });
+
+    const uint32_t zero = m.Id();
+    m.Op(SpirvModule::OpConstant, { type_int, zero, 0 });
+    const uint32_t component = m.Float(type_float, value);
+    const uint32_t one = m.Float(type_float, 1.0f);
+    const uint32_t vector = m.Id();
+    m.Op(SpirvModule::OpConstantComposite, { type_vec4, vector, component, component, component, one });
+
+    m.Op(SpirvModule::OpVariable, { type_output_pointer, output, SpirvModule::StorageClassOutput });
+    m.Op(SpirvModule::OpVariable, { type_push_block_pointer, push_constants, SpirvModule::StorageClassPushConstant });
+    m.Op(SpirvModule::OpVariable, { type_uniform_block_pointer, uniforms, SpirvModule::StorageClassUniform });
+
+    const uint32_t label = m.Id(), offset_pointer = m.Id(), offset = m.Id(), scale_pointer = m.Id(), scale = m.Id();
+    const uint32_t scaled = m.Id(), result = m.Id();
+
+    m.Op(SpirvModule::OpFunction, { type_void, main, 0, type_function });
+    m.Op(SpirvModule::OpLabel, { label });
+    m.Op(SpirvModule::OpAccessChain, { type_push_vec4_pointer, offset_pointer, push_constants, zero });
+    m.Op(SpirvModule::OpLoad, { type_vec4, offset, offset_pointer });
+    m.Op(SpirvModule::OpAccessChain, { type_uniform_vec4_pointer, scale_pointer, uniforms, zero });
+    m.Op(SpirvModule::OpLoad, { type_vec4, scale, scale_pointer });
+    m.Op(SpirvModule::OpFMul, { type_vec4, scaled, scale, offset });
+    m.Op(SpirvModule::OpFAdd, { type_vec4, result, scaled, vector });
+    m.Op(SpirvModule::OpStore, { output, result });
+    m.Op(SpirvModule::OpReturn, {});
+    m.Op(SpirvModule::OpFunctionEnd, {});
+
+    return m.Finish();
+}
+
+// Stores constant color
+static std::vector<uint32_t> MakeFragmentShader(float value)
+{
+    SpirvModule m;
+    const uint32_t main = m.Id(), output = m.Id();
+    const uint32_t type_void = m.Id(), type_function = m.Id(), type_float = m.Id(), type_vec4 = m.Id();
+    const uint32_t type_output_pointer = m.Id();
+
+    m.Op(SpirvModule::OpCapability, { SpirvModule::CapabilityShader });
+    m.Op(SpirvModule::OpMemoryModel, { 0, 1 });  // logical, GLSL450
+    m.Op(SpirvModule::OpEntryPoint, { SpirvModule::ExecutionModelFragment, main }, "main", { output });
+    m.Op(SpirvModule::OpExecutionMode, { main, SpirvModule::ExecutionModeOriginUpperLeft });
+    m.Op(SpirvModule::OpDecorate, { output, SpirvModule::DecorationLocation, 0 });
+
+    m.Op(SpirvModule::OpTypeVoid, { type_void });
+    m.Op(SpirvModule::OpTypeFunction, { type_function, type_void });
+    m.Op(SpirvModule::OpTypeFloat, { type_float, 32 });
+    m.Op(SpirvModule::OpTypeVector, { type_vec4, type_float, 4 });
+    m.Op(SpirvModule::OpTypePointer, { type_output_pointer, SpirvModule::StorageClassOutput, type_vec4 });
+
+    const uint32_t component = m.Float(type_float, value);
+    const uint32_t one = m.Float(type_float, 1.0f);
+    const uint32_t vector = m.Id();
+    m.Op(SpirvModule::OpConstantComposite, { type_vec4, vector, component, component, component, one });
+
+    m.Op(SpirvModule::OpVariable, { type_output_pointer, output, SpirvModule::StorageClassOutput });
+
+    const uint32_t label = m.Id();
+    m.Op(SpirvModule::OpFunction, { type_void, main, 0, type_function });
+    m.Op(SpirvModule::OpLabel, { label });
+    m.Op(SpirvModule::OpStore, { output, vector });
+    m.Op(SpirvModule::OpReturn, {});
+    m.Op(SpirvModule::OpFunctionEnd, {});
+
+    return m.Finish();
+}
+
+static uint32_t FindMemoryType(VkPhysicalDevice physical_device, uint32_t type_bits, VkMemoryPropertyFlags properties)
+{
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
+
+    for (uint32_t type = 0; type < memory_properties.memoryTypeCount; ++type)
+    {
+        if ((type_bits & (1u << type)) && (memory_properties.memoryTypes[type].propertyFlags & properties) == properties)
+            return type;
+    }
+
+    AEDI_EXPECT(false);
+    return 0;
+}
+
+static VkDeviceMemory AllocateMemory(VkDevice device, VkPhysicalDevice physical_device,
+    const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties)
+{
+    VkMemoryAllocateInfo allocate_info = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+    allocate_info.allocationSize = requirements.size;
+    allocate_info.memoryTypeIndex = FindMemoryType(physical_device, requirements.memoryTypeBits, properties);
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkAllocateMemory(device, &allocate_info, nullptr, &memory) == VK_SUCCESS);
+    return memory;
+}
+
+// Measures every pattern and draw count with MoltenVK configuration inherited from parent process
+static int RunChild(const char* profile)
+{
+    const VkInstance instance = CreateInstance();
+    const VkPhysicalDevice physical_device = FirstPhysicalDevice(instance);
+
+    uint32_t queue_family = 0;
+    const VkDevice device = CreateDevice(physical_device, queue_family);
+
+    VkQueue queue = VK_NULL_HANDLE;
+    vkGetDeviceQueue(device, queue_family, 0, &queue);
+
+    // Offscreen render target
+    VkImageCreateInfo image_info = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+    image_info.extent = { TARGET_SIZE, TARGET_SIZE, 1 };
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+    VkImage image = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateImage(device, &image_info, nullptr, &image) == VK_SUCCESS);
+
+    VkMemoryRequirements image_requirements;
+    vkGetImageMemoryRequirements(device, image, &image_requirements);
+    const VkDeviceMemory image_memory = AllocateMemory(device, physical_device, image_requirements,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    AEDI_EXPECT(vkBindImageMemory(device, image, image_memory, 0) == VK_SUCCESS);
+
+    VkImageViewCreateInfo view_info = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    view_info.image = image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = image_info.format;
+    view_info.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+    VkImageView view = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateImageView(device, &view_info, nullptr, &view) == VK_SUCCESS);
+
+    VkAttachmentDescription attachment = {};
+    attachment.format = image_info.format;
+    attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    const VkAttachmentReference color_reference = { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+
+    VkSubpassDescription subpass = {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &color_reference;
+
+    VkRenderPassCreateInfo render_pass_info = { VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO };
+    render_pass_info.attachmentCount = 1;
+    render_pass_info.pAttachments = &attachment;
+    render_pass_info.subpassCount = 1;
+    render_pass_info.pSubpasses = &subpass;
+
+    VkRenderPass render_pass = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateRenderPass(device, &render_pass_info, nullptr, &render_pass) == VK_SUCCESS);
+
+    VkFramebufferCreateInfo framebuffer_info = { VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
+    framebuffer_info.renderPass = render_pass;
+    framebuffer_info.attachmentCount = 1;
+    framebuffer_info.pAttachments = &view;
+    framebuffer_info.width = TARGET_SIZE;
+    framebuffer_info.height = TARGET_SIZE;
+    framebuffer_info.layers = 1;
+
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateFramebuffer(device, &framebuffer_info, nullptr, &framebuffer) == VK_SUCCESS);
+
+    // Uniform buffer with one range per descriptor set
+    VkBufferCreateInfo buffer_info = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    buffer_info.size = VkDeviceSize(UNIFORM_STRIDE) * DESCRIPTOR_SETS;
+    buffer_info.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateBuffer(device, &buffer_info, nullptr, &buffer) == VK_SUCCESS);
+
+    VkMemoryRequirements buffer_requirements;
+    vkGetBufferMemoryRequirements(device, buffer, &buffer_requirements);
+    const VkDeviceMemory buffer_memory = AllocateMemory(device, physical_device, buffer_requirements,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    AEDI_EXPECT(vkBindBufferMemory(device, buffer, buffer_memory, 0) == VK_SUCCESS);
+
+    void* mapped = nullptr;
+    AEDI_EXPECT(vkMapMemory(device, buffer_memory, 0, buffer_info.size, 0, &mapped) == VK_SUCCESS);
+
+    for (int set = 0; set < DESCRIPTOR_SETS; ++set)
+    {
+        const float scale[4] = { 1.0f / (set + 1), 1.0f / (set + 1), 0.0f, 0.0f };
+        memcpy(static_cast<char*>(mapped) + set * UNIFORM_STRIDE, scale, sizeof scale);
+    }
+
+    vkUnmapMemory(device, buffer_memory);
+
+    // Descriptor sets and pipeline layout
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo set_layout_info = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    set_layout_info.bindingCount = 1;
+    set_layout_info.pBindings = &binding;
+
+    VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateDescriptorSetLayout(device, &set_layout_info, nullptr, &set_layout) == VK_SUCCESS);
+
+    const VkDescriptorPoolSize pool_size = { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, DESCRIPTOR_SETS };
+
+    VkDescriptorPoolCreateInfo descriptor_pool_info = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    descriptor_pool_info.maxSets = DESCRIPTOR_SETS;
+    descriptor_pool_info.poolSizeCount = 1;
+    descriptor_pool_info.pPoolSizes = &pool_size;
+
+    VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateDescriptorPool(device, &descriptor_pool_info, nullptr, &descriptor_pool) == VK_SUCCESS);
+
+    const std::vector<VkDescriptorSetLayout> set_layouts(DESCRIPTOR_SETS, set_layout);
+
+    VkDescriptorSetAllocateInfo set_allocate_info = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    set_allocate_info.descriptorPool = descriptor_pool;
+    set_allocate_info.descriptorSetCount = DESCRIPTOR_SETS;
+    set_allocate_info.pSetLayouts = set_layouts.data();
+
+    std::vector<VkDescriptorSet> sets(DESCRIPTOR_SETS);
+    AEDI_EXPECT(vkAllocateDescriptorSets(device, &set_allocate_info, sets.data()) == VK_SUCCESS);
+
+    for (int set = 0; set < DESCRIPTOR_SETS; ++set)
+    {
+        const VkDescriptorBufferInfo descriptor_buffer = { buffer, VkDeviceSize(set) * UNIFORM_STRIDE, 16 };
+
+        VkWriteDescriptorSet write = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.dstSet = sets[set];
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        write.pBufferInfo = &descriptor_buffer;
+        vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+    }
+
+    const VkPushConstantRange push_constant_range = { VK_SHADER_STAGE_VERTEX_BIT, 0, 16 };
+
+    VkPipelineLayoutCreateInfo layout_info = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    layout_info.setLayoutCount = 1;
+    layout_info.pSetLayouts = &set_layout;
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &push_constant_range;
+
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreatePipelineLayout(device, &layout_info, nullptr, &layout) == VK_SUCCESS);
+
+    // Pipelines with distinct shaders, so switching between them changes Metal render pipeline state
+    std::vector<VkShaderModule> modules;
+    std::vector<VkPipeline> pipelines;
+
+    for (int variant = 0; variant < PIPELINES; ++variant)
+    {
+        const float value = 1.0f + variant / 16.0f;
+
+        const VkShaderModule vertex_module = CreateShaderModule(device, MakeVertexShader(value / 2));
+        const VkShaderModule fragment_module = CreateShaderModule(device, MakeFragmentShader(value / 4));
+        AEDI_EXPECT(vertex_module != VK_NULL_HANDLE && fragment_module != VK_NULL_HANDLE);
+        modules.push_back(vertex_module);
+        modules.push_back(fragment_module);
+
+        VkPipelineShaderStageCreateInfo stages[2] = {};
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = vertex_module;
+        stages[0].pName = "main";
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = fragment_module;
+        stages[1].pName = "main";
+
+        VkPipelineVertexInputStateCreateInfo vertex_input = { VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+
+        VkPipelineInputAssemblyStateCreateInfo input_assembly = { VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+        input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        const VkViewport viewport = { 0, 0, float(TARGET_SIZE), float(TARGET_SIZE), 0, 1 };
+        const VkRect2D scissor = { { 0, 0 }, { TARGET_SIZE, TARGET_SIZE } };
+
+        VkPipelineViewportStateCreateInfo viewport_state = { VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+        viewport_state.viewportCount = 1;
+        viewport_state.pViewports = &viewport;
+        viewport_state.scissorCount = 1;
+        viewport_state.pScissors = &scissor;
+
+        VkPipelineRasterizationStateCreateInfo rasterization = { VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+        rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterization.cullMode = VK_CULL_MODE_NONE;
+        rasterization.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisample = { VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+        multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineColorBlendAttachmentState blend_attachment = {};
+        blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
+            | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+        VkPipelineColorBlendStateCreateInfo color_blend = { VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+        color_blend.attachmentCount = 1;
+        color_blend.pAttachments = &blend_attachment;
+
+        VkGraphicsPipelineCreateInfo graphics_info = { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+        graphics_info.stageCount = 2;
+        graphics_info.pStages = stages;
+        graphics_info.pVertexInputState = &vertex_input;
+        graphics_info.pInputAssemblyState = &input_assembly;
+        graphics_info.pViewportState = &viewport_state;
+        graphics_info.pRasterizationState = &rasterization;
+        graphics_info.pMultisampleState = &multisample;
+        graphics_info.pColorBlendState = &color_blend;
+        graphics_info.layout = layout;
+        graphics_info.renderPass = render_pass;
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        AEDI_EXPECT(vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphics_info, nullptr, &pipeline) == VK_SUCCESS);
+        pipelines.push_back(pipeline);
+    }
+
+    // Command buffer is reused, its pool is reset after every submission completes
+    VkCommandPoolCreateInfo pool_info = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    pool_info.queueFamilyIndex = queue_family;
+
+    VkCommandPool pool = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateCommandPool(device, &pool_info, nullptr, &pool) == VK_SUCCESS);
+
+    VkCommandBufferAllocateInfo allocate_info = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    allocate_info.commandPool = pool;
+    allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocate_info.commandBufferCount = 1;
+
+    VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkAllocateCommandBuffers(device, &allocate_info, &command_buffer) == VK_SUCCESS);
+
+    VkFenceCreateInfo fence_info = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    VkFence fence = VK_NULL_HANDLE;
+    AEDI_EXPECT(vkCreateFence(device, &fence_info, nullptr, &fence) == VK_SUCCESS);
+
+    const VkClearValue clear_value = {};
+
+    VkRenderPassBeginInfo render_pass_begin = { VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+    render_pass_begin.renderPass = render_pass;
+    render_pass_begin.framebuffer = framebuffer;
+    render_pass_begin.renderArea = { { 0, 0 }, { TARGET_SIZE, TARGET_SIZE } };
+    render_pass_begin.clearValueCount = 1;
+    render_pass_begin.pClearValues = &clear_value;
+
+    VkCommandBufferBeginInfo begin_info = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    VkSubmitInfo submit_info = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &command_buffer;
+
+    for (const auto& pattern : PATTERNS)
+    {
+        for (const int draws : DRAW_COUNTS)
+        {
+            const std::string name = aedi::Format("%s/%s/%d", profile, pattern.name, draws);
+            aedi::Bench bench(name, aedi::Unit::Operations, draws, REPETITIONS);
+
+            for (int iteration = 0; iteration < WARMUP + REPETITIONS; ++iteration)
+            {
+                const uint64_t start = mach_absolute_time();
+
+                AEDI_EXPECT(vkBeginCommandBuffer(command_buffer, &begin_info) == VK_SUCCESS);
+                vkCmdBeginRenderPass(command_buffer, &render_pass_begin, VK_SUBPASS_CONTENTS_INLINE);
+
+                const float initial_offset[4] = { 0.5f, 0.5f, 0.0f, 0.0f };
+                vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines[0]);
+                vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &sets[0],
+                    0, nullptr);
+                vkCmdPushConstants(command_buffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof initial_offset,
+                    initial_offset);
+
+                for (int draw = 0; draw < draws; ++draw)
+                {
+                    if (pattern.changes & ChangePipeline)
+                        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines[draw % PIPELINES]);
+
+                    if (pattern.changes & ChangeDescriptorSet)
+                    {
+                        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1,
+                            &sets[draw % DESCRIPTOR_SETS], 0, nullptr);
+                    }
+
+                    if (pattern.changes & ChangePushConstants)
+                    {
+                        const float offset[4] = { float(draw % 64) / 64, float(draw % 32) / 32, 0.0f, 0.0f };
+                        vkCmdPushConstants(command_buffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof offset, offset);
+                    }
+
+                    vkCmdDraw(command_buffer, 3, 1, 0, 0);
+                }
+
+                vkCmdEndRenderPass(command_buffer);
+                AEDI_EXPECT(vkEndCommandBuffer(command_buffer) == VK_SUCCESS);
+                AEDI_EXPECT(vkQueueSubmit(queue, 1, &submit_info, fence) == VK_SUCCESS);
+
+                const uint64_t end = mach_absolute_time();
+
+                AEDI_EXPECT(vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS);
+                AEDI_EXPECT(vkResetFences(device, 1, &fence) == VK_SUCCESS);
+                AEDI_EXPECT(vkResetCommandPool(device, pool, 0) == VK_SUCCESS);
+
+                if (iteration >= WARMUP)
+                    bench.AddTime(end - start);
+            }
+
+            aedi::Info(("us_per_draw/" + name).c_str(), "%.3f", bench.TotalNanoseconds() / REPETITIONS / draws / 1000);
+        }
+    }
+
+    vkDestroyFence(device, fence, nullptr);
+    vkDestroyCommandPool(device, pool, nullptr);
+
+    for (VkPipeline pipeline : pipelines)
+        vkDestroyPipeline(device, pipeline, nullptr);
+
+    for (VkShaderModule module : modules)
+        vkDestroyShaderModule(device, module, nullptr);
+
+    vkDestroyPipelineLayout(device, layout, nullptr);
+    vkDestroyDescriptorPool(device, descriptor_pool, nullptr);
+    vkDestroyDescriptorSetLayout(device, set_layout, nullptr);
+    vkDestroyBuffer(device, buffer, nullptr);
+    vkFreeMemory(device, buffer_memory, nullptr);
+    vkDestroyFramebuffer(device, framebuffer, nullptr);
+    vkDestroyRenderPass(device, render_pass, nullptr);
+    vkDestroyImageView(device, view, nullptr);
+    vkDestroyImage(device, image, nullptr);
+    vkFreeMemory(device, image_memory, nullptr);
+    vkDestroyDevice(device, nullptr);
+    vkDestroyInstance(instance, nullptr);
+
+    return 0;
+}
+
+// Splits space separated assignments of profile into names and values
+static std::vector<std::pair<std::string, std::string>> ProfileSettings(const char* settings)
+{
+    std::vector<std::pair<std::string, std::string>> result;
+    const std::string assignments = settings;
+
+    for (size_t begin = 0, end = 0; begin < assignments.size(); begin = end + 1)
+    {
+        end = std::min(assignments.find(' ', begin), assignments.size());
+        const std::string assignment = assignments.substr(begin, end - begin);
+        const size_t equals = assignment.find('=');
+        AEDI_EXPECT(equals != std::string::npos);
+        result.emplace_back(assignment.substr(0, equals), assignment.substr(equals + 1));
+    }
+
+    return result;
+}
+
+// Applies profile to environment of child processes, variables of other profiles are removed first
+static void ApplyProfile(const char* settings)
+{
+    for (const auto& other : PROFILES)
+    {
+        for (const auto& [name, value] : ProfileSettings(other.settings))
+            AEDI_EXPECT(unsetenv(name.c_str()) == 0);
+    }
+
+    for (const auto& [name, value] : ProfileSettings(settings))
+        AEDI_EXPECT(setenv(name.c_str(), value.c_str(), 1) == 0);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 2 && strcmp(argv[1], CHILD_ARGUMENT) == 0)
+        return RunChild(argv[2]);
+
+#ifdef AEDI_STATIC_MOLTENVK
+    aedi::Info("moltenvk", "static");
+#else
+    aedi::Info("moltenvk", "loader and dylib");
+    UseMoltenVKFromPrefix();
+#endif
+
+    aedi::PrintCpuFeatures();
+
+#if defined(__aarch64__)
+    const char* const arch = "arm64";
+#elif defined(__x86_64__)
+    const char* const arch = "x86_64";
+#endif
+
+    for (const auto& profile : PROFILES)
+    {
+        ApplyProfile(profile.settings);
+
+        // Child writes results to the same stdout
+        fflush(stdout);
+        const std::string command = aedi::Format("arch -%s '%s' %s %s", arch, argv[0], CHILD_ARGUMENT, profile.name);
+        AEDI_EXPECT(system(command.c_str()) == 0);
+    }
+
+    return 0;
+}
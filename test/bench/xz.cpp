@@ -0,0 +1,162 @@
+// pkg-config: liblzma
+
+#include <lzma.h>
+
+#include <thread>
+
+#include "corpus.h"
+
+// Single threaded and multithreaded decoding of large .xz payload by liblzma, e.g. content of mod archive
+//
+// Multithreaded encoder splits input into blocks, and stores their sizes in block headers,
+// multithreaded decoder decodes such blocks in parallel, while single threaded stream has one block only
+// 7z archives hold raw LZMA or LZMA2 streams without xz blocks, their decoding is always single threaded,
+// so the single threaded case here is the reference for them too
+
+static constexpr int REPEAT_COUNT = 4;
+static constexpr uint64_t BLOCK_SIZE = 1024 * 1024;
+static constexpr uint32_t PRESET = 6;
+
+static std::vector<unsigned char> Encode(const std::vector<unsigned char>& content, uint32_t threads)
+{
+    lzma_stream stream = LZMA_STREAM_INIT;
+    lzma_ret result;
+
+    if (threads == 0)
+    {
+        result = lzma_easy_encoder(&stream, PRESET, LZMA_CHECK_CRC32);
+    }
+    else
+    {
+        lzma_mt options = {};
+        options.threads = threads;
+        options.block_size = BLOCK_SIZE;
+        options.preset = PRESET;
+        options.check = LZMA_CHECK_CRC32;
+
+        result = lzma_stream_encoder_mt(&stream, &options);
+    }
+
+    AEDI_EXPECT(result == LZMA_OK);
+
+    std::vector<unsigned char> encoded(lzma_stream_buffer_bound(content.size()));
+
+    stream.next_in = content.data();
+    stream.avail_in = content.size();
+    stream.next_out = encoded.data();
+    stream.avail_out = encoded.size();
+
+    while ((result = lzma_code(&stream, LZMA_FINISH)) == LZMA_OK);
+
+    AEDI_EXPECT(result == LZMA_STREAM_END);
+
+    encoded.resize(stream.total_out);
+    lzma_end(&stream);
+
+    return encoded;
+}
+
+// Zero threads means single threaded decoder
+static bool Decode(const std::vector<unsigned char>& encoded, std::vector<unsigned char>& decoded, uint32_t threads)
+{
+    lzma_stream stream = LZMA_STREAM_INIT;
+    lzma_ret result;
+
+    if (threads == 0)
+    {
+        result = lzma_stream_decoder(&stream, UINT64_MAX, 0);
+    }
+    else
+    {
+        lzma_mt options = {};
+        options.threads = threads;
+        options.memlimit_threading = UINT64_MAX;
+        options.memlimit_stop = UINT64_MAX;
+
+        result = lzma_stream_decoder_mt(&stream, &options);
+    }
+
+    if (result != LZMA_OK)
+        return false;
+
+    stream.next_in = encoded.data();
+    stream.avail_in = encoded.size();
+    stream.next_out = decoded.data();
+    stream.avail_out = decoded.size();
+
+    while ((result = lzma_code(&stream, LZMA_FINISH)) == LZMA_OK);
+
+    const bool complete = result == LZMA_STREAM_END && stream.total_out == decoded.size();
+    lzma_end(&stream);
+
+    return complete;
+}
+
+int main()
+{
+    aedi::Info("lzma_version", "%s", lzma_version_string());
+    aedi::PrintCpuFeatures();
+
+    const uint32_t cores = std::max(lzma_cputhreads(), 1u);
+    aedi::Info("lzma_cputhreads", "%u", cores);
+
+    const auto corpus = LoadCorpus();
+    AEDI_EXPECT(!corpus.empty());
+
+    // Payload is the whole corpus repeated a few times, large enough to be split into many blocks
+    std::vector<unsigned char> content;
+
+    for (int i = 0; i < REPEAT_COUNT; ++i)
+        for (const auto& item : corpus)
+            content.insert(content.end(), item.second.begin(), item.second.end());
+
+    std::vector<uint32_t> thread_counts = { 1, 2, 4 };
+
+    if (cores > 4)
+        thread_counts.push_back(cores);
+
+    std::vector<unsigned char> single_block, multiple_blocks;
+
+    // Encoding is slow at default preset, it's measured only a few times
+    AEDI_BENCH_COUNT("encode/single", Bytes, content.size(), 3)
+    {
+        single_block = Encode(content, 0);
+    }
+
+    AEDI_BENCH_COUNT(aedi::Format("encode/threads%u", cores), Bytes, content.size(), 3)
+    {
+        multiple_blocks = Encode(content, cores);
+    }
+
+    aedi::Info("ratio/single", "%.3f", double(content.size()) / single_block.size());
+    aedi::Info("ratio/blocks", "%.3f", double(content.size()) / multiple_blocks.size());
+
+    std::vector<unsigned char> decoded(content.size());
+
+    AEDI_BENCH("decode/single", Bytes, content.size())
+    {
+        AEDI_EXPECT(Decode(multiple_blocks, decoded, 0));
+    }
+
+    AEDI_EXPECT(decoded == content);
+
+    for (uint32_t threads : thread_counts)
+    {
+        AEDI_BENCH(aedi::Format("decode/threads%u", threads), Bytes, content.size())
+        {
+            AEDI_EXPECT(Decode(multiple_blocks, decoded, threads));
+        }
+
+        AEDI_EXPECT(decoded == content);
+    }
+
+    // Stream of one block has nothing to decode in parallel, multithreaded decoder falls back to single thread
+    AEDI_BENCH(aedi::Format("decode/single_block/threads%u", cores), Bytes, content.size())
+    {
+        AEDI_EXPECT(Decode(single_block, decoded, cores));
+    }
+
+    AEDI_EXPECT(decoded == content);
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <zlib.h>
+
+#include "corpus.h"
+
+// Inflate and deflate throughput on content typical for PK3 archives
+//
+// zlib-ng selects its implementations at runtime, and fills its internal functable with them on the first call
+// Entries of this table are resolved to function names via symbols of the executable, and printed before benchmarks
+
+static std::vector<std::string> FunctableImplementations(const char* path)
+{
+    const std::vector<aedi::Symbol> symbols = aedi::DefinedSymbols(path);
+    const auto functable = std::find_if(symbols.begin(), symbols.end(),
+        [](const aedi::Symbol& symbol) { return symbol.name == "_functable"; });
+
+    if (functable == symbols.end() || functable + 1 == symbols.end())
+        return {};
+
+    // Table layout differs between zlib-ng versions, its size is the distance to the next symbol
+    const size_t count = std::min((functable[1].address - functable->address) / sizeof(void*), size_t(64));
+    const void* const* entries = reinterpret_cast<const void* const*>(functable->address);
+    std::vector<std::string> implementations;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::string name = aedi::SymbolName(symbols, entries[i]);
+
+        if (!name.empty())
+            implementations.push_back(name.substr(1));
+    }
+
+    return implementations;
+}
+
+int main(int, char** argv)
+{
+    aedi::Info("zlib_version", "%s", zlibVersion());
+    aedi::PrintCpuFeatures();
+
+    const auto corpus = LoadCorpus();
+    AEDI_EXPECT(!corpus.empty());
+
+    // Checksums are the most direct indication of accelerated code, their speed differs several times
+    const std::vector<unsigned char>& checksummed = corpus.front().second;
+
+    // Any call through the functable initializes all of its entries
+    aedi::DoNotOptimize(adler32(1, checksummed.data(), uInt(checksummed.size())));
+
+    const std::vector<std::string> implementations = FunctableImplementations(argv[0]);
+    AEDI_EXPECT(!implementations.empty());
+
+    std::string functable;
+    bool accelerated_adler32 = false;
+
+    for (const std::string& implementation : implementations)
+    {
+        functable += (functable.empty() ? "" : " ") + implementation;
+
+        // NEON on arm64, and SSSE3 on x86_64, which Rosetta implements too
+        if (implementation.compare(0, 8, "adler32_") == 0 && implementation != "adler32_c"
+            && implementation.find("stub") == std::string::npos)
+            accelerated_adler32 = true;
+    }
+
+    aedi::Info("zlib_functable", "%s", functable.c_str());
+    AEDI_EXPECT(accelerated_adler32);
+
+    AEDI_BENCH("crc32", Bytes, checksummed.size())
+    {
+        aedi::DoNotOptimize(crc32(0, checksummed.data(), uInt(checksummed.size())));
+    }
+
+    AEDI_BENCH("adler32", Bytes, checksummed.size())
+    {
+        aedi::DoNotOptimize(adler32(1, checksummed.data(), uInt(checksummed.size())));
+    }
+
+    for (const auto& [name, data] : corpus)
+    {
+        std::vector<unsigned char> inflated(data.size());
+
+        for (int level : { 1, 6, 9 })
+        {
+            std::vector<unsigned char> deflated(compressBound(uLong(data.size())));
+            uLongf deflated_size = 0;
+
+            AEDI_BENCH(aedi::Format("deflate/%s/level%d", name.c_str(), level), Bytes, data.size())
+            {
+                deflated_size = deflated.size();
+                AEDI_EXPECT(compress2(deflated.data(), &deflated_size, data.data(), uLong(data.size()), level) == Z_OK);
+            }
+
+            aedi::Info(aedi::Format("ratio/%s/level%d", name.c_str(), level).c_str(), "%.3f", double(data.size()) / deflated_size);
+
+            AEDI_BENCH(aedi::Format("inflate/%s/level%d", name.c_str(), level), Bytes, data.size())
+            {
+                uLongf inflated_size = inflated.size();
+                AEDI_EXPECT(uncompress(inflated.data(), &inflated_size, deflated.data(), deflated_size) == Z_OK);
+            }
+
+            AEDI_EXPECT(inflated == data);
+        }
+    }
+
+    return 0;
+}
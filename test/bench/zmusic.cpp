@@ -0,0 +1,758 @@
+// pkg-config: zmusic sndfile
+#include <dirent.h>
+#include <fcntl.h>
+#include <math.h>
+#include <sndfile.h>
+#include <sys/stat.h>
+#include <zmusic.h>
+
+#include <chrono>
+#include <initializer_list>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Sound effect and music decoding through ZMusic, the same way GZDoom does it
+//
+// Files are encoded in memory by libsndfile, and then decoded with CreateDecoder() from memory
+// Static decoder references the given data, non-static one makes a copy of it
+// First sample time includes decoder creation, i.e. format detection and header parsing
+//
+// Songs opened from the same data are streamed with FillStream(), like the audio callback of GZDoom does
+// Every repetition fills one callback buffer, so high percentiles show decoding spikes that cause underruns
+// ZMusic_GetStreamStats() reports fill times, CPU load and synth voices of a song after its measured fills
+// With ZMusic_SetStreamPrefetch(), background thread renders songs ahead, and the same stats report its buffer
+//
+// Opening of song file is compared between reading it to heap for OpenSongMem(), like the ports do,
+// and custom reader backed by file mapping, which lets decoders read directly from page cache
+//
+// The same MIDI song is rendered by every OPL3 core of libADLMIDI and OPN2 core of libOPNMIDI with 1 to 4 chips
+// Cores removed by --zmusic-fast-emulators fall back to the first available one, so they show its speed instead
+// The same song is also pre-rendered to cache file in background, and streamed from it
+//
+// ZMusic_ConvertSamples() is measured for every pair of SampleType and ChannelConfig, it runs vectorized kernels
+// that are selected for the CPU at runtime
+
+static constexpr int SAMPLE_RATE = 48000;
+static constexpr int CHANNELS = 2;
+static constexpr int DURATION = 10;  // seconds
+static constexpr size_t FIRST_READ_SIZE = 4096;  // bytes
+static constexpr int CALLBACK_FRAMES = 512;
+static constexpr int PREFETCH_MS = 200;
+
+struct MemoryFile
+{
+    std::vector<unsigned char> data;
+    sf_count_t position = 0;
+};
+
+static sf_count_t GetLength(void* user_data)
+{
+    return sf_count_t(static_cast<MemoryFile*>(user_data)->data.size());
+}
+
+static sf_count_t Seek(sf_count_t offset, int whence, void* user_data)
+{
+    MemoryFile* file = static_cast<MemoryFile*>(user_data);
+
+    if (whence == SEEK_CUR)
+        offset += file->position;
+    else if (whence == SEEK_END)
+        offset += sf_count_t(file->data.size());
+
+    file->position = offset;
+    return offset;
+}
+
+static sf_count_t Read(void* buffer, sf_count_t count, void* user_data)
+{
+    MemoryFile* file = static_cast<MemoryFile*>(user_data);
+    const sf_count_t available = std::max(sf_count_t(file->data.size()) - file->position, sf_count_t(0));
+
+    count = std::min(count, available);
+
+    if (count > 0)
+    {
+        memcpy(buffer, &file->data[file->position], size_t(count));
+        file->position += count;
+    }
+
+    return count;
+}
+
+static sf_count_t Write(const void* buffer, sf_count_t count, void* user_data)
+{
+    MemoryFile* file = static_cast<MemoryFile*>(user_data);
+    const size_t end = size_t(file->position + count);
+
+    if (file->data.size() < end)
+        file->data.resize(end);
+
+    memcpy(&file->data[file->position], buffer, size_t(count));
+    file->position += count;
+
+    return count;
+}
+
+static sf_count_t Tell(void* user_data)
+{
+    return static_cast<MemoryFile*>(user_data)->position;
+}
+
+// Music-like signal, two notes with slow amplitude modulation
+static std::vector<float> MakeSignal()
+{
+    std::vector<float> signal(size_t(SAMPLE_RATE) * DURATION * CHANNELS);
+
+    for (size_t i = 0, e = signal.size() / CHANNELS; i < e; ++i)
+    {
+        const double time = double(i) / SAMPLE_RATE;
+        const double envelope = 0.5 + 0.25 * sin(2 * M_PI * 0.5 * time);
+
+        signal[i * CHANNELS] = float(envelope * sin(2 * M_PI * 261.63 * time));
+        signal[i * CHANNELS + 1] = float(envelope * sin(2 * M_PI * 392 * time));
+    }
+
+    return signal;
+}
+
+static std::vector<unsigned char> Encode(const std::vector<float>& signal, int format)
+{
+    SF_VIRTUAL_IO io = { GetLength, Seek, Read, Write, Tell };
+    MemoryFile file;
+
+    SF_INFO info = {};
+    info.samplerate = SAMPLE_RATE;
+    info.channels = CHANNELS;
+    info.format = format;
+
+    SNDFILE* sndfile = sf_open_virtual(&io, SFM_WRITE, &info, &file);
+
+    if (sndfile == nullptr)
+        return {};
+
+    const sf_count_t frames = sf_count_t(signal.size() / CHANNELS);
+    const bool written = sf_writef_float(sndfile, signal.data(), frames) == frames;
+
+    if (sf_close(sndfile) != 0 || !written)
+        return {};
+
+    return std::move(file.data);
+}
+
+// Format 0 MIDI file with chords on melodic channels and drums, typical for Doom music
+static std::vector<unsigned char> MakeMidi()
+{
+    constexpr int TICKS_PER_BEAT = 96;  // 120 BPM, i.e. 192 ticks per second
+    constexpr int TICKS_PER_SECOND = TICKS_PER_BEAT * 2;
+    constexpr int STEP = TICKS_PER_SECOND / 8;
+
+    std::vector<unsigned char> track;
+
+    const auto VarLen = [&track](uint32_t value)
+    {
+        unsigned char bytes[4];
+        int count = 0;
+
+        do
+        {
+            bytes[count++] = value & 0x7F;
+            value >>= 7;
+        }
+        while (value != 0);
+
+        while (count > 1)
+            track.push_back(bytes[--count] | 0x80);
+
+        track.push_back(bytes[0]);
+    };
+
+    const auto Event = [&](uint32_t delta, std::initializer_list<unsigned char> bytes)
+    {
+        VarLen(delta);
+        track.insert(track.end(), bytes);
+    };
+
+    for (unsigned char channel = 0; channel < 8; ++channel)
+        Event(0, { uint8_t(0xC0 | channel), uint8_t(channel * 10) });
+
+    uint32_t state = 0xAD1;
+
+    for (int step = 0; step < DURATION * TICKS_PER_SECOND / STEP; ++step)
+    {
+        std::vector<std::pair<unsigned char, unsigned char>> notes;
+
+        for (unsigned char channel = 0; channel < 8; ++channel)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+
+            notes.emplace_back(channel, uint8_t(36 + channel * 5 + state % 12));
+        }
+
+        notes.emplace_back(9, uint8_t(step % 2 == 0 ? 36 : 38));
+
+        for (const auto& [channel, note] : notes)
+            Event(0, { uint8_t(0x90 | channel), note, 100 });
+
+        for (size_t i = 0; i < notes.size(); ++i)
+            Event(i == 0 ? STEP : 0, { uint8_t(0x80 | notes[i].first), notes[i].second, 0 });
+    }
+
+    Event(0, { 0xFF, 0x2F, 0x00 });  // end of track
+
+    std::vector<unsigned char> midi = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, TICKS_PER_BEAT };
+    const uint32_t size = uint32_t(track.size());
+
+    midi.insert(midi.end(), { 'M', 'T', 'r', 'k', uint8_t(size >> 24), uint8_t(size >> 16), uint8_t(size >> 8),
+        uint8_t(size) });
+    midi.insert(midi.end(), track.begin(), track.end());
+
+    return midi;
+}
+
+static size_t SampleSize(SampleType type)
+{
+    switch (type)
+    {
+    case SampleType_UInt8:
+        return 1;
+    case SampleType_Int16:
+        return 2;
+    case SampleType_Float32:
+        return 4;
+    }
+
+    return 0;
+}
+
+static const char* SampleTypeName(SampleType type)
+{
+    return type == SampleType_Float32 ? "f32" : type == SampleType_Int16 ? "s16" : "u8";
+}
+
+static const char* ChannelConfigName(ChannelConfig channels)
+{
+    return channels == ChannelConfig_Stereo ? "stereo" : "mono";
+}
+
+// Conversion between all sample formats of streams and decoders, and volume scaling without conversion
+static void MeasureConversions(const std::vector<float>& signal)
+{
+    static constexpr SampleType TYPES[] = { SampleType_UInt8, SampleType_Int16, SampleType_Float32 };
+    static constexpr ChannelConfig LAYOUTS[] = { ChannelConfig_Mono, ChannelConfig_Stereo };
+    static constexpr size_t FRAMES = 4096;
+
+    // Out of range samples are clipped
+    const float loud[] = { 1.5f, -1.5f, 1.f, -1.f };
+    int16_t clipped[4] = {};
+    AEDI_EXPECT(ZMusic_ConvertSamples(clipped, SampleType_Int16, ChannelConfig_Stereo,
+        loud, SampleType_Float32, ChannelConfig_Stereo, 2, 1.f));
+    AEDI_EXPECT(clipped[0] == 32767 && clipped[1] == -32768 && clipped[2] == 32767 && clipped[3] == -32767);
+
+    AEDI_EXPECT(signal.size() >= FRAMES * 2);
+
+    std::vector<unsigned char> input(FRAMES * 2 * sizeof(float));
+    std::vector<unsigned char> output(FRAMES * 2 * sizeof(float));
+
+    for (SampleType inType : TYPES)
+    {
+        for (ChannelConfig inChannels : LAYOUTS)
+        {
+            AEDI_EXPECT(ZMusic_ConvertSamples(input.data(), inType, inChannels,
+                signal.data(), SampleType_Float32, ChannelConfig_Stereo, FRAMES, 1.f));
+
+            for (SampleType outType : TYPES)
+            {
+                for (ChannelConfig outChannels : LAYOUTS)
+                {
+                    const bool same = inType == outType && inChannels == outChannels;
+
+                    for (float volume : { 1.f, 0.5f })
+                    {
+                        if (volume != 1.f && !same)
+                            continue;
+
+                        const std::string name = aedi::Format("convert/%s_%s/%s_%s%s",
+                            SampleTypeName(inType), ChannelConfigName(inChannels),
+                            SampleTypeName(outType), ChannelConfigName(outChannels), volume != 1.f ? "/volume" : "");
+
+                        AEDI_BENCH(name, Samples, FRAMES)
+                        {
+                            AEDI_EXPECT(ZMusic_ConvertSamples(output.data(), outType, outChannels,
+                                input.data(), inType, inChannels, FRAMES, volume));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Structured stream statistics after the measured fills, ports graph the same values in game
+static ZMusicStreamStats ReportStreamStats(ZMusic_MusicStream song, const std::string& name)
+{
+    ZMusicStreamStats stats = {};
+    AEDI_EXPECT(ZMusic_GetStreamStats(song, &stats));
+    AEDI_EXPECT(stats.mFillCount > 0 && stats.mAudioNs > 0);
+
+    // Fills go back to back, faster than real time, so the client side buffer only grows
+    aedi::Info(("fill_us/" + name).c_str(), "%.1f", stats.mFillTimeNs / 1e3 / stats.mFillCount);
+    aedi::Info(("max_fill_us/" + name).c_str(), "%.1f", stats.mMaxFillTimeNs / 1e3);
+    aedi::Info(("cpu_load/" + name).c_str(), "%.4f", stats.mCpuLoad);
+    aedi::Info(("underruns/" + name).c_str(), "%llu", static_cast<unsigned long long>(stats.mUnderrunCount));
+    aedi::Info(("buffered_ms/" + name).c_str(), "%.0f", stats.mBufferedMs);
+    aedi::Info(("voices/" + name).c_str(), "%d", stats.mActiveVoices);
+
+    return stats;
+}
+
+// Plays the song, and closes it
+static void StreamSong(ZMusic_MusicStream song, const std::string& name)
+{
+    AEDI_EXPECT(song != nullptr);
+    AEDI_EXPECT(ZMusic_Start(song, 0, true));
+
+    SoundStreamInfo info = {};
+    ZMusic_GetStreamInfo(song, &info);
+    AEDI_EXPECT(info.mBufferSize > 0);
+    AEDI_EXPECT(info.mSampleRate == SAMPLE_RATE);
+
+    // Negative number of channels means 16-bit integer samples, float ones otherwise
+    const int channels = abs(info.mNumChannels);
+    const int frame_size = channels * (info.mNumChannels < 0 ? 2 : 4);
+    std::vector<unsigned char> buffer(size_t(CALLBACK_FRAMES) * frame_size);
+
+    // Measured repetitions play the whole song once
+    const int callback_count = SAMPLE_RATE * DURATION / CALLBACK_FRAMES;
+
+    AEDI_BENCH_COUNT(name, Samples, CALLBACK_FRAMES, callback_count)
+    {
+        AEDI_EXPECT(ZMusic_FillStream(song, buffer.data(), int(buffer.size())));
+    }
+
+    ReportStreamStats(song, name);
+    ZMusic_Close(song);
+}
+
+static void MeasureStreaming(const std::vector<unsigned char>& encoded, const char* name)
+{
+    ZMusic_MusicStream song = ZMusic_OpenSongMem(encoded.data(), encoded.size(), MDEV_DEFAULT, nullptr);
+    StreamSong(song, aedi::Format("stream/%s", name));
+}
+
+// Song streamed through prefetch buffer by callbacks paced in real time, for one second, fills only copy audio
+// that background thread rendered ahead, so their times are compared with the ones of synchronous streaming
+// Without underruns, played audio is the same as the one that the song renders synchronously
+static void MeasurePrefetch(const std::vector<unsigned char>& encoded, const char* name)
+{
+    ZMusic_MusicStream song = ZMusic_OpenSongMem(encoded.data(), encoded.size(), MDEV_DEFAULT, nullptr);
+    ZMusic_MusicStream reference = ZMusic_OpenSongMem(encoded.data(), encoded.size(), MDEV_DEFAULT, nullptr);
+    AEDI_EXPECT(song != nullptr && reference != nullptr);
+    AEDI_EXPECT(ZMusic_Start(song, 0, true) && ZMusic_Start(reference, 0, true));
+    AEDI_EXPECT(ZMusic_SetStreamPrefetch(song, PREFETCH_MS));
+
+    SoundStreamInfo info = {};
+    ZMusic_GetStreamInfo(song, &info);
+    AEDI_EXPECT(info.mSampleRate == SAMPLE_RATE);
+
+    const int frame_size = abs(info.mNumChannels) * (info.mNumChannels < 0 ? 2 : 4);
+    const size_t callback_size = size_t(CALLBACK_FRAMES) * frame_size;
+    const int callback_count = SAMPLE_RATE / CALLBACK_FRAMES;
+
+    // Playback starts when the buffer is half full, like the ports start their streams after the first fills
+    ZMusicStreamStats stats = {};
+    const auto start = std::chrono::steady_clock::now();
+
+    do
+    {
+        AEDI_EXPECT(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        AEDI_EXPECT(ZMusic_GetStreamStats(song, &stats));
+    }
+    while (stats.mPrefetchFillMs < PREFETCH_MS / 2);
+
+    std::vector<unsigned char> played(callback_size * callback_count);
+    std::vector<unsigned char> expected(played.size());
+    const auto period = std::chrono::nanoseconds(1000000000LL * CALLBACK_FRAMES / SAMPLE_RATE);
+    auto deadline = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < callback_count; ++i)
+    {
+        AEDI_EXPECT(ZMusic_FillStream(song, &played[i * callback_size], int(callback_size)));
+        deadline += period;
+        std::this_thread::sleep_until(deadline);
+    }
+
+    for (int i = 0; i < callback_count; ++i)
+        AEDI_EXPECT(ZMusic_FillStream(reference, &expected[i * callback_size], int(callback_size)));
+
+    const std::string stats_name = aedi::Format("prefetch/%s", name);
+    stats = ReportStreamStats(song, stats_name);
+    AEDI_EXPECT(stats.mPrefetchMs >= PREFETCH_MS && stats.mRenderCount > 0);
+
+    aedi::Info(("prefetch_underruns/" + stats_name).c_str(), "%llu",
+        static_cast<unsigned long long>(stats.mPrefetchUnderrunCount));
+    aedi::Info(("prefetch_min_fill_ms/" + stats_name).c_str(), "%.1f", stats.mPrefetchMinFillMs);
+    aedi::Info(("render_us/" + stats_name).c_str(), "%.1f", stats.mRenderTimeNs / 1e3 / stats.mRenderCount);
+    aedi::Info(("max_render_us/" + stats_name).c_str(), "%.1f", stats.mMaxRenderTimeNs / 1e3);
+
+    if (stats.mPrefetchUnderrunCount == 0)
+        AEDI_EXPECT(played == expected);
+
+    ZMusic_Close(reference);
+    ZMusic_Close(song);
+}
+
+struct MappedFile
+{
+    const char* data;
+    long size;
+    long position;
+};
+
+static ZMusicCustomReader* OpenMappedReader(const char* path)
+{
+    const int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+        return nullptr;
+
+    struct stat status = {};
+    void* data = fstat(fd, &status) == 0 && status.st_size > 0
+        ? mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0)
+        : MAP_FAILED;
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return nullptr;
+
+    madvise(data, size_t(status.st_size), MADV_SEQUENTIAL);
+
+    ZMusicCustomReader* reader = new ZMusicCustomReader();
+    reader->handle = new MappedFile{ static_cast<const char*>(data), long(status.st_size), 0 };
+
+    // The same as fgets()
+    reader->gets = [](ZMusicCustomReader* reader, char* buffer, int count) -> char*
+    {
+        MappedFile* file = static_cast<MappedFile*>(reader->handle);
+        int length = 0;
+
+        while (length < count - 1 && file->position < file->size)
+        {
+            const char value = file->data[file->position++];
+            buffer[length++] = value;
+
+            if (value == '\n')
+                break;
+        }
+
+        if (length == 0)
+            return nullptr;
+
+        buffer[length] = '\0';
+        return buffer;
+    };
+
+    reader->read = [](ZMusicCustomReader* reader, void* buffer, int32_t size) -> long
+    {
+        MappedFile* file = static_cast<MappedFile*>(reader->handle);
+        const long count = std::min(long(std::max(size, 0)), file->size - file->position);
+
+        memcpy(buffer, file->data + file->position, size_t(count));
+        file->position += count;
+
+        return count;
+    };
+
+    // The same as fseek(), zero on success
+    reader->seek = [](ZMusicCustomReader* reader, long offset, int whence) -> long
+    {
+        MappedFile* file = static_cast<MappedFile*>(reader->handle);
+
+        if (whence == SEEK_CUR)
+            offset += file->position;
+        else if (whence == SEEK_END)
+            offset += file->size;
+
+        if (offset < 0 || offset > file->size)
+            return -1;
+
+        file->position = offset;
+        return 0;
+    };
+
+    reader->tell = [](ZMusicCustomReader* reader) -> long
+    {
+        return static_cast<MappedFile*>(reader->handle)->position;
+    };
+
+    reader->close = [](ZMusicCustomReader* reader)
+    {
+        MappedFile* file = static_cast<MappedFile*>(reader->handle);
+        munmap(const_cast<char*>(file->data), size_t(file->size));
+
+        delete file;
+        delete reader;
+    };
+
+    return reader;
+}
+
+static std::vector<unsigned char> ReadFile(const char* path)
+{
+    std::vector<unsigned char> content;
+    FILE* file = fopen(path, "rb");
+
+    if (file == nullptr)
+        return content;
+
+    unsigned char buffer[64 * 1024];
+
+    while (const size_t size = fread(buffer, 1, sizeof buffer, file))
+        content.insert(content.end(), buffer, buffer + size);
+
+    fclose(file);
+    return content;
+}
+
+// Time to the first callback buffer of song stored in file
+static void MeasureOpening(const std::vector<unsigned char>& encoded, const char* name)
+{
+    const std::string path = aedi::Format("zmusic-bench.%s", name);
+    FILE* file = fopen(path.c_str(), "wb");
+    AEDI_EXPECT(file != nullptr);
+
+    const bool written = fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+    AEDI_EXPECT(fclose(file) == 0 && written);
+
+    std::vector<unsigned char> buffer(size_t(CALLBACK_FRAMES) * CHANNELS * sizeof(float));
+
+    AEDI_BENCH(aedi::Format("open/heap/%s", name), Samples, CALLBACK_FRAMES)
+    {
+        const std::vector<unsigned char> content = ReadFile(path.c_str());
+        AEDI_EXPECT(content.size() == encoded.size());
+
+        ZMusic_MusicStream song = ZMusic_OpenSongMem(content.data(), content.size(), MDEV_DEFAULT, nullptr);
+        AEDI_EXPECT(song != nullptr);
+        AEDI_EXPECT(ZMusic_Start(song, 0, false));
+        AEDI_EXPECT(ZMusic_FillStream(song, buffer.data(), int(buffer.size())));
+        ZMusic_Close(song);
+    }
+
+    AEDI_BENCH(aedi::Format("open/mapped/%s", name), Samples, CALLBACK_FRAMES)
+    {
+        // Song takes ownership of reader, and closes it
+        ZMusicCustomReader* reader = OpenMappedReader(path.c_str());
+        AEDI_EXPECT(reader != nullptr);
+
+        ZMusic_MusicStream song = ZMusic_OpenSong(reader, MDEV_DEFAULT, nullptr);
+        AEDI_EXPECT(song != nullptr);
+        AEDI_EXPECT(ZMusic_Start(song, 0, false));
+        AEDI_EXPECT(ZMusic_FillStream(song, buffer.data(), int(buffer.size())));
+        ZMusic_Close(song);
+    }
+
+    remove(path.c_str());
+}
+
+static void MeasureEmulators(const std::vector<unsigned char>& midi)
+{
+    // Identifiers are values of ADLMIDI_Emulator and OPNMIDI_Emulator enumerations
+    static const struct
+    {
+        const char* name;
+        EMidiDevice device;
+        EIntConfigKey emulator_key;
+        EIntConfigKey chips_key;
+        std::vector<std::pair<const char*, int>> emulators;
+    }
+    SYNTHS[] =
+    {
+        { "adl", MDEV_ADL, zmusic_adl_emulator_id, zmusic_adl_chips_count,
+            { { "nuked", 0 }, { "nuked174", 1 }, { "dosbox", 2 }, { "opal", 3 }, { "java", 4 } } },
+        { "opn", MDEV_OPN, zmusic_opn_emulator_id, zmusic_opn_chips_count,
+            { { "mame", 0 }, { "nuked", 1 }, { "gens", 2 } } },
+    };
+
+    for (const auto& synth : SYNTHS)
+    {
+        for (const auto& [emulator, id] : synth.emulators)
+        {
+            for (int chips = 1; chips <= 4; ++chips)
+            {
+                // Settings of the next opened song, there is no song to restart
+                int value = 0;
+                ChangeMusicSettingInt(synth.emulator_key, nullptr, id, &value);
+                ChangeMusicSettingInt(synth.chips_key, nullptr, chips, &value);
+
+                ZMusic_MusicStream song = ZMusic_OpenSongMem(midi.data(), midi.size(), synth.device, nullptr);
+                AEDI_EXPECT(song != nullptr);
+                AEDI_EXPECT(ZMusic_Start(song, 0, true));
+
+                SoundStreamInfo info = {};
+                ZMusic_GetStreamInfo(song, &info);
+                AEDI_EXPECT(info.mBufferSize > 0);
+
+                const int frame_size = abs(info.mNumChannels) * (info.mNumChannels < 0 ? 2 : 4);
+                std::vector<unsigned char> buffer(size_t(CALLBACK_FRAMES) * frame_size);
+
+                const int callback_count = info.mSampleRate * DURATION / CALLBACK_FRAMES;
+                const std::string name = aedi::Format("emulator/%s/%s/chips%d", synth.name, emulator, chips);
+
+                AEDI_BENCH_COUNT(name, Samples, CALLBACK_FRAMES, callback_count)
+                {
+                    AEDI_EXPECT(ZMusic_FillStream(song, buffer.data(), int(buffer.size())));
+                }
+
+                AEDI_EXPECT(ReportStreamStats(song, name).mDeviceType == synth.device);
+                ZMusic_Close(song);
+            }
+        }
+    }
+}
+
+// MIDI song pre-rendered by ZMusic_OpenSongCached() and streamed from FLAC file, versus its synthesis
+// by libADLMIDI with the most accurate OPL3 core, the first play measures time until the file is rendered
+static void MeasureMidiCache(const std::vector<unsigned char>& midi)
+{
+    int value = 0;
+    ChangeMusicSettingInt(zmusic_snd_outputrate, nullptr, SAMPLE_RATE, &value);
+    ChangeMusicSettingInt(zmusic_adl_emulator_id, nullptr, 0, &value);
+    ChangeMusicSettingInt(zmusic_adl_chips_count, nullptr, 2, &value);
+
+    char directory[] = "/tmp/zmusic-cache.XXXXXX";
+    AEDI_EXPECT(mkdtemp(directory) != nullptr);
+
+    const auto OpenSong = [&midi, &directory]
+    {
+        ZMusic_MusicStream song = ZMusic_OpenSongCached(midi.data(), midi.size(), MDEV_ADL, nullptr, SAMPLE_RATE,
+            directory, "adl/nuked/chips2");
+        AEDI_EXPECT(song != nullptr);
+        return song;
+    };
+
+    // Songs opened before the file is complete are synthesized, rendering of the first one continues meanwhile
+    const auto start = std::chrono::steady_clock::now();
+    ZMusic_MusicStream song = OpenSong();
+
+    while (ZMusic_IsMIDI(song))
+    {
+        ZMusic_Close(song);
+        AEDI_EXPECT(std::chrono::steady_clock::now() - start < std::chrono::minutes(1));
+
+        usleep(10000);
+        song = OpenSong();
+    }
+
+    const auto rendering = std::chrono::steady_clock::now() - start;
+    aedi::Info("midi_cache/render_ms", "%lld",
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(rendering).count()));
+
+    StreamSong(song, "midi_cache/cached");
+    StreamSong(ZMusic_OpenSongMem(midi.data(), midi.size(), MDEV_ADL, nullptr), "midi_cache/synth");
+
+    DIR* entries = opendir(directory);
+    AEDI_EXPECT(entries != nullptr);
+
+    while (const dirent* entry = readdir(entries))
+    {
+        if (entry->d_name[0] != '.')
+            remove(aedi::Format("%s/%s", directory, entry->d_name).c_str());
+    }
+
+    closedir(entries);
+    AEDI_EXPECT(rmdir(directory) == 0);
+}
+
+int main()
+{
+    aedi::Info("sndfile_version", "%s", sf_version_string());
+    aedi::PrintCpuFeatures();
+
+    const std::vector<unsigned char> midi = MakeMidi();
+    MeasureEmulators(midi);
+    MeasureMidiCache(midi);
+
+    static const struct
+    {
+        const char* name;
+        int format;
+    }
+    FORMATS[] =
+    {
+        { "wav", SF_FORMAT_WAV | SF_FORMAT_PCM_16 },
+        { "flac", SF_FORMAT_FLAC | SF_FORMAT_PCM_16 },
+        { "vorbis", SF_FORMAT_OGG | SF_FORMAT_VORBIS },
+        { "opus", SF_FORMAT_OGG | SF_FORMAT_OPUS },
+        { "mp3", SF_FORMAT_MPEG | SF_FORMAT_MPEG_LAYER_III },
+    };
+
+    const std::vector<float> signal = MakeSignal();
+    MeasureConversions(signal);
+
+    std::vector<unsigned char> decoded(size_t(SAMPLE_RATE) * CHANNELS * sizeof(float));
+
+    for (const auto& format : FORMATS)
+    {
+        const std::vector<unsigned char> encoded = Encode(signal, format.format);
+        AEDI_EXPECT(!encoded.empty());
+
+        aedi::Info(aedi::Format("size/%s", format.name).c_str(), "%zu", encoded.size());
+        MeasureStreaming(encoded, format.name);
+        MeasurePrefetch(encoded, format.name);
+        MeasureOpening(encoded, format.name);
+
+        for (bool isstatic : { true, false })
+        {
+            const char* const kind = isstatic ? "static" : "copy";
+
+            // Determine amount of decoded data, it differs from the original because of encoder delay and padding
+            SoundDecoder* decoder = CreateDecoder(encoded.data(), encoded.size(), isstatic);
+            AEDI_EXPECT(decoder != nullptr);
+
+            int samplerate = 0;
+            ChannelConfig channels = ChannelConfig_Mono;
+            SampleType type = SampleType_UInt8;
+            SoundDecoder_GetInfo(decoder, &samplerate, &channels, &type);
+
+            const size_t frame_size = SampleSize(type) * (channels == ChannelConfig_Stereo ? 2 : 1);
+            AEDI_EXPECT(samplerate == SAMPLE_RATE);
+            AEDI_EXPECT(frame_size > 0);
+
+            size_t decoded_size = 0;
+
+            while (const size_t size = SoundDecoder_Read(decoder, decoded.data(), decoded.size()))
+                decoded_size += size;
+
+            SoundDecoder_Close(decoder);
+
+            AEDI_EXPECT(decoded_size >= frame_size * SAMPLE_RATE * (DURATION - 1));
+
+            const std::string suffix = aedi::Format("%s/%s", format.name, kind);
+
+            AEDI_BENCH("first_sample/" + suffix, Samples, FIRST_READ_SIZE / frame_size)
+            {
+                decoder = CreateDecoder(encoded.data(), encoded.size(), isstatic);
+                AEDI_EXPECT(SoundDecoder_Read(decoder, decoded.data(), FIRST_READ_SIZE) == FIRST_READ_SIZE);
+                SoundDecoder_Close(decoder);
+            }
+
+            AEDI_BENCH("decode/" + suffix, Samples, decoded_size / frame_size)
+            {
+                decoder = CreateDecoder(encoded.data(), encoded.size(), isstatic);
+
+                while (SoundDecoder_Read(decoder, decoded.data(), decoded.size()) != 0)
+                {
+                    // Read until the end
+                }
+
+                SoundDecoder_Close(decoder);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+// pkg-config: libzstd
+
+#define ZSTD_STATIC_LINKING_ONLY
+
+#include <zdict.h>
+#include <zstd.h>
+
+#include <thread>
+
+#include "corpus.h"
+
+// Multithreaded compression and dictionary compression of zstd, the ways archives of game content would use them
+//
+// Multithreaded compression splits the whole content into jobs compressed by worker threads, so its throughput
+// is measured at high ratio levels for different numbers of workers, zero workers means single threaded mode
+// Lumps are small archive entries, every one is compressed separately, with and without dictionary trained on them
+// The same decompression context is reused for all lumps, with shared digested dictionary referenced by it,
+// and with raw dictionary that is digested again for every lump
+
+static constexpr size_t LUMP_SIZE = 4096;
+static constexpr size_t DICTIONARY_SIZE = 112640;
+static constexpr size_t JOB_SIZE = 512 * 1024;
+static constexpr int LUMP_LEVEL = 19;
+
+static void MeasureMultithreading(const std::vector<unsigned char>& content)
+{
+    const ZSTD_bounds bounds = ZSTD_cParam_getBounds(ZSTD_c_nbWorkers);
+    AEDI_EXPECT(!ZSTD_isError(bounds.error));
+
+    // Upper bound of workers is zero when library is built without multithreading support
+    aedi::Info("zstd_max_workers", "%d", bounds.upperBound);
+    AEDI_EXPECT(bounds.upperBound > 0);
+
+    const int cores = std::max(int(std::thread::hardware_concurrency()), 1);
+    std::vector<int> worker_counts = { 0, 1, 2, 4 };
+
+    if (cores > 4)
+        worker_counts.push_back(cores);
+
+    ZSTD_CCtx* context = ZSTD_createCCtx();
+    AEDI_EXPECT(context != nullptr);
+
+    ZSTD_DCtx* decompression_context = ZSTD_createDCtx();
+    AEDI_EXPECT(decompression_context != nullptr);
+
+    std::vector<unsigned char> compressed(ZSTD_compressBound(content.size()));
+    std::vector<unsigned char> decompressed(content.size());
+
+    for (int level : { 9, LUMP_LEVEL })
+    {
+        for (int workers : worker_counts)
+        {
+            ZSTD_CCtx_reset(context, ZSTD_reset_session_and_parameters);
+            AEDI_EXPECT(!ZSTD_isError(ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, level)));
+            AEDI_EXPECT(!ZSTD_isError(ZSTD_CCtx_setParameter(context, ZSTD_c_nbWorkers, workers)));
+
+            // Default job size of high levels is greater than the whole content, it would be compressed by one worker
+            if (workers > 0)
+                AEDI_EXPECT(!ZSTD_isError(ZSTD_CCtx_setParameter(context, ZSTD_c_jobSize, int(JOB_SIZE))));
+
+            const std::string name = aedi::Format("level%d/workers%d", level, workers);
+            size_t size = 0;
+
+            AEDI_BENCH("compress/" + name, Bytes, content.size())
+            {
+                size = ZSTD_compress2(context, compressed.data(), compressed.size(), content.data(), content.size());
+                AEDI_EXPECT(!ZSTD_isError(size));
+            }
+
+            const size_t result = ZSTD_decompressDCtx(decompression_context, decompressed.data(), decompressed.size(),
+                compressed.data(), size);
+            AEDI_EXPECT(result == content.size());
+            AEDI_EXPECT(decompressed == content);
+
+            aedi::Info(("ratio/" + name).c_str(), "%.3f", double(content.size()) / size);
+        }
+    }
+
+    ZSTD_freeDCtx(decompression_context);
+    ZSTD_freeCCtx(context);
+}
+
+struct Lump
+{
+    const unsigned char* data;
+    size_t size;
+    std::vector<unsigned char> compressed;
+};
+
+static std::vector<Lump> SplitLumps(const std::vector<unsigned char>& content)
+{
+    std::vector<Lump> lumps;
+
+    for (size_t offset = 0; offset < content.size(); offset += LUMP_SIZE)
+        lumps.push_back({ &content[offset], std::min(LUMP_SIZE, content.size() - offset), {} });
+
+    return lumps;
+}
+
+static std::vector<unsigned char> TrainDictionary(const std::vector<unsigned char>& content,
+    const std::vector<Lump>& lumps)
+{
+    std::vector<size_t> sample_sizes;
+
+    for (const Lump& lump : lumps)
+        sample_sizes.push_back(lump.size);
+
+    std::vector<unsigned char> dictionary(DICTIONARY_SIZE);
+    size_t size = 0;
+
+    // Training is done once when archive is created, so only a few repetitions are enough
+    AEDI_BENCH_COUNT("train/dictionary", Bytes, content.size(), 3)
+    {
+        size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), content.data(), sample_sizes.data(),
+            unsigned(sample_sizes.size()));
+        AEDI_EXPECT(!ZDICT_isError(size));
+    }
+
+    dictionary.resize(size);
+    aedi::Info("dictionary_size", "%zu", size);
+    aedi::Info("dictionary_id", "%u", ZDICT_getDictID(dictionary.data(), dictionary.size()));
+
+    return dictionary;
+}
+
+static void MeasureLumps(const std::vector<unsigned char>& content)
+{
+    std::vector<Lump> lumps = SplitLumps(content);
+    aedi::Info("lump_count", "%zu", lumps.size());
+
+    const std::vector<unsigned char> dictionary = TrainDictionary(content, lumps);
+
+    ZSTD_CDict* compression_dictionary = ZSTD_createCDict(dictionary.data(), dictionary.size(), LUMP_LEVEL);
+    AEDI_EXPECT(compression_dictionary != nullptr);
+
+    ZSTD_DDict* decompression_dictionary = ZSTD_createDDict(dictionary.data(), dictionary.size());
+    AEDI_EXPECT(decompression_dictionary != nullptr);
+
+    // Digested dictionaries take more memory than raw one, it's their cost of being shared by all lumps
+    aedi::Info("memory/cdict", "%zu", ZSTD_sizeof_CDict(compression_dictionary));
+    aedi::Info("memory/ddict", "%zu", ZSTD_sizeof_DDict(decompression_dictionary));
+
+    ZSTD_CCtx* compression_context = ZSTD_createCCtx();
+    AEDI_EXPECT(compression_context != nullptr);
+
+    ZSTD_DCtx* context = ZSTD_createDCtx();
+    AEDI_EXPECT(context != nullptr);
+
+    std::vector<unsigned char> decompressed(LUMP_SIZE);
+
+    for (const char* mode : { "plain", "dictionary" })
+    {
+        const bool use_dictionary = strcmp(mode, "dictionary") == 0;
+        size_t compressed_size = 0;
+
+        for (Lump& lump : lumps)
+        {
+            lump.compressed.resize(ZSTD_compressBound(lump.size));
+
+            const size_t size = use_dictionary
+                ? ZSTD_compress_usingCDict(compression_context, lump.compressed.data(), lump.compressed.size(),
+                    lump.data, lump.size, compression_dictionary)
+                : ZSTD_compressCCtx(compression_context, lump.compressed.data(), lump.compressed.size(),
+                    lump.data, lump.size, LUMP_LEVEL);
+            AEDI_EXPECT(!ZSTD_isError(size));
+
+            lump.compressed.resize(size);
+            compressed_size += size;
+        }
+
+        aedi::Info(aedi::Format("ratio/lumps/%s", mode).c_str(), "%.3f", double(content.size()) / compressed_size);
+
+        // Reference to dictionary stays in decompression context until it's reset, one lookup per archive is enough
+        ZSTD_DCtx_reset(context, ZSTD_reset_session_and_parameters);
+
+        if (use_dictionary)
+            AEDI_EXPECT(!ZSTD_isError(ZSTD_DCtx_refDDict(context, decompression_dictionary)));
+
+        AEDI_BENCH(aedi::Format("decompress/lumps/%s", mode), Bytes, content.size())
+        {
+            for (const Lump& lump : lumps)
+            {
+                const size_t size = ZSTD_decompressDCtx(context, decompressed.data(), decompressed.size(),
+                    lump.compressed.data(), lump.compressed.size());
+                AEDI_EXPECT(size == lump.size);
+            }
+        }
+
+        for (const Lump& lump : lumps)
+        {
+            const size_t size = ZSTD_decompressDCtx(context, decompressed.data(), decompressed.size(),
+                lump.compressed.data(), lump.compressed.size());
+            AEDI_EXPECT(size == lump.size && memcmp(decompressed.data(), lump.data, size) == 0);
+        }
+    }
+
+    // Lumps are compressed with dictionary now, raw one is loaded into decompression context for every lump
+    ZSTD_DCtx_reset(context, ZSTD_reset_session_and_parameters);
+
+    AEDI_BENCH("decompress/lumps/dictionary/raw", Bytes, content.size())
+    {
+        for (const Lump& lump : lumps)
+        {
+            const size_t size = ZSTD_decompress_usingDict(context, decompressed.data(), decompressed.size(),
+                lump.compressed.data(), lump.compressed.size(), dictionary.data(), dictionary.size());
+            AEDI_EXPECT(size == lump.size);
+        }
+    }
+
+    ZSTD_freeDCtx(context);
+    ZSTD_freeCCtx(compression_context);
+    ZSTD_freeDDict(decompression_dictionary);
+    ZSTD_freeCDict(compression_dictionary);
+}
+
+int main()
+{
+    aedi::Info("zstd_version", "%s", ZSTD_versionString());
+    aedi::PrintCpuFeatures();
+
+    const auto corpus = LoadCorpus();
+    AEDI_EXPECT(!corpus.empty());
+
+    // Archive content is the whole corpus, like entries of PK3 file stored one after another
+    std::vector<unsigned char> content;
+
+    for (const auto& item : corpus)
+        content.insert(content.end(), item.second.begin(), item.second.end());
+
+    MeasureMultithreading(content);
+    MeasureLumps(content);
+
+    return 0;
+}
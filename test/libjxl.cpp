@@ -0,0 +1,94 @@
+// pkg-config: libjxl libjxl_threads
+#include <jxl/decode.h>
+#include <jxl/encode.h>
+#include <jxl/thread_parallel_runner.h>
+
+#include <vector>
+
+static constexpr uint32_t SIZE = 64;
+
+int main()
+{
+    AEDI_EXPECT(JxlDecoderVersion() > 0);
+
+    std::vector<uint8_t> pixels(SIZE * SIZE * 4);
+
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = uint8_t(i * 7 + i / 256);
+
+    // Parallel runner with several threads, even on single core machine, so groups are processed concurrently
+    void* runner = JxlThreadParallelRunnerCreate(nullptr, 4);
+    AEDI_EXPECT(runner != nullptr);
+
+    JxlEncoder* encoder = JxlEncoderCreate(nullptr);
+    AEDI_EXPECT(encoder != nullptr);
+    AEDI_EXPECT(JxlEncoderSetParallelRunner(encoder, JxlThreadParallelRunner, runner) == JXL_ENC_SUCCESS);
+
+    JxlBasicInfo info;
+    JxlEncoderInitBasicInfo(&info);
+    info.xsize = SIZE;
+    info.ysize = SIZE;
+    info.bits_per_sample = 8;
+    info.num_extra_channels = 1;
+    info.alpha_bits = 8;
+    info.uses_original_profile = JXL_TRUE;
+    AEDI_EXPECT(JxlEncoderSetBasicInfo(encoder, &info) == JXL_ENC_SUCCESS);
+
+    JxlColorEncoding color;
+    JxlColorEncodingSetToSRGB(&color, JXL_FALSE);
+    AEDI_EXPECT(JxlEncoderSetColorEncoding(encoder, &color) == JXL_ENC_SUCCESS);
+
+    const JxlPixelFormat format = { 4, JXL_TYPE_UINT8, JXL_NATIVE_ENDIAN, 0 };
+    JxlEncoderFrameSettings* settings = JxlEncoderFrameSettingsCreate(encoder, nullptr);
+    AEDI_EXPECT(JxlEncoderSetFrameLossless(settings, JXL_TRUE) == JXL_ENC_SUCCESS);
+    AEDI_EXPECT(JxlEncoderAddImageFrame(settings, &format, pixels.data(), pixels.size()) == JXL_ENC_SUCCESS);
+    JxlEncoderCloseInput(encoder);
+
+    std::vector<uint8_t> encoded(pixels.size() * 2);
+    uint8_t* next_out = encoded.data();
+    size_t avail_out = encoded.size();
+    AEDI_EXPECT(JxlEncoderProcessOutput(encoder, &next_out, &avail_out) == JXL_ENC_SUCCESS);
+    encoded.resize(size_t(next_out - encoded.data()));
+    JxlEncoderDestroy(encoder);
+
+    const JxlSignature signature = JxlSignatureCheck(encoded.data(), encoded.size());
+    AEDI_EXPECT(signature == JXL_SIG_CODESTREAM || signature == JXL_SIG_CONTAINER);
+
+    JxlDecoder* decoder = JxlDecoderCreate(nullptr);
+    AEDI_EXPECT(decoder != nullptr);
+    AEDI_EXPECT(JxlDecoderSetParallelRunner(decoder, JxlThreadParallelRunner, runner) == JXL_DEC_SUCCESS);
+    AEDI_EXPECT(JxlDecoderSubscribeEvents(decoder, JXL_DEC_BASIC_INFO | JXL_DEC_FULL_IMAGE) == JXL_DEC_SUCCESS);
+    AEDI_EXPECT(JxlDecoderSetInput(decoder, encoded.data(), encoded.size()) == JXL_DEC_SUCCESS);
+    JxlDecoderCloseInput(decoder);
+
+    std::vector<uint8_t> decoded(pixels.size());
+    bool finished = false;
+
+    while (!finished)
+    {
+        const JxlDecoderStatus status = JxlDecoderProcessInput(decoder);
+
+        if (status == JXL_DEC_BASIC_INFO)
+        {
+            AEDI_EXPECT(JxlDecoderGetBasicInfo(decoder, &info) == JXL_DEC_SUCCESS);
+            AEDI_EXPECT(info.xsize == SIZE && info.ysize == SIZE && info.alpha_bits == 8);
+        }
+        else if (status == JXL_DEC_NEED_IMAGE_OUT_BUFFER)
+        {
+            AEDI_EXPECT(JxlDecoderSetImageOutBuffer(decoder, &format, decoded.data(), decoded.size())
+                == JXL_DEC_SUCCESS);
+        }
+        else
+        {
+            AEDI_EXPECT(status == JXL_DEC_FULL_IMAGE || status == JXL_DEC_SUCCESS);
+            finished = true;
+        }
+    }
+
+    AEDI_EXPECT(decoded == pixels);
+
+    JxlDecoderDestroy(decoder);
+    JxlThreadParallelRunnerDestroy(runner);
+
+    return 0;
+}
@@ -1,13 +1,32 @@
 #include <mpg123.h>
+#include <string.h>
 
 int main(int argc, char **argv)
 {
     AEDI_EXPECT(mpg123_init() == MPG123_OK);
 
+    // Library with runtime dispatch carries generic decoder together with optimized ones
+    int decoder_count = 0;
+
+    for (const char** decoder = mpg123_decoders(); *decoder != nullptr; ++decoder)
+        ++decoder_count;
+
+    AEDI_EXPECT(decoder_count > 1);
+
     mpg123_handle* mh = mpg123_new(NULL, NULL);
     AEDI_EXPECT(mh != nullptr);
     AEDI_EXPECT(mpg123_param(mh, MPG123_VERBOSE, 1, 0.) == MPG123_OK);
 
+    // Decoder is chosen for the running CPU when handle is created
+    const char* const decoder = mpg123_current_decoder(mh);
+    AEDI_EXPECT(decoder != nullptr);
+
+#if defined(__aarch64__)
+    AEDI_EXPECT(strcmp(decoder, "NEON64") == 0);
+#elif defined(__x86_64__)
+    AEDI_EXPECT(strcmp(decoder, __builtin_cpu_supports("avx") ? "AVX" : "x86-64") == 0);
+#endif
+
     mpg123_delete(mh);
     mpg123_exit();
 
@@ -1,5 +1,16 @@
 #include <webp/decode.h>
 
+// Internal libwebp function pointers, see src/dsp/cpu.h, src/dsp/dsp.h and src/dsp/filters.c
+// CPU features are reported via the first one, others are set by initialization of DSP functions
+extern "C" int (*VP8GetCPUInfo)(int feature);
+extern "C" void (*VP8Transform)(const int16_t* in, uint8_t* dst, int do_two);
+extern "C" void (*WebPUnfilters[4])(const uint8_t* prev_line, const uint8_t* in, uint8_t* out, int width);
+
+// Values of CPUFeature enumeration
+static constexpr int WEBP_CPU_SSE2 = 0;
+static constexpr int WEBP_CPU_SSE4_1 = 3;
+static constexpr int WEBP_CPU_NEON = 6;
+
 // https://chromium.googlesource.com/webm/libwebp-test-data
 // https://chromium-review.googlesource.com/c/webm/libwebp-test-data/+/3384439
 
@@ -54,6 +65,26 @@ int main()
         AEDI_EXPECT(width == 1);
         AEDI_EXPECT(height == 13);
     }
+    {
+        // Lossy image with filtered alpha initializes decoder and alpha unfiltering functions
+        int width, height;
+        uint8_t* pixels = WebPDecodeRGBA(alpha_filter_1, sizeof alpha_filter_1, &width, &height);
+        AEDI_EXPECT(pixels != nullptr);
+        WebPFree(pixels);
+
+        AEDI_EXPECT(VP8GetCPUInfo != nullptr);
+        AEDI_EXPECT(VP8Transform != nullptr);
+
+        for (int filter = 1; filter < 4; ++filter)
+            AEDI_EXPECT(WebPUnfilters[filter] != nullptr);
+
+#if defined(__aarch64__)
+        AEDI_EXPECT(VP8GetCPUInfo(WEBP_CPU_NEON));
+#elif defined(__x86_64__)
+        AEDI_EXPECT(VP8GetCPUInfo(WEBP_CPU_SSE2));
+        AEDI_EXPECT(!VP8GetCPUInfo(WEBP_CPU_SSE4_1) == !__builtin_cpu_supports("sse4.1"));
+#endif
+    }
 
     return 0;
 }
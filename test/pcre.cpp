@@ -0,0 +1,45 @@
+// pkg-config: libpcre
+
+#include <string.h>
+#include <pcre.h>
+
+int main()
+{
+    int jit = 0;
+    AEDI_EXPECT(pcre_config(PCRE_CONFIG_JIT, &jit) == 0);
+
+#ifdef __x86_64__
+    AEDI_EXPECT(jit == 1);
+#else
+    AEDI_EXPECT(jit == 0);
+#endif
+
+    const char* error = nullptr;
+    int error_offset = 0;
+
+    pcre* const regex = pcre_compile("^(\\w+)\\s*=\\s*(\\d+)$", 0, &error, &error_offset, nullptr);
+    AEDI_EXPECT(regex != nullptr);
+
+    pcre_extra* const extra = pcre_study(regex, PCRE_STUDY_JIT_COMPILE, &error);
+    AEDI_EXPECT(error == nullptr);
+
+    if (jit)
+    {
+        // Pattern is compiled to machine code, so executable memory was allocated and written successfully
+        int jitted = 0;
+        AEDI_EXPECT(pcre_fullinfo(regex, extra, PCRE_INFO_JIT, &jitted) == 0);
+        AEDI_EXPECT(jitted == 1);
+    }
+
+    const char subject[] = "gain = 127";
+    int vector[9] = {};
+
+    AEDI_EXPECT(pcre_exec(regex, extra, subject, int(strlen(subject)), 0, 0, vector, 9) == 3);
+    AEDI_EXPECT(vector[2] == 0 && vector[3] == 4);
+    AEDI_EXPECT(vector[4] == 7 && vector[5] == 10);
+
+    pcre_free_study(extra);
+    pcre_free(regex);
+
+    return 0;
+}
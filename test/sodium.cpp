@@ -0,0 +1,47 @@
+// pkg-config: libsodium
+#include <string.h>
+#include <sodium.h>
+
+int main()
+{
+    AEDI_EXPECT(sodium_init() >= 0);
+
+    // AES-GCM is implemented with ARMv8 crypto extension or AES-NI only, there is no portable fallback
+    AEDI_EXPECT(crypto_aead_aes256gcm_is_available() == 1);
+
+    constexpr size_t MESSAGE_SIZE = 1024;
+    unsigned char message[MESSAGE_SIZE];
+
+    for (size_t i = 0; i < MESSAGE_SIZE; ++i)
+    {
+        message[i] = static_cast<unsigned char>(i % 251);
+    }
+
+    unsigned char key[crypto_aead_aes256gcm_KEYBYTES];
+    crypto_aead_aes256gcm_keygen(key);
+
+    unsigned char nonce[crypto_aead_aes256gcm_NPUBBYTES];
+    randombytes_buf(nonce, sizeof nonce);
+
+    unsigned char ciphertext[MESSAGE_SIZE + crypto_aead_aes256gcm_ABYTES];
+    unsigned long long ciphertext_size = 0;
+
+    AEDI_EXPECT(crypto_aead_aes256gcm_encrypt(ciphertext, &ciphertext_size, message, MESSAGE_SIZE,
+        nullptr, 0, nullptr, nonce, key) == 0);
+    AEDI_EXPECT(ciphertext_size == sizeof ciphertext);
+
+    unsigned char decrypted[MESSAGE_SIZE] = {};
+    unsigned long long decrypted_size = 0;
+
+    AEDI_EXPECT(crypto_aead_aes256gcm_decrypt(decrypted, &decrypted_size, nullptr, ciphertext, ciphertext_size,
+        nullptr, 0, nonce, key) == 0);
+    AEDI_EXPECT(decrypted_size == MESSAGE_SIZE);
+    AEDI_EXPECT(memcmp(message, decrypted, MESSAGE_SIZE) == 0);
+
+    // Tampered message must be rejected
+    ciphertext[0] ^= 1;
+    AEDI_EXPECT(crypto_aead_aes256gcm_decrypt(decrypted, &decrypted_size, nullptr, ciphertext, ciphertext_size,
+        nullptr, 0, nonce, key) == -1);
+
+    return 0;
+}
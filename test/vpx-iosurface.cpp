@@ -0,0 +1,31 @@
+#include <vpx-iosurface.h>
+#include <vpx/vp8dx.h>
+
+int main()
+{
+    vpx_iosurface_pool* pool = vpx_iosurface_pool_create();
+    AEDI_EXPECT(pool != nullptr);
+
+    vpx_codec_ctx_t codec;
+    AEDI_EXPECT(vpx_codec_dec_init(&codec, &vpx_codec_vp9_dx_algo, nullptr, 0) == VPX_CODEC_OK);
+    AEDI_EXPECT(vpx_iosurface_attach(&codec, pool) == VPX_CODEC_OK);
+    AEDI_EXPECT(vpx_codec_destroy(&codec) == VPX_CODEC_OK);
+
+    // VP8 decoder has no external frame buffers
+    AEDI_EXPECT(vpx_codec_dec_init(&codec, &vpx_codec_vp8_dx_algo, nullptr, 0) == VPX_CODEC_OK);
+    AEDI_EXPECT(vpx_iosurface_attach(&codec, pool) != VPX_CODEC_OK);
+    AEDI_EXPECT(vpx_codec_destroy(&codec) == VPX_CODEC_OK);
+
+    // Image in memory of decoder, not of pool, cannot be imported
+    vpx_image_t image = {};
+    AEDI_EXPECT(vpx_iosurface_surface(pool, &image) == nullptr);
+    AEDI_EXPECT(vpx_iosurface_pixel_buffer(pool, &image) == nullptr);
+
+    vpx_iosurface_stats stats;
+    vpx_iosurface_pool_stats(pool, &stats);
+    AEDI_EXPECT(stats.surfaces == 0 && stats.imported_frames == 0);
+
+    vpx_iosurface_pool_destroy(pool);
+
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include <vpx-videotoolbox.h>
+#include <vpx/vp8dx.h>
+
+int main()
+{
+    vpx_codec_ctx_t codec;
+    AEDI_EXPECT(vpx_codec_dec_init(&codec, vpx_codec_vp9_videotoolbox_dx(), nullptr, 0) == VPX_CODEC_OK);
+
+    // Decoder is chosen at the first key frame
+    AEDI_EXPECT(vpx_videotoolbox_is_hardware(&codec) == -1);
+
+    // Controls are forwarded to libvpx decoder
+    AEDI_EXPECT(vpx_codec_control(&codec, VP9D_SET_ROW_MT, 1) == VPX_CODEC_OK);
+    AEDI_EXPECT(vpx_codec_control(&codec, VP9_SET_BYTE_ALIGNMENT, 3) != VPX_CODEC_OK);
+
+    // Not a VP9 frame, neither decoder accepts it
+    const uint8_t garbage[16] = {};
+    AEDI_EXPECT(vpx_codec_decode(&codec, garbage, sizeof garbage, nullptr, 0) != VPX_CODEC_OK);
+    AEDI_EXPECT(vpx_videotoolbox_is_hardware(&codec) == -1);
+
+    vpx_codec_iter_t iterator = nullptr;
+    AEDI_EXPECT(vpx_codec_get_frame(&codec, &iterator) == nullptr);
+
+    AEDI_EXPECT(vpx_codec_destroy(&codec) == VPX_CODEC_OK);
+
+    // Other decoders are not of this library
+    AEDI_EXPECT(vpx_codec_dec_init(&codec, vpx_codec_vp9_dx(), nullptr, 0) == VPX_CODEC_OK);
+    AEDI_EXPECT(vpx_videotoolbox_is_hardware(&codec) == -1);
+    AEDI_EXPECT(vpx_codec_destroy(&codec) == VPX_CODEC_OK);
+
+    return 0;
+}
@@ -1,7 +1,105 @@
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <vulkan/vulkan_core.h>
+#include <MoltenVK/mvk_private_api.h>
+
+// Applies MoltenVK configuration the same way as applications do via LSEnvironment of their Info.plist,
+// profile is a space separated list of assignments, e.g. MVK_CONFIG_LOG_LEVEL=0 MVK_CONFIG_DEBUG=0
+static void ApplyMoltenVKProfile(const char* profile)
+{
+    char assignment[256];
+    int length;
+
+    for (const char* cursor = profile; sscanf(cursor, " %255s%n", assignment, &length) == 1; cursor += length)
+    {
+        if (char* value = strchr(assignment, '='))
+        {
+            *value = '\0';
+            setenv(assignment, value + 1, 1);
+        }
+    }
+}
+
+// Returns value of MoltenVK configuration variable from profile, or nullptr if it's not set there
+static const char* FindMoltenVKSetting(const char* profile, const char* name)
+{
+    const size_t length = strlen(name);
+
+    for (const char* cursor = strstr(profile, name); cursor != nullptr; cursor = strstr(cursor + length, name))
+    {
+        if ((cursor == profile || cursor[-1] == ' ') && cursor[length] == '=')
+            return cursor + length + 1;
+    }
+
+    return nullptr;
+}
+
+// Checks and prints configuration of MoltenVK library that is shipped with applications
+// Must be called before any other Vulkan function because MoltenVK reads environment variables once
+static int CheckMoltenVKConfiguration()
+{
+#ifdef AEDI_MOLTENVK_GAME_PROFILE
+    const char* profile = AEDI_MOLTENVK_GAME_PROFILE;
+#else
+    const char* profile = "";
+#endif
+
+    ApplyMoltenVKProfile(profile);
+
+    void* moltenvk = dlopen("@rpath/libMoltenVK.dylib", RTLD_NOW | RTLD_LOCAL);
+
+    if (moltenvk == nullptr)
+    {
+        // Nothing to check without dynamic library, e.g. when only static MoltenVK is installed
+        puts("Skipped MoltenVK configuration check, libMoltenVK.dylib is not available");
+        return 0;
+    }
+
+    auto getConfiguration = reinterpret_cast<PFN_vkGetMoltenVKConfigurationMVK>(dlsym(moltenvk, "vkGetMoltenVKConfigurationMVK"));
+    AEDI_EXPECT(getConfiguration != nullptr);
+
+    MVKConfiguration config;
+    size_t size = sizeof config;
+    AEDI_EXPECT(getConfiguration(VK_NULL_HANDLE, &config, &size) == VK_SUCCESS);
+
+    const struct
+    {
+        const char* name;
+        long value;
+    }
+    settings[] =
+    {
+        { "MVK_CONFIG_USE_METAL_ARGUMENT_BUFFERS", long(config.useMetalArgumentBuffers) },
+        { "MVK_CONFIG_SYNCHRONOUS_QUEUE_SUBMITS", long(config.synchronousQueueSubmits) },
+        { "MVK_CONFIG_SHOULD_MAXIMIZE_CONCURRENT_COMPILATION", long(config.shouldMaximizeConcurrentCompilation) },
+        { "MVK_CONFIG_MAX_ACTIVE_METAL_COMMAND_BUFFERS_PER_QUEUE", long(config.maxActiveMetalCommandBuffersPerQueue) },
+        { "MVK_CONFIG_PREFILL_METAL_COMMAND_BUFFERS", long(config.prefillMetalCommandBuffers) },
+        { "MVK_CONFIG_FAST_MATH_ENABLED", long(config.fastMathEnabled) },
+        { "MVK_CONFIG_LOG_LEVEL", long(config.logLevel) },
+        { "MVK_CONFIG_DEBUG", long(config.debugMode) },
+        { "MVK_CONFIG_PERFORMANCE_TRACKING", long(config.performanceTracking) },
+    };
+
+    for (const auto& setting : settings)
+    {
+        printf("%s=%ld\n", setting.name, setting.value);
+
+        // Variables that are not in profile keep upstream defaults, so only profile values are checked
+        if (const char* expected = FindMoltenVKSetting(profile, setting.name))
+            AEDI_EXPECT(setting.value == strtol(expected, nullptr, 10));
+    }
+
+    dlclose(moltenvk);
+    return 0;
+}
 
 int main()
 {
+    if (CheckMoltenVKConfiguration() != 0)
+        return 1;
+
     uint32_t version;
     AEDI_EXPECT(vkEnumerateInstanceVersion(&version) == VK_SUCCESS);
     AEDI_EXPECT(version >= VK_API_VERSION_1_1);